@@ -0,0 +1,11 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 v_Color;
+in vec2 v_Local;
+
+void main() {
+    // Soft round particle: fade towards the edge of the quad
+    float falloff = clamp(1.0 - dot(v_Local, v_Local), 0.0, 1.0);
+    FragColor = vec4(v_Color.rgb, v_Color.a * falloff);
+} 
\ No newline at end of file
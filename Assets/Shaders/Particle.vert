@@ -0,0 +1,24 @@
+#version 330 core
+layout (location = 0) in vec3 a_Corner;
+layout (location = 1) in float a_PositionX;
+layout (location = 2) in float a_PositionY;
+layout (location = 3) in float a_Life;
+layout (location = 4) in float a_InvLifetime;
+layout (location = 5) in vec4 a_Color;
+
+uniform mat4 u_ViewProjection;
+uniform vec2 u_Size;    // x = size at spawn, y = size at death
+uniform float u_FadeOut;
+
+out vec4 v_Color;
+out vec2 v_Local;
+
+void main() {
+    float age = clamp(1.0 - a_Life * a_InvLifetime, 0.0, 1.0);
+    float size = mix(u_Size.x, u_Size.y, age);
+    vec2 position = vec2(a_PositionX, a_PositionY) + a_Corner.xy * size;
+
+    gl_Position = u_ViewProjection * vec4(position, 0.0, 1.0);
+    v_Color = vec4(a_Color.rgb, a_Color.a * mix(1.0, 1.0 - age, u_FadeOut));
+    v_Local = a_Corner.xy * 2.0;
+} 
\ No newline at end of file
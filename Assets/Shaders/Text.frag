@@ -0,0 +1,15 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 v_TexCoord;
+in vec4 v_Color;
+
+uniform sampler2D u_Atlas;
+
+void main() {
+    // Distance field: 0.5 is the glyph edge; fwidth keeps the edge one pixel wide at any scale
+    float distance = texture(u_Atlas, v_TexCoord).r;
+    float width = max(fwidth(distance), 1e-4);
+    float alpha = smoothstep(0.5 - width, 0.5 + width, distance);
+    FragColor = vec4(v_Color.rgb, v_Color.a * alpha);
+} 
\ No newline at end of file
@@ -0,0 +1,17 @@
+#version 330 core
+layout (location = 0) in vec2 a_Position;
+layout (location = 1) in vec2 a_TexCoord;
+layout (location = 2) in vec2 a_Animation; // x = frame count, y = frames per second
+
+uniform mat4 u_ViewProjection;
+uniform float u_Time;
+uniform vec2 u_TileUVSize;
+
+out vec2 v_TexCoord;
+
+void main() {
+    // Animated tiles step along their atlas row, so no chunk rebuild is needed per frame
+    float frame = mod(floor(u_Time * a_Animation.y), max(a_Animation.x, 1.0));
+    v_TexCoord = a_TexCoord + vec2(frame * u_TileUVSize.x, 0.0);
+    gl_Position = u_ViewProjection * vec4(a_Position, 0.0, 1.0);
+} 
\ No newline at end of file
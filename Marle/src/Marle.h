@@ -24,12 +24,52 @@
 #include "Marle/Events/MouseEvent.h"
 #include "Marle/Events/ApplicationEvent.h"
 
+// Core
+#include "Marle/Core/FileSystem.h"
+#include "Marle/Core/FrameTaskScheduler.h"
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Core/MemoryTracker.h"
+#include "Marle/Core/Metrics.h"
+#include "Marle/Core/ResourceManager.h"
+#include "Marle/Core/Snapshot.h"
+#include "Marle/Core/StringId.h"
+#include "Marle/Core/SystemScheduler.h"
+
+// Audio
+#include "Marle/Audio/AudioEngine.h"
+#include "Marle/Audio/AudioClip.h"
+#include "Marle/Audio/AudioDevice.h"
+
+// Animation
+#include "Marle/Animation/AnimationSystem.h"
+
+// Scene
+#include "Marle/Scene/TransformHierarchy.h"
+#include "Marle/Scene/WorldStreamer.h"
+
+// Navigation
+#include "Marle/Navigation/FlowField.h"
+
+// Network
+#include "Marle/Network/Replication.h"
+
 // Input
 #include "Marle/Core/KeyCodes.h"
 
 // Renderer
+#include "Marle/Renderer/RendererBackend.h"
 #include "Marle/Renderer/Renderer2D.h"
+#include "Marle/Renderer/SoftwareRenderer.h"
+#include "Marle/Renderer/ParticleSystem.h"
+#include "Marle/Renderer/Tilemap.h"
+#include "Marle/Renderer/Font.h"
+#include "Marle/Renderer/TextureStreamer.h"
+#include "Marle/Renderer/ImageDecoder.h"
+#include "Marle/Renderer/RenderProfiler.h"
+#include "Marle/Renderer/RenderGraph.h"
+#include "Marle/Renderer/VertexBufferLayout.h"
 #include "Marle/Platform/OpenGL/OpenGLTexture.h"
+#include "Marle/Platform/OpenGL/OpenGLFramebuffer.h"
 
 // Entry point ==START==
 #include "Marle/EntryPoint.h"
@@ -0,0 +1,122 @@
+#include "mrlpch.h"
+#include "AnimationClip.h"
+#include "Skeleton.h"
+#include "../Core/SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Marle {
+
+    static const uint32_t s_TrackCount = (uint32_t)AnimationTrack::Count;
+
+    AnimationClip::AnimationClip(const Skeleton& skeleton, float duration, bool loop)
+        : m_Duration(std::max(duration, 0.0f)), m_Loop(loop), m_BoneCount(skeleton.GetBoneCount())
+    {
+        m_Bind.reserve(m_BoneCount);
+        for (uint32_t bone = 0; bone < m_BoneCount; bone++) {
+            m_Bind.push_back(skeleton.GetBindTransform(bone));
+        }
+        m_Curves.resize((size_t)m_BoneCount * s_TrackCount);
+    }
+
+    void AnimationClip::AddKey(uint32_t bone, AnimationTrack track, float time, float value)
+    {
+        if (bone >= m_BoneCount || track >= AnimationTrack::Count) {
+            printf("Error: Animation key for invalid bone %u / track %u\n", bone, (uint32_t)track);
+            return;
+        }
+        std::vector<Key>& curve = m_Curves[(size_t)bone * s_TrackCount + (uint32_t)track];
+        Key key = { std::min(std::max(time, 0.0f), m_Duration), value };
+        auto it = std::upper_bound(curve.begin(), curve.end(), key.Time, [](float t, const Key& k) { return t < k.Time; });
+        curve.insert(it, key);
+        m_FrameCount = 0; // Needs baking again
+    }
+
+    float AnimationClip::EvaluateCurve(uint32_t bone, AnimationTrack track, float time) const
+    {
+        const std::vector<Key>& curve = m_Curves[(size_t)bone * s_TrackCount + (uint32_t)track];
+        if (curve.empty()) {
+            const BoneTransform& bind = m_Bind[bone];
+            switch (track) {
+                case AnimationTrack::PositionX: return bind.Position.x;
+                case AnimationTrack::PositionY: return bind.Position.y;
+                case AnimationTrack::Rotation: return bind.Rotation;
+                case AnimationTrack::ScaleX: return bind.Scale.x;
+                case AnimationTrack::ScaleY: return bind.Scale.y;
+                default: return 0.0f;
+            }
+        }
+        if (time <= curve.front().Time) {
+            return curve.front().Value;
+        }
+        if (time >= curve.back().Time) {
+            return curve.back().Value;
+        }
+        auto next = std::upper_bound(curve.begin(), curve.end(), time, [](float t, const Key& k) { return t < k.Time; });
+        const Key& b = *next;
+        const Key& a = *(next - 1);
+        float span = b.Time - a.Time;
+        float f = span > 0.0f ? (time - a.Time) / span : 1.0f;
+        return a.Value + (b.Value - a.Value) * f;
+    }
+
+    void AnimationClip::Bake(float sampleRate)
+    {
+        m_SampleRate = std::max(sampleRate, 1.0f);
+        // One extra frame at exactly the duration, so sampling never interpolates across the loop seam
+        m_FrameCount = (uint32_t)ceilf(m_Duration * m_SampleRate) + 1;
+
+        Pose frame;
+        frame.Resize(m_BoneCount);
+        m_FrameFloats = (uint32_t)frame.GetFloatCount();
+        m_Frames.resize((size_t)m_FrameCount * m_FrameFloats);
+
+        for (uint32_t index = 0; index < m_FrameCount; index++) {
+            float time = std::min((float)index / m_SampleRate, m_Duration);
+            for (uint32_t bone = 0; bone < m_BoneCount; bone++) {
+                BoneTransform transform;
+                transform.Position.x = EvaluateCurve(bone, AnimationTrack::PositionX, time);
+                transform.Position.y = EvaluateCurve(bone, AnimationTrack::PositionY, time);
+                transform.Rotation = EvaluateCurve(bone, AnimationTrack::Rotation, time);
+                transform.Scale.x = EvaluateCurve(bone, AnimationTrack::ScaleX, time);
+                transform.Scale.y = EvaluateCurve(bone, AnimationTrack::ScaleY, time);
+                frame.SetBone(bone, transform);
+            }
+            std::copy(frame.GetData(), frame.GetData() + m_FrameFloats, m_Frames.data() + (size_t)index * m_FrameFloats);
+        }
+    }
+
+    float AnimationClip::WrapTime(float time) const
+    {
+        if (m_Duration <= 0.0f) {
+            return 0.0f;
+        }
+        if (m_Loop) {
+            time = fmodf(time, m_Duration);
+            return time < 0.0f ? time + m_Duration : time;
+        }
+        return std::min(std::max(time, 0.0f), m_Duration);
+    }
+
+    void AnimationClip::Sample(float time, Pose& out) const
+    {
+        if (m_FrameCount == 0 || out.GetFloatCount() != m_FrameFloats) {
+            return;
+        }
+
+        float position = WrapTime(time) * m_SampleRate;
+        uint32_t index = std::min((uint32_t)position, m_FrameCount > 1 ? m_FrameCount - 2 : 0);
+        float f = std::min(std::max(position - (float)index, 0.0f), 1.0f);
+
+        const float* a = m_Frames.data() + (size_t)index * m_FrameFloats;
+        const float* b = m_FrameCount > 1 ? a + m_FrameFloats : a;
+        float* result = out.GetData();
+        SIMD::Float4 weight = SIMD::Set1(f);
+        for (uint32_t i = 0; i < m_FrameFloats; i += 4) {
+            SIMD::Float4 start = SIMD::Load(a + i);
+            SIMD::Store(result + i, SIMD::MulAdd(SIMD::Sub(SIMD::Load(b + i), start), weight, start));
+        }
+    }
+
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "Pose.h"
+#include <vector>
+
+namespace Marle {
+
+    class Skeleton;
+
+    enum class AnimationTrack : uint32_t {
+        PositionX = 0,
+        PositionY,
+        Rotation,       // Radians; keys interpolate linearly in angle, so 0 -> 2*pi is a full turn
+        ScaleX,
+        ScaleY,
+        Count
+    };
+
+    // Keyframed animation for one skeleton.
+    //
+    // Curves are authored per bone and track with AddKey, then Bake() resamples all of them at a
+    // fixed rate into a flat array of poses (every channel of every bone per frame, in Pose
+    // layout). Sampling is then the same for every clip and every bone: find two frames and lerp
+    // them with SIMD, with no per-curve key searches. Tracks without keys hold the bind pose.
+    class AnimationClip {
+    public:
+        static constexpr float DefaultSampleRate = 30.0f;
+
+        AnimationClip(const Skeleton& skeleton, float duration, bool loop = true);
+
+        // Keys may be added in any order; times are clamped to [0, duration]
+        void AddKey(uint32_t bone, AnimationTrack track, float time, float value);
+        void Bake(float sampleRate = DefaultSampleRate);
+
+        // Pose at `time` (wrapped or clamped, see WrapTime); `out` must match the skeleton
+        void Sample(float time, Pose& out) const;
+        float WrapTime(float time) const;
+
+        float GetDuration() const { return m_Duration; }
+        bool IsLooping() const { return m_Loop; }
+        bool IsBaked() const { return m_FrameCount > 0; }
+        uint32_t GetBoneCount() const { return m_BoneCount; }
+        uint32_t GetFrameCount() const { return m_FrameCount; }
+        size_t GetMemorySize() const { return m_Frames.size() * sizeof(float); }
+
+    private:
+        struct Key {
+            float Time;
+            float Value;
+        };
+
+        float EvaluateCurve(uint32_t bone, AnimationTrack track, float time) const;
+
+        float m_Duration = 0.0f;
+        bool m_Loop = true;
+        uint32_t m_BoneCount = 0;
+        std::vector<BoneTransform> m_Bind;
+        std::vector<std::vector<Key>> m_Curves;     // bone * Track count + track, sorted by time
+
+        float m_SampleRate = DefaultSampleRate;
+        uint32_t m_FrameCount = 0;
+        uint32_t m_FrameFloats = 0;                 // Pose::ChannelCount * padded bone count
+        TaggedVector<float, MemoryTag::Animation> m_Frames;
+    };
+
+}
@@ -0,0 +1,236 @@
+#include "mrlpch.h"
+#include "AnimationSystem.h"
+#include "../Core/JobSystem.h"
+#include "../Core/SystemScheduler.h"
+#include "../Renderer/Renderer2D.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace Marle {
+
+    static const uint32_t s_InstancesPerJob = 16;
+
+    AnimationSystem::~AnimationSystem()
+    {
+        if (m_VAO) {
+            glDeleteVertexArrays(1, &m_VAO);
+            glDeleteBuffers(1, &m_VBO);
+            glDeleteBuffers(1, &m_EBO);
+            MemoryTracker::TrackGpu(MemoryTag::Animation, -(int64_t)m_GpuBytes);
+        }
+    }
+
+    AnimationInstance AnimationSystem::CreateInstance(const std::shared_ptr<const Skeleton>& skeleton,
+                                                      const std::shared_ptr<const SkinnedMesh>& mesh)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        if (!skeleton || skeleton->GetBoneCount() == 0) {
+            printf("Error: Animation instance needs a skeleton with bones\n");
+            return InvalidInstance;
+        }
+        if (mesh && mesh->GetBoneCount() > skeleton->GetBoneCount()) {
+            printf("Error: Skinned mesh was built for %u bones, but the skeleton has %u\n", mesh->GetBoneCount(),
+                   skeleton->GetBoneCount());
+            return InvalidInstance;
+        }
+
+        AnimationInstance id;
+        if (!m_FreeInstances.empty()) {
+            id = m_FreeInstances.back();
+            m_FreeInstances.pop_back();
+        } else {
+            id = (AnimationInstance)m_Instances.size();
+            m_Instances.emplace_back();
+        }
+
+        Instance& instance = m_Instances[id];
+        instance.Alive = true;
+        instance.SkeletonData = skeleton;
+        instance.Mesh = mesh;
+        instance.Current = Layer();
+        instance.Previous = Layer();
+        instance.FadeElapsed = instance.FadeDuration = 0.0f;
+        instance.Root = Affine2D();
+        instance.LocalPose = skeleton->GetBindPose();
+        instance.FadePose = skeleton->GetBindPose();
+        instance.World.assign(skeleton->GetBoneCount(), Affine2D());
+        instance.Palette.assign(skeleton->GetBoneCount(), Affine2D());
+        UpdateInstance(instance, 0.0f);
+
+        m_LiveCount++;
+        m_LayoutDirty = true;
+        m_SkinDirty = true;
+        return id;
+    }
+
+    void AnimationSystem::DestroyInstance(AnimationInstance instance)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        if (!IsValid(instance)) {
+            return;
+        }
+        Instance& entry = m_Instances[instance];
+        entry.Alive = false;
+        entry.SkeletonData.reset();
+        entry.Mesh.reset();
+        entry.Current = Layer();
+        entry.Previous = Layer();
+        m_FreeInstances.push_back(instance);
+        m_LiveCount--;
+        m_LayoutDirty = true;
+        m_SkinDirty = true;
+    }
+
+    void AnimationSystem::Play(AnimationInstance instance, const std::shared_ptr<const AnimationClip>& clip, float fadeSeconds, float speed)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        if (!IsValid(instance) || !clip) {
+            return;
+        }
+        Instance& entry = m_Instances[instance];
+        if (!clip->IsBaked() || clip->GetBoneCount() != entry.SkeletonData->GetBoneCount()) {
+            printf("Error: Animation clip is not baked or was made for another skeleton\n");
+            return;
+        }
+
+        if (fadeSeconds > 0.0f && entry.Current.Clip) {
+            entry.Previous = entry.Current;
+            entry.FadeElapsed = 0.0f;
+            entry.FadeDuration = fadeSeconds;
+        } else {
+            entry.Previous = Layer();
+            entry.FadeDuration = 0.0f;
+        }
+        entry.Current.Clip = clip;
+        entry.Current.Time = 0.0f;
+        entry.Current.Speed = speed;
+    }
+
+    void AnimationSystem::SetSpeed(AnimationInstance instance, float speed)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        if (IsValid(instance)) {
+            m_Instances[instance].Current.Speed = speed;
+        }
+    }
+
+    void AnimationSystem::SetTransform(AnimationInstance instance, const glm::vec2& position, float rotation, const glm::vec2& scale)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        if (IsValid(instance)) {
+            m_Instances[instance].Root = Affine2D::FromTRS(position, rotation, scale);
+        }
+    }
+
+    const Affine2D& AnimationSystem::GetBoneWorld(AnimationInstance instance, uint32_t bone) const
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(false);
+        static const Affine2D identity;
+        if (!IsValid(instance) || bone >= m_Instances[instance].World.size()) {
+            return identity;
+        }
+        return m_Instances[instance].World[bone];
+    }
+
+    void AnimationSystem::UpdateInstance(Instance& instance, float dt)
+    {
+        const Skeleton& skeleton = *instance.SkeletonData;
+
+        if (instance.Current.Clip) {
+            instance.Current.Time = instance.Current.Clip->WrapTime(instance.Current.Time + dt * instance.Current.Speed);
+            instance.Current.Clip->Sample(instance.Current.Time, instance.LocalPose);
+
+            if (instance.Previous.Clip) {
+                instance.FadeElapsed += dt;
+                if (instance.FadeElapsed >= instance.FadeDuration) {
+                    instance.Previous = Layer();
+                } else {
+                    instance.Previous.Time = instance.Previous.Clip->WrapTime(instance.Previous.Time + dt * instance.Previous.Speed);
+                    instance.Previous.Clip->Sample(instance.Previous.Time, instance.FadePose);
+                    BlendPoses(instance.FadePose, instance.LocalPose, instance.FadeElapsed / instance.FadeDuration, instance.LocalPose);
+                }
+            }
+        }
+
+        ComputeWorldTransforms(skeleton.GetParents(), instance.LocalPose, instance.Root, instance.World.data());
+        ComputeSkinningPalette(instance.World.data(), skeleton.GetInverseBind(), skeleton.GetBoneCount(), instance.Palette.data());
+    }
+
+    void AnimationSystem::Update(float dt)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        auto start = std::chrono::steady_clock::now();
+
+        JobSystem::ParallelFor((uint32_t)m_Instances.size(), s_InstancesPerJob, [this, dt](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                if (m_Instances[i].Alive) {
+                    UpdateInstance(m_Instances[i], dt);
+                }
+            }
+        });
+
+        m_Stats.Instances = m_LiveCount;
+        m_Stats.Bones = 0;
+        m_Stats.Crossfades = 0;
+        for (const Instance& instance : m_Instances) {
+            if (instance.Alive) {
+                m_Stats.Bones += instance.SkeletonData->GetBoneCount();
+                m_Stats.Crossfades += instance.Previous.Clip ? 1 : 0;
+            }
+        }
+        m_Stats.UpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_SkinDirty = true;
+    }
+
+    void AnimationSystem::Skin()
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(true);
+        if (!m_SkinDirty) {
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+
+        // Instances are packed back to back; the combined index list only changes with them
+        if (m_LayoutDirty) {
+            uint32_t vertexCount = 0;
+            m_Indices.clear();
+            for (Instance& instance : m_Instances) {
+                if (!instance.Alive || !instance.Mesh) {
+                    continue;
+                }
+                instance.VertexOffset = vertexCount;
+                for (uint32_t index : instance.Mesh->GetIndices()) {
+                    m_Indices.push_back(vertexCount + index);
+                }
+                vertexCount += instance.Mesh->GetVertexCount();
+            }
+            m_Vertices.resize(vertexCount);
+            m_LayoutDirty = false;
+            m_IndicesUploaded = false;
+        }
+
+        JobSystem::ParallelFor((uint32_t)m_Instances.size(), s_InstancesPerJob, [this](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                const Instance& instance = m_Instances[i];
+                if (instance.Alive && instance.Mesh) {
+                    instance.Mesh->Skin(instance.Palette.data(), m_Vertices.data() + instance.VertexOffset);
+                }
+            }
+        });
+
+        m_Stats.Vertices = (uint32_t)m_Vertices.size();
+        m_Stats.SkinMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        m_SkinDirty = false;
+    }
+
+    void AnimationSystem::Render(OpenGLTexture2D* texture)
+    {
+        SystemScheduler::ValidateAccess<AnimationSystem>(false);
+        Skin();
+        if (!m_Indices.empty()) {
+            Renderer2D::DrawSkinnedMeshes(*this, texture);
+        }
+    }
+
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "AnimationClip.h"
+#include "Pose.h"
+#include "Skeleton.h"
+#include "SkinnedMesh.h"
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include <memory>
+#include <vector>
+
+namespace Marle {
+
+    class OpenGLTexture2D;
+
+    typedef uint32_t AnimationInstance;
+
+    // Every animated character in a scene. Update() runs in the fixed step and evaluates all
+    // instances in parallel on the JobSystem: advance clocks, sample the clip (and the one being
+    // faded out), blend, resolve the flat parent-ordered hierarchy and build the skinning
+    // palette. Skin() then deforms every mesh on the CPU into one shared vertex array, which
+    // Render() draws with a single call. Clips, skeletons and meshes are shared between
+    // instances and kept alive by them.
+    class AnimationSystem {
+    public:
+        static constexpr AnimationInstance InvalidInstance = ~0u;
+
+        AnimationSystem() = default;
+        ~AnimationSystem();
+
+        AnimationSystem(const AnimationSystem&) = delete;
+        AnimationSystem& operator=(const AnimationSystem&) = delete;
+
+        // The mesh is optional; instances without one are still posed (attachments, gameplay)
+        AnimationInstance CreateInstance(const std::shared_ptr<const Skeleton>& skeleton,
+                                         const std::shared_ptr<const SkinnedMesh>& mesh = nullptr);
+        void DestroyInstance(AnimationInstance instance);
+
+        // Starts a clip from its beginning; with fadeSeconds > 0 it crossfades from the current one
+        void Play(AnimationInstance instance, const std::shared_ptr<const AnimationClip>& clip,
+                  float fadeSeconds = 0.0f, float speed = 1.0f);
+        void SetSpeed(AnimationInstance instance, float speed);
+        void SetTransform(AnimationInstance instance, const glm::vec2& position, float rotation = 0.0f,
+                          const glm::vec2& scale = glm::vec2(1.0f));
+
+        // Fixed-step update of every instance
+        void Update(float dt);
+        // CPU skinning of every instance with a mesh; does nothing until the next Update
+        void Skin();
+        // Call between Renderer2D::BeginScene/EndScene; skins first if needed
+        void Render(OpenGLTexture2D* texture);
+
+        // Model-to-world transform of a bone after the last Update, e.g. for attachments
+        const Affine2D& GetBoneWorld(AnimationInstance instance, uint32_t bone) const;
+        uint32_t GetInstanceCount() const { return m_LiveCount; }
+
+        struct Stats {
+            uint32_t Instances = 0;
+            uint32_t Bones = 0;                 // Evaluated per Update
+            uint32_t Vertices = 0;              // Skinned per Skin
+            uint32_t Crossfades = 0;            // Instances blending two clips
+            double UpdateMs = 0.0;
+            double SkinMs = 0.0;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        friend class Renderer2D;
+
+        struct Layer {
+            std::shared_ptr<const AnimationClip> Clip;
+            float Time = 0.0f;
+            float Speed = 1.0f;
+        };
+
+        struct Instance {
+            bool Alive = false;
+            std::shared_ptr<const Skeleton> SkeletonData;
+            std::shared_ptr<const SkinnedMesh> Mesh;
+            Layer Current;
+            Layer Previous;                     // Fading out while FadeElapsed < FadeDuration
+            float FadeElapsed = 0.0f;
+            float FadeDuration = 0.0f;
+            Affine2D Root;
+            Pose LocalPose;
+            Pose FadePose;
+            TaggedVector<Affine2D, MemoryTag::Animation> World;
+            TaggedVector<Affine2D, MemoryTag::Animation> Palette;
+            uint32_t VertexOffset = 0;          // Into m_Vertices, assigned by Skin
+        };
+
+        void UpdateInstance(Instance& instance, float dt);
+        bool IsValid(AnimationInstance instance) const { return instance < m_Instances.size() && m_Instances[instance].Alive; }
+
+        std::vector<Instance> m_Instances;
+        std::vector<uint32_t> m_FreeInstances;
+        uint32_t m_LiveCount = 0;
+        bool m_SkinDirty = false;
+        bool m_LayoutDirty = true;              // Vertex offsets and the index buffer need rebuilding
+
+        TaggedVector<SkinnedVertex, MemoryTag::Animation> m_Vertices;
+        std::vector<uint32_t> m_Indices;        // Every instance's triangles, offset into m_Vertices
+        Stats m_Stats;
+
+        // Owned GPU buffers, created on first draw by Renderer2D
+        GLuint m_VAO = 0;
+        GLuint m_VBO = 0;
+        GLuint m_EBO = 0;
+        size_t m_GpuBytes = 0;
+        bool m_IndicesUploaded = false;
+    };
+
+}
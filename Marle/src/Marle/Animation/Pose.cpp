@@ -0,0 +1,143 @@
+#include "mrlpch.h"
+#include "Pose.h"
+#include "../Core/SIMD.h"
+
+#include <cmath>
+#include <vector>
+
+namespace Marle {
+
+    Affine2D Affine2D::FromTRS(const glm::vec2& translation, float rotation, const glm::vec2& scale)
+    {
+        float c = cosf(rotation);
+        float s = sinf(rotation);
+        Affine2D result;
+        result.A = c * scale.x;
+        result.B = s * scale.x;
+        result.C = -s * scale.y;
+        result.D = c * scale.y;
+        result.TX = translation.x;
+        result.TY = translation.y;
+        return result;
+    }
+
+    Affine2D Affine2D::Inverse() const
+    {
+        float determinant = A * D - B * C;
+        float inv = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+        Affine2D result;
+        result.A = D * inv;
+        result.B = -B * inv;
+        result.C = -C * inv;
+        result.D = A * inv;
+        result.TX = -(result.A * TX + result.C * TY);
+        result.TY = -(result.B * TX + result.D * TY);
+        return result;
+    }
+
+    void Pose::Resize(uint32_t boneCount)
+    {
+        m_BoneCount = boneCount;
+        m_Stride = (boneCount + 3) & ~3u;
+        m_Data.assign((size_t)m_Stride * ChannelCount, 0.0f);
+        // Padding bones stay valid identities so the SIMD loops never see a zero rotation
+        float* cosines = GetChannel(PoseChannel::RotationCos);
+        float* scaleX = GetChannel(PoseChannel::ScaleX);
+        float* scaleY = GetChannel(PoseChannel::ScaleY);
+        for (uint32_t bone = 0; bone < m_Stride; bone++) {
+            cosines[bone] = 1.0f;
+            scaleX[bone] = 1.0f;
+            scaleY[bone] = 1.0f;
+        }
+    }
+
+    void Pose::SetBone(uint32_t bone, const BoneTransform& transform)
+    {
+        GetChannel(PoseChannel::X)[bone] = transform.Position.x;
+        GetChannel(PoseChannel::Y)[bone] = transform.Position.y;
+        GetChannel(PoseChannel::RotationCos)[bone] = cosf(transform.Rotation);
+        GetChannel(PoseChannel::RotationSin)[bone] = sinf(transform.Rotation);
+        GetChannel(PoseChannel::ScaleX)[bone] = transform.Scale.x;
+        GetChannel(PoseChannel::ScaleY)[bone] = transform.Scale.y;
+    }
+
+    BoneTransform Pose::GetBone(uint32_t bone) const
+    {
+        BoneTransform transform;
+        transform.Position = { GetChannel(PoseChannel::X)[bone], GetChannel(PoseChannel::Y)[bone] };
+        transform.Rotation = atan2f(GetChannel(PoseChannel::RotationSin)[bone], GetChannel(PoseChannel::RotationCos)[bone]);
+        transform.Scale = { GetChannel(PoseChannel::ScaleX)[bone], GetChannel(PoseChannel::ScaleY)[bone] };
+        return transform;
+    }
+
+    void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out)
+    {
+        const float* from = a.GetData();
+        const float* to = b.GetData();
+        float* result = out.GetData();
+        const size_t count = a.GetFloatCount();
+
+        SIMD::Float4 w = SIMD::Set1(weight);
+        for (size_t i = 0; i < count; i += 4) {
+            SIMD::Float4 start = SIMD::Load(from + i);
+            SIMD::Store(result + i, SIMD::MulAdd(SIMD::Sub(SIMD::Load(to + i), start), w, start));
+        }
+    }
+
+    void ComputeWorldTransforms(const int32_t* parents, const Pose& pose, const Affine2D& root, Affine2D* world)
+    {
+        const uint32_t stride = pose.GetStride();
+        const uint32_t boneCount = pose.GetBoneCount();
+
+        // Local matrices for four bones at a time, renormalizing the blended rotations
+        static thread_local std::vector<float> s_Local;
+        s_Local.resize((size_t)stride * 6);
+        float* localA = s_Local.data();
+        float* localB = localA + stride;
+        float* localC = localB + stride;
+        float* localD = localC + stride;
+
+        const float* cosines = pose.GetChannel(PoseChannel::RotationCos);
+        const float* sines = pose.GetChannel(PoseChannel::RotationSin);
+        const float* scaleX = pose.GetChannel(PoseChannel::ScaleX);
+        const float* scaleY = pose.GetChannel(PoseChannel::ScaleY);
+        const SIMD::Float4 one = SIMD::Set1(1.0f);
+        const SIMD::Float4 epsilon = SIMD::Set1(1e-12f);
+        for (uint32_t bone = 0; bone < stride; bone += 4) {
+            SIMD::Float4 c = SIMD::Load(cosines + bone);
+            SIMD::Float4 s = SIMD::Load(sines + bone);
+            SIMD::Float4 length = SIMD::Sqrt(SIMD::Max(SIMD::MulAdd(c, c, SIMD::Mul(s, s)), epsilon));
+            SIMD::Float4 inv = SIMD::Div(one, length);
+            c = SIMD::Mul(c, inv);
+            s = SIMD::Mul(s, inv);
+            SIMD::Float4 sx = SIMD::Load(scaleX + bone);
+            SIMD::Float4 sy = SIMD::Load(scaleY + bone);
+            SIMD::Store(localA + bone, SIMD::Mul(c, sx));
+            SIMD::Store(localB + bone, SIMD::Mul(s, sx));
+            SIMD::Store(localC + bone, SIMD::Sub(SIMD::Zero(), SIMD::Mul(s, sy)));
+            SIMD::Store(localD + bone, SIMD::Mul(c, sy));
+        }
+
+        // Parents come first, so each parent is final by the time its children read it
+        const float* x = pose.GetChannel(PoseChannel::X);
+        const float* y = pose.GetChannel(PoseChannel::Y);
+        for (uint32_t bone = 0; bone < boneCount; bone++) {
+            Affine2D local;
+            local.A = localA[bone];
+            local.B = localB[bone];
+            local.C = localC[bone];
+            local.D = localD[bone];
+            local.TX = x[bone];
+            local.TY = y[bone];
+            world[bone] = (parents[bone] < 0 ? root : world[parents[bone]]) * local;
+        }
+    }
+
+    void ComputeSkinningPalette(const Affine2D* world, const Affine2D* inverseBind, uint32_t count, Affine2D* palette)
+    {
+        for (uint32_t bone = 0; bone < count; bone++) {
+            palette[bone] = world[bone] * inverseBind[bone];
+        }
+    }
+
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Marle {
+
+    // 2D affine transform stored as columns (A, B), (C, D), (TX, TY):
+    // x' = A * x + C * y + TX, y' = B * x + D * y + TY
+    struct Affine2D {
+        float A = 1.0f, B = 0.0f;
+        float C = 0.0f, D = 1.0f;
+        float TX = 0.0f, TY = 0.0f;
+
+        static Affine2D FromTRS(const glm::vec2& translation, float rotation, const glm::vec2& scale);
+
+        // This transform applied after `other`
+        Affine2D operator*(const Affine2D& other) const
+        {
+            Affine2D result;
+            result.A = A * other.A + C * other.B;
+            result.B = B * other.A + D * other.B;
+            result.C = A * other.C + C * other.D;
+            result.D = B * other.C + D * other.D;
+            result.TX = A * other.TX + C * other.TY + TX;
+            result.TY = B * other.TX + D * other.TY + TY;
+            return result;
+        }
+
+        glm::vec2 Transform(const glm::vec2& point) const
+        {
+            return glm::vec2(A * point.x + C * point.y + TX, B * point.x + D * point.y + TY);
+        }
+
+        Affine2D Inverse() const;
+    };
+
+    // Local transform of one bone relative to its parent
+    struct BoneTransform {
+        glm::vec2 Position = { 0.0f, 0.0f };
+        float Rotation = 0.0f;                  // Radians, counter-clockwise
+        glm::vec2 Scale = { 1.0f, 1.0f };
+    };
+
+    enum class PoseChannel : uint32_t {
+        X = 0,
+        Y,
+        RotationCos,
+        RotationSin,
+        ScaleX,
+        ScaleY,
+        Count
+    };
+
+    // Local bone transforms of one skeleton, one array per channel. Rotations are kept as unit
+    // complex numbers (cos, sin) so poses interpolate and blend with plain lerps and are
+    // renormalized once when converted to matrices. Channel arrays are padded to a multiple of
+    // four bones and stored back to back, so whole-pose operations are one SIMD loop.
+    class Pose {
+    public:
+        static constexpr uint32_t ChannelCount = (uint32_t)PoseChannel::Count;
+
+        void Resize(uint32_t boneCount);
+
+        uint32_t GetBoneCount() const { return m_BoneCount; }
+        uint32_t GetStride() const { return m_Stride; }            // Floats per channel
+        size_t GetFloatCount() const { return m_Data.size(); }     // Every channel, padding included
+
+        float* GetChannel(PoseChannel channel) { return m_Data.data() + (size_t)channel * m_Stride; }
+        const float* GetChannel(PoseChannel channel) const { return m_Data.data() + (size_t)channel * m_Stride; }
+        float* GetData() { return m_Data.data(); }
+        const float* GetData() const { return m_Data.data(); }
+
+        void SetBone(uint32_t bone, const BoneTransform& transform);
+        BoneTransform GetBone(uint32_t bone) const;
+
+    private:
+        uint32_t m_BoneCount = 0;
+        uint32_t m_Stride = 0;
+        TaggedVector<float, MemoryTag::Animation> m_Data;
+    };
+
+    // out = a + (b - a) * weight on every channel; out may be a or b. Both poses must have the
+    // same bone count.
+    void BlendPoses(const Pose& a, const Pose& b, float weight, Pose& out);
+
+    // Resolves local transforms into model space in one forward pass; bones must be ordered
+    // parent before child, and root bones (parent < 0) are placed by `root`.
+    void ComputeWorldTransforms(const int32_t* parents, const Pose& pose, const Affine2D& root, Affine2D* world);
+
+    // palette[i] = world[i] * inverseBind[i]: what skinning applies to bind-pose vertices
+    void ComputeSkinningPalette(const Affine2D* world, const Affine2D* inverseBind, uint32_t count, Affine2D* palette);
+
+}
@@ -0,0 +1,39 @@
+#include "mrlpch.h"
+#include "Skeleton.h"
+
+namespace Marle {
+
+    int32_t Skeleton::AddBone(const std::string& name, int32_t parent, const BoneTransform& bind)
+    {
+        if (parent != NoParent && (parent < 0 || parent >= (int32_t)m_Parents.size())) {
+            printf("Error: Bone '%s' added before its parent (%d)\n", name.c_str(), parent);
+            return -1;
+        }
+
+        int32_t bone = (int32_t)m_Parents.size();
+        m_Names.push_back(name);
+        m_Parents.push_back(parent);
+        m_BindLocal.push_back(bind);
+
+        Affine2D local = Affine2D::FromTRS(bind.Position, bind.Rotation, bind.Scale);
+        m_BindWorld.push_back(parent == NoParent ? local : m_BindWorld[parent] * local);
+        m_InverseBind.push_back(m_BindWorld.back().Inverse());
+
+        m_BindPose.Resize((uint32_t)m_Parents.size());
+        for (uint32_t i = 0; i < m_Parents.size(); i++) {
+            m_BindPose.SetBone(i, m_BindLocal[i]);
+        }
+        return bone;
+    }
+
+    int32_t Skeleton::FindBone(const std::string& name) const
+    {
+        for (uint32_t bone = 0; bone < m_Names.size(); bone++) {
+            if (m_Names[bone] == name) {
+                return (int32_t)bone;
+            }
+        }
+        return -1;
+    }
+
+}
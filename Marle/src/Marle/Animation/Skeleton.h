@@ -0,0 +1,42 @@
+#pragma once
+
+#include "../Core.h"
+#include "Pose.h"
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // Bone hierarchy with its bind (rest) pose. Bones can only be added after their parent, so
+    // the arrays are always parent-ordered and one forward pass resolves every world transform.
+    class Skeleton {
+    public:
+        static constexpr int32_t NoParent = -1;
+
+        // Returns the new bone's index, or -1 if the parent does not exist yet
+        int32_t AddBone(const std::string& name, int32_t parent, const BoneTransform& bind);
+
+        uint32_t GetBoneCount() const { return (uint32_t)m_Parents.size(); }
+        int32_t GetParent(uint32_t bone) const { return m_Parents[bone]; }
+        const int32_t* GetParents() const { return m_Parents.data(); }
+        const std::string& GetBoneName(uint32_t bone) const { return m_Names[bone]; }
+        // -1 when there is no such bone
+        int32_t FindBone(const std::string& name) const;
+
+        const Pose& GetBindPose() const { return m_BindPose; }
+        const BoneTransform& GetBindTransform(uint32_t bone) const { return m_BindLocal[bone]; }
+        // Model-space bind transforms and their inverses, which map bind-pose mesh vertices
+        // into each bone's space for skinning
+        const Affine2D* GetBindWorld() const { return m_BindWorld.data(); }
+        const Affine2D* GetInverseBind() const { return m_InverseBind.data(); }
+
+    private:
+        std::vector<std::string> m_Names;
+        std::vector<int32_t> m_Parents;
+        std::vector<BoneTransform> m_BindLocal;
+        std::vector<Affine2D> m_BindWorld;
+        std::vector<Affine2D> m_InverseBind;
+        Pose m_BindPose;
+    };
+
+}
@@ -0,0 +1,128 @@
+#include "mrlpch.h"
+#include "SkinnedMesh.h"
+#include "../Core/SIMD.h"
+#include "../Renderer/VertexBufferLayout.h"
+
+#include <algorithm>
+
+namespace Marle {
+
+    void SkinnedMesh::Grow()
+    {
+        uint32_t stride = std::max<uint32_t>(m_Stride * 2, 16);
+
+        auto regrow = [this, stride](auto& values, uint32_t groups) {
+            auto grown = values;
+            grown.assign((size_t)stride * groups, 0);
+            for (uint32_t group = 0; group < groups; group++) {
+                std::copy(values.begin() + (size_t)group * m_Stride, values.begin() + (size_t)group * m_Stride + m_VertexCount,
+                          grown.begin() + (size_t)group * stride);
+            }
+            values.swap(grown);
+        };
+        regrow(m_BindX, 1);
+        regrow(m_BindY, 1);
+        regrow(m_TexCoords, 1);
+        regrow(m_Bones, MaxInfluences);
+        regrow(m_Weights, MaxInfluences);
+        m_Stride = stride;
+    }
+
+    uint32_t SkinnedMesh::AddVertex(const glm::vec2& position, const glm::vec2& texCoord,
+                                    std::initializer_list<std::pair<uint32_t, float>> influences)
+    {
+        if (m_VertexCount == m_Stride) {
+            Grow();
+        }
+
+        uint32_t vertex = m_VertexCount++;
+        m_BindX[vertex] = position.x;
+        m_BindY[vertex] = position.y;
+        m_TexCoords[vertex] = PackUNorm16x2(texCoord);
+
+        float total = 0.0f;
+        uint32_t count = 0;
+        for (const auto& influence : influences) {
+            if (count == MaxInfluences) {
+                printf("Warning: Skinned vertex has more than %u influences; extra ones ignored\n", MaxInfluences);
+                break;
+            }
+            if (influence.second <= 0.0f) {
+                continue;
+            }
+            // Skin() indexes the palette with it, which has one entry per skeleton bone
+            if (influence.first >= m_BoneCount) {
+                printf("Error: Skinned vertex %u references bone %u, but the skeleton has %u bones; influence dropped\n",
+                       vertex, influence.first, m_BoneCount);
+                continue;
+            }
+            m_Bones[(size_t)count * m_Stride + vertex] = (int32_t)influence.first;
+            m_Weights[(size_t)count * m_Stride + vertex] = influence.second;
+            total += influence.second;
+            count++;
+        }
+        if (count == 0) {
+            // Unweighted vertices, and ones whose every bone was dropped, follow the root
+            m_Bones[vertex] = 0;
+            m_Weights[vertex] = 1.0f;
+            total = 1.0f;
+            count = 1;
+        }
+        for (uint32_t k = 0; k < count; k++) {
+            m_Weights[(size_t)k * m_Stride + vertex] /= total;
+        }
+        m_UsedInfluences = std::max(m_UsedInfluences, count);
+        return vertex;
+    }
+
+    void SkinnedMesh::AddTriangle(uint32_t a, uint32_t b, uint32_t c)
+    {
+        m_Indices.push_back(a);
+        m_Indices.push_back(b);
+        m_Indices.push_back(c);
+    }
+
+    size_t SkinnedMesh::GetMemorySize() const
+    {
+        return (size_t)m_Stride * (3 + MaxInfluences * 2) * sizeof(float) + m_Indices.size() * sizeof(uint32_t);
+    }
+
+    void SkinnedMesh::Skin(const Affine2D* palette, SkinnedVertex* out) const
+    {
+        for (uint32_t base = 0; base < m_VertexCount; base += 4) {
+            SIMD::Float4 x = SIMD::Load(&m_BindX[base]);
+            SIMD::Float4 y = SIMD::Load(&m_BindY[base]);
+            SIMD::Float4 resultX = SIMD::Zero();
+            SIMD::Float4 resultY = SIMD::Zero();
+
+            for (uint32_t k = 0; k < m_UsedInfluences; k++) {
+                const int32_t* bones = &m_Bones[(size_t)k * m_Stride + base];
+                const Affine2D& m0 = palette[bones[0]];
+                const Affine2D& m1 = palette[bones[1]];
+                const Affine2D& m2 = palette[bones[2]];
+                const Affine2D& m3 = palette[bones[3]];
+                SIMD::Float4 w = SIMD::Load(&m_Weights[(size_t)k * m_Stride + base]);
+
+                // x' = A x + C y + TX, y' = B x + D y + TY for each lane's bone
+                SIMD::Float4 px = SIMD::MulAdd(SIMD::Set(m0.A, m1.A, m2.A, m3.A), x,
+                                  SIMD::MulAdd(SIMD::Set(m0.C, m1.C, m2.C, m3.C), y, SIMD::Set(m0.TX, m1.TX, m2.TX, m3.TX)));
+                SIMD::Float4 py = SIMD::MulAdd(SIMD::Set(m0.B, m1.B, m2.B, m3.B), x,
+                                  SIMD::MulAdd(SIMD::Set(m0.D, m1.D, m2.D, m3.D), y, SIMD::Set(m0.TY, m1.TY, m2.TY, m3.TY)));
+                resultX = SIMD::MulAdd(px, w, resultX);
+                resultY = SIMD::MulAdd(py, w, resultY);
+            }
+
+            float skinnedX[4];
+            float skinnedY[4];
+            SIMD::Store(skinnedX, resultX);
+            SIMD::Store(skinnedY, resultY);
+            uint32_t lanes = std::min<uint32_t>(4, m_VertexCount - base);
+            for (uint32_t lane = 0; lane < lanes; lane++) {
+                SkinnedVertex& vertex = out[base + lane];
+                vertex.Position = glm::vec2(skinnedX[lane], skinnedY[lane]);
+                vertex.TexCoord = m_TexCoords[base + lane];
+            }
+        }
+    }
+
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "Pose.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <initializer_list>
+#include <utility>
+#include <vector>
+
+namespace Marle {
+
+    // Output of CPU skinning, streamed to the GPU as is: 12 bytes
+    struct SkinnedVertex {
+        glm::vec2 Position;
+        uint32_t TexCoord;      // VertexFormat::UNorm16x2
+    };
+
+    // Triangle mesh in the skeleton's bind pose. Each vertex follows up to four bones with
+    // normalized weights (linear blend skinning). Vertex data is SoA and padded to a multiple
+    // of four so Skin() deforms four vertices per SIMD instruction.
+    class SkinnedMesh {
+    public:
+        static constexpr uint32_t MaxInfluences = 4;
+
+        // boneCount is that of the skeleton the mesh is skinned with; influences name bones below it
+        explicit SkinnedMesh(uint32_t boneCount) : m_BoneCount(boneCount) {}
+
+        // Position in model space (bind pose); texCoord within 0..1; influences are (bone, weight)
+        // pairs. Influences on bones the skeleton does not have are dropped with an error.
+        uint32_t AddVertex(const glm::vec2& position, const glm::vec2& texCoord,
+                           std::initializer_list<std::pair<uint32_t, float>> influences);
+        void AddTriangle(uint32_t a, uint32_t b, uint32_t c);
+
+        uint32_t GetBoneCount() const { return m_BoneCount; }
+        uint32_t GetVertexCount() const { return m_VertexCount; }
+        const std::vector<uint32_t>& GetIndices() const { return m_Indices; }
+        size_t GetMemorySize() const;
+
+        // Deforms every vertex by `palette` (world * inverse bind per bone, see
+        // ComputeSkinningPalette) and writes GetVertexCount() vertices to `out`
+        void Skin(const Affine2D* palette, SkinnedVertex* out) const;
+
+    private:
+        void Grow();
+
+        uint32_t m_BoneCount = 0;
+        uint32_t m_VertexCount = 0;
+        uint32_t m_Stride = 0;                      // Capacity, a multiple of 4
+        uint32_t m_UsedInfluences = 0;              // Highest influence count of any vertex
+        TaggedVector<float, MemoryTag::Animation> m_BindX, m_BindY;
+        TaggedVector<uint32_t, MemoryTag::Animation> m_TexCoords;    // Packed as SkinnedVertex stores them
+        TaggedVector<int32_t, MemoryTag::Animation> m_Bones;      // Influence k of vertex v at k * stride + v
+        TaggedVector<float, MemoryTag::Animation> m_Weights;
+        std::vector<uint32_t> m_Indices;
+    };
+
+}
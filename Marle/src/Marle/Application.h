@@ -13,6 +13,9 @@ namespace Marle
             virtual ~Application();
             
             void Run();
+            // Ends the loop after the current frame
+            void Close() { m_Running = false; }
+            bool IsHeadless() const { return m_WindowProps.Headless; }
             virtual void OnEvent(Event& e);
 
         protected:
@@ -20,6 +23,8 @@ namespace Marle
             virtual void OnRender(double interpolation_alpha); // For rendering, alpha for interpolation
 
         private:
+            // Fixed updates paced by sleeping, no rendering; shared by every platform
+            void RunHeadless();
             void InitWindow();
             void ShutdownWindow();
             void InitGraphics();
@@ -3,6 +3,20 @@
 #include "Events/KeyEvent.h"
 #include "Events/ApplicationEvent.h"
 #include "Renderer/Renderer2D.h"
+#include "Renderer/RenderGraph.h"
+#include "Renderer/RenderProfiler.h"
+#include "Renderer/TextureStreamer.h"
+#include "Core/FileSystem.h"
+#include "Core/FrameTaskScheduler.h"
+#include "Core/JobSystem.h"
+#include "Core/MemoryTracker.h"
+#include "Core/Metrics.h"
+#include "Core/ResourceManager.h"
+#include "Core/SystemScheduler.h"
+#include "Audio/AudioEngine.h"
+
+#include <chrono>
+#include <thread>
 
 #ifdef MRL_PLATFORM_MACOS
 #define GL_SILENCE_DEPRECATION
@@ -36,6 +50,66 @@ double GetCurrentTimeSeconds() {
 
 namespace Marle {
 
+    // Health of the whole engine, recorded by the frame loop for external readers (MarleStat)
+    struct FrameMetrics {
+        MetricId Frames = Metrics::InvalidMetric;
+        MetricId FrameMs = Metrics::InvalidMetric;
+        MetricId HeapBytes = Metrics::InvalidMetric;
+        MetricId GpuBytes = Metrics::InvalidMetric;
+        MetricId TextureResidentBytes = Metrics::InvalidMetric;
+        MetricId TexturePendingLoads = Metrics::InvalidMetric;
+        MetricId ResourcesLoading = Metrics::InvalidMetric;
+        MetricId TasksPending = Metrics::InvalidMetric;
+        MetricId TaskBudgetMs = Metrics::InvalidMetric;
+    };
+    static FrameMetrics s_FrameMetrics;
+
+    static void RegisterFrameMetrics()
+    {
+        static const double frameMsBounds[] = { 4.0, 8.0, 12.0, 16.7, 20.0, 25.0, 33.3, 50.0, 100.0, 250.0 };
+        s_FrameMetrics.Frames = Metrics::RegisterCounter("marle_frames_total", "Frames run");
+        s_FrameMetrics.FrameMs = Metrics::RegisterHistogram("marle_frame_ms", "Wall time from one frame to the next",
+                                                            frameMsBounds, sizeof(frameMsBounds) / sizeof(frameMsBounds[0]));
+        s_FrameMetrics.HeapBytes = Metrics::RegisterGauge("marle_memory_heap_bytes", "Heap memory allocated through the engine allocators");
+        s_FrameMetrics.GpuBytes = Metrics::RegisterGauge("marle_memory_gpu_bytes", "Estimated GPU memory");
+        s_FrameMetrics.TextureResidentBytes = Metrics::RegisterGauge("marle_textures_resident_bytes", "Streamed texture levels on the GPU");
+        s_FrameMetrics.TexturePendingLoads = Metrics::RegisterGauge("marle_textures_pending_loads", "Texture levels being read or waiting for upload");
+        s_FrameMetrics.ResourcesLoading = Metrics::RegisterGauge("marle_resources_loading", "Resources with an async load in flight");
+        s_FrameMetrics.TasksPending = Metrics::RegisterGauge("marle_frame_tasks_pending", "Amortized tasks not finished yet");
+        s_FrameMetrics.TaskBudgetMs = Metrics::RegisterGauge("marle_frame_task_budget_ms", "Time granted to amortized tasks last frame");
+    }
+
+    static void RecordFrameMetrics(double frameMs)
+    {
+        Metrics::Increment(s_FrameMetrics.Frames);
+        Metrics::Observe(s_FrameMetrics.FrameMs, frameMs);
+
+        // The gauges walk subsystem state; skip them while nobody is looking
+        if (Metrics::HasReaders()) {
+            size_t heapBytes = 0, gpuBytes = 0;
+            for (uint32_t tag = 0; tag < (uint32_t)MemoryTag::Count; tag++) {
+                MemoryTracker::TagStats memory = MemoryTracker::GetStats((MemoryTag)tag);
+                heapBytes += memory.CurrentBytes;
+                gpuBytes += memory.GpuBytes;
+            }
+            uint32_t loading = 0;
+            for (uint32_t type = 0; type < (uint32_t)ResourceType::Count; type++) {
+                loading += ResourceManager::GetStats((ResourceType)type).Loading;
+            }
+            TextureStreamer::Stats textures = TextureStreamer::GetStats();
+            const FrameTaskScheduler::Stats& tasks = FrameTaskScheduler::GetStats();
+
+            Metrics::SetGauge(s_FrameMetrics.HeapBytes, (double)heapBytes);
+            Metrics::SetGauge(s_FrameMetrics.GpuBytes, (double)gpuBytes);
+            Metrics::SetGauge(s_FrameMetrics.TextureResidentBytes, (double)textures.ResidentBytes);
+            Metrics::SetGauge(s_FrameMetrics.TexturePendingLoads, textures.PendingLoads);
+            Metrics::SetGauge(s_FrameMetrics.ResourcesLoading, loading);
+            Metrics::SetGauge(s_FrameMetrics.TasksPending, tasks.Pending);
+            Metrics::SetGauge(s_FrameMetrics.TaskBudgetMs, tasks.BudgetMs);
+        }
+        Metrics::Publish();
+    }
+
     Application::Application(const WindowProps& props) 
         : m_WindowProps(props)
     #ifdef MRL_PLATFORM_MACOS
@@ -43,8 +117,18 @@ namespace Marle {
     #endif
     {
         printf("Creating Marle Application: %s\n", m_WindowProps.Title);
-        InitWindow();
-        InitGraphics();
+        MemoryTracker::Init();
+        Metrics::Init();
+        RegisterFrameMetrics();
+        JobSystem::Init();
+        FileSystem::Init();
+        SystemScheduler::Init();
+        FrameTaskScheduler::Init();
+        AudioEngine::Init(std::make_unique<NullAudioDevice>()); // Silent until a platform device exists
+        if (!m_WindowProps.Headless) {
+            InitWindow();
+            InitGraphics();
+        }
         
         // Initialize last frame time
     #ifdef MRL_PLATFORM_MACOS
@@ -57,8 +141,17 @@ namespace Marle {
     Application::~Application()
     {
         printf("Destroying Marle Application\n");
-        ShutdownGraphics();
-        ShutdownWindow();
+        if (!m_WindowProps.Headless) {
+            ShutdownGraphics();
+            ShutdownWindow();
+        }
+        AudioEngine::Shutdown();
+        FrameTaskScheduler::Shutdown();
+        SystemScheduler::Shutdown();
+        FileSystem::Shutdown();
+        JobSystem::Shutdown();
+        Metrics::Shutdown();
+        MemoryTracker::Shutdown();
     }
 
     void Application::OnEvent(Event& e)
@@ -79,6 +172,44 @@ namespace Marle {
         // but eventually, those might move into a more structured rendering system called from here.
     }
 
+    void Application::RunHeadless()
+    {
+        printf("Application headless loop started\n");
+
+        using Clock = std::chrono::steady_clock;
+        const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_FixedDeltaTime));
+        auto deadline = Clock::now();
+        auto lastStep = deadline;
+        FrameTaskScheduler::SetTargetFrameMs(m_FixedDeltaTime * 1000.0); // Each step is a frame here
+
+        while (m_Running)
+        {
+            auto stepStart = Clock::now();
+            double stepMs = std::chrono::duration<double, std::milli>(stepStart - lastStep).count();
+            lastStep = stepStart;
+
+            MemoryTracker::NewFrame();
+            FrameTaskScheduler::BeginFrame();
+            SystemScheduler::Execute(m_FixedDeltaTime);
+            OnUpdate(m_FixedDeltaTime);
+            AudioEngine::Update();
+            FileSystem::Update();
+            FrameTaskScheduler::Execute(); // Amortized tasks get what is left of the step
+            RecordFrameMetrics(stepMs);
+
+            // Sleep until the next step; after a long stall, restart the clock instead of catching up
+            deadline += step;
+            auto now = Clock::now();
+            if (now > deadline + step * 15) {
+                deadline = now;
+            } else {
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+
+        printf("Application headless loop ended\n");
+    }
+
 #ifdef MRL_PLATFORM_MACOS
 
     void Application::InitWindow()
@@ -169,16 +300,22 @@ namespace Marle {
         glViewport(0, 0, m_WindowProps.Width, m_WindowProps.Height);
         glClearColor(0.1f, 0.1f, 0.15f, 1.0f); // Dark moody blue/gray
         
-        // Initialize Renderer2D
+        // Initialize the resource cache (shaders, textures, fonts), then Renderer2D
+        ResourceManager::Init();
         Renderer2D::Init();
+        RenderGraph::Init();
+        RenderProfiler::Init();
         
         printf("OpenGL context initialization complete\n");
     }
 
     void Application::ShutdownGraphics()
     {
-        // Shutdown Renderer2D first
+        // Shutdown Renderer2D first, then release the resources it and the game held
+        RenderProfiler::Shutdown();
+        RenderGraph::Shutdown();
         Renderer2D::Shutdown();
+        ResourceManager::Shutdown();
         
         if (m_GLContext) {
             NSOpenGLContext* context = (__bridge NSOpenGLContext*)m_GLContext;
@@ -202,6 +339,10 @@ namespace Marle {
 
     void Application::Run()
     {
+        if (m_WindowProps.Headless) {
+            RunHeadless();
+            return;
+        }
         printf("Application Run loop started (macOS)\n");
         
         NSWindow* window = (__bridge NSWindow*)m_Window;
@@ -227,9 +368,14 @@ namespace Marle {
                 break;
             }
             
+            MemoryTracker::NewFrame();
+            RenderProfiler::BeginFrame(); // CPU frame time covers updates and command submission
+            FrameTaskScheduler::BeginFrame(); // Measures the frame the task budget is carved from
+
             // 2. Calculate Frame Time
             double current_time = GetCurrentTimeSeconds();
             double frame_time = current_time - m_LastFrameTime;
+            double frame_ms = frame_time * 1000.0; // Reported unclamped, stalls included
             m_LastFrameTime = current_time;
 
             // Optional: Clamp frame_time to avoid spiral of death if debugging or extreme stalls
@@ -244,7 +390,7 @@ namespace Marle {
                 // --- Input Polling could go here if needed (e.g., IsKeyPressed) ---
                 
                 // --- Core Engine Subsystem Updates (e.g., Physics, Animation) ---
-                // (None yet)
+                SystemScheduler::Execute(m_FixedDeltaTime); // Registered systems, in parallel where their data allows
 
                 // --- Game Specific Update ---
                 OnUpdate(m_FixedDeltaTime); // Call the virtual update method
@@ -252,21 +398,34 @@ namespace Marle {
                 m_Accumulator -= m_FixedDeltaTime;
                 // m_TotalGameTime += m_FixedDeltaTime; // Optional: track total game time
             }
+            AudioEngine::Update(); // Recycle voices the mixer has finished
 
             // 4. Rendering
             double interpolation_alpha = m_Accumulator / m_FixedDeltaTime; // For smooth rendering between states
 
             // --- Clear Screen ---
             [context makeCurrentContext];
+            FileSystem::Update(); // Submit this frame's file reads, run the callbacks of finished ones
+            ResourceManager::Update(); // Finish async loads, evict cached resources over budget
             glClear(GL_COLOR_BUFFER_BIT);
+            RenderGraph::BeginFrame(m_WindowProps.Width, m_WindowProps.Height);
 
             // --- Call Game Specific Render ---
-            OnRender(interpolation_alpha); // Call the virtual render method
+            OnRender(interpolation_alpha); // Call the virtual render method (draws directly or adds graph passes)
+            RenderGraph::Execute();
 
             // --- UI Rendering / Debug Rendering could go here ---
 
+            // --- Amortized Work: incremental tasks get whatever the frame has left ---
+            FrameTaskScheduler::Execute();
+
+            RenderProfiler::EndFrame();
+
             // --- Swap Buffers ---
             [context flushBuffer];
+
+            // --- Metrics: record the frame and publish if anyone is reading ---
+            RecordFrameMetrics(frame_ms);
         }
         
         printf("Application Run loop ended\n");
@@ -296,6 +455,10 @@ namespace Marle {
 
     void Application::Run()
     {
+        if (m_WindowProps.Headless) {
+            RunHeadless();
+            return;
+        }
         printf("Run loop not implemented for this platform\n");
         while(m_Running)
         {
@@ -0,0 +1,67 @@
+#include "mrlpch.h"
+#include "AudioClip.h"
+#include "WavFile.h"
+
+#include <vector>
+
+namespace Marle {
+
+    std::shared_ptr<AudioClip> AudioClip::LoadWav(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        if (!file) {
+            printf("Error: Could not open audio file %s\n", path.c_str());
+            return nullptr;
+        }
+
+        WavInfo info;
+        if (!ReadWavHeader(file, info)) {
+            printf("Error: Failed to load %s\n", path.c_str());
+            fclose(file);
+            return nullptr;
+        }
+
+        size_t bytes = (size_t)info.FrameCount * info.GetFrameSize();
+        std::vector<uint8_t> raw(bytes);
+        size_t read = fread(raw.data(), 1, bytes, file);
+        fclose(file);
+        if (read != bytes) {
+            printf("Warning: %s is truncated (%zu of %zu bytes)\n", path.c_str(), read, bytes);
+        }
+
+        uint32_t frames = (uint32_t)(read / info.GetFrameSize());
+        std::vector<float> interleaved((size_t)frames * info.Channels);
+        ConvertWavSamples(raw.data(), info, interleaved.data(), interleaved.size());
+
+        printf("Loaded audio: %s (%u Hz, %u channels, %.2f s)\n", path.c_str(), info.SampleRate, info.Channels,
+               (float)frames / (float)info.SampleRate);
+        return Create(info.SampleRate, info.Channels, interleaved.data(), frames);
+    }
+
+    std::shared_ptr<AudioClip> AudioClip::Create(uint32_t sampleRate, uint32_t channels, const float* interleaved, uint32_t frames)
+    {
+        if (channels == 0 || channels > 2 || sampleRate == 0) {
+            printf("Error: AudioClip needs 1 or 2 channels and a sample rate\n");
+            return nullptr;
+        }
+
+        auto clip = std::make_shared<AudioClip>();
+        clip->m_SampleRate = sampleRate;
+        clip->m_Channels = channels;
+        clip->m_FrameCount = frames;
+        clip->SetInterleaved(interleaved);
+        return clip;
+    }
+
+    void AudioClip::SetInterleaved(const float* interleaved)
+    {
+        m_Samples.resize((size_t)m_FrameCount * m_Channels);
+        for (uint32_t c = 0; c < m_Channels; c++) {
+            float* channel = m_Samples.data() + (size_t)c * m_FrameCount;
+            for (uint32_t i = 0; i < m_FrameCount; i++) {
+                channel[i] = interleaved[(size_t)i * m_Channels + c];
+            }
+        }
+    }
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Marle {
+
+    // Fully decoded sound (effects, short loops). Samples are stored planar, one contiguous
+    // float array per channel, so the mixer can load them four at a time. Long music should
+    // be streamed with AudioEngine::PlayStream instead.
+    class AudioClip {
+    public:
+        // 8/16/24-bit PCM or 32-bit float WAV, mono or stereo
+        static std::shared_ptr<AudioClip> LoadWav(const std::string& path);
+        // From interleaved samples, e.g. generated tones
+        static std::shared_ptr<AudioClip> Create(uint32_t sampleRate, uint32_t channels, const float* interleaved, uint32_t frames);
+
+        uint32_t GetSampleRate() const { return m_SampleRate; }
+        uint32_t GetChannels() const { return m_Channels; }
+        uint32_t GetFrameCount() const { return m_FrameCount; }
+        float GetDuration() const { return m_SampleRate ? (float)m_FrameCount / (float)m_SampleRate : 0.0f; }
+        const float* GetChannel(uint32_t channel) const { return m_Samples.data() + (size_t)channel * m_FrameCount; }
+        size_t GetMemorySize() const { return m_Samples.size() * sizeof(float); }
+
+    private:
+        void SetInterleaved(const float* interleaved);
+
+        uint32_t m_SampleRate = 0;
+        uint32_t m_Channels = 0;
+        uint32_t m_FrameCount = 0;
+        TaggedVector<float, MemoryTag::Audio> m_Samples;
+    };
+
+}
@@ -0,0 +1,119 @@
+#include "mrlpch.h"
+#include "AudioDevice.h"
+#include "WavFile.h"
+
+#include <chrono>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+namespace Marle {
+
+    ThreadedAudioDevice::~ThreadedAudioDevice()
+    {
+        Stop();
+    }
+
+    bool ThreadedAudioDevice::Start(const AudioFormat& format, const RenderCallback& render)
+    {
+        if (m_Running.load()) {
+            printf("Error: Audio device %s is already running\n", GetName());
+            return false;
+        }
+        if (!Open(format)) {
+            return false;
+        }
+
+        m_Format = format;
+        m_Render = render;
+        m_Running.store(true);
+        m_Thread = std::thread([this]() { ThreadMain(); });
+        return true;
+    }
+
+    void ThreadedAudioDevice::Stop()
+    {
+        if (!m_Running.exchange(false)) {
+            return;
+        }
+        if (m_Thread.joinable()) {
+            m_Thread.join();
+        }
+        Close();
+    }
+
+    void ThreadedAudioDevice::ThreadMain()
+    {
+    #if defined(__unix__) || defined(__APPLE__)
+        if (m_Realtime) {
+            // Usually needs privileges; the normal priority is kept when refused
+            sched_param param = {};
+            param.sched_priority = sched_get_priority_min(SCHED_FIFO) + 10;
+            pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        }
+    #endif
+
+        std::vector<float> buffer((size_t)m_Format.PeriodFrames * m_Format.Channels);
+        const auto period = std::chrono::nanoseconds((uint64_t)m_Format.PeriodFrames * 1000000000ull / m_Format.SampleRate);
+        auto deadline = std::chrono::steady_clock::now();
+
+        while (m_Running.load(std::memory_order_relaxed)) {
+            m_Render(buffer.data(), m_Format.PeriodFrames);
+            Write(buffer.data(), m_Format.PeriodFrames);
+
+            if (!m_Realtime) {
+                continue;
+            }
+            deadline += period;
+            auto now = std::chrono::steady_clock::now();
+            if (now > deadline + period) {
+                // A hardware device would have played silence here; restart the clock from now
+                m_Underruns.fetch_add(1, std::memory_order_relaxed);
+                deadline = now;
+            } else {
+                std::this_thread::sleep_until(deadline);
+            }
+        }
+    }
+
+    WavFileAudioDevice::~WavFileAudioDevice()
+    {
+        // Close() is virtual, so the file has to be finished before this class goes away
+        Stop();
+    }
+
+    bool WavFileAudioDevice::Open(const AudioFormat& format)
+    {
+        m_File = fopen(m_Path.c_str(), "wb");
+        if (!m_File) {
+            printf("Error: Could not open %s for audio output\n", m_Path.c_str());
+            return false;
+        }
+        m_Channels = format.Channels;
+        m_DataBytes = 0;
+        WriteWavHeader(m_File, format.Channels, format.SampleRate, 0);
+        return true;
+    }
+
+    void WavFileAudioDevice::Write(const float* samples, uint32_t frames)
+    {
+        size_t count = (size_t)frames * m_Channels;
+        m_DataBytes += fwrite(samples, sizeof(float), count, m_File) * sizeof(float);
+    }
+
+    void WavFileAudioDevice::Close()
+    {
+        if (!m_File) {
+            return;
+        }
+        // RIFF sizes are 32-bit; anything past 4 GB is still written but the header saturates
+        PatchWavHeader(m_File, m_DataBytes > 0xFFFFFFDBull ? 0xFFFFFFDBu : (uint32_t)m_DataBytes);
+        fclose(m_File);
+        m_File = nullptr;
+        printf("Wrote %s (%.2f MB of audio)\n", m_Path.c_str(), m_DataBytes / (1024.0 * 1024.0));
+    }
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "../Core.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace Marle {
+
+    struct AudioFormat {
+        uint32_t SampleRate = 48000;
+        uint32_t Channels = 2;          // The mixer renders stereo
+        uint32_t PeriodFrames = 256;    // Frames per callback; 5.3 ms at 48 kHz
+    };
+
+    // Output backend. The device owns the audio thread and calls the render callback once per
+    // period for interleaved float frames. Platform devices (CoreAudio, ALSA) implement this
+    // directly; the file and null devices below share a software clock.
+    class AudioDevice {
+    public:
+        typedef std::function<void(float* output, uint32_t frames)> RenderCallback;
+
+        virtual ~AudioDevice() = default;
+
+        virtual bool Start(const AudioFormat& format, const RenderCallback& render) = 0;
+        virtual void Stop() = 0;
+        virtual const char* GetName() const = 0;
+        // Frames queued between the mixer and the listener
+        virtual uint32_t GetLatencyFrames() const = 0;
+        // Periods the callback finished too late for
+        virtual uint64_t GetUnderruns() const { return 0; }
+    };
+
+    // Runs the callback on its own thread, either paced by the sample clock (sleeping until each
+    // period is due, raised to real-time priority where the OS allows) or back to back for
+    // offline rendering.
+    class ThreadedAudioDevice : public AudioDevice {
+    public:
+        ThreadedAudioDevice(bool realtime) : m_Realtime(realtime) {}
+        ~ThreadedAudioDevice() override;
+
+        bool Start(const AudioFormat& format, const RenderCallback& render) override;
+        void Stop() override;
+        uint32_t GetLatencyFrames() const override { return m_Format.PeriodFrames; }
+        uint64_t GetUnderruns() const override { return m_Underruns.load(std::memory_order_relaxed); }
+
+    protected:
+        virtual bool Open(const AudioFormat& /*format*/) { return true; }
+        virtual void Write(const float* /*samples*/, uint32_t /*frames*/) {}
+        virtual void Close() {}
+
+    private:
+        void ThreadMain();
+
+        bool m_Realtime;
+        AudioFormat m_Format;
+        RenderCallback m_Render;
+        std::thread m_Thread;
+        std::atomic<bool> m_Running{ false };
+        std::atomic<uint64_t> m_Underruns{ 0 };
+    };
+
+    // Discards the mix; for servers, tests and benchmarks
+    class NullAudioDevice : public ThreadedAudioDevice {
+    public:
+        NullAudioDevice(bool realtime = true) : ThreadedAudioDevice(realtime) {}
+        const char* GetName() const override { return "Null"; }
+    };
+
+    // Records the mix to a 32-bit float WAV file
+    class WavFileAudioDevice : public ThreadedAudioDevice {
+    public:
+        WavFileAudioDevice(const std::string& path, bool realtime = true) : ThreadedAudioDevice(realtime), m_Path(path) {}
+        ~WavFileAudioDevice() override;
+        const char* GetName() const override { return "WAV file"; }
+
+    protected:
+        bool Open(const AudioFormat& format) override;
+        void Write(const float* samples, uint32_t frames) override;
+        void Close() override;
+
+    private:
+        std::string m_Path;
+        FILE* m_File = nullptr;
+        uint32_t m_Channels = 0;
+        uint64_t m_DataBytes = 0;
+    };
+
+}
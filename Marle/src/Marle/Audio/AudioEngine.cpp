@@ -0,0 +1,424 @@
+#include "mrlpch.h"
+#include "AudioEngine.h"
+#include "AudioClip.h"
+#include "AudioStream.h"
+#include "../Core/SPSCQueue.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Marle {
+
+    static uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Game-side view of a mixer voice slot; owns what the mixer is reading from
+    struct VoiceSlot {
+        uint16_t Generation = 0;
+        bool InUse = false;
+        std::shared_ptr<AudioClip> Clip;
+        std::unique_ptr<AudioStream> Stream;
+    };
+
+    struct AudioEngine::AudioEngineData {
+        AudioConfig Config;
+        std::unique_ptr<AudioDevice> Device;
+        std::unique_ptr<AudioMixer> Mixer;
+        SPSCQueue<AudioCommand> Commands;   // Game thread -> audio thread
+        SPSCQueue<uint32_t> Finished;       // Audio thread -> game thread
+
+        std::vector<VoiceSlot> Slots;
+        std::vector<uint32_t> FreeSlots;
+        uint32_t ActiveVoices = 0;
+        uint32_t PeakVoices = 0;
+        uint64_t DroppedCommands = 0;
+        uint64_t RejectedPlays = 0;
+
+        // Streams are only ever deleted by the streaming thread, so it can fill them unlocked
+        std::thread Streamer;
+        std::mutex StreamMutex;
+        std::condition_variable StreamWake;
+        std::vector<AudioStream*> Streams;
+        std::vector<std::unique_ptr<AudioStream>> RetiredStreams;
+        bool StreamerRunning = true;
+
+        // Audio thread statistics, published four times a second
+        uint64_t WindowFrames = 0;
+        uint64_t WindowMixNs = 0;
+        uint64_t WindowMixMaxNs = 0;
+        uint32_t WindowPeriods = 0;
+        uint64_t WindowLatencyNs = 0;
+        uint32_t WindowCommands = 0;
+        std::atomic<uint64_t> MixAverageNs{ 0 };
+        std::atomic<uint64_t> MixMaxNs{ 0 };
+        std::atomic<uint64_t> CommandLatencyNs{ 0 };
+        std::atomic<uint64_t> VoicesStarted{ 0 };
+        std::atomic<uint64_t> StreamUnderruns{ 0 };
+
+        AudioEngineData(const AudioConfig& config)
+            : Config(config), Commands(config.CommandQueueSize), Finished(config.MaxVoices + 1)
+        {
+        }
+    };
+
+    std::unique_ptr<AudioEngine::AudioEngineData> AudioEngine::s_Data = nullptr;
+
+    bool AudioEngine::Init(std::unique_ptr<AudioDevice> device, const AudioConfig& config)
+    {
+        if (s_Data) {
+            printf("Warning: AudioEngine already initialized\n");
+            return true;
+        }
+        if (!device) {
+            printf("Error: AudioEngine needs an output device\n");
+            return false;
+        }
+
+        AudioConfig settings = config;
+        settings.MaxVoices = std::min<uint32_t>(std::max<uint32_t>(settings.MaxVoices, 1), 0xFFFF);
+        s_Data = std::make_unique<AudioEngineData>(settings);
+        AudioEngineData& data = *s_Data;
+
+        data.Mixer = std::make_unique<AudioMixer>(settings.Format, settings.MaxVoices);
+        data.Slots.resize(settings.MaxVoices);
+        data.FreeSlots.reserve(settings.MaxVoices);
+        for (uint32_t slot = settings.MaxVoices; slot-- > 0;) {
+            data.FreeSlots.push_back(slot);
+        }
+        data.Streamer = std::thread(&AudioEngine::StreamThread);
+
+        data.Device = std::move(device);
+        if (!data.Device->Start(settings.Format, &AudioEngine::Render)) {
+            printf("Error: Failed to start audio device %s\n", data.Device->GetName());
+            data.Device.reset();
+            Shutdown();
+            return false;
+        }
+
+        printf("AudioEngine initialized (%s, %u Hz, %u-frame periods, %u voices)\n", data.Device->GetName(),
+               settings.Format.SampleRate, settings.Format.PeriodFrames, settings.MaxVoices);
+        return true;
+    }
+
+    void AudioEngine::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+        AudioEngineData& data = *s_Data;
+
+        // The device thread goes first; after that nothing reads the voices' sources
+        if (data.Device) {
+            data.Device->Stop();
+        }
+        {
+            std::lock_guard<std::mutex> lock(data.StreamMutex);
+            data.StreamerRunning = false;
+        }
+        data.StreamWake.notify_one();
+        if (data.Streamer.joinable()) {
+            data.Streamer.join();
+        }
+        s_Data.reset();
+        printf("AudioEngine shutdown\n");
+    }
+
+    bool AudioEngine::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    bool AudioEngine::Send(const AudioCommand& command)
+    {
+        if (!s_Data->Commands.Push(command)) {
+            s_Data->DroppedCommands++;
+            return false;
+        }
+        return true;
+    }
+
+    static AudioVoice AcquireVoice(std::vector<VoiceSlot>& slots, std::vector<uint32_t>& freeSlots)
+    {
+        uint32_t slot = freeSlots.back();
+        freeSlots.pop_back();
+        VoiceSlot& entry = slots[slot];
+        entry.Generation = entry.Generation == 0xFFFF ? 1 : entry.Generation + 1;
+        entry.InUse = true;
+        return ((AudioVoice)entry.Generation << 16) | slot;
+    }
+
+    AudioVoice AudioEngine::Play(const std::shared_ptr<AudioClip>& clip, const AudioPlayParams& params)
+    {
+        if (!s_Data || !clip) {
+            return InvalidVoice;
+        }
+        AudioEngineData& data = *s_Data;
+        if (data.FreeSlots.empty()) {
+            data.RejectedPlays++;
+            return InvalidVoice;
+        }
+
+        AudioVoice voice = AcquireVoice(data.Slots, data.FreeSlots);
+        AudioCommand command;
+        command.Type = AudioCommandType::Play;
+        command.Voice = voice;
+        command.Clip = clip.get();
+        command.Params = params;
+        command.IssuedNs = NowNs();
+        if (!Send(command)) {
+            data.Slots[AudioMixer::GetSlot(voice)].InUse = false;
+            data.FreeSlots.push_back(AudioMixer::GetSlot(voice));
+            return InvalidVoice;
+        }
+
+        data.Slots[AudioMixer::GetSlot(voice)].Clip = clip;
+        data.ActiveVoices++;
+        data.PeakVoices = std::max(data.PeakVoices, data.ActiveVoices);
+        return voice;
+    }
+
+    AudioVoice AudioEngine::PlayStream(const std::string& path, const AudioPlayParams& params)
+    {
+        if (!s_Data) {
+            return InvalidVoice;
+        }
+        AudioEngineData& data = *s_Data;
+        if (data.FreeSlots.empty()) {
+            data.RejectedPlays++;
+            return InvalidVoice;
+        }
+
+        // Only the header is read here; decoding happens on the streaming thread
+        auto stream = std::make_unique<AudioStream>();
+        if (!stream->Open(path, params.Loop)) {
+            return InvalidVoice;
+        }
+
+        AudioVoice voice = AcquireVoice(data.Slots, data.FreeSlots);
+        AudioCommand command;
+        command.Type = AudioCommandType::Play;
+        command.Voice = voice;
+        command.Stream = stream.get();
+        command.Params = params;
+        command.IssuedNs = NowNs();
+
+        {
+            std::lock_guard<std::mutex> lock(data.StreamMutex);
+            data.Streams.push_back(stream.get());
+        }
+        data.StreamWake.notify_one();
+
+        VoiceSlot& slot = data.Slots[AudioMixer::GetSlot(voice)];
+        slot.Stream = std::move(stream);
+        if (!Send(command)) {
+            std::lock_guard<std::mutex> lock(data.StreamMutex);
+            data.RetiredStreams.push_back(std::move(slot.Stream));
+            slot.InUse = false;
+            data.FreeSlots.push_back(AudioMixer::GetSlot(voice));
+            return InvalidVoice;
+        }
+
+        data.ActiveVoices++;
+        data.PeakVoices = std::max(data.PeakVoices, data.ActiveVoices);
+        return voice;
+    }
+
+    bool AudioEngine::IsPlaying(AudioVoice voice)
+    {
+        if (!s_Data || voice == InvalidVoice) {
+            return false;
+        }
+        uint32_t slot = AudioMixer::GetSlot(voice);
+        if (slot >= s_Data->Slots.size()) {
+            return false;
+        }
+        const VoiceSlot& entry = s_Data->Slots[slot];
+        return entry.InUse && entry.Generation == (voice >> 16);
+    }
+
+    void AudioEngine::Stop(AudioVoice voice, float fadeOut)
+    {
+        if (!IsPlaying(voice)) {
+            return;
+        }
+        AudioCommand command;
+        command.Type = AudioCommandType::Stop;
+        command.Voice = voice;
+        command.Ramp = fadeOut;
+        Send(command);
+    }
+
+    void AudioEngine::SetVolume(AudioVoice voice, float volume, float rampSeconds)
+    {
+        if (!IsPlaying(voice)) {
+            return;
+        }
+        AudioCommand command;
+        command.Type = AudioCommandType::SetVolume;
+        command.Voice = voice;
+        command.Value = volume;
+        command.Ramp = rampSeconds;
+        Send(command);
+    }
+
+    void AudioEngine::SetPan(AudioVoice voice, float pan, float rampSeconds)
+    {
+        if (!IsPlaying(voice)) {
+            return;
+        }
+        AudioCommand command;
+        command.Type = AudioCommandType::SetPan;
+        command.Voice = voice;
+        command.Value = pan;
+        command.Ramp = rampSeconds;
+        Send(command);
+    }
+
+    void AudioEngine::SetPitch(AudioVoice voice, float pitch)
+    {
+        if (!IsPlaying(voice)) {
+            return;
+        }
+        AudioCommand command;
+        command.Type = AudioCommandType::SetPitch;
+        command.Voice = voice;
+        command.Value = pitch;
+        Send(command);
+    }
+
+    void AudioEngine::SetMasterVolume(float volume, float rampSeconds)
+    {
+        if (!s_Data) {
+            return;
+        }
+        AudioCommand command;
+        command.Type = AudioCommandType::SetMasterVolume;
+        command.Value = volume;
+        command.Ramp = rampSeconds;
+        Send(command);
+    }
+
+    void AudioEngine::Update()
+    {
+        if (!s_Data) {
+            return;
+        }
+        AudioEngineData& data = *s_Data;
+
+        uint32_t voice = 0;
+        bool retired = false;
+        while (data.Finished.Pop(voice)) {
+            uint32_t slot = AudioMixer::GetSlot(voice);
+            VoiceSlot& entry = data.Slots[slot];
+            if (!entry.InUse || entry.Generation != (voice >> 16)) {
+                continue;
+            }
+            entry.InUse = false;
+            entry.Clip.reset();
+            if (entry.Stream) {
+                std::lock_guard<std::mutex> lock(data.StreamMutex);
+                data.RetiredStreams.push_back(std::move(entry.Stream));
+                retired = true;
+            }
+            data.FreeSlots.push_back(slot);
+            data.ActiveVoices--;
+        }
+        if (retired) {
+            data.StreamWake.notify_one();
+        }
+    }
+
+    void AudioEngine::Render(float* output, uint32_t frames)
+    {
+        AudioEngineData& data = *s_Data;
+        uint64_t start = NowNs();
+
+        AudioCommand command;
+        while (data.Commands.Pop(command)) {
+            if (command.Type == AudioCommandType::Play) {
+                data.WindowLatencyNs += start > command.IssuedNs ? start - command.IssuedNs : 0;
+                data.WindowCommands++;
+                data.VoicesStarted.fetch_add(1, std::memory_order_relaxed);
+            }
+            data.Mixer->Execute(command);
+        }
+
+        data.Mixer->Mix(output, frames);
+        for (uint32_t voice : data.Mixer->GetFinishedVoices()) {
+            data.Finished.Push(voice);
+        }
+        data.StreamUnderruns.store(data.Mixer->GetStreamUnderruns(), std::memory_order_relaxed);
+
+        uint64_t elapsed = NowNs() - start;
+        data.WindowMixNs += elapsed;
+        data.WindowMixMaxNs = std::max(data.WindowMixMaxNs, elapsed);
+        data.WindowPeriods++;
+        data.WindowFrames += frames;
+        if (data.WindowFrames * 4 >= data.Config.Format.SampleRate) {
+            data.MixAverageNs.store(data.WindowMixNs / data.WindowPeriods, std::memory_order_relaxed);
+            data.MixMaxNs.store(data.WindowMixMaxNs, std::memory_order_relaxed);
+            if (data.WindowCommands > 0) {
+                data.CommandLatencyNs.store(data.WindowLatencyNs / data.WindowCommands, std::memory_order_relaxed);
+            }
+            data.WindowFrames = data.WindowMixNs = data.WindowMixMaxNs = data.WindowLatencyNs = 0;
+            data.WindowPeriods = data.WindowCommands = 0;
+        }
+    }
+
+    void AudioEngine::StreamThread()
+    {
+        AudioEngineData& data = *s_Data;
+        std::vector<AudioStream*> streams;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(data.StreamMutex);
+                data.StreamWake.wait_for(lock, std::chrono::milliseconds(5));
+                if (!data.StreamerRunning) {
+                    break;
+                }
+                for (const std::unique_ptr<AudioStream>& stream : data.RetiredStreams) {
+                    data.Streams.erase(std::remove(data.Streams.begin(), data.Streams.end(), stream.get()), data.Streams.end());
+                }
+                data.RetiredStreams.clear();
+                streams = data.Streams;
+            }
+
+            for (AudioStream* stream : streams) {
+                stream->Fill();
+            }
+        }
+    }
+
+    AudioEngine::Stats AudioEngine::GetStats()
+    {
+        Stats stats;
+        if (!s_Data) {
+            return stats;
+        }
+        const AudioEngineData& data = *s_Data;
+        const double rate = (double)data.Config.Format.SampleRate;
+
+        stats.ActiveVoices = data.ActiveVoices;
+        stats.PeakVoices = data.PeakVoices;
+        stats.VoicesStarted = data.VoicesStarted.load(std::memory_order_relaxed);
+        stats.DroppedCommands = data.DroppedCommands;
+        stats.RejectedPlays = data.RejectedPlays;
+        stats.StreamUnderruns = data.StreamUnderruns.load(std::memory_order_relaxed);
+        stats.DeviceUnderruns = data.Device ? data.Device->GetUnderruns() : 0;
+        stats.MixMsAverage = data.MixAverageNs.load(std::memory_order_relaxed) / 1e6;
+        stats.MixMsMax = data.MixMaxNs.load(std::memory_order_relaxed) / 1e6;
+        stats.PeriodMs = data.Config.Format.PeriodFrames * 1000.0 / rate;
+        stats.CommandLatencyMs = data.CommandLatencyNs.load(std::memory_order_relaxed) / 1e6;
+        stats.OutputLatencyMs = data.Device ? data.Device->GetLatencyFrames() * 1000.0 / rate : 0.0;
+        return stats;
+    }
+
+}
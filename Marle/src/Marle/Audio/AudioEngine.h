@@ -0,0 +1,78 @@
+#pragma once
+
+#include "../Core.h"
+#include "AudioDevice.h"
+#include "AudioMixer.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Marle {
+
+    class AudioClip;
+
+    typedef uint32_t AudioVoice;
+
+    struct AudioConfig {
+        AudioFormat Format;
+        uint32_t MaxVoices = 512;
+        uint32_t CommandQueueSize = 4096;
+    };
+
+    // Audio front end. The device's thread runs the AudioMixer: each period it drains a
+    // lock-free command queue fed by the game thread, mixes and reports finished voices back
+    // through a second queue, so neither side ever waits on the other. A streaming thread keeps
+    // the ring buffers of PlayStream voices topped up from disk.
+    //
+    // Play returns a handle straight away; it stays valid (IsPlaying) until the mixer reports the
+    // voice finished and Update() recycles it, after which commands for it are ignored. Clips are
+    // kept alive by the engine while they play. Everything except GetStats is game thread only.
+    class AudioEngine {
+    public:
+        static constexpr AudioVoice InvalidVoice = 0;
+
+        // Takes the device (NullAudioDevice, WavFileAudioDevice, or a platform device)
+        static bool Init(std::unique_ptr<AudioDevice> device, const AudioConfig& config = AudioConfig());
+        static void Shutdown();
+        static bool IsInitialized();
+
+        static AudioVoice Play(const std::shared_ptr<AudioClip>& clip, const AudioPlayParams& params = AudioPlayParams());
+        // Decodes the WAV file progressively on the streaming thread; for music and ambience
+        static AudioVoice PlayStream(const std::string& path, const AudioPlayParams& params = AudioPlayParams());
+
+        static void Stop(AudioVoice voice, float fadeOut = 0.0f);
+        static void SetVolume(AudioVoice voice, float volume, float rampSeconds = 0.02f);
+        static void SetPan(AudioVoice voice, float pan, float rampSeconds = 0.02f);
+        static void SetPitch(AudioVoice voice, float pitch);
+        static void SetMasterVolume(float volume, float rampSeconds = 0.05f);
+        static bool IsPlaying(AudioVoice voice);
+
+        // Called once per frame by Application::Run: recycles finished voices and their sources
+        static void Update();
+
+        struct Stats {
+            uint32_t ActiveVoices = 0;          // As seen by the game thread
+            uint32_t PeakVoices = 0;
+            uint64_t VoicesStarted = 0;         // Play commands the mixer has executed
+            uint64_t DroppedCommands = 0;       // Queue full; raise CommandQueueSize
+            uint64_t RejectedPlays = 0;         // Every voice slot in use
+            uint64_t StreamUnderruns = 0;       // Mix blocks a stream could not fill
+            uint64_t DeviceUnderruns = 0;       // Periods the device had to skip
+            double MixMsAverage = 0.0;          // Per period, over the last quarter second
+            double MixMsMax = 0.0;
+            double PeriodMs = 0.0;              // Time budget of one period
+            double CommandLatencyMs = 0.0;      // Average queue-to-mix delay of recent Play commands
+            double OutputLatencyMs = 0.0;       // Device buffering after the mix
+        };
+        static Stats GetStats();
+
+    private:
+        static bool Send(const AudioCommand& command);
+        static void Render(float* output, uint32_t frames);
+        static void StreamThread();
+
+        struct AudioEngineData;
+        static std::unique_ptr<AudioEngineData> s_Data;
+    };
+
+}
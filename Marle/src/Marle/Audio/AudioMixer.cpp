@@ -0,0 +1,335 @@
+#include "mrlpch.h"
+#include "AudioMixer.h"
+#include "AudioClip.h"
+#include "AudioStream.h"
+#include "../Core/SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Marle {
+
+    static const uint64_t s_One = 1ull << 32;
+    static const float s_FracScale = 1.0f / 4294967296.0f;
+    // Shortest gain ramp; even an immediate stop fades over ~1.3 ms at 48 kHz instead of clicking
+    static const uint32_t s_MinRampFrames = 64;
+    static const uint32_t s_ScratchFrames = (uint32_t)(AudioMixer::BlockFrames * AudioMixer::MaxStep) + 2;
+
+    // Adds `count` resampled frames, four at a time. Gains start at gainL/gainR and move by
+    // stepL/stepR per frame. Every source read (index and index + 1) must be in range.
+    static void MixResampled(const float* const* source, uint32_t channels, uint64_t position, uint64_t step,
+                             float* outL, float* outR, uint32_t count, float gainL, float gainR, float stepL, float stepR)
+    {
+        const float* left = source[0];
+        const float* right = channels > 1 ? source[1] : source[0];
+        const SIMD::Float4 lanes = SIMD::Set(0.0f, 1.0f, 2.0f, 3.0f);
+        SIMD::Float4 gL = SIMD::MulAdd(lanes, SIMD::Set1(stepL), SIMD::Set1(gainL));
+        SIMD::Float4 gR = SIMD::MulAdd(lanes, SIMD::Set1(stepR), SIMD::Set1(gainR));
+        const SIMD::Float4 gStepL = SIMD::Set1(stepL * 4.0f);
+        const SIMD::Float4 gStepR = SIMD::Set1(stepR * 4.0f);
+
+        uint32_t i = 0;
+        if (step == s_One && (uint32_t)position == 0) {
+            // Native rate on a whole frame: straight loads, no interpolation
+            const float* l = left + (position >> 32);
+            const float* r = right + (position >> 32);
+            for (; i + 4 <= count; i += 4) {
+                SIMD::Float4 sl = SIMD::Load(l + i);
+                SIMD::Float4 sr = channels > 1 ? SIMD::Load(r + i) : sl;
+                SIMD::Store(outL + i, SIMD::MulAdd(sl, gL, SIMD::Load(outL + i)));
+                SIMD::Store(outR + i, SIMD::MulAdd(sr, gR, SIMD::Load(outR + i)));
+                gL = SIMD::Add(gL, gStepL);
+                gR = SIMD::Add(gR, gStepR);
+            }
+        } else {
+            for (; i + 4 <= count; i += 4) {
+                uint64_t p0 = position + (uint64_t)i * step;
+                uint64_t p1 = p0 + step, p2 = p1 + step, p3 = p2 + step;
+                uint32_t i0 = (uint32_t)(p0 >> 32), i1 = (uint32_t)(p1 >> 32), i2 = (uint32_t)(p2 >> 32), i3 = (uint32_t)(p3 >> 32);
+                SIMD::Float4 frac = SIMD::Set((uint32_t)p0 * s_FracScale, (uint32_t)p1 * s_FracScale,
+                                              (uint32_t)p2 * s_FracScale, (uint32_t)p3 * s_FracScale);
+
+                SIMD::Float4 a = SIMD::Set(left[i0], left[i1], left[i2], left[i3]);
+                SIMD::Float4 b = SIMD::Set(left[i0 + 1], left[i1 + 1], left[i2 + 1], left[i3 + 1]);
+                SIMD::Float4 sl = SIMD::MulAdd(SIMD::Sub(b, a), frac, a);
+                SIMD::Float4 sr = sl;
+                if (channels > 1) {
+                    a = SIMD::Set(right[i0], right[i1], right[i2], right[i3]);
+                    b = SIMD::Set(right[i0 + 1], right[i1 + 1], right[i2 + 1], right[i3 + 1]);
+                    sr = SIMD::MulAdd(SIMD::Sub(b, a), frac, a);
+                }
+                SIMD::Store(outL + i, SIMD::MulAdd(sl, gL, SIMD::Load(outL + i)));
+                SIMD::Store(outR + i, SIMD::MulAdd(sr, gR, SIMD::Load(outR + i)));
+                gL = SIMD::Add(gL, gStepL);
+                gR = SIMD::Add(gR, gStepR);
+            }
+        }
+
+        for (; i < count; i++) {
+            uint64_t p = position + (uint64_t)i * step;
+            uint32_t index = (uint32_t)(p >> 32);
+            float frac = (uint32_t)p * s_FracScale;
+            float sl = left[index] + (left[index + 1] - left[index]) * frac;
+            float sr = channels > 1 ? right[index] + (right[index + 1] - right[index]) * frac : sl;
+            outL[i] += sl * (gainL + stepL * (float)i);
+            outR[i] += sr * (gainR + stepR * (float)i);
+        }
+    }
+
+    AudioMixer::AudioMixer(const AudioFormat& format, uint32_t maxVoices)
+        : m_Format(format)
+    {
+        maxVoices = std::min<uint32_t>(std::max<uint32_t>(maxVoices, 1), 0xFFFF);
+        m_Voices.resize(maxVoices);
+        m_Active.reserve(maxVoices);
+        m_Finished.reserve(maxVoices);
+        m_MixL.resize(BlockFrames);
+        m_MixR.resize(BlockFrames);
+        m_StreamScratch.resize((size_t)s_ScratchFrames * 2);
+    }
+
+    void AudioMixer::UpdateStep(Voice& voice)
+    {
+        double ratio = (double)voice.SourceRate / (double)m_Format.SampleRate * voice.Pitch;
+        ratio = std::min(std::max(ratio, 1.0 / 1024.0), (double)MaxStep);
+        voice.Step = (uint64_t)(ratio * (double)s_One);
+    }
+
+    void AudioMixer::SetGainTargets(Voice& voice, float seconds)
+    {
+        if (voice.Stopping) {
+            voice.TargetL = voice.TargetR = 0.0f;
+        } else {
+            // Balance: the far side fades out as the sound moves across, the centre is unity
+            float pan = std::min(std::max(voice.Pan, -1.0f), 1.0f);
+            voice.TargetL = voice.Volume * std::min(1.0f, 1.0f - pan);
+            voice.TargetR = voice.Volume * std::min(1.0f, 1.0f + pan);
+        }
+
+        uint32_t frames = (uint32_t)(std::max(seconds, 0.0f) * (float)m_Format.SampleRate);
+        if (frames == 0 && !voice.Stopping) {
+            voice.GainL = voice.TargetL;
+            voice.GainR = voice.TargetR;
+            voice.RampFrames = 0;
+            return;
+        }
+        frames = std::max(frames, s_MinRampFrames);
+        voice.RampFrames = frames;
+        voice.GainStepL = (voice.TargetL - voice.GainL) / (float)frames;
+        voice.GainStepR = (voice.TargetR - voice.GainR) / (float)frames;
+    }
+
+    void AudioMixer::Execute(const AudioCommand& command)
+    {
+        uint32_t slot = GetSlot(command.Voice);
+        if (command.Type == AudioCommandType::SetMasterVolume) {
+            m_MasterTarget = std::max(command.Value, 0.0f);
+            m_MasterRampFrames = std::max((uint32_t)(command.Ramp * (float)m_Format.SampleRate), s_MinRampFrames);
+            m_MasterStep = (m_MasterTarget - m_MasterGain) / (float)m_MasterRampFrames;
+            return;
+        }
+        if (slot >= m_Voices.size()) {
+            return;
+        }
+        Voice& voice = m_Voices[slot];
+
+        if (command.Type == AudioCommandType::Play) {
+            if (voice.Active) {
+                m_Active.erase(std::find(m_Active.begin(), m_Active.end(), slot));
+            }
+            voice = Voice();
+            voice.Handle = command.Voice;
+            if (command.Clip) {
+                voice.SourceChannels = command.Clip->GetChannels();
+                voice.SourceFrames = command.Clip->GetFrameCount();
+                voice.SourceRate = command.Clip->GetSampleRate();
+                for (uint32_t c = 0; c < voice.SourceChannels; c++) {
+                    voice.Source[c] = command.Clip->GetChannel(c);
+                }
+            } else if (command.Stream) {
+                voice.Stream = command.Stream;
+                voice.SourceChannels = command.Stream->GetChannels();
+                voice.SourceRate = command.Stream->GetSampleRate();
+            } else {
+                return;
+            }
+            voice.Active = true;
+            voice.Loop = command.Params.Loop;
+            voice.Volume = command.Params.Volume;
+            voice.Pan = command.Params.Pan;
+            voice.Pitch = command.Params.Pitch;
+            UpdateStep(voice);
+            SetGainTargets(voice, command.Params.FadeIn);
+            m_Active.push_back(slot);
+            return;
+        }
+
+        if (!voice.Active || voice.Handle != command.Voice || voice.Stopping) {
+            return; // Already finished (or the slot has been reused)
+        }
+        switch (command.Type) {
+            case AudioCommandType::Stop:
+                voice.Stopping = true;
+                SetGainTargets(voice, command.Ramp);
+                break;
+            case AudioCommandType::SetVolume:
+                voice.Volume = command.Value;
+                SetGainTargets(voice, command.Ramp);
+                break;
+            case AudioCommandType::SetPan:
+                voice.Pan = command.Value;
+                SetGainTargets(voice, command.Ramp);
+                break;
+            case AudioCommandType::SetPitch:
+                voice.Pitch = command.Value;
+                UpdateStep(voice);
+                break;
+            default:
+                break;
+        }
+    }
+
+    uint32_t AudioMixer::RenderSource(Voice& voice, const float* const* source, uint32_t sourceFrames, bool loop,
+                                      uint32_t offset, uint32_t frames)
+    {
+        const uint64_t last = sourceFrames > 0 ? (uint64_t)(sourceFrames - 1) << 32 : 0;
+        float* outL = m_MixL.data() + offset;
+        float* outR = m_MixR.data() + offset;
+        uint32_t done = 0;
+
+        while (done < frames) {
+            if (voice.Stopping && voice.RampFrames == 0) {
+                break;
+            }
+            uint64_t index = voice.Position >> 32;
+            if (index >= sourceFrames) {
+                if (loop && sourceFrames > 0) {
+                    voice.Position -= (uint64_t)sourceFrames << 32;
+                    continue;
+                }
+                break;
+            }
+
+            bool ramping = voice.RampFrames > 0;
+            uint32_t count = frames - done;
+            if (ramping) {
+                count = std::min(count, voice.RampFrames);
+            }
+
+            uint64_t safe = voice.Position < last ? (last - voice.Position + voice.Step - 1) / voice.Step : 0;
+            if (safe == 0) {
+                // Last source frame: interpolate towards the loop start, or hold it
+                float frac = (uint32_t)voice.Position * s_FracScale;
+                float s[2];
+                for (uint32_t c = 0; c < voice.SourceChannels; c++) {
+                    float a = source[c][index];
+                    float b = loop ? source[c][0] : a;
+                    s[c] = a + (b - a) * frac;
+                }
+                outL[done] += s[0] * voice.GainL;
+                outR[done] += s[voice.SourceChannels > 1 ? 1 : 0] * voice.GainR;
+                count = 1;
+            } else {
+                count = (uint32_t)std::min<uint64_t>(count, safe);
+                MixResampled(source, voice.SourceChannels, voice.Position, voice.Step, outL + done, outR + done, count,
+                             voice.GainL, voice.GainR, ramping ? voice.GainStepL : 0.0f, ramping ? voice.GainStepR : 0.0f);
+            }
+
+            voice.Position += voice.Step * count;
+            if (ramping) {
+                voice.RampFrames -= count;
+                if (voice.RampFrames == 0) {
+                    voice.GainL = voice.TargetL;
+                    voice.GainR = voice.TargetR;
+                } else {
+                    voice.GainL += voice.GainStepL * (float)count;
+                    voice.GainR += voice.GainStepR * (float)count;
+                }
+            }
+            done += count;
+        }
+        return done;
+    }
+
+    bool AudioMixer::MixVoice(Voice& voice, uint32_t frames)
+    {
+        if (!voice.Stream) {
+            uint32_t produced = RenderSource(voice, voice.Source, voice.SourceFrames, voice.Loop, 0, frames);
+            return produced == frames && !(voice.Stopping && voice.RampFrames == 0);
+        }
+
+        AudioStream& stream = *voice.Stream;
+        if (!stream.IsPrimed()) {
+            return !voice.Stopping; // Silent until the first chunk is decoded
+        }
+
+        // Window of source frames this block reads, copied out of the ring
+        uint64_t frac = voice.Position & 0xFFFFFFFFull;
+        uint32_t need = (uint32_t)std::min<uint64_t>(((frac + (uint64_t)(frames - 1) * voice.Step) >> 32) + 2, s_ScratchFrames);
+        float* window[2] = { m_StreamScratch.data(), m_StreamScratch.data() + s_ScratchFrames };
+        uint32_t available = stream.Peek(window, need);
+
+        voice.Position = frac;
+        uint32_t produced = RenderSource(voice, window, available, false, 0, frames);
+        stream.Consume((uint32_t)(voice.Position >> 32));
+        voice.Position &= 0xFFFFFFFFull;
+
+        if (voice.Stopping && voice.RampFrames == 0) {
+            return false;
+        }
+        if (produced < frames) {
+            if (stream.IsEndOfFile() && stream.GetAvailableFrames() <= 1) {
+                return false;
+            }
+            m_StreamUnderruns++;
+        }
+        return true;
+    }
+
+    void AudioMixer::EndVoice(uint32_t activeIndex)
+    {
+        Voice& voice = m_Voices[m_Active[activeIndex]];
+        voice.Active = false;
+        m_Finished.push_back(voice.Handle);
+        m_Active[activeIndex] = m_Active.back();
+        m_Active.pop_back();
+    }
+
+    void AudioMixer::Mix(float* output, uint32_t frames)
+    {
+        m_Finished.clear();
+        const uint32_t channels = m_Format.Channels;
+
+        for (uint32_t done = 0; done < frames;) {
+            uint32_t count = std::min(BlockFrames, frames - done);
+            std::fill(m_MixL.begin(), m_MixL.begin() + count, 0.0f);
+            std::fill(m_MixR.begin(), m_MixR.begin() + count, 0.0f);
+
+            for (size_t a = m_Active.size(); a-- > 0;) {
+                if (!MixVoice(m_Voices[m_Active[a]], count)) {
+                    EndVoice((uint32_t)a);
+                }
+            }
+
+            // Master gain, clamp and interleave
+            float* out = output + (size_t)done * channels;
+            for (uint32_t i = 0; i < count; i++) {
+                if (m_MasterRampFrames > 0) {
+                    m_MasterGain = --m_MasterRampFrames == 0 ? m_MasterTarget : m_MasterGain + m_MasterStep;
+                }
+                float l = std::min(std::max(m_MixL[i] * m_MasterGain, -1.0f), 1.0f);
+                float r = std::min(std::max(m_MixR[i] * m_MasterGain, -1.0f), 1.0f);
+                if (channels == 2) {
+                    out[i * 2] = l;
+                    out[i * 2 + 1] = r;
+                } else {
+                    for (uint32_t c = 0; c < channels; c++) {
+                        out[(size_t)i * channels + c] = c == 0 ? (channels == 1 ? (l + r) * 0.5f : l) : (c == 1 ? r : 0.0f);
+                    }
+                }
+            }
+            done += count;
+        }
+    }
+
+}
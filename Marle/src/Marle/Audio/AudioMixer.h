@@ -0,0 +1,114 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "AudioDevice.h"
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    class AudioClip;
+    class AudioStream;
+
+    struct AudioPlayParams {
+        float Volume = 1.0f;
+        float Pan = 0.0f;       // -1 left .. 1 right
+        float Pitch = 1.0f;     // Playback rate; 2 = an octave up
+        bool Loop = false;
+        float FadeIn = 0.0f;    // Seconds
+    };
+
+    enum class AudioCommandType : uint8_t {
+        Play = 0,
+        Stop,
+        SetVolume,
+        SetPan,
+        SetPitch,
+        SetMasterVolume
+    };
+
+    struct AudioCommand {
+        AudioCommandType Type = AudioCommandType::Play;
+        uint32_t Voice = 0;
+        float Value = 0.0f;
+        float Ramp = 0.0f;                  // Seconds over which a gain change is applied
+        const AudioClip* Clip = nullptr;
+        AudioStream* Stream = nullptr;
+        AudioPlayParams Params;
+        uint64_t IssuedNs = 0;              // Steady clock when queued, for latency statistics
+    };
+
+    // The mixer proper: owns every voice and renders them into the device buffer. Not thread
+    // safe by design; AudioEngine feeds it commands and calls Mix from the audio thread, and
+    // benchmarks drive it directly. Mix never allocates or locks.
+    //
+    // Voices are resampled with linear interpolation from a 32.32 fixed-point position, and all
+    // gain changes (volume, pan, fades, stops) ramp per sample so they never click. Sources are
+    // planar, and the inner loops work on four output frames at a time.
+    class AudioMixer {
+    public:
+        static constexpr uint32_t BlockFrames = 256;    // Mix is processed in blocks of this size
+        static constexpr float MaxStep = 16.0f;     // Source rate / device rate * pitch
+
+        AudioMixer(const AudioFormat& format, uint32_t maxVoices);
+
+        void Execute(const AudioCommand& command);
+        // Adds every voice into `frames` interleaved output frames (which it overwrites)
+        void Mix(float* output, uint32_t frames);
+
+        // Handles of voices that ended during the last Mix
+        const std::vector<uint32_t>& GetFinishedVoices() const { return m_Finished; }
+        uint32_t GetActiveVoices() const { return (uint32_t)m_Active.size(); }
+        uint32_t GetMaxVoices() const { return (uint32_t)m_Voices.size(); }
+        uint64_t GetStreamUnderruns() const { return m_StreamUnderruns; }
+
+        static uint32_t GetSlot(uint32_t voice) { return voice & 0xFFFF; }
+
+    private:
+        struct Voice {
+            uint32_t Handle = 0;
+            bool Active = false;
+            const float* Source[2] = { nullptr, nullptr };
+            uint32_t SourceChannels = 0;
+            uint32_t SourceFrames = 0;
+            uint32_t SourceRate = 0;
+            AudioStream* Stream = nullptr;
+            bool Loop = false;
+            uint64_t Position = 0;          // 32.32 fixed-point source frame
+            uint64_t Step = 0;
+            float Volume = 1.0f;
+            float Pan = 0.0f;
+            float Pitch = 1.0f;
+            float GainL = 0.0f, GainR = 0.0f;
+            float GainStepL = 0.0f, GainStepR = 0.0f;
+            uint32_t RampFrames = 0;        // Frames until the gains reach their targets
+            float TargetL = 0.0f, TargetR = 0.0f;
+            bool Stopping = false;          // Ends when the current ramp does
+        };
+
+        // False once the voice has ended
+        bool MixVoice(Voice& voice, uint32_t frames);
+        // Renders from a planar source until `frames` are done or the source runs out; returns
+        // the frames produced
+        uint32_t RenderSource(Voice& voice, const float* const* source, uint32_t sourceFrames, bool loop,
+                              uint32_t offset, uint32_t frames);
+        void SetGainTargets(Voice& voice, float seconds);
+        void UpdateStep(Voice& voice);
+        void EndVoice(uint32_t activeIndex);
+
+        AudioFormat m_Format;
+        std::vector<Voice> m_Voices;        // Indexed by slot
+        std::vector<uint32_t> m_Active;     // Slots of playing voices
+        std::vector<uint32_t> m_Finished;
+        TaggedVector<float, MemoryTag::Audio> m_MixL;
+        TaggedVector<float, MemoryTag::Audio> m_MixR;
+        TaggedVector<float, MemoryTag::Audio> m_StreamScratch; // Planar window peeked from a stream
+        float m_MasterGain = 1.0f;
+        float m_MasterTarget = 1.0f;
+        float m_MasterStep = 0.0f;
+        uint32_t m_MasterRampFrames = 0;
+        uint64_t m_StreamUnderruns = 0;
+    };
+
+}
@@ -0,0 +1,114 @@
+#include "mrlpch.h"
+#include "AudioStream.h"
+
+#include <algorithm>
+
+namespace Marle {
+
+    AudioStream::~AudioStream()
+    {
+        if (m_File) {
+            fclose(m_File);
+        }
+    }
+
+    bool AudioStream::Open(const std::string& path, bool loop)
+    {
+        m_File = fopen(path.c_str(), "rb");
+        if (!m_File) {
+            printf("Error: Could not open audio stream %s\n", path.c_str());
+            return false;
+        }
+        if (!ReadWavHeader(m_File, m_Info) || m_Info.FrameCount == 0) {
+            printf("Error: Failed to stream %s\n", path.c_str());
+            fclose(m_File);
+            m_File = nullptr;
+            return false;
+        }
+
+        m_Loop = loop;
+        m_FramesLeft = m_Info.FrameCount;
+        m_Raw.resize((size_t)ChunkFrames * m_Info.GetFrameSize());
+        m_Decoded.resize((size_t)ChunkFrames * m_Info.Channels);
+        m_Ring.resize((size_t)RingFrames * m_Info.Channels);
+        return true;
+    }
+
+    bool AudioStream::NeedsFill() const
+    {
+        if (!m_File || m_EndOfFile.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        uint64_t used = m_WritePosition.load(std::memory_order_relaxed) - m_ReadPosition.load(std::memory_order_acquire);
+        return RingFrames - used >= ChunkFrames;
+    }
+
+    void AudioStream::Fill()
+    {
+        const uint32_t channels = m_Info.Channels;
+        while (NeedsFill()) {
+            uint32_t frames = (uint32_t)std::min<uint64_t>(ChunkFrames, m_FramesLeft);
+            size_t read = fread(m_Raw.data(), m_Info.GetFrameSize(), frames, m_File);
+            if (read < frames) {
+                // Truncated file: play what there is
+                m_FramesLeft = read;
+                frames = (uint32_t)read;
+            }
+            if (frames == 0) {
+                m_EndOfFile.store(true, std::memory_order_release);
+                break;
+            }
+            ConvertWavSamples(m_Raw.data(), m_Info, m_Decoded.data(), (size_t)frames * channels);
+
+            uint64_t write = m_WritePosition.load(std::memory_order_relaxed);
+            uint32_t start = (uint32_t)(write % RingFrames);
+            uint32_t first = std::min(frames, RingFrames - start);
+            std::copy(m_Decoded.begin(), m_Decoded.begin() + (size_t)first * channels, m_Ring.begin() + (size_t)start * channels);
+            std::copy(m_Decoded.begin() + (size_t)first * channels, m_Decoded.begin() + (size_t)frames * channels, m_Ring.begin());
+            m_WritePosition.store(write + frames, std::memory_order_release);
+
+            m_FramesLeft -= frames;
+            if (m_FramesLeft == 0) {
+                if (m_Loop && m_Info.FrameCount > 0) {
+                    fseek(m_File, (long)m_Info.DataOffset, SEEK_SET);
+                    m_FramesLeft = m_Info.FrameCount;
+                } else {
+                    m_EndOfFile.store(true, std::memory_order_release);
+                }
+            }
+        }
+        m_Primed.store(true, std::memory_order_release);
+    }
+
+    uint32_t AudioStream::GetAvailableFrames() const
+    {
+        return (uint32_t)(m_WritePosition.load(std::memory_order_acquire) - m_ReadPosition.load(std::memory_order_relaxed));
+    }
+
+    uint32_t AudioStream::Peek(float* const* channels, uint32_t frames) const
+    {
+        frames = std::min(frames, GetAvailableFrames());
+        const uint32_t count = m_Info.Channels;
+        uint32_t index = (uint32_t)(m_ReadPosition.load(std::memory_order_relaxed) % RingFrames);
+        const float* ring = m_Ring.data();
+        for (uint32_t i = 0; i < frames; i++) {
+            for (uint32_t c = 0; c < count; c++) {
+                channels[c][i] = ring[(size_t)index * count + c];
+            }
+            index = index + 1 == RingFrames ? 0 : index + 1;
+        }
+        return frames;
+    }
+
+    void AudioStream::Consume(uint32_t frames)
+    {
+        frames = std::min(frames, GetAvailableFrames());
+        m_ReadPosition.store(m_ReadPosition.load(std::memory_order_relaxed) + frames, std::memory_order_release);
+    }
+
+    bool AudioStream::IsFinished() const
+    {
+        return m_EndOfFile.load(std::memory_order_acquire) && GetAvailableFrames() == 0;
+    }
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "WavFile.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // A long sound decoded from disk a chunk at a time into a ring buffer. The streaming thread
+    // fills it (Fill) and the mixer drains it (Peek/Consume); the two sides only share the
+    // atomic read and write positions, so the mixer never blocks on file I/O.
+    class AudioStream {
+    public:
+        static constexpr uint32_t RingFrames = 32768;  // ~0.7 s at 48 kHz
+        static constexpr uint32_t ChunkFrames = 4096;  // Decoded per read
+
+        AudioStream() = default;
+        ~AudioStream();
+
+        AudioStream(const AudioStream&) = delete;
+        AudioStream& operator=(const AudioStream&) = delete;
+
+        bool Open(const std::string& path, bool loop);
+
+        uint32_t GetChannels() const { return m_Info.Channels; }
+        uint32_t GetSampleRate() const { return m_Info.SampleRate; }
+        size_t GetMemorySize() const { return m_Ring.size() * sizeof(float) + m_Raw.size(); }
+
+        // Streaming thread: decodes until the ring is full or the file has ended
+        void Fill();
+        bool NeedsFill() const;
+
+        // Mixer thread. Peek copies up to `frames` frames without consuming them, deinterleaved
+        // into one array per channel, and returns how many it copied.
+        uint32_t GetAvailableFrames() const;
+        uint32_t Peek(float* const* channels, uint32_t frames) const;
+        void Consume(uint32_t frames);
+        // False until the first chunk is in, so a new stream does not count as starved
+        bool IsPrimed() const { return m_Primed.load(std::memory_order_acquire); }
+        // Every frame of the file has been decoded (and queued in the ring)
+        bool IsEndOfFile() const { return m_EndOfFile.load(std::memory_order_acquire); }
+        // ... and played
+        bool IsFinished() const;
+
+    private:
+        FILE* m_File = nullptr;
+        WavInfo m_Info;
+        bool m_Loop = false;
+        uint64_t m_FramesLeft = 0;          // Still to decode before the end (or the loop point)
+        std::vector<uint8_t> m_Raw;
+        std::vector<float> m_Decoded;
+        TaggedVector<float, MemoryTag::Audio> m_Ring;   // Interleaved
+
+        std::atomic<uint64_t> m_WritePosition{ 0 };     // Frames ever written
+        std::atomic<uint64_t> m_ReadPosition{ 0 };      // Frames ever consumed
+        std::atomic<bool> m_EndOfFile{ false };
+        std::atomic<bool> m_Primed{ false };
+    };
+
+}
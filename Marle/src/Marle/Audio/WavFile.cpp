@@ -0,0 +1,155 @@
+#include "mrlpch.h"
+#include "WavFile.h"
+
+#include <cstring>
+
+namespace Marle {
+
+    static const uint16_t WAVE_FORMAT_PCM = 1;
+    static const uint16_t WAVE_FORMAT_IEEE_FLOAT = 3;
+    static const uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+    static uint32_t ReadU32(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24); }
+    static uint16_t ReadU16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+
+    static void WriteU32(uint8_t* p, uint32_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); p[2] = (uint8_t)(v >> 16); p[3] = (uint8_t)(v >> 24); }
+    static void WriteU16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+
+    bool ReadWavHeader(FILE* file, WavInfo& info)
+    {
+        uint8_t riff[12];
+        if (fread(riff, 1, sizeof(riff), file) != sizeof(riff) || memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0) {
+            printf("Error: Not a RIFF/WAVE file\n");
+            return false;
+        }
+
+        bool haveFormat = false;
+        uint16_t formatTag = 0;
+        uint64_t offset = sizeof(riff);
+        for (;;) {
+            uint8_t chunk[8];
+            if (fread(chunk, 1, sizeof(chunk), file) != sizeof(chunk)) {
+                printf("Error: WAV file has no data chunk\n");
+                return false;
+            }
+            offset += sizeof(chunk);
+            uint32_t size = ReadU32(chunk + 4);
+
+            if (memcmp(chunk, "fmt ", 4) == 0) {
+                uint8_t format[40] = {};
+                size_t read = size < sizeof(format) ? size : sizeof(format);
+                if (size < 16 || fread(format, 1, read, file) != read) {
+                    printf("Error: Truncated WAV format chunk\n");
+                    return false;
+                }
+                formatTag = ReadU16(format);
+                info.Channels = ReadU16(format + 2);
+                info.SampleRate = ReadU32(format + 4);
+                info.BitsPerSample = ReadU16(format + 14);
+                if (formatTag == WAVE_FORMAT_EXTENSIBLE && size >= 26) {
+                    formatTag = ReadU16(format + 24); // First two bytes of the sub-format GUID
+                }
+                haveFormat = true;
+                size_t skip = size - read + (size & 1);
+                if (skip > 0) {
+                    fseek(file, (long)skip, SEEK_CUR);
+                }
+            } else if (memcmp(chunk, "data", 4) == 0) {
+                if (!haveFormat) {
+                    printf("Error: WAV data chunk before its format chunk\n");
+                    return false;
+                }
+                info.DataOffset = offset;
+                break;
+            } else {
+                fseek(file, (long)(size + (size & 1)), SEEK_CUR);
+            }
+            offset += size + (size & 1);
+        }
+
+        info.Float = formatTag == WAVE_FORMAT_IEEE_FLOAT;
+        bool supported = (formatTag == WAVE_FORMAT_PCM && (info.BitsPerSample == 8 || info.BitsPerSample == 16 || info.BitsPerSample == 24)) ||
+                         (info.Float && info.BitsPerSample == 32);
+        if (!supported || info.Channels == 0 || info.Channels > 2 || info.SampleRate == 0) {
+            printf("Error: Unsupported WAV format (tag %u, %u channels, %u bits)\n", formatTag, info.Channels, info.BitsPerSample);
+            return false;
+        }
+
+        // Streamed recorders leave the size at 0 or 0xFFFFFFFF; trust the file length then
+        uint8_t sizeBytes[4];
+        fseek(file, (long)(info.DataOffset - 4), SEEK_SET);
+        if (fread(sizeBytes, 1, 4, file) != 4) {
+            return false;
+        }
+        uint64_t dataBytes = ReadU32(sizeBytes);
+        fseek(file, 0, SEEK_END);
+        uint64_t available = (uint64_t)ftell(file) - info.DataOffset;
+        if (dataBytes == 0 || dataBytes > available) {
+            dataBytes = available;
+        }
+        info.FrameCount = dataBytes / info.GetFrameSize();
+        fseek(file, (long)info.DataOffset, SEEK_SET);
+        return true;
+    }
+
+    void ConvertWavSamples(const uint8_t* source, const WavInfo& info, float* destination, size_t samples)
+    {
+        switch (info.BitsPerSample) {
+            case 8:
+                for (size_t i = 0; i < samples; i++) {
+                    destination[i] = ((float)source[i] - 128.0f) * (1.0f / 128.0f);
+                }
+                break;
+            case 16:
+                for (size_t i = 0; i < samples; i++) {
+                    int16_t value;
+                    memcpy(&value, source + i * 2, 2);
+                    destination[i] = (float)value * (1.0f / 32768.0f);
+                }
+                break;
+            case 24:
+                for (size_t i = 0; i < samples; i++) {
+                    const uint8_t* p = source + i * 3;
+                    int32_t value = (int32_t)(((uint32_t)p[0] << 8) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 24)) >> 8;
+                    destination[i] = (float)value * (1.0f / 8388608.0f);
+                }
+                break;
+            case 32:
+                memcpy(destination, source, samples * sizeof(float));
+                break;
+        }
+    }
+
+    bool WriteWavHeader(FILE* file, uint32_t channels, uint32_t sampleRate, uint32_t dataBytes)
+    {
+        uint8_t header[44];
+        memcpy(header, "RIFF", 4);
+        WriteU32(header + 4, 36 + dataBytes);
+        memcpy(header + 8, "WAVEfmt ", 8);
+        WriteU32(header + 16, 16);
+        WriteU16(header + 20, WAVE_FORMAT_IEEE_FLOAT);
+        WriteU16(header + 22, (uint16_t)channels);
+        WriteU32(header + 24, sampleRate);
+        WriteU32(header + 28, sampleRate * channels * 4);
+        WriteU16(header + 32, (uint16_t)(channels * 4));
+        WriteU16(header + 34, 32);
+        memcpy(header + 36, "data", 4);
+        WriteU32(header + 40, dataBytes);
+        return fwrite(header, 1, sizeof(header), file) == sizeof(header);
+    }
+
+    bool PatchWavHeader(FILE* file, uint32_t dataBytes)
+    {
+        uint8_t size[4];
+        long end = ftell(file);
+        WriteU32(size, 36 + dataBytes);
+        fseek(file, 4, SEEK_SET);
+        bool ok = fwrite(size, 1, 4, file) == 4;
+        WriteU32(size, dataBytes);
+        fseek(file, 40, SEEK_SET);
+        ok = ok && fwrite(size, 1, 4, file) == 4;
+        fseek(file, end, SEEK_SET);
+        return ok;
+    }
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace Marle {
+
+    struct WavInfo {
+        uint32_t Channels = 0;
+        uint32_t SampleRate = 0;
+        uint32_t BitsPerSample = 0;     // 8, 16 or 24 bit PCM, or 32-bit float
+        bool Float = false;
+        uint64_t DataOffset = 0;        // File offset of the first sample
+        uint64_t FrameCount = 0;
+
+        uint32_t GetFrameSize() const { return Channels * (BitsPerSample / 8); }
+    };
+
+    // Parses the RIFF header and leaves the file positioned at the first sample
+    bool ReadWavHeader(FILE* file, WavInfo& info);
+
+    // Converts interleaved samples as stored in the file to interleaved floats in [-1, 1]
+    void ConvertWavSamples(const uint8_t* source, const WavInfo& info, float* destination, size_t samples);
+
+    // Writes a 32-bit float header; dataBytes may be patched later with PatchWavHeader
+    bool WriteWavHeader(FILE* file, uint32_t channels, uint32_t sampleRate, uint32_t dataBytes);
+    bool PatchWavHeader(FILE* file, uint32_t dataBytes);
+
+}
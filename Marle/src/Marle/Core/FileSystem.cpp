@@ -0,0 +1,975 @@
+#include "mrlpch.h"
+#include "FileSystem.h"
+#include "JobSystem.h"
+#include "MemoryTracker.h"
+#include "Metrics.h"
+#include "../Platform/Linux/IoUring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Marle {
+
+    // On-disk layout of a .mpak archive: the header, the files back to back, then EntryCount
+    // table entries, each followed by its path (PathBytes, not terminated)
+    struct ArchiveHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t EntryCount;
+        uint32_t Reserved;
+        uint64_t TableOffset;
+        uint64_t TableBytes;
+    };
+
+    struct ArchiveTableEntry {
+        uint64_t Offset;
+        uint64_t Size;
+        uint32_t PathBytes;
+        uint32_t Reserved;
+    };
+
+    static_assert(sizeof(ArchiveHeader) == 32, "ArchiveHeader is stored on disk as-is");
+    static_assert(sizeof(ArchiveTableEntry) == 24, "ArchiveTableEntry is stored on disk as-is");
+
+    static const uint32_t s_ArchiveMagic = 0x4B41504D;     // "MPAK" in memory order
+    static const uint32_t s_ArchiveVersion = 1;
+    // Largest single read request; longer files take several
+    static const uint64_t s_MaxReadBytes = 1ull << 30;
+
+    static const double s_ReadMsBounds[] = { 0.1, 0.25, 0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0 };
+
+    static MetricId s_ReadMsMetric = Metrics::InvalidMetric;
+    static MetricId s_BytesReadMetric = Metrics::InvalidMetric;
+
+    static uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // An open OS file, shared by every VirtualFile reading from it
+    class NativeFile {
+    public:
+        ~NativeFile();
+
+        static std::shared_ptr<NativeFile> Open(const std::string& path);
+
+        uint64_t GetSize() const { return m_Size; }
+        int GetDescriptor() const { return m_Descriptor; }
+        bool Read(uint64_t offset, void* dst, size_t size);
+
+    private:
+        int m_Descriptor = -1;
+    #if !defined(__unix__) && !defined(__APPLE__)
+        FILE* m_File = nullptr;
+        std::mutex m_Mutex;         // Seek and read are one step
+    #endif
+        uint64_t m_Size = 0;
+    };
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    NativeFile::~NativeFile()
+    {
+        if (m_Descriptor >= 0) {
+            close(m_Descriptor);
+        }
+    }
+
+    std::shared_ptr<NativeFile> NativeFile::Open(const std::string& path)
+    {
+        int descriptor;
+        do {
+            descriptor = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        } while (descriptor < 0 && errno == EINTR);
+        if (descriptor < 0) {
+            return nullptr;
+        }
+
+        struct stat info;
+        if (fstat(descriptor, &info) != 0 || !S_ISREG(info.st_mode)) {
+            close(descriptor);
+            return nullptr;
+        }
+
+        auto file = std::make_shared<NativeFile>();
+        file->m_Descriptor = descriptor;
+        file->m_Size = (uint64_t)info.st_size;
+        return file;
+    }
+
+    bool NativeFile::Read(uint64_t offset, void* dst, size_t size)
+    {
+        uint8_t* cursor = static_cast<uint8_t*>(dst);
+        while (size > 0) {
+            ssize_t count = pread(m_Descriptor, cursor, size, (off_t)offset);
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count <= 0) {
+                return false;
+            }
+            cursor += count;
+            offset += (uint64_t)count;
+            size -= (size_t)count;
+        }
+        return true;
+    }
+
+#else
+
+    NativeFile::~NativeFile()
+    {
+        if (m_File) {
+            fclose(m_File);
+        }
+    }
+
+    std::shared_ptr<NativeFile> NativeFile::Open(const std::string& path)
+    {
+        FILE* handle = fopen(path.c_str(), "rb");
+        if (!handle) {
+            return nullptr;
+        }
+        auto file = std::make_shared<NativeFile>();
+        file->m_File = handle;
+        fseek(handle, 0, SEEK_END);
+        file->m_Size = (uint64_t)ftell(handle);
+        return file;
+    }
+
+    bool NativeFile::Read(uint64_t offset, void* dst, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return fseek(m_File, (long)offset, SEEK_SET) == 0 && fread(dst, 1, size, m_File) == size;
+    }
+
+#endif
+
+    // Equal read buffers carved from one page-aligned allocation, so the whole pool can be
+    // registered with io_uring once
+    struct FileBufferPool {
+        void* Allocation = nullptr;
+        size_t SlabBytes = 0;
+        std::vector<uint8_t*> Slabs;
+        std::mutex Mutex;
+        std::vector<int> Free;
+
+        FileBufferPool(uint32_t count, size_t slabBytes)
+        {
+            const size_t page = 4096;
+            SlabBytes = (slabBytes + page - 1) & ~(page - 1);
+            Allocation = MemoryTracker::Allocate(SlabBytes * count + page, MemoryTag::Assets);
+            uint8_t* base = reinterpret_cast<uint8_t*>(((uintptr_t)Allocation + page - 1) & ~(uintptr_t)(page - 1));
+            for (uint32_t i = 0; i < count; i++) {
+                Slabs.push_back(base + SlabBytes * i);
+                Free.push_back((int)(count - 1 - i));
+            }
+        }
+
+        ~FileBufferPool()
+        {
+            MemoryTracker::Free(Allocation);
+        }
+
+        int Acquire()
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            if (Free.empty()) {
+                return -1;
+            }
+            int slab = Free.back();
+            Free.pop_back();
+            return slab;
+        }
+
+        void Release(int slab)
+        {
+            std::lock_guard<std::mutex> lock(Mutex);
+            Free.push_back(slab);
+        }
+    };
+
+    FileBuffer::FileBuffer(FileBuffer&& other) noexcept
+        : m_Data(other.m_Data), m_Size(other.m_Size), m_Pool(std::move(other.m_Pool)), m_Slab(other.m_Slab)
+    {
+        other.m_Data = nullptr;
+        other.m_Size = 0;
+        other.m_Slab = -1;
+    }
+
+    FileBuffer& FileBuffer::operator=(FileBuffer&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            m_Data = other.m_Data;
+            m_Size = other.m_Size;
+            m_Pool = std::move(other.m_Pool);
+            m_Slab = other.m_Slab;
+            other.m_Data = nullptr;
+            other.m_Size = 0;
+            other.m_Slab = -1;
+        }
+        return *this;
+    }
+
+    FileBuffer::~FileBuffer()
+    {
+        Reset();
+    }
+
+    void FileBuffer::Reset()
+    {
+        if (m_Pool) {
+            m_Pool->Release(m_Slab);
+            m_Pool.reset();
+        } else if (m_Data) {
+            MemoryTracker::Free(m_Data);
+        }
+        m_Data = nullptr;
+        m_Size = 0;
+        m_Slab = -1;
+    }
+
+    bool VirtualFile::Read(uint64_t offset, void* dst, size_t size) const
+    {
+        if (!m_File || offset > m_Size || size > m_Size - offset) {
+            return false;
+        }
+        return m_File->Read(m_Offset + offset, dst, size);
+    }
+
+    bool VirtualFile::ReadAll(FileBuffer& data) const
+    {
+        data.Reset();
+        if (!m_File) {
+            return false;
+        }
+        if (m_Size > 0) {
+            data.m_Data = static_cast<uint8_t*>(MemoryTracker::Allocate((size_t)m_Size, MemoryTag::Assets));
+            if (!data.m_Data) {
+                return false;
+            }
+            data.m_Size = (size_t)m_Size;
+        }
+        if (!Read(0, data.m_Data, data.m_Size)) {
+            data.Reset();
+            return false;
+        }
+        return true;
+    }
+
+    void VirtualFile::Close()
+    {
+        m_File.reset();
+        m_Offset = m_Size = 0;
+    }
+
+    struct ArchiveEntry {
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    struct Mount {
+        std::string Point;              // Normalized, no trailing slash
+        std::string Directory;
+        std::shared_ptr<NativeFile> Archive;
+        std::string ArchivePath;
+        std::unordered_map<std::string, ArchiveEntry> Entries;
+    };
+
+    struct ReadRequest {
+        FileReadId Id = 0;
+        std::string Path;
+        FileReadCallback Callback;
+        VirtualFile File;
+        FileBuffer Data;
+        uint64_t Done = 0;              // Bytes read so far
+        bool Failed = false;
+        uint64_t StartNs = 0;
+    };
+
+    struct FileSystem::FileSystemData {
+        FileSystemSettings Settings;
+
+        std::mutex MountMutex;
+        std::vector<std::shared_ptr<const Mount>> Mounts;  // Oldest first
+
+        IoUring Ring;
+        bool UseRing = false;
+        std::shared_ptr<FileBufferPool> Pool;
+
+        FileReadId NextId = 1;
+        std::unordered_map<FileReadId, std::unique_ptr<ReadRequest>> Requests;
+        std::deque<ReadRequest*> Queued;
+        std::vector<ReadRequest*> Finished;    // Callbacks still to run
+        uint32_t InFlight = 0;
+
+        // Thread pool backend: jobs hand their requests back here
+        std::mutex CompletedMutex;
+        std::vector<ReadRequest*> Completed;
+
+        Stats Counters;                         // Everything but the live counts
+        double TotalLatencyMs = 0.0;
+        bool ReportedSubmitError = false;
+    };
+
+    std::unique_ptr<FileSystem::FileSystemData> FileSystem::s_Data = nullptr;
+
+    // Forward slashes, no empty or "." components, and each ".." folded into the component
+    // before it. False when a ".." would climb above the root ("Assets/../../etc/passwd"), so no
+    // path can reach outside a mounted directory.
+    static bool NormalizePath(const std::string& path, std::string& normalized)
+    {
+        normalized.clear();
+        normalized.reserve(path.size());
+        size_t start = 0;
+        while (start <= path.size()) {
+            size_t end = start;
+            while (end < path.size() && path[end] != '/' && path[end] != '\\') {
+                end++;
+            }
+            size_t length = end - start;
+            if (length == 2 && path[start] == '.' && path[start + 1] == '.') {
+                if (normalized.empty()) {
+                    return false;
+                }
+                size_t slash = normalized.rfind('/');
+                normalized.resize(slash == std::string::npos ? 0 : slash);
+            } else if (length > 0 && !(length == 1 && path[start] == '.')) {
+                if (!normalized.empty()) {
+                    normalized += '/';
+                }
+                normalized.append(path, start, length);
+            }
+            start = end + 1;
+        }
+        return true;
+    }
+
+    static bool MatchMount(const std::string& point, const std::string& path, std::string& relative)
+    {
+        if (point.empty()) {
+            relative = path;
+            return true;
+        }
+        if (path.size() <= point.size() || path[point.size()] != '/' || path.compare(0, point.size(), point) != 0) {
+            return false;
+        }
+        relative = path.substr(point.size() + 1);
+        return true;
+    }
+
+    // For a path NormalizePath rejected: whether the components before its first ".." already lie
+    // inside one of the mount points ("Assets/../../x" with "Assets" mounted), so it escapes a mount
+    // rather than being a native path outside the virtual tree ("../shared/x.png")
+    static bool EscapesMount(const std::vector<std::shared_ptr<const Mount>>& mounts, const std::string& path)
+    {
+        size_t end = 0;
+        while (end < path.size()) {
+            size_t next = end;
+            while (next < path.size() && path[next] != '/' && path[next] != '\\') {
+                next++;
+            }
+            if (next - end == 2 && path[end] == '.' && path[end + 1] == '.') {
+                break;
+            }
+            end = next + 1;
+        }
+
+        std::string prefix, relative;
+        NormalizePath(path.substr(0, end), prefix);
+        for (const std::shared_ptr<const Mount>& mount : mounts) {
+            if (!mount->Point.empty() && (prefix == mount->Point || MatchMount(mount->Point, prefix, relative))) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void FileSystem::Init(const FileSystemSettings& settings)
+    {
+        s_Data = std::make_unique<FileSystemData>();
+        FileSystemData& data = *s_Data;
+        data.Settings = settings;
+        data.Settings.QueueDepth = std::max(data.Settings.QueueDepth, 1u);
+        if (settings.PooledBuffers > 0 && settings.PooledBufferBytes > 0) {
+            data.Pool = std::make_shared<FileBufferPool>(std::min(settings.PooledBuffers, 16384u), settings.PooledBufferBytes);
+        }
+
+        if (settings.UseIoUring && data.Ring.Init(data.Settings.QueueDepth)) {
+            data.UseRing = true;
+            if (data.Pool) {
+                data.Ring.RegisterBuffers(data.Pool->Slabs.data(), data.Pool->SlabBytes, (uint32_t)data.Pool->Slabs.size());
+            }
+        }
+
+        s_ReadMsMetric = Metrics::RegisterHistogram("marle_fs_read_ms", "Async file read, request to completion",
+                                                    s_ReadMsBounds, (uint32_t)(sizeof(s_ReadMsBounds) / sizeof(double)));
+        s_BytesReadMetric = Metrics::RegisterCounter("marle_fs_bytes_read_total", "Bytes read by async file reads");
+
+        Stats stats = GetStats();
+        printf("FileSystem initialized (%s%s, queue depth %u, %u x %zu KB read buffers)\n", stats.Backend,
+               stats.RegisteredBuffers ? " with registered buffers" : "", data.Settings.QueueDepth,
+               data.Pool ? (uint32_t)data.Pool->Slabs.size() : 0, data.Pool ? data.Pool->SlabBytes / 1024 : 0);
+    }
+
+    void FileSystem::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+
+        Flush();
+        s_Data->Ring.Shutdown();
+        s_Data.reset();
+        printf("FileSystem shutdown complete\n");
+    }
+
+    bool FileSystem::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    bool FileSystem::MountDirectory(const std::string& mountPoint, const std::string& directory)
+    {
+        if (!s_Data) {
+            printf("Error: FileSystem not initialized (mounting %s)\n", directory.c_str());
+            return false;
+        }
+    #if defined(__unix__) || defined(__APPLE__)
+        struct stat info;
+        if (stat(directory.c_str(), &info) != 0 || !S_ISDIR(info.st_mode)) {
+            printf("Error: Cannot mount %s, it is not a directory\n", directory.c_str());
+            return false;
+        }
+    #endif
+
+        auto mount = std::make_shared<Mount>();
+        if (!NormalizePath(mountPoint, mount->Point)) {
+            printf("Error: Cannot mount %s at %s, it is outside the root\n", directory.c_str(), mountPoint.c_str());
+            return false;
+        }
+        mount->Directory = directory.empty() ? "." : directory;
+        std::lock_guard<std::mutex> lock(s_Data->MountMutex);
+        s_Data->Mounts.push_back(std::move(mount));
+        return true;
+    }
+
+    bool FileSystem::MountArchive(const std::string& mountPoint, const std::string& archivePath)
+    {
+        if (!s_Data) {
+            printf("Error: FileSystem not initialized (mounting %s)\n", archivePath.c_str());
+            return false;
+        }
+
+        auto mount = std::make_shared<Mount>();
+        if (!NormalizePath(mountPoint, mount->Point)) {
+            printf("Error: Cannot mount %s at %s, it is outside the root\n", archivePath.c_str(), mountPoint.c_str());
+            return false;
+        }
+
+        std::shared_ptr<NativeFile> file = NativeFile::Open(archivePath);
+        if (!file) {
+            printf("Error: Could not open archive %s\n", archivePath.c_str());
+            return false;
+        }
+
+        ArchiveHeader header;
+        uint64_t fileSize = file->GetSize();
+        if (fileSize < sizeof(header) || !file->Read(0, &header, sizeof(header)) || header.Magic != s_ArchiveMagic ||
+            header.Version != s_ArchiveVersion || header.TableOffset < sizeof(header) ||
+            header.TableOffset > fileSize || header.TableBytes > fileSize - header.TableOffset) {
+            printf("Error: %s is not a compatible archive\n", archivePath.c_str());
+            return false;
+        }
+
+        std::vector<uint8_t> table((size_t)header.TableBytes);
+        if (!file->Read(header.TableOffset, table.data(), table.size())) {
+            printf("Error: Archive %s is truncated\n", archivePath.c_str());
+            return false;
+        }
+
+        mount->Archive = file;
+        mount->ArchivePath = archivePath;
+        mount->Entries.reserve(header.EntryCount);
+        size_t cursor = 0;
+        for (uint32_t i = 0; i < header.EntryCount; i++) {
+            ArchiveTableEntry entry;
+            if (table.size() - cursor < sizeof(entry)) {
+                printf("Error: Archive %s has a truncated table\n", archivePath.c_str());
+                return false;
+            }
+            memcpy(&entry, table.data() + cursor, sizeof(entry));
+            cursor += sizeof(entry);
+            if (table.size() - cursor < entry.PathBytes || entry.Offset < sizeof(header) ||
+                entry.Offset > header.TableOffset || entry.Size > header.TableOffset - entry.Offset) {
+                printf("Error: Archive %s has a malformed entry (%u)\n", archivePath.c_str(), i);
+                return false;
+            }
+            std::string path(reinterpret_cast<const char*>(table.data() + cursor), entry.PathBytes), normalized;
+            cursor += entry.PathBytes;
+            if (!NormalizePath(path, normalized)) {
+                printf("Error: Archive %s has an entry outside its root (%s)\n", archivePath.c_str(), path.c_str());
+                return false;
+            }
+            mount->Entries[normalized] = { entry.Offset, entry.Size };
+        }
+
+        printf("Mounted %s at /%s (%zu files)\n", archivePath.c_str(), mount->Point.c_str(), mount->Entries.size());
+        std::lock_guard<std::mutex> lock(s_Data->MountMutex);
+        s_Data->Mounts.push_back(std::move(mount));
+        return true;
+    }
+
+    bool FileSystem::Unmount(const std::string& mountPoint)
+    {
+        if (!s_Data) {
+            return false;
+        }
+
+        std::string point;
+        if (!NormalizePath(mountPoint, point)) {
+            return false;
+        }
+        std::lock_guard<std::mutex> lock(s_Data->MountMutex);
+        std::vector<std::shared_ptr<const Mount>>& mounts = s_Data->Mounts;
+        size_t before = mounts.size();
+        mounts.erase(std::remove_if(mounts.begin(), mounts.end(),
+                                    [&point](const std::shared_ptr<const Mount>& mount) { return mount->Point == point; }),
+                     mounts.end());
+        return mounts.size() != before;
+    }
+
+    bool FileSystem::Exists(const std::string& path)
+    {
+        VirtualFile file;
+        return Open(path, file);
+    }
+
+    bool FileSystem::Open(const std::string& path, VirtualFile& file)
+    {
+        file.Close();
+
+        // The table is copied so that directory lookups, which are syscalls, run unlocked
+        std::vector<std::shared_ptr<const Mount>> mounts;
+        if (s_Data) {
+            std::lock_guard<std::mutex> lock(s_Data->MountMutex);
+            mounts = s_Data->Mounts;
+        }
+
+        std::string normalized, relative;
+        if (!mounts.empty() && !NormalizePath(path, normalized)) {
+            if (EscapesMount(mounts, path)) {
+                printf("Error: %s climbs out of a mounted directory\n", path.c_str());
+                return false;
+            }
+            mounts.clear(); // Not a virtual path; only the native fallback below applies
+        }
+        for (auto it = mounts.rbegin(); it != mounts.rend(); ++it) {
+            const Mount& mount = **it;
+            if (!MatchMount(mount.Point, normalized, relative)) {
+                continue;
+            }
+            if (mount.Archive) {
+                auto entry = mount.Entries.find(relative);
+                if (entry != mount.Entries.end()) {
+                    file.m_File = mount.Archive;
+                    file.m_Offset = entry->second.Offset;
+                    file.m_Size = entry->second.Size;
+                    return true;
+                }
+            } else if (std::shared_ptr<NativeFile> native = NativeFile::Open(mount.Directory + "/" + relative)) {
+                file.m_Size = native->GetSize();
+                file.m_File = std::move(native);
+                return true;
+            }
+        }
+
+        std::shared_ptr<NativeFile> native = NativeFile::Open(path);
+        if (!native) {
+            return false;
+        }
+        file.m_Size = native->GetSize();
+        file.m_File = std::move(native);
+        return true;
+    }
+
+    bool FileSystem::ReadFile(const std::string& path, FileBuffer& data)
+    {
+        VirtualFile file;
+        if (!Open(path, file)) {
+            data.Reset();
+            return false;
+        }
+        return file.ReadAll(data);
+    }
+
+    bool FileSystem::ReadTextFile(const std::string& path, std::string& text)
+    {
+        VirtualFile file;
+        text.clear();
+        if (!Open(path, file)) {
+            return false;
+        }
+        text.resize((size_t)file.GetSize());
+        if (!text.empty() && !file.Read(0, &text[0], text.size())) {
+            text.clear();
+            return false;
+        }
+        return true;
+    }
+
+    FileReadId FileSystem::ReadAsync(const std::string& path, FileReadCallback callback)
+    {
+        // Like JobSystem without workers: done inline before the function returns
+        if (!s_Data) {
+            FileReadResult result;
+            result.Path = path;
+            result.Success = ReadFile(path, result.Data);
+            if (callback) {
+                callback(result);
+            }
+            return 0;
+        }
+
+        FileSystemData& data = *s_Data;
+        auto request = std::make_unique<ReadRequest>();
+        ReadRequest* read = request.get();
+        read->Id = data.NextId++;
+        read->Path = path;
+        read->Callback = std::move(callback);
+        read->StartNs = NowNs();
+        data.Requests[read->Id] = std::move(request);
+
+        if (!Open(path, read->File)) {
+            read->Failed = true;
+            data.Finished.push_back(read);
+            return read->Id;
+        }
+
+        size_t size = (size_t)read->File.GetSize();
+        if (size == 0) {
+            data.Finished.push_back(read);
+            return read->Id;
+        }
+
+        FileBuffer& buffer = read->Data;
+        if (data.Pool && size <= data.Pool->SlabBytes) {
+            int slab = data.Pool->Acquire();
+            if (slab >= 0) {
+                buffer.m_Pool = data.Pool;
+                buffer.m_Slab = slab;
+                buffer.m_Data = data.Pool->Slabs[slab];
+                buffer.m_Size = size;
+                data.Counters.PooledReads++;
+            }
+        }
+        if (!buffer.m_Data) {
+            buffer.m_Data = static_cast<uint8_t*>(MemoryTracker::Allocate(size, MemoryTag::Assets));
+            buffer.m_Size = buffer.m_Data ? size : 0;
+        }
+        if (!buffer.m_Data) {
+            read->Failed = true;
+            data.Finished.push_back(read);
+            return read->Id;
+        }
+
+        data.Queued.push_back(read);
+        return read->Id;
+    }
+
+    void FileSystem::Update()
+    {
+        if (s_Data) {
+            Pump(false);
+        }
+    }
+
+    void FileSystem::Wait(FileReadId id)
+    {
+        while (s_Data && s_Data->Requests.count(id)) {
+            Pump(true);
+        }
+    }
+
+    void FileSystem::Flush()
+    {
+        while (s_Data && !s_Data->Requests.empty()) {
+            Pump(true);
+        }
+    }
+
+    void FileSystem::Pump(bool block)
+    {
+        FileSystemData& data = *s_Data;
+        ReapCompletions();
+        SubmitQueued();
+
+        bool wait = block && data.Finished.empty() && data.InFlight > 0;
+        if (data.UseRing) {
+            // One syscall for every read queued since the last call, and for the wait if any
+            if ((data.Ring.GetPrepared() > 0 || wait) && data.Ring.Submit(wait ? 1 : 0) < 0 && !data.ReportedSubmitError) {
+                printf("Error: io_uring_enter failed (%s)\n", strerror(errno));
+                data.ReportedSubmitError = true;
+            }
+            if (wait) {
+                ReapCompletions();
+            }
+        } else if (wait) {
+            if (!JobSystem::RunPendingJob()) {
+                std::this_thread::yield();
+            }
+            ReapCompletions();
+        }
+
+        DispatchFinished();
+    }
+
+    void FileSystem::SubmitQueued()
+    {
+        FileSystemData& data = *s_Data;
+        while (!data.Queued.empty() && data.InFlight < data.Settings.QueueDepth) {
+            ReadRequest* read = data.Queued.front();
+            FileBuffer& buffer = read->Data;
+
+            if (data.UseRing) {
+                uint32_t size = (uint32_t)std::min<uint64_t>(buffer.m_Size - read->Done, s_MaxReadBytes);
+                int registered = buffer.m_Pool && data.Ring.HasRegisteredBuffers() ? buffer.m_Slab : -1;
+                if (!data.Ring.PrepareRead(read->File.m_File->GetDescriptor(), buffer.m_Data + read->Done, size,
+                                           read->File.m_Offset + read->Done, read->Id, registered)) {
+                    break;
+                }
+            } else {
+                FileSystemData* owner = &data;
+                data.Counters.Submissions++;
+                JobSystem::SubmitBackground([read, owner]() {
+                    read->Failed = !read->File.Read(read->Done, read->Data.GetData() + read->Done, read->Data.GetSize() - read->Done);
+                    read->Done = read->Data.GetSize();
+                    std::lock_guard<std::mutex> lock(owner->CompletedMutex);
+                    owner->Completed.push_back(read);
+                });
+            }
+
+            data.Queued.pop_front();
+            data.InFlight++;
+            data.Counters.PeakInFlight = std::max(data.Counters.PeakInFlight, data.InFlight);
+        }
+    }
+
+    void FileSystem::ReapCompletions()
+    {
+        FileSystemData& data = *s_Data;
+        if (!data.UseRing) {
+            std::vector<ReadRequest*> completed;
+            {
+                std::lock_guard<std::mutex> lock(data.CompletedMutex);
+                completed.swap(data.Completed);
+            }
+            data.InFlight -= (uint32_t)completed.size();
+            data.Finished.insert(data.Finished.end(), completed.begin(), completed.end());
+            return;
+        }
+
+        uint64_t id;
+        int32_t result;
+        while (data.Ring.PopCompletion(id, result)) {
+            data.InFlight--;
+            auto it = data.Requests.find(id);
+            if (it == data.Requests.end()) {
+                continue;
+            }
+
+            ReadRequest* read = it->second.get();
+            if (result == -EINTR || result == -EAGAIN) {
+                data.Queued.push_front(read);
+                continue;
+            }
+            if (result <= 0) {
+                // An error, or the file shrank since it was opened
+                read->Failed = true;
+                data.Finished.push_back(read);
+                continue;
+            }
+
+            // A short read leaves the rest for the next submission, ahead of newer requests
+            read->Done += (uint64_t)result;
+            if (read->Done < read->Data.GetSize()) {
+                data.Queued.push_front(read);
+            } else {
+                data.Finished.push_back(read);
+            }
+        }
+    }
+
+    void FileSystem::DispatchFinished()
+    {
+        FileSystemData& data = *s_Data;
+        std::vector<ReadRequest*> finished;
+        finished.swap(data.Finished);
+
+        uint64_t now = NowNs();
+        for (ReadRequest* read : finished) {
+            std::unique_ptr<ReadRequest> owned = std::move(data.Requests[read->Id]);
+            data.Requests.erase(read->Id);
+
+            FileReadResult result;
+            result.Id = read->Id;
+            result.Path = std::move(read->Path);
+            result.Success = !read->Failed;
+            result.LatencyMs = (double)(now - read->StartNs) / 1000000.0;
+            if (result.Success) {
+                result.Data = std::move(read->Data);
+            }
+            read->Data.Reset();
+            read->File.Close();
+
+            Stats& counters = data.Counters;
+            counters.Reads++;
+            counters.Failures += read->Failed ? 1 : 0;
+            counters.BytesRead += result.Data.GetSize();
+            counters.MaxLatencyMs = std::max(counters.MaxLatencyMs, result.LatencyMs);
+            data.TotalLatencyMs += result.LatencyMs;
+            Metrics::Observe(s_ReadMsMetric, result.LatencyMs);
+            Metrics::Increment(s_BytesReadMetric, result.Data.GetSize());
+
+            if (owned->Callback) {
+                owned->Callback(result);
+            }
+        }
+    }
+
+    FileSystem::Stats FileSystem::GetStats()
+    {
+        Stats stats;
+        if (!s_Data) {
+            return stats;
+        }
+
+        FileSystemData& data = *s_Data;
+        stats = data.Counters;
+        stats.Backend = data.UseRing ? "io_uring" : "thread pool";
+        stats.RegisteredBuffers = data.UseRing && data.Ring.HasRegisteredBuffers();
+        {
+            std::lock_guard<std::mutex> lock(data.MountMutex);
+            stats.Mounts = (uint32_t)data.Mounts.size();
+        }
+        stats.Queued = (uint32_t)data.Queued.size();
+        stats.InFlight = data.InFlight;
+        if (data.UseRing) {
+            stats.Submissions = data.Ring.GetEnterCalls();
+        }
+        stats.AverageLatencyMs = stats.Reads ? data.TotalLatencyMs / (double)stats.Reads : 0.0;
+        return stats;
+    }
+
+    void FileSystem::PrintStats()
+    {
+        Stats stats = GetStats();
+        printf("FileSystem (%s%s): %u mounts, %llu reads (%llu failed, %llu pooled), %.1f MB, %llu submissions\n",
+               stats.Backend, stats.RegisteredBuffers ? ", registered buffers" : "", stats.Mounts,
+               (unsigned long long)stats.Reads, (unsigned long long)stats.Failures, (unsigned long long)stats.PooledReads,
+               stats.BytesRead / (1024.0 * 1024.0), (unsigned long long)stats.Submissions);
+        printf("  %u in flight (peak %u), %u queued, latency %.2f ms average, %.2f ms max\n",
+               stats.InFlight, stats.PeakInFlight, stats.Queued, stats.AverageLatencyMs, stats.MaxLatencyMs);
+    }
+
+    ArchiveWriter::ArchiveWriter(const std::string& path)
+        : m_Path(path)
+    {
+        m_File = fopen(path.c_str(), "wb");
+        ArchiveHeader header;
+        memset(&header, 0, sizeof(header)); // Stays invalid until Finish
+        if (!m_File || fwrite(&header, sizeof(header), 1, m_File) != 1) {
+            printf("Error: Could not create archive %s\n", path.c_str());
+            if (m_File) {
+                fclose(m_File);
+                m_File = nullptr;
+            }
+        }
+        m_Offset = sizeof(header);
+    }
+
+    ArchiveWriter::~ArchiveWriter()
+    {
+        if (m_File) {
+            fclose(m_File);
+        }
+    }
+
+    bool ArchiveWriter::AddFile(const std::string& path, const uint8_t* data, size_t size)
+    {
+        std::string normalized;
+        if (!m_File) {
+            return false;
+        }
+        if (!NormalizePath(path, normalized)) {
+            printf("Error: %s is outside the archive root (%s)\n", path.c_str(), m_Path.c_str());
+            return false;
+        }
+        if (size > 0 && fwrite(data, 1, size, m_File) != size) {
+            printf("Error: Could not write %s to archive %s\n", path.c_str(), m_Path.c_str());
+            return false;
+        }
+        m_Entries.push_back({ normalized, m_Offset, (uint64_t)size });
+        m_Offset += size;
+        return true;
+    }
+
+    bool ArchiveWriter::AddFileFromDisk(const std::string& path, const std::string& sourcePath)
+    {
+        std::shared_ptr<NativeFile> file = NativeFile::Open(sourcePath);
+        std::vector<uint8_t> data(file ? (size_t)file->GetSize() : 0);
+        if (!file || !file->Read(0, data.data(), data.size())) {
+            printf("Error: Could not read %s for archive %s\n", sourcePath.c_str(), m_Path.c_str());
+            return false;
+        }
+        return AddFile(path, data.data(), data.size());
+    }
+
+    bool ArchiveWriter::Finish()
+    {
+        if (!m_File) {
+            return false;
+        }
+
+        ArchiveHeader header;
+        memset(&header, 0, sizeof(header));
+        header.Magic = s_ArchiveMagic;
+        header.Version = s_ArchiveVersion;
+        header.EntryCount = (uint32_t)m_Entries.size();
+        header.TableOffset = m_Offset;
+
+        bool ok = true;
+        for (const Entry& entry : m_Entries) {
+            ArchiveTableEntry record;
+            memset(&record, 0, sizeof(record));
+            record.Offset = entry.Offset;
+            record.Size = entry.Size;
+            record.PathBytes = (uint32_t)entry.Path.size();
+            ok = ok && fwrite(&record, sizeof(record), 1, m_File) == 1 &&
+                 fwrite(entry.Path.data(), 1, entry.Path.size(), m_File) == entry.Path.size();
+            header.TableBytes += sizeof(record) + entry.Path.size();
+        }
+        ok = ok && fseek(m_File, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, m_File) == 1;
+        ok = fclose(m_File) == 0 && ok;
+        m_File = nullptr;
+        if (!ok) {
+            printf("Error: Could not write archive %s\n", m_Path.c_str());
+        }
+        return ok;
+    }
+
+}
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    class NativeFile;
+    struct FileBufferPool;
+
+    // Bytes read through the FileSystem: either one of its pooled read buffers, which goes back
+    // to the pool when this is destroyed, or heap memory tracked under the Assets tag.
+    // Move-only; may be handed to and destroyed on any thread.
+    class FileBuffer {
+    public:
+        FileBuffer() = default;
+        FileBuffer(FileBuffer&& other) noexcept;
+        FileBuffer& operator=(FileBuffer&& other) noexcept;
+        ~FileBuffer();
+
+        FileBuffer(const FileBuffer&) = delete;
+        FileBuffer& operator=(const FileBuffer&) = delete;
+
+        const uint8_t* GetData() const { return m_Data; }
+        uint8_t* GetData() { return m_Data; }
+        size_t GetSize() const { return m_Size; }
+        bool IsPooled() const { return m_Pool != nullptr; }
+
+        void Reset();
+
+    private:
+        friend class FileSystem;
+        friend class VirtualFile;
+
+        uint8_t* m_Data = nullptr;
+        size_t m_Size = 0;
+        std::shared_ptr<FileBufferPool> m_Pool;
+        int m_Slab = -1;
+    };
+
+    // A file opened through the FileSystem. An archive entry is a window into its archive.
+    // Reads are positional, so one VirtualFile may be read from several threads.
+    class VirtualFile {
+    public:
+        bool IsOpen() const { return m_File != nullptr; }
+        uint64_t GetSize() const { return m_Size; }
+
+        // Exactly `size` bytes at `offset`, or false
+        bool Read(uint64_t offset, void* dst, size_t size) const;
+        bool ReadAll(FileBuffer& data) const;
+        void Close();
+
+    private:
+        friend class FileSystem;
+
+        std::shared_ptr<NativeFile> m_File;
+        uint64_t m_Offset = 0;                  // Into m_File
+        uint64_t m_Size = 0;
+    };
+
+    typedef uint64_t FileReadId;
+
+    struct FileReadResult {
+        FileReadId Id = 0;
+        std::string Path;
+        bool Success = false;
+        FileBuffer Data;                        // The whole file; the callback may move it out
+        double LatencyMs = 0.0;                 // ReadAsync to completion
+    };
+
+    typedef std::function<void(FileReadResult& result)> FileReadCallback;
+
+    struct FileSystemSettings {
+        bool UseIoUring = true;                 // Linux; reads run on the JobSystem otherwise
+        uint32_t QueueDepth = 256;              // Reads in flight at once
+        uint32_t PooledBuffers = 64;
+        size_t PooledBufferBytes = 256 * 1024;  // Files up to this size are read into a pooled buffer
+    };
+
+    // One namespace of forward-slash paths over mounted directories and .mpak archives, with
+    // blocking and asynchronous reads.
+    //
+    // A path is looked up in the mounts, newest first: a mount at "Assets" serves
+    // "Assets/Textures/a.png" from its directory or archive as "Textures/a.png". A path no mount
+    // has is opened as given, relative to the working directory. ".." is resolved before the
+    // lookup; a path that climbs out of a mount point ("Assets/../../x") fails to open, while one
+    // that starts above the root ("../shared/x.png") skips the mounts and is opened as given.
+    //
+    // ReadAsync() opens the file (an archive entry is only a lookup) and queues the read.
+    // Update(), which Application::Run calls once per frame, submits the queued reads as one batch
+    // and runs the callbacks of the finished ones on the calling thread. With io_uring the batch
+    // is a single io_uring_enter and completions are read from the shared ring without a
+    // syscall; files that fit one of the pooled buffers are read into it, with the pool
+    // registered with the ring so the kernel does not map those pages per read. Without io_uring
+    // (other platforms, old kernels, or where it is blocked) each read is a JobSystem job.
+    //
+    // Open, ReadFile and ReadTextFile block and are safe from any thread, also before Init.
+    // Everything else is main thread only.
+    class FileSystem {
+    public:
+        static void Init(const FileSystemSettings& settings = FileSystemSettings());
+        // Finishes the reads in flight, running their callbacks
+        static void Shutdown();
+        static bool IsInitialized();
+
+        // mountPoint "" covers every path
+        static bool MountDirectory(const std::string& mountPoint, const std::string& directory);
+        static bool MountArchive(const std::string& mountPoint, const std::string& archivePath);
+        // Removes every mount at mountPoint; reads from an unmounted archive that are in flight
+        // keep it open until they finish
+        static bool Unmount(const std::string& mountPoint);
+
+        static bool Exists(const std::string& path);
+        static bool Open(const std::string& path, VirtualFile& file);
+        static bool ReadFile(const std::string& path, FileBuffer& data);
+        static bool ReadTextFile(const std::string& path, std::string& text);
+
+        // The callback runs from a later Update(), Wait() or Flush(), also when the file is missing
+        static FileReadId ReadAsync(const std::string& path, FileReadCallback callback);
+        static void Update();
+        // Returns once the read has completed and its callback has run
+        static void Wait(FileReadId id);
+        static void Flush();
+
+        struct Stats {
+            const char* Backend = "none";       // "io_uring" or "thread pool"
+            bool RegisteredBuffers = false;
+            uint32_t Mounts = 0;
+            uint32_t Queued = 0;                // Waiting for room in the queue
+            uint32_t InFlight = 0;
+            uint32_t PeakInFlight = 0;
+            uint64_t Reads = 0;                 // Completed async reads, failed included
+            uint64_t Failures = 0;
+            uint64_t PooledReads = 0;
+            uint64_t BytesRead = 0;
+            uint64_t Submissions = 0;           // io_uring_enter calls, or jobs for the thread pool
+            double AverageLatencyMs = 0.0;
+            double MaxLatencyMs = 0.0;
+        };
+        static Stats GetStats();
+        static void PrintStats();
+
+    private:
+        struct FileSystemData;
+        static std::unique_ptr<FileSystemData> s_Data;
+
+        static void Pump(bool block);
+        static void SubmitQueued();
+        static void ReapCompletions();
+        static void DispatchFinished();
+    };
+
+    // Writes a .mpak archive for FileSystem::MountArchive: the files back to back, then a table
+    // of their paths, offsets and sizes. Paths are relative to where the archive gets mounted.
+    class ArchiveWriter {
+    public:
+        explicit ArchiveWriter(const std::string& path);
+        ~ArchiveWriter();
+
+        ArchiveWriter(const ArchiveWriter&) = delete;
+        ArchiveWriter& operator=(const ArchiveWriter&) = delete;
+
+        bool AddFile(const std::string& path, const uint8_t* data, size_t size);
+        bool AddFileFromDisk(const std::string& path, const std::string& sourcePath);
+        // Writes the table; the archive is unreadable until then
+        bool Finish();
+
+    private:
+        struct Entry {
+            std::string Path;
+            uint64_t Offset;
+            uint64_t Size;
+        };
+
+        std::string m_Path;
+        FILE* m_File = nullptr;
+        uint64_t m_Offset = 0;
+        std::vector<Entry> m_Entries;
+    };
+
+}
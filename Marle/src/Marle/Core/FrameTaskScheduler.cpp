@@ -0,0 +1,451 @@
+#include "mrlpch.h"
+#include "FrameTaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace Marle {
+
+    static const double s_OverrunTolerance = 1.05;     // Timer and swap jitter that does not count as an overrun
+    static const double s_CeilingGrowthMs = 0.25;
+    static const double s_StepAverageWeight = 0.25;
+
+    struct FrameTask {
+        FrameTaskId Id = FrameTaskScheduler::InvalidTask;
+        const char* Name = nullptr;
+        FrameTaskScheduler::StepFunc Step;
+        FrameTaskPriority Priority = FrameTaskPriority::Normal;
+        uint64_t DeadlineNs = 0;            // 0 = none
+        uint64_t LastRunFrame = 0;
+        uint32_t Steps = 0;
+        double SpentMs = 0.0;
+        double AverageStepMs = 0.0;
+        float Progress = 0.0f;
+        bool Done = false;
+        bool Cancelled = false;
+        bool MissedDeadline = false;
+    };
+
+    struct FrameTaskScheduler::FrameTaskSchedulerData {
+        std::vector<FrameTask> Tasks;
+        std::vector<FrameTask> Incoming;    // Submitted since the last Execute; steps may submit while Tasks is iterated
+        std::vector<uint32_t> Order;
+        FrameTaskId NextId = 1;
+        bool Running = false;
+
+        double TargetMs = 1000.0 / 60.0;
+        double MinMs = 0.25;
+        double MaxMs = 4.0;
+        double ReserveMs = 1.0;
+        double CeilingMs = 2.0;
+
+        uint64_t Frame = 0;
+        uint64_t FrameStartNs = 0;
+        bool RanTasks = false;              // Whether the frame that just ended ran any step
+
+        Stats CurrentStats;
+    };
+
+    std::unique_ptr<FrameTaskScheduler::FrameTaskSchedulerData> FrameTaskScheduler::s_Data = nullptr;
+
+    static uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static double ToMs(uint64_t ns)
+    {
+        return (double)ns / 1000000.0;
+    }
+
+    bool FrameTaskContext::ShouldYield() const
+    {
+        return NowNs() >= m_SliceEndNs;
+    }
+
+    double FrameTaskContext::GetRemainingMs() const
+    {
+        uint64_t now = NowNs();
+        return now < m_SliceEndNs ? ToMs(m_SliceEndNs - now) : 0.0;
+    }
+
+    void FrameTaskContext::SetProgress(float progress)
+    {
+        if (m_Progress) {
+            *m_Progress = std::min(std::max(progress, 0.0f), 1.0f);
+        }
+    }
+
+    void FrameTaskScheduler::Init(double targetFrameMs)
+    {
+        if (s_Data) {
+            return;
+        }
+        s_Data = std::make_unique<FrameTaskSchedulerData>();
+        s_Data->TargetMs = targetFrameMs;
+        s_Data->CurrentStats.CeilingMs = s_Data->CeilingMs;
+        printf("FrameTaskScheduler initialized (%.2f ms frames)\n", targetFrameMs);
+    }
+
+    void FrameTaskScheduler::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+        size_t unfinished = 0;
+        for (const std::vector<FrameTask>* list : { &s_Data->Tasks, &s_Data->Incoming }) {
+            for (const FrameTask& task : *list) {
+                unfinished += (!task.Done && !task.Cancelled) ? 1 : 0;
+            }
+        }
+        if (unfinished > 0) {
+            printf("Warning: FrameTaskScheduler shut down with %zu unfinished tasks\n", unfinished);
+        }
+        s_Data.reset();
+    }
+
+    bool FrameTaskScheduler::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    FrameTaskId FrameTaskScheduler::Submit(const char* name, StepFunc step, FrameTaskPriority priority, double deadlineSeconds)
+    {
+        if (!s_Data) {
+            printf("Error: FrameTaskScheduler::Submit('%s') before Init\n", name);
+            return InvalidTask;
+        }
+        if (!step) {
+            printf("Error: FrameTaskScheduler::Submit('%s') without a step function\n", name);
+            return InvalidTask;
+        }
+
+        FrameTask task;
+        task.Id = s_Data->NextId++;
+        task.Name = name;
+        task.Step = std::move(step);
+        task.Priority = priority;
+        if (deadlineSeconds > 0.0) {
+            task.DeadlineNs = NowNs() + (uint64_t)(deadlineSeconds * 1e9);
+        }
+        s_Data->Incoming.push_back(std::move(task));
+        s_Data->CurrentStats.Pending++;
+        return s_Data->Incoming.back().Id;
+    }
+
+    static FrameTask* FindTask(std::vector<FrameTask>& tasks, FrameTaskId id)
+    {
+        for (FrameTask& task : tasks) {
+            if (task.Id == id) {
+                return &task;
+            }
+        }
+        return nullptr;
+    }
+
+    void FrameTaskScheduler::Cancel(FrameTaskId task)
+    {
+        if (!s_Data) {
+            return;
+        }
+        FrameTask* found = FindTask(s_Data->Tasks, task);
+        if (!found) {
+            found = FindTask(s_Data->Incoming, task);
+        }
+        // Flagged only: the task may be the one whose step is running
+        if (found && !found->Done && !found->Cancelled) {
+            found->Cancelled = true;
+            s_Data->CurrentStats.Pending--;
+        }
+    }
+
+    bool FrameTaskScheduler::IsPending(FrameTaskId task)
+    {
+        if (!s_Data) {
+            return false;
+        }
+        const FrameTask* found = FindTask(s_Data->Tasks, task);
+        if (!found) {
+            found = FindTask(s_Data->Incoming, task);
+        }
+        return found && !found->Done && !found->Cancelled;
+    }
+
+    float FrameTaskScheduler::GetProgress(FrameTaskId task)
+    {
+        if (!s_Data || task == InvalidTask || task >= s_Data->NextId) {
+            return 0.0f;
+        }
+        const FrameTask* found = FindTask(s_Data->Tasks, task);
+        if (!found) {
+            found = FindTask(s_Data->Incoming, task);
+        }
+        return found && !found->Done ? found->Progress : 1.0f;
+    }
+
+    void FrameTaskScheduler::SetTargetFrameMs(double targetMs)
+    {
+        if (s_Data && targetMs > 0.0) {
+            s_Data->TargetMs = targetMs;
+        }
+    }
+
+    void FrameTaskScheduler::SetBudgetLimits(double minMs, double maxMs, double reserveMs)
+    {
+        if (!s_Data) {
+            return;
+        }
+        if (minMs <= 0.0 || maxMs < minMs) {
+            printf("Error: FrameTaskScheduler budget limits %.3f..%.3f ms are invalid\n", minMs, maxMs);
+            return;
+        }
+        s_Data->MinMs = minMs;
+        s_Data->MaxMs = maxMs;
+        s_Data->ReserveMs = std::max(reserveMs, 0.0);
+        s_Data->CeilingMs = std::min(std::max(s_Data->CeilingMs, minMs), maxMs);
+        s_Data->CurrentStats.CeilingMs = s_Data->CeilingMs;
+    }
+
+    void FrameTaskScheduler::BeginFrame()
+    {
+        if (!s_Data) {
+            return;
+        }
+        FrameTaskSchedulerData& data = *s_Data;
+        uint64_t now = NowNs();
+
+        // Adapt the ceiling to how the frame that just ended turned out: back off quickly when
+        // the tasks may have pushed it over, recover slowly
+        if (data.FrameStartNs != 0) {
+            double frameMs = ToMs(now - data.FrameStartNs);
+            data.CurrentStats.LastFrameMs = frameMs;
+            if (data.RanTasks) {
+                if (frameMs > data.TargetMs * s_OverrunTolerance) {
+                    data.CeilingMs = std::max(data.CeilingMs * 0.5, data.MinMs);
+                    data.CurrentStats.OverrunFrames++;
+                } else {
+                    data.CeilingMs = std::min(data.CeilingMs + s_CeilingGrowthMs, data.MaxMs);
+                }
+            }
+        }
+        data.CurrentStats.CeilingMs = data.CeilingMs;
+        data.FrameStartNs = now;
+        data.RanTasks = false;
+    }
+
+    double FrameTaskScheduler::ComputeBudgetMs(uint64_t now)
+    {
+        FrameTaskSchedulerData& data = *s_Data;
+
+        double elapsedMs = data.FrameStartNs != 0 && now > data.FrameStartNs ? ToMs(now - data.FrameStartNs) : 0.0;
+        double budgetMs = std::min(std::max(data.TargetMs - elapsedMs - data.ReserveMs, data.MinMs), data.CeilingMs);
+
+        // Deadlines: extrapolate the time a task still needs from what it has taken per unit of
+        // progress so far, and make sure each remaining frame grants its share
+        for (const FrameTask& task : data.Tasks) {
+            if (task.DeadlineNs == 0 || task.Done || task.Cancelled) {
+                continue;
+            }
+            double framesLeft = now < task.DeadlineNs ? ToMs(task.DeadlineNs - now) / data.TargetMs : 0.0;
+            double neededMs;
+            if (task.Progress > 0.0f) {
+                neededMs = task.SpentMs * (1.0 - task.Progress) / task.Progress / std::max(framesLeft, 1.0);
+            } else {
+                // No estimate yet: only push once the deadline is close
+                neededMs = framesLeft < 2.0 ? data.MaxMs : 0.0;
+            }
+            budgetMs = std::max(budgetMs, std::min(neededMs * 1.25, data.MaxMs));
+        }
+        return budgetMs;
+    }
+
+    void FrameTaskScheduler::Complete(uint32_t index, uint64_t now)
+    {
+        FrameTask& task = s_Data->Tasks[index];
+        task.Done = true;
+        task.Progress = 1.0f;
+        s_Data->CurrentStats.Completed++;
+        s_Data->CurrentStats.Pending--;
+        if (task.DeadlineNs != 0 && now > task.DeadlineNs && !task.MissedDeadline) {
+            task.MissedDeadline = true;
+            s_Data->CurrentStats.DeadlinesMissed++;
+            printf("Warning: frame task '%s' finished %.1f ms past its deadline\n", task.Name, ToMs(now - task.DeadlineNs));
+        }
+    }
+
+    static void MergeIncoming(std::vector<FrameTask>& tasks, std::vector<FrameTask>& incoming)
+    {
+        tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [](const FrameTask& task) {
+            return task.Done || task.Cancelled;
+        }), tasks.end());
+        for (FrameTask& task : incoming) {
+            if (!task.Cancelled) {
+                tasks.push_back(std::move(task));
+            }
+        }
+        incoming.clear();
+    }
+
+    void FrameTaskScheduler::Execute()
+    {
+        if (!s_Data || s_Data->Running) {
+            return;
+        }
+        FrameTaskSchedulerData& data = *s_Data;
+        Stats& stats = data.CurrentStats;
+        data.Frame++;
+        stats.Steps = 0;
+        stats.BudgetMs = 0.0;
+        stats.UsedMs = 0.0;
+        stats.LongestStepMs = 0.0;
+
+        MergeIncoming(data.Tasks, data.Incoming);
+        if (data.Tasks.empty()) {
+            return;
+        }
+
+        uint64_t now = NowNs();
+        stats.BudgetMs = ComputeBudgetMs(now);
+        const uint64_t sliceEnd = now + (uint64_t)(stats.BudgetMs * 1000000.0);
+
+        data.Order.resize(data.Tasks.size());
+        for (uint32_t i = 0; i < data.Order.size(); i++) {
+            data.Order[i] = i;
+        }
+        std::sort(data.Order.begin(), data.Order.end(), [&data](uint32_t a, uint32_t b) {
+            const FrameTask& left = data.Tasks[a];
+            const FrameTask& right = data.Tasks[b];
+            if (left.Priority != right.Priority) {
+                return left.Priority > right.Priority;
+            }
+            uint64_t leftDeadline = left.DeadlineNs ? left.DeadlineNs : ~0ull;
+            uint64_t rightDeadline = right.DeadlineNs ? right.DeadlineNs : ~0ull;
+            if (leftDeadline != rightDeadline) {
+                return leftDeadline < rightDeadline;
+            }
+            if (left.LastRunFrame != right.LastRunFrame) {
+                return left.LastRunFrame < right.LastRunFrame;
+            }
+            return left.Id < right.Id;
+        });
+
+        data.Running = true;
+        FrameTaskContext context;
+        context.m_SliceEndNs = sliceEnd;
+        for (uint32_t index : data.Order) {
+            FrameTask& task = data.Tasks[index];
+            while (!task.Done && !task.Cancelled) {
+                now = NowNs();
+                double remainingMs = now < sliceEnd ? ToMs(sliceEnd - now) : 0.0;
+                // The first step of the frame always runs, so a slice shorter than any step still makes progress
+                if (stats.Steps > 0 && (remainingMs <= 0.0 || (task.Steps > 0 && task.AverageStepMs > remainingMs))) {
+                    break;
+                }
+
+                context.m_Progress = &task.Progress;
+                bool done = task.Step(context);
+                uint64_t end = NowNs();
+
+                double stepMs = ToMs(end - now);
+                task.AverageStepMs = task.Steps == 0 ? stepMs : task.AverageStepMs + (stepMs - task.AverageStepMs) * s_StepAverageWeight;
+                task.SpentMs += stepMs;
+                task.Steps++;
+                task.LastRunFrame = data.Frame;
+                stats.Steps++;
+                stats.UsedMs += stepMs;
+                stats.LongestStepMs = std::max(stats.LongestStepMs, stepMs);
+                if (done && !task.Cancelled) {
+                    Complete(index, end);
+                }
+            }
+            if (NowNs() >= sliceEnd) {
+                break;
+            }
+        }
+        data.Running = false;
+        data.RanTasks = stats.Steps > 0;
+
+        // Report deadlines that passed while the task was still waiting for time
+        now = NowNs();
+        for (FrameTask& task : data.Tasks) {
+            if (task.DeadlineNs != 0 && now > task.DeadlineNs && !task.Done && !task.Cancelled && !task.MissedDeadline) {
+                task.MissedDeadline = true;
+                stats.DeadlinesMissed++;
+                printf("Warning: frame task '%s' missed its deadline at %.0f%%\n", task.Name, task.Progress * 100.0f);
+            }
+        }
+    }
+
+    void FrameTaskScheduler::Flush()
+    {
+        if (!s_Data) {
+            return;
+        }
+        FrameTaskSchedulerData& data = *s_Data;
+        if (data.Running) {
+            printf("Error: FrameTaskScheduler::Flush called from a task step\n");
+            return;
+        }
+
+        data.Running = true;
+        FrameTaskContext context;
+        context.m_SliceEndNs = ~0ull;
+        // Steps may keep submitting; loop until nothing is left
+        for (MergeIncoming(data.Tasks, data.Incoming); !data.Tasks.empty(); MergeIncoming(data.Tasks, data.Incoming)) {
+            for (uint32_t i = 0; i < data.Tasks.size(); i++) {
+                FrameTask& task = data.Tasks[i];
+                context.m_Progress = &task.Progress;
+                while (!task.Done && !task.Cancelled) {
+                    uint64_t start = NowNs();
+                    bool done = task.Step(context);
+                    task.SpentMs += ToMs(NowNs() - start);
+                    task.Steps++;
+                    if (done && !task.Cancelled) {
+                        Complete(i, NowNs());
+                    }
+                }
+            }
+        }
+        data.Running = false;
+    }
+
+    const FrameTaskScheduler::Stats& FrameTaskScheduler::GetStats()
+    {
+        static const Stats empty;
+        return s_Data ? s_Data->CurrentStats : empty;
+    }
+
+    void FrameTaskScheduler::PrintStats()
+    {
+        if (!s_Data) {
+            return;
+        }
+        static const char* s_PriorityNames[] = { "low", "normal", "high" };
+        const FrameTaskSchedulerData& data = *s_Data;
+        const Stats& stats = data.CurrentStats;
+
+        printf("FrameTaskScheduler: %u pending, %llu completed, %llu deadlines missed, %llu overrun frames\n", stats.Pending,
+               (unsigned long long)stats.Completed, (unsigned long long)stats.DeadlinesMissed, (unsigned long long)stats.OverrunFrames);
+        printf("  budget %.3f ms (used %.3f in %u steps, longest %.3f), ceiling %.2f ms, target %.2f ms, last frame %.2f ms\n",
+               stats.BudgetMs, stats.UsedMs, stats.Steps, stats.LongestStepMs, stats.CeilingMs, data.TargetMs, stats.LastFrameMs);
+
+        uint64_t now = NowNs();
+        for (const std::vector<FrameTask>* list : { &data.Tasks, &data.Incoming }) {
+            for (const FrameTask& task : *list) {
+                if (task.Done || task.Cancelled) {
+                    continue;
+                }
+                printf("  %-24s %-6s %5.1f%%  %u steps, %.3f ms (avg step %.3f)", task.Name, s_PriorityNames[(size_t)task.Priority],
+                       task.Progress * 100.0f, task.Steps, task.SpentMs, task.AverageStepMs);
+                if (task.DeadlineNs != 0) {
+                    double left = now < task.DeadlineNs ? ToMs(task.DeadlineNs - now) : -ToMs(now - task.DeadlineNs);
+                    printf("  deadline in %.0f ms", left);
+                }
+                printf("\n");
+            }
+        }
+    }
+
+}
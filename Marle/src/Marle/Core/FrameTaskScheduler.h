@@ -0,0 +1,107 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace Marle {
+
+    typedef uint32_t FrameTaskId;
+
+    enum class FrameTaskPriority : uint8_t {
+        Low = 0,        // Housekeeping: cache trims, garbage collection
+        Normal,
+        High            // Work the player is waiting on
+    };
+
+    // Handed to every step. Long steps can loop on ShouldYield() themselves; short ones just
+    // return and the scheduler calls them again while the slice lasts.
+    class FrameTaskContext {
+    public:
+        // True once this frame's slice is used up
+        bool ShouldYield() const;
+        double GetRemainingMs() const;
+        // Fraction done, 0..1. Optional, but it is what deadline tracking estimates the rest from.
+        void SetProgress(float progress);
+
+    private:
+        friend class FrameTaskScheduler;
+        uint64_t m_SliceEndNs = 0;
+        float* m_Progress = nullptr;
+    };
+
+    // Spreads one-off expensive work (building navigation data, rebuilding caches, collecting
+    // unused resources) over many frames instead of letting it land on one.
+    //
+    // A task is a resumable step function: it does a bounded piece of work, keeps its own cursor
+    // in its captures, and returns true once finished. Application::Run calls Execute() after
+    // OnRender and the render graph, before the buffer swap, with whatever is left of the frame:
+    //
+    //   budget = clamp(target frame time - time spent this frame - reserve, min, ceiling)
+    //
+    // The ceiling adapts to what the frames actually cost: it halves after a frame that ran tasks
+    // and still overran the target, and creeps back up by a quarter millisecond per frame that
+    // did not. A task falling behind its deadline (judged from the time it has taken so far and
+    // its reported progress) raises the slice to the share it needs per frame, up to the maximum.
+    //
+    // Tasks run highest priority first, then earliest deadline, then least recently run, so equal
+    // tasks take turns leading the slice. A step whose average cost does not fit what is left is
+    // deferred to the next frame, except that every frame runs at least one step.
+    //
+    // Main thread only. Tasks may Submit or Cancel tasks, themselves included, from a step.
+    class FrameTaskScheduler {
+    public:
+        static constexpr FrameTaskId InvalidTask = 0;
+
+        typedef std::function<bool(FrameTaskContext& context)> StepFunc;
+
+        static void Init(double targetFrameMs = 1000.0 / 60.0);
+        // Unfinished tasks are dropped (and reported); Flush() first to complete them
+        static void Shutdown();
+        static bool IsInitialized();
+
+        // Names must outlive the task (string literals). deadlineSeconds is from now; 0 = none.
+        static FrameTaskId Submit(const char* name, StepFunc step, FrameTaskPriority priority = FrameTaskPriority::Normal,
+                                  double deadlineSeconds = 0.0);
+        static void Cancel(FrameTaskId task);
+        static bool IsPending(FrameTaskId task);
+        // Last progress the task reported; 1 once it is no longer pending
+        static float GetProgress(FrameTaskId task);
+
+        // Frame time the budget is carved from, e.g. the display's refresh interval
+        static void SetTargetFrameMs(double targetMs);
+        // Bounds for the slice, and what is kept back for the swap and the OS
+        static void SetBudgetLimits(double minMs, double maxMs, double reserveMs = 1.0);
+
+        // Called by Application::Run: BeginFrame at the top of the frame, Execute before the swap
+        static void BeginFrame();
+        static void Execute();
+        // Runs every task to completion, ignoring the budget (loading screens, shutdown)
+        static void Flush();
+
+        struct Stats {
+            uint32_t Pending = 0;
+            uint64_t Completed = 0;
+            uint64_t DeadlinesMissed = 0;   // Tasks still unfinished when their deadline passed
+            uint32_t Steps = 0;             // Last frame
+            double BudgetMs = 0.0;          // Slice granted last frame
+            double UsedMs = 0.0;            // Of which spent in steps
+            double CeilingMs = 0.0;         // Current adaptive upper bound for the slice
+            double LongestStepMs = 0.0;     // Last frame
+            double LastFrameMs = 0.0;       // BeginFrame to BeginFrame
+            uint64_t OverrunFrames = 0;     // Frames over the target that had run tasks
+        };
+        static const Stats& GetStats();
+        // Budget state and every pending task
+        static void PrintStats();
+
+    private:
+        static double ComputeBudgetMs(uint64_t now);
+        static void Complete(uint32_t index, uint64_t now);
+
+        struct FrameTaskSchedulerData;
+        static std::unique_ptr<FrameTaskSchedulerData> s_Data;
+    };
+
+}
@@ -0,0 +1,238 @@
+#include "mrlpch.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Marle {
+
+    // Claimed by whichever of a worker and the handle's Wait() gets to it first
+    struct BackgroundJob {
+        std::function<void()> Function;
+        std::shared_ptr<std::atomic<uint32_t>> Pending;
+        std::atomic<bool> Claimed{ false };
+
+        bool TryRun()
+        {
+            if (Claimed.exchange(true, std::memory_order_acq_rel)) {
+                return false;
+            }
+            Function();
+            Function = nullptr;
+            Pending->fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+    };
+
+    struct JobSystem::JobSystemData {
+        std::vector<std::thread> Workers;
+        std::deque<std::function<void()>> Queue;
+        std::deque<std::shared_ptr<BackgroundJob>> BackgroundQueue;  // Entries claimed by Wait() stay until a worker pops them
+        std::mutex QueueMutex;
+        std::condition_variable QueueCondition;
+        bool Stopping = false;
+    };
+
+    std::unique_ptr<JobSystem::JobSystemData> JobSystem::s_Data = nullptr;
+
+    void JobHandle::Wait() const
+    {
+        if (!m_Pending) {
+            return;
+        }
+        if (m_Background) {
+            m_Background->TryRun();
+        }
+        while (m_Pending->load(std::memory_order_acquire) != 0) {
+            if (!JobSystem::RunPendingJob()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void JobSystem::Init(uint32_t workerCount)
+    {
+        if (s_Data) {
+            return;
+        }
+
+        if (workerCount == 0) {
+            uint32_t hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        s_Data = std::make_unique<JobSystemData>();
+        s_Data->Workers.reserve(workerCount);
+        for (uint32_t i = 0; i < workerCount; i++) {
+            s_Data->Workers.emplace_back([]() {
+                JobSystemData& data = *s_Data;
+                for (;;) {
+                    std::function<void()> job;
+                    std::shared_ptr<BackgroundJob> background;
+                    {
+                        std::unique_lock<std::mutex> lock(data.QueueMutex);
+                        data.QueueCondition.wait(lock, [&data]() {
+                            return data.Stopping || !data.Queue.empty() || !data.BackgroundQueue.empty();
+                        });
+                        if (!data.Queue.empty()) {
+                            job = std::move(data.Queue.front());
+                            data.Queue.pop_front();
+                        } else if (!data.BackgroundQueue.empty()) {
+                            background = std::move(data.BackgroundQueue.front());
+                            data.BackgroundQueue.pop_front();
+                        } else {
+                            return;
+                        }
+                    }
+                    if (job) {
+                        job();
+                    } else {
+                        background->TryRun();
+                    }
+                }
+            });
+        }
+
+        printf("JobSystem initialized with %u worker threads\n", workerCount);
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(s_Data->QueueMutex);
+            s_Data->Stopping = true;
+        }
+        s_Data->QueueCondition.notify_all();
+        for (std::thread& worker : s_Data->Workers) {
+            worker.join();
+        }
+        s_Data.reset();
+        printf("JobSystem shutdown complete\n");
+    }
+
+    bool JobSystem::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    uint32_t JobSystem::GetWorkerCount()
+    {
+        return s_Data ? (uint32_t)s_Data->Workers.size() : 0;
+    }
+
+    JobHandle JobSystem::Submit(std::function<void()> job)
+    {
+        JobHandle handle;
+        handle.m_Pending = std::make_shared<std::atomic<uint32_t>>(1);
+
+        if (!s_Data) {
+            job();
+            handle.m_Pending->store(0, std::memory_order_release);
+            return handle;
+        }
+
+        auto pending = handle.m_Pending;
+        {
+            std::lock_guard<std::mutex> lock(s_Data->QueueMutex);
+            s_Data->Queue.emplace_back([job = std::move(job), pending]() {
+                job();
+                pending->fetch_sub(1, std::memory_order_acq_rel);
+            });
+        }
+        s_Data->QueueCondition.notify_one();
+        return handle;
+    }
+
+    JobHandle JobSystem::SubmitBackground(std::function<void()> job)
+    {
+        JobHandle handle;
+        handle.m_Pending = std::make_shared<std::atomic<uint32_t>>(1);
+
+        if (!s_Data) {
+            job();
+            handle.m_Pending->store(0, std::memory_order_release);
+            return handle;
+        }
+
+        handle.m_Background = std::make_shared<BackgroundJob>();
+        handle.m_Background->Function = std::move(job);
+        handle.m_Background->Pending = handle.m_Pending;
+        {
+            std::lock_guard<std::mutex> lock(s_Data->QueueMutex);
+            s_Data->BackgroundQueue.push_back(handle.m_Background);
+        }
+        s_Data->QueueCondition.notify_one();
+        return handle;
+    }
+
+    bool JobSystem::RunPendingJob()
+    {
+        if (!s_Data) {
+            return false;
+        }
+
+        std::function<void()> job;
+        {
+            std::lock_guard<std::mutex> lock(s_Data->QueueMutex);
+            if (s_Data->Queue.empty()) {
+                return false;
+            }
+            job = std::move(s_Data->Queue.front());
+            s_Data->Queue.pop_front();
+        }
+        job();
+        return true;
+    }
+
+    void JobSystem::ParallelFor(uint32_t count, uint32_t minChunk, const std::function<void(uint32_t, uint32_t)>& fn)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        minChunk = std::max<uint32_t>(minChunk, 1);
+        uint32_t threads = GetWorkerCount() + 1;
+        uint32_t chunkCount = std::min(threads, (count + minChunk - 1) / minChunk);
+        if (chunkCount <= 1) {
+            fn(0, count);
+            return;
+        }
+
+        uint32_t chunkSize = (count + chunkCount - 1) / chunkCount;
+        auto pending = std::make_shared<std::atomic<uint32_t>>(chunkCount - 1);
+        {
+            std::lock_guard<std::mutex> lock(s_Data->QueueMutex);
+            for (uint32_t chunk = 1; chunk < chunkCount; chunk++) {
+                uint32_t begin = chunk * chunkSize;
+                uint32_t end = std::min(count, begin + chunkSize);
+                if (begin >= end) {
+                    pending->fetch_sub(1, std::memory_order_relaxed);
+                    continue;
+                }
+                // fn outlives the jobs because this call does not return until pending reaches zero
+                s_Data->Queue.emplace_back([&fn, begin, end, pending]() {
+                    fn(begin, end);
+                    pending->fetch_sub(1, std::memory_order_acq_rel);
+                });
+            }
+        }
+        s_Data->QueueCondition.notify_all();
+
+        fn(0, std::min(count, chunkSize));
+
+        while (pending->load(std::memory_order_acquire) != 0) {
+            if (!RunPendingJob()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+}
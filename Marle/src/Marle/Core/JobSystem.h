@@ -0,0 +1,62 @@
+#pragma once
+
+#include "../Core.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace Marle {
+
+    struct BackgroundJob;
+
+    // Tracks a group of submitted jobs; Wait() helps run queued work instead of blocking idle.
+    class JobHandle {
+    public:
+        JobHandle() = default;
+
+        bool IsValid() const { return m_Pending != nullptr; }
+        bool IsDone() const { return !m_Pending || m_Pending->load(std::memory_order_acquire) == 0; }
+        // Helps with frame jobs while waiting. A background job no worker has started yet is run
+        // here, but never anyone else's.
+        void Wait() const;
+
+    private:
+        friend class JobSystem;
+        std::shared_ptr<std::atomic<uint32_t>> m_Pending;
+        std::shared_ptr<BackgroundJob> m_Background;
+    };
+
+    // Fixed pool of worker threads shared by every engine subsystem.
+    // Everything degrades to running inline on the calling thread when the pool is not initialized.
+    //
+    // There are two queues. Frame jobs (Submit, ParallelFor) are short and are what waiting
+    // threads help with. Background jobs (SubmitBackground) are long or block: file reads,
+    // decoding, deserialization. Workers take them only when no frame job is queued, and
+    // RunPendingJob never does, so a frame-critical wait cannot end up doing someone's I/O.
+    class JobSystem {
+    public:
+        static void Init(uint32_t workerCount = 0); // 0 = hardware threads - 1 (the main thread helps)
+        static void Shutdown();
+
+        static bool IsInitialized();
+        static uint32_t GetWorkerCount();
+
+        // Fire-and-forget frame job
+        static JobHandle Submit(std::function<void()> job);
+        // Long or blocking work, kept off every thread that waits for frame jobs
+        static JobHandle SubmitBackground(std::function<void()> job);
+
+        // Runs fn(begin, end) over [0, count) split into chunks of at least minChunk items,
+        // on the workers and the calling thread. Returns once every chunk has finished.
+        static void ParallelFor(uint32_t count, uint32_t minChunk, const std::function<void(uint32_t, uint32_t)>& fn);
+
+        // Runs one queued frame job on the calling thread, if any. Returns false when there was none.
+        static bool RunPendingJob();
+
+    private:
+        struct JobSystemData;
+        static std::unique_ptr<JobSystemData> s_Data;
+    };
+
+}
@@ -0,0 +1,415 @@
+#include "mrlpch.h"
+#include "MemoryTracker.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+
+namespace Marle {
+
+    static const size_t s_TagCount = (size_t)MemoryTag::Count;
+    // One history sample per this many frames (about a second at 60 Hz); the ring covers ~17 minutes
+    static const uint64_t s_HistoryInterval = 60;
+    static const size_t s_HistoryCapacity = 1024;
+    static const size_t s_DumpMaxGroups = 64;
+
+    // In front of every tracked block; 16 bytes keeps the user pointer malloc-aligned
+    struct alignas(16) AllocationHeader {
+        uint64_t Size;
+        uint8_t Tag;
+        uint8_t Flags;
+    };
+    static_assert(sizeof(AllocationHeader) == 16, "AllocationHeader must preserve malloc alignment");
+
+    enum AllocationFlags : uint8_t {
+        AllocationCounted = BIT(0),
+        AllocationRecorded = BIT(1)
+    };
+
+    // Plain statics rather than s_Data so allocations before Init and after Shutdown still balance
+    struct TagCounters {
+        std::atomic<int64_t> Current{ 0 };   // Signed: batched frees can publish before the matching allocations
+        std::atomic<int64_t> Peak{ 0 };
+        std::atomic<uint64_t> Live{ 0 };
+        std::atomic<uint64_t> Total{ 0 };
+        std::atomic<uint64_t> FrameAllocations{ 0 };
+        std::atomic<size_t> FrameBytes{ 0 };
+        std::atomic<uint64_t> LastFrameAllocations{ 0 };
+        std::atomic<size_t> LastFrameBytes{ 0 };
+        std::atomic<int64_t> Gpu{ 0 };
+        std::atomic<int64_t> GpuPeak{ 0 };
+    };
+    static TagCounters s_Counters[s_TagCount];
+    static std::atomic<MemoryTrackingMode> s_Mode{ MemoryTrackingMode::Off };
+    static std::atomic<uint32_t> s_SampleRate{ 64 };
+    static std::atomic<uint64_t> s_Frame{ 0 };
+
+    template<typename T>
+    static void UpdatePeak(std::atomic<T>& peak, T value)
+    {
+        T previous = peak.load(std::memory_order_relaxed);
+        while (value > previous && !peak.compare_exchange_weak(previous, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    // Outside Full mode each thread batches its counter updates and publishes them every few
+    // hundred operations (or when it holds a lot of bytes), which keeps the hot path off shared
+    // cache lines. Totals lag by at most one batch per thread; the peak is taken at publish time.
+    static const uint32_t s_FlushOperations = 256;
+    static const int64_t s_FlushBytes = 256 * 1024;
+
+    struct PendingCounters {
+        int64_t Bytes[s_TagCount] = {};
+        int64_t Live[s_TagCount] = {};
+        uint64_t Total[s_TagCount] = {};
+        uint64_t FrameBytes[s_TagCount] = {};
+        uint32_t Operations = 0;
+
+        void Flush()
+        {
+            for (size_t i = 0; i < s_TagCount; i++) {
+                TagCounters& counters = s_Counters[i];
+                if (Bytes[i] != 0) {
+                    int64_t current = counters.Current.fetch_add(Bytes[i], std::memory_order_relaxed) + Bytes[i];
+                    UpdatePeak(counters.Peak, current);
+                }
+                if (Live[i] != 0) {
+                    counters.Live.fetch_add((uint64_t)Live[i], std::memory_order_relaxed);
+                }
+                if (Total[i] != 0) {
+                    counters.Total.fetch_add(Total[i], std::memory_order_relaxed);
+                    counters.FrameAllocations.fetch_add(Total[i], std::memory_order_relaxed);
+                    counters.FrameBytes.fetch_add(FrameBytes[i], std::memory_order_relaxed);
+                }
+                Bytes[i] = Live[i] = 0;
+                Total[i] = FrameBytes[i] = 0;
+            }
+            Operations = 0;
+        }
+
+        void Add(size_t tag, int64_t bytes, int64_t live)
+        {
+            Bytes[tag] += bytes;
+            Live[tag] += live;
+            if (live > 0) {
+                Total[tag]++;
+                FrameBytes[tag] += (uint64_t)bytes;
+            }
+            if (++Operations >= s_FlushOperations || Bytes[tag] >= s_FlushBytes || Bytes[tag] <= -s_FlushBytes) {
+                Flush();
+            }
+        }
+
+        ~PendingCounters() { Flush(); }
+    };
+
+    static PendingCounters& GetPendingCounters()
+    {
+        thread_local PendingCounters pending;
+        return pending;
+    }
+
+    struct AllocationRecord {
+        size_t Size;
+        MemoryTag Tag;
+        uint64_t Frame;
+    };
+
+    struct HistorySample {
+        uint64_t Frame = 0;
+        size_t Heap[s_TagCount] = {};
+        int64_t Gpu[s_TagCount] = {};
+    };
+
+    struct MemoryTracker::MemoryTrackerData {
+        std::mutex Mutex;
+        std::unordered_map<const void*, AllocationRecord> Records;
+        std::vector<HistorySample> History;
+        size_t HistoryNext = 0;
+    };
+
+    std::unique_ptr<MemoryTracker::MemoryTrackerData> MemoryTracker::s_Data = nullptr;
+
+    static bool ShouldRecord(MemoryTrackingMode mode)
+    {
+        if (mode == MemoryTrackingMode::Full) {
+            return true;
+        }
+        // Per-thread countdown, so sampling costs no shared cache line
+        thread_local uint32_t countdown = 0;
+        if (countdown == 0) {
+            countdown = s_SampleRate.load(std::memory_order_relaxed);
+            return true;
+        }
+        countdown--;
+        return false;
+    }
+
+    void MemoryTracker::Init(MemoryTrackingMode mode, uint32_t sampleRate)
+    {
+        s_Data = std::make_unique<MemoryTrackerData>();
+        s_Data->History.resize(s_HistoryCapacity);
+        s_SampleRate.store(std::max(sampleRate, 1u), std::memory_order_relaxed);
+        s_Mode.store(mode, std::memory_order_relaxed);
+
+        static const char* modeNames[] = { "off", "sampled", "full" };
+        printf("MemoryTracker initialized (%s tracking)\n", modeNames[(size_t)mode]);
+    }
+
+    void MemoryTracker::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+        s_Mode.store(MemoryTrackingMode::Off, std::memory_order_relaxed);
+        {
+            // Blocks recorded so far are freed later without a registry lookup
+            std::lock_guard<std::mutex> lock(s_Data->Mutex);
+            s_Data->Records.clear();
+        }
+        s_Data.reset();
+    }
+
+    bool MemoryTracker::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    void MemoryTracker::SetMode(MemoryTrackingMode mode)
+    {
+        GetPendingCounters().Flush();
+        if (s_Data) {
+            s_Mode.store(mode, std::memory_order_relaxed);
+        }
+    }
+
+    MemoryTrackingMode MemoryTracker::GetMode()
+    {
+        return s_Mode.load(std::memory_order_relaxed);
+    }
+
+    void* MemoryTracker::Allocate(size_t size, MemoryTag tag)
+    {
+        AllocationHeader* header = static_cast<AllocationHeader*>(std::malloc(sizeof(AllocationHeader) + size));
+        if (!header) {
+            return nullptr;
+        }
+        header->Size = size;
+        header->Tag = (uint8_t)tag;
+        header->Flags = 0;
+        void* ptr = header + 1;
+
+        MemoryTrackingMode mode = s_Mode.load(std::memory_order_relaxed);
+        if (mode == MemoryTrackingMode::Off) {
+            return ptr;
+        }
+
+        header->Flags |= AllocationCounted;
+        if (mode == MemoryTrackingMode::Full) {
+            TagCounters& counters = s_Counters[(size_t)tag];
+            int64_t current = counters.Current.fetch_add((int64_t)size, std::memory_order_relaxed) + (int64_t)size;
+            UpdatePeak(counters.Peak, current);
+            counters.Live.fetch_add(1, std::memory_order_relaxed);
+            counters.Total.fetch_add(1, std::memory_order_relaxed);
+            counters.FrameAllocations.fetch_add(1, std::memory_order_relaxed);
+            counters.FrameBytes.fetch_add(size, std::memory_order_relaxed);
+        } else {
+            GetPendingCounters().Add((size_t)tag, (int64_t)size, 1);
+        }
+
+        if (ShouldRecord(mode)) {
+            MemoryTrackerData* data = s_Data.get();
+            if (data) {
+                std::lock_guard<std::mutex> lock(data->Mutex);
+                data->Records[ptr] = AllocationRecord{ size, tag, s_Frame.load(std::memory_order_relaxed) };
+                header->Flags |= AllocationRecorded;
+            }
+        }
+        return ptr;
+    }
+
+    void* MemoryTracker::Reallocate(void* ptr, size_t size, MemoryTag tag)
+    {
+        if (!ptr) {
+            return Allocate(size, tag);
+        }
+        void* resized = Allocate(size, tag);
+        if (resized) {
+            const AllocationHeader* header = static_cast<const AllocationHeader*>(ptr) - 1;
+            std::memcpy(resized, ptr, std::min((size_t)header->Size, size));
+            Free(ptr);
+        }
+        return resized;
+    }
+
+    void MemoryTracker::Free(void* ptr)
+    {
+        if (!ptr) {
+            return;
+        }
+        AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+
+        if (header->Flags & AllocationCounted) {
+            if (s_Mode.load(std::memory_order_relaxed) == MemoryTrackingMode::Full) {
+                TagCounters& counters = s_Counters[header->Tag];
+                counters.Current.fetch_sub((int64_t)header->Size, std::memory_order_relaxed);
+                counters.Live.fetch_sub(1, std::memory_order_relaxed);
+            } else {
+                GetPendingCounters().Add(header->Tag, -(int64_t)header->Size, -1);
+            }
+        }
+        if (header->Flags & AllocationRecorded) {
+            MemoryTrackerData* data = s_Data.get();
+            if (data) {
+                std::lock_guard<std::mutex> lock(data->Mutex);
+                data->Records.erase(ptr);
+            }
+        }
+        std::free(header);
+    }
+
+    void MemoryTracker::TrackGpu(MemoryTag tag, int64_t bytes)
+    {
+        TagCounters& counters = s_Counters[(size_t)tag];
+        int64_t current = counters.Gpu.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+        UpdatePeak(counters.GpuPeak, current);
+    }
+
+    void MemoryTracker::NewFrame()
+    {
+        GetPendingCounters().Flush();
+        uint64_t frame = s_Frame.fetch_add(1, std::memory_order_relaxed) + 1;
+        for (TagCounters& counters : s_Counters) {
+            counters.LastFrameAllocations.store(counters.FrameAllocations.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+            counters.LastFrameBytes.store(counters.FrameBytes.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+
+        if (s_Data && frame % s_HistoryInterval == 0) {
+            HistorySample sample;
+            sample.Frame = frame;
+            for (size_t i = 0; i < s_TagCount; i++) {
+                sample.Heap[i] = (size_t)std::max<int64_t>(s_Counters[i].Current.load(std::memory_order_relaxed), 0);
+                sample.Gpu[i] = s_Counters[i].Gpu.load(std::memory_order_relaxed);
+            }
+            std::lock_guard<std::mutex> lock(s_Data->Mutex);
+            s_Data->History[s_Data->HistoryNext % s_HistoryCapacity] = sample;
+            s_Data->HistoryNext++;
+        }
+    }
+
+    uint64_t MemoryTracker::GetFrameIndex()
+    {
+        return s_Frame.load(std::memory_order_relaxed);
+    }
+
+    MemoryTracker::TagStats MemoryTracker::GetStats(MemoryTag tag)
+    {
+        GetPendingCounters().Flush();
+        const TagCounters& counters = s_Counters[(size_t)tag];
+        TagStats stats;
+        stats.CurrentBytes = (size_t)std::max<int64_t>(counters.Current.load(std::memory_order_relaxed), 0);
+        stats.PeakBytes = (size_t)counters.Peak.load(std::memory_order_relaxed);
+        stats.LiveAllocations = counters.Live.load(std::memory_order_relaxed);
+        stats.TotalAllocations = counters.Total.load(std::memory_order_relaxed);
+        stats.FrameAllocations = counters.LastFrameAllocations.load(std::memory_order_relaxed);
+        stats.FrameBytes = counters.LastFrameBytes.load(std::memory_order_relaxed);
+        stats.GpuBytes = (size_t)std::max<int64_t>(counters.Gpu.load(std::memory_order_relaxed), 0);
+        stats.GpuPeakBytes = (size_t)std::max<int64_t>(counters.GpuPeak.load(std::memory_order_relaxed), 0);
+        return stats;
+    }
+
+    const char* MemoryTracker::GetTagName(MemoryTag tag)
+    {
+        static const char* names[] = { "Renderer", "Assets", "Events", "Game", "Audio", "Animation", "Navigation", "Network", "World" };
+        return tag < MemoryTag::Count ? names[(size_t)tag] : "Unknown";
+    }
+
+    bool MemoryTracker::DumpToFile(const std::string& path)
+    {
+        FILE* file = fopen(path.c_str(), "w");
+        if (!file) {
+            printf("Error: could not open %s for the memory dump\n", path.c_str());
+            return false;
+        }
+
+        MemoryTrackingMode mode = GetMode();
+        uint64_t frame = GetFrameIndex();
+        static const char* modeNames[] = { "off", "sampled", "full" };
+        fprintf(file, "Marle memory dump, frame %llu, %s tracking", (unsigned long long)frame, modeNames[(size_t)mode]);
+        if (mode == MemoryTrackingMode::Sampled) {
+            fprintf(file, " (1 in %u allocations recorded)", s_SampleRate.load(std::memory_order_relaxed));
+        }
+        fprintf(file, "\n\n");
+
+        fprintf(file, "%-10s %14s %14s %10s %12s %12s %14s %14s %14s\n", "Tag", "Heap", "Heap peak", "Live", "Allocs",
+                "Frame allocs", "Frame bytes", "GPU", "GPU peak");
+        for (size_t i = 0; i < s_TagCount; i++) {
+            TagStats stats = GetStats((MemoryTag)i);
+            fprintf(file, "%-10s %14zu %14zu %10llu %12llu %12llu %14zu %14zu %14zu\n", GetTagName((MemoryTag)i),
+                    stats.CurrentBytes, stats.PeakBytes, (unsigned long long)stats.LiveAllocations,
+                    (unsigned long long)stats.TotalAllocations, (unsigned long long)stats.FrameAllocations,
+                    stats.FrameBytes, stats.GpuBytes, stats.GpuPeakBytes);
+        }
+
+        if (s_Data) {
+            std::vector<HistorySample> history;
+            struct Group { uint64_t Count = 0; uint64_t OldestFrame = ~0ull; };
+            std::map<std::pair<uint8_t, size_t>, Group> groups;
+            {
+                std::lock_guard<std::mutex> lock(s_Data->Mutex);
+                size_t count = std::min(s_Data->HistoryNext, s_HistoryCapacity);
+                for (size_t i = s_Data->HistoryNext - count; i < s_Data->HistoryNext; i++) {
+                    history.push_back(s_Data->History[i % s_HistoryCapacity]);
+                }
+                for (const auto& entry : s_Data->Records) {
+                    Group& group = groups[{ (uint8_t)entry.second.Tag, entry.second.Size }];
+                    group.Count++;
+                    group.OldestFrame = std::min(group.OldestFrame, entry.second.Frame);
+                }
+            }
+
+            // Heap that only ever climbs across samples is the first thing to look at for leaks
+            fprintf(file, "\nGrowth (bytes, one sample per %llu frames)\n%10s", (unsigned long long)s_HistoryInterval, "Frame");
+            for (size_t i = 0; i < s_TagCount; i++) {
+                fprintf(file, " %14s %14s", GetTagName((MemoryTag)i), "GPU");
+            }
+            fprintf(file, "\n");
+            for (const HistorySample& sample : history) {
+                fprintf(file, "%10llu", (unsigned long long)sample.Frame);
+                for (size_t i = 0; i < s_TagCount; i++) {
+                    fprintf(file, " %14zu %14lld", sample.Heap[i], (long long)sample.Gpu[i]);
+                }
+                fprintf(file, "\n");
+            }
+
+            // Long-lived allocations of one size piling up are the usual leak signature
+            std::vector<std::pair<std::pair<uint8_t, size_t>, Group>> sorted(groups.begin(), groups.end());
+            std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+                if (a.second.OldestFrame != b.second.OldestFrame) {
+                    return a.second.OldestFrame < b.second.OldestFrame;
+                }
+                return a.second.Count * a.first.second > b.second.Count * b.first.second;
+            });
+            fprintf(file, "\nRecorded live allocations by age (tag, size)\n%-10s %12s %10s %14s %14s\n",
+                    "Tag", "Size", "Count", "Bytes", "Oldest frame");
+            for (size_t i = 0; i < sorted.size() && i < s_DumpMaxGroups; i++) {
+                const auto& entry = sorted[i];
+                fprintf(file, "%-10s %12zu %10llu %14llu %14llu\n", GetTagName((MemoryTag)entry.first.first), entry.first.second,
+                        (unsigned long long)entry.second.Count, (unsigned long long)(entry.second.Count * entry.first.second),
+                        (unsigned long long)entry.second.OldestFrame);
+            }
+            if (sorted.size() > s_DumpMaxGroups) {
+                fprintf(file, "... %zu more groups\n", sorted.size() - s_DumpMaxGroups);
+            }
+        }
+
+        fclose(file);
+        printf("Memory dump written to %s\n", path.c_str());
+        return true;
+    }
+
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Marle {
+
+    enum class MemoryTag : uint8_t {
+        Renderer = 0,
+        Assets,
+        Events,
+        Game,
+        Audio,
+        Animation,
+        Navigation,
+        Network,
+        World,
+        Count
+    };
+
+    enum class MemoryTrackingMode : uint8_t {
+        Off = 0,    // Pass-through; allocations made now are never counted
+        Sampled,    // Exact byte counters, 1 in SampleRate allocations recorded for the dump
+        Full        // Every live allocation recorded (default in debug builds)
+    };
+
+    // Heap and GPU memory accounting per engine subsystem.
+    //
+    // Heap memory is counted when it goes through the engine allocators below (Allocate/Free,
+    // TaggedAllocator, MakeTagged) — stb decode buffers, particle pools, text and tilemap
+    // vertices. GPU memory is an estimate reported by the code that creates the objects.
+    // Counters are lock-free and always on; the live-allocation record behind DumpToFile is
+    // what the tracking mode controls. Safe to call from any thread.
+    class MemoryTracker {
+    public:
+    #ifdef MRL_DEBUG
+        static const MemoryTrackingMode DefaultMode = MemoryTrackingMode::Full;
+    #else
+        static const MemoryTrackingMode DefaultMode = MemoryTrackingMode::Sampled;
+    #endif
+
+        static void Init(MemoryTrackingMode mode = DefaultMode, uint32_t sampleRate = 64);
+        static void Shutdown();
+        static bool IsInitialized();
+
+        static void SetMode(MemoryTrackingMode mode);
+        static MemoryTrackingMode GetMode();
+
+        // Allocations are aligned like malloc. Free and Reallocate accept nullptr.
+        static void* Allocate(size_t size, MemoryTag tag);
+        static void* Reallocate(void* ptr, size_t size, MemoryTag tag);
+        static void Free(void* ptr);
+
+        // Positive when GPU storage is created, negative when it is released
+        static void TrackGpu(MemoryTag tag, int64_t bytes);
+
+        // Called by Application::Run once per frame; closes the per-frame counters
+        static void NewFrame();
+        static uint64_t GetFrameIndex();
+
+        struct TagStats {
+            size_t CurrentBytes = 0;
+            size_t PeakBytes = 0;
+            uint64_t LiveAllocations = 0;
+            uint64_t TotalAllocations = 0;
+            uint64_t FrameAllocations = 0;  // During the last completed frame
+            size_t FrameBytes = 0;
+            size_t GpuBytes = 0;
+            size_t GpuPeakBytes = 0;
+        };
+        static TagStats GetStats(MemoryTag tag);
+        static const char* GetTagName(MemoryTag tag);
+
+        // Writes the per-tag totals, the growth history and the oldest live allocations
+        static bool DumpToFile(const std::string& path);
+
+    private:
+        struct MemoryTrackerData;
+        static std::unique_ptr<MemoryTrackerData> s_Data;
+    };
+
+    // STL allocator charging a tag, e.g. TaggedVector<float, MemoryTag::Renderer>
+    template<typename T, MemoryTag Tag>
+    struct TaggedAllocator {
+        using value_type = T;
+
+        template<typename U>
+        struct rebind { using other = TaggedAllocator<U, Tag>; };
+
+        TaggedAllocator() = default;
+        template<typename U>
+        TaggedAllocator(const TaggedAllocator<U, Tag>&) {}
+
+        T* allocate(size_t count)
+        {
+            void* memory = MemoryTracker::Allocate(count * sizeof(T), Tag);
+            if (!memory) {
+                throw std::bad_alloc();
+            }
+            return static_cast<T*>(memory);
+        }
+        void deallocate(T* ptr, size_t) { MemoryTracker::Free(ptr); }
+
+        template<typename U>
+        bool operator==(const TaggedAllocator<U, Tag>&) const { return true; }
+        template<typename U>
+        bool operator!=(const TaggedAllocator<U, Tag>&) const { return false; }
+    };
+
+    template<typename T, MemoryTag Tag>
+    using TaggedVector = std::vector<T, TaggedAllocator<T, Tag>>;
+
+    template<typename T>
+    struct TaggedDelete {
+        void operator()(T* ptr) const
+        {
+            if (ptr) {
+                ptr->~T();
+                MemoryTracker::Free(ptr);
+            }
+        }
+    };
+
+    template<typename T>
+    using TaggedPtr = std::unique_ptr<T, TaggedDelete<T>>;
+
+    template<typename T, typename... Args>
+    TaggedPtr<T> MakeTagged(MemoryTag tag, Args&&... args)
+    {
+        void* memory = MemoryTracker::Allocate(sizeof(T), tag);
+        return TaggedPtr<T>(new (memory) T(std::forward<Args>(args)...));
+    }
+
+}
@@ -0,0 +1,680 @@
+#include "mrlpch.h"
+#include "Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <cerrno>
+#endif
+
+namespace Marle {
+
+    static const uint32_t s_SlotsPerThread = 4096;     // Counters take one, histograms their buckets plus the sum
+    static const uint32_t s_MaxPendingClients = 8;
+    static const double s_ReaderTimeoutSeconds = 3.0;
+
+    struct MetricDefinition {
+        MetricType Type = MetricType::Counter;
+        uint32_t FirstSlot = 0;
+        uint32_t BucketCount = 0;
+        double Bounds[MaxMetricBuckets] = {};
+    };
+
+    // Written only by the thread holding it, read by Publish. Blocks outlive their threads and
+    // are handed to the next thread that needs one, so totals never lose what a thread recorded.
+    struct alignas(64) ThreadAccumulator {
+        std::atomic<uint64_t> Slots[s_SlotsPerThread] = {};
+        std::atomic<bool> InUse{ false };
+    };
+
+    struct Metrics::MetricsData {
+        MetricDefinition Definitions[MaxMetrics];
+        MetricSample Samples[MaxMetrics];                 // Names filled at registration, values by Aggregate
+        std::atomic<uint64_t> Gauges[MaxMetrics] = {};    // Bit patterns of doubles
+        std::atomic<uint32_t> Count{ 0 };
+        uint32_t SlotsUsed = 0;
+        uint32_t Generation = 0;
+
+        std::mutex AccumulatorMutex;
+        std::vector<std::unique_ptr<ThreadAccumulator>> Accumulators;
+
+        std::chrono::steady_clock::time_point Start;
+        uint64_t Frame = 0;
+
+        std::string SharedName;
+        MetricsSharedHeader* Shared = nullptr;
+        size_t SharedSize = 0;
+        uint32_t LastPulse = 0;
+        double LastPulseSeconds = -1e9;
+
+        std::string SocketPath;
+        int SocketHandle = -1;
+        std::vector<int> PendingClients;
+        std::string Text;
+
+        uint64_t ReadersFrame = ~0ull;      // Frame HasReaders last answered for
+        bool Readers = false;
+
+        Stats CurrentStats;
+    };
+
+    std::unique_ptr<Metrics::MetricsData> Metrics::s_Data = nullptr;
+
+    // Bumped by every Init and Shutdown so blocks leased under an earlier Init are never touched
+    // again, e.g. by a thread that exits after Shutdown freed them
+    static std::atomic<uint32_t> s_Generation{ 0 };
+
+    struct AccumulatorLease {
+        ThreadAccumulator* Accumulator = nullptr;
+        uint32_t Generation = 0;
+
+        ~AccumulatorLease()
+        {
+            if (Accumulator && Generation == s_Generation.load(std::memory_order_acquire)) {
+                Accumulator->InUse.store(false, std::memory_order_release);
+            }
+        }
+    };
+    static thread_local AccumulatorLease t_Lease;
+
+    static double SecondsSince(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    static void CopyTruncated(char* destination, size_t capacity, const char* source)
+    {
+        size_t length = source ? std::min(strlen(source), capacity - 1) : 0;
+        memcpy(destination, source ? source : "", length);
+        memset(destination + length, 0, capacity - length);
+    }
+
+    static size_t GetSharedSize()
+    {
+        return sizeof(MetricsSharedHeader) + sizeof(MetricSample) * MaxMetrics;
+    }
+
+    void Metrics::Init(const char* shmName)
+    {
+        if (s_Data) {
+            return;
+        }
+        s_Data = std::make_unique<MetricsData>();
+        MetricsData& data = *s_Data;
+        data.Generation = s_Generation.fetch_add(1, std::memory_order_acq_rel) + 1;
+        data.Start = std::chrono::steady_clock::now();
+
+    #if defined(__unix__) || defined(__APPLE__)
+        if (shmName) {
+            data.SharedName = shmName[0] ? std::string(shmName) : MetricsReader::GetDefaultName((uint32_t)getpid());
+            int handle = shm_open(data.SharedName.c_str(), O_CREAT | O_RDWR, 0600);
+            if (handle < 0 || ftruncate(handle, (off_t)GetSharedSize()) != 0) {
+                printf("Warning: Metrics could not create shared memory %s: %s\n", data.SharedName.c_str(), strerror(errno));
+            } else {
+                void* memory = mmap(nullptr, GetSharedSize(), PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+                if (memory == MAP_FAILED) {
+                    printf("Warning: Metrics could not map shared memory %s: %s\n", data.SharedName.c_str(), strerror(errno));
+                    shm_unlink(data.SharedName.c_str());
+                } else {
+                    memset(memory, 0, GetSharedSize());
+                    data.Shared = static_cast<MetricsSharedHeader*>(memory);
+                    data.SharedSize = GetSharedSize();
+                    data.Shared->Version = MetricsSharedHeader::CurrentVersion;
+                    data.Shared->ProcessId = (uint32_t)getpid();
+                    // Magic last: a reader opening the segment meanwhile sees it as not ready yet
+                    std::atomic_thread_fence(std::memory_order_release);
+                    data.Shared->Magic = MetricsSharedHeader::MagicValue;
+                }
+            }
+            if (handle >= 0) {
+                close(handle);
+            }
+        }
+    #else
+        (void)shmName;
+    #endif
+
+        if (data.Shared) {
+            printf("Metrics initialized (shared memory %s)\n", data.SharedName.c_str());
+        } else {
+            printf("Metrics initialized\n");
+        }
+    }
+
+    void Metrics::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+        MetricsData& data = *s_Data;
+    #if defined(__unix__) || defined(__APPLE__)
+        for (int client : data.PendingClients) {
+            close(client);
+        }
+        if (data.SocketHandle >= 0) {
+            close(data.SocketHandle);
+            unlink(data.SocketPath.c_str());
+        }
+        if (data.Shared) {
+            munmap(data.Shared, data.SharedSize);
+            shm_unlink(data.SharedName.c_str());
+        }
+    #endif
+        // Before the blocks are freed, so leases released from now on leave them alone
+        s_Generation.fetch_add(1, std::memory_order_acq_rel);
+        s_Data.reset();
+    }
+
+    bool Metrics::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    bool Metrics::ListenOnSocket(const std::string& path)
+    {
+        if (!s_Data) {
+            printf("Error: Metrics::ListenOnSocket(%s) before Init\n", path.c_str());
+            return false;
+        }
+    #if defined(__unix__) || defined(__APPLE__)
+        MetricsData& data = *s_Data;
+        sockaddr_un address = {};
+        if (path.empty() || path.size() >= sizeof(address.sun_path)) {
+            printf("Error: Metrics socket path '%s' is empty or too long\n", path.c_str());
+            return false;
+        }
+        if (data.SocketHandle >= 0) {
+            close(data.SocketHandle);
+            unlink(data.SocketPath.c_str());
+            data.SocketHandle = -1;
+        }
+
+        int handle = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (handle < 0) {
+            printf("Error: Failed to create metrics socket: %s\n", strerror(errno));
+            return false;
+        }
+        address.sun_family = AF_UNIX;
+        memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        unlink(path.c_str()); // Left behind by a previous run that did not shut down
+        if (bind(handle, (const sockaddr*)&address, sizeof(address)) < 0 || listen(handle, (int)s_MaxPendingClients) < 0) {
+            printf("Error: Failed to listen on metrics socket %s: %s\n", path.c_str(), strerror(errno));
+            close(handle);
+            return false;
+        }
+        fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK);
+
+        data.SocketHandle = handle;
+        data.SocketPath = path;
+        printf("Metrics served on %s\n", path.c_str());
+        return true;
+    #else
+        printf("Error: Metrics sockets are not implemented for this platform (%s)\n", path.c_str());
+        return false;
+    #endif
+    }
+
+    MetricId Metrics::Register(const char* name, const char* help, MetricType type, const double* bounds, uint32_t boundCount)
+    {
+        if (!s_Data) {
+            return InvalidMetric;
+        }
+        MetricsData& data = *s_Data;
+        uint32_t count = data.Count.load(std::memory_order_relaxed);
+
+        for (uint32_t i = 0; i < count; i++) {
+            if (strncmp(data.Samples[i].Name, name, sizeof(data.Samples[i].Name) - 1) == 0) {
+                if (data.Definitions[i].Type != type) {
+                    printf("Error: metric %s is already registered with another type\n", name);
+                    return InvalidMetric;
+                }
+                return i;
+            }
+        }
+
+        uint32_t slots = type == MetricType::Counter ? 1 : type == MetricType::Histogram ? boundCount + 2 : 0;
+        if (count == MaxMetrics || data.SlotsUsed + slots > s_SlotsPerThread) {
+            printf("Error: too many metrics registering %s\n", name);
+            return InvalidMetric;
+        }
+        if (type == MetricType::Histogram) {
+            bool ascending = bounds && boundCount > 0 && boundCount <= MaxMetricBuckets;
+            for (uint32_t i = 1; ascending && i < boundCount; i++) {
+                ascending = bounds[i] > bounds[i - 1];
+            }
+            if (!ascending) {
+                printf("Error: histogram %s needs 1 to %u ascending bounds\n", name, MaxMetricBuckets);
+                return InvalidMetric;
+            }
+        }
+
+        MetricDefinition& definition = data.Definitions[count];
+        definition.Type = type;
+        definition.FirstSlot = data.SlotsUsed;
+        definition.BucketCount = type == MetricType::Histogram ? boundCount : 0;
+        MetricSample& sample = data.Samples[count];
+        memset(&sample, 0, sizeof(sample));
+        CopyTruncated(sample.Name, sizeof(sample.Name), name);
+        CopyTruncated(sample.Help, sizeof(sample.Help), help);
+        sample.Type = type;
+        sample.BucketCount = definition.BucketCount;
+        for (uint32_t i = 0; i < definition.BucketCount; i++) {
+            definition.Bounds[i] = sample.Bounds[i] = bounds[i];
+        }
+        data.SlotsUsed += slots;
+
+        // Recording threads check ids against the count; publish the definition first
+        data.Count.store(count + 1, std::memory_order_release);
+        return count;
+    }
+
+    MetricId Metrics::RegisterCounter(const char* name, const char* help)
+    {
+        return Register(name, help, MetricType::Counter, nullptr, 0);
+    }
+
+    MetricId Metrics::RegisterGauge(const char* name, const char* help)
+    {
+        return Register(name, help, MetricType::Gauge, nullptr, 0);
+    }
+
+    MetricId Metrics::RegisterHistogram(const char* name, const char* help, const double* bounds, uint32_t boundCount)
+    {
+        return Register(name, help, MetricType::Histogram, bounds, boundCount);
+    }
+
+    std::atomic<uint64_t>* Metrics::AcquireSlots()
+    {
+        if (t_Lease.Accumulator && t_Lease.Generation == s_Data->Generation) {
+            return t_Lease.Accumulator->Slots;
+        }
+
+        MetricsData& data = *s_Data;
+        std::lock_guard<std::mutex> lock(data.AccumulatorMutex);
+
+        ThreadAccumulator* accumulator = nullptr;
+        for (std::unique_ptr<ThreadAccumulator>& candidate : data.Accumulators) {
+            bool expected = false;
+            if (candidate->InUse.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                accumulator = candidate.get();
+                break;
+            }
+        }
+        if (!accumulator) {
+            data.Accumulators.push_back(std::make_unique<ThreadAccumulator>());
+            accumulator = data.Accumulators.back().get();
+            accumulator->InUse.store(true, std::memory_order_relaxed);
+            data.CurrentStats.Threads = (uint32_t)data.Accumulators.size();
+        }
+        t_Lease.Accumulator = accumulator;
+        t_Lease.Generation = data.Generation;
+        return accumulator->Slots;
+    }
+
+    // Only the owning thread writes a slot, so a plain load and store replace the atomic add
+    static inline void AddToSlot(std::atomic<uint64_t>& slot, uint64_t amount)
+    {
+        slot.store(slot.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    void Metrics::Increment(MetricId counter, uint64_t amount)
+    {
+        MetricsData* data = s_Data.get();
+        if (!data || counter >= data->Count.load(std::memory_order_acquire) || data->Definitions[counter].Type != MetricType::Counter) {
+            return;
+        }
+        AddToSlot(AcquireSlots()[data->Definitions[counter].FirstSlot], amount);
+    }
+
+    void Metrics::SetGauge(MetricId gauge, double value)
+    {
+        MetricsData* data = s_Data.get();
+        if (!data || gauge >= data->Count.load(std::memory_order_acquire) || data->Definitions[gauge].Type != MetricType::Gauge) {
+            return;
+        }
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        data->Gauges[gauge].store(bits, std::memory_order_relaxed);
+    }
+
+    void Metrics::Observe(MetricId histogram, double value)
+    {
+        MetricsData* data = s_Data.get();
+        if (!data || histogram >= data->Count.load(std::memory_order_acquire) || data->Definitions[histogram].Type != MetricType::Histogram) {
+            return;
+        }
+        const MetricDefinition& definition = data->Definitions[histogram];
+        uint32_t bucket = 0;
+        while (bucket < definition.BucketCount && value > definition.Bounds[bucket]) {
+            bucket++;
+        }
+
+        std::atomic<uint64_t>* slots = AcquireSlots();
+        AddToSlot(slots[definition.FirstSlot + bucket], 1);
+
+        std::atomic<uint64_t>& sumSlot = slots[definition.FirstSlot + definition.BucketCount + 1];
+        uint64_t bits = sumSlot.load(std::memory_order_relaxed);
+        double sum;
+        memcpy(&sum, &bits, sizeof(sum));
+        sum += value;
+        memcpy(&bits, &sum, sizeof(bits));
+        sumSlot.store(bits, std::memory_order_relaxed);
+    }
+
+    bool Metrics::HasReaders()
+    {
+        if (!s_Data) {
+            return false;
+        }
+        MetricsData& data = *s_Data;
+        if (data.ReadersFrame == data.Frame) {
+            return data.Readers;
+        }
+        data.ReadersFrame = data.Frame;
+
+        bool readers = false;
+        if (data.Shared) {
+            uint32_t pulse = data.Shared->ReaderPulse.load(std::memory_order_relaxed);
+            double now = SecondsSince(data.Start);
+            if (pulse != data.LastPulse) {
+                data.LastPulse = pulse;
+                data.LastPulseSeconds = now;
+            }
+            readers = now - data.LastPulseSeconds < s_ReaderTimeoutSeconds;
+        }
+
+    #if defined(__unix__) || defined(__APPLE__)
+        // Connections are answered by this frame's Publish, after the gauges were set
+        while (data.SocketHandle >= 0 && data.PendingClients.size() < s_MaxPendingClients) {
+            int client = accept(data.SocketHandle, nullptr, nullptr);
+            if (client < 0) {
+                break;
+            }
+            data.PendingClients.push_back(client);
+        }
+        readers = readers || !data.PendingClients.empty();
+    #endif
+
+        data.Readers = readers;
+        return readers;
+    }
+
+    void Metrics::Aggregate()
+    {
+        MetricsData& data = *s_Data;
+        uint32_t count = data.Count.load(std::memory_order_relaxed);
+        std::lock_guard<std::mutex> lock(data.AccumulatorMutex);
+
+        for (uint32_t i = 0; i < count; i++) {
+            const MetricDefinition& definition = data.Definitions[i];
+            MetricSample& sample = data.Samples[i];
+            switch (definition.Type) {
+                case MetricType::Counter: {
+                    uint64_t total = 0;
+                    for (const std::unique_ptr<ThreadAccumulator>& accumulator : data.Accumulators) {
+                        total += accumulator->Slots[definition.FirstSlot].load(std::memory_order_relaxed);
+                    }
+                    sample.Count = total;
+                    sample.Value = (double)total;
+                    break;
+                }
+                case MetricType::Gauge: {
+                    uint64_t bits = data.Gauges[i].load(std::memory_order_relaxed);
+                    memcpy(&sample.Value, &bits, sizeof(sample.Value));
+                    break;
+                }
+                case MetricType::Histogram: {
+                    memset(sample.Buckets, 0, sizeof(sample.Buckets));
+                    sample.Count = 0;
+                    sample.Value = 0.0;
+                    for (const std::unique_ptr<ThreadAccumulator>& accumulator : data.Accumulators) {
+                        for (uint32_t bucket = 0; bucket <= definition.BucketCount; bucket++) {
+                            uint64_t hits = accumulator->Slots[definition.FirstSlot + bucket].load(std::memory_order_relaxed);
+                            sample.Buckets[bucket] += hits;
+                            sample.Count += hits;
+                        }
+                        uint64_t bits = accumulator->Slots[definition.FirstSlot + definition.BucketCount + 1].load(std::memory_order_relaxed);
+                        double sum;
+                        memcpy(&sum, &bits, sizeof(sum));
+                        sample.Value += sum;
+                    }
+                    break;
+                }
+            }
+        }
+    }
+
+    void Metrics::Publish()
+    {
+        if (!s_Data) {
+            return;
+        }
+        MetricsData& data = *s_Data;
+        Stats& stats = data.CurrentStats;
+        if (!HasReaders()) {
+            stats.SkippedPublishes++;
+            data.Frame++;
+            return;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        Aggregate();
+        uint32_t count = data.Count.load(std::memory_order_relaxed);
+
+        if (data.Shared) {
+            // Seqlock: odd while the samples are inconsistent
+            MetricsSharedHeader& header = *data.Shared;
+            uint32_t sequence = header.Sequence.load(std::memory_order_relaxed);
+            header.Sequence.store(sequence + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            header.MetricCount = count;
+            header.Frame = data.Frame;
+            header.UptimeSeconds = SecondsSince(data.Start);
+            memcpy(reinterpret_cast<MetricSample*>(&header + 1), data.Samples, sizeof(MetricSample) * count);
+            header.Sequence.store(sequence + 2, std::memory_order_release);
+        }
+
+    #if defined(__unix__) || defined(__APPLE__)
+        if (!data.PendingClients.empty()) {
+            FormatMetricsText(data.Samples, count, data.Text);
+            for (int client : data.PendingClients) {
+                // Never waits: the text normally fits the socket buffer, and a client whose
+                // buffer is full (EAGAIN or a partial send) is dropped rather than stalling the frame
+                int flags = 0;
+            #ifdef MSG_NOSIGNAL
+                flags |= MSG_NOSIGNAL;
+            #endif
+            #ifdef MSG_DONTWAIT
+                flags |= MSG_DONTWAIT;
+            #endif
+            #ifdef SO_NOSIGPIPE
+                int noSignal = 1;
+                setsockopt(client, SOL_SOCKET, SO_NOSIGPIPE, &noSignal, sizeof(noSignal));
+            #endif
+                fcntl(client, F_SETFL, fcntl(client, F_GETFL, 0) | O_NONBLOCK);
+                size_t sent = 0;
+                while (sent < data.Text.size()) {
+                    ssize_t result = send(client, data.Text.data() + sent, data.Text.size() - sent, flags);
+                    if (result < 0 && errno == EINTR) {
+                        continue;
+                    }
+                    if (result <= 0) {
+                        break;
+                    }
+                    sent += (size_t)result;
+                }
+                close(client);
+                stats.SocketRequests++;
+                stats.DroppedClients += sent < data.Text.size() ? 1 : 0;
+            }
+            data.PendingClients.clear();
+        }
+    #endif
+
+        stats.Publishes++;
+        stats.PublishMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        data.Frame++;
+    }
+
+    Metrics::Stats Metrics::GetStats()
+    {
+        if (!s_Data) {
+            return Stats();
+        }
+        Stats stats = s_Data->CurrentStats;
+        stats.Metrics = s_Data->Count.load(std::memory_order_relaxed);
+        return stats;
+    }
+
+    static const char* GetMetricTypeName(MetricType type)
+    {
+        switch (type) {
+            case MetricType::Counter: return "counter";
+            case MetricType::Gauge: return "gauge";
+            case MetricType::Histogram: return "histogram";
+        }
+        return "untyped";
+    }
+
+    void FormatMetricsText(const MetricSample* samples, uint32_t count, std::string& text)
+    {
+        text.clear();
+        char line[256];
+        for (uint32_t i = 0; i < count; i++) {
+            const MetricSample& sample = samples[i];
+            if (sample.Help[0]) {
+                snprintf(line, sizeof(line), "# HELP %s %s\n", sample.Name, sample.Help);
+                text += line;
+            }
+            snprintf(line, sizeof(line), "# TYPE %s %s\n", sample.Name, GetMetricTypeName(sample.Type));
+            text += line;
+
+            switch (sample.Type) {
+                case MetricType::Counter:
+                    snprintf(line, sizeof(line), "%s %llu\n", sample.Name, (unsigned long long)sample.Count);
+                    text += line;
+                    break;
+                case MetricType::Gauge:
+                    snprintf(line, sizeof(line), "%s %.9g\n", sample.Name, sample.Value);
+                    text += line;
+                    break;
+                case MetricType::Histogram: {
+                    uint64_t cumulative = 0;
+                    uint32_t buckets = std::min(sample.BucketCount, MaxMetricBuckets);
+                    for (uint32_t bucket = 0; bucket < buckets; bucket++) {
+                        cumulative += sample.Buckets[bucket];
+                        snprintf(line, sizeof(line), "%s_bucket{le=\"%g\"} %llu\n", sample.Name, sample.Bounds[bucket],
+                                 (unsigned long long)cumulative);
+                        text += line;
+                    }
+                    snprintf(line, sizeof(line), "%s_bucket{le=\"+Inf\"} %llu\n%s_sum %.9g\n%s_count %llu\n", sample.Name,
+                             (unsigned long long)sample.Count, sample.Name, sample.Value, sample.Name, (unsigned long long)sample.Count);
+                    text += line;
+                    break;
+                }
+            }
+        }
+    }
+
+    MetricsReader::~MetricsReader()
+    {
+        Close();
+    }
+
+    std::string MetricsReader::GetDefaultName(uint32_t processId)
+    {
+        return "/marle-metrics-" + std::to_string(processId);
+    }
+
+    bool MetricsReader::Open(const std::string& shmName)
+    {
+        Close();
+    #if defined(__unix__) || defined(__APPLE__)
+        int handle = shm_open(shmName.c_str(), O_RDWR, 0);
+        if (handle < 0) {
+            printf("Error: Failed to open metrics %s: %s\n", shmName.c_str(), strerror(errno));
+            return false;
+        }
+        struct stat info;
+        if (fstat(handle, &info) != 0 || (size_t)info.st_size < GetSharedSize()) {
+            printf("Error: %s is not a Marle metrics segment\n", shmName.c_str());
+            close(handle);
+            return false;
+        }
+        // Read-write: readers announce themselves through ReaderPulse
+        void* memory = mmap(nullptr, GetSharedSize(), PROT_READ | PROT_WRITE, MAP_SHARED, handle, 0);
+        close(handle);
+        if (memory == MAP_FAILED) {
+            printf("Error: Failed to map metrics %s: %s\n", shmName.c_str(), strerror(errno));
+            return false;
+        }
+
+        MetricsSharedHeader* header = static_cast<MetricsSharedHeader*>(memory);
+        if (header->Magic != MetricsSharedHeader::MagicValue || header->Version != MetricsSharedHeader::CurrentVersion) {
+            printf("Error: %s is not a Marle metrics segment (or a different version)\n", shmName.c_str());
+            munmap(memory, GetSharedSize());
+            return false;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        m_Header = header;
+        m_Size = GetSharedSize();
+        return true;
+    #else
+        printf("Error: Metrics shared memory is not implemented for this platform (%s)\n", shmName.c_str());
+        return false;
+    #endif
+    }
+
+    void MetricsReader::Close()
+    {
+    #if defined(__unix__) || defined(__APPLE__)
+        if (m_Header) {
+            munmap(m_Header, m_Size);
+        }
+    #endif
+        m_Header = nullptr;
+        m_Size = 0;
+    }
+
+    void MetricsReader::Announce()
+    {
+        if (m_Header) {
+            m_Header->ReaderPulse.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    bool MetricsReader::Read(std::vector<MetricSample>& samples, uint64_t& frame, double& uptimeSeconds)
+    {
+        if (!m_Header) {
+            return false;
+        }
+        const MetricSample* shared = reinterpret_cast<const MetricSample*>(m_Header + 1);
+        for (uint32_t attempt = 0; attempt < 1000; attempt++) {
+            uint32_t before = m_Header->Sequence.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield();
+                continue;
+            }
+            uint32_t count = std::min(m_Header->MetricCount, MaxMetrics);
+            samples.resize(count);
+            memcpy(samples.data(), shared, sizeof(MetricSample) * count);
+            frame = m_Header->Frame;
+            uptimeSeconds = m_Header->UptimeSeconds;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_Header->Sequence.load(std::memory_order_relaxed) == before) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "../Core.h"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    typedef uint32_t MetricId;
+
+    enum class MetricType : uint8_t {
+        Counter = 0,    // Monotonic total
+        Gauge,          // Last value set
+        Histogram       // Observations in fixed buckets, plus their sum
+    };
+
+    static const uint32_t MaxMetrics = 256;
+    static const uint32_t MaxMetricBuckets = 15;   // Upper bounds; one more bucket takes everything above
+
+    // One metric as published. Plain data: it is laid out as-is in the shared-memory segment.
+    struct MetricSample {
+        char Name[64];
+        char Help[96];
+        MetricType Type;
+        uint32_t BucketCount;                   // Bounds used; Buckets holds BucketCount + 1 counts
+        double Value;                           // Counter total, gauge value or histogram sum
+        uint64_t Count;                         // Histogram observations
+        double Bounds[MaxMetricBuckets];
+        uint64_t Buckets[MaxMetricBuckets + 1]; // Per bucket, not cumulative
+    };
+
+    // Header of the shared-memory segment, followed by MaxMetrics samples. Sequence is a seqlock:
+    // odd while the engine is writing, so a reader retries when it changed during its copy.
+    // Readers announce themselves by bumping ReaderPulse; the engine only publishes while one did
+    // so within the last few seconds.
+    struct MetricsSharedHeader {
+        static const uint32_t MagicValue = 0x4D4C524D;    // "MRLM" in memory order
+        static const uint32_t CurrentVersion = 1;
+
+        uint32_t Magic;
+        uint32_t Version;
+        uint32_t ProcessId;
+        uint32_t MetricCount;
+        std::atomic<uint32_t> Sequence;
+        std::atomic<uint32_t> ReaderPulse;
+        uint64_t Frame;
+        double UptimeSeconds;
+    };
+
+    // Counters, gauges and histograms for watching a running game from outside: frame time,
+    // memory, asset streaming, renderer load.
+    //
+    // Recording is lock-free from any thread. Every thread accumulates counters and histogram
+    // buckets into its own block, so an increment is a thread-local load and store with no
+    // contention; gauges are a single relaxed store. Publish(), once per frame, sums the blocks
+    // into a snapshot and copies it into a shared-memory segment ("/marle-metrics-<pid>") under a
+    // seqlock, and answers the optional Unix-socket endpoint with the text format (Prometheus
+    // style, see FormatMetricsText). With no reader attached it skips all of that, so the cost
+    // is the recording itself plus one non-blocking accept() when the socket is open.
+    //
+    // MarleStat reads either endpoint. Registration is main-thread only, before the metric is
+    // recorded; Shutdown must come after the other threads stop recording, though they may
+    // exit at any time after it.
+    class Metrics {
+    public:
+        static constexpr MetricId InvalidMetric = ~0u;
+
+        // shmName: "" for the default per-process name, nullptr for no shared memory
+        static void Init(const char* shmName = "");
+        static void Shutdown();
+        static bool IsInitialized();
+
+        // Serves the text format to every connection on `path`, then closes it
+        static bool ListenOnSocket(const std::string& path);
+
+        // Registering an existing name returns its id (when the type matches). Names and help
+        // are truncated to fit MetricSample. Bounds must be ascending.
+        static MetricId RegisterCounter(const char* name, const char* help);
+        static MetricId RegisterGauge(const char* name, const char* help);
+        static MetricId RegisterHistogram(const char* name, const char* help, const double* bounds, uint32_t boundCount);
+
+        // Any thread; no-ops for InvalidMetric, so call sites need no checks
+        static void Increment(MetricId counter, uint64_t amount = 1);
+        static void SetGauge(MetricId gauge, double value);
+        static void Observe(MetricId histogram, double value);
+
+        // Whether anything will read the next Publish; gates gauges that cost something to compute
+        static bool HasReaders();
+        // Called by Application::Run at the end of every frame
+        static void Publish();
+
+        struct Stats {
+            uint32_t Metrics = 0;
+            uint32_t Threads = 0;           // Accumulator blocks handed out
+            uint64_t Publishes = 0;
+            uint64_t SkippedPublishes = 0;  // No reader attached
+            uint64_t SocketRequests = 0;
+            uint64_t DroppedClients = 0;    // Socket buffer full; got a truncated reply
+            double PublishMs = 0.0;         // Last publish that ran
+        };
+        static Stats GetStats();
+
+    private:
+        // This thread's accumulator slots, leasing a block on first use
+        static std::atomic<uint64_t>* AcquireSlots();
+        static MetricId Register(const char* name, const char* help, MetricType type, const double* bounds, uint32_t boundCount);
+        static void Aggregate();
+
+        struct MetricsData;
+        static std::unique_ptr<MetricsData> s_Data;
+    };
+
+    // Text exposition: "# HELP" and "# TYPE" lines, then "name value" (histograms as cumulative
+    // name_bucket{le="..."} lines plus name_sum and name_count)
+    void FormatMetricsText(const MetricSample* samples, uint32_t count, std::string& text);
+
+    // Reads a segment published by another process
+    class MetricsReader {
+    public:
+        MetricsReader() = default;
+        ~MetricsReader();
+
+        MetricsReader(const MetricsReader&) = delete;
+        MetricsReader& operator=(const MetricsReader&) = delete;
+
+        static std::string GetDefaultName(uint32_t processId);
+
+        bool Open(const std::string& shmName);
+        void Close();
+        bool IsOpen() const { return m_Header != nullptr; }
+
+        // Marks a reader as attached, so the engine starts (or keeps) publishing
+        void Announce();
+        // A consistent copy of the latest snapshot; false if the writer kept it busy or it is gone
+        bool Read(std::vector<MetricSample>& samples, uint64_t& frame, double& uptimeSeconds);
+
+    private:
+        MetricsSharedHeader* m_Header = nullptr;
+        size_t m_Size = 0;
+    };
+
+}
@@ -0,0 +1,608 @@
+#include "mrlpch.h"
+#include "ResourceManager.h"
+#include "FileSystem.h"
+#include "JobSystem.h"
+#include "Metrics.h"
+#include "../Platform/OpenGL/OpenGLShader.h"
+#include "../Platform/OpenGL/OpenGLTexture.h"
+#include "../Renderer/Font.h"
+#include "../Renderer/SoftwareRenderer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Marle {
+
+    // Matches ResourceHandle::InvalidIndex
+    static const uint32_t s_NoSlot = ~0u;
+
+    // Per-type loading hooks. Decode runs on a job thread and must not touch GL;
+    // Create runs on the render thread. Both return nullptr on failure. Types whose file can be
+    // read whole also have DecodeMemory, so async loads read through FileSystem::ReadAsync and
+    // only decode on the JobSystem.
+    struct ResourceOps {
+        const char* Name;
+        std::shared_ptr<void> (*Decode)(const std::string& path);
+        std::shared_ptr<void> (*DecodeMemory)(const std::string& path, const uint8_t* data, size_t size);
+        void* (*Create)(const std::string& path, void* staged);
+        void (*Destroy)(void* object);
+        void (*Measure)(const void* object, size_t& cpuBytes, size_t& gpuBytes);
+    };
+
+    struct StagedFont {
+        std::unique_ptr<Font> Object;
+    };
+
+    struct StagedSoftwareTexture {
+        std::unique_ptr<SoftwareTexture> Object;
+    };
+
+    static const ResourceOps s_Ops[(size_t)ResourceType::Count] = {
+        {
+            "Textures",
+            [](const std::string& path) -> std::shared_ptr<void> {
+                auto source = std::make_shared<OpenGLTexture2D::SourceLevels>();
+                if (!OpenGLTexture2D::ReadLevels(path, 0, *source)) {
+                    printf("Failed to load texture: %s\n", path.c_str());
+                    return nullptr;
+                }
+                return source;
+            },
+            [](const std::string& path, const uint8_t* data, size_t size) -> std::shared_ptr<void> {
+                auto source = std::make_shared<OpenGLTexture2D::SourceLevels>();
+                if (!OpenGLTexture2D::ReadLevels(path, data, size, 0, *source)) {
+                    printf("Failed to load texture: %s\n", path.c_str());
+                    return nullptr;
+                }
+                return source;
+            },
+            [](const std::string& path, void* staged) -> void* {
+                auto* texture = new OpenGLTexture2D(path, *static_cast<OpenGLTexture2D::SourceLevels*>(staged));
+                if (texture->GetRendererID() == 0) {
+                    delete texture;
+                    return nullptr;
+                }
+                return texture;
+            },
+            [](void* object) { delete static_cast<OpenGLTexture2D*>(object); },
+            [](const void* object, size_t& cpuBytes, size_t& gpuBytes) {
+                cpuBytes = 0;
+                gpuBytes = static_cast<const OpenGLTexture2D*>(object)->GetMemorySize();
+            }
+        },
+        {
+            "Shaders",
+            [](const std::string& path) -> std::shared_ptr<void> {
+                auto sources = std::make_shared<OpenGLShader::Sources>();
+                if (!OpenGLShader::ReadSources(path + ".vert", path + ".frag", *sources)) {
+                    return nullptr;
+                }
+                return sources;
+            },
+            nullptr,
+            [](const std::string& /*path*/, void* staged) -> void* {
+                auto* shader = new OpenGLShader(*static_cast<OpenGLShader::Sources*>(staged));
+                if (!shader->IsValid()) {
+                    delete shader;
+                    return nullptr;
+                }
+                return shader;
+            },
+            [](void* object) { delete static_cast<OpenGLShader*>(object); },
+            [](const void* /*object*/, size_t& cpuBytes, size_t& gpuBytes) {
+                cpuBytes = 0;
+                gpuBytes = 0;
+            }
+        },
+        {
+            "Fonts",
+            [](const std::string& path) -> std::shared_ptr<void> {
+                // Font parsing has no GL work (atlas pages are created on first draw)
+                auto staged = std::make_shared<StagedFont>();
+                staged->Object = std::make_unique<Font>(path);
+                if (!staged->Object->IsLoaded()) {
+                    return nullptr;
+                }
+                return staged;
+            },
+            nullptr,
+            [](const std::string& /*path*/, void* staged) -> void* {
+                return static_cast<StagedFont*>(staged)->Object.release();
+            },
+            [](void* object) { delete static_cast<Font*>(object); },
+            [](const void* object, size_t& cpuBytes, size_t& gpuBytes) {
+                const Font* font = static_cast<const Font*>(object);
+                cpuBytes = font->GetFileSize();
+                gpuBytes = font->GetAtlasMemorySize();
+            }
+        },
+        {
+            "Software textures",
+            [](const std::string& path) -> std::shared_ptr<void> {
+                // Nothing to create on the render thread: the decoded texels are the texture
+                auto staged = std::make_shared<StagedSoftwareTexture>();
+                staged->Object = SoftwareTexture::Load(path);
+                if (!staged->Object) {
+                    return nullptr;
+                }
+                return staged;
+            },
+            nullptr,
+            [](const std::string& /*path*/, void* staged) -> void* {
+                return static_cast<StagedSoftwareTexture*>(staged)->Object.release();
+            },
+            [](void* object) { delete static_cast<SoftwareTexture*>(object); },
+            [](const void* object, size_t& cpuBytes, size_t& gpuBytes) {
+                cpuBytes = static_cast<const SoftwareTexture*>(object)->GetMemorySize();
+                gpuBytes = 0;
+            }
+        }
+    };
+
+    enum class SlotState : uint8_t {
+        Free = 0,
+        Loading,
+        Ready,
+        Failed
+    };
+
+    struct PendingDecode {
+        std::shared_ptr<void> Staged;
+        std::atomic<bool> Done{ false };
+        JobHandle Job;  // Set on the main thread once the decode is submitted
+    };
+
+    struct ResourceSlot {
+        std::string Path;
+        uint64_t Hash = 0;
+        ResourceType Type = ResourceType::Texture;
+        SlotState State = SlotState::Free;
+        bool Keyed = false;           // Registered in SlotByHash
+        uint32_t Generation = 0;
+        uint32_t RefCount = 0;
+        void* Object = nullptr;
+        std::shared_ptr<PendingDecode> Pending;
+        size_t CpuBytes = 0;
+        size_t GpuBytes = 0;
+        uint64_t ReleasedAt = 0;      // LRU order among cached slots
+    };
+
+    struct ResourceManager::ResourceManagerData {
+        std::vector<ResourceSlot> Slots;
+        std::vector<uint32_t> FreeSlots;
+        std::unordered_map<uint64_t, uint32_t> SlotByHash;
+        size_t CpuBudget = 0;
+        size_t GpuBudget = 0;
+        uint64_t ReleaseCounter = 0;
+        TypeStats Counters[(size_t)ResourceType::Count]; // Requests, hits and evictions only
+    };
+
+    std::unique_ptr<ResourceManager::ResourceManagerData> ResourceManager::s_Data = nullptr;
+
+    // Generation new slots start at; carried across Shutdown/Init so a handle that outlives a
+    // shutdown never matches a slot of the next session
+    static uint32_t s_FirstGeneration = 0;
+
+    // Asset health for Metrics readers; decodes record from the job threads that run them
+    static MetricId s_DecodeMsMetric = Metrics::InvalidMetric;
+    static MetricId s_LoadFailuresMetric = Metrics::InvalidMetric;
+    static MetricId s_EvictionsMetric = Metrics::InvalidMetric;
+
+    static std::shared_ptr<void> TimedDecode(std::shared_ptr<void> (*decode)(const std::string&), const std::string& path)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<void> staged = decode(path);
+        Metrics::Observe(s_DecodeMsMetric, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        return staged;
+    }
+
+    static std::shared_ptr<void> TimedDecodeMemory(std::shared_ptr<void> (*decode)(const std::string&, const uint8_t*, size_t),
+                                                   const std::string& path, const FileBuffer& file)
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::shared_ptr<void> staged = decode(path, file.GetData(), file.GetSize());
+        Metrics::Observe(s_DecodeMsMetric, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+        return staged;
+    }
+
+    static uint64_t HashPath(StringId path, ResourceType type)
+    {
+        // The path's FNV-1a, continued with the type so one path can back different resource kinds
+        uint64_t hash = path.GetHash();
+        hash ^= (uint64_t)type + 1;
+        hash *= 1099511628211ull;
+        return hash;
+    }
+
+    // Takes an index, not a slot: the FileSystem callbacks and jobs run while waiting may load
+    // other resources and grow the slot array
+    static void FinishLoad(std::vector<ResourceSlot>& slots, uint32_t index, bool wait)
+    {
+        std::shared_ptr<PendingDecode> pending = slots[index].Pending;
+        while (wait && !pending->Done.load(std::memory_order_acquire)) {
+            FileSystem::Update(); // The load may still be waiting for its file read
+            if (pending->Job.IsValid()) {
+                pending->Job.Wait(); // Decodes here unless a worker already started; never other loads
+            } else if (!JobSystem::RunPendingJob()) {
+                std::this_thread::yield();
+            }
+        }
+
+        ResourceSlot& slot = slots[index];
+        if (slot.Pending != pending) {
+            return; // Finished or freed by a nested call while waiting
+        }
+        const ResourceOps& ops = s_Ops[(size_t)slot.Type];
+        slot.Object = pending->Staged ? ops.Create(slot.Path, pending->Staged.get()) : nullptr;
+        slot.State = slot.Object ? SlotState::Ready : SlotState::Failed;
+        slot.Pending.reset();
+        if (!slot.Object) {
+            Metrics::Increment(s_LoadFailuresMetric);
+        }
+        if (slot.Object) {
+            ops.Measure(slot.Object, slot.CpuBytes, slot.GpuBytes);
+        }
+    }
+
+    static void FreeSlot(std::unordered_map<uint64_t, uint32_t>& slotByHash, std::vector<uint32_t>& freeSlots,
+                         ResourceSlot& slot, uint32_t index)
+    {
+        if (slot.Object) {
+            s_Ops[(size_t)slot.Type].Destroy(slot.Object);
+            slot.Object = nullptr;
+        }
+        if (slot.Keyed) {
+            slotByHash.erase(slot.Hash);
+            slot.Keyed = false;
+        }
+        slot.Pending.reset(); // A decode still in flight keeps its own reference and finishes into nothing
+        slot.Path.clear();
+        slot.State = SlotState::Free;
+        slot.RefCount = 0;
+        slot.CpuBytes = slot.GpuBytes = 0;
+        slot.Generation++;
+        freeSlots.push_back(index);
+    }
+
+    void ResourceManager::Init(size_t cpuBudgetBytes, size_t gpuBudgetBytes)
+    {
+        s_Data = std::make_unique<ResourceManagerData>();
+        s_Data->CpuBudget = cpuBudgetBytes;
+        s_Data->GpuBudget = gpuBudgetBytes;
+
+        static const double decodeMsBounds[] = { 0.5, 1.0, 2.0, 5.0, 10.0, 20.0, 50.0, 100.0, 250.0 };
+        s_DecodeMsMetric = Metrics::RegisterHistogram("marle_resource_decode_ms", "Decode time per resource load, with the file read unless it was async",
+                                                      decodeMsBounds, sizeof(decodeMsBounds) / sizeof(decodeMsBounds[0]));
+        s_LoadFailuresMetric = Metrics::RegisterCounter("marle_resource_load_failures_total", "Resource loads that failed");
+        s_EvictionsMetric = Metrics::RegisterCounter("marle_resource_evictions_total", "Cached resources destroyed to free memory");
+        printf("ResourceManager initialized (cache budgets: %.0f MB CPU, %.0f MB GPU)\n",
+               cpuBudgetBytes / (1024.0 * 1024.0), gpuBudgetBytes / (1024.0 * 1024.0));
+    }
+
+    void ResourceManager::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+
+        uint32_t leaked = 0;
+        for (uint32_t i = 0; i < s_Data->Slots.size(); i++) {
+            ResourceSlot& slot = s_Data->Slots[i];
+            if (slot.State == SlotState::Free) {
+                continue;
+            }
+            if (slot.RefCount > 0) {
+                leaked++;
+            }
+            FreeSlot(s_Data->SlotByHash, s_Data->FreeSlots, slot, i);
+        }
+        for (const ResourceSlot& slot : s_Data->Slots) {
+            s_FirstGeneration = std::max(s_FirstGeneration, slot.Generation);
+        }
+        if (leaked > 0) {
+            printf("Warning: ResourceManager shut down with %u resources still referenced\n", leaked);
+        }
+
+        s_Data.reset();
+        printf("ResourceManager shutdown complete\n");
+    }
+
+    bool ResourceManager::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    void ResourceManager::SetBudgets(size_t cpuBudgetBytes, size_t gpuBudgetBytes)
+    {
+        if (s_Data) {
+            s_Data->CpuBudget = cpuBudgetBytes;
+            s_Data->GpuBudget = gpuBudgetBytes;
+        }
+    }
+
+    void ResourceManager::Acquire(const std::string& path, ResourceType type, bool async, uint32_t& index, uint32_t& generation)
+    {
+        index = s_NoSlot;
+        generation = 0;
+        if (!s_Data) {
+            printf("Error: ResourceManager not initialized (loading %s)\n", path.c_str());
+            return;
+        }
+
+        ResourceManagerData& data = *s_Data;
+        TypeStats& counters = data.Counters[(size_t)type];
+        counters.Requests++;
+
+        uint64_t hash = HashPath(StringId(path), type);
+        bool keyed = true;
+        auto it = data.SlotByHash.find(hash);
+        if (it != data.SlotByHash.end()) {
+            ResourceSlot& slot = data.Slots[it->second];
+            if (slot.Path == path) {
+                counters.Hits++;
+                slot.RefCount++;
+                index = it->second;
+                generation = slot.Generation;
+                if (slot.State == SlotState::Loading && !async) {
+                    FinishLoad(data.Slots, index, true);
+                }
+                return;
+            }
+            printf("Warning: resource path hash collision between %s and %s\n", slot.Path.c_str(), path.c_str());
+            keyed = false;
+        }
+
+        if (data.FreeSlots.empty()) {
+            data.FreeSlots.push_back((uint32_t)data.Slots.size());
+            data.Slots.emplace_back();
+            data.Slots.back().Generation = s_FirstGeneration;
+        }
+        index = data.FreeSlots.back();
+        data.FreeSlots.pop_back();
+
+        ResourceSlot& slot = data.Slots[index];
+        slot.Path = path;
+        slot.Hash = hash;
+        slot.Type = type;
+        slot.State = SlotState::Loading;
+        slot.Keyed = keyed;
+        slot.RefCount = 1;
+        slot.Pending = std::make_shared<PendingDecode>();
+        generation = slot.Generation;
+        if (keyed) {
+            data.SlotByHash[hash] = index;
+        }
+
+        std::shared_ptr<PendingDecode> pending = slot.Pending;
+        auto decode = s_Ops[(size_t)type].Decode;
+        auto decodeMemory = s_Ops[(size_t)type].DecodeMemory;
+        if (async && decodeMemory && FileSystem::IsInitialized()) {
+            // The read joins the FileSystem's next batch; the decode job starts when it completes
+            FileSystem::ReadAsync(path, [pending, decodeMemory](FileReadResult& result) {
+                if (!result.Success) {
+                    printf("Failed to load %s: file not readable\n", result.Path.c_str());
+                    pending->Done.store(true, std::memory_order_release);
+                    return;
+                }
+                auto file = std::make_shared<FileBuffer>(std::move(result.Data));
+                std::string path = std::move(result.Path);
+                pending->Job = JobSystem::SubmitBackground([pending, decodeMemory, file, path]() {
+                    pending->Staged = TimedDecodeMemory(decodeMemory, path, *file);
+                    pending->Done.store(true, std::memory_order_release);
+                });
+            });
+        } else if (async) {
+            pending->Job = JobSystem::SubmitBackground([pending, path, decode]() {
+                pending->Staged = TimedDecode(decode, path);
+                pending->Done.store(true, std::memory_order_release);
+            });
+        } else {
+            pending->Staged = TimedDecode(decode, path);
+            pending->Done.store(true, std::memory_order_release);
+            FinishLoad(data.Slots, index, false);
+        }
+    }
+
+    bool ResourceManager::FindSlot(StringId path, ResourceType type, uint32_t& index, uint32_t& generation)
+    {
+        index = s_NoSlot;
+        generation = 0;
+        if (!s_Data) {
+            return false;
+        }
+
+        ResourceManagerData& data = *s_Data;
+        TypeStats& counters = data.Counters[(size_t)type];
+        counters.Requests++;
+
+        auto it = data.SlotByHash.find(HashPath(path, type));
+        if (it == data.SlotByHash.end()) {
+            return false;
+        }
+        ResourceSlot& slot = data.Slots[it->second];
+        counters.Hits++;
+        slot.RefCount++;
+        index = it->second;
+        generation = slot.Generation;
+        return true;
+    }
+
+    void ResourceManager::AddRef(uint32_t index, uint32_t generation)
+    {
+        if (s_Data && index < s_Data->Slots.size() && s_Data->Slots[index].Generation == generation) {
+            s_Data->Slots[index].RefCount++;
+        }
+    }
+
+    void ResourceManager::Release(uint32_t index, uint32_t generation)
+    {
+        if (!s_Data || index >= s_Data->Slots.size()) {
+            return;
+        }
+        ResourceSlot& slot = s_Data->Slots[index];
+        if (slot.Generation != generation || slot.RefCount == 0 || --slot.RefCount > 0) {
+            return;
+        }
+
+        // Failures are forgotten so the next request retries; everything else stays cached
+        if (slot.State == SlotState::Failed) {
+            FreeSlot(s_Data->SlotByHash, s_Data->FreeSlots, slot, index);
+        } else {
+            slot.ReleasedAt = ++s_Data->ReleaseCounter;
+        }
+    }
+
+    void* ResourceManager::Resolve(uint32_t index, uint32_t generation, ResourceType type)
+    {
+        if (!s_Data || index >= s_Data->Slots.size()) {
+            return nullptr;
+        }
+        const ResourceSlot& slot = s_Data->Slots[index];
+        if (slot.Generation != generation || slot.Type != type || slot.State != SlotState::Ready) {
+            return nullptr;
+        }
+        return slot.Object;
+    }
+
+    bool ResourceManager::IsLoading(uint32_t index, uint32_t generation)
+    {
+        if (!s_Data || index >= s_Data->Slots.size()) {
+            return false;
+        }
+        const ResourceSlot& slot = s_Data->Slots[index];
+        return slot.Generation == generation && slot.State == SlotState::Loading;
+    }
+
+    void ResourceManager::Update()
+    {
+        if (!s_Data) {
+            return;
+        }
+        ResourceManagerData& data = *s_Data;
+
+        size_t cpuTotal = 0, gpuTotal = 0;
+        for (uint32_t i = 0; i < data.Slots.size(); i++) {
+            if (data.Slots[i].State == SlotState::Loading && data.Slots[i].Pending->Done.load(std::memory_order_acquire)) {
+                FinishLoad(data.Slots, i, false);
+            }
+            ResourceSlot& slot = data.Slots[i];
+            if (slot.State == SlotState::Ready) {
+                // Sizes move at runtime (texture streaming, font atlas growth)
+                s_Ops[(size_t)slot.Type].Measure(slot.Object, slot.CpuBytes, slot.GpuBytes);
+                cpuTotal += slot.CpuBytes;
+                gpuTotal += slot.GpuBytes;
+            }
+        }
+
+        // Evict least recently released cached resources until both budgets hold
+        while (cpuTotal > data.CpuBudget || gpuTotal > data.GpuBudget) {
+            uint32_t victim = s_NoSlot;
+            for (uint32_t i = 0; i < data.Slots.size(); i++) {
+                const ResourceSlot& slot = data.Slots[i];
+                if (slot.State != SlotState::Ready || slot.RefCount > 0) {
+                    continue;
+                }
+                if (victim == s_NoSlot || slot.ReleasedAt < data.Slots[victim].ReleasedAt) {
+                    victim = i;
+                }
+            }
+            if (victim == s_NoSlot) {
+                break; // Everything left is in use
+            }
+
+            ResourceSlot& slot = data.Slots[victim];
+            cpuTotal -= slot.CpuBytes;
+            gpuTotal -= slot.GpuBytes;
+            data.Counters[(size_t)slot.Type].Evictions++;
+            Metrics::Increment(s_EvictionsMetric);
+            FreeSlot(data.SlotByHash, data.FreeSlots, slot, victim);
+        }
+    }
+
+    void ResourceManager::ClearCache()
+    {
+        if (!s_Data) {
+            return;
+        }
+        for (uint32_t i = 0; i < s_Data->Slots.size(); i++) {
+            ResourceSlot& slot = s_Data->Slots[i];
+            if (slot.State == SlotState::Ready && slot.RefCount == 0) {
+                s_Data->Counters[(size_t)slot.Type].Evictions++;
+                Metrics::Increment(s_EvictionsMetric);
+                FreeSlot(s_Data->SlotByHash, s_Data->FreeSlots, slot, i);
+            }
+        }
+    }
+
+    FrameTaskId ResourceManager::ClearCacheOverFrames(FrameTaskPriority priority, double deadlineSeconds)
+    {
+        if (!s_Data) {
+            return FrameTaskScheduler::InvalidTask;
+        }
+        // One resource per step: destroying a GL object is the expensive part, and the scheduler
+        // keeps calling the step while the frame has time left
+        uint32_t cursor = 0;
+        return FrameTaskScheduler::Submit("ResourceManager::ClearCache", [cursor](FrameTaskContext& context) mutable {
+            if (!s_Data) {
+                return true;
+            }
+            while (cursor < s_Data->Slots.size()) {
+                uint32_t index = cursor++;
+                ResourceSlot& slot = s_Data->Slots[index];
+                if (slot.State == SlotState::Ready && slot.RefCount == 0) {
+                    s_Data->Counters[(size_t)slot.Type].Evictions++;
+                    Metrics::Increment(s_EvictionsMetric);
+                    FreeSlot(s_Data->SlotByHash, s_Data->FreeSlots, slot, index);
+                    break;
+                }
+            }
+            context.SetProgress(s_Data->Slots.empty() ? 1.0f : (float)cursor / (float)s_Data->Slots.size());
+            return cursor >= s_Data->Slots.size();
+        }, priority, deadlineSeconds);
+    }
+
+    ResourceManager::TypeStats ResourceManager::GetStats(ResourceType type)
+    {
+        if (!s_Data) {
+            return TypeStats();
+        }
+
+        TypeStats stats = s_Data->Counters[(size_t)type];
+        for (const ResourceSlot& slot : s_Data->Slots) {
+            if (slot.Type != type) {
+                continue;
+            }
+            if (slot.State == SlotState::Loading) {
+                stats.Loading++;
+            } else if (slot.State == SlotState::Ready) {
+                stats.Resident++;
+                stats.Referenced += slot.RefCount > 0 ? 1 : 0;
+                stats.CpuBytes += slot.CpuBytes;
+                stats.GpuBytes += slot.GpuBytes;
+            }
+        }
+        return stats;
+    }
+
+    const char* ResourceManager::GetTypeName(ResourceType type)
+    {
+        return type < ResourceType::Count ? s_Ops[(size_t)type].Name : "Unknown";
+    }
+
+    void ResourceManager::PrintStats()
+    {
+        for (size_t i = 0; i < (size_t)ResourceType::Count; i++) {
+            ResourceType type = (ResourceType)i;
+            TypeStats stats = GetStats(type);
+            printf("%-8s %3u resident (%u referenced, %u cached, %u loading)  CPU %.2f MB  GPU %.2f MB  hit rate %.1f%% (%llu/%llu)  %llu evicted\n",
+                   GetTypeName(type), stats.Resident, stats.Referenced, stats.Resident - stats.Referenced, stats.Loading,
+                   stats.CpuBytes / (1024.0 * 1024.0), stats.GpuBytes / (1024.0 * 1024.0), stats.GetHitRate() * 100.0,
+                   (unsigned long long)stats.Hits, (unsigned long long)stats.Requests, (unsigned long long)stats.Evictions);
+        }
+    }
+
+}
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "../Core.h"
+#include "FrameTaskScheduler.h"
+#include "StringId.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace Marle {
+
+    class OpenGLTexture2D;
+    class OpenGLShader;
+    class Font;
+    class SoftwareTexture;
+
+    enum class ResourceType : uint8_t {
+        Texture = 0,
+        Shader,     // Path is the shared stem: "Assets/Shaders/Texture" loads Texture.vert + Texture.frag
+        Font,
+        SoftwareTexture,
+        Count
+    };
+
+    template<typename T> struct ResourceTraits;
+    template<> struct ResourceTraits<OpenGLTexture2D> { static const ResourceType Type = ResourceType::Texture; };
+    template<> struct ResourceTraits<OpenGLShader>    { static const ResourceType Type = ResourceType::Shader; };
+    template<> struct ResourceTraits<Font>            { static const ResourceType Type = ResourceType::Font; };
+    template<> struct ResourceTraits<SoftwareTexture> { static const ResourceType Type = ResourceType::SoftwareTexture; };
+
+    // Counted reference to a managed resource. A handle names a slot plus the generation it was
+    // issued for, so a handle that outlives its resource (after Shutdown or a failed load being
+    // retried) resolves to nullptr instead of to whatever reuses the slot.
+    template<typename T>
+    class ResourceHandle {
+    public:
+        ResourceHandle() = default;
+        ResourceHandle(const ResourceHandle& other);
+        ResourceHandle(ResourceHandle&& other) noexcept;
+        ResourceHandle& operator=(const ResourceHandle& other);
+        ResourceHandle& operator=(ResourceHandle&& other) noexcept;
+        ~ResourceHandle();
+
+        void Reset();
+
+        // nullptr while an async load is in flight or when loading failed
+        T* Get() const;
+        T* operator->() const { return Get(); }
+        explicit operator bool() const { return Get() != nullptr; }
+
+        bool IsValid() const { return m_Index != InvalidIndex; }
+        bool IsLoading() const;
+
+    private:
+        friend class ResourceManager;
+        static const uint32_t InvalidIndex = ~0u;
+
+        ResourceHandle(uint32_t index, uint32_t generation) : m_Index(index), m_Generation(generation) {}
+
+        uint32_t m_Index = InvalidIndex;
+        uint32_t m_Generation = 0;
+    };
+
+    // Owns textures, shaders and fonts (and textures for the software renderer), keyed by a hash of their path.
+    //
+    // Requests for a path that is loaded, loading or cached share one object. Loads are split into
+    // a decode step that runs on the JobSystem (file I/O, image decode, mip generation) and a
+    // create step on the render thread (GL objects), finished by Update() or by a blocking Load().
+    // Async texture loads read their file with FileSystem::ReadAsync first and decode from memory.
+    // When the last handle goes away the resource moves to an LRU cache instead of being
+    // destroyed; cached resources are evicted oldest first once CPU or GPU usage passes its budget.
+    // Render thread only.
+    class ResourceManager {
+    public:
+        static void Init(size_t cpuBudgetBytes = 256ull * 1024 * 1024, size_t gpuBudgetBytes = 512ull * 1024 * 1024);
+        static void Shutdown();
+        static bool IsInitialized();
+
+        static void SetBudgets(size_t cpuBudgetBytes, size_t gpuBudgetBytes);
+
+        // Returns once the resource is ready (or failed)
+        template<typename T>
+        static ResourceHandle<T> Load(const std::string& path)
+        {
+            uint32_t index, generation;
+            Acquire(path, ResourceTraits<T>::Type, false, index, generation);
+            return ResourceHandle<T>(index, generation);
+        }
+
+        // Returns immediately; the handle resolves once Update() has created the object
+        template<typename T>
+        static ResourceHandle<T> LoadAsync(const std::string& path)
+        {
+            uint32_t index, generation;
+            Acquire(path, ResourceTraits<T>::Type, true, index, generation);
+            return ResourceHandle<T>(index, generation);
+        }
+
+        // A resource that is already loaded, loading or cached, without touching the path
+        // string; an invalid handle otherwise. Never starts a load.
+        template<typename T>
+        static ResourceHandle<T> Find(StringId path)
+        {
+            uint32_t index, generation;
+            FindSlot(path, ResourceTraits<T>::Type, index, generation);
+            return ResourceHandle<T>(index, generation);
+        }
+
+        // Once per frame: creates finished async loads, refreshes sizes and enforces the budgets
+        static void Update();
+        // Destroys every cached (unreferenced) resource
+        static void ClearCache();
+        // Same, a few resources per frame on the FrameTaskScheduler, so releasing a whole level's
+        // textures does not stall one frame. Resources referenced again before their turn survive.
+        static FrameTaskId ClearCacheOverFrames(FrameTaskPriority priority = FrameTaskPriority::Low, double deadlineSeconds = 0.0);
+
+        struct TypeStats {
+            uint32_t Resident = 0;      // Loaded objects, referenced or cached
+            uint32_t Referenced = 0;
+            uint32_t Loading = 0;
+            size_t CpuBytes = 0;
+            size_t GpuBytes = 0;
+            uint64_t Requests = 0;
+            uint64_t Hits = 0;          // Served by a loaded, loading or cached resource
+            uint64_t Evictions = 0;
+            double GetHitRate() const { return Requests ? (double)Hits / (double)Requests : 0.0; }
+        };
+        static TypeStats GetStats(ResourceType type);
+        static const char* GetTypeName(ResourceType type);
+        static void PrintStats();
+
+    private:
+        template<typename T> friend class ResourceHandle;
+
+        static void Acquire(const std::string& path, ResourceType type, bool async, uint32_t& index, uint32_t& generation);
+        static bool FindSlot(StringId path, ResourceType type, uint32_t& index, uint32_t& generation);
+        static void AddRef(uint32_t index, uint32_t generation);
+        static void Release(uint32_t index, uint32_t generation);
+        static void* Resolve(uint32_t index, uint32_t generation, ResourceType type);
+        static bool IsLoading(uint32_t index, uint32_t generation);
+
+        struct ResourceManagerData;
+        static std::unique_ptr<ResourceManagerData> s_Data;
+    };
+
+    template<typename T>
+    ResourceHandle<T>::ResourceHandle(const ResourceHandle& other)
+        : m_Index(other.m_Index), m_Generation(other.m_Generation)
+    {
+        if (IsValid()) {
+            ResourceManager::AddRef(m_Index, m_Generation);
+        }
+    }
+
+    template<typename T>
+    ResourceHandle<T>::ResourceHandle(ResourceHandle&& other) noexcept
+        : m_Index(other.m_Index), m_Generation(other.m_Generation)
+    {
+        other.m_Index = InvalidIndex;
+    }
+
+    template<typename T>
+    ResourceHandle<T>& ResourceHandle<T>::operator=(const ResourceHandle& other)
+    {
+        if (this != &other) {
+            if (other.IsValid()) {
+                ResourceManager::AddRef(other.m_Index, other.m_Generation);
+            }
+            Reset();
+            m_Index = other.m_Index;
+            m_Generation = other.m_Generation;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    ResourceHandle<T>& ResourceHandle<T>::operator=(ResourceHandle&& other) noexcept
+    {
+        if (this != &other) {
+            Reset();
+            m_Index = other.m_Index;
+            m_Generation = other.m_Generation;
+            other.m_Index = InvalidIndex;
+        }
+        return *this;
+    }
+
+    template<typename T>
+    ResourceHandle<T>::~ResourceHandle()
+    {
+        Reset();
+    }
+
+    template<typename T>
+    void ResourceHandle<T>::Reset()
+    {
+        if (IsValid()) {
+            ResourceManager::Release(m_Index, m_Generation);
+            m_Index = InvalidIndex;
+        }
+    }
+
+    template<typename T>
+    T* ResourceHandle<T>::Get() const
+    {
+        return IsValid() ? static_cast<T*>(ResourceManager::Resolve(m_Index, m_Generation, ResourceTraits<T>::Type)) : nullptr;
+    }
+
+    template<typename T>
+    bool ResourceHandle<T>::IsLoading() const
+    {
+        return IsValid() && ResourceManager::IsLoading(m_Index, m_Generation);
+    }
+
+}
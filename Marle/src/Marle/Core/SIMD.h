@@ -0,0 +1,229 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(__x86_64__)
+    #include <emmintrin.h>
+    #define MRL_SIMD_SSE2
+#elif defined(__ARM_NEON) || defined(__aarch64__)
+    #include <arm_neon.h>
+    #define MRL_SIMD_NEON
+#else
+    #define MRL_SIMD_SCALAR
+#endif
+
+namespace Marle {
+
+    // Four-wide float operations over whatever the target provides (SSE2 on x86_64, NEON on arm64),
+    // with a scalar fallback so callers never need their own #ifdefs.
+    namespace SIMD {
+
+    #if defined(MRL_SIMD_SSE2)
+        using Float4 = __m128;
+        using Int4 = __m128i;
+
+        inline Float4 Load(const float* p)                   { return _mm_loadu_ps(p); }
+        inline void   Store(float* p, Float4 v)              { _mm_storeu_ps(p, v); }
+        inline Float4 Set1(float s)                          { return _mm_set1_ps(s); }
+        inline Float4 Set(float a, float b, float c, float d){ return _mm_setr_ps(a, b, c, d); }
+        inline Float4 Zero()                                 { return _mm_setzero_ps(); }
+        inline Float4 Add(Float4 a, Float4 b)                { return _mm_add_ps(a, b); }
+        inline Float4 Sub(Float4 a, Float4 b)                { return _mm_sub_ps(a, b); }
+        inline Float4 Mul(Float4 a, Float4 b)                { return _mm_mul_ps(a, b); }
+        inline Float4 Div(Float4 a, Float4 b)                { return _mm_div_ps(a, b); }
+        inline Float4 MulAdd(Float4 a, Float4 b, Float4 c)   { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+        inline Float4 Min(Float4 a, Float4 b)                { return _mm_min_ps(a, b); }
+        inline Float4 Max(Float4 a, Float4 b)                { return _mm_max_ps(a, b); }
+        inline Float4 Sqrt(Float4 a)                         { return _mm_sqrt_ps(a); }
+        // Lane-wise a <= b, as an all-ones / all-zeros mask
+        inline Float4 CmpLE(Float4 a, Float4 b)              { return _mm_cmple_ps(a, b); }
+        inline Float4 Select(Float4 mask, Float4 a, Float4 b){ return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+        // Bit i set when lane i of the mask is set
+        inline int    MoveMask(Float4 mask)                  { return _mm_movemask_ps(mask); }
+
+        inline Int4   LoadInt(const int32_t* p)              { return _mm_loadu_si128((const __m128i*)p); }
+        inline void   StoreInt(int32_t* p, Int4 v)           { _mm_storeu_si128((__m128i*)p, v); }
+        inline Int4   ToInt(Float4 v)                        { return _mm_cvttps_epi32(v); }
+        inline Float4 ToFloat(Int4 v)                        { return _mm_cvtepi32_ps(v); }
+        inline Int4   SetInt1(int32_t s)                     { return _mm_set1_epi32(s); }
+        inline Int4   SetInt(int32_t a, int32_t b, int32_t c, int32_t d) { return _mm_setr_epi32(a, b, c, d); }
+        // Four bytes, zero-extended to the four lanes
+        inline Int4   LoadBytesInt(const uint8_t* p)
+        {
+            int32_t word;
+            __builtin_memcpy(&word, p, sizeof(word));
+            __m128i zero = _mm_setzero_si128();
+            return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(word), zero), zero);
+        }
+        // Low byte of each lane, written as four bytes
+        inline void   StoreBytesInt(uint8_t* p, Int4 v)
+        {
+            __m128i bytes = _mm_and_si128(v, _mm_set1_epi32(0xFF));
+            bytes = _mm_packus_epi16(_mm_packs_epi32(bytes, bytes), bytes);
+            int32_t word = _mm_cvtsi128_si32(bytes);
+            __builtin_memcpy(p, &word, sizeof(word));
+        }
+        inline Int4   AddInt(Int4 a, Int4 b)                 { return _mm_add_epi32(a, b); }
+        inline Int4   SubInt(Int4 a, Int4 b)                 { return _mm_sub_epi32(a, b); }
+        inline Int4   AbsInt(Int4 a)                         { Int4 sign = _mm_srai_epi32(a, 31); return _mm_sub_epi32(_mm_xor_si128(a, sign), sign); }
+        inline Int4   AndInt(Int4 a, Int4 b)                 { return _mm_and_si128(a, b); }
+        inline Int4   OrInt(Int4 a, Int4 b)                  { return _mm_or_si128(a, b); }
+        // Signed lane-wise a < b, as an all-ones / all-zeros mask
+        inline Int4   CmpLTInt(Int4 a, Int4 b)               { return _mm_cmplt_epi32(a, b); }
+        inline Int4   SelectInt(Int4 mask, Int4 a, Int4 b)   { return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b)); }
+        // Logical shifts
+        inline Int4   ShiftLeftInt(Int4 v, int bits)         { return _mm_slli_epi32(v, bits); }
+        inline Int4   ShiftRightInt(Int4 v, int bits)        { return _mm_srli_epi32(v, bits); }
+    #elif defined(MRL_SIMD_NEON)
+        using Float4 = float32x4_t;
+        using Int4 = int32x4_t;
+
+        inline Float4 Load(const float* p)                   { return vld1q_f32(p); }
+        inline void   Store(float* p, Float4 v)              { vst1q_f32(p, v); }
+        inline Float4 Set1(float s)                          { return vdupq_n_f32(s); }
+        inline Float4 Set(float a, float b, float c, float d){ float v[4] = { a, b, c, d }; return vld1q_f32(v); }
+        inline Float4 Zero()                                 { return vdupq_n_f32(0.0f); }
+        inline Float4 Add(Float4 a, Float4 b)                { return vaddq_f32(a, b); }
+        inline Float4 Sub(Float4 a, Float4 b)                { return vsubq_f32(a, b); }
+        inline Float4 Mul(Float4 a, Float4 b)                { return vmulq_f32(a, b); }
+        inline Float4 Div(Float4 a, Float4 b)                { return vdivq_f32(a, b); }
+        inline Float4 MulAdd(Float4 a, Float4 b, Float4 c)   { return vmlaq_f32(c, a, b); }
+        inline Float4 Min(Float4 a, Float4 b)                { return vminq_f32(a, b); }
+        inline Float4 Max(Float4 a, Float4 b)                { return vmaxq_f32(a, b); }
+        inline Float4 Sqrt(Float4 a)                         { return vsqrtq_f32(a); }
+        inline Float4 CmpLE(Float4 a, Float4 b)              { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+        inline Float4 Select(Float4 mask, Float4 a, Float4 b){ return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+        inline int    MoveMask(Float4 mask)
+        {
+            static const int32_t bits[4] = { 1, 2, 4, 8 };
+            int32x4_t masked = vandq_s32(vreinterpretq_s32_f32(mask), vld1q_s32(bits));
+            return (int)vaddvq_s32(masked);
+        }
+
+        inline Int4   LoadInt(const int32_t* p)              { return vld1q_s32(p); }
+        inline void   StoreInt(int32_t* p, Int4 v)           { vst1q_s32(p, v); }
+        inline Int4   ToInt(Float4 v)                        { return vcvtq_s32_f32(v); }
+        inline Float4 ToFloat(Int4 v)                        { return vcvtq_f32_s32(v); }
+        inline Int4   SetInt1(int32_t s)                     { return vdupq_n_s32(s); }
+        inline Int4   SetInt(int32_t a, int32_t b, int32_t c, int32_t d) { int32_t v[4] = { a, b, c, d }; return vld1q_s32(v); }
+        inline Int4   LoadBytesInt(const uint8_t* p)
+        {
+            uint32_t word;
+            __builtin_memcpy(&word, p, sizeof(word));
+            uint16x8_t wide = vmovl_u8(vreinterpret_u8_u32(vdup_n_u32(word)));
+            return vreinterpretq_s32_u32(vmovl_u16(vget_low_u16(wide)));
+        }
+        inline void   StoreBytesInt(uint8_t* p, Int4 v)
+        {
+            uint16x4_t halves = vmovn_u32(vreinterpretq_u32_s32(v));
+            uint8x8_t bytes = vmovn_u16(vcombine_u16(halves, halves));
+            uint32_t word = vget_lane_u32(vreinterpret_u32_u8(bytes), 0);
+            __builtin_memcpy(p, &word, sizeof(word));
+        }
+        inline Int4   AddInt(Int4 a, Int4 b)                 { return vaddq_s32(a, b); }
+        inline Int4   SubInt(Int4 a, Int4 b)                 { return vsubq_s32(a, b); }
+        inline Int4   AbsInt(Int4 a)                         { return vabsq_s32(a); }
+        inline Int4   AndInt(Int4 a, Int4 b)                 { return vandq_s32(a, b); }
+        inline Int4   OrInt(Int4 a, Int4 b)                  { return vorrq_s32(a, b); }
+        inline Int4   CmpLTInt(Int4 a, Int4 b)               { return vreinterpretq_s32_u32(vcltq_s32(a, b)); }
+        inline Int4   SelectInt(Int4 mask, Int4 a, Int4 b)   { return vbslq_s32(vreinterpretq_u32_s32(mask), a, b); }
+        inline Int4   ShiftLeftInt(Int4 v, int bits)         { return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(v), vdupq_n_s32(bits))); }
+        inline Int4   ShiftRightInt(Int4 v, int bits)        { return vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(v), vdupq_n_s32(-bits))); }
+    #else
+        struct Float4 { float v[4]; };
+        struct Int4 { int32_t v[4]; };
+
+        #define MRL_SIMD_LANES(expr) Float4 r; for (int i = 0; i < 4; i++) { r.v[i] = (expr); } return r
+
+        inline Float4 Load(const float* p)                   { MRL_SIMD_LANES(p[i]); }
+        inline void   Store(float* p, Float4 v)              { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+        inline Float4 Set1(float s)                          { MRL_SIMD_LANES(s); }
+        inline Float4 Set(float a, float b, float c, float d){ return Float4{ { a, b, c, d } }; }
+        inline Float4 Zero()                                 { MRL_SIMD_LANES(0.0f); }
+        inline Float4 Add(Float4 a, Float4 b)                { MRL_SIMD_LANES(a.v[i] + b.v[i]); }
+        inline Float4 Sub(Float4 a, Float4 b)                { MRL_SIMD_LANES(a.v[i] - b.v[i]); }
+        inline Float4 Mul(Float4 a, Float4 b)                { MRL_SIMD_LANES(a.v[i] * b.v[i]); }
+        inline Float4 Div(Float4 a, Float4 b)                { MRL_SIMD_LANES(a.v[i] / b.v[i]); }
+        inline Float4 MulAdd(Float4 a, Float4 b, Float4 c)   { MRL_SIMD_LANES(a.v[i] * b.v[i] + c.v[i]); }
+        inline Float4 Min(Float4 a, Float4 b)                { MRL_SIMD_LANES(a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+        inline Float4 Max(Float4 a, Float4 b)                { MRL_SIMD_LANES(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+        inline Float4 Sqrt(Float4 a)                         { MRL_SIMD_LANES(__builtin_sqrtf(a.v[i])); }
+        inline Float4 CmpLE(Float4 a, Float4 b)
+        {
+            Float4 r;
+            for (int i = 0; i < 4; i++) {
+                uint32_t bits = a.v[i] <= b.v[i] ? 0xFFFFFFFFu : 0u;
+                __builtin_memcpy(&r.v[i], &bits, sizeof(bits));
+            }
+            return r;
+        }
+        inline Float4 Select(Float4 mask, Float4 a, Float4 b)
+        {
+            Float4 r;
+            for (int i = 0; i < 4; i++) {
+                uint32_t bits;
+                __builtin_memcpy(&bits, &mask.v[i], sizeof(bits));
+                r.v[i] = bits ? a.v[i] : b.v[i];
+            }
+            return r;
+        }
+        inline int MoveMask(Float4 mask)
+        {
+            int result = 0;
+            for (int i = 0; i < 4; i++) {
+                uint32_t bits;
+                __builtin_memcpy(&bits, &mask.v[i], sizeof(bits));
+                result |= (bits >> 31) << i;
+            }
+            return result;
+        }
+
+        inline Int4   LoadInt(const int32_t* p)              { return Int4{ { p[0], p[1], p[2], p[3] } }; }
+        inline void   StoreInt(int32_t* p, Int4 v)           { for (int i = 0; i < 4; i++) p[i] = v.v[i]; }
+        inline Int4   ToInt(Float4 v)                        { return Int4{ { (int32_t)v.v[0], (int32_t)v.v[1], (int32_t)v.v[2], (int32_t)v.v[3] } }; }
+        inline Float4 ToFloat(Int4 v)                        { return Float4{ { (float)v.v[0], (float)v.v[1], (float)v.v[2], (float)v.v[3] } }; }
+        inline Int4   SetInt1(int32_t s)                     { return Int4{ { s, s, s, s } }; }
+        inline Int4   SetInt(int32_t a, int32_t b, int32_t c, int32_t d) { return Int4{ { a, b, c, d } }; }
+        inline Int4   LoadBytesInt(const uint8_t* p)         { return Int4{ { p[0], p[1], p[2], p[3] } }; }
+        inline void   StoreBytesInt(uint8_t* p, Int4 v)      { for (int i = 0; i < 4; i++) p[i] = (uint8_t)v.v[i]; }
+        inline Int4   AddInt(Int4 a, Int4 b)                 { return Int4{ { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } }; }
+        inline Int4   SubInt(Int4 a, Int4 b)                 { return Int4{ { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } }; }
+        inline Int4   AbsInt(Int4 a)
+        {
+            Int4 r;
+            for (int i = 0; i < 4; i++) r.v[i] = a.v[i] < 0 ? -a.v[i] : a.v[i];
+            return r;
+        }
+        inline Int4   AndInt(Int4 a, Int4 b)                 { return Int4{ { a.v[0] & b.v[0], a.v[1] & b.v[1], a.v[2] & b.v[2], a.v[3] & b.v[3] } }; }
+        inline Int4   OrInt(Int4 a, Int4 b)                  { return Int4{ { a.v[0] | b.v[0], a.v[1] | b.v[1], a.v[2] | b.v[2], a.v[3] | b.v[3] } }; }
+        inline Int4   CmpLTInt(Int4 a, Int4 b)
+        {
+            Int4 r;
+            for (int i = 0; i < 4; i++) r.v[i] = a.v[i] < b.v[i] ? -1 : 0;
+            return r;
+        }
+        inline Int4   SelectInt(Int4 mask, Int4 a, Int4 b)
+        {
+            Int4 r;
+            for (int i = 0; i < 4; i++) r.v[i] = mask.v[i] ? a.v[i] : b.v[i];
+            return r;
+        }
+        inline Int4   ShiftLeftInt(Int4 v, int bits)
+        {
+            Int4 r;
+            for (int i = 0; i < 4; i++) r.v[i] = (int32_t)((uint32_t)v.v[i] << bits);
+            return r;
+        }
+        inline Int4   ShiftRightInt(Int4 v, int bits)
+        {
+            Int4 r;
+            for (int i = 0; i < 4; i++) r.v[i] = (int32_t)((uint32_t)v.v[i] >> bits);
+            return r;
+        }
+
+        #undef MRL_SIMD_LANES
+    #endif
+
+    }
+
+}
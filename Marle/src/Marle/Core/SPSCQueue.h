@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    // Bounded wait-free queue for exactly one producer thread and one consumer thread.
+    // Push and Pop never lock or allocate, so either side may be a real-time thread.
+    template<typename T>
+    class SPSCQueue {
+    public:
+        explicit SPSCQueue(uint32_t capacity)
+        {
+            uint32_t size = 2;
+            while (size < capacity) {
+                size <<= 1;
+            }
+            m_Items.resize(size);
+            m_Mask = size - 1;
+        }
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        // Producer side; false when the queue is full
+        bool Push(const T& item)
+        {
+            uint32_t tail = m_Tail.load(std::memory_order_relaxed);
+            if (tail - m_CachedHead > m_Mask) {
+                m_CachedHead = m_Head.load(std::memory_order_acquire);
+                if (tail - m_CachedHead > m_Mask) {
+                    return false;
+                }
+            }
+            m_Items[tail & m_Mask] = item;
+            m_Tail.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side; false when the queue is empty
+        bool Pop(T& item)
+        {
+            uint32_t head = m_Head.load(std::memory_order_relaxed);
+            if (head == m_CachedTail) {
+                m_CachedTail = m_Tail.load(std::memory_order_acquire);
+                if (head == m_CachedTail) {
+                    return false;
+                }
+            }
+            item = m_Items[head & m_Mask];
+            m_Head.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        uint32_t GetCapacity() const { return m_Mask + 1; }
+
+    private:
+        std::vector<T> m_Items;
+        uint32_t m_Mask = 0;
+
+        // Each index lives on its own cache line next to the other side's cached copy of it
+        alignas(64) std::atomic<uint32_t> m_Tail{ 0 };
+        uint32_t m_CachedHead = 0;          // Producer's last view of m_Head
+        alignas(64) std::atomic<uint32_t> m_Head{ 0 };
+        uint32_t m_CachedTail = 0;          // Consumer's last view of m_Tail
+    };
+
+}
@@ -0,0 +1,580 @@
+#include "mrlpch.h"
+#include "Snapshot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace Marle {
+
+    static const uint32_t s_SnapshotMagic = 0x534C524D; // "MRLS"
+    static const uint32_t s_SnapshotFormatVersion = 2;
+    static const uint64_t s_UnknownHash = 0;
+    static const uint32_t s_HeaderSlotBytes = 4096;  // Headers A and B never share a sector
+
+    // File layout: block 0 holds header A at 0 and header B at s_HeaderSlotBytes. Two slots follow,
+    // each [section table + pointer runs][section 0][section 1]... with every region starting on a
+    // block boundary. Each header describes its own slot.
+    struct SnapshotFileHeader {
+        uint32_t Magic;
+        uint32_t FormatVersion;
+        uint32_t BlockSize;
+        uint32_t SectionCount;
+        uint32_t PointerRunCount;
+        uint32_t Slot;
+        uint64_t Generation;
+        uint64_t FileSize;
+        uint64_t MetadataOffset;        // Section table, then pointer runs
+        uint64_t MetadataSize;
+        uint64_t Checksum;              // Of the fields above and the metadata
+    };
+    static_assert(sizeof(SnapshotFileHeader) == 64, "snapshot header layout changed");
+
+    struct SnapshotSectionEntry {
+        char Name[48];
+        uint32_t Version;
+        uint32_t Reserved;
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    struct SnapshotPointerRun {
+        uint32_t Section;
+        uint32_t TargetSection;
+        uint64_t FirstOffset;
+        uint64_t Stride;
+        uint64_t Count;
+    };
+
+    static uint64_t RoundUpToBlock(uint64_t size)
+    {
+        return (size + SnapshotSaver::BlockSize - 1) / SnapshotSaver::BlockSize * SnapshotSaver::BlockSize;
+    }
+
+    // Four independent multiply-xorshift lanes, so hashing runs at memory speed. Never returns s_UnknownHash.
+    static uint64_t HashBlock(const uint8_t* data, size_t size)
+    {
+        const uint64_t k = 0xFF51AFD7ED558CCDull;
+        uint64_t h[4] = { 0x9E3779B97F4A7C15ull ^ size, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull, 0x27D4EB2F165667C5ull };
+
+        size_t i = 0;
+        for (; i + 32 <= size; i += 32) {
+            for (int lane = 0; lane < 4; lane++) {
+                uint64_t v;
+                memcpy(&v, data + i + lane * 8, 8);
+                h[lane] = (h[lane] ^ v) * k;
+                h[lane] ^= h[lane] >> 29;
+            }
+        }
+        for (; i < size; i++) {
+            h[0] = (h[0] ^ data[i]) * k;
+        }
+
+        uint64_t result = h[0] ^ (h[1] * 3) ^ (h[2] * 5) ^ (h[3] * 7);
+        result ^= result >> 33;
+        return result == s_UnknownHash ? 1 : result;
+    }
+
+    static uint64_t ChecksumHeader(const SnapshotFileHeader& header, const uint8_t* metadata)
+    {
+        uint64_t fields = HashBlock(reinterpret_cast<const uint8_t*>(&header), offsetof(SnapshotFileHeader, Checksum));
+        return HashBlock(metadata, (size_t)header.MetadataSize) ^ (fields * 0x9E3779B97F4A7C15ull);
+    }
+
+    static bool SyncDirectory(const std::string& path)
+    {
+        size_t slash = path.find_last_of('/');
+        std::string directory = slash == std::string::npos ? "." : slash == 0 ? "/" : path.substr(0, slash);
+        int fd = open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) {
+            return false;
+        }
+        bool ok = fsync(fd) == 0;
+        close(fd);
+        return ok;
+    }
+
+    static bool WriteAt(int fd, const void* data, size_t size, uint64_t offset)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (size > 0) {
+            ssize_t written = pwrite(fd, bytes, size, (off_t)offset);
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            size -= (size_t)written;
+            offset += (uint64_t)written;
+        }
+        return true;
+    }
+
+    // SnapshotCapture
+
+    void SnapshotCapture::Clear()
+    {
+        m_SectionCount = 0;
+        m_Pointers.clear();
+    }
+
+    void* SnapshotCapture::AllocateSection(const std::string& name, uint32_t version, size_t size, uint32_t* sectionIndex)
+    {
+        if (m_SectionCount == m_Sections.size()) {
+            m_Sections.emplace_back();
+        }
+
+        Section& section = m_Sections[m_SectionCount];
+        section.Name = name;
+        section.Version = version;
+        section.Data.resize(size);
+
+        if (sectionIndex) {
+            *sectionIndex = m_SectionCount;
+        }
+        m_SectionCount++;
+        return section.Data.data();
+    }
+
+    uint32_t SnapshotCapture::AddSection(const std::string& name, uint32_t version, const void* data, size_t size)
+    {
+        uint32_t index = 0;
+        void* destination = AllocateSection(name, version, size, &index);
+        if (size > 0) {
+            memcpy(destination, data, size);
+        }
+        return index;
+    }
+
+    void SnapshotCapture::AddPointers(uint32_t section, uint64_t firstOffset, uint64_t stride, uint64_t count, uint32_t targetSection)
+    {
+        if (count > 0) {
+            m_Pointers.push_back({ section, targetSection, firstOffset, stride, count });
+        }
+    }
+
+    size_t SnapshotCapture::GetTotalSize() const
+    {
+        size_t total = 0;
+        for (uint32_t i = 0; i < m_SectionCount; i++) {
+            total += m_Sections[i].Data.size();
+        }
+        return total;
+    }
+
+    // SnapshotSaver
+
+    SnapshotSaver::SnapshotSaver()
+    {
+        m_Thread = std::thread([this]() { WorkerLoop(); });
+    }
+
+    SnapshotSaver::~SnapshotSaver()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Stopping = true;
+        }
+        m_Condition.notify_all();
+        m_Thread.join();
+    }
+
+    SnapshotCapture* SnapshotSaver::BeginCapture()
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        for (int i = 0; i < 2; i++) {
+            if (!m_CaptureBusy[i]) {
+                m_CaptureBusy[i] = true;
+                m_Captures[i].Clear();
+                return &m_Captures[i];
+            }
+        }
+        return nullptr;
+    }
+
+    void SnapshotSaver::SaveAsync(SnapshotCapture* capture, const std::string& path)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Queue.push_back({ capture, path });
+            m_Pending++;
+        }
+        m_Condition.notify_all();
+    }
+
+    bool SnapshotSaver::SaveNow(SnapshotCapture* capture, const std::string& path)
+    {
+        // Keep ordering with anything already queued for the same file. The wait and the claim
+        // share one lock, and the worker will not dequeue while m_SyncSaving is set, so a
+        // SaveAsync from another thread cannot run its Write alongside this one.
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return m_Pending == 0; });
+        m_Pending++;
+        m_SyncSaving = true;
+        lock.unlock();
+
+        bool result = Write(*capture, path);
+
+        lock.lock();
+        m_CaptureBusy[capture - m_Captures] = false;
+        m_SyncSaving = false;
+        m_Pending--;
+        lock.unlock();
+        m_Condition.notify_all();
+        return result;
+    }
+
+    bool SnapshotSaver::IsSaving() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_Pending > 0;
+    }
+
+    void SnapshotSaver::WaitForSaves()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Condition.wait(lock, [this]() { return m_Pending == 0; });
+    }
+
+    SnapshotSaver::SaveStats SnapshotSaver::GetLastSaveStats() const
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        return m_LastStats;
+    }
+
+    void SnapshotSaver::WorkerLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        while (true) {
+            m_Condition.wait(lock, [this]() { return !m_SyncSaving && (m_Stopping || !m_Queue.empty()); });
+            if (m_Queue.empty()) {
+                return; // Stopping with nothing left to write
+            }
+
+            Job job = m_Queue.front();
+            m_Queue.erase(m_Queue.begin());
+            lock.unlock();
+
+            if (!Write(*job.Capture, job.Path)) {
+                printf("Error: Failed to save snapshot %s\n", job.Path.c_str());
+            }
+
+            lock.lock();
+            m_CaptureBusy[job.Capture - m_Captures] = false;
+            m_Pending--;
+            m_Condition.notify_all();
+        }
+    }
+
+    bool SnapshotSaver::LayoutFits(const SnapshotCapture& capture, size_t metadataSize) const
+    {
+        if (m_LayoutRegions.empty() || capture.m_SectionCount + 1 != m_LayoutRegions.size() ||
+            metadataSize > m_LayoutRegions[0].Capacity) {
+            return false;
+        }
+        for (uint32_t i = 0; i < capture.m_SectionCount; i++) {
+            if (capture.m_Sections[i].Name != m_LayoutNames[i] ||
+                capture.m_Sections[i].Data.size() > m_LayoutRegions[i + 1].Capacity) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool SnapshotSaver::Write(SnapshotCapture& capture, const std::string& path)
+    {
+        auto start = std::chrono::high_resolution_clock::now();
+        SaveStats stats;
+
+        const size_t metadataSize = capture.m_SectionCount * sizeof(SnapshotSectionEntry) +
+                                    capture.m_Pointers.size() * sizeof(SnapshotPointerRun);
+
+        stats.FullRewrite = path != m_LayoutPath || !LayoutFits(capture, metadataSize);
+        if (stats.FullRewrite) {
+            // New layout with 25% slack per region, so sections can grow a little without moving
+            m_LayoutPath = path;
+            m_LayoutNames.clear();
+            m_LayoutRegions.clear();
+
+            uint64_t offset = RoundUpToBlock(std::max<uint64_t>(metadataSize + metadataSize / 4, 1));
+            m_LayoutRegions.push_back({ 0, offset });
+            for (uint32_t i = 0; i < capture.m_SectionCount; i++) {
+                size_t size = capture.m_Sections[i].Data.size();
+                uint64_t capacity = RoundUpToBlock(std::max<uint64_t>(size + size / 4, 1));
+                m_LayoutNames.push_back(capture.m_Sections[i].Name);
+                m_LayoutRegions.push_back({ offset, capacity });
+                offset += capacity;
+            }
+            m_SlotBytes = offset;
+            m_FileSize = BlockSize + 2 * m_SlotBytes;
+            m_BlockHashes.assign(m_FileSize / BlockSize, s_UnknownHash);
+            m_ActiveSlot = 1; // The new file starts with slot 0
+        }
+
+        // Never the slot the newest header on disk points to; a new layout goes to a new file,
+        // so the old one stays valid until the rename
+        uint32_t slot = m_ActiveSlot ^ 1;
+        uint64_t slotOffset = BlockSize + slot * m_SlotBytes;
+        std::string target = stats.FullRewrite ? path + ".tmp" : path;
+
+        int fd = open(target.c_str(), O_WRONLY | O_CREAT | (stats.FullRewrite ? O_TRUNC : 0), 0644);
+        if (fd < 0) {
+            printf("Error: Could not open %s for writing\n", target.c_str());
+            m_LayoutPath.clear();
+            return false;
+        }
+
+        bool ok = !stats.FullRewrite || ftruncate(fd, (off_t)m_FileSize) == 0;
+
+        // Section blocks: hash each one against what this slot holds, write runs of changed blocks
+        for (uint32_t i = 0; i < capture.m_SectionCount && ok; i++) {
+            const std::vector<uint8_t>& data = capture.m_Sections[i].Data;
+            const Region& region = m_LayoutRegions[i + 1];
+            uint64_t regionOffset = slotOffset + region.Offset;
+            uint32_t firstBlock = (uint32_t)(regionOffset / BlockSize);
+            uint32_t blockCount = (uint32_t)(region.Capacity / BlockSize);
+
+            uint32_t runStart = 0, runLength = 0;
+            for (uint32_t b = 0; b <= blockCount && ok; b++) {
+                bool dirty = false;
+                if (b < blockCount) {
+                    uint64_t begin = (uint64_t)b * BlockSize;
+                    size_t bytes = begin < data.size() ? (size_t)std::min<uint64_t>(BlockSize, data.size() - begin) : 0;
+                    uint64_t hash = HashBlock(data.data() + std::min<uint64_t>(begin, data.size()), bytes);
+                    dirty = hash != m_BlockHashes[firstBlock + b];
+                    m_BlockHashes[firstBlock + b] = hash;
+                    stats.BlocksTotal++;
+                }
+
+                if (dirty) {
+                    if (runLength == 0) {
+                        runStart = b;
+                    }
+                    runLength++;
+                    continue;
+                }
+
+                if (runLength > 0) {
+                    // Bytes past the section's size are never read back, so only valid data is written
+                    uint64_t begin = (uint64_t)runStart * BlockSize;
+                    uint64_t end = std::min<uint64_t>((uint64_t)(runStart + runLength) * BlockSize, data.size());
+                    if (end > begin) {
+                        ok = WriteAt(fd, data.data() + begin, (size_t)(end - begin), regionOffset + begin);
+                        stats.BytesWritten += end - begin;
+                    }
+                    stats.BlocksWritten += runLength;
+                    runLength = 0;
+                }
+            }
+        }
+
+        // The slot's section table and pointer runs; the header that makes them current comes last
+        SnapshotFileHeader header;
+        memset(&header, 0, sizeof(header));
+        if (ok) {
+            m_Scratch.assign(metadataSize, 0);
+
+            SnapshotSectionEntry* entries = reinterpret_cast<SnapshotSectionEntry*>(m_Scratch.data());
+            for (uint32_t i = 0; i < capture.m_SectionCount; i++) {
+                const SnapshotCapture::Section& section = capture.m_Sections[i];
+                strncpy(entries[i].Name, section.Name.c_str(), sizeof(entries[i].Name) - 1);
+                entries[i].Version = section.Version;
+                entries[i].Offset = slotOffset + m_LayoutRegions[i + 1].Offset;
+                entries[i].Size = section.Data.size();
+            }
+
+            SnapshotPointerRun* runs = reinterpret_cast<SnapshotPointerRun*>(entries + capture.m_SectionCount);
+            for (size_t i = 0; i < capture.m_Pointers.size(); i++) {
+                const SnapshotCapture::PointerRun& run = capture.m_Pointers[i];
+                runs[i] = { run.Section, run.TargetSection, run.FirstOffset, run.Stride, run.Count };
+            }
+
+            header.Magic = s_SnapshotMagic;
+            header.FormatVersion = s_SnapshotFormatVersion;
+            header.BlockSize = BlockSize;
+            header.SectionCount = capture.m_SectionCount;
+            header.PointerRunCount = (uint32_t)capture.m_Pointers.size();
+            header.Slot = slot;
+            header.Generation = m_Generation + 1;
+            header.FileSize = m_FileSize;
+            header.MetadataOffset = slotOffset + m_LayoutRegions[0].Offset;
+            header.MetadataSize = m_Scratch.size();
+            header.Checksum = ChecksumHeader(header, m_Scratch.data());
+
+            ok = WriteAt(fd, m_Scratch.data(), m_Scratch.size(), header.MetadataOffset);
+            stats.BytesWritten += m_Scratch.size();
+            stats.BlocksWritten += (uint32_t)((m_Scratch.size() + BlockSize - 1) / BlockSize);
+            stats.BlocksTotal += (uint32_t)(m_LayoutRegions[0].Capacity / BlockSize);
+        }
+
+        // Data must be durable before the header that describes it, and the header before the
+        // file replaces the previous one
+        ok = ok && fsync(fd) == 0;
+        ok = ok && WriteAt(fd, &header, sizeof(header), (uint64_t)slot * s_HeaderSlotBytes) && fsync(fd) == 0;
+        stats.BytesWritten += sizeof(header);
+        close(fd);
+
+        if (ok && stats.FullRewrite) {
+            ok = rename(target.c_str(), path.c_str()) == 0 && SyncDirectory(path);
+        }
+        if (ok) {
+            m_Generation++;
+            m_ActiveSlot = slot;
+        } else {
+            // Unknown state of the slot being written: the next save starts a new file
+            m_LayoutPath.clear();
+            if (stats.FullRewrite) {
+                remove(target.c_str());
+            }
+        }
+
+        stats.Succeeded = ok;
+        stats.Seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_LastStats = stats;
+        return ok;
+    }
+
+    // Snapshot
+
+    Snapshot::~Snapshot()
+    {
+        Unload();
+    }
+
+    void Snapshot::Unload()
+    {
+        if (m_Base) {
+            munmap(m_Base, m_MappedSize);
+            m_Base = nullptr;
+            m_MappedSize = 0;
+            m_HeaderOffset = 0;
+        }
+    }
+
+    bool Snapshot::Load(const std::string& path)
+    {
+        Unload();
+
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            printf("Error: Could not open snapshot %s\n", path.c_str());
+            return false;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || (size_t)info.st_size < sizeof(SnapshotFileHeader)) {
+            printf("Error: Snapshot %s is truncated\n", path.c_str());
+            close(fd);
+            return false;
+        }
+
+        // Private mapping: pages touched by pointer fix-ups are copied, the rest stay shared with the page cache
+        size_t size = (size_t)info.st_size;
+        void* mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (mapping == MAP_FAILED) {
+            printf("Error: Could not map snapshot %s\n", path.c_str());
+            return false;
+        }
+        m_Base = static_cast<uint8_t*>(mapping);
+        m_MappedSize = size;
+
+        // The newest header whose slot was completely written
+        const SnapshotFileHeader* header = nullptr;
+        for (uint32_t slot = 0; slot < 2; slot++) {
+            uint64_t headerOffset = (uint64_t)slot * s_HeaderSlotBytes;
+            if (headerOffset + sizeof(SnapshotFileHeader) > size) {
+                break;
+            }
+            const SnapshotFileHeader* candidate = reinterpret_cast<const SnapshotFileHeader*>(m_Base + headerOffset);
+            uint64_t tableSize = (uint64_t)candidate->SectionCount * sizeof(SnapshotSectionEntry) +
+                                 (uint64_t)candidate->PointerRunCount * sizeof(SnapshotPointerRun);
+            if (candidate->Magic != s_SnapshotMagic || candidate->FormatVersion != s_SnapshotFormatVersion ||
+                candidate->FileSize > size || candidate->MetadataSize != tableSize ||
+                candidate->MetadataOffset > size || candidate->MetadataSize > size - candidate->MetadataOffset ||
+                candidate->Checksum != ChecksumHeader(*candidate, m_Base + candidate->MetadataOffset)) {
+                continue;
+            }
+            if (!header || candidate->Generation > header->Generation) {
+                header = candidate;
+                m_HeaderOffset = (size_t)headerOffset;
+            }
+        }
+        if (!header) {
+            printf("Error: %s is not a compatible snapshot (format %u)\n", path.c_str(), s_SnapshotFormatVersion);
+            Unload();
+            return false;
+        }
+
+        const SnapshotSectionEntry* entries = reinterpret_cast<const SnapshotSectionEntry*>(m_Base + header->MetadataOffset);
+        for (uint32_t i = 0; i < header->SectionCount; i++) {
+            if (entries[i].Offset > size || entries[i].Size > size - entries[i].Offset) {
+                printf("Error: Snapshot %s section '%.48s' is out of bounds\n", path.c_str(), entries[i].Name);
+                Unload();
+                return false;
+            }
+        }
+
+        // Pointer fix-ups: offsets into the target section become addresses in the mapping
+        const SnapshotPointerRun* runs = reinterpret_cast<const SnapshotPointerRun*>(entries + header->SectionCount);
+        for (uint32_t r = 0; r < header->PointerRunCount; r++) {
+            const SnapshotPointerRun& run = runs[r];
+            if (run.Section >= header->SectionCount || run.TargetSection >= header->SectionCount || run.Count == 0) {
+                continue;
+            }
+
+            const SnapshotSectionEntry& section = entries[run.Section];
+            const SnapshotSectionEntry& target = entries[run.TargetSection];
+            // Written so no term can overflow: the first field fits, then the rest fit at Stride
+            // apart without overlapping one another
+            bool fits = section.Size >= sizeof(uint64_t) && run.FirstOffset <= section.Size - sizeof(uint64_t);
+            if (fits && run.Count > 1) {
+                fits = run.Stride >= sizeof(uint64_t) &&
+                       (section.Size - run.FirstOffset - sizeof(uint64_t)) / run.Stride >= run.Count - 1;
+            }
+            if (!fits) {
+                printf("Warning: Snapshot %s has an out-of-bounds pointer run, skipped\n", path.c_str());
+                continue;
+            }
+
+            uint8_t* field = m_Base + section.Offset + run.FirstOffset;
+            uint8_t* targetBase = m_Base + target.Offset;
+            for (uint64_t i = 0; i < run.Count; i++, field += run.Stride) {
+                uint64_t value;
+                memcpy(&value, field, sizeof(value));
+                value = (value < target.Size) ? (uint64_t)(uintptr_t)(targetBase + value) : 0;
+                memcpy(field, &value, sizeof(value));
+            }
+        }
+
+        return true;
+    }
+
+    uint64_t Snapshot::GetGeneration() const
+    {
+        return m_Base ? reinterpret_cast<const SnapshotFileHeader*>(m_Base + m_HeaderOffset)->Generation : 0;
+    }
+
+    const void* Snapshot::GetSection(const std::string& name, size_t* size, uint32_t* version) const
+    {
+        if (!m_Base) {
+            return nullptr;
+        }
+
+        const SnapshotFileHeader* header = reinterpret_cast<const SnapshotFileHeader*>(m_Base + m_HeaderOffset);
+        const SnapshotSectionEntry* entries = reinterpret_cast<const SnapshotSectionEntry*>(m_Base + header->MetadataOffset);
+        for (uint32_t i = 0; i < header->SectionCount; i++) {
+            if (strncmp(entries[i].Name, name.c_str(), sizeof(entries[i].Name)) == 0) {
+                if (size) *size = (size_t)entries[i].Size;
+                if (version) *version = entries[i].Version;
+                return m_Base + entries[i].Offset;
+            }
+        }
+        return nullptr;
+    }
+
+}
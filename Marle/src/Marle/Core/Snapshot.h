@@ -0,0 +1,178 @@
+#pragma once
+
+#include "../Core.h"
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Marle {
+
+    // On-disk pointer. Written as a byte offset into a target section, turned into a real pointer
+    // by Snapshot::Load when it applies the relocations registered with SnapshotCapture::AddPointers.
+    template<typename T>
+    struct SnapshotPtr {
+        static const uint64_t Null = ~0ull;
+
+        uint64_t Value = Null;
+
+        static SnapshotPtr FromOffset(uint64_t byteOffset) { SnapshotPtr p; p.Value = byteOffset; return p; }
+        static SnapshotPtr FromIndex(uint64_t index) { return FromOffset(index * sizeof(T)); }
+
+        // Only meaningful on a loaded snapshot
+        T* Get() const { return reinterpret_cast<T*>((uintptr_t)Value); }
+    };
+
+    // One save's worth of state: named, versioned sections of plain data plus pointer relocations.
+    // Filled on the game thread (a memcpy of the live arrays), then handed to SnapshotSaver.
+    class SnapshotCapture {
+    public:
+        void Clear();
+
+        // Returns the section index; storage is reused between captures so steady-state
+        // autosaves do not allocate
+        uint32_t AddSection(const std::string& name, uint32_t version, const void* data, size_t size);
+        // Same, but lets the caller write the section contents in place
+        void* AllocateSection(const std::string& name, uint32_t version, size_t size, uint32_t* sectionIndex = nullptr);
+
+        // Marks count SnapshotPtr fields, the first at firstOffset in section and then every
+        // stride bytes, as pointing into targetSection
+        void AddPointers(uint32_t section, uint64_t firstOffset, uint64_t stride, uint64_t count, uint32_t targetSection);
+
+        size_t GetTotalSize() const;
+
+    private:
+        friend class SnapshotSaver;
+
+        struct Section {
+            std::string Name;
+            uint32_t Version = 0;
+            std::vector<uint8_t> Data;
+        };
+
+        struct PointerRun {
+            uint32_t Section, TargetSection;
+            uint64_t FirstOffset, Stride, Count;
+        };
+
+        std::vector<Section> m_Sections;
+        uint32_t m_SectionCount = 0;    // Sections in use; m_Sections may hold spares from earlier captures
+        std::vector<PointerRun> m_Pointers;
+    };
+
+    // Writes snapshots on a background thread. Two captures are double-buffered: the game fills
+    // one while the other is being written, so an autosave never waits on disk I/O.
+    //
+    // Files are laid out in fixed-size blocks with each section padded to block boundaries and
+    // some slack, and hold two copies (slots) of that layout, each with its own header. A save
+    // only writes the slot the newest header does not describe: it hashes every block and rewrites
+    // the ones that differ from what that slot holds, syncs them, then writes and syncs the slot's
+    // header, which carries a generation and a checksum. Loading picks the newest valid header, so
+    // a crash mid-save leaves the previous save intact. A new layout (first save to a path, or
+    // sections that outgrew their slack) is written to a temporary file and renamed over the old.
+    class SnapshotSaver {
+    public:
+        static const uint32_t BlockSize = 64 * 1024;
+
+        SnapshotSaver();
+        ~SnapshotSaver();
+
+        SnapshotSaver(const SnapshotSaver&) = delete;
+        SnapshotSaver& operator=(const SnapshotSaver&) = delete;
+
+        // Returns an empty capture to fill, or nullptr if both are still being written
+        SnapshotCapture* BeginCapture();
+        // Queues the capture for writing and returns immediately
+        void SaveAsync(SnapshotCapture* capture, const std::string& path);
+        // Writes on the calling thread
+        bool SaveNow(SnapshotCapture* capture, const std::string& path);
+
+        bool IsSaving() const;
+        void WaitForSaves();
+
+        struct SaveStats {
+            double Seconds = 0.0;
+            uint64_t BytesWritten = 0;
+            uint32_t BlocksWritten = 0;
+            uint32_t BlocksTotal = 0;
+            bool FullRewrite = false;
+            bool Succeeded = false;
+        };
+        SaveStats GetLastSaveStats() const;
+
+    private:
+        struct Region {
+            uint64_t Offset = 0;
+            uint64_t Capacity = 0;
+        };
+
+        struct Job {
+            SnapshotCapture* Capture = nullptr;
+            std::string Path;
+        };
+
+        void WorkerLoop();
+        bool Write(SnapshotCapture& capture, const std::string& path);
+        bool LayoutFits(const SnapshotCapture& capture, size_t metadataSize) const;
+
+        SnapshotCapture m_Captures[2];
+        bool m_CaptureBusy[2] = { false, false };
+
+        // Layout and block hashes of the last file written, for incremental saves
+        std::string m_LayoutPath;
+        std::vector<std::string> m_LayoutNames;
+        std::vector<Region> m_LayoutRegions;   // [0] = metadata, then one per section; offsets within a slot
+        std::vector<uint64_t> m_BlockHashes;
+        uint64_t m_SlotBytes = 0;
+        uint64_t m_FileSize = 0;
+        uint32_t m_ActiveSlot = 0;             // The slot the newest header on disk describes
+        uint64_t m_Generation = 0;
+        std::vector<uint8_t> m_Scratch;
+
+        std::thread m_Thread;
+        mutable std::mutex m_Mutex;
+        std::condition_variable m_Condition;
+        std::vector<Job> m_Queue;
+        uint32_t m_Pending = 0;
+        bool m_SyncSaving = false;             // SaveNow is writing; the worker must not dequeue
+        bool m_Stopping = false;
+        SaveStats m_LastStats;
+    };
+
+    // A loaded snapshot: the file is memory-mapped and pointer fields are fixed up in place,
+    // so sections are used directly with no parsing or copying.
+    class Snapshot {
+    public:
+        Snapshot() = default;
+        ~Snapshot();
+
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+
+        bool Load(const std::string& path);
+        void Unload();
+        bool IsLoaded() const { return m_Base != nullptr; }
+
+        uint64_t GetGeneration() const;
+
+        // nullptr when the section is missing
+        const void* GetSection(const std::string& name, size_t* size = nullptr, uint32_t* version = nullptr) const;
+
+        template<typename T>
+        const T* GetArray(const std::string& name, size_t& count, uint32_t* version = nullptr) const
+        {
+            size_t size = 0;
+            const T* data = static_cast<const T*>(GetSection(name, &size, version));
+            count = data ? size / sizeof(T) : 0;
+            return data;
+        }
+
+    private:
+        uint8_t* m_Base = nullptr;
+        size_t m_MappedSize = 0;
+        size_t m_HeaderOffset = 0;             // The newest valid header slot
+    };
+
+}
@@ -0,0 +1,76 @@
+#include "mrlpch.h"
+#include "StringId.h"
+
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+namespace Marle {
+
+#ifdef MRL_DEBUG
+    namespace {
+
+        struct InternTable {
+            std::mutex Mutex;
+            std::unordered_map<uint64_t, std::string> Strings;
+        };
+
+        // Leaked on purpose: ids may be resolved from static destructors
+        InternTable& GetInternTable()
+        {
+            static InternTable* table = new InternTable();
+            return *table;
+        }
+
+        void Record(uint64_t hash, const char* text, size_t length)
+        {
+            InternTable& table = GetInternTable();
+            std::lock_guard<std::mutex> lock(table.Mutex);
+            auto it = table.Strings.find(hash);
+            if (it == table.Strings.end()) {
+                table.Strings.emplace(hash, std::string(text, length));
+            } else if (it->second.size() != length || memcmp(it->second.data(), text, length) != 0) {
+                printf("Error: StringId collision: '%s' and '%.*s' both hash to %016llx\n",
+                       it->second.c_str(), (int)length, text, (unsigned long long)hash);
+            }
+        }
+
+    }
+#endif
+
+    StringId::StringId(const std::string& text)
+        : StringId(text.data(), text.size())
+    {
+    }
+
+    StringId::StringId(const char* text, size_t length)
+        : m_Hash(HashString(text, length))
+    {
+    #ifdef MRL_DEBUG
+        Record(m_Hash, text, length);
+    #endif
+    }
+
+    StringId StringId::Intern(const char* text)
+    {
+        return StringId(text, strlen(text));
+    }
+
+    const char* StringId::GetString() const
+    {
+    #ifdef MRL_DEBUG
+        {
+            InternTable& table = GetInternTable();
+            std::lock_guard<std::mutex> lock(table.Mutex);
+            auto it = table.Strings.find(m_Hash);
+            if (it != table.Strings.end()) {
+                return it->second.c_str();
+            }
+        }
+    #endif
+        thread_local char text[20];
+        snprintf(text, sizeof(text), "#%016llx", (unsigned long long)m_Hash);
+        return text;
+    }
+
+}
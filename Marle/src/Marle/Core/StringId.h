@@ -0,0 +1,89 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+namespace Marle {
+
+    // 64-bit FNV-1a; usable in constant expressions
+    constexpr uint64_t HashString(const char* text, size_t length)
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < length; ++i) {
+            hash ^= (uint8_t)text[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // A string known only by its hash, for names looked up on hot paths: uniforms, resource
+    // paths, event names. Comparing and hashing are integer operations and nothing is allocated.
+    //
+    // String literals convert implicitly. The hash is computed at compile time when the StringId
+    // is a constant expression: a constexpr variable, or MRL_SID("name") anywhere. Otherwise the
+    // optimizer usually folds it. Runtime strings need the explicit constructor. In debug builds
+    // it records them in an intern table. GetString() reads that table back, and Intern()
+    // reports two different strings with the same hash.
+    class StringId {
+    public:
+        constexpr StringId() = default;
+
+        template<size_t N>
+        constexpr StringId(const char (&text)[N])
+            : m_Hash(HashString(text, Length(text, N)))
+        {
+        }
+
+        explicit StringId(const std::string& text);
+        StringId(const char* text, size_t length);
+
+        static constexpr StringId FromHash(uint64_t hash)
+        {
+            StringId id;
+            id.m_Hash = hash;
+            return id;
+        }
+
+        // Records `text` for GetString() in debug builds, warning on collisions; hashes only in release
+        static StringId Intern(const char* text);
+
+        constexpr uint64_t GetHash() const { return m_Hash; }
+        constexpr bool IsValid() const { return m_Hash != 0; }
+
+        // The interned string, or the hash as "#0123456789abcdef" when it was never interned (or
+        // in release builds). Valid until the next call on the same thread.
+        const char* GetString() const;
+
+        constexpr bool operator==(const StringId& other) const { return m_Hash == other.m_Hash; }
+        constexpr bool operator!=(const StringId& other) const { return m_Hash != other.m_Hash; }
+        constexpr bool operator<(const StringId& other) const { return m_Hash < other.m_Hash; }
+
+    private:
+        // Stops at the first NUL, so char buffers that are not literals hash what they hold
+        static constexpr size_t Length(const char* text, size_t capacity)
+        {
+            size_t length = 0;
+            while (length + 1 < capacity && text[length] != '\0') {
+                length++;
+            }
+            return length;
+        }
+
+        uint64_t m_Hash = 0;
+    };
+
+}
+
+// Forces compile-time hashing of a string literal
+#define MRL_SID(text) (::Marle::StringId::FromHash(std::integral_constant<uint64_t, ::Marle::StringId(text).GetHash()>::value))
+
+namespace std {
+    template<>
+    struct hash<Marle::StringId> {
+        size_t operator()(const Marle::StringId& id) const { return (size_t)id.GetHash(); }
+    };
+}
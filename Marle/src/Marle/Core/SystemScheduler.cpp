@@ -0,0 +1,572 @@
+#include "mrlpch.h"
+#include "SystemScheduler.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#if defined(__GNUC__) || defined(__clang__)
+#include <cxxabi.h>
+#endif
+
+namespace Marle {
+
+    static const uint32_t s_InvalidNode = ~0u;
+    static const double s_AverageWeight = 1.0 / 60.0;
+
+    // System whose update is running on this thread, for ValidateAccess
+    static thread_local SystemId t_CurrentSystem = SystemScheduler::InvalidSystem;
+
+    struct SystemRecord {
+        const char* Name = nullptr;
+        SystemScheduler::UpdateFunc Update;
+        std::vector<uint32_t> Reads;        // Type ids, sorted; types also written are only in Writes
+        std::vector<uint32_t> Writes;
+        std::vector<const char*> After;
+        std::vector<const char*> Before;
+        bool MainThread = false;
+        bool Enabled = true;
+        bool Removed = false;
+        uint64_t LastNs = 0;                // Written by whichever thread ran it
+    };
+
+    struct SystemScheduler::SystemSchedulerData {
+        std::vector<SystemRecord> Systems;
+        std::vector<SystemStats> SystemStatsList;
+        std::unordered_map<std::type_index, uint32_t> TypeIds;
+        std::vector<std::string> TypeNames;    // Readable, for diagnostics
+        bool Dirty = true;
+
+        // Compiled graph over the enabled systems ("nodes", in registration order)
+        std::vector<SystemId> Nodes;
+        std::vector<uint32_t> Order;                // Topological, ties broken by registration
+        std::vector<uint32_t> SuccessorOffsets;     // Node n's successors: [Offsets[n], Offsets[n + 1])
+        std::vector<uint32_t> Successors;
+        std::vector<uint32_t> Indegree;
+
+        // Per step
+        double FixedDt = 0.0;
+        std::unique_ptr<std::atomic<uint32_t>[]> Pending;
+        std::atomic<uint32_t> Remaining{ 0 };
+        std::mutex MainMutex;
+        std::vector<uint32_t> MainReady;
+        std::atomic<uint32_t> MainReadyCount{ 0 };
+
+        std::mutex ReportMutex;
+        std::set<std::pair<SystemId, std::type_index>> Reported;
+
+        Stats CurrentStats;
+    };
+
+    std::unique_ptr<SystemScheduler::SystemSchedulerData> SystemScheduler::s_Data = nullptr;
+
+    static uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void SystemScheduler::Init()
+    {
+        if (s_Data) {
+            return;
+        }
+        s_Data = std::make_unique<SystemSchedulerData>();
+        printf("SystemScheduler initialized\n");
+    }
+
+    void SystemScheduler::Shutdown()
+    {
+        s_Data.reset();
+    }
+
+    bool SystemScheduler::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    static std::string GetTypeName(std::type_index type)
+    {
+    #if defined(__GNUC__) || defined(__clang__)
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(type.name(), nullptr, nullptr, &status);
+        if (status == 0 && demangled) {
+            std::string name = demangled;
+            free(demangled);
+            return name;
+        }
+    #endif
+        return type.name();
+    }
+
+    static uint32_t GetTypeId(std::unordered_map<std::type_index, uint32_t>& ids, std::vector<std::string>& names, std::type_index type)
+    {
+        auto it = ids.find(type);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        uint32_t id = (uint32_t)names.size();
+        ids.emplace(type, id);
+        names.push_back(GetTypeName(type));
+        return id;
+    }
+
+    void SystemScheduler::SystemBuilder::Read(std::type_index type)
+    {
+        s_Data->Systems[m_System].Reads.push_back(GetTypeId(s_Data->TypeIds, s_Data->TypeNames, type));
+    }
+
+    void SystemScheduler::SystemBuilder::Write(std::type_index type)
+    {
+        s_Data->Systems[m_System].Writes.push_back(GetTypeId(s_Data->TypeIds, s_Data->TypeNames, type));
+    }
+
+    void SystemScheduler::SystemBuilder::After(const char* system)
+    {
+        s_Data->Systems[m_System].After.push_back(system);
+    }
+
+    void SystemScheduler::SystemBuilder::Before(const char* system)
+    {
+        s_Data->Systems[m_System].Before.push_back(system);
+    }
+
+    void SystemScheduler::SystemBuilder::SetMainThread()
+    {
+        s_Data->Systems[m_System].MainThread = true;
+    }
+
+    static void SortUnique(std::vector<uint32_t>& values)
+    {
+        std::sort(values.begin(), values.end());
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+    }
+
+    SystemId SystemScheduler::AddSystem(const char* name, const SetupFunc& setup, const UpdateFunc& update)
+    {
+        if (!s_Data) {
+            printf("Error: SystemScheduler::AddSystem('%s') before Init\n", name);
+            return InvalidSystem;
+        }
+
+        SystemId id = (SystemId)s_Data->Systems.size();
+        s_Data->Systems.emplace_back();
+        s_Data->Systems.back().Name = name;
+        s_Data->Systems.back().Update = update;
+
+        SystemBuilder builder(id);
+        if (setup) {
+            setup(builder);
+        }
+
+        SystemRecord& system = s_Data->Systems[id];
+        SortUnique(system.Reads);
+        SortUnique(system.Writes);
+        system.Reads.erase(std::remove_if(system.Reads.begin(), system.Reads.end(), [&system](uint32_t type) {
+            return std::binary_search(system.Writes.begin(), system.Writes.end(), type);
+        }), system.Reads.end());
+
+        SystemStats stats;
+        stats.Name = name;
+        stats.MainThread = system.MainThread;
+        s_Data->SystemStatsList.push_back(stats);
+        s_Data->Dirty = true;
+        return id;
+    }
+
+    void SystemScheduler::RemoveSystem(SystemId system)
+    {
+        if (!s_Data || system >= s_Data->Systems.size()) {
+            return;
+        }
+        SystemRecord& record = s_Data->Systems[system];
+        record.Removed = true;
+        record.Enabled = false;
+        record.Update = nullptr;
+        s_Data->SystemStatsList[system].Enabled = false;
+        s_Data->Dirty = true;
+    }
+
+    void SystemScheduler::SetEnabled(SystemId system, bool enabled)
+    {
+        if (!s_Data || system >= s_Data->Systems.size() || s_Data->Systems[system].Removed) {
+            return;
+        }
+        if (s_Data->Systems[system].Enabled != enabled) {
+            s_Data->Systems[system].Enabled = enabled;
+            s_Data->SystemStatsList[system].Enabled = enabled;
+            s_Data->Dirty = true;
+        }
+    }
+
+    // First type both systems access where at least one of them writes it, or ~0u
+    static uint32_t FindConflict(const SystemRecord& a, const SystemRecord& b)
+    {
+        for (uint32_t type : a.Writes) {
+            if (std::binary_search(b.Writes.begin(), b.Writes.end(), type) || std::binary_search(b.Reads.begin(), b.Reads.end(), type)) {
+                return type;
+            }
+        }
+        for (uint32_t type : b.Writes) {
+            if (std::binary_search(a.Reads.begin(), a.Reads.end(), type)) {
+                return type;
+            }
+        }
+        return ~0u;
+    }
+
+    // Row-per-node bit matrix: Test(a, b) means a runs before b
+    struct ReachMatrix {
+        uint32_t Words = 0;
+        std::vector<uint64_t> Bits;
+
+        void Reset(uint32_t nodes)
+        {
+            Words = (nodes + 63) / 64;
+            Bits.assign((size_t)nodes * Words, 0);
+        }
+        bool Test(uint32_t a, uint32_t b) const { return (Bits[(size_t)a * Words + b / 64] >> (b % 64)) & 1; }
+
+        // Adds a -> b and everything it implies
+        void AddEdge(uint32_t a, uint32_t b, uint32_t nodes)
+        {
+            for (uint32_t x = 0; x < nodes; x++) {
+                if (x != a && !Test(x, a)) {
+                    continue;
+                }
+                uint64_t* row = &Bits[(size_t)x * Words];
+                const uint64_t* from = &Bits[(size_t)b * Words];
+                for (uint32_t w = 0; w < Words; w++) {
+                    row[w] |= from[w];
+                }
+                row[b / 64] |= 1ull << (b % 64);
+            }
+        }
+    };
+
+    bool SystemScheduler::Compile()
+    {
+        SystemSchedulerData& data = *s_Data;
+
+        data.Nodes.clear();
+        std::vector<uint32_t> nodeOf(data.Systems.size(), s_InvalidNode);
+        for (SystemId id = 0; id < data.Systems.size(); id++) {
+            if (data.Systems[id].Enabled) {
+                nodeOf[id] = (uint32_t)data.Nodes.size();
+                data.Nodes.push_back(id);
+            }
+        }
+        const uint32_t count = (uint32_t)data.Nodes.size();
+
+        auto findNode = [&data, &nodeOf](const SystemRecord& from, const char* name) {
+            for (SystemId id = 0; id < data.Systems.size(); id++) {
+                const SystemRecord& other = data.Systems[id];
+                if (!other.Removed && (other.Name == name || strcmp(other.Name, name) == 0)) {
+                    return nodeOf[id];
+                }
+            }
+            printf("Warning: System '%s' is ordered against unknown system '%s'\n", from.Name, name);
+            return s_InvalidNode;
+        };
+
+        // Explicit constraints first; conflicts are then ordered around them
+        std::vector<std::pair<uint32_t, uint32_t>> edges;
+        ReachMatrix reach;
+        reach.Reset(count);
+        bool cycle = false;
+        for (uint32_t node = 0; node < count && !cycle; node++) {
+            const SystemRecord& system = data.Systems[data.Nodes[node]];
+            for (int pass = 0; pass < 2 && !cycle; pass++) {
+                for (const char* name : pass == 0 ? system.After : system.Before) {
+                    uint32_t other = findNode(system, name);
+                    if (other == s_InvalidNode || other == node) {
+                        continue;
+                    }
+                    uint32_t first = pass == 0 ? other : node;
+                    uint32_t second = pass == 0 ? node : other;
+                    if (reach.Test(second, first)) {
+                        printf("Error: Ordering constraints form a cycle through systems '%s' and '%s'; running every system in registration order\n",
+                               data.Systems[data.Nodes[first]].Name, data.Systems[data.Nodes[second]].Name);
+                        cycle = true;
+                        break;
+                    }
+                    edges.push_back({ first, second });
+                    reach.AddEdge(first, second, count);
+                }
+            }
+        }
+
+        uint32_t ambiguities = 0;
+        if (cycle) {
+            edges.clear();
+            for (uint32_t node = 1; node < count; node++) {
+                edges.push_back({ node - 1, node });
+            }
+        } else {
+            const ReachMatrix constrained = reach;
+            for (uint32_t a = 0; a < count; a++) {
+                const SystemRecord& first = data.Systems[data.Nodes[a]];
+                for (uint32_t b = a + 1; b < count; b++) {
+                    const SystemRecord& second = data.Systems[data.Nodes[b]];
+                    uint32_t type = FindConflict(first, second);
+                    if (type == ~0u) {
+                        continue;
+                    }
+                    if (!constrained.Test(a, b) && !constrained.Test(b, a)) {
+                        ambiguities++;
+                    #ifdef MRL_DEBUG
+                        printf("Warning: Systems '%s' and '%s' both access %s with no ordering constraint; '%s' runs first (registration order)\n",
+                               first.Name, second.Name, data.TypeNames[type].c_str(), first.Name);
+                    #endif
+                    }
+                    // Already ordered, directly or through other systems
+                    if (reach.Test(a, b) || reach.Test(b, a)) {
+                        continue;
+                    }
+                    edges.push_back({ a, b });
+                    reach.AddEdge(a, b, count);
+                }
+            }
+        }
+
+        // Successor lists
+        data.Indegree.assign(count, 0);
+        data.SuccessorOffsets.assign(count + 1, 0);
+        for (const auto& edge : edges) {
+            data.SuccessorOffsets[edge.first + 1]++;
+            data.Indegree[edge.second]++;
+        }
+        for (uint32_t node = 0; node < count; node++) {
+            data.SuccessorOffsets[node + 1] += data.SuccessorOffsets[node];
+        }
+        data.Successors.assign(edges.size(), 0);
+        std::vector<uint32_t> cursor(data.SuccessorOffsets.begin(), data.SuccessorOffsets.end() - 1);
+        for (const auto& edge : edges) {
+            data.Successors[cursor[edge.first]++] = edge.second;
+        }
+
+        // Topological order with the lowest ready node first
+        data.Order.clear();
+        std::vector<uint32_t> indegree = data.Indegree;
+        std::vector<uint32_t> ready;
+        std::vector<uint32_t> depth(count, 1);
+        for (uint32_t node = 0; node < count; node++) {
+            if (indegree[node] == 0) {
+                ready.push_back(node);
+            }
+        }
+        uint32_t maxDepth = 0;
+        while (!ready.empty()) {
+            auto lowest = std::min_element(ready.begin(), ready.end());
+            uint32_t node = *lowest;
+            ready.erase(lowest);
+            data.Order.push_back(node);
+            maxDepth = std::max(maxDepth, depth[node]);
+            for (uint32_t i = data.SuccessorOffsets[node]; i < data.SuccessorOffsets[node + 1]; i++) {
+                uint32_t next = data.Successors[i];
+                depth[next] = std::max(depth[next], depth[node] + 1);
+                if (--indegree[next] == 0) {
+                    ready.push_back(next);
+                }
+            }
+        }
+
+        data.Pending.reset(new std::atomic<uint32_t>[count > 0 ? count : 1]);
+        data.MainReady.clear();
+        data.MainReady.reserve(count);
+
+        data.CurrentStats.Systems = count;
+        data.CurrentStats.Dependencies = (uint32_t)edges.size();
+        data.CurrentStats.Ambiguities = ambiguities;
+        data.CurrentStats.Depth = maxDepth;
+        return !cycle;
+    }
+
+    void SystemScheduler::Invoke(uint32_t node)
+    {
+        SystemSchedulerData& data = *s_Data;
+        SystemId id = data.Nodes[node];
+        SystemRecord& system = data.Systems[id];
+
+        // A worker waiting inside one system may run another from the job queue
+        SystemId previous = t_CurrentSystem;
+        uint64_t start = NowNs();
+        t_CurrentSystem = id;
+        system.Update(data.FixedDt);
+        t_CurrentSystem = previous;
+        system.LastNs = NowNs() - start;
+    }
+
+    void SystemScheduler::Dispatch(uint32_t node)
+    {
+        SystemSchedulerData& data = *s_Data;
+        if (data.Systems[data.Nodes[node]].MainThread) {
+            std::lock_guard<std::mutex> lock(data.MainMutex);
+            data.MainReady.push_back(node);
+            data.MainReadyCount.fetch_add(1, std::memory_order_release);
+            return;
+        }
+        JobSystem::Submit([node]() { RunSystem(node); });
+    }
+
+    void SystemScheduler::RunSystem(uint32_t node)
+    {
+        SystemSchedulerData& data = *s_Data;
+        Invoke(node);
+        for (uint32_t i = data.SuccessorOffsets[node]; i < data.SuccessorOffsets[node + 1]; i++) {
+            uint32_t next = data.Successors[i];
+            if (data.Pending[next].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                Dispatch(next);
+            }
+        }
+        data.Remaining.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void SystemScheduler::Execute(double fixed_dt)
+    {
+        if (!s_Data) {
+            return;
+        }
+        SystemSchedulerData& data = *s_Data;
+        if (data.Dirty) {
+            Compile();
+            data.Dirty = false;
+        }
+
+        const uint32_t count = (uint32_t)data.Order.size();
+        uint64_t start = NowNs();
+        data.FixedDt = fixed_dt;
+
+        if (count < 2 || JobSystem::GetWorkerCount() == 0) {
+            for (uint32_t node : data.Order) {
+                Invoke(node);
+            }
+        } else {
+            for (uint32_t node = 0; node < count; node++) {
+                data.Pending[node].store(data.Indegree[node], std::memory_order_relaxed);
+            }
+            data.Remaining.store(count, std::memory_order_release);
+            for (uint32_t node : data.Order) {
+                if (data.Indegree[node] == 0) {
+                    Dispatch(node);
+                }
+            }
+
+            // Main-thread systems run here; otherwise help the workers
+            while (data.Remaining.load(std::memory_order_acquire) != 0) {
+                if (data.MainReadyCount.load(std::memory_order_acquire) != 0) {
+                    uint32_t node;
+                    {
+                        std::lock_guard<std::mutex> lock(data.MainMutex);
+                        node = data.MainReady.back();
+                        data.MainReady.pop_back();
+                        data.MainReadyCount.fetch_sub(1, std::memory_order_relaxed);
+                    }
+                    RunSystem(node);
+                } else if (!JobSystem::RunPendingJob()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        // Timings, and the longest chain through the graph with this step's costs
+        Stats& stats = data.CurrentStats;
+        stats.StepMs = (NowNs() - start) / 1e6;
+        stats.SerialMs = 0.0;
+        stats.CriticalPathMs = 0.0;
+        std::vector<double> earliest(count, 0.0);
+        for (uint32_t node : data.Order) {
+            const SystemRecord& system = data.Systems[data.Nodes[node]];
+            SystemStats& systemStats = data.SystemStatsList[data.Nodes[node]];
+            double ms = system.LastNs / 1e6;
+            systemStats.LastMs = ms;
+            systemStats.AverageMs = systemStats.AverageMs == 0.0 ? ms : systemStats.AverageMs + (ms - systemStats.AverageMs) * s_AverageWeight;
+            systemStats.MaxMs = std::max(systemStats.MaxMs, ms);
+            stats.SerialMs += ms;
+
+            double finish = earliest[node] + ms;
+            stats.CriticalPathMs = std::max(stats.CriticalPathMs, finish);
+            for (uint32_t i = data.SuccessorOffsets[node]; i < data.SuccessorOffsets[node + 1]; i++) {
+                earliest[data.Successors[i]] = std::max(earliest[data.Successors[i]], finish);
+            }
+        }
+    }
+
+    void SystemScheduler::ValidateAccess(std::type_index type, bool write)
+    {
+    #ifdef MRL_DEBUG
+        if (!s_Data || t_CurrentSystem == InvalidSystem) {
+            return;
+        }
+        SystemSchedulerData& data = *s_Data;
+        const SystemRecord& system = data.Systems[t_CurrentSystem];
+
+        auto it = data.TypeIds.find(type);
+        bool declared = false;
+        if (it != data.TypeIds.end()) {
+            declared = std::binary_search(system.Writes.begin(), system.Writes.end(), it->second) ||
+                       (!write && std::binary_search(system.Reads.begin(), system.Reads.end(), it->second));
+        }
+        if (declared) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(data.ReportMutex);
+        if (data.Reported.insert({ t_CurrentSystem, type }).second) {
+            printf("Error: System '%s' %s %s without declaring it\n", system.Name, write ? "writes" : "reads", GetTypeName(type).c_str());
+        }
+    #else
+        (void)type;
+        (void)write;
+    #endif
+    }
+
+    const SystemScheduler::Stats& SystemScheduler::GetStats()
+    {
+        static const Stats empty;
+        return s_Data ? s_Data->CurrentStats : empty;
+    }
+
+    const std::vector<SystemScheduler::SystemStats>& SystemScheduler::GetSystemStats()
+    {
+        static const std::vector<SystemStats> empty;
+        return s_Data ? s_Data->SystemStatsList : empty;
+    }
+
+    void SystemScheduler::PrintStats()
+    {
+        if (!s_Data) {
+            return;
+        }
+        const SystemSchedulerData& data = *s_Data;
+        const Stats& stats = data.CurrentStats;
+
+        printf("SystemScheduler: %u systems, %u dependencies, depth %u, %u ambiguous pairs, %u workers\n", stats.Systems,
+               stats.Dependencies, stats.Depth, stats.Ambiguities, JobSystem::GetWorkerCount());
+        for (uint32_t node : data.Order) {
+            const SystemRecord& system = data.Systems[data.Nodes[node]];
+            const SystemStats& systemStats = data.SystemStatsList[data.Nodes[node]];
+            printf("  %-24s %7.3f ms (avg %.3f, max %.3f)%s", system.Name, systemStats.LastMs, systemStats.AverageMs,
+                   systemStats.MaxMs, system.MainThread ? " [main]" : "");
+            if (data.SuccessorOffsets[node] != data.SuccessorOffsets[node + 1]) {
+                printf(" ->");
+                for (uint32_t i = data.SuccessorOffsets[node]; i < data.SuccessorOffsets[node + 1]; i++) {
+                    printf(" %s", data.Systems[data.Nodes[data.Successors[i]]].Name);
+                }
+            }
+            printf("\n");
+        }
+        for (const SystemRecord& system : data.Systems) {
+            if (!system.Enabled && !system.Removed) {
+                printf("  %-24s (disabled)\n", system.Name);
+            }
+        }
+        printf("  step %.3f ms, serial %.3f ms, critical path %.3f ms\n", stats.StepMs, stats.SerialMs, stats.CriticalPathMs);
+    }
+
+}
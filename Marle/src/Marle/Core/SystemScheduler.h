@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace Marle {
+
+    typedef uint32_t SystemId;
+
+    // Runs the fixed-step update systems, in parallel where their data allows.
+    //
+    // Each system declares in its setup callback which types (components, resources, whole
+    // subsystems such as ParticleSystem) it reads and writes, and optionally which systems it
+    // must run after or before. From that the scheduler builds a dependency graph: two systems
+    // that touch the same type and at least one of them writes it run in registration order
+    // unless a constraint says otherwise, everything else may overlap on the JobSystem workers.
+    // The graph is rebuilt only when systems are added, removed or toggled.
+    //
+    // Debug builds warn about conflicting systems whose order comes from registration alone,
+    // and ValidateAccess reports a system touching a type it never declared.
+    class SystemScheduler {
+    public:
+        static constexpr SystemId InvalidSystem = ~0u;
+
+        class SystemBuilder {
+        public:
+            template<typename T> void Read() { Read(std::type_index(typeid(T))); }
+            template<typename T> void Write() { Write(std::type_index(typeid(T))); }
+            void Read(std::type_index type);
+            void Write(std::type_index type);
+            // Ordering against other systems by name; disabled systems are skipped, unknown names reported
+            void After(const char* system);
+            void Before(const char* system);
+            // For systems that must not leave the main thread (GL, window, platform APIs)
+            void SetMainThread();
+
+        private:
+            friend class SystemScheduler;
+            SystemBuilder(uint32_t system) : m_System(system) {}
+            uint32_t m_System;
+        };
+
+        typedef std::function<void(SystemBuilder&)> SetupFunc;
+        typedef std::function<void(double fixed_dt)> UpdateFunc;
+
+        static void Init();
+        static void Shutdown();
+        static bool IsInitialized();
+
+        // Names must outlive the scheduler (string literals)
+        static SystemId AddSystem(const char* name, const SetupFunc& setup, const UpdateFunc& update);
+        static void RemoveSystem(SystemId system);
+        static void SetEnabled(SystemId system, bool enabled);
+
+        // Runs every enabled system once and returns when all have finished. Called by
+        // Application::Run for each fixed step, before OnUpdate.
+        static void Execute(double fixed_dt);
+
+        // Debug builds: reports (once) when the running system touches a type it did not declare.
+        // Meant for the accessors of shared data, as in ParticleSystem, AnimationSystem,
+        // TransformHierarchy and FlowFieldCache; a no-op in release builds.
+        template<typename T> static void ValidateAccess(bool write)
+        {
+        #ifdef MRL_DEBUG
+            ValidateAccess(std::type_index(typeid(T)), write);
+        #else
+            (void)write;
+        #endif
+        }
+        static void ValidateAccess(std::type_index type, bool write);
+
+        struct SystemStats {
+            const char* Name = nullptr;
+            bool Enabled = true;
+            bool MainThread = false;
+            double LastMs = 0.0;
+            double AverageMs = 0.0;     // Exponential moving average over roughly a second of steps
+            double MaxMs = 0.0;         // Since the system was added
+        };
+
+        struct Stats {
+            uint32_t Systems = 0;           // Enabled
+            uint32_t Dependencies = 0;      // Graph edges
+            uint32_t Ambiguities = 0;       // Conflicting pairs ordered by registration alone
+            uint32_t Depth = 0;             // Systems on the longest dependency chain
+            double StepMs = 0.0;            // Wall time of the last step
+            double SerialMs = 0.0;          // Sum of its system times
+            double CriticalPathMs = 0.0;    // Slowest dependency chain; the floor for StepMs
+        };
+        static const Stats& GetStats();
+        static const std::vector<SystemStats>& GetSystemStats();
+        // Execution order, dependencies and timings of every system
+        static void PrintStats();
+
+    private:
+        static bool Compile();
+        static void Invoke(uint32_t node);
+        static void Dispatch(uint32_t node);
+        static void RunSystem(uint32_t node);
+
+        struct SystemSchedulerData;
+        static std::unique_ptr<SystemSchedulerData> s_Data;
+    };
+
+}
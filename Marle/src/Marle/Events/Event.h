@@ -1,10 +1,12 @@
 #pragma once
 
+#include <cstring>
 #include <string>
 #include <sstream>
 #include <functional>
 #include <iostream>
 #include "Marle/Core.h"
+#include "Marle/Core/StringId.h"
 
 namespace Marle 
 {
@@ -57,7 +59,9 @@ namespace Marle
 	/**/
     #define EVENT_CLASS_TYPE(type) static EventType GetStaticType() { return EventType::type; }\
 								virtual EventType GetEventType() const override { return GetStaticType(); }\
-								virtual const char* GetName() const override { return #type; }
+								virtual const char* GetName() const override { return #type; }\
+								static StringId GetStaticNameId() { return MRL_SID(#type); }\
+								virtual StringId GetNameId() const override { return GetStaticNameId(); }
 
     #define EVENT_CLASS_CATEGORY(category) virtual int GetCategoryFlags() const override { return category; }
 
@@ -95,6 +99,9 @@ namespace Marle
 			/**/
 		    virtual EventType GetEventType() const = 0;
 		    virtual const char* GetName() const = 0;
+		    // GetName() hashed, for keying tables by event name. EVENT_CLASS_TYPE overrides it with
+		    // the compile-time hash; events declared without the macro hash their name here.
+		    virtual StringId GetNameId() const { const char* name = GetName(); return StringId(name, strlen(name)); }
 		    virtual int GetCategoryFlags() const = 0;
 		    virtual std::string ToString() const { return GetName(); }
 
@@ -0,0 +1,490 @@
+#include "mrlpch.h"
+#include "FlowField.h"
+#include "../Core/JobSystem.h"
+#include "../Core/SystemScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <utility>
+
+namespace Marle {
+
+    // Same order as NavGrid's integration: east, then counter-clockwise
+    static const int32_t s_OffsetX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+    static const int32_t s_OffsetY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+    static const glm::vec2 s_Directions[FlowField::NoDirection + 1] = {
+        { 1.0f, 0.0f }, { 0.70710678f, 0.70710678f }, { 0.0f, 1.0f }, { -0.70710678f, 0.70710678f },
+        { -1.0f, 0.0f }, { -0.70710678f, -0.70710678f }, { 0.0f, -1.0f }, { 0.70710678f, -0.70710678f },
+        { 0.0f, 0.0f }
+    };
+
+    static uint8_t DirectionIndex(const glm::ivec2& step)
+    {
+        for (uint8_t direction = 0; direction < 8; direction++) {
+            if (s_OffsetX[direction] == step.x && s_OffsetY[direction] == step.y) {
+                return direction;
+            }
+        }
+        return FlowField::NoDirection;
+    }
+
+    static uint32_t SaturatingAdd(uint32_t a, uint64_t b)
+    {
+        uint64_t sum = (uint64_t)a + b;
+        return sum >= NavGrid::Unreachable ? NavGrid::Unreachable - 1 : (uint32_t)sum;
+    }
+
+    FlowField::FlowField(const NavGrid& grid, const glm::ivec2& goal)
+        : m_Grid(&grid), m_Goal(goal), m_GoalSector(grid.GetSectorIndex(goal))
+    {
+        m_Sectors.resize(grid.GetSectorCount());
+        m_Requested = std::make_unique<std::atomic<uint8_t>[]>(grid.GetSectorCount());
+    }
+
+    glm::vec2 FlowField::GetDirection(const glm::vec2& position) const
+    {
+        glm::ivec2 cell = m_Grid->WorldToCell(position);
+        if (!m_Grid->IsInside(cell)) {
+            return glm::vec2(0.0f);
+        }
+        uint32_t sector = m_Grid->GetSectorIndex(cell);
+        const SectorState& state = m_Sectors[sector];
+        if (state.Slot >= 0) {
+            return s_Directions[m_Directions[(size_t)state.Slot * NavGrid::SectorCells + m_Grid->ToLocal(sector, cell)]];
+        }
+
+        Request(position);
+        if (state.SearchEpoch != m_SearchEpoch || !state.Reachable || cell == m_Goal) {
+            return glm::vec2(0.0f);
+        }
+        glm::vec2 toward = m_Grid->CellToWorld(state.ExitTarget) - position;
+        float length = sqrtf(toward.x * toward.x + toward.y * toward.y);
+        return length > 0.0f ? toward / length : glm::vec2(0.0f);
+    }
+
+    uint32_t FlowField::GetCost(const glm::ivec2& cell) const
+    {
+        if (!m_Grid->IsInside(cell)) {
+            return NavGrid::Unreachable;
+        }
+        uint32_t sector = m_Grid->GetSectorIndex(cell);
+        int32_t slot = m_Sectors[sector].Slot;
+        return slot >= 0 ? m_Integration[(size_t)slot * NavGrid::SectorCells + m_Grid->ToLocal(sector, cell)] : NavGrid::Unreachable;
+    }
+
+    void FlowField::Request(const glm::vec2& position) const
+    {
+        glm::ivec2 cell = m_Grid->WorldToCell(position);
+        if (!m_Grid->IsInside(cell)) {
+            return;
+        }
+        std::atomic<uint8_t>& requested = m_Requested[m_Grid->GetSectorIndex(cell)];
+        if (!requested.load(std::memory_order_relaxed)) {
+            requested.store(1, std::memory_order_relaxed);
+            m_HasRequests.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    size_t FlowField::GetMemorySize() const
+    {
+        return m_Directions.size() + m_Integration.size() * sizeof(uint32_t) + m_NodeDistance.size() * (sizeof(uint32_t) + 1) +
+               m_Open.capacity() * sizeof(OpenNode) + m_Sectors.size() * (sizeof(SectorState) + 1);
+    }
+
+    uint32_t FlowField::Heuristic(const glm::ivec2& cell) const
+    {
+        if (m_SearchTarget.x < 0) {
+            return 0;
+        }
+        // Octile distance at the cheapest cell cost, so the search stays consistent
+        uint32_t dx = (uint32_t)std::abs(cell.x - m_SearchTarget.x);
+        uint32_t dy = (uint32_t)std::abs(cell.y - m_SearchTarget.y);
+        return NavGrid::StepCost * std::max(dx, dy) + (NavGrid::DiagonalStepCost - NavGrid::StepCost) * std::min(dx, dy);
+    }
+
+    void FlowField::SetSearchTarget(const glm::ivec2& cell)
+    {
+        if (cell == m_SearchTarget) {
+            return;
+        }
+        // Re-key the open set for the new target, dropping stale entries on the way
+        m_SearchTarget = cell;
+        const auto& nodes = m_Grid->m_Nodes;
+        size_t kept = 0;
+        for (const OpenNode& entry : m_Open) {
+            if (!m_NodeClosed[entry.Node] && entry.Distance == m_NodeDistance[entry.Node]) {
+                m_Open[kept++] = { entry.Distance + Heuristic(nodes[entry.Node].Anchor), entry.Distance, entry.Node };
+            }
+        }
+        m_Open.resize(kept);
+        std::make_heap(m_Open.begin(), m_Open.end(), std::greater<OpenNode>());
+    }
+
+    void FlowField::BeginSearch()
+    {
+        const NavGrid& grid = *m_Grid;
+        const auto& nodes = grid.m_Nodes;
+        m_SearchedGraphVersion = grid.GetGraphVersion();
+        m_SearchEpoch = std::max(m_SearchEpoch + 1, 1u);
+        m_SearchProgressed = true;
+        m_SearchTarget = glm::ivec2(-1);
+        m_NodeDistance.assign(nodes.size(), NavGrid::Unreachable);
+        m_NodeClosed.assign(nodes.size(), 0);
+        m_Open.clear();
+        m_GoalComponents.clear();
+
+        // Exact costs inside the goal sector seed the portals around it
+        uint32_t integration[NavGrid::SectorCells];
+        NavGrid::Seed goal = { grid.ToLocal(m_GoalSector, m_Goal), 0 };
+        grid.IntegrateSector(m_GoalSector, &goal, 1, integration);
+        for (uint32_t node = grid.m_SectorNodeStart[m_GoalSector]; node < grid.m_SectorNodeStart[m_GoalSector + 1]; node++) {
+            uint32_t cost = integration[grid.ToLocal(m_GoalSector, nodes[node].Anchor)];
+            if (cost != NavGrid::Unreachable) {
+                m_NodeDistance[node] = cost;
+                m_Open.push_back({ cost, cost, node });
+                if (std::find(m_GoalComponents.begin(), m_GoalComponents.end(), grid.m_NodeComponents[node]) == m_GoalComponents.end()) {
+                    m_GoalComponents.push_back(grid.m_NodeComponents[node]);
+                }
+            }
+        }
+        std::make_heap(m_Open.begin(), m_Open.end(), std::greater<OpenNode>());
+    }
+
+    bool FlowField::ResolveSector(uint32_t sector, bool directed)
+    {
+        SectorState& state = m_Sectors[sector];
+        if (state.SearchEpoch == m_SearchEpoch) {
+            return state.Reachable;
+        }
+        state.SearchEpoch = m_SearchEpoch;
+
+        const NavGrid& grid = *m_Grid;
+        const auto& nodes = grid.m_Nodes;
+        uint32_t first = grid.m_SectorNodeStart[sector];
+        uint32_t last = grid.m_SectorNodeStart[sector + 1];
+        // Portals in regions the goal does not connect to would never close
+        auto reached = [this, &grid, &nodes, first, last]() {
+            for (uint32_t node = first; node < last; node++) {
+                uint32_t twin = nodes[node].Twin;
+                uint32_t component = grid.m_NodeComponents[twin];
+                if (!m_NodeClosed[twin] && std::find(m_GoalComponents.begin(), m_GoalComponents.end(), component) != m_GoalComponents.end()) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        if (first != last && !reached()) {
+            glm::ivec2 center = grid.GetSectorOrigin(sector) + glm::ivec2((int32_t)NavGrid::SectorSize / 2);
+            SetSearchTarget(directed ? center : glm::ivec2(-1));
+        }
+
+        // Distances are to the goal, so relaxing from `node` prices the move toward it
+        while (first != last && !reached() && !m_Open.empty()) {
+            std::pop_heap(m_Open.begin(), m_Open.end(), std::greater<OpenNode>());
+            OpenNode entry = m_Open.back();
+            m_Open.pop_back();
+            uint32_t node = entry.Node;
+            if (m_NodeClosed[node] || entry.Distance != m_NodeDistance[node]) {
+                continue;
+            }
+            m_NodeClosed[node] = 1;
+            m_SearchProgressed = true;
+
+            auto relax = [this, &nodes](uint32_t next, uint32_t distance) {
+                if (!m_NodeClosed[next] && distance < m_NodeDistance[next]) {
+                    m_NodeDistance[next] = distance;
+                    m_Open.push_back({ SaturatingAdd(distance, Heuristic(nodes[next].Anchor)), distance, next });
+                    std::push_heap(m_Open.begin(), m_Open.end(), std::greater<OpenNode>());
+                }
+            };
+
+            uint32_t twin = nodes[node].Twin;
+            relax(twin, SaturatingAdd(entry.Distance, (uint64_t)NavGrid::StepCost * grid.GetCost(nodes[twin].Anchor)));
+
+            uint32_t nodeSector = nodes[node].Sector;
+            uint32_t sectorFirst = grid.m_SectorNodeStart[nodeSector];
+            uint32_t count = grid.m_SectorNodeStart[nodeSector + 1] - sectorFirst;
+            const auto& costs = grid.m_SectorCosts[nodeSector];
+            if (costs.size() != (size_t)count * count) {
+                continue;
+            }
+            uint32_t to = node - sectorFirst;
+            for (uint32_t from = 0; from < count; from++) {
+                uint32_t cost = costs[(size_t)from * count + to];
+                if (cost != NavGrid::Unreachable) {
+                    relax(sectorFirst + from, SaturatingAdd(entry.Distance, cost));
+                }
+            }
+        }
+
+        // The sector leaves through the portal whose far side is closest to the goal
+        uint32_t best = NavGrid::Unreachable;
+        for (uint32_t node = first; node < last; node++) {
+            uint32_t twin = nodes[node].Twin;
+            if (m_NodeClosed[twin] && m_NodeDistance[twin] < best) {
+                best = m_NodeDistance[twin];
+                state.ExitTarget = nodes[node].Anchor + nodes[node].Across;
+            }
+        }
+        if (sector == m_GoalSector) {
+            state.ExitTarget = m_Goal;
+        }
+        state.Reachable = sector == m_GoalSector || best != NavGrid::Unreachable;
+        return state.Reachable;
+    }
+
+    uint64_t FlowField::ComputeSeedHash(uint32_t sector) const
+    {
+        const NavGrid& grid = *m_Grid;
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&hash](uint64_t value) {
+            hash ^= value;
+            hash *= 1099511628211ull;
+        };
+        mix(sector == m_GoalSector ? grid.ToLocal(sector, m_Goal) : 0xFFFF);
+        for (uint32_t node = grid.m_SectorNodeStart[sector]; node < grid.m_SectorNodeStart[sector + 1]; node++) {
+            const NavGrid::PortalNode& portal = grid.m_Nodes[node];
+            mix(grid.ToLocal(sector, portal.First) | ((uint64_t)portal.Length << 16) | ((uint64_t)DirectionIndex(portal.Across) << 24));
+            mix(m_NodeClosed[portal.Twin] ? m_NodeDistance[portal.Twin] : NavGrid::Unreachable);
+        }
+        return hash;
+    }
+
+    void FlowField::CollectWork(std::vector<uint32_t>& sectors)
+    {
+        const NavGrid& grid = *m_Grid;
+        m_SearchProgressed = false;
+        if (m_SearchedGraphVersion != grid.GetGraphVersion()) {
+            BeginSearch();
+        }
+
+        std::vector<uint32_t> requests;
+        if (m_HasRequests.exchange(false, std::memory_order_relaxed)) {
+            for (uint32_t sector = 0; sector < m_Sectors.size(); sector++) {
+                if (m_Requested[sector].exchange(0, std::memory_order_relaxed)) {
+                    requests.push_back(sector);
+                }
+            }
+        }
+        // Aiming the search at each sector in turn only pays off for a handful of them
+        bool directed = requests.size() + m_BuiltSectors.size() <= 16;
+
+        size_t previouslyBuilt = m_BuiltSectors.size();
+        for (size_t i = 0; i < previouslyBuilt; i++) {
+            ResolveSector(m_BuiltSectors[i], directed);
+        }
+
+        // Agents in a requested sector will walk the corridor to the goal, so build it all now
+        uint32_t sectorCount = (uint32_t)m_Sectors.size();
+        for (uint32_t requested : requests) {
+            uint32_t sector = requested;
+            for (uint32_t step = 0; step < sectorCount && ResolveSector(sector, directed); step++) {
+                SectorState& state = m_Sectors[sector];
+                if (state.Slot < 0) {
+                    state.Slot = (int32_t)m_BuiltSectors.size();
+                    m_BuiltSectors.push_back(sector);
+                    sectors.push_back(sector);
+                }
+                if (sector == m_GoalSector) {
+                    break;
+                }
+                sector = grid.GetSectorIndex(state.ExitTarget);
+            }
+        }
+
+        // Built sectors change with their cells, or with the portal distances around them
+        for (size_t i = 0; i < previouslyBuilt; i++) {
+            uint32_t sector = m_BuiltSectors[i];
+            const SectorState& state = m_Sectors[sector];
+            if (state.Version != grid.GetSectorVersion(sector) || (m_SearchProgressed && state.SeedHash != ComputeSeedHash(sector))) {
+                sectors.push_back(sector);
+            }
+        }
+
+        m_Directions.resize(m_BuiltSectors.size() * NavGrid::SectorCells, NoDirection);
+        m_Integration.resize(m_BuiltSectors.size() * NavGrid::SectorCells, NavGrid::Unreachable);
+    }
+
+    void FlowField::BuildSector(uint32_t sector)
+    {
+        const NavGrid& grid = *m_Grid;
+        SectorState& state = m_Sectors[sector];
+        glm::ivec2 origin = grid.GetSectorOrigin(sector);
+
+        // Cells along each exit start at the cost of the portal's far side, so the wave inside
+        // the sector continues the abstract path. Where an exit seed is the best a cell can
+        // do, its direction points straight across the edge.
+        thread_local std::vector<NavGrid::Seed> seeds;
+        seeds.clear();
+        uint32_t exitCost[NavGrid::SectorCells];
+        uint8_t exitDirection[NavGrid::SectorCells];
+        std::fill(exitCost, exitCost + NavGrid::SectorCells, NavGrid::Unreachable);
+
+        if (sector == m_GoalSector) {
+            seeds.push_back({ grid.ToLocal(sector, m_Goal), 0 });
+        }
+        for (uint32_t node = grid.m_SectorNodeStart[sector]; node < grid.m_SectorNodeStart[sector + 1]; node++) {
+            const NavGrid::PortalNode& portal = grid.m_Nodes[node];
+            if (!m_NodeClosed[portal.Twin]) {
+                continue; // Not known exactly yet; the search only closed what it needed
+            }
+            uint32_t distance = m_NodeDistance[portal.Twin];
+            int32_t middle = portal.Length / 2;
+            uint8_t direction = DirectionIndex(portal.Across);
+            for (int32_t i = 0; i < portal.Length; i++) {
+                glm::ivec2 cell = portal.First + portal.Along * i;
+                uint16_t local = grid.ToLocal(sector, cell);
+                // Leaving this cell, then along the far side to the twin's anchor
+                uint64_t extra = (uint64_t)NavGrid::StepCost * grid.GetCost(cell) + (uint64_t)NavGrid::StepCost * (uint32_t)std::abs(i - middle);
+                uint32_t value = SaturatingAdd(distance, extra);
+                if (value < exitCost[local]) {
+                    exitCost[local] = value;
+                    exitDirection[local] = direction;
+                    seeds.push_back({ local, value });
+                }
+            }
+        }
+
+        uint32_t* integration = m_Integration.data() + (size_t)state.Slot * NavGrid::SectorCells;
+        uint8_t* directions = m_Directions.data() + (size_t)state.Slot * NavGrid::SectorCells;
+        grid.IntegrateSector(sector, seeds.data(), (uint32_t)seeds.size(), integration);
+
+        for (uint32_t y = 0; y < NavGrid::SectorSize; y++) {
+            for (uint32_t x = 0; x < NavGrid::SectorSize; x++) {
+                uint32_t local = x + y * NavGrid::SectorSize;
+                uint32_t value = integration[local];
+                if (value == NavGrid::Unreachable || value == 0) {
+                    directions[local] = NoDirection; // Unreachable, blocked or the goal itself
+                    continue;
+                }
+                if (value == exitCost[local]) {
+                    directions[local] = exitDirection[local];
+                    continue;
+                }
+
+                // Steepest descent among the neighbours this cell can actually step to
+                uint8_t best = NoDirection;
+                uint32_t lowest = value;
+                glm::ivec2 cell = origin + glm::ivec2((int32_t)x, (int32_t)y);
+                for (uint8_t direction = 0; direction < 8; direction++) {
+                    int32_t nx = (int32_t)x + s_OffsetX[direction];
+                    int32_t ny = (int32_t)y + s_OffsetY[direction];
+                    if (nx < 0 || ny < 0 || nx >= (int32_t)NavGrid::SectorSize || ny >= (int32_t)NavGrid::SectorSize) {
+                        continue;
+                    }
+                    if ((direction & 1) && (!grid.IsWalkable(cell + glm::ivec2(s_OffsetX[direction], 0)) ||
+                                            !grid.IsWalkable(cell + glm::ivec2(0, s_OffsetY[direction])))) {
+                        continue;
+                    }
+                    uint32_t neighbour = integration[nx + ny * NavGrid::SectorSize];
+                    if (neighbour < lowest) {
+                        lowest = neighbour;
+                        best = direction;
+                    }
+                }
+                directions[local] = best;
+            }
+        }
+
+        state.Version = grid.GetSectorVersion(sector);
+        state.SeedHash = ComputeSeedHash(sector);
+    }
+
+    FlowFieldCache::FlowFieldCache(NavGrid& grid, uint32_t idleCapacity)
+        : m_Grid(grid), m_IdleCapacity(idleCapacity)
+    {
+        m_Grid.Rebuild();
+    }
+
+    std::shared_ptr<const FlowField> FlowFieldCache::GetField(const glm::ivec2& goal)
+    {
+        SystemScheduler::ValidateAccess<FlowFieldCache>(true);
+        if (!m_Grid.IsWalkable(goal)) {
+            printf("Warning: Flow field goal (%d, %d) is blocked or outside the grid\n", goal.x, goal.y);
+            return nullptr;
+        }
+        for (const std::shared_ptr<FlowField>& field : m_Fields) {
+            if (field->m_Goal == goal) {
+                field->m_LastUsed = m_UpdateIndex;
+                return field;
+            }
+        }
+
+        std::shared_ptr<FlowField> field(new FlowField(m_Grid, goal));
+        field->BeginSearch();
+        field->m_LastUsed = m_UpdateIndex;
+        m_Fields.push_back(field);
+        return field;
+    }
+
+    void FlowFieldCache::Update()
+    {
+        SystemScheduler::ValidateAccess<FlowFieldCache>(true);
+        auto start = std::chrono::steady_clock::now();
+        m_UpdateIndex++;
+
+        // Fields only the cache still holds are idle; past the capacity the stalest go first
+        uint32_t idle = 0;
+        for (const std::shared_ptr<FlowField>& field : m_Fields) {
+            if (field.use_count() > 1) {
+                field->m_LastUsed = m_UpdateIndex;
+            } else {
+                idle++;
+            }
+        }
+        if (idle > m_IdleCapacity) {
+            std::vector<std::shared_ptr<FlowField>> sorted = m_Fields;
+            std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) { return a->m_LastUsed < b->m_LastUsed; });
+            uint32_t evict = idle - m_IdleCapacity;
+            for (const std::shared_ptr<FlowField>& field : sorted) {
+                if (evict == 0) {
+                    break;
+                }
+                if (field.use_count() == 2) { // m_Fields and `sorted`
+                    m_Fields.erase(std::find(m_Fields.begin(), m_Fields.end(), field));
+                    evict--;
+                }
+            }
+        }
+
+        m_Grid.Rebuild();
+
+        // Searches are independent per field; each field then lists the sectors it needs built
+        std::vector<std::vector<uint32_t>> work(m_Fields.size());
+        JobSystem::ParallelFor((uint32_t)m_Fields.size(), 1, [this, &work](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                m_Fields[i]->CollectWork(work[i]);
+            }
+        });
+        auto searched = std::chrono::steady_clock::now();
+
+        std::vector<std::pair<FlowField*, uint32_t>> builds;
+        for (size_t i = 0; i < m_Fields.size(); i++) {
+            for (uint32_t sector : work[i]) {
+                builds.push_back({ m_Fields[i].get(), sector });
+            }
+        }
+        JobSystem::ParallelFor((uint32_t)builds.size(), 4, [&builds](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                builds[i].first->BuildSector(builds[i].second);
+            }
+        });
+        auto built = std::chrono::steady_clock::now();
+
+        m_Stats.Fields = (uint32_t)m_Fields.size();
+        m_Stats.BuiltSectors = 0;
+        m_Stats.MemoryBytes = 0;
+        for (const std::shared_ptr<FlowField>& field : m_Fields) {
+            m_Stats.BuiltSectors += field->GetBuiltSectorCount();
+            m_Stats.MemoryBytes += field->GetMemorySize();
+        }
+        m_Stats.RebuiltSectors = (uint32_t)builds.size();
+        m_Stats.Portals = m_Grid.GetPortalCount();
+        m_Stats.SearchMs = std::chrono::duration<double, std::milli>(searched - start).count();
+        m_Stats.BuildMs = std::chrono::duration<double, std::milli>(built - searched).count();
+    }
+
+}
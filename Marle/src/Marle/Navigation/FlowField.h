@@ -0,0 +1,137 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "NavGrid.h"
+#include <glm/glm.hpp>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace Marle {
+
+    // Directions toward one goal cell, shared by every agent heading there. Nothing is computed
+    // up front. When agents look up a sector, an A* search over the portal graph runs backwards
+    // from the goal until it has reached every portal around that sector. Integration costs and
+    // directions are then built for the sector and for every sector between it and the goal. A
+    // goal across a huge map therefore only costs the corridor that is actually used.
+    //
+    // Lookups are O(1) and may run on any thread between FlowFieldCache::Update calls. A lookup
+    // in a sector that is not built yet queues it for the next Update. It returns a coarse
+    // heading toward the sector's exit if the search has already passed through, else zero.
+    class FlowField {
+    public:
+        static constexpr uint8_t NoDirection = 8;
+
+        const glm::ivec2& GetGoal() const { return m_Goal; }
+
+        // Unit vector toward the goal; zero at the goal, on blocked cells and where it cannot be reached
+        glm::vec2 GetDirection(const glm::vec2& position) const;
+        // Travel cost to the goal in NavGrid integration units; Unreachable where not built (yet)
+        uint32_t GetCost(const glm::ivec2& cell) const;
+        // Builds the sector around `position` on the next Update, e.g. before agents spawn there
+        void Request(const glm::vec2& position) const;
+
+        uint32_t GetBuiltSectorCount() const { return (uint32_t)m_BuiltSectors.size(); }
+        size_t GetMemorySize() const;
+
+    private:
+        friend class FlowFieldCache;
+
+        struct SectorState {
+            int32_t Slot = -1;                  // Into m_Directions / m_Integration, -1 until built
+            uint32_t SearchEpoch = 0;           // Exit below is valid when this matches m_SearchEpoch
+            bool Reachable = false;
+            glm::ivec2 ExitTarget = glm::ivec2(0); // Cell just past the best exit, for coarse lookups
+            uint32_t Version = 0;               // NavGrid sector version it was built from
+            uint64_t SeedHash = 0;              // Portal distances it was built from
+        };
+
+        struct OpenNode {
+            uint32_t Priority;                  // Distance plus heuristic
+            uint32_t Distance;
+            uint32_t Node;
+            bool operator>(const OpenNode& other) const { return Priority > other.Priority; }
+        };
+
+        FlowField(const NavGrid& grid, const glm::ivec2& goal);
+
+        // Restarts the portal search from the goal sector (new field or changed portal graph)
+        void BeginSearch();
+        // Continues the search until every portal around `sector` that can reach the goal is
+        // closed, then picks the sector's exit: the portal whose far side is closest to the goal.
+        // Closed portals have exact distances; the heuristic only decides what else gets closed.
+        bool ResolveSector(uint32_t sector, bool directed);
+        void SetSearchTarget(const glm::ivec2& cell);
+        // Sectors to (re)build this update: requested ones, the corridor from them to the goal,
+        // and built ones whose cells or portal distances changed. Allocates their slots.
+        void CollectWork(std::vector<uint32_t>& sectors);
+        // Integration and directions of one sector; sectors of one field may build in parallel
+        void BuildSector(uint32_t sector);
+        uint64_t ComputeSeedHash(uint32_t sector) const;
+        uint32_t Heuristic(const glm::ivec2& cell) const;
+
+        const NavGrid* m_Grid;
+        glm::ivec2 m_Goal;
+        uint32_t m_GoalSector;
+        uint64_t m_SearchedGraphVersion = ~0ull;
+        uint64_t m_LastUsed = 0;
+
+        // Portal search state, kept between updates so it resumes where it stopped
+        uint32_t m_SearchEpoch = 0;
+        bool m_SearchProgressed = false;
+        glm::ivec2 m_SearchTarget = glm::ivec2(-1);
+        std::vector<uint32_t> m_NodeDistance;   // Per NavGrid portal node; exact once closed
+        std::vector<uint8_t> m_NodeClosed;
+        std::vector<OpenNode> m_Open;           // Min-heap on Priority
+        std::vector<uint32_t> m_GoalComponents; // NavGrid components the goal connects to
+        std::vector<SectorState> m_Sectors;
+        std::vector<uint32_t> m_BuiltSectors;
+        std::unique_ptr<std::atomic<uint8_t>[]> m_Requested;
+        mutable std::atomic<bool> m_HasRequests{ false };
+
+        TaggedVector<uint8_t, MemoryTag::Navigation> m_Directions;     // NavGrid::SectorCells per slot
+        TaggedVector<uint32_t, MemoryTag::Navigation> m_Integration;
+    };
+
+    // Owns the flow fields of one NavGrid, one per goal cell. Fields nobody holds any more are
+    // kept for reuse until more than `idleCapacity` of them pile up. Update() applies grid edits
+    // and brings every field up to date, rebuilding only the sectors whose cells or portal
+    // distances changed; it runs the searches and sector builds in parallel on the JobSystem.
+    class FlowFieldCache {
+    public:
+        explicit FlowFieldCache(NavGrid& grid, uint32_t idleCapacity = 8);
+
+        FlowFieldCache(const FlowFieldCache&) = delete;
+        FlowFieldCache& operator=(const FlowFieldCache&) = delete;
+
+        // Field toward `goal`, shared with everyone else asking for the same cell. Directions
+        // appear from the next Update on. nullptr if the goal is outside the grid or blocked.
+        std::shared_ptr<const FlowField> GetField(const glm::ivec2& goal);
+        std::shared_ptr<const FlowField> GetField(const glm::vec2& goalPosition) { return GetField(m_Grid.WorldToCell(goalPosition)); }
+
+        // Once per fixed step, before agents look up directions; must not overlap lookups
+        void Update();
+
+        NavGrid& GetGrid() { return m_Grid; }
+
+        struct Stats {
+            uint32_t Fields = 0;
+            uint32_t BuiltSectors = 0;          // Across all fields
+            uint32_t RebuiltSectors = 0;        // Built by the last Update
+            uint32_t Portals = 0;
+            double SearchMs = 0.0;              // Grid rebuild and portal searches
+            double BuildMs = 0.0;               // Sector integration and directions
+            size_t MemoryBytes = 0;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        NavGrid& m_Grid;
+        uint32_t m_IdleCapacity;
+        uint64_t m_UpdateIndex = 0;
+        std::vector<std::shared_ptr<FlowField>> m_Fields;
+        Stats m_Stats;
+    };
+
+}
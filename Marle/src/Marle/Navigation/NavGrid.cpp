@@ -0,0 +1,348 @@
+#include "mrlpch.h"
+#include "NavGrid.h"
+#include "../Core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace Marle {
+
+    NavGrid::NavGrid(uint32_t width, uint32_t height, float cellSize, const glm::vec2& origin)
+        : m_Width(std::max(width, 1u)), m_Height(std::max(height, 1u)), m_CellSize(cellSize), m_Origin(origin)
+    {
+        m_SectorsX = (m_Width + SectorSize - 1) / SectorSize;
+        m_SectorsY = (m_Height + SectorSize - 1) / SectorSize;
+        m_Costs.assign((size_t)m_Width * m_Height, 1);
+
+        uint32_t sectors = GetSectorCount();
+        m_SectorVersions.assign(sectors, 0);
+        m_SectorDirty.assign(sectors, 1);
+        m_EastSpans.resize(sectors);
+        m_NorthSpans.resize(sectors);
+        m_SectorCosts.resize(sectors);
+        m_DirtySectors.reserve(sectors);
+        for (uint32_t sector = 0; sector < sectors; sector++) {
+            m_DirtySectors.push_back(sector);
+        }
+    }
+
+    void NavGrid::SetCost(uint32_t x, uint32_t y, uint8_t cost)
+    {
+        if (x >= m_Width || y >= m_Height) {
+            return;
+        }
+        cost = std::max<uint8_t>(cost, 1);
+        uint8_t& current = m_Costs[(size_t)y * m_Width + x];
+        if (current == cost) {
+            return;
+        }
+        current = cost;
+
+        uint32_t sector = GetSectorIndex({ (int32_t)x, (int32_t)y });
+        m_SectorVersions[sector]++;
+        if (!m_SectorDirty[sector]) {
+            m_SectorDirty[sector] = 1;
+            m_DirtySectors.push_back(sector);
+        }
+    }
+
+    void NavGrid::FillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t cost)
+    {
+        for (uint32_t row = y; row < std::min(y + height, m_Height); row++) {
+            for (uint32_t column = x; column < std::min(x + width, m_Width); column++) {
+                SetCost(column, row, cost);
+            }
+        }
+    }
+
+    glm::ivec2 NavGrid::WorldToCell(const glm::vec2& position) const
+    {
+        return { (int32_t)floorf((position.x - m_Origin.x) / m_CellSize), (int32_t)floorf((position.y - m_Origin.y) / m_CellSize) };
+    }
+
+    glm::vec2 NavGrid::CellToWorld(const glm::ivec2& cell) const
+    {
+        return { m_Origin.x + ((float)cell.x + 0.5f) * m_CellSize, m_Origin.y + ((float)cell.y + 0.5f) * m_CellSize };
+    }
+
+    glm::ivec2 NavGrid::GetSectorOrigin(uint32_t sector) const
+    {
+        return { (int32_t)((sector % m_SectorsX) * SectorSize), (int32_t)((sector / m_SectorsX) * SectorSize) };
+    }
+
+    uint16_t NavGrid::ToLocal(uint32_t sector, const glm::ivec2& cell) const
+    {
+        glm::ivec2 origin = GetSectorOrigin(sector);
+        return (uint16_t)((cell.x - origin.x) + (cell.y - origin.y) * SectorSize);
+    }
+
+    void NavGrid::IntegrateSector(uint32_t sector, const Seed* seeds, uint32_t seedCount, uint32_t* integration) const
+    {
+        static const int32_t s_OffsetX[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+        static const int32_t s_OffsetY[8] = { 0, 1, 1, 1, 0, -1, -1, -1 };
+
+        // Sector-local copy of the costs, with everything outside the grid blocked
+        glm::ivec2 origin = GetSectorOrigin(sector);
+        uint8_t costs[SectorCells];
+        for (uint32_t y = 0; y < SectorSize; y++) {
+            for (uint32_t x = 0; x < SectorSize; x++) {
+                costs[x + y * SectorSize] = GetCost({ origin.x + (int32_t)x, origin.y + (int32_t)y });
+            }
+        }
+
+        std::fill(integration, integration + SectorCells, Unreachable);
+        thread_local std::vector<std::pair<uint32_t, uint16_t>> heap;
+        heap.clear();
+        auto later = [](const std::pair<uint32_t, uint16_t>& a, const std::pair<uint32_t, uint16_t>& b) { return a.first > b.first; };
+
+        for (uint32_t i = 0; i < seedCount; i++) {
+            const Seed& seed = seeds[i];
+            if (seed.Cell < SectorCells && costs[seed.Cell] != Blocked && seed.Value < integration[seed.Cell]) {
+                integration[seed.Cell] = seed.Value;
+                heap.push_back({ seed.Value, seed.Cell });
+                std::push_heap(heap.begin(), heap.end(), later);
+            }
+        }
+
+        while (!heap.empty()) {
+            std::pop_heap(heap.begin(), heap.end(), later);
+            auto [value, cell] = heap.back();
+            heap.pop_back();
+            if (value != integration[cell]) {
+                continue; // Stale entry
+            }
+
+            int32_t x = cell % SectorSize;
+            int32_t y = cell / SectorSize;
+            for (uint32_t direction = 0; direction < 8; direction++) {
+                int32_t nx = x + s_OffsetX[direction];
+                int32_t ny = y + s_OffsetY[direction];
+                if (nx < 0 || ny < 0 || nx >= (int32_t)SectorSize || ny >= (int32_t)SectorSize) {
+                    continue;
+                }
+                uint16_t next = (uint16_t)(nx + ny * SectorSize);
+                if (costs[next] == Blocked) {
+                    continue;
+                }
+                bool diagonal = direction & 1;
+                if (diagonal && (costs[nx + y * SectorSize] == Blocked || costs[x + ny * SectorSize] == Blocked)) {
+                    continue; // No cutting corners past walls
+                }
+                uint64_t candidate = (uint64_t)value + (diagonal ? DiagonalStepCost : StepCost) * costs[next];
+                if (candidate < integration[next]) {
+                    integration[next] = (uint32_t)candidate;
+                    heap.push_back({ (uint32_t)candidate, next });
+                    std::push_heap(heap.begin(), heap.end(), later);
+                }
+            }
+        }
+    }
+
+    bool NavGrid::UpdateEdgeSpans(std::vector<PortalSpan>& spans, glm::ivec2 first, glm::ivec2 along, glm::ivec2 across)
+    {
+        std::vector<PortalSpan> updated;
+        uint32_t runStart = 0;
+        bool inRun = false;
+        for (uint32_t i = 0; i <= SectorSize; i++) {
+            glm::ivec2 cell = first + along * (int32_t)i;
+            bool open = i < SectorSize && IsWalkable(cell) && IsWalkable(cell + across);
+            if (open && !inRun) {
+                runStart = i;
+                inRun = true;
+            } else if (!open && inRun) {
+                updated.push_back({ (uint8_t)runStart, (uint8_t)(i - runStart) });
+                inRun = false;
+            }
+        }
+        if (updated == spans) {
+            return false;
+        }
+        spans.swap(updated);
+        return true;
+    }
+
+    const std::vector<NavGrid::PortalSpan>* NavGrid::GetSideSpans(uint32_t sector, Side side) const
+    {
+        uint32_t x = sector % m_SectorsX;
+        uint32_t y = sector / m_SectorsX;
+        switch (side) {
+            case East: return x + 1 < m_SectorsX ? &m_EastSpans[sector] : nullptr;
+            case North: return y + 1 < m_SectorsY ? &m_NorthSpans[sector] : nullptr;
+            case West: return x > 0 ? &m_EastSpans[sector - 1] : nullptr;
+            case South: return y > 0 ? &m_NorthSpans[sector - m_SectorsX] : nullptr;
+            default: return nullptr;
+        }
+    }
+
+    void NavGrid::RebuildNodes()
+    {
+        static const glm::ivec2 s_Along[SideCount] = { { 0, 1 }, { 1, 0 }, { 0, 1 }, { 1, 0 } };
+        static const glm::ivec2 s_Across[SideCount] = { { 1, 0 }, { 0, 1 }, { -1, 0 }, { 0, -1 } };
+        const int32_t last = (int32_t)SectorSize - 1;
+        const glm::ivec2 edgeOrigin[SideCount] = { { last, 0 }, { 0, last }, { 0, 0 }, { 0, 0 } };
+
+        uint32_t sectors = GetSectorCount();
+        m_Nodes.clear();
+        m_SectorNodeStart.assign(sectors + 1, 0);
+        // First node of each sector side, to pair up twins afterwards
+        std::vector<uint32_t> sideStart((size_t)sectors * SideCount);
+
+        for (uint32_t sector = 0; sector < sectors; sector++) {
+            m_SectorNodeStart[sector] = (uint32_t)m_Nodes.size();
+            glm::ivec2 origin = GetSectorOrigin(sector);
+            for (uint32_t side = 0; side < SideCount; side++) {
+                sideStart[(size_t)sector * SideCount + side] = (uint32_t)m_Nodes.size();
+                const std::vector<PortalSpan>* spans = GetSideSpans(sector, (Side)side);
+                if (!spans) {
+                    continue;
+                }
+                for (const PortalSpan& span : *spans) {
+                    PortalNode node;
+                    node.Along = s_Along[side];
+                    node.Across = s_Across[side];
+                    node.First = origin + edgeOrigin[side] + node.Along * (int32_t)span.Start;
+                    node.Anchor = node.First + node.Along * (int32_t)(span.Length / 2);
+                    node.Sector = sector;
+                    node.Twin = 0;
+                    node.Length = span.Length;
+                    m_Nodes.push_back(node);
+                }
+            }
+        }
+        m_SectorNodeStart[sectors] = (uint32_t)m_Nodes.size();
+
+        // East spans of a sector are the West spans of the next one, North the South of the one above
+        for (uint32_t sector = 0; sector < sectors; sector++) {
+            uint32_t x = sector % m_SectorsX;
+            uint32_t y = sector / m_SectorsX;
+            if (x + 1 < m_SectorsX) {
+                uint32_t mine = sideStart[(size_t)sector * SideCount + East];
+                uint32_t theirs = sideStart[(size_t)(sector + 1) * SideCount + West];
+                for (uint32_t i = 0; i < m_EastSpans[sector].size(); i++) {
+                    m_Nodes[mine + i].Twin = theirs + i;
+                    m_Nodes[theirs + i].Twin = mine + i;
+                }
+            }
+            if (y + 1 < m_SectorsY) {
+                uint32_t mine = sideStart[(size_t)sector * SideCount + North];
+                uint32_t theirs = sideStart[(size_t)(sector + m_SectorsX) * SideCount + South];
+                for (uint32_t i = 0; i < m_NorthSpans[sector].size(); i++) {
+                    m_Nodes[mine + i].Twin = theirs + i;
+                    m_Nodes[theirs + i].Twin = mine + i;
+                }
+            }
+        }
+    }
+
+    void NavGrid::ComputeSectorCosts(uint32_t sector)
+    {
+        uint32_t first = m_SectorNodeStart[sector];
+        uint32_t count = m_SectorNodeStart[sector + 1] - first;
+        TaggedVector<uint32_t, MemoryTag::Navigation>& costs = m_SectorCosts[sector];
+        costs.assign((size_t)count * count, Unreachable);
+
+        uint32_t integration[SectorCells];
+        for (uint32_t to = 0; to < count; to++) {
+            Seed seed = { ToLocal(sector, m_Nodes[first + to].Anchor), 0 };
+            IntegrateSector(sector, &seed, 1, integration);
+            for (uint32_t from = 0; from < count; from++) {
+                costs[(size_t)from * count + to] = integration[ToLocal(sector, m_Nodes[first + from].Anchor)];
+            }
+        }
+    }
+
+    bool NavGrid::Rebuild()
+    {
+        if (m_DirtySectors.empty()) {
+            return false;
+        }
+
+        // A changed sector can change the portals it shares with its neighbours, whose portal
+        // costs then need recomputing too
+        std::vector<uint8_t> recost(GetSectorCount(), 0);
+        const int32_t last = (int32_t)SectorSize - 1;
+        for (uint32_t sector : m_DirtySectors) {
+            m_SectorDirty[sector] = 0;
+            recost[sector] = 1;
+            uint32_t x = sector % m_SectorsX;
+            uint32_t y = sector / m_SectorsX;
+            glm::ivec2 origin = GetSectorOrigin(sector);
+            if (x + 1 < m_SectorsX && UpdateEdgeSpans(m_EastSpans[sector], origin + glm::ivec2(last, 0), { 0, 1 }, { 1, 0 })) {
+                recost[sector + 1] = 1;
+            }
+            if (y + 1 < m_SectorsY && UpdateEdgeSpans(m_NorthSpans[sector], origin + glm::ivec2(0, last), { 1, 0 }, { 0, 1 })) {
+                recost[sector + m_SectorsX] = 1;
+            }
+            if (x > 0 && UpdateEdgeSpans(m_EastSpans[sector - 1], origin + glm::ivec2(-1, 0), { 0, 1 }, { 1, 0 })) {
+                recost[sector - 1] = 1;
+            }
+            if (y > 0 && UpdateEdgeSpans(m_NorthSpans[sector - m_SectorsX], origin + glm::ivec2(0, -1), { 1, 0 }, { 0, 1 })) {
+                recost[sector - m_SectorsX] = 1;
+            }
+        }
+        m_DirtySectors.clear();
+
+        RebuildNodes();
+
+        std::vector<uint32_t> sectors;
+        for (uint32_t sector = 0; sector < recost.size(); sector++) {
+            if (recost[sector]) {
+                sectors.push_back(sector);
+            }
+        }
+        JobSystem::ParallelFor((uint32_t)sectors.size(), 8, [this, &sectors](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                ComputeSectorCosts(sectors[i]);
+            }
+        });
+
+        LabelComponents();
+        m_GraphVersion++;
+        return true;
+    }
+
+    void NavGrid::LabelComponents()
+    {
+        // Union-find over portal crossings and the connected pairs inside each sector
+        std::vector<uint32_t>& parents = m_NodeComponents;
+        parents.resize(m_Nodes.size());
+        for (uint32_t node = 0; node < parents.size(); node++) {
+            parents[node] = node;
+        }
+        auto find = [&parents](uint32_t node) {
+            while (parents[node] != node) {
+                parents[node] = parents[parents[node]];
+                node = parents[node];
+            }
+            return node;
+        };
+        auto unite = [&find, &parents](uint32_t a, uint32_t b) {
+            a = find(a);
+            b = find(b);
+            if (a != b) {
+                parents[std::max(a, b)] = std::min(a, b);
+            }
+        };
+
+        for (uint32_t node = 0; node < m_Nodes.size(); node++) {
+            unite(node, m_Nodes[node].Twin);
+        }
+        for (uint32_t sector = 0; sector < GetSectorCount(); sector++) {
+            uint32_t first = m_SectorNodeStart[sector];
+            uint32_t count = m_SectorNodeStart[sector + 1] - first;
+            const auto& costs = m_SectorCosts[sector];
+            for (uint32_t from = 0; from < count; from++) {
+                for (uint32_t to = from + 1; to < count; to++) {
+                    if (costs[(size_t)from * count + to] != Unreachable) {
+                        unite(first + from, first + to);
+                    }
+                }
+            }
+        }
+        for (uint32_t node = 0; node < parents.size(); node++) {
+            parents[node] = find(node);
+        }
+    }
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    // Walkable grid for flow-field pathfinding, split into square sectors. Each cell holds a
+    // movement cost: 1 is open ground and Blocked cannot be entered. Along every sector edge the
+    // grid keeps the open spans (portals) where agents can cross into the neighbouring sector.
+    // Each sector also caches the travel cost between its own portals. Together these form a
+    // small abstract graph, which FlowField searches to find the sectors a path goes through.
+    // Changing cells only marks their sector dirty; Rebuild() recomputes the dirty sectors.
+    class NavGrid {
+    public:
+        static constexpr uint32_t SectorSize = 16;
+        static constexpr uint32_t SectorCells = SectorSize * SectorSize;
+        static constexpr uint8_t Blocked = 255;
+        static constexpr uint32_t Unreachable = ~0u;
+        // Integration units per step, multiplied by the cost of the cell being left
+        static constexpr uint32_t StepCost = 10;
+        static constexpr uint32_t DiagonalStepCost = 14;
+
+        NavGrid(uint32_t width, uint32_t height, float cellSize = 1.0f, const glm::vec2& origin = glm::vec2(0.0f));
+
+        // 1..254 for walkable cells, Blocked for walls
+        void SetCost(uint32_t x, uint32_t y, uint8_t cost);
+        void FillRect(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint8_t cost);
+        uint8_t GetCost(const glm::ivec2& cell) const { return IsInside(cell) ? m_Costs[(size_t)cell.y * m_Width + cell.x] : Blocked; }
+        bool IsWalkable(const glm::ivec2& cell) const { return GetCost(cell) != Blocked; }
+
+        uint32_t GetWidth() const { return m_Width; }
+        uint32_t GetHeight() const { return m_Height; }
+        float GetCellSize() const { return m_CellSize; }
+        bool IsInside(const glm::ivec2& cell) const { return cell.x >= 0 && cell.y >= 0 && (uint32_t)cell.x < m_Width && (uint32_t)cell.y < m_Height; }
+        glm::ivec2 WorldToCell(const glm::vec2& position) const;
+        // Centre of the cell
+        glm::vec2 CellToWorld(const glm::ivec2& cell) const;
+
+        uint32_t GetSectorCountX() const { return m_SectorsX; }
+        uint32_t GetSectorCountY() const { return m_SectorsY; }
+        uint32_t GetSectorCount() const { return m_SectorsX * m_SectorsY; }
+        uint32_t GetSectorIndex(const glm::ivec2& cell) const { return (cell.y / SectorSize) * m_SectorsX + cell.x / SectorSize; }
+        glm::ivec2 GetSectorOrigin(uint32_t sector) const;
+        // Bumped whenever a cell of the sector changes
+        uint32_t GetSectorVersion(uint32_t sector) const { return m_SectorVersions[sector]; }
+
+        // Recomputes portals and portal costs of changed sectors, in parallel on the JobSystem.
+        // Returns false when nothing had changed.
+        bool Rebuild();
+        // Bumped by every Rebuild that changed something
+        uint64_t GetGraphVersion() const { return m_GraphVersion; }
+        uint32_t GetPortalCount() const { return (uint32_t)m_Nodes.size(); }
+
+        struct Seed {
+            uint16_t Cell;      // Sector-local, x + y * SectorSize
+            uint32_t Value;
+        };
+        // Dijkstra over one sector (8-connected, no corner cutting) from the seeds outward.
+        // Writes SectorCells costs to `integration`; Unreachable where no seed can be reached.
+        void IntegrateSector(uint32_t sector, const Seed* seeds, uint32_t seedCount, uint32_t* integration) const;
+
+    private:
+        friend class FlowField;
+        friend class FlowFieldCache;
+
+        // Open run of cells along one sector edge, in edge-local coordinates
+        struct PortalSpan {
+            uint8_t Start;
+            uint8_t Length;
+            bool operator==(const PortalSpan& other) const { return Start == other.Start && Length == other.Length; }
+        };
+
+        // One side of a portal. The twin is the same portal seen from the neighbouring sector.
+        struct PortalNode {
+            glm::ivec2 First;       // First span cell on this sector's side
+            glm::ivec2 Along;       // Step from one span cell to the next
+            glm::ivec2 Across;      // Step over the edge into the neighbouring sector
+            glm::ivec2 Anchor;      // Middle of the span, where the abstract graph measures from
+            uint32_t Sector;
+            uint32_t Twin;
+            uint8_t Length;
+        };
+
+        enum Side : uint32_t { East = 0, North, West, South, SideCount };
+
+        bool UpdateEdgeSpans(std::vector<PortalSpan>& spans, glm::ivec2 first, glm::ivec2 along, glm::ivec2 across);
+        const std::vector<PortalSpan>* GetSideSpans(uint32_t sector, Side side) const;
+        void RebuildNodes();
+        void ComputeSectorCosts(uint32_t sector);
+        void LabelComponents();
+        uint16_t ToLocal(uint32_t sector, const glm::ivec2& cell) const;
+
+        uint32_t m_Width;
+        uint32_t m_Height;
+        float m_CellSize;
+        glm::vec2 m_Origin;
+        uint32_t m_SectorsX;
+        uint32_t m_SectorsY;
+        TaggedVector<uint8_t, MemoryTag::Navigation> m_Costs;
+
+        std::vector<uint32_t> m_SectorVersions;
+        std::vector<uint32_t> m_DirtySectors;
+        std::vector<uint8_t> m_SectorDirty;
+        uint64_t m_GraphVersion = 0;
+
+        // Spans on each sector's east and north edges; west and south are the neighbours' ones
+        std::vector<std::vector<PortalSpan>> m_EastSpans;
+        std::vector<std::vector<PortalSpan>> m_NorthSpans;
+
+        // Portal nodes grouped by sector (East, North, West, South spans in that order), and per
+        // sector the k x k travel costs between its nodes' anchors, [from * k + to]
+        TaggedVector<PortalNode, MemoryTag::Navigation> m_Nodes;
+        std::vector<uint32_t> m_SectorNodeStart;
+        std::vector<TaggedVector<uint32_t, MemoryTag::Navigation>> m_SectorCosts;
+        // Connected region of each node, so searches can skip portals they can never reach
+        std::vector<uint32_t> m_NodeComponents;
+    };
+
+}
@@ -0,0 +1,105 @@
+#include "mrlpch.h"
+#include "BitStream.h"
+
+namespace Marle {
+
+    BitWriter::BitWriter(std::vector<uint8_t>& buffer)
+        : m_Buffer(buffer)
+    {
+    }
+
+    void BitWriter::WriteBits(uint32_t value, uint32_t bits)
+    {
+        if (bits == 0) {
+            return;
+        }
+        uint64_t mask = bits >= 32 ? 0xFFFFFFFFull : ((1ull << bits) - 1);
+        m_Scratch |= ((uint64_t)value & mask) << m_ScratchBits;
+        m_ScratchBits += bits;
+        m_BitCount += bits;
+        if (m_ScratchBits >= 32) {
+            uint32_t word = (uint32_t)m_Scratch;
+            m_Buffer.push_back((uint8_t)word);
+            m_Buffer.push_back((uint8_t)(word >> 8));
+            m_Buffer.push_back((uint8_t)(word >> 16));
+            m_Buffer.push_back((uint8_t)(word >> 24));
+            m_Scratch >>= 32;
+            m_ScratchBits -= 32;
+        }
+    }
+
+    void BitWriter::WriteVarUint(uint32_t value)
+    {
+        // Groups of 4 bits, each preceded by a continuation bit, after a 1-bit zero test
+        if (value == 0) {
+            WriteBool(false);
+            return;
+        }
+        WriteBool(true);
+        value--;
+        for (;;) {
+            WriteBits(value & 0xF, 4);
+            value >>= 4;
+            WriteBool(value != 0);
+            if (value == 0) {
+                break;
+            }
+        }
+    }
+
+    void BitWriter::Finish()
+    {
+        while (m_ScratchBits > 0) {
+            m_Buffer.push_back((uint8_t)m_Scratch);
+            m_Scratch >>= 8;
+            m_ScratchBits = m_ScratchBits > 8 ? m_ScratchBits - 8 : 0;
+        }
+        m_Scratch = 0;
+    }
+
+    BitReader::BitReader(const uint8_t* data, size_t size)
+        : m_Data(data), m_TotalBits(size * 8)
+    {
+    }
+
+    uint32_t BitReader::ReadBits(uint32_t bits)
+    {
+        if (bits == 0) {
+            return 0;
+        }
+        if (m_Error || bits > 32 || m_BitPosition + bits > m_TotalBits) {
+            m_Error = true;
+            return 0;
+        }
+
+        uint32_t value = 0;
+        uint32_t written = 0;
+        while (written < bits) {
+            size_t byte = m_BitPosition >> 3;
+            uint32_t offset = (uint32_t)(m_BitPosition & 7);
+            uint32_t take = std::min(8 - offset, bits - written);
+            uint32_t chunk = (m_Data[byte] >> offset) & ((1u << take) - 1);
+            value |= chunk << written;
+            written += take;
+            m_BitPosition += take;
+        }
+        return value;
+    }
+
+    uint32_t BitReader::ReadVarUint()
+    {
+        if (!ReadBool()) {
+            return 0;
+        }
+        uint32_t value = 0;
+        for (uint32_t shift = 0; shift < 32; shift += 4) {
+            value |= ReadBits(4) << shift;
+            if (!ReadBool()) {
+                return value + 1;
+            }
+        }
+        m_Error = true;
+        return 0;
+    }
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    // Packs values of arbitrary bit width, least significant bit first, through a 64-bit scratch
+    // word flushed 32 bits at a time. Output is little-endian, so readers on any platform agree.
+    class BitWriter {
+    public:
+        explicit BitWriter(std::vector<uint8_t>& buffer);
+
+        void WriteBits(uint32_t value, uint32_t bits);      // bits <= 32
+        void WriteBool(bool value) { WriteBits(value ? 1 : 0, 1); }
+        // Small values cheap, large ones still possible: 0 costs 1 bit, < 2^k about 2k bits
+        void WriteVarUint(uint32_t value);
+        // Flushes the partial word; call once before using the buffer
+        void Finish();
+
+        size_t GetBitCount() const { return m_BitCount; }
+
+    private:
+        std::vector<uint8_t>& m_Buffer;
+        uint64_t m_Scratch = 0;
+        uint32_t m_ScratchBits = 0;
+        size_t m_BitCount = 0;
+    };
+
+    // Reads what BitWriter wrote. Reading past the end returns zeros and latches the error
+    // flag, so decoders can check once at the end instead of after every field.
+    class BitReader {
+    public:
+        BitReader(const uint8_t* data, size_t size);
+
+        uint32_t ReadBits(uint32_t bits);
+        bool ReadBool() { return ReadBits(1) != 0; }
+        uint32_t ReadVarUint();
+
+        bool HasError() const { return m_Error; }
+        size_t GetBitsRemaining() const { return m_TotalBits - m_BitPosition; }
+
+    private:
+        const uint8_t* m_Data;
+        size_t m_TotalBits;
+        size_t m_BitPosition = 0;
+        bool m_Error = false;
+    };
+
+}
@@ -0,0 +1,279 @@
+#include "mrlpch.h"
+#include "NetConnection.h"
+
+#include <cstring>
+
+namespace Marle {
+
+    namespace {
+
+        void WriteU16(uint8_t* out, uint16_t value)
+        {
+            out[0] = (uint8_t)value;
+            out[1] = (uint8_t)(value >> 8);
+        }
+
+        void WriteU32(uint8_t* out, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = (uint8_t)(value >> (i * 8));
+            }
+        }
+
+        uint16_t ReadU16(const uint8_t* in)
+        {
+            return (uint16_t)(in[0] | (in[1] << 8));
+        }
+
+        uint32_t ReadU32(const uint8_t* in)
+        {
+            return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+        }
+
+    }
+
+    NetConnection::NetConnection(NetSocket& socket, const NetAddress& peer)
+        : m_Socket(socket), m_Peer(peer),
+          m_SentPackets(SequenceBufferSize), m_SentMessages(MessageBufferSize),
+          m_ReceivedSequences(SequenceBufferSize, 0), m_Reassembly(ReassemblySlots)
+    {
+    }
+
+    bool NetConnection::ReadPacketType(const uint8_t* data, size_t size, NetPacketType& type)
+    {
+        if (size < HeaderSize || ReadU32(data) != ProtocolId) {
+            return false;
+        }
+        uint8_t value = data[4] & ~AckFlag;
+        if (value < (uint8_t)NetPacketType::ConnectRequest || value > (uint8_t)NetPacketType::Fragment) {
+            return false;
+        }
+        type = (NetPacketType)value;
+        return true;
+    }
+
+    void NetConnection::WriteHeader(uint8_t* packet, NetPacketType type, uint16_t sequence) const
+    {
+        uint32_t ackBits = 0;
+        if (m_HasReceived) {
+            for (uint32_t i = 0; i < 32; ++i) {
+                uint16_t sequenceAcked = (uint16_t)(m_RemoteSequence - 1 - i);
+                if (m_ReceivedSequences[sequenceAcked % SequenceBufferSize] == (uint32_t)sequenceAcked + 1) {
+                    ackBits |= 1u << i;
+                }
+            }
+        }
+        WriteU32(packet, ProtocolId);
+        packet[4] = (uint8_t)type | (m_HasReceived ? AckFlag : 0);
+        WriteU16(packet + 5, sequence);
+        WriteU16(packet + 7, m_RemoteSequence);
+        WriteU32(packet + 9, ackBits);
+    }
+
+    bool NetConnection::SendPacket(const uint8_t* packet, size_t size, double now, bool hasMessage, uint16_t messageId)
+    {
+        uint16_t sequence = ReadU16(packet + 5);
+
+        // The packet LossWindow sequences back has left every ack window; unacked means lost
+        SentPacket& judged = m_SentPackets[(uint16_t)(sequence - LossWindow) % SequenceBufferSize];
+        if (judged.Valid && judged.Sequence == (uint16_t)(sequence - LossWindow)) {
+            float sample = judged.Acked ? 0.0f : 100.0f;
+            m_Stats.PacketLossPercent += (sample - m_Stats.PacketLossPercent) * 0.02f;
+        }
+
+        SentPacket& sent = m_SentPackets[sequence % SequenceBufferSize];
+        sent.Sequence = sequence;
+        sent.MessageId = messageId;
+        sent.Valid = true;
+        sent.HasMessage = hasMessage;
+        sent.Acked = false;
+        sent.Time = now;
+
+        m_Stats.PacketsSent++;
+        m_Stats.BytesSent += size;
+        return m_Socket.Send(m_Peer, packet, size, now);
+    }
+
+    bool NetConnection::SendControl(NetPacketType type, double now, const uint8_t* payload, size_t size)
+    {
+        uint8_t packet[HeaderSize + 64];
+        if (size > sizeof(packet) - HeaderSize) {
+            printf("Error: Control packet payload of %zu bytes is too large\n", size);
+            return false;
+        }
+        WriteHeader(packet, type, m_NextSequence++);
+        if (size > 0) {
+            memcpy(packet + HeaderSize, payload, size);
+        }
+        return SendPacket(packet, HeaderSize + size, now, false, 0);
+    }
+
+    uint16_t NetConnection::SendMessage(const uint8_t* data, size_t size, double now)
+    {
+        uint16_t messageId = m_NextMessageId++;
+        if (size > MaxMessageSize) {
+            printf("Error: Message of %zu bytes exceeds the %zu byte limit; dropped\n", size, MaxMessageSize);
+            return messageId;
+        }
+
+        uint32_t fragmentCount = (uint32_t)((size + FragmentSize - 1) / FragmentSize);
+        if (fragmentCount == 0) {
+            fragmentCount = 1;
+        }
+
+        SentMessage& message = m_SentMessages[messageId % MessageBufferSize];
+        message.Id = messageId;
+        message.FragmentsLeft = (uint16_t)fragmentCount;
+        message.Valid = true;
+        m_Stats.MessagesSent++;
+
+        uint8_t packet[NetSocket::MaxPacketSize];
+        for (uint32_t index = 0; index < fragmentCount; ++index) {
+            size_t offset = (size_t)index * FragmentSize;
+            size_t length = std::min(FragmentSize, size - offset);
+            WriteHeader(packet, NetPacketType::Fragment, m_NextSequence++);
+            WriteU16(packet + HeaderSize, messageId);
+            packet[HeaderSize + 2] = (uint8_t)index;
+            packet[HeaderSize + 3] = (uint8_t)fragmentCount;
+            memcpy(packet + HeaderSize + FragmentHeaderSize, data + offset, length);
+            SendPacket(packet, HeaderSize + FragmentHeaderSize + length, now, true, messageId);
+        }
+        return messageId;
+    }
+
+    bool NetConnection::ProcessPacket(const uint8_t* data, size_t size, double now, std::vector<uint8_t>& message)
+    {
+        NetPacketType type;
+        if (!ReadPacketType(data, size, type)) {
+            return false;
+        }
+        uint16_t sequence = ReadU16(data + 5);
+        uint16_t ack = ReadU16(data + 7);
+        uint32_t ackBits = ReadU32(data + 9);
+
+        m_LastReceiveTime = now;
+        m_Stats.PacketsReceived++;
+        m_Stats.BytesReceived += size;
+        if (data[4] & AckFlag) {
+            ProcessAcks(ack, ackBits, now);
+        }
+
+        // Record the sequence for our acks; drop duplicates and packets older than the buffer
+        uint32_t& slot = m_ReceivedSequences[sequence % SequenceBufferSize];
+        if (slot == (uint32_t)sequence + 1) {
+            m_Stats.DuplicatePackets++;
+            return false;
+        }
+        if (m_HasReceived && (uint16_t)(m_RemoteSequence - sequence) < 0x8000 &&
+            (uint16_t)(m_RemoteSequence - sequence) >= SequenceBufferSize) {
+            return false;
+        }
+        if (!m_HasReceived || SequenceGreater(sequence, m_RemoteSequence)) {
+            // Forget the sequences skipped over, so stale entries do not produce false acks
+            uint16_t from = m_HasReceived ? (uint16_t)(m_RemoteSequence + 1) : sequence;
+            for (uint16_t s = from; s != sequence && (uint16_t)(sequence - s) <= SequenceBufferSize; ++s) {
+                m_ReceivedSequences[s % SequenceBufferSize] = 0;
+            }
+            m_RemoteSequence = sequence;
+            m_HasReceived = true;
+        }
+        slot = (uint32_t)sequence + 1;
+
+        if (type != NetPacketType::Fragment) {
+            return false;
+        }
+        return ReceiveFragment(data + HeaderSize, size - HeaderSize, message);
+    }
+
+    void NetConnection::ProcessAcks(uint16_t ack, uint32_t ackBits, double now)
+    {
+        for (uint32_t i = 0; i <= 32; ++i) {
+            if (i > 0 && !(ackBits & (1u << (i - 1)))) {
+                continue;
+            }
+            uint16_t sequence = (uint16_t)(ack - i);
+            SentPacket& packet = m_SentPackets[sequence % SequenceBufferSize];
+            if (packet.Valid && packet.Sequence == sequence && !packet.Acked) {
+                OnPacketAcked(packet, now);
+            }
+        }
+    }
+
+    void NetConnection::OnPacketAcked(SentPacket& packet, double now)
+    {
+        packet.Acked = true;
+        float rtt = (float)((now - packet.Time) * 1000.0);
+        m_Stats.RttMs = m_Stats.RttMs == 0.0f ? rtt : m_Stats.RttMs + (rtt - m_Stats.RttMs) * 0.1f;
+
+        if (!packet.HasMessage) {
+            return;
+        }
+        SentMessage& message = m_SentMessages[packet.MessageId % MessageBufferSize];
+        if (message.Valid && message.Id == packet.MessageId && message.FragmentsLeft > 0) {
+            if (--message.FragmentsLeft == 0) {
+                message.Valid = false;
+                m_AckedMessages.push_back(message.Id);
+            }
+        }
+    }
+
+    bool NetConnection::ReceiveFragment(const uint8_t* data, size_t size, std::vector<uint8_t>& message)
+    {
+        if (size < FragmentHeaderSize) {
+            return false;
+        }
+        uint16_t messageId = ReadU16(data);
+        uint8_t index = data[2];
+        uint8_t count = data[3];
+        const uint8_t* payload = data + FragmentHeaderSize;
+        size_t length = size - FragmentHeaderSize;
+        if (count == 0 || index >= count || length > FragmentSize || (index + 1 < count && length != FragmentSize)) {
+            return false;
+        }
+
+        if (count == 1) {
+            message.assign(payload, payload + length);
+            m_Stats.MessagesReceived++;
+            return true;
+        }
+
+        Reassembly& slot = m_Reassembly[messageId % ReassemblySlots];
+        if (!slot.Active || slot.MessageId != messageId) {
+            if (slot.Active && SequenceGreater(slot.MessageId, messageId)) {
+                return false;   // Older than the message this slot already gave up on
+            }
+            slot.MessageId = messageId;
+            slot.Active = true;
+            slot.FragmentCount = count;
+            slot.FragmentsReceived = 0;
+            slot.Size = (size_t)count * FragmentSize;
+            slot.Received.assign(count, 0);
+            slot.Data.resize(slot.Size);
+        }
+        if (slot.FragmentCount != count || slot.Received[index]) {
+            return false;
+        }
+
+        slot.Received[index] = 1;
+        slot.FragmentsReceived++;
+        memcpy(slot.Data.data() + (size_t)index * FragmentSize, payload, length);
+        if (index + 1 == count) {
+            slot.Size = (size_t)index * FragmentSize + length;
+        }
+        if (slot.FragmentsReceived < count) {
+            return false;
+        }
+
+        slot.Active = false;
+        message.assign(slot.Data.begin(), slot.Data.begin() + slot.Size);
+        m_Stats.MessagesReceived++;
+        return true;
+    }
+
+    void NetConnection::TakeAckedMessages(std::vector<uint16_t>& messages)
+    {
+        messages.insert(messages.end(), m_AckedMessages.begin(), m_AckedMessages.end());
+        m_AckedMessages.clear();
+    }
+
+}
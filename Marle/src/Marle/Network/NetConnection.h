@@ -0,0 +1,136 @@
+#pragma once
+
+#include "../Core.h"
+#include "NetSocket.h"
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    enum class NetPacketType : uint8_t {
+        ConnectRequest = 1,
+        ConnectAccept,
+        Disconnect,
+        KeepAlive,
+        Fragment,
+    };
+
+    // Unreliable packets made trackable, between this host and one peer. Every packet carries a
+    // sequence number and acks the last 33 packets received from the peer. Messages larger than a
+    // packet are split into fragments and reassembled on the other side. A message counts as acked
+    // once all its fragments were acked. Nothing is resent: callers like the replication layer
+    // build their next message from the newest state the peer acked instead.
+    //
+    // Packet layout, little-endian:
+    //   u32 protocol id, u8 type (high bit: ack fields valid), u16 sequence, u16 ack, u32 ack bits
+    //   Fragment: u16 message id, u8 fragment index, u8 fragment count, payload
+    //   Control types: optional small payload
+    class NetConnection {
+    public:
+        static constexpr uint32_t ProtocolId = 0x314C524D;     // "MRL1"
+        static constexpr size_t HeaderSize = 13;
+        static constexpr size_t FragmentHeaderSize = 4;
+        static constexpr size_t FragmentSize = NetSocket::MaxPacketSize - HeaderSize - FragmentHeaderSize;
+        static constexpr uint32_t MaxFragments = 255;
+        static constexpr size_t MaxMessageSize = FragmentSize * MaxFragments;
+
+        NetConnection(NetSocket& socket, const NetAddress& peer);
+
+        const NetAddress& GetPeer() const { return m_Peer; }
+
+        // Type of a datagram if it belongs to this protocol
+        static bool ReadPacketType(const uint8_t* data, size_t size, NetPacketType& type);
+
+        // Header-only packet (plus up to a few bytes of payload); still carries acks
+        bool SendControl(NetPacketType type, double now, const uint8_t* payload = nullptr, size_t size = 0);
+        // Splits `data` into fragments and sends them all. Returns the message id, which
+        // TakeAckedMessages() reports once the peer acked every fragment.
+        uint16_t SendMessage(const uint8_t* data, size_t size, double now);
+
+        // Processes one datagram from the peer: acks, then the fragment it carries, if any.
+        // Returns true when that completed a message, which is then in `message`.
+        bool ProcessPacket(const uint8_t* data, size_t size, double now, std::vector<uint8_t>& message);
+
+        // Appends the ids of messages acked since the last call
+        void TakeAckedMessages(std::vector<uint16_t>& messages);
+
+        double GetLastReceiveTime() const { return m_LastReceiveTime; }
+
+        struct Stats {
+            float RttMs = 0.0f;
+            float PacketLossPercent = 0.0f;     // Of our packets, judged by the peer's acks
+            uint64_t PacketsSent = 0;
+            uint64_t PacketsReceived = 0;
+            uint64_t BytesSent = 0;
+            uint64_t BytesReceived = 0;
+            uint32_t MessagesSent = 0;
+            uint32_t MessagesReceived = 0;
+            uint32_t DuplicatePackets = 0;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        static constexpr uint8_t AckFlag = 0x80;
+        static constexpr uint32_t SequenceBufferSize = 1024;
+        static constexpr uint32_t MessageBufferSize = 256;
+        static constexpr uint32_t ReassemblySlots = 16;
+        // A packet not acked this many packets later has left every ack window; it was lost
+        static constexpr uint16_t LossWindow = 64;
+
+        struct SentPacket {
+            uint16_t Sequence = 0;
+            uint16_t MessageId = 0;
+            bool Valid = false;
+            bool HasMessage = false;
+            bool Acked = false;
+            double Time = 0.0;
+        };
+
+        struct SentMessage {
+            uint16_t Id = 0;
+            uint16_t FragmentsLeft = 0;
+            bool Valid = false;
+        };
+
+        struct Reassembly {
+            uint16_t MessageId = 0;
+            bool Active = false;
+            uint8_t FragmentCount = 0;
+            uint32_t FragmentsReceived = 0;
+            size_t Size = 0;
+            std::vector<uint8_t> Received;      // One flag per fragment
+            std::vector<uint8_t> Data;
+        };
+
+        void WriteHeader(uint8_t* packet, NetPacketType type, uint16_t sequence) const;
+        bool SendPacket(const uint8_t* packet, size_t size, double now, bool hasMessage, uint16_t messageId);
+        void ProcessAcks(uint16_t ack, uint32_t ackBits, double now);
+        void OnPacketAcked(SentPacket& packet, double now);
+        bool ReceiveFragment(const uint8_t* data, size_t size, std::vector<uint8_t>& message);
+
+        NetSocket& m_Socket;
+        NetAddress m_Peer;
+
+        uint16_t m_NextSequence = 0;
+        uint16_t m_NextMessageId = 0;
+        std::vector<SentPacket> m_SentPackets;
+        std::vector<SentMessage> m_SentMessages;
+        std::vector<uint16_t> m_AckedMessages;
+
+        // Received sequence numbers, for building acks and dropping duplicates
+        bool m_HasReceived = false;
+        uint16_t m_RemoteSequence = 0;
+        std::vector<uint32_t> m_ReceivedSequences;  // Sequence + 1, 0 = empty
+        std::vector<Reassembly> m_Reassembly;
+
+        double m_LastReceiveTime = 0.0;
+        Stats m_Stats;
+    };
+
+    // Wrap-around aware "a is newer than b" for 16-bit sequence numbers
+    inline bool SequenceGreater(uint16_t a, uint16_t b)
+    {
+        return a != b && (uint16_t)(a - b) < 0x8000;
+    }
+
+}
@@ -0,0 +1,189 @@
+#include "mrlpch.h"
+#include "NetSocket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <arpa/inet.h>
+    #include <fcntl.h>
+    #include <netinet/in.h>
+    #include <sys/socket.h>
+#endif
+
+namespace Marle {
+
+    bool NetAddress::Parse(const char* text, NetAddress& address)
+    {
+        unsigned a, b, c, d, port;
+        char tail;
+        if (sscanf(text, "%u.%u.%u.%u:%u%c", &a, &b, &c, &d, &port, &tail) != 5 ||
+            a > 255 || b > 255 || c > 255 || d > 255 || port > 65535) {
+            return false;
+        }
+        address = NetAddress((uint8_t)a, (uint8_t)b, (uint8_t)c, (uint8_t)d, (uint16_t)port);
+        return true;
+    }
+
+    std::string NetAddress::ToString() const
+    {
+        char text[32];
+        snprintf(text, sizeof(text), "%u.%u.%u.%u:%u", Ip >> 24, (Ip >> 16) & 0xFF, (Ip >> 8) & 0xFF, Ip & 0xFF, Port);
+        return text;
+    }
+
+    NetSocket::~NetSocket()
+    {
+        Close();
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+
+    bool NetSocket::Open(uint16_t port)
+    {
+        Close();
+
+        int handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+        if (handle < 0) {
+            printf("Error: Failed to create UDP socket: %s\n", strerror(errno));
+            return false;
+        }
+
+        sockaddr_in local = {};
+        local.sin_family = AF_INET;
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+        local.sin_port = htons(port);
+        if (bind(handle, (const sockaddr*)&local, sizeof(local)) < 0) {
+            printf("Error: Failed to bind UDP port %u: %s\n", port, strerror(errno));
+            close(handle);
+            return false;
+        }
+
+        if (fcntl(handle, F_SETFL, fcntl(handle, F_GETFL, 0) | O_NONBLOCK) < 0) {
+            printf("Error: Failed to make UDP socket non-blocking: %s\n", strerror(errno));
+            close(handle);
+            return false;
+        }
+
+        socklen_t length = sizeof(local);
+        getsockname(handle, (sockaddr*)&local, &length);
+        m_Handle = handle;
+        m_Port = ntohs(local.sin_port);
+        return true;
+    }
+
+    void NetSocket::Close()
+    {
+        if (m_Handle >= 0) {
+            close(m_Handle);
+            m_Handle = -1;
+            m_Port = 0;
+        }
+        m_Delayed.clear();
+    }
+
+    bool NetSocket::SendNow(const NetAddress& to, const uint8_t* data, size_t size)
+    {
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(to.Ip);
+        address.sin_port = htons(to.Port);
+        ssize_t sent = sendto(m_Handle, data, size, 0, (const sockaddr*)&address, sizeof(address));
+        return sent == (ssize_t)size;
+    }
+
+    size_t NetSocket::Receive(NetAddress& from, uint8_t* data, size_t capacity)
+    {
+        if (m_Handle < 0) {
+            return 0;
+        }
+        for (;;) {
+            sockaddr_in address = {};
+            socklen_t length = sizeof(address);
+            ssize_t received = recvfrom(m_Handle, data, capacity, 0, (sockaddr*)&address, &length);
+            if (received > 0) {
+                from = NetAddress(ntohl(address.sin_addr.s_addr), ntohs(address.sin_port));
+                return (size_t)received;
+            }
+            // ICMP port-unreachable from an earlier send shows up here on some systems; skip it
+            if (received < 0 && errno == ECONNREFUSED) {
+                continue;
+            }
+            return 0;
+        }
+    }
+
+#else
+
+    bool NetSocket::Open(uint16_t port)
+    {
+        printf("Error: UDP sockets are not implemented on this platform (port %u)\n", port);
+        return false;
+    }
+
+    void NetSocket::Close()
+    {
+        m_Delayed.clear();
+    }
+
+    bool NetSocket::SendNow(const NetAddress&, const uint8_t*, size_t)
+    {
+        return false;
+    }
+
+    size_t NetSocket::Receive(NetAddress&, uint8_t*, size_t)
+    {
+        return 0;
+    }
+
+#endif
+
+    void NetSocket::SetConditions(const NetConditions& conditions, uint32_t seed)
+    {
+        m_Conditions = conditions;
+        m_Simulating = conditions.LossPercent > 0.0f || conditions.LatencyMs > 0.0f ||
+            conditions.JitterMs > 0.0f || conditions.DuplicatePercent > 0.0f;
+        m_Random.seed(seed);
+    }
+
+    bool NetSocket::Send(const NetAddress& to, const uint8_t* data, size_t size, double now)
+    {
+        if (m_Handle < 0 || size > MaxPacketSize) {
+            return false;
+        }
+        if (!m_Simulating) {
+            return SendNow(to, data, size);
+        }
+
+        std::uniform_real_distribution<float> percent(0.0f, 100.0f);
+        if (percent(m_Random) < m_Conditions.LossPercent) {
+            return true;    // Lost on the way, as far as the caller can tell
+        }
+        int copies = percent(m_Random) < m_Conditions.DuplicatePercent ? 2 : 1;
+        for (int i = 0; i < copies; ++i) {
+            double delay = (m_Conditions.LatencyMs + m_Conditions.JitterMs * percent(m_Random) / 100.0f) / 1000.0;
+            m_Delayed.push_back({ now + delay, to, std::vector<uint8_t>(data, data + size) });
+        }
+        Update(now);
+        return true;
+    }
+
+    void NetSocket::Update(double now)
+    {
+        if (m_Delayed.empty()) {
+            return;
+        }
+        // Only a few packets are in flight at once, so sorting every update is cheap. Due packets
+        // leave in send-time order, which is how jitter reorders them.
+        std::stable_sort(m_Delayed.begin(), m_Delayed.end(),
+            [](const DelayedPacket& a, const DelayedPacket& b) { return a.SendTime < b.SendTime; });
+        size_t due = 0;
+        while (due < m_Delayed.size() && m_Delayed[due].SendTime <= now) {
+            SendNow(m_Delayed[due].To, m_Delayed[due].Data.data(), m_Delayed[due].Data.size());
+            due++;
+        }
+        m_Delayed.erase(m_Delayed.begin(), m_Delayed.begin() + due);
+    }
+
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // IPv4 endpoint, host byte order
+    struct NetAddress {
+        uint32_t Ip = 0;
+        uint16_t Port = 0;
+
+        NetAddress() = default;
+        NetAddress(uint32_t ip, uint16_t port) : Ip(ip), Port(port) {}
+        NetAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d, uint16_t port)
+            : Ip(((uint32_t)a << 24) | ((uint32_t)b << 16) | ((uint32_t)c << 8) | d), Port(port) {}
+
+        // "a.b.c.d:port"
+        static bool Parse(const char* text, NetAddress& address);
+        std::string ToString() const;
+
+        bool operator==(const NetAddress& other) const { return Ip == other.Ip && Port == other.Port; }
+        bool operator!=(const NetAddress& other) const { return !(*this == other); }
+    };
+
+    // Bad network on demand, applied to outgoing packets. Times come from the caller so that
+    // tests and benches can run simulated seconds as fast as the CPU allows.
+    struct NetConditions {
+        float LossPercent = 0.0f;
+        float LatencyMs = 0.0f;         // One way
+        float JitterMs = 0.0f;          // Added uniformly in [0, JitterMs]; may reorder packets
+        float DuplicatePercent = 0.0f;
+    };
+
+    // Non-blocking UDP socket. Send() goes through the NetConditions simulator when it is
+    // active; delayed packets leave from Update(), which the owner calls once per step.
+    class NetSocket {
+    public:
+        static constexpr size_t MaxPacketSize = 1400;
+
+        NetSocket() = default;
+        ~NetSocket();
+
+        NetSocket(const NetSocket&) = delete;
+        NetSocket& operator=(const NetSocket&) = delete;
+
+        // Port 0 picks a free one
+        bool Open(uint16_t port);
+        void Close();
+        bool IsOpen() const { return m_Handle >= 0; }
+        uint16_t GetPort() const { return m_Port; }
+
+        void SetConditions(const NetConditions& conditions, uint32_t seed = 1);
+        const NetConditions& GetConditions() const { return m_Conditions; }
+
+        bool Send(const NetAddress& to, const uint8_t* data, size_t size, double now);
+        // Returns the packet size, 0 when nothing is waiting
+        size_t Receive(NetAddress& from, uint8_t* data, size_t capacity);
+        // Releases simulated packets whose delay has passed
+        void Update(double now);
+
+    private:
+        struct DelayedPacket {
+            double SendTime;
+            NetAddress To;
+            std::vector<uint8_t> Data;
+        };
+
+        bool SendNow(const NetAddress& to, const uint8_t* data, size_t size);
+
+        int m_Handle = -1;
+        uint16_t m_Port = 0;
+        NetConditions m_Conditions;
+        bool m_Simulating = false;
+        std::mt19937 m_Random;
+        std::vector<DelayedPacket> m_Delayed;
+    };
+
+}
@@ -0,0 +1,887 @@
+#include "mrlpch.h"
+#include "Replication.h"
+#include "BitStream.h"
+#include "../Core/JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+namespace Marle {
+
+    namespace {
+
+        // KeepAlive payload asking the server for a full snapshot
+        constexpr uint8_t ResyncRequest = 1;
+        // Render clock: jump when this far off, else close this fraction of the gap per tick
+        constexpr double ClockSnapTicks = 30.0;
+        constexpr double ClockCorrection = 0.05;
+
+        uint32_t BitsFor(uint32_t steps)
+        {
+            uint32_t bits = 0;
+            while (bits < 32 && (steps >> bits) != 0) {
+                bits++;
+            }
+            return std::max(bits, 1u);
+        }
+
+        // A changed field: raw when narrow, else the difference to the baseline in 6 bits when
+        // it is within +-16, 12 bits within +-512 (wide fields only), or the raw value
+        void WriteField(BitWriter& writer, uint32_t bits, uint32_t previous, uint32_t value)
+        {
+            if (bits <= 6) {
+                writer.WriteBits(value, bits);
+                return;
+            }
+            bool negative = value < previous;
+            uint32_t magnitude = negative ? previous - value : value - previous;
+            if (magnitude <= 16) {
+                writer.WriteBool(true);
+                writer.WriteBool(negative);
+                writer.WriteBits(magnitude - 1, 4);
+                return;
+            }
+            writer.WriteBool(false);
+            if (bits > 12) {
+                if (magnitude <= 512) {
+                    writer.WriteBool(true);
+                    writer.WriteBool(negative);
+                    writer.WriteBits(magnitude - 1, 9);
+                    return;
+                }
+                writer.WriteBool(false);
+            }
+            writer.WriteBits(value, bits);
+        }
+
+        uint32_t ReadField(BitReader& reader, uint32_t bits, uint32_t previous)
+        {
+            if (bits <= 6) {
+                return reader.ReadBits(bits);
+            }
+            uint32_t magnitudeBits = 0;
+            if (reader.ReadBool()) {
+                magnitudeBits = 4;
+            } else if (bits > 12 && reader.ReadBool()) {
+                magnitudeBits = 9;
+            }
+            if (magnitudeBits == 0) {
+                return reader.ReadBits(bits);
+            }
+            bool negative = reader.ReadBool();
+            uint32_t magnitude = reader.ReadBits(magnitudeBits) + 1;
+            return negative ? previous - magnitude : previous + magnitude;
+        }
+
+        void WriteU32(uint8_t* out, uint32_t value)
+        {
+            for (int i = 0; i < 4; ++i) {
+                out[i] = (uint8_t)(value >> (i * 8));
+            }
+        }
+
+        uint32_t ReadU32(const uint8_t* in)
+        {
+            return (uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24);
+        }
+
+    }
+
+    // ReplicationSchema
+
+    uint32_t ReplicationSchema::AddField(const char* name, FieldType type, float min, float max, uint32_t steps)
+    {
+        if (m_Fields.size() >= MaxFields) {
+            printf("Error: Replication schema field '%s' exceeds the %u field limit\n", name, MaxFields);
+            return ~0u;
+        }
+        m_Fields.push_back({ name, type, min, max, steps, BitsFor(steps) });
+        return (uint32_t)m_Fields.size() - 1;
+    }
+
+    uint32_t ReplicationSchema::AddFloat(const char* name, float min, float max, float precision)
+    {
+        if (!(max > min) || !(precision > 0.0f)) {
+            printf("Error: Replication field '%s' needs max > min and a positive precision\n", name);
+            return ~0u;
+        }
+        double steps = std::ceil(((double)max - min) / precision);
+        if (steps > (double)0x7FFFFFFF) {
+            printf("Warning: Replication field '%s' precision clamped to 31 bits\n", name);
+            steps = (double)0x7FFFFFFF;
+        }
+        return AddField(name, FieldType::Float, min, max, (uint32_t)steps);
+    }
+
+    uint32_t ReplicationSchema::AddInt(const char* name, int32_t min, int32_t max)
+    {
+        if (max < min) {
+            printf("Error: Replication field '%s' needs max >= min\n", name);
+            return ~0u;
+        }
+        return AddField(name, FieldType::Int, (float)min, (float)max, (uint32_t)((int64_t)max - min));
+    }
+
+    uint32_t ReplicationSchema::AddBool(const char* name)
+    {
+        return AddField(name, FieldType::Bool, 0.0f, 1.0f, 1);
+    }
+
+    uint32_t ReplicationSchema::GetFieldIndex(const char* name) const
+    {
+        for (uint32_t i = 0; i < m_Fields.size(); ++i) {
+            if (m_Fields[i].Name == name) {
+                return i;
+            }
+        }
+        return ~0u;
+    }
+
+    uint32_t ReplicationSchema::GetBitsPerEntity() const
+    {
+        uint32_t bits = 0;
+        for (const Field& field : m_Fields) {
+            bits += field.Bits;
+        }
+        return bits;
+    }
+
+    uint32_t ReplicationSchema::GetHash() const
+    {
+        // FNV-1a over everything that affects the wire format
+        uint32_t hash = 2166136261u;
+        auto mix = [&hash](const void* data, size_t size) {
+            const uint8_t* bytes = (const uint8_t*)data;
+            for (size_t i = 0; i < size; ++i) {
+                hash = (hash ^ bytes[i]) * 16777619u;
+            }
+        };
+        for (const Field& field : m_Fields) {
+            mix(field.Name.data(), field.Name.size());
+            mix(&field.Type, sizeof(field.Type));
+            mix(&field.Min, sizeof(field.Min));
+            mix(&field.Max, sizeof(field.Max));
+            mix(&field.Steps, sizeof(field.Steps));
+        }
+        return hash;
+    }
+
+    uint32_t ReplicationSchema::Quantize(uint32_t field, float value) const
+    {
+        const Field& f = m_Fields[field];
+        switch (f.Type) {
+            case FieldType::Bool:
+                return value != 0.0f ? 1 : 0;
+            case FieldType::Int: {
+                double clamped = std::min(std::max((double)std::lround(value), (double)f.Min), (double)f.Max);
+                return (uint32_t)((int64_t)clamped - (int64_t)f.Min);
+            }
+            case FieldType::Float:
+            default: {
+                float t = (value - f.Min) / (f.Max - f.Min);
+                t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);     // Also maps NaN to 0
+                return (uint32_t)((double)t * f.Steps + 0.5);
+            }
+        }
+    }
+
+    float ReplicationSchema::Dequantize(uint32_t field, uint32_t value) const
+    {
+        const Field& f = m_Fields[field];
+        switch (f.Type) {
+            case FieldType::Bool:
+                return value ? 1.0f : 0.0f;
+            case FieldType::Int:
+                return (float)((int64_t)f.Min + value);
+            case FieldType::Float:
+            default:
+                return f.Min + (float)((double)value * (f.Max - f.Min) / f.Steps);
+        }
+    }
+
+    void ReplicationSchema::Encode(const ReplicationSnapshot* baseline, const ReplicationSnapshot& snapshot, std::vector<uint8_t>& out) const
+    {
+        const uint32_t fieldCount = GetFieldCount();
+        out.clear();
+        BitWriter writer(out);
+        writer.WriteBits(snapshot.Tick, 32);
+        writer.WriteBool(baseline != nullptr);
+        if (baseline) {
+            writer.WriteVarUint(snapshot.Tick - baseline->Tick);
+        }
+
+        // New and changed entities, ids as gaps from the previous one written
+        size_t b = 0;
+        const size_t baselineCount = baseline ? baseline->Ids.size() : 0;
+        uint32_t nextId = 0;
+        for (size_t i = 0; i < snapshot.Ids.size(); ++i) {
+            uint32_t id = snapshot.Ids[i];
+            const uint32_t* values = &snapshot.Values[i * fieldCount];
+            while (b < baselineCount && baseline->Ids[b] < id) {
+                b++;
+            }
+            const uint32_t* previous = nullptr;
+            if (b < baselineCount && baseline->Ids[b] == id) {
+                previous = &baseline->Values[b * fieldCount];
+                if (memcmp(previous, values, fieldCount * sizeof(uint32_t)) == 0) {
+                    continue;
+                }
+            }
+
+            writer.WriteBool(true);
+            writer.WriteVarUint(id - nextId);
+            nextId = id + 1;
+            for (uint32_t f = 0; f < fieldCount; ++f) {
+                if (!previous) {
+                    writer.WriteBits(values[f], m_Fields[f].Bits);
+                } else if (values[f] == previous[f]) {
+                    writer.WriteBool(false);
+                } else {
+                    writer.WriteBool(true);
+                    WriteField(writer, m_Fields[f].Bits, previous[f], values[f]);
+                }
+            }
+        }
+        writer.WriteBool(false);
+
+        // Entities of the baseline that are gone
+        size_t s = 0;
+        nextId = 0;
+        for (b = 0; b < baselineCount; ++b) {
+            uint32_t id = baseline->Ids[b];
+            while (s < snapshot.Ids.size() && snapshot.Ids[s] < id) {
+                s++;
+            }
+            if (s < snapshot.Ids.size() && snapshot.Ids[s] == id) {
+                continue;
+            }
+            writer.WriteBool(true);
+            writer.WriteVarUint(id - nextId);
+            nextId = id + 1;
+        }
+        writer.WriteBool(false);
+        writer.Finish();
+    }
+
+    bool ReplicationSchema::ReadHeader(const uint8_t* data, size_t size, uint32_t& tick, bool& hasBaseline, uint32_t& baselineTick)
+    {
+        BitReader reader(data, size);
+        tick = reader.ReadBits(32);
+        hasBaseline = reader.ReadBool();
+        baselineTick = hasBaseline ? tick - reader.ReadVarUint() : 0;
+        return !reader.HasError() && tick != 0;
+    }
+
+    bool ReplicationSchema::Decode(const uint8_t* data, size_t size, const ReplicationSnapshot* baseline, ReplicationSnapshot& snapshot) const
+    {
+        const uint32_t fieldCount = GetFieldCount();
+        BitReader reader(data, size);
+        uint32_t tick = reader.ReadBits(32);
+        bool hasBaseline = reader.ReadBool();
+        if (hasBaseline) {
+            uint32_t baselineTick = tick - reader.ReadVarUint();
+            if (!baseline || baseline->Tick != baselineTick) {
+                return false;
+            }
+        } else {
+            baseline = nullptr;
+        }
+
+        // Changes, in id order; unchanged fields copied from the baseline as they are read
+        thread_local std::vector<uint32_t> changedIds;
+        thread_local std::vector<uint32_t> changedValues;
+        thread_local std::vector<uint32_t> removedIds;
+        changedIds.clear();
+        changedValues.clear();
+        removedIds.clear();
+
+        size_t b = 0;
+        const size_t baselineCount = baseline ? baseline->Ids.size() : 0;
+        uint32_t nextId = 0;
+        while (reader.ReadBool()) {
+            uint32_t id = nextId + reader.ReadVarUint();
+            nextId = id + 1;
+            while (b < baselineCount && baseline->Ids[b] < id) {
+                b++;
+            }
+            const uint32_t* previous = b < baselineCount && baseline->Ids[b] == id ? &baseline->Values[b * fieldCount] : nullptr;
+            changedIds.push_back(id);
+            for (uint32_t f = 0; f < fieldCount; ++f) {
+                uint32_t value;
+                if (!previous) {
+                    value = reader.ReadBits(m_Fields[f].Bits);
+                } else if (reader.ReadBool()) {
+                    value = ReadField(reader, m_Fields[f].Bits, previous[f]);
+                } else {
+                    value = previous[f];
+                }
+                if (value > m_Fields[f].Steps) {
+                    return false;
+                }
+                changedValues.push_back(value);
+            }
+            if (reader.HasError() || nextId == 0) {
+                return false;
+            }
+        }
+        nextId = 0;
+        while (reader.ReadBool()) {
+            uint32_t id = nextId + reader.ReadVarUint();
+            nextId = id + 1;
+            removedIds.push_back(id);
+            if (reader.HasError() || nextId == 0) {
+                return false;
+            }
+        }
+        if (reader.HasError()) {
+            return false;
+        }
+
+        // Merge: baseline minus removed, with changed entities replacing or joining it
+        snapshot.Tick = tick;
+        snapshot.Ids.clear();
+        snapshot.Values.clear();
+        size_t c = 0, r = 0;
+        b = 0;
+        while (b < baselineCount || c < changedIds.size()) {
+            uint32_t baselineId = b < baselineCount ? baseline->Ids[b] : ~0u;
+            uint32_t changedId = c < changedIds.size() ? changedIds[c] : ~0u;
+            if (c < changedIds.size() && changedId <= baselineId) {
+                snapshot.Ids.push_back(changedId);
+                snapshot.Values.insert(snapshot.Values.end(), changedValues.begin() + c * fieldCount, changedValues.begin() + (c + 1) * fieldCount);
+                b += changedId == baselineId ? 1 : 0;
+                c++;
+                continue;
+            }
+            while (r < removedIds.size() && removedIds[r] < baselineId) {
+                r++;
+            }
+            if (r >= removedIds.size() || removedIds[r] != baselineId) {
+                snapshot.Ids.push_back(baselineId);
+                snapshot.Values.insert(snapshot.Values.end(), baseline->Values.begin() + b * fieldCount, baseline->Values.begin() + (b + 1) * fieldCount);
+            }
+            b++;
+        }
+        return true;
+    }
+
+    // ReplicationServer
+
+    struct ReplicationServer::Client {
+        static constexpr uint32_t SentRing = HistorySize * 2;
+
+        struct SentSnapshot {
+            uint16_t MessageId = 0;
+            uint32_t Tick = 0;
+        };
+
+        std::unique_ptr<NetConnection> Connection;
+        uint32_t AckedTick = 0;         // Newest snapshot the client has, 0 = none
+        uint32_t ResyncTick = 0;        // Acks for snapshots older than this are ignored
+        SentSnapshot Sent[SentRing];
+        std::vector<uint8_t> Packet;
+        uint64_t EncodeNs = 0;
+        bool Full = false;
+        uint64_t CountedBytes = 0;      // BytesSent already in the stats
+    };
+
+    ReplicationServer::ReplicationServer(const ReplicationSchema& schema, const ReplicationServerConfig& config)
+        : m_Schema(schema), m_Config(config)
+    {
+        if (m_Config.SendInterval == 0) {
+            m_Config.SendInterval = 1;
+        }
+    }
+
+    ReplicationServer::~ReplicationServer()
+    {
+        Stop();
+    }
+
+    bool ReplicationServer::Start(uint16_t port)
+    {
+        if (m_Schema.GetFieldCount() == 0) {
+            printf("Error: Replication server needs a schema with at least one field\n");
+            return false;
+        }
+        if (!m_Socket.Open(port)) {
+            return false;
+        }
+        printf("Replication server listening on port %u (%u fields, %u bits per entity)\n",
+               m_Socket.GetPort(), m_Schema.GetFieldCount(), m_Schema.GetBitsPerEntity());
+        return true;
+    }
+
+    void ReplicationServer::Stop()
+    {
+        if (!m_Socket.IsOpen()) {
+            return;
+        }
+        // Unreliable; clients that miss it time out instead
+        m_Socket.SetConditions(NetConditions());
+        for (auto& client : m_Clients) {
+            for (int i = 0; i < 3; ++i) {
+                client->Connection->SendControl(NetPacketType::Disconnect, m_Time);
+            }
+        }
+        m_Clients.clear();
+        m_Socket.Close();
+    }
+
+    const ReplicationSnapshot* ReplicationServer::FindSnapshot(uint32_t tick) const
+    {
+        for (const ReplicationSnapshot& snapshot : m_History) {
+            if (snapshot.Tick == tick && tick != 0) {
+                return &snapshot;
+            }
+        }
+        return nullptr;
+    }
+
+    void ReplicationServer::Update(double fixed_dt)
+    {
+        m_Tick++;
+        m_Time += fixed_dt;
+        if (!m_Socket.IsOpen()) {
+            return;
+        }
+        m_Socket.Update(m_Time);
+        ReceivePackets();
+
+        std::vector<uint16_t> acked;
+        for (size_t i = 0; i < m_Clients.size();) {
+            Client& client = *m_Clients[i];
+            if (m_Time - client.Connection->GetLastReceiveTime() > m_Config.TimeoutSeconds) {
+                RemoveClient(i, "timed out");
+                continue;
+            }
+            acked.clear();
+            client.Connection->TakeAckedMessages(acked);
+            for (uint16_t messageId : acked) {
+                const Client::SentSnapshot& sent = client.Sent[messageId % Client::SentRing];
+                if (sent.MessageId == messageId && sent.Tick >= client.ResyncTick && sent.Tick > client.AckedTick) {
+                    client.AckedTick = sent.Tick;
+                }
+            }
+            i++;
+        }
+
+        m_StatsClientSeconds += m_Clients.size() * fixed_dt;
+        UpdateStats();
+    }
+
+    void ReplicationServer::ReceivePackets()
+    {
+        uint8_t buffer[NetSocket::MaxPacketSize];
+        std::vector<uint8_t> message;
+        NetAddress from;
+        size_t size;
+        while ((size = m_Socket.Receive(from, buffer, sizeof(buffer))) > 0) {
+            NetPacketType type;
+            if (!NetConnection::ReadPacketType(buffer, size, type)) {
+                continue;
+            }
+
+            size_t index = 0;
+            while (index < m_Clients.size() && m_Clients[index]->Connection->GetPeer() != from) {
+                index++;
+            }
+            if (index == m_Clients.size()) {
+                if (type != NetPacketType::ConnectRequest) {
+                    continue;
+                }
+                uint32_t hash = size >= NetConnection::HeaderSize + 4 ? ReadU32(buffer + NetConnection::HeaderSize) : 0;
+                if (hash != m_Schema.GetHash()) {
+                    printf("Warning: Rejected %s: replication schema mismatch\n", from.ToString().c_str());
+                    continue;
+                }
+                if (m_Clients.size() >= m_Config.MaxClients) {
+                    printf("Warning: Rejected %s: server is full (%u clients)\n", from.ToString().c_str(), m_Config.MaxClients);
+                    continue;
+                }
+                auto client = std::make_unique<Client>();
+                client->Connection = std::make_unique<NetConnection>(m_Socket, from);
+                m_Clients.push_back(std::move(client));
+                printf("Client %s connected\n", from.ToString().c_str());
+            }
+
+            Client& client = *m_Clients[index];
+            if (type == NetPacketType::Disconnect) {
+                RemoveClient(index, "disconnected");
+                continue;
+            }
+            client.Connection->ProcessPacket(buffer, size, m_Time, message);
+            if (type == NetPacketType::ConnectRequest) {
+                // Also answers retries whose accept got lost
+                client.Connection->SendControl(NetPacketType::ConnectAccept, m_Time);
+            } else if (type == NetPacketType::KeepAlive && size > NetConnection::HeaderSize &&
+                       buffer[NetConnection::HeaderSize] == ResyncRequest) {
+                client.AckedTick = 0;
+                client.ResyncTick = m_Tick;
+            }
+        }
+    }
+
+    void ReplicationServer::RemoveClient(size_t index, const char* reason)
+    {
+        printf("Client %s %s\n", m_Clients[index]->Connection->GetPeer().ToString().c_str(), reason);
+        m_Clients.erase(m_Clients.begin() + index);
+    }
+
+    void ReplicationServer::BeginSnapshot()
+    {
+        m_PendingIds.clear();
+        m_PendingValues.clear();
+        m_PendingSorted = true;
+    }
+
+    void ReplicationServer::WriteEntity(uint32_t id, const float* values)
+    {
+        if (!m_PendingIds.empty() && id <= m_PendingIds.back()) {
+            m_PendingSorted = false;
+        }
+        m_PendingIds.push_back(id);
+        for (uint32_t f = 0; f < m_Schema.GetFieldCount(); ++f) {
+            m_PendingValues.push_back(m_Schema.Quantize(f, values[f]));
+        }
+    }
+
+    void ReplicationServer::EndSnapshot()
+    {
+        m_Stats.Entities = (uint32_t)m_PendingIds.size();
+        if (m_Clients.empty() || m_Tick % m_Config.SendInterval != 0) {
+            return;
+        }
+
+        const uint32_t fieldCount = m_Schema.GetFieldCount();
+        ReplicationSnapshot& snapshot = m_History[m_SnapshotCount++ % HistorySize];
+        snapshot.Tick = m_Tick;
+        if (m_PendingSorted) {
+            snapshot.Ids.assign(m_PendingIds.begin(), m_PendingIds.end());
+            snapshot.Values.assign(m_PendingValues.begin(), m_PendingValues.end());
+        } else {
+            m_Order.resize(m_PendingIds.size());
+            std::iota(m_Order.begin(), m_Order.end(), 0u);
+            std::sort(m_Order.begin(), m_Order.end(), [this](uint32_t a, uint32_t b) { return m_PendingIds[a] < m_PendingIds[b]; });
+            snapshot.Ids.clear();
+            snapshot.Values.clear();
+            for (uint32_t index : m_Order) {
+                if (!snapshot.Ids.empty() && snapshot.Ids.back() == m_PendingIds[index]) {
+                    continue;   // Written twice this tick; the first one wins
+                }
+                snapshot.Ids.push_back(m_PendingIds[index]);
+                snapshot.Values.insert(snapshot.Values.end(), m_PendingValues.begin() + (size_t)index * fieldCount,
+                                       m_PendingValues.begin() + (size_t)(index + 1) * fieldCount);
+            }
+        }
+
+        JobSystem::ParallelFor((uint32_t)m_Clients.size(), 1, [this, &snapshot](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                Client& client = *m_Clients[i];
+                auto start = std::chrono::steady_clock::now();
+                const ReplicationSnapshot* baseline = client.AckedTick != 0 ? FindSnapshot(client.AckedTick) : nullptr;
+                m_Schema.Encode(baseline, snapshot, client.Packet);
+                client.Full = baseline == nullptr;
+                client.EncodeNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+            }
+        });
+
+        for (auto& client : m_Clients) {
+            uint16_t messageId = client->Connection->SendMessage(client->Packet.data(), client->Packet.size(), m_Time);
+            client->Sent[messageId % Client::SentRing] = { messageId, m_Tick };
+            m_StatsEncodeNs += client->EncodeNs;
+            m_StatsEncodedEntities += snapshot.Ids.size();
+            m_StatsSnapshotBytes += client->Packet.size();
+            m_StatsSnapshots++;
+            (client->Full ? m_Stats.FullSnapshots : m_Stats.DeltaSnapshots)++;
+        }
+    }
+
+    void ReplicationServer::UpdateStats()
+    {
+        float rtt = 0.0f, loss = 0.0f;
+        for (auto& client : m_Clients) {
+            const NetConnection::Stats& stats = client->Connection->GetStats();
+            m_StatsBytes += stats.BytesSent - client->CountedBytes;
+            client->CountedBytes = stats.BytesSent;
+            rtt += stats.RttMs;
+            loss += stats.PacketLossPercent;
+        }
+
+        if (m_Time - m_StatsWindowStart < 1.0) {
+            return;
+        }
+        m_Stats.Clients = (uint32_t)m_Clients.size();
+        m_Stats.BytesPerClientPerSecond = m_StatsClientSeconds > 0.0 ? (float)(m_StatsBytes / m_StatsClientSeconds) : 0.0f;
+        m_Stats.EncodeNsPerEntity = m_StatsEncodedEntities ? (float)m_StatsEncodeNs / m_StatsEncodedEntities : 0.0f;
+        m_Stats.AverageSnapshotBytes = m_StatsSnapshots ? (float)m_StatsSnapshotBytes / m_StatsSnapshots : 0.0f;
+        m_Stats.RttMs = m_Clients.empty() ? 0.0f : rtt / m_Clients.size();
+        m_Stats.PacketLossPercent = m_Clients.empty() ? 0.0f : loss / m_Clients.size();
+
+        m_StatsWindowStart = m_Time;
+        m_StatsBytes = 0;
+        m_StatsClientSeconds = 0.0;
+        m_StatsEncodeNs = 0;
+        m_StatsEncodedEntities = 0;
+        m_StatsSnapshotBytes = 0;
+        m_StatsSnapshots = 0;
+    }
+
+    // ReplicationClient
+
+    ReplicationClient::ReplicationClient(const ReplicationSchema& schema, const ReplicationClientConfig& config)
+        : m_Schema(schema), m_Config(config)
+    {
+    }
+
+    ReplicationClient::~ReplicationClient()
+    {
+        Disconnect();
+    }
+
+    bool ReplicationClient::Connect(const NetAddress& server)
+    {
+        Disconnect();
+        if (!m_Socket.Open(0)) {
+            return false;
+        }
+        m_Connection = std::make_unique<NetConnection>(m_Socket, server);
+        m_State = State::Connecting;
+        m_ConnectStartTime = m_Time;
+        m_LastConnectAttempt = m_Time - m_Config.ConnectRetrySeconds;
+        m_NeedsResync = false;
+        for (ReplicationSnapshot& snapshot : m_History) {
+            snapshot.Clear();
+        }
+        m_NewestTick = 0;
+        m_ClockStarted = false;
+        m_Stats = Stats();
+        m_StatsWindowStart = m_Time;
+        m_StatsBytes = 0;
+        printf("Connecting to replication server %s\n", server.ToString().c_str());
+        return true;
+    }
+
+    void ReplicationClient::Disconnect()
+    {
+        if (m_State == State::Disconnected) {
+            return;
+        }
+        m_Socket.SetConditions(NetConditions());
+        for (int i = 0; i < 3; ++i) {
+            m_Connection->SendControl(NetPacketType::Disconnect, m_Time);
+        }
+        m_Socket.Close();
+        m_Connection.reset();
+        m_State = State::Disconnected;
+    }
+
+    void ReplicationClient::Update(double fixed_dt)
+    {
+        m_Time += fixed_dt;
+        if (m_State == State::Disconnected) {
+            return;
+        }
+        m_Socket.Update(m_Time);
+        ReceivePackets();
+        if (m_State == State::Disconnected) {
+            return;
+        }
+
+        if (m_State == State::Connecting) {
+            if (m_Time - m_ConnectStartTime > m_Config.TimeoutSeconds) {
+                printf("Error: No answer from replication server %s\n", m_Connection->GetPeer().ToString().c_str());
+                Disconnect();
+                return;
+            }
+            if (m_Time - m_LastConnectAttempt >= m_Config.ConnectRetrySeconds) {
+                uint8_t hash[4];
+                WriteU32(hash, m_Schema.GetHash());
+                m_Connection->SendControl(NetPacketType::ConnectRequest, m_Time, hash, sizeof(hash));
+                m_LastConnectAttempt = m_Time;
+            }
+            return;
+        }
+
+        if (m_Time - m_Connection->GetLastReceiveTime() > m_Config.TimeoutSeconds) {
+            printf("Warning: Replication server %s timed out\n", m_Connection->GetPeer().ToString().c_str());
+            Disconnect();
+            return;
+        }
+        // Carries the acks for everything received this step
+        uint8_t resync = ResyncRequest;
+        m_Connection->SendControl(NetPacketType::KeepAlive, m_Time, m_NeedsResync ? &resync : nullptr, m_NeedsResync ? 1 : 0);
+        AdvanceClock();
+
+        if (m_Time - m_StatsWindowStart >= 1.0) {
+            const NetConnection::Stats& stats = m_Connection->GetStats();
+            m_Stats.BytesPerSecond = (float)((stats.BytesReceived - m_StatsBytes) / (m_Time - m_StatsWindowStart));
+            m_Stats.RttMs = stats.RttMs;
+            m_StatsBytes = stats.BytesReceived;
+            m_StatsWindowStart = m_Time;
+        }
+    }
+
+    void ReplicationClient::ReceivePackets()
+    {
+        uint8_t buffer[NetSocket::MaxPacketSize];
+        NetAddress from;
+        size_t size;
+        while ((size = m_Socket.Receive(from, buffer, sizeof(buffer))) > 0) {
+            NetPacketType type;
+            if (from != m_Connection->GetPeer() || !NetConnection::ReadPacketType(buffer, size, type)) {
+                continue;
+            }
+            if (type == NetPacketType::Disconnect) {
+                printf("Replication server %s closed the connection\n", from.ToString().c_str());
+                m_Socket.Close();
+                m_Connection.reset();
+                m_State = State::Disconnected;
+                return;
+            }
+
+            bool complete = m_Connection->ProcessPacket(buffer, size, m_Time, m_Message);
+            if (m_State == State::Connecting && (type == NetPacketType::ConnectAccept || type == NetPacketType::Fragment)) {
+                m_State = State::Connected;
+                printf("Connected to replication server %s\n", from.ToString().c_str());
+            }
+            if (complete) {
+                OnSnapshot(m_Message);
+            }
+        }
+    }
+
+    const ReplicationSnapshot* ReplicationClient::FindSnapshot(uint32_t tick) const
+    {
+        for (const ReplicationSnapshot& snapshot : m_History) {
+            if (snapshot.Tick == tick && tick != 0) {
+                return &snapshot;
+            }
+        }
+        return nullptr;
+    }
+
+    void ReplicationClient::OnSnapshot(const std::vector<uint8_t>& message)
+    {
+        uint32_t tick, baselineTick;
+        bool hasBaseline;
+        if (!ReplicationSchema::ReadHeader(message.data(), message.size(), tick, hasBaseline, baselineTick)) {
+            m_Stats.DecodeErrors++;
+            return;
+        }
+        if (FindSnapshot(tick)) {
+            return;
+        }
+
+        // Replaces an empty slot or the oldest snapshot; late ones older than everything kept are dropped
+        ReplicationSnapshot* slot = nullptr;
+        for (ReplicationSnapshot& snapshot : m_History) {
+            if (!slot || snapshot.Tick < slot->Tick) {
+                slot = &snapshot;
+            }
+        }
+        if (slot->Tick > tick) {
+            return;
+        }
+
+        const ReplicationSnapshot* baseline = hasBaseline ? FindSnapshot(baselineTick) : nullptr;
+        if ((hasBaseline && !baseline) || !m_Schema.Decode(message.data(), message.size(), baseline, m_Decoded)) {
+            m_Stats.DecodeErrors++;
+            m_NeedsResync = true;
+            return;
+        }
+        if (!hasBaseline) {
+            m_NeedsResync = false;
+        }
+        // Decoded aside first, since the oldest slot may have been the baseline
+        std::swap(*slot, m_Decoded);
+
+        m_Stats.Snapshots++;
+        if (tick > m_NewestTick) {
+            m_NewestTick = tick;
+            m_Stats.Entities = (uint32_t)slot->Ids.size();
+        }
+    }
+
+    void ReplicationClient::AdvanceClock()
+    {
+        if (m_NewestTick == 0) {
+            return;
+        }
+        double target = (double)m_NewestTick - m_Config.InterpolationDelay;
+        if (!m_ClockStarted || std::fabs(target - m_RenderTick) > ClockSnapTicks) {
+            m_RenderTick = target;
+            m_ClockStarted = true;
+        } else {
+            m_RenderTick += 1.0;
+            m_RenderTick += (target - m_RenderTick) * ClockCorrection;
+        }
+        m_Stats.BufferedTicks = (float)(m_NewestTick - m_RenderTick);
+    }
+
+    const std::vector<ReplicatedEntity>& ReplicationClient::Interpolate(double interpolation_alpha)
+    {
+        m_Interpolated.clear();
+        if (!m_ClockStarted) {
+            return m_Interpolated;
+        }
+
+        // The two snapshots around the render time
+        double time = m_RenderTick - 1.0 + interpolation_alpha;
+        const ReplicationSnapshot* from = nullptr;
+        const ReplicationSnapshot* to = nullptr;
+        for (const ReplicationSnapshot& snapshot : m_History) {
+            if (snapshot.Tick == 0) {
+                continue;
+            }
+            if (snapshot.Tick <= time) {
+                if (!from || snapshot.Tick > from->Tick) {
+                    from = &snapshot;
+                }
+            } else if (!to || snapshot.Tick < to->Tick) {
+                to = &snapshot;
+            }
+        }
+        if (!to) {
+            m_Stats.StarvedFrames++;
+        }
+        if (!from) {
+            from = to;
+            to = nullptr;
+        }
+        if (!from) {
+            return m_Interpolated;
+        }
+
+        const uint32_t fieldCount = m_Schema.GetFieldCount();
+        float t = to ? (float)((time - from->Tick) / (double)(to->Tick - from->Tick)) : 0.0f;
+        size_t j = 0;
+        m_Interpolated.resize(from->Ids.size());
+        for (size_t i = 0; i < from->Ids.size(); ++i) {
+            ReplicatedEntity& entity = m_Interpolated[i];
+            entity.Id = from->Ids[i];
+            const uint32_t* a = &from->Values[i * fieldCount];
+            const uint32_t* b = nullptr;
+            if (to) {
+                while (j < to->Ids.size() && to->Ids[j] < entity.Id) {
+                    j++;
+                }
+                if (j < to->Ids.size() && to->Ids[j] == entity.Id) {
+                    b = &to->Values[j * fieldCount];
+                }
+            }
+            for (uint32_t f = 0; f < fieldCount; ++f) {
+                float value = m_Schema.Dequantize(f, a[f]);
+                if (b && m_Schema.GetField(f).Type == ReplicationSchema::FieldType::Float) {
+                    value += (m_Schema.Dequantize(f, b[f]) - value) * t;
+                }
+                entity.Values[f] = value;
+            }
+        }
+        return m_Interpolated;
+    }
+
+}
@@ -0,0 +1,247 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "NetConnection.h"
+#include "NetSocket.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // Replicated state of every entity at one server tick, quantized
+    struct ReplicationSnapshot {
+        uint32_t Tick = 0;                                  // 0 = empty
+        TaggedVector<uint32_t, MemoryTag::Network> Ids;     // Ascending
+        TaggedVector<uint32_t, MemoryTag::Network> Values;  // Ids.size() * field count
+
+        void Clear() { Tick = 0; Ids.clear(); Values.clear(); }
+    };
+
+    // The fields every replicated entity has, and how each is quantized on the wire. Floats are
+    // clamped to [min, max] and stored in steps no larger than `precision`. Ints and bools use
+    // exactly the bits their range needs. Server and client must build the same schema; the
+    // handshake compares hashes.
+    class ReplicationSchema {
+    public:
+        static constexpr uint32_t MaxFields = 16;
+
+        enum class FieldType : uint8_t { Float, Int, Bool };
+
+        struct Field {
+            std::string Name;
+            FieldType Type;
+            float Min;
+            float Max;
+            uint32_t Steps;     // Largest quantized value
+            uint32_t Bits;
+        };
+
+        // Each returns the field index
+        uint32_t AddFloat(const char* name, float min, float max, float precision);
+        uint32_t AddInt(const char* name, int32_t min, int32_t max);
+        uint32_t AddBool(const char* name);
+
+        uint32_t GetFieldCount() const { return (uint32_t)m_Fields.size(); }
+        const Field& GetField(uint32_t field) const { return m_Fields[field]; }
+        // ~0u when there is no such field
+        uint32_t GetFieldIndex(const char* name) const;
+        uint32_t GetBitsPerEntity() const;
+        uint32_t GetHash() const;
+
+        uint32_t Quantize(uint32_t field, float value) const;
+        float Dequantize(uint32_t field, uint32_t value) const;
+
+        // Writes `snapshot` as a delta against `baseline` (nullptr for a full snapshot). Only
+        // new and changed entities are sent, changed ones field by field, with small changes
+        // in a few bits. Then come the ids of removed entities.
+        void Encode(const ReplicationSnapshot* baseline, const ReplicationSnapshot& snapshot, std::vector<uint8_t>& out) const;
+        // Tick of an encoded snapshot and the tick of the baseline it needs, if any
+        static bool ReadHeader(const uint8_t* data, size_t size, uint32_t& tick, bool& hasBaseline, uint32_t& baselineTick);
+        // `baseline` must be the snapshot named by the header
+        bool Decode(const uint8_t* data, size_t size, const ReplicationSnapshot* baseline, ReplicationSnapshot& snapshot) const;
+
+    private:
+        uint32_t AddField(const char* name, FieldType type, float min, float max, uint32_t steps);
+
+        std::vector<Field> m_Fields;
+    };
+
+    struct ReplicationServerConfig {
+        uint32_t MaxClients = 32;
+        uint32_t SendInterval = 1;          // Send a snapshot every N ticks
+        double TimeoutSeconds = 5.0;
+    };
+
+    // Headless side of snapshot replication. Each fixed step the game writes the replicated
+    // state of every entity. When a send is due, each client gets the snapshot as a delta
+    // against the newest snapshot that client has acked. Lost packets are never resent: the
+    // next snapshot simply deltas against an older acked one. Client encodes run in parallel
+    // on the JobSystem.
+    class ReplicationServer {
+    public:
+        // Snapshots kept as baselines; clients keep as many
+        static constexpr uint32_t HistorySize = 32;
+
+        ReplicationServer(const ReplicationSchema& schema, const ReplicationServerConfig& config = ReplicationServerConfig());
+        ~ReplicationServer();
+
+        ReplicationServer(const ReplicationServer&) = delete;
+        ReplicationServer& operator=(const ReplicationServer&) = delete;
+
+        bool Start(uint16_t port);
+        void Stop();
+        bool IsRunning() const { return m_Socket.IsOpen(); }
+        uint16_t GetPort() const { return m_Socket.GetPort(); }
+        void SetConditions(const NetConditions& conditions) { m_Socket.SetConditions(conditions, 0x5EED); }
+
+        // Once per fixed step, before the snapshot: advances the tick, accepts connections,
+        // applies acks and drops clients that timed out
+        void Update(double fixed_dt);
+
+        // Values in schema field order; ints and bools are passed as floats too. Entities may
+        // come in any order.
+        void BeginSnapshot();
+        void WriteEntity(uint32_t id, const float* values);
+        // Sends the snapshot to every client when this tick is due
+        void EndSnapshot();
+
+        uint32_t GetTick() const { return m_Tick; }
+        uint32_t GetClientCount() const { return (uint32_t)m_Clients.size(); }
+
+        struct Stats {
+            uint32_t Clients = 0;
+            uint32_t Entities = 0;
+            float BytesPerClientPerSecond = 0.0f;   // Everything sent, headers included
+            float EncodeNsPerEntity = 0.0f;         // Quantize, delta and bit-pack, per client
+            float AverageSnapshotBytes = 0.0f;
+            uint32_t FullSnapshots = 0;             // Sent without a baseline
+            uint32_t DeltaSnapshots = 0;
+            float RttMs = 0.0f;                     // Averaged over clients
+            float PacketLossPercent = 0.0f;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        struct Client;
+
+        const ReplicationSnapshot* FindSnapshot(uint32_t tick) const;
+        void ReceivePackets();
+        void RemoveClient(size_t index, const char* reason);
+        void UpdateStats();
+
+        const ReplicationSchema& m_Schema;
+        ReplicationServerConfig m_Config;
+        NetSocket m_Socket;
+        std::vector<std::unique_ptr<Client>> m_Clients;
+
+        uint32_t m_Tick = 0;
+        double m_Time = 0.0;
+        ReplicationSnapshot m_History[HistorySize];
+        uint32_t m_SnapshotCount = 0;
+        // This tick's entities in WriteEntity order, already quantized
+        std::vector<uint32_t> m_PendingIds;
+        std::vector<uint32_t> m_PendingValues;
+        std::vector<uint32_t> m_Order;
+        bool m_PendingSorted = true;
+
+        double m_StatsWindowStart = 0.0;
+        uint64_t m_StatsBytes = 0;
+        double m_StatsClientSeconds = 0.0;     // Connected time summed over clients
+        uint64_t m_StatsEncodeNs = 0;
+        uint64_t m_StatsEncodedEntities = 0;
+        uint64_t m_StatsSnapshotBytes = 0;
+        uint32_t m_StatsSnapshots = 0;
+        Stats m_Stats;
+    };
+
+    // One entity as seen by the client, dequantized
+    struct ReplicatedEntity {
+        uint32_t Id;
+        float Values[ReplicationSchema::MaxFields];
+    };
+
+    struct ReplicationClientConfig {
+        // How far behind the newest snapshot the client renders, in ticks. It needs to cover
+        // the send interval plus jitter, or the client runs out of snapshots to interpolate.
+        uint32_t InterpolationDelay = 6;
+        double TimeoutSeconds = 5.0;
+        double ConnectRetrySeconds = 0.25;
+    };
+
+    // Receives snapshots, decodes them against the baselines they name, and acks every packet
+    // on the next Update. Rendering runs a few ticks behind the newest snapshot. It interpolates
+    // between the two snapshots around the render time, using the interpolation_alpha that
+    // OnRender receives. The render clock follows the server's tick rate and slowly corrects
+    // for drift. The client assumes the same fixed step as the server.
+    class ReplicationClient {
+    public:
+        static constexpr uint32_t HistorySize = ReplicationServer::HistorySize;
+
+        enum class State { Disconnected, Connecting, Connected };
+
+        ReplicationClient(const ReplicationSchema& schema, const ReplicationClientConfig& config = ReplicationClientConfig());
+        ~ReplicationClient();
+
+        ReplicationClient(const ReplicationClient&) = delete;
+        ReplicationClient& operator=(const ReplicationClient&) = delete;
+
+        bool Connect(const NetAddress& server);
+        void Disconnect();
+        State GetState() const { return m_State; }
+        void SetConditions(const NetConditions& conditions) { m_Socket.SetConditions(conditions, 0xC11E); }
+
+        // Once per fixed step: receives and decodes snapshots, sends acks, advances the render clock
+        void Update(double fixed_dt);
+
+        // Entities at the current render time. Floats are interpolated; ints and bools keep
+        // the older snapshot's value until the newer one is reached. An entity appears once its
+        // first snapshot is reached and stays until the render time passes its removal.
+        const std::vector<ReplicatedEntity>& Interpolate(double interpolation_alpha);
+
+        uint32_t GetNewestTick() const { return m_NewestTick; }
+        double GetRenderTick() const { return m_RenderTick; }
+
+        struct Stats {
+            uint32_t Snapshots = 0;
+            uint32_t DecodeErrors = 0;          // Missing baseline or corrupt data; a resync follows
+            uint32_t Entities = 0;              // In the newest snapshot
+            float BytesPerSecond = 0.0f;
+            float RttMs = 0.0f;
+            float BufferedTicks = 0.0f;         // Newest snapshot minus render time
+            uint32_t StarvedFrames = 0;         // Render time past the newest snapshot
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        void ReceivePackets();
+        void OnSnapshot(const std::vector<uint8_t>& message);
+        const ReplicationSnapshot* FindSnapshot(uint32_t tick) const;
+        void AdvanceClock();
+
+        const ReplicationSchema& m_Schema;
+        ReplicationClientConfig m_Config;
+        NetSocket m_Socket;
+        std::unique_ptr<NetConnection> m_Connection;
+        State m_State = State::Disconnected;
+        double m_Time = 0.0;
+        double m_ConnectStartTime = 0.0;
+        double m_LastConnectAttempt = 0.0;
+        bool m_NeedsResync = false;
+        std::vector<uint8_t> m_Message;
+
+        ReplicationSnapshot m_History[HistorySize];
+        ReplicationSnapshot m_Decoded;
+        uint32_t m_NewestTick = 0;
+        double m_RenderTick = 0.0;
+        bool m_ClockStarted = false;
+        std::vector<ReplicatedEntity> m_Interpolated;
+
+        double m_StatsWindowStart = 0.0;
+        uint64_t m_StatsBytes = 0;
+        Stats m_Stats;
+    };
+
+}
@@ -0,0 +1,245 @@
+#include "mrlpch.h"
+#include "IoUring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(__linux__)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+    #include <unistd.h>
+    #include <vector>
+#endif
+
+namespace Marle {
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "ring indices are mapped as atomics");
+
+    IoUring::~IoUring()
+    {
+        Shutdown();
+    }
+
+#if defined(__linux__)
+
+    static int Setup(uint32_t entries, io_uring_params& params)
+    {
+        return (int)syscall(__NR_io_uring_setup, entries, &params);
+    }
+
+    static int Enter(int ring, uint32_t toSubmit, uint32_t minComplete, uint32_t flags)
+    {
+        return (int)syscall(__NR_io_uring_enter, ring, toSubmit, minComplete, flags, nullptr, 0);
+    }
+
+    static int Register(int ring, uint32_t opcode, const void* arg, uint32_t count)
+    {
+        return (int)syscall(__NR_io_uring_register, ring, opcode, arg, count);
+    }
+
+    template<typename T>
+    static T* RingField(void* map, uint32_t offset)
+    {
+        return reinterpret_cast<T*>(static_cast<uint8_t*>(map) + offset);
+    }
+
+    bool IoUring::Init(uint32_t entries)
+    {
+        Shutdown();
+
+        io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        int ring = Setup(entries, params);
+        if (ring < 0) {
+            printf("Warning: io_uring is unavailable (%s)\n", strerror(errno));
+            return false;
+        }
+        m_Ring = ring;
+        m_Entries = params.sq_entries;
+
+        // Kernels since 5.4 map both rings with one mmap
+        m_SqMapBytes = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+        m_CqMapBytes = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) {
+            m_SqMapBytes = m_CqMapBytes = std::max(m_SqMapBytes, m_CqMapBytes);
+        }
+
+        m_SqMap = mmap(nullptr, m_SqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQ_RING);
+        if (m_SqMap == MAP_FAILED) {
+            m_SqMap = nullptr;
+            printf("Error: could not map the io_uring submission ring (%s)\n", strerror(errno));
+            Shutdown();
+            return false;
+        }
+        if (singleMap) {
+            m_CqMap = m_SqMap;
+        } else {
+            m_CqMap = mmap(nullptr, m_CqMapBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_CQ_RING);
+            if (m_CqMap == MAP_FAILED) {
+                m_CqMap = nullptr;
+                printf("Error: could not map the io_uring completion ring (%s)\n", strerror(errno));
+                Shutdown();
+                return false;
+            }
+        }
+        m_SqesBytes = params.sq_entries * sizeof(io_uring_sqe);
+        m_Sqes = mmap(nullptr, m_SqesBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring, IORING_OFF_SQES);
+        if (m_Sqes == MAP_FAILED) {
+            m_Sqes = nullptr;
+            printf("Error: could not map the io_uring submission entries (%s)\n", strerror(errno));
+            Shutdown();
+            return false;
+        }
+
+        m_SqHead = RingField<std::atomic<uint32_t>>(m_SqMap, params.sq_off.head);
+        m_SqTail = RingField<std::atomic<uint32_t>>(m_SqMap, params.sq_off.tail);
+        m_SqMask = *RingField<uint32_t>(m_SqMap, params.sq_off.ring_mask);
+        m_SqArray = RingField<uint32_t>(m_SqMap, params.sq_off.array);
+        m_CqHead = RingField<std::atomic<uint32_t>>(m_CqMap, params.cq_off.head);
+        m_CqTail = RingField<std::atomic<uint32_t>>(m_CqMap, params.cq_off.tail);
+        m_CqMask = *RingField<uint32_t>(m_CqMap, params.cq_off.ring_mask);
+        m_Cqes = RingField<void>(m_CqMap, params.cq_off.cqes);
+        m_LocalTail = m_SqTail->load(std::memory_order_relaxed);
+        m_Prepared = 0;
+        return true;
+    }
+
+    void IoUring::Shutdown()
+    {
+        if (m_Sqes) {
+            munmap(m_Sqes, m_SqesBytes);
+        }
+        if (m_CqMap && m_CqMap != m_SqMap) {
+            munmap(m_CqMap, m_CqMapBytes);
+        }
+        if (m_SqMap) {
+            munmap(m_SqMap, m_SqMapBytes);
+        }
+        if (m_Ring >= 0) {
+            close(m_Ring); // Also drops the registered buffers
+        }
+        m_Ring = -1;
+        m_Entries = 0;
+        m_SqMap = m_CqMap = m_Sqes = nullptr;
+        m_RegisteredBuffers = 0;
+        m_Prepared = 0;
+    }
+
+    bool IoUring::RegisterBuffers(uint8_t* const* buffers, size_t bufferBytes, uint32_t count)
+    {
+        if (!IsValid() || count == 0) {
+            return false;
+        }
+
+        std::vector<iovec> vectors(count);
+        for (uint32_t i = 0; i < count; i++) {
+            vectors[i].iov_base = buffers[i];
+            vectors[i].iov_len = bufferBytes;
+        }
+        if (Register(m_Ring, IORING_REGISTER_BUFFERS, vectors.data(), count) < 0) {
+            printf("Warning: could not register %u io_uring buffers (%s)\n", count, strerror(errno));
+            return false;
+        }
+        m_RegisteredBuffers = count;
+        return true;
+    }
+
+    bool IoUring::PrepareRead(int descriptor, void* dst, uint32_t size, uint64_t offset, uint64_t userData, int bufferIndex)
+    {
+        if (!IsValid() || m_LocalTail - m_SqHead->load(std::memory_order_acquire) >= m_Entries) {
+            return false;
+        }
+
+        uint32_t index = m_LocalTail & m_SqMask;
+        io_uring_sqe& sqe = static_cast<io_uring_sqe*>(m_Sqes)[index];
+        memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = bufferIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe.fd = descriptor;
+        sqe.off = offset;
+        sqe.addr = (uint64_t)(uintptr_t)dst;
+        sqe.len = size;
+        sqe.buf_index = bufferIndex >= 0 ? (uint16_t)bufferIndex : 0;
+        sqe.user_data = userData;
+        m_SqArray[index] = index;
+        m_LocalTail++;
+        m_Prepared++;
+        return true;
+    }
+
+    int IoUring::Submit(uint32_t waitFor)
+    {
+        if (!IsValid()) {
+            return -1;
+        }
+        if (m_Prepared == 0 && waitFor == 0) {
+            return 0;
+        }
+
+        // Publish the entries before the kernel looks at the tail
+        m_SqTail->store(m_LocalTail, std::memory_order_release);
+        int submitted;
+        do {
+            m_EnterCalls++;
+            submitted = Enter(m_Ring, m_Prepared, waitFor, waitFor > 0 ? IORING_ENTER_GETEVENTS : 0);
+        } while (submitted < 0 && errno == EINTR);
+        if (submitted < 0) {
+            return -1;
+        }
+        m_Prepared -= std::min((uint32_t)submitted, m_Prepared);
+        return submitted;
+    }
+
+    bool IoUring::PopCompletion(uint64_t& userData, int32_t& result)
+    {
+        if (!IsValid()) {
+            return false;
+        }
+        uint32_t head = m_CqHead->load(std::memory_order_relaxed);
+        if (head == m_CqTail->load(std::memory_order_acquire)) {
+            return false;
+        }
+        const io_uring_cqe& cqe = static_cast<const io_uring_cqe*>(m_Cqes)[head & m_CqMask];
+        userData = cqe.user_data;
+        result = cqe.res;
+        m_CqHead->store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+#else
+
+    bool IoUring::Init(uint32_t /*entries*/)
+    {
+        return false;
+    }
+
+    void IoUring::Shutdown()
+    {
+    }
+
+    bool IoUring::RegisterBuffers(uint8_t* const* /*buffers*/, size_t /*bufferBytes*/, uint32_t /*count*/)
+    {
+        return false;
+    }
+
+    bool IoUring::PrepareRead(int /*descriptor*/, void* /*dst*/, uint32_t /*size*/, uint64_t /*offset*/, uint64_t /*userData*/, int /*bufferIndex*/)
+    {
+        return false;
+    }
+
+    int IoUring::Submit(uint32_t /*waitFor*/)
+    {
+        return -1;
+    }
+
+    bool IoUring::PopCompletion(uint64_t& /*userData*/, int32_t& /*result*/)
+    {
+        return false;
+    }
+
+#endif
+
+}
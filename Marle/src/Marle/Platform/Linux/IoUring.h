@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../../Core.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Marle {
+
+    // Minimal io_uring reader over the raw syscalls (no liburing): one submission and completion
+    // ring pair, plain and fixed-buffer reads. Reads are prepared into the shared submission ring
+    // without a syscall, Submit() hands all of them to the kernel with one io_uring_enter, and
+    // completions are reaped straight from the completion ring.
+    //
+    // One thread at a time. Init() fails on kernels without io_uring or where it is blocked
+    // (seccomp, io_uring_disabled), and everywhere but Linux.
+    class IoUring {
+    public:
+        IoUring() = default;
+        ~IoUring();
+
+        IoUring(const IoUring&) = delete;
+        IoUring& operator=(const IoUring&) = delete;
+
+        bool Init(uint32_t entries);
+        void Shutdown();
+        bool IsValid() const { return m_Ring >= 0; }
+        uint32_t GetCapacity() const { return m_Entries; }
+
+        // Pins the buffers for READ_FIXED; fails with ENOMEM past RLIMIT_MEMLOCK
+        bool RegisterBuffers(uint8_t* const* buffers, size_t bufferBytes, uint32_t count);
+        bool HasRegisteredBuffers() const { return m_RegisteredBuffers > 0; }
+
+        // Queues a read; bufferIndex is a registered buffer `dst` lies in, or -1. False when the
+        // submission ring is full.
+        bool PrepareRead(int descriptor, void* dst, uint32_t size, uint64_t offset, uint64_t userData, int bufferIndex = -1);
+        uint32_t GetPrepared() const { return m_Prepared; }
+
+        // Submits everything prepared, blocking until at least `waitFor` completions are ready.
+        // Returns the number submitted, or -1 on error.
+        int Submit(uint32_t waitFor = 0);
+
+        // Next completion, if any; `result` is the byte count or -errno
+        bool PopCompletion(uint64_t& userData, int32_t& result);
+
+        uint64_t GetEnterCalls() const { return m_EnterCalls; }
+
+    private:
+        int m_Ring = -1;
+        uint32_t m_Entries = 0;
+        void* m_SqMap = nullptr;
+        void* m_CqMap = nullptr;
+        size_t m_SqMapBytes = 0;
+        size_t m_CqMapBytes = 0;
+        void* m_Sqes = nullptr;
+        size_t m_SqesBytes = 0;
+
+        std::atomic<uint32_t>* m_SqHead = nullptr;
+        std::atomic<uint32_t>* m_SqTail = nullptr;
+        uint32_t m_SqMask = 0;
+        uint32_t* m_SqArray = nullptr;
+        std::atomic<uint32_t>* m_CqHead = nullptr;
+        std::atomic<uint32_t>* m_CqTail = nullptr;
+        uint32_t m_CqMask = 0;
+        void* m_Cqes = nullptr;
+
+        uint32_t m_LocalTail = 0;       // SQ tail including prepared entries not yet published
+        uint32_t m_Prepared = 0;
+        uint32_t m_RegisteredBuffers = 0;
+        uint64_t m_EnterCalls = 0;
+    };
+
+}
@@ -0,0 +1,109 @@
+#include "mrlpch.h"
+#include "OpenGLFramebuffer.h"
+#include "../../Core/MemoryTracker.h"
+
+namespace Marle {
+
+    OpenGLFramebuffer::OpenGLFramebuffer(const FramebufferSpec& spec)
+        : m_Spec(spec)
+    {
+        Create();
+    }
+
+    OpenGLFramebuffer::~OpenGLFramebuffer()
+    {
+        Release();
+    }
+
+    size_t OpenGLFramebuffer::GetMemorySize(const FramebufferSpec& spec)
+    {
+        size_t texels = (size_t)spec.Width * spec.Height;
+        size_t colorBytes = spec.Format == FramebufferFormat::RGBA16F ? 8 : 4;
+        return texels * colorBytes + (spec.Depth ? texels * 4 : 0);
+    }
+
+    void OpenGLFramebuffer::Create()
+    {
+        if (m_Spec.Width == 0 || m_Spec.Height == 0) {
+            printf("Error: Cannot create a %ux%u framebuffer\n", m_Spec.Width, m_Spec.Height);
+            return;
+        }
+
+        glGenFramebuffers(1, &m_RendererID);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+
+        glGenTextures(1, &m_ColorAttachment);
+        glBindTexture(GL_TEXTURE_2D, m_ColorAttachment);
+        if (m_Spec.Format == FramebufferFormat::RGBA16F) {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16F, m_Spec.Width, m_Spec.Height, 0, GL_RGBA, GL_HALF_FLOAT, nullptr);
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Spec.Width, m_Spec.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_ColorAttachment, 0);
+
+        if (m_Spec.Depth) {
+            glGenRenderbuffers(1, &m_DepthAttachment);
+            glBindRenderbuffer(GL_RENDERBUFFER, m_DepthAttachment);
+            glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_Spec.Width, m_Spec.Height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_DepthAttachment);
+        }
+
+        GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        if (status != GL_FRAMEBUFFER_COMPLETE) {
+            printf("Error: Framebuffer %ux%u incomplete (status 0x%x)\n", m_Spec.Width, m_Spec.Height, status);
+            Release();
+            return;
+        }
+
+        m_MemorySize = GetMemorySize(m_Spec);
+        MemoryTracker::TrackGpu(MemoryTag::Renderer, (int64_t)m_MemorySize);
+    }
+
+    void OpenGLFramebuffer::Release()
+    {
+        if (m_DepthAttachment) {
+            glDeleteRenderbuffers(1, &m_DepthAttachment);
+            m_DepthAttachment = 0;
+        }
+        if (m_ColorAttachment) {
+            glDeleteTextures(1, &m_ColorAttachment);
+            m_ColorAttachment = 0;
+        }
+        if (m_RendererID) {
+            glDeleteFramebuffers(1, &m_RendererID);
+            m_RendererID = 0;
+        }
+        MemoryTracker::TrackGpu(MemoryTag::Renderer, -(int64_t)m_MemorySize);
+        m_MemorySize = 0;
+    }
+
+    void OpenGLFramebuffer::Bind() const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+        glViewport(0, 0, m_Spec.Width, m_Spec.Height);
+    }
+
+    void OpenGLFramebuffer::Unbind() const
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+    void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height)
+    {
+        if (width == m_Spec.Width && height == m_Spec.Height && m_RendererID) {
+            return;
+        }
+        Release();
+        m_Spec.Width = width;
+        m_Spec.Height = height;
+        Create();
+    }
+
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <glad/gl.h>
+
+namespace Marle {
+
+    enum class FramebufferFormat : uint8_t {
+        RGBA8 = 0,
+        RGBA16F     // HDR scene colour, bloom chains
+    };
+
+    struct FramebufferSpec {
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        FramebufferFormat Format = FramebufferFormat::RGBA8;
+        bool Depth = false;     // Adds a 24-bit depth / 8-bit stencil renderbuffer
+
+        bool operator==(const FramebufferSpec& other) const
+        {
+            return Width == other.Width && Height == other.Height && Format == other.Format && Depth == other.Depth;
+        }
+        bool operator!=(const FramebufferSpec& other) const { return !(*this == other); }
+    };
+
+    // Off-screen render target: one colour texture (sampled by later passes) and an optional
+    // depth-stencil renderbuffer. GPU memory is reported to MemoryTracker under Renderer.
+    class OpenGLFramebuffer {
+    public:
+        OpenGLFramebuffer(const FramebufferSpec& spec);
+        ~OpenGLFramebuffer();
+
+        OpenGLFramebuffer(const OpenGLFramebuffer&) = delete;
+        OpenGLFramebuffer& operator=(const OpenGLFramebuffer&) = delete;
+
+        bool IsValid() const { return m_RendererID != 0; }
+
+        // Binds as the draw target and sets the viewport to cover it
+        void Bind() const;
+        void Unbind() const;
+
+        // Recreates the attachments; contents are lost
+        void Resize(uint32_t width, uint32_t height);
+
+        const FramebufferSpec& GetSpec() const { return m_Spec; }
+        GLuint GetRendererID() const { return m_RendererID; }
+        GLuint GetColorAttachment() const { return m_ColorAttachment; }
+        size_t GetMemorySize() const { return m_MemorySize; }
+
+        static size_t GetMemorySize(const FramebufferSpec& spec);
+
+    private:
+        void Create();
+        void Release();
+
+        FramebufferSpec m_Spec;
+        GLuint m_RendererID = 0;
+        GLuint m_ColorAttachment = 0;
+        GLuint m_DepthAttachment = 0;
+        size_t m_MemorySize = 0;
+    };
+
+}
@@ -0,0 +1,153 @@
+#include "mrlpch.h"
+#include "OpenGLRendererBackend.h"
+#include "OpenGLTexture.h"
+#include "OpenGLVertexLayout.h"
+#include "../../Core/MemoryTracker.h"
+#include "../../Renderer/RenderProfiler.h"
+#include <glm/gtc/matrix_transform.hpp>
+
+namespace Marle {
+
+    const VertexBufferLayout& OpenGLRendererBackend::GetQuadLayout()
+    {
+        // Position (location 0) and texture coordinate (location 1)
+        static const VertexBufferLayout layout = VertexBufferLayout()
+            .Add(0, VertexFormat::Half2)
+            .Add(1, VertexFormat::UNorm16x2);
+        return layout;
+    }
+
+    OpenGLRendererBackend::OpenGLRendererBackend()
+    {
+        // Shared through the resource cache (path stem loads .vert + .frag)
+        m_TextureShader = ResourceManager::Load<OpenGLShader>("Assets/Shaders/Texture");
+
+        // Unit quad (-0.5 to 0.5) in 8-byte vertices; every coordinate is exact in half precision
+        const QuadVertex vertices[] = {
+            { PackHalf2({ -0.5f, -0.5f }), PackUNorm16x2({ 0.0f, 0.0f }) }, // Bottom-left
+            { PackHalf2({  0.5f, -0.5f }), PackUNorm16x2({ 1.0f, 0.0f }) }, // Bottom-right
+            { PackHalf2({  0.5f,  0.5f }), PackUNorm16x2({ 1.0f, 1.0f }) }, // Top-right
+            { PackHalf2({ -0.5f,  0.5f }), PackUNorm16x2({ 0.0f, 1.0f }) }  // Top-left
+        };
+
+        unsigned int indices[] = {
+            0, 1, 2, // First triangle
+            2, 3, 0  // Second triangle
+        };
+
+        glGenVertexArrays(1, &m_QuadVAO);
+        glBindVertexArray(m_QuadVAO);
+
+        glGenBuffers(1, &m_QuadVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_QuadVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+        glGenBuffers(1, &m_QuadEBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_QuadEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+        ApplyVertexLayout(GetQuadLayout());
+        glBindVertexArray(0);
+
+        m_GpuBytes = sizeof(vertices) + sizeof(indices);
+        MemoryTracker::TrackGpu(MemoryTag::Renderer, (int64_t)m_GpuBytes);
+    }
+
+    OpenGLRendererBackend::~OpenGLRendererBackend()
+    {
+        glDeleteVertexArrays(1, &m_QuadVAO);
+        glDeleteBuffers(1, &m_QuadVBO);
+        glDeleteBuffers(1, &m_QuadEBO);
+        MemoryTracker::TrackGpu(MemoryTag::Renderer, -(int64_t)m_GpuBytes);
+    }
+
+    void OpenGLRendererBackend::Clear(const glm::vec4& color)
+    {
+        glClearColor(color.x, color.y, color.z, color.w);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+
+    void OpenGLRendererBackend::BeginScene(const RenderSceneInfo& scene)
+    {
+        m_Scene = scene;
+        m_TextureShader->Bind();
+        m_TextureShader->SetUniformMat4f(Uniforms::ViewProjection, scene.ViewProjection);
+    }
+
+    void OpenGLRendererBackend::DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture)
+    {
+        // Create transform matrix
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f)) *
+                              glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f));
+        DrawQuad(transform, texture);
+    }
+
+    void OpenGLRendererBackend::DrawQuad(const glm::mat4& transform, Texture2D* texture)
+    {
+        if (texture->GetBackendType() != RendererBackendType::OpenGL) {
+            printf("Error: OpenGL backend cannot draw a software texture\n");
+            return;
+        }
+        OpenGLTexture2D* glTexture = static_cast<OpenGLTexture2D*>(texture);
+
+        // Mip streaming follows how large the texture is actually drawn: the unit quad's edges
+        // are as long as the transform's first two columns
+        float width = glm::length(glm::vec2(transform[0].x, transform[0].y));
+        float height = glm::length(glm::vec2(transform[1].x, transform[1].y));
+        glTexture->RequestScreenSize(width * m_Scene.Zoom, height * m_Scene.Zoom, m_Scene.FrameIndex);
+
+        // Bind texture
+        glTexture->Bind(0);
+
+        // Set texture uniform
+        m_TextureShader->SetUniform1i(Uniforms::Texture, 0);
+        m_TextureShader->SetUniformMat4f(Uniforms::Transform, transform);
+
+        // Straight-alpha "over" for colour; alpha accumulates like the software backend's
+        // premultiplied blend, so both leave the same target behind
+        glEnable(GL_BLEND);
+        glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+        // Draw quad
+        glBindVertexArray(m_QuadVAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        glBindVertexArray(0);
+        glDisable(GL_BLEND);
+        RenderProfiler::CountStateChange();
+        RenderProfiler::CountDraw(2);
+    }
+
+    void OpenGLRendererBackend::EndScene()
+    {
+        m_TextureShader->Unbind();
+    }
+
+    void OpenGLRendererBackend::Blit(GLuint texture, const glm::vec2& min, const glm::vec2& max)
+    {
+        // The unit quad spans -0.5..0.5; map it straight to clip space
+        glm::vec2 center = (min + max) - glm::vec2(1.0f);
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(center, 0.0f)) *
+                              glm::scale(glm::mat4(1.0f), glm::vec3((max - min) * 2.0f, 1.0f));
+
+        GLboolean blend = glIsEnabled(GL_BLEND);
+        glDisable(GL_BLEND);
+        m_TextureShader->Bind();
+        m_TextureShader->SetUniformMat4f(Uniforms::ViewProjection, glm::mat4(1.0f));
+        m_TextureShader->SetUniformMat4f(Uniforms::Transform, transform);
+        m_TextureShader->SetUniform1i(Uniforms::Texture, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glBindVertexArray(m_QuadVAO);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+        glBindVertexArray(0);
+        RenderProfiler::CountStateChange();
+        RenderProfiler::CountDraw(2);
+
+        // Leave the scene's projection in place for draws that follow
+        m_TextureShader->SetUniformMat4f(Uniforms::ViewProjection, m_Scene.ViewProjection);
+        if (blend) {
+            glEnable(GL_BLEND);
+        }
+    }
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../../Renderer/RendererBackend.h"
+#include "../../Renderer/VertexBufferLayout.h"
+#include "../../Core/ResourceManager.h"
+#include "../../Core/StringId.h"
+#include "OpenGLShader.h"
+#include <glad/gl.h>
+
+namespace Marle {
+
+    // Uniform names used by the engine's shaders. Interned, so debug builds can name one a shader lacks.
+    namespace Uniforms {
+        inline const StringId ViewProjection = StringId::Intern("u_ViewProjection");
+        inline const StringId Transform = StringId::Intern("u_Transform");
+        inline const StringId Texture = StringId::Intern("u_Texture");
+        inline const StringId Size = StringId::Intern("u_Size");
+        inline const StringId FadeOut = StringId::Intern("u_FadeOut");
+        inline const StringId Time = StringId::Intern("u_Time");
+        inline const StringId TileUVSize = StringId::Intern("u_TileUVSize");
+        inline const StringId Atlas = StringId::Intern("u_Atlas");
+    }
+
+    // Draws quads with the texture shader, one draw call each. Needs a current GL context and
+    // an initialized ResourceManager. Quads are alpha-blended over the target.
+    class OpenGLRendererBackend : public RendererBackend {
+    public:
+        OpenGLRendererBackend();
+        ~OpenGLRendererBackend() override;
+
+        RendererBackendType GetType() const override { return RendererBackendType::OpenGL; }
+        const char* GetName() const override { return "OpenGL"; }
+        bool IsValid() const { return (bool)m_TextureShader; }
+
+        void Clear(const glm::vec4& color) override;
+        void BeginScene(const RenderSceneInfo& scene) override;
+        void DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture) override;
+        void EndScene() override;
+        // Unit quad (-0.5 to 0.5) placed by a full model transform, e.g. rotated
+        void DrawQuad(const glm::mat4& transform, Texture2D* texture);
+
+        // Copies a GL texture over part of the viewport, in 0-1 viewport coordinates, then
+        // restores the scene's projection
+        void Blit(GLuint texture, const glm::vec2& min, const glm::vec2& max);
+
+        // For Renderer2D's GL-only paths that share the texture shader and unit quad
+        OpenGLShader* GetTextureShader() const { return m_TextureShader.Get(); }
+        GLuint GetQuadVertexBuffer() const { return m_QuadVBO; }
+        GLuint GetQuadIndexBuffer() const { return m_QuadEBO; }
+        static const VertexBufferLayout& GetQuadLayout();
+
+    private:
+        struct QuadVertex {
+            uint32_t Position;      // VertexFormat::Half2
+            uint32_t TexCoord;      // VertexFormat::UNorm16x2
+        };
+
+        ResourceHandle<OpenGLShader> m_TextureShader;
+        GLuint m_QuadVAO = 0;
+        GLuint m_QuadVBO = 0;
+        GLuint m_QuadEBO = 0;
+        size_t m_GpuBytes = 0;
+        RenderSceneInfo m_Scene;
+    };
+
+}
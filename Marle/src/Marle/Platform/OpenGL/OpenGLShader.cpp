@@ -1,22 +1,40 @@
 #include "mrlpch.h"
 #include "OpenGLShader.h"
-#include <fstream>
-#include <sstream>
+#include "../../Core/FileSystem.h"
+#include "../../Renderer/RenderProfiler.h"
+#include <algorithm>
+#include <cstring>
 #include <glm/gtc/type_ptr.hpp>
 
 namespace Marle {
 
     OpenGLShader::OpenGLShader(const std::string& vertexSrcPath, const std::string& fragmentSrcPath)
     {
-        std::string vertexSource = ReadFile(vertexSrcPath);
-        std::string fragmentSource = ReadFile(fragmentSrcPath);
-        
-        if (vertexSource.empty() || fragmentSource.empty()) {
-            printf("Failed to read shader files!\n");
+        Sources sources;
+        if (!ReadSources(vertexSrcPath, fragmentSrcPath, sources)) {
             return;
         }
 
-        m_RendererID = CreateProgram(vertexSource, fragmentSource);
+        m_RendererID = CreateProgram(sources.Vertex, sources.Fragment);
+        ReflectUniforms();
+    }
+
+    OpenGLShader::OpenGLShader(const Sources& sources)
+    {
+        m_RendererID = CreateProgram(sources.Vertex, sources.Fragment);
+        ReflectUniforms();
+    }
+
+    bool OpenGLShader::ReadSources(const std::string& vertexSrcPath, const std::string& fragmentSrcPath, Sources& sources)
+    {
+        sources.Vertex = ReadFile(vertexSrcPath);
+        sources.Fragment = ReadFile(fragmentSrcPath);
+        
+        if (sources.Vertex.empty() || sources.Fragment.empty()) {
+            printf("Failed to read shader files!\n");
+            return false;
+        }
+        return true;
     }
 
     OpenGLShader::~OpenGLShader()
@@ -27,6 +45,7 @@ namespace Marle {
     void OpenGLShader::Bind() const
     {
         glUseProgram(m_RendererID);
+        RenderProfiler::CountStateChange();
     }
 
     void OpenGLShader::Unbind() const
@@ -34,13 +53,25 @@ namespace Marle {
         glUseProgram(0);
     }
 
-    void OpenGLShader::SetUniform1i(const std::string& name, int value)
+    void OpenGLShader::SetUniform1i(StringId name, int value)
     {
         GLint location = GetUniformLocation(name);
         glUniform1i(location, value);
     }
 
-    void OpenGLShader::SetUniformMat4f(const std::string& name, const glm::mat4& matrix)
+    void OpenGLShader::SetUniform1f(StringId name, float value)
+    {
+        GLint location = GetUniformLocation(name);
+        glUniform1f(location, value);
+    }
+
+    void OpenGLShader::SetUniform2f(StringId name, const glm::vec2& value)
+    {
+        GLint location = GetUniformLocation(name);
+        glUniform2f(location, value.x, value.y);
+    }
+
+    void OpenGLShader::SetUniformMat4f(StringId name, const glm::mat4& matrix)
     {
         GLint location = GetUniformLocation(name);
         glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
@@ -48,17 +79,12 @@ namespace Marle {
 
     std::string OpenGLShader::ReadFile(const std::string& filepath)
     {
-        std::ifstream file(filepath);
-        if (!file.is_open()) {
+        std::string source;
+        if (!FileSystem::ReadTextFile(filepath, source)) {
             printf("Failed to open shader file: %s\n", filepath.c_str());
             return "";
         }
-
-        std::stringstream buffer;
-        buffer << file.rdbuf();
-        file.close();
-
-        return buffer.str();
+        return source;
     }
 
     GLuint OpenGLShader::CompileShader(GLenum type, const std::string& source)
@@ -131,13 +157,86 @@ namespace Marle {
         return program;
     }
 
-    GLint OpenGLShader::GetUniformLocation(const std::string& name)
+    void OpenGLShader::ReflectUniforms()
+    {
+        m_Uniforms.assign(16, UniformSlot());
+        m_UniformCount = 0;
+        if (m_RendererID == 0) {
+            return;
+        }
+
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(m_RendererID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<char> name((size_t)std::max(maxLength, 1));
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(m_RendererID, (GLuint)i, (GLsizei)name.size(), &length, &size, &type, name.data());
+            GLint location = glGetUniformLocation(m_RendererID, name.data());
+            if (location < 0) {
+                continue;   // Uniform block member
+            }
+            InsertUniform(StringId(name.data(), (size_t)length), location);
+            // Arrays are reported as "name[0]"; also answer to the bare name
+            if (length > 3 && strcmp(name.data() + length - 3, "[0]") == 0) {
+                InsertUniform(StringId(name.data(), (size_t)length - 3), location);
+            }
+        }
+    }
+
+    void OpenGLShader::InsertUniform(StringId name, GLint location)
+    {
+        if ((m_UniformCount + 1) * 2 > m_Uniforms.size()) {
+            std::vector<UniformSlot> old;
+            old.swap(m_Uniforms);
+            m_Uniforms.assign(old.size() * 2, UniformSlot());
+            m_UniformCount = 0;
+            for (const UniformSlot& slot : old) {
+                if (slot.Name != 0) {
+                    InsertUniform(StringId::FromHash(slot.Name), slot.Location);
+                }
+            }
+        }
+
+        size_t mask = m_Uniforms.size() - 1;
+        for (size_t i = (size_t)name.GetHash() & mask;; i = (i + 1) & mask) {
+            if (m_Uniforms[i].Name == 0 || m_Uniforms[i].Name == name.GetHash()) {
+                m_UniformCount += m_Uniforms[i].Name == 0 ? 1 : 0;
+                m_Uniforms[i].Name = name.GetHash();
+                m_Uniforms[i].Location = location;
+                return;
+            }
+        }
+    }
+
+    const OpenGLShader::UniformSlot* OpenGLShader::FindUniform(StringId name) const
+    {
+        if (m_Uniforms.empty()) {
+            return nullptr;
+        }
+        size_t mask = m_Uniforms.size() - 1;
+        for (size_t i = (size_t)name.GetHash() & mask;; i = (i + 1) & mask) {
+            if (m_Uniforms[i].Name == name.GetHash()) {
+                return &m_Uniforms[i];
+            }
+            if (m_Uniforms[i].Name == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    GLint OpenGLShader::GetUniformLocation(StringId name)
     {
-        GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-        if (location == -1) {
-            printf("Warning: uniform '%s' not found\n", name.c_str());
+        const UniformSlot* slot = FindUniform(name);
+        if (slot) {
+            return slot->Location;
         }
-        return location;
+        // Remembered as -1 so the warning appears once per name
+        printf("Warning: uniform '%s' not found\n", name.GetString());
+        InsertUniform(name, -1);
+        return -1;
     }
 
-} 
\ No newline at end of file
+}
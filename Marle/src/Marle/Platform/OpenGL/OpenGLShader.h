@@ -1,6 +1,8 @@
 #pragma once
 
+#include "../../Core/StringId.h"
 #include <string>
+#include <vector>
 #include <glad/gl.h>
 #include <glm/glm.hpp>
 
@@ -8,23 +10,69 @@ namespace Marle {
     
     class OpenGLShader {
     public:
+        struct Sources {
+            std::string Vertex;
+            std::string Fragment;
+        };
+
         OpenGLShader(const std::string& vertexSrcPath, const std::string& fragmentSrcPath);
+        // Compiles sources that were already read (e.g. on a loader thread)
+        OpenGLShader(const Sources& sources);
         ~OpenGLShader();
 
+        // File reads only, no GL calls; safe off the render thread
+        static bool ReadSources(const std::string& vertexSrcPath, const std::string& fragmentSrcPath, Sources& sources);
+
+        bool IsValid() const { return m_RendererID != 0; }
+
         void Bind() const;
         void Unbind() const;
 
-        // Utility functions to set uniforms
-        void SetUniform1i(const std::string& name, int value);
-        void SetUniformMat4f(const std::string& name, const glm::mat4& matrix);
+        // Utility functions to set uniforms. Locations come from a table filled at link time,
+        // so setting one by name is a probe on the name's hash.
+        void SetUniform1i(StringId name, int value);
+        void SetUniform1f(StringId name, float value);
+        void SetUniform2f(StringId name, const glm::vec2& value);
+        void SetUniformMat4f(StringId name, const glm::mat4& matrix);
+        bool HasUniform(StringId name) const { return FindUniform(name) != nullptr; }
+
+        // Literal names are interned in debug builds, so a missing uniform is reported by name
+        // rather than by hash
+        template<size_t N> void SetUniform1i(const char (&name)[N], int value) { SetUniform1i(LiteralId(name), value); }
+        template<size_t N> void SetUniform1f(const char (&name)[N], float value) { SetUniform1f(LiteralId(name), value); }
+        template<size_t N> void SetUniform2f(const char (&name)[N], const glm::vec2& value) { SetUniform2f(LiteralId(name), value); }
+        template<size_t N> void SetUniformMat4f(const char (&name)[N], const glm::mat4& matrix) { SetUniformMat4f(LiteralId(name), matrix); }
 
     private:
-        std::string ReadFile(const std::string& filepath);
+        template<size_t N>
+        static StringId LiteralId(const char (&name)[N])
+        {
+        #ifdef MRL_DEBUG
+            return StringId::Intern(name);
+        #else
+            return StringId(name);
+        #endif
+        }
+
+        static std::string ReadFile(const std::string& filepath);
         GLuint CompileShader(GLenum type, const std::string& source);
         GLuint CreateProgram(const std::string& vertexShader, const std::string& fragmentShader);
-        GLint GetUniformLocation(const std::string& name);
+
+        // Open addressing on the name hash, power-of-two sized, at most half full
+        struct UniformSlot {
+            uint64_t Name = 0;      // 0 = empty
+            GLint Location = -1;
+        };
+
+        // Fills the uniform table from the program's active uniforms
+        void ReflectUniforms();
+        void InsertUniform(StringId name, GLint location);
+        const UniformSlot* FindUniform(StringId name) const;
+        GLint GetUniformLocation(StringId name);
 
         GLuint m_RendererID = 0;
+        std::vector<UniformSlot> m_Uniforms;
+        uint32_t m_UniformCount = 0;
     };
 
 } 
\ No newline at end of file
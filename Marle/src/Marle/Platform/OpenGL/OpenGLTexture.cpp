@@ -1,58 +1,127 @@
 #include "mrlpch.h"
 #include "OpenGLTexture.h"
+#include "../../Core/FileSystem.h"
+#include "../../Renderer/DDSFile.h"
+#include "../../Renderer/ImageDecoder.h"
+#include "../../Renderer/MipGenerator.h"
+#include "../../Renderer/RenderProfiler.h"
+#include "../../Renderer/TextureStreamer.h"
+#include "../../Core/MemoryTracker.h"
 
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
+#include <algorithm>
+#include <cmath>
 
 namespace Marle {
 
+    static GLenum GetCompressedInternalFormat(TextureFormat format)
+    {
+        switch (format) {
+            case TextureFormat::BC1: return GLAD_GL_EXT_texture_compression_s3tc ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT : 0;
+            case TextureFormat::BC3: return GLAD_GL_EXT_texture_compression_s3tc ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT : 0;
+            case TextureFormat::BC7: return GLAD_GL_ARB_texture_compression_bptc ? GL_COMPRESSED_RGBA_BPTC_UNORM_ARB : 0;
+            default:                 return 0;
+        }
+    }
+
+    static bool IsDDSPath(const std::string& path)
+    {
+        return path.size() > 4 && path.compare(path.size() - 4, 4, ".dds") == 0;
+    }
+
     OpenGLTexture2D::OpenGLTexture2D(const std::string& path)
         : m_FilePath(path)
     {
-        // Load image data
-        stbi_set_flip_vertically_on_load(1); // Flip Y coordinate to match OpenGL
-        m_LocalBuffer = stbi_load(path.c_str(), &m_Width, &m_Height, &m_BPP, 4); // Force 4 channels (RGBA)
-        
-        if (!m_LocalBuffer) {
+        SourceLevels source;
+        if (!ReadLevels(path, 0, source)) {
+            printf("Failed to load texture: %s\n", path.c_str());
+            return;
+        }
+        Create(source);
+    }
+
+    OpenGLTexture2D::OpenGLTexture2D(const std::string& path, SourceLevels& source)
+        : m_FilePath(path)
+    {
+        if (source.Levels.empty() || source.Levels[0].empty()) {
             printf("Failed to load texture: %s\n", path.c_str());
-            printf("STB Error: %s\n", stbi_failure_reason());
             return;
         }
+        Create(source);
+    }
+
+    void OpenGLTexture2D::Create(SourceLevels& source)
+    {
+        const std::string& path = m_FilePath;
+        if (!source.BottomUp) {
+            printf("Warning: %s was not written by MarleTexConv, it will appear upside down\n", path.c_str());
+        }
 
-        printf("Loaded texture: %s (%dx%d, %d channels)\n", path.c_str(), m_Width, m_Height, m_BPP);
+        m_Width = (int)source.Width;
+        m_Height = (int)source.Height;
+        m_BPP = source.Channels;
+        m_SourceFormat = source.Format;
+        m_InternalFormat = GetCompressedInternalFormat(source.Format);
+        m_Format = m_InternalFormat ? source.Format : TextureFormat::RGBA8;
+        if (!m_InternalFormat && source.Format != TextureFormat::RGBA8) {
+            printf("Warning: no %s support, decoding %s to RGBA8\n", GetTextureFormatName(source.Format), path.c_str());
+        }
+
+        m_MipCount = (uint32_t)source.Levels.size();
+        m_TailMip = m_MipCount - 1;
+        for (uint32_t level = 0; level < m_MipCount; level++) {
+            if ((std::max(source.Width, source.Height) >> level) <= TextureStreamer::TailSize) {
+                m_TailMip = level;
+                break;
+            }
+        }
+
+        // With the streamer running only the tail goes up now; the rest arrives once something draws it
+        m_Streamed = TextureStreamer::IsInitialized() && m_TailMip > 0;
+        m_ResidentMip = m_Streamed ? m_TailMip : 0;
+        m_RequestedMip = m_ResidentMip;
 
         // Generate OpenGL texture
         glGenTextures(1, &m_RendererID);
         glBindTexture(GL_TEXTURE_2D, m_RendererID);
 
         // Set texture parameters
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, m_MipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
         glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)m_MipCount - 1);
 
         // Upload texture data
-        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_LocalBuffer);
+        for (uint32_t level = m_ResidentMip; level < m_MipCount; level++) {
+            UploadLevel(level, source.Levels[level]);
+        }
+        SetResidentMip(m_ResidentMip);
 
         // Unbind texture
         glBindTexture(GL_TEXTURE_2D, 0);
 
-        // Free image data
-        if (m_LocalBuffer) {
-            stbi_image_free(m_LocalBuffer);
-            m_LocalBuffer = nullptr;
+        if (m_Streamed) {
+            TextureStreamer::Register(this);
         }
+
+        printf("Loaded texture: %s (%dx%d, %s, %u mips, resident from mip %u)\n", path.c_str(), m_Width, m_Height,
+               GetTextureFormatName(m_Format), m_MipCount, m_ResidentMip);
     }
 
     OpenGLTexture2D::~OpenGLTexture2D()
     {
+        if (m_Streamed) {
+            TextureStreamer::Unregister(this);
+        }
         glDeleteTextures(1, &m_RendererID);
+        MemoryTracker::TrackGpu(MemoryTag::Assets, -(int64_t)m_MemorySize);
     }
 
     void OpenGLTexture2D::Bind(uint32_t slot) const
     {
         glActiveTexture(GL_TEXTURE0 + slot);
         glBindTexture(GL_TEXTURE_2D, m_RendererID);
+        RenderProfiler::CountStateChange();
     }
 
     void OpenGLTexture2D::Unbind() const
@@ -60,4 +129,136 @@ namespace Marle {
         glBindTexture(GL_TEXTURE_2D, 0);
     }
 
+    void OpenGLTexture2D::RequestScreenSize(float width, float height, uint64_t frame)
+    {
+        if (!m_Streamed) {
+            return;
+        }
+
+        // Level whose texels map roughly 1:1 to screen pixels; what trilinear filtering samples anyway
+        float ratio = std::max((float)m_Width / std::max(width, 1.0f), (float)m_Height / std::max(height, 1.0f));
+        uint32_t level = ratio > 1.0f ? (uint32_t)std::floor(std::log2(ratio)) : 0;
+        level = std::min(level, m_TailMip);
+
+        if (frame != m_RequestFrame) {
+            m_RequestFrame = frame;
+            m_RequestedMip = level;
+        } else {
+            m_RequestedMip = std::min(m_RequestedMip, level);
+        }
+    }
+
+    static void TakeDDSLevels(DDSImage& image, OpenGLTexture2D::SourceLevels& source)
+    {
+        source.Format = image.Format;
+        source.Width = image.Width;
+        source.Height = image.Height;
+        source.Channels = 4;
+        source.BottomUp = image.BottomUp;
+        source.Levels = std::move(image.Levels);
+    }
+
+    bool OpenGLTexture2D::ReadLevels(const std::string& path, uint32_t firstLevel, SourceLevels& source)
+    {
+        if (IsDDSPath(path)) {
+            // Only the requested levels are read
+            DDSImage image;
+            if (!LoadDDS(path, image, firstLevel)) {
+                return false;
+            }
+            TakeDDSLevels(image, source);
+            return true;
+        }
+
+        FileBuffer file;
+        if (!FileSystem::ReadFile(path, file)) {
+            printf("Error: could not read %s\n", path.c_str());
+            return false;
+        }
+        return ReadLevels(path, file.GetData(), file.GetSize(), firstLevel, source);
+    }
+
+    bool OpenGLTexture2D::ReadLevels(const std::string& path, const uint8_t* data, size_t size, uint32_t firstLevel, SourceLevels& source)
+    {
+        if (IsDDSPath(path)) {
+            DDSImage image;
+            if (!LoadDDSMemory(path, data, size, image, firstLevel)) {
+                return false;
+            }
+            TakeDDSLevels(image, source);
+            return true;
+        }
+
+        // Decoded straight into level 0, bottom-up, and the rest of the chain is built from it in place
+        ImageInfo info;
+        source.Levels.resize(1);
+        if (!LoadImageMemory(data, size, info, source.Levels[0])) {
+            printf("Error: failed to decode %s (%s)\n", path.c_str(), GetImageDecodeError());
+            source.Levels.clear();
+            return false;
+        }
+
+        source.Format = TextureFormat::RGBA8;
+        source.Width = info.Width;
+        source.Height = info.Height;
+        source.Channels = info.Channels;
+        source.BottomUp = true;
+        GenerateMipChain(source.Levels[0].data(), source.Width, source.Height, source.Levels);
+
+        for (uint32_t level = 0; level < firstLevel && level < source.Levels.size(); level++) {
+            std::vector<uint8_t>().swap(source.Levels[level]);
+        }
+        return true;
+    }
+
+    size_t OpenGLTexture2D::GetLevelSize(uint32_t level) const
+    {
+        return GetTextureDataSize(m_Format, std::max((uint32_t)m_Width >> level, 1u), std::max((uint32_t)m_Height >> level, 1u));
+    }
+
+    void OpenGLTexture2D::UploadLevel(uint32_t level, const std::vector<uint8_t>& data)
+    {
+        uint32_t width = std::max((uint32_t)m_Width >> level, 1u);
+        uint32_t height = std::max((uint32_t)m_Height >> level, 1u);
+
+        if (m_InternalFormat) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, level, m_InternalFormat, width, height, 0, (GLsizei)data.size(), data.data());
+        } else if (m_SourceFormat != TextureFormat::RGBA8) {
+            std::vector<uint8_t> decoded;
+            DecompressImage(data.data(), width, height, m_SourceFormat, decoded);
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, decoded.data());
+        } else {
+            glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
+        }
+        m_MemorySize += GetLevelSize(level);
+        RenderProfiler::CountTextureUpload(data.size());
+        MemoryTracker::TrackGpu(MemoryTag::Assets, (int64_t)GetLevelSize(level));
+    }
+
+    void OpenGLTexture2D::SetResidentMip(uint32_t level)
+    {
+        m_ResidentMip = level;
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)level);
+    }
+
+    void OpenGLTexture2D::EvictTo(uint32_t level)
+    {
+        if (level <= m_ResidentMip) {
+            return;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, m_RendererID);
+        uint32_t previous = m_ResidentMip;
+        SetResidentMip(level);
+
+        // Respecifying a level as 0x0 releases its storage; it sits below the base level so the
+        // texture stays complete
+        for (uint32_t l = previous; l < level; l++) {
+            glTexImage2D(GL_TEXTURE_2D, l, GL_RGBA8, 0, 0, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            m_MemorySize -= GetLevelSize(l);
+            MemoryTracker::TrackGpu(MemoryTag::Assets, -(int64_t)GetLevelSize(l));
+        }
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
 } 
\ No newline at end of file
@@ -1,27 +1,83 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <glad/gl.h>
+#include "../../Renderer/RendererBackend.h"
+#include "../../Renderer/TextureCompression.h"
 
 namespace Marle {
     
-    class OpenGLTexture2D {
+    // Loads any image format ImageDecoder reads (TGA and PNG natively, the rest through stb_image),
+    // or a .dds (BC1/BC3/BC7) which is uploaded compressed when the driver supports it and decoded
+    // to RGBA8 on the CPU otherwise.
+    //
+    // Every texture has a full mip chain, taken from the .dds or generated on load. While the
+    // TextureStreamer is running a texture starts with only its small tail levels resident; the
+    // renderer reports how large it is drawn and the streamer loads or evicts the bigger levels.
+    class OpenGLTexture2D : public Texture2D {
     public:
+        struct SourceLevels {
+            TextureFormat Format = TextureFormat::RGBA8;
+            uint32_t Width = 0, Height = 0;
+            int Channels = 4;
+            bool BottomUp = true;
+            std::vector<std::vector<uint8_t>> Levels; // Entries below the first requested level are empty
+        };
+
         OpenGLTexture2D(const std::string& path);
-        ~OpenGLTexture2D();
+        // Uploads levels already read with ReadLevels (e.g. on a loader thread); path is kept for streaming
+        OpenGLTexture2D(const std::string& path, SourceLevels& source);
+        ~OpenGLTexture2D() override;
+
+        // Reads levels [firstLevel, count) of an image file; no GL calls, safe to call from job threads
+        static bool ReadLevels(const std::string& path, uint32_t firstLevel, SourceLevels& source);
+        // Same, from the whole file already in memory (read with FileSystem::ReadAsync)
+        static bool ReadLevels(const std::string& path, const uint8_t* data, size_t size, uint32_t firstLevel, SourceLevels& source);
 
         void Bind(uint32_t slot = 0) const;
         void Unbind() const;
 
-        int GetWidth() const { return m_Width; }
-        int GetHeight() const { return m_Height; }
+        RendererBackendType GetBackendType() const override { return RendererBackendType::OpenGL; }
+        int GetWidth() const override { return m_Width; }
+        int GetHeight() const override { return m_Height; }
         GLuint GetRendererID() const { return m_RendererID; }
+        // Format as stored on the GPU (RGBA8 when a compressed file had to be decoded)
+        TextureFormat GetFormat() const { return m_Format; }
+        // GPU bytes of the levels currently resident
+        size_t GetMemorySize() const { return m_MemorySize; }
+        uint32_t GetMipCount() const { return m_MipCount; }
+        // Largest resident level; 0 means full resolution is on the GPU
+        uint32_t GetResidentMip() const { return m_ResidentMip; }
+
+        // Called by the renderer per draw with the approximate on-screen size in pixels
+        void RequestScreenSize(float width, float height, uint64_t frame);
 
     private:
+        friend class TextureStreamer;
+
+        void Create(SourceLevels& source);
+        size_t GetLevelSize(uint32_t level) const;
+        // Uploads one level given in the file's format, decoding it first when needed
+        void UploadLevel(uint32_t level, const std::vector<uint8_t>& data);
+        void SetResidentMip(uint32_t level);
+        // Frees every level above the given one
+        void EvictTo(uint32_t level);
+
         GLuint m_RendererID = 0;
         std::string m_FilePath;
-        unsigned char* m_LocalBuffer = nullptr;
         int m_Width = 0, m_Height = 0, m_BPP = 0; // Bits Per Pixel (or channels)
+        TextureFormat m_SourceFormat = TextureFormat::RGBA8;
+        TextureFormat m_Format = TextureFormat::RGBA8;
+        GLenum m_InternalFormat = 0; // Compressed GL format, 0 when stored as RGBA8
+        size_t m_MemorySize = 0;
+
+        uint32_t m_MipCount = 1;
+        uint32_t m_ResidentMip = 0;
+        uint32_t m_TailMip = 0;      // Levels from here down are always resident
+        uint32_t m_RequestedMip = 0; // Sharpest level asked for during m_RequestFrame
+        uint64_t m_RequestFrame = 0;
+        bool m_Streamed = false;
     };
 
 } 
\ No newline at end of file
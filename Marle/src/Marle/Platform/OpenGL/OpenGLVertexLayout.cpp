@@ -0,0 +1,43 @@
+#include "mrlpch.h"
+#include "OpenGLVertexLayout.h"
+
+namespace Marle {
+
+    static GLenum GetComponentType(VertexFormat format)
+    {
+        switch (format) {
+            case VertexFormat::Float:
+            case VertexFormat::Float2:
+            case VertexFormat::Float3:
+            case VertexFormat::Float4:      return GL_FLOAT;
+            case VertexFormat::Half2:
+            case VertexFormat::Half4:       return GL_HALF_FLOAT;
+            case VertexFormat::UNorm16x2:   return GL_UNSIGNED_SHORT;
+            case VertexFormat::SNorm16x2:   return GL_SHORT;
+            case VertexFormat::UNorm8x4:
+            case VertexFormat::UByte4:
+            case VertexFormat::UInt8x4:     return GL_UNSIGNED_BYTE;
+            case VertexFormat::Int:         return GL_INT;
+            case VertexFormat::UInt:        return GL_UNSIGNED_INT;
+            default:                        return GL_FLOAT;
+        }
+    }
+
+    void ApplyVertexLayout(const VertexBufferLayout& layout)
+    {
+        const GLsizei stride = (GLsizei)layout.GetStride();
+        for (const VertexAttribute& attribute : layout.GetAttributes()) {
+            const VertexFormatInfo& info = GetVertexFormatInfo(attribute.Format);
+            const void* offset = (const void*)(uintptr_t)attribute.Offset;
+            if (info.Integer) {
+                glVertexAttribIPointer(attribute.Location, (GLint)info.Components, GetComponentType(attribute.Format), stride, offset);
+            } else {
+                glVertexAttribPointer(attribute.Location, (GLint)info.Components, GetComponentType(attribute.Format),
+                                      info.Normalized ? GL_TRUE : GL_FALSE, stride, offset);
+            }
+            glEnableVertexAttribArray(attribute.Location);
+            glVertexAttribDivisor(attribute.Location, attribute.Divisor);
+        }
+    }
+
+}
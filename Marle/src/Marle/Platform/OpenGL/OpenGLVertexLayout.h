@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../../Renderer/VertexBufferLayout.h"
+#include <glad/gl.h>
+
+namespace Marle {
+
+    // Points the bound vertex array's attributes at the buffer bound to GL_ARRAY_BUFFER, as the
+    // layout describes, and enables them
+    void ApplyVertexLayout(const VertexBufferLayout& layout);
+
+}
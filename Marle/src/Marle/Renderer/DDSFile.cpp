@@ -0,0 +1,235 @@
+#include "mrlpch.h"
+#include "DDSFile.h"
+#include "../Core/FileSystem.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+
+namespace Marle {
+
+    static constexpr uint32_t MakeFourCC(char a, char b, char c, char d)
+    {
+        return (uint32_t)(uint8_t)a | ((uint32_t)(uint8_t)b << 8) | ((uint32_t)(uint8_t)c << 16) | ((uint32_t)(uint8_t)d << 24);
+    }
+
+    static const uint32_t s_Magic = MakeFourCC('D', 'D', 'S', ' ');
+    // Written to dwReserved1[0] to mark rows as bottom-up
+    static const uint32_t s_BottomUpTag = MakeFourCC('M', 'R', 'L', 'U');
+
+    static const uint32_t DDSD_CAPS = 0x1, DDSD_HEIGHT = 0x2, DDSD_WIDTH = 0x4, DDSD_PIXELFORMAT = 0x1000;
+    static const uint32_t DDSD_MIPMAPCOUNT = 0x20000, DDSD_LINEARSIZE = 0x80000;
+    static const uint32_t DDPF_ALPHAPIXELS = 0x1, DDPF_FOURCC = 0x4, DDPF_RGB = 0x40;
+    static const uint32_t DDSCAPS_COMPLEX = 0x8, DDSCAPS_TEXTURE = 0x1000, DDSCAPS_MIPMAP = 0x400000;
+
+    static const uint32_t DXGI_FORMAT_R8G8B8A8_UNORM = 28;
+    static const uint32_t DXGI_FORMAT_BC1_UNORM = 71;
+    static const uint32_t DXGI_FORMAT_BC3_UNORM = 77;
+    static const uint32_t DXGI_FORMAT_BC7_UNORM = 98;
+
+    // Larger than any GPU accepts; keeps level sizes well inside 64 bits
+    static const uint32_t s_MaxDimension = 65536;
+
+    struct DDSPixelFormat {
+        uint32_t Size, Flags, FourCC, RGBBitCount, RBitMask, GBitMask, BBitMask, ABitMask;
+    };
+
+    struct DDSHeader {
+        uint32_t Size, Flags, Height, Width, PitchOrLinearSize, Depth, MipMapCount;
+        uint32_t Reserved1[11];
+        DDSPixelFormat PixelFormat;
+        uint32_t Caps, Caps2, Caps3, Caps4, Reserved2;
+    };
+
+    struct DDSHeaderDX10 {
+        uint32_t DXGIFormat, ResourceDimension, MiscFlag, ArraySize, MiscFlags2;
+    };
+
+    static_assert(sizeof(DDSHeader) == 124, "DDS header must be 124 bytes");
+
+    static bool FormatFromDXGI(uint32_t dxgi, TextureFormat& format)
+    {
+        switch (dxgi) {
+            case DXGI_FORMAT_R8G8B8A8_UNORM: format = TextureFormat::RGBA8; return true;
+            case DXGI_FORMAT_BC1_UNORM:      format = TextureFormat::BC1; return true;
+            case DXGI_FORMAT_BC3_UNORM:      format = TextureFormat::BC3; return true;
+            case DXGI_FORMAT_BC7_UNORM:      format = TextureFormat::BC7; return true;
+            default:                         return false;
+        }
+    }
+
+    // Reads `size` bytes at `offset` of the file being parsed
+    typedef std::function<bool(uint64_t offset, void* dst, size_t size)> DDSReadFunc;
+
+    static bool ParseDDS(const std::string& path, uint64_t fileSize, const DDSReadFunc& read, DDSImage& image, uint32_t firstLevel)
+    {
+        uint32_t magic = 0;
+        DDSHeader header;
+        uint64_t offset = sizeof(magic) + sizeof(header);
+        if (!read(0, &magic, sizeof(magic)) || !read(sizeof(magic), &header, sizeof(header)) ||
+            magic != s_Magic || header.Size != sizeof(DDSHeader)) {
+            printf("Error: %s is not a DDS file\n", path.c_str());
+            return false;
+        }
+
+        const DDSPixelFormat& pf = header.PixelFormat;
+        if (pf.Flags & DDPF_FOURCC) {
+            if (pf.FourCC == MakeFourCC('D', 'X', 'T', '1')) {
+                image.Format = TextureFormat::BC1;
+            } else if (pf.FourCC == MakeFourCC('D', 'X', 'T', '5')) {
+                image.Format = TextureFormat::BC3;
+            } else if (pf.FourCC == MakeFourCC('D', 'X', '1', '0')) {
+                DDSHeaderDX10 dx10;
+                bool read10 = read(offset, &dx10, sizeof(dx10));
+                offset += sizeof(dx10);
+                if (!read10 || !FormatFromDXGI(dx10.DXGIFormat, image.Format) || dx10.ArraySize > 1) {
+                    printf("Error: %s uses an unsupported DX10 format (%u)\n", path.c_str(), dx10.DXGIFormat);
+                    return false;
+                }
+            } else {
+                printf("Error: %s uses an unsupported FourCC\n", path.c_str());
+                return false;
+            }
+        } else if ((pf.Flags & DDPF_RGB) && pf.RGBBitCount == 32 && pf.RBitMask == 0x000000FF && pf.ABitMask == 0xFF000000) {
+            image.Format = TextureFormat::RGBA8;
+        } else {
+            printf("Error: %s uses an unsupported pixel format\n", path.c_str());
+            return false;
+        }
+
+        if (header.Width == 0 || header.Height == 0 || header.Width > s_MaxDimension || header.Height > s_MaxDimension) {
+            printf("Error: %s has invalid dimensions %ux%u\n", path.c_str(), header.Width, header.Height);
+            return false;
+        }
+        image.Width = header.Width;
+        image.Height = header.Height;
+        image.BottomUp = header.Reserved1[0] == s_BottomUpTag;
+
+        // A full chain ends at 1x1, so a corrupt count cannot ask for more levels than that
+        uint32_t maxLevels = 1;
+        while ((std::max(image.Width, image.Height) >> maxLevels) > 0) {
+            maxLevels++;
+        }
+        uint32_t levelCount = (header.Flags & DDSD_MIPMAPCOUNT) ? std::min(std::max(header.MipMapCount, 1u), maxLevels) : 1;
+
+        // Every level must be in the file before anything is allocated
+        uint64_t end = offset;
+        for (uint32_t level = 0; level < levelCount; level++) {
+            end += GetTextureDataSize(image.Format, std::max(image.Width >> level, 1u), std::max(image.Height >> level, 1u));
+        }
+        if (end > fileSize) {
+            printf("Error: %s is truncated (%llu of %llu bytes)\n", path.c_str(), (unsigned long long)fileSize, (unsigned long long)end);
+            return false;
+        }
+
+        image.Levels.resize(levelCount);
+        for (uint32_t level = 0; level < levelCount; level++) {
+            uint32_t width = std::max(image.Width >> level, 1u);
+            uint32_t height = std::max(image.Height >> level, 1u);
+            size_t size = GetTextureDataSize(image.Format, width, height);
+            if (level < firstLevel) {
+                offset += size;
+                continue;
+            }
+
+            std::vector<uint8_t>& data = image.Levels[level];
+            data.resize(size);
+            if (!read(offset, data.data(), data.size())) {
+                printf("Error: %s is truncated (mip %u)\n", path.c_str(), level);
+                return false;
+            }
+            offset += size;
+        }
+
+        return true;
+    }
+
+    bool LoadDDS(const std::string& path, DDSImage& image, uint32_t firstLevel)
+    {
+        VirtualFile file;
+        if (!FileSystem::Open(path, file)) {
+            printf("Failed to open DDS file: %s\n", path.c_str());
+            return false;
+        }
+        return ParseDDS(path, file.GetSize(), [&file](uint64_t offset, void* dst, size_t size) { return file.Read(offset, dst, size); },
+                        image, firstLevel);
+    }
+
+    bool LoadDDSMemory(const std::string& path, const uint8_t* data, size_t size, DDSImage& image, uint32_t firstLevel)
+    {
+        auto read = [data, size](uint64_t offset, void* dst, size_t count) {
+            if (offset > size || count > size - offset) {
+                return false;
+            }
+            memcpy(dst, data + offset, count);
+            return true;
+        };
+        return ParseDDS(path, size, read, image, firstLevel);
+    }
+
+    bool SaveDDS(const std::string& path, const DDSImage& image)
+    {
+        if (image.Levels.empty()) {
+            return false;
+        }
+
+        DDSHeader header;
+        memset(&header, 0, sizeof(header));
+        header.Size = sizeof(DDSHeader);
+        header.Flags = DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT | DDSD_LINEARSIZE;
+        header.Width = image.Width;
+        header.Height = image.Height;
+        header.PitchOrLinearSize = (uint32_t)image.Levels[0].size();
+        header.Caps = DDSCAPS_TEXTURE;
+        if (image.Levels.size() > 1) {
+            header.Flags |= DDSD_MIPMAPCOUNT;
+            header.MipMapCount = (uint32_t)image.Levels.size();
+            header.Caps |= DDSCAPS_COMPLEX | DDSCAPS_MIPMAP;
+        }
+        if (image.BottomUp) {
+            header.Reserved1[0] = s_BottomUpTag;
+        }
+
+        DDSPixelFormat& pf = header.PixelFormat;
+        pf.Size = sizeof(DDSPixelFormat);
+        bool dx10 = false;
+        switch (image.Format) {
+            case TextureFormat::RGBA8:
+                pf.Flags = DDPF_RGB | DDPF_ALPHAPIXELS;
+                pf.RGBBitCount = 32;
+                pf.RBitMask = 0x000000FF;
+                pf.GBitMask = 0x0000FF00;
+                pf.BBitMask = 0x00FF0000;
+                pf.ABitMask = 0xFF000000;
+                header.PitchOrLinearSize = 0;
+                break;
+            case TextureFormat::BC1: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('D', 'X', 'T', '1'); break;
+            case TextureFormat::BC3: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('D', 'X', 'T', '5'); break;
+            case TextureFormat::BC7: pf.Flags = DDPF_FOURCC; pf.FourCC = MakeFourCC('D', 'X', '1', '0'); dx10 = true; break;
+        }
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            printf("Failed to create DDS file: %s\n", path.c_str());
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&s_Magic), sizeof(s_Magic));
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        if (dx10) {
+            DDSHeaderDX10 extension = { DXGI_FORMAT_BC7_UNORM, 3 /* TEXTURE2D */, 0, 1, 0 };
+            file.write(reinterpret_cast<const char*>(&extension), sizeof(extension));
+        }
+        for (const std::vector<uint8_t>& level : image.Levels) {
+            file.write(reinterpret_cast<const char*>(level.data()), level.size());
+        }
+
+        if (!file) {
+            printf("Error: failed writing %s\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "../Core.h"
+#include "TextureCompression.h"
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // Contents of a .dds file: one 2D texture with its mip chain, level 0 first.
+    // BC1/BC3 are stored with the legacy DXT1/DXT5 FourCC, BC7 with a DX10 extension header.
+    struct DDSImage {
+        TextureFormat Format = TextureFormat::RGBA8;
+        uint32_t Width = 0, Height = 0;
+        // Rows stored bottom-up (engine/OpenGL convention); set for files written by MarleTexConv
+        bool BottomUp = false;
+        std::vector<std::vector<uint8_t>> Levels;
+    };
+
+    // Levels below firstLevel are skipped on disk and left empty (used when streaming mips in).
+    // Reads through the FileSystem.
+    bool LoadDDS(const std::string& path, DDSImage& image, uint32_t firstLevel = 0);
+    // Same, for a whole file already in memory; path is for messages
+    bool LoadDDSMemory(const std::string& path, const uint8_t* data, size_t size, DDSImage& image, uint32_t firstLevel = 0);
+    bool SaveDDS(const std::string& path, const DDSImage& image);
+
+}
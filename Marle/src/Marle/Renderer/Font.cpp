@@ -0,0 +1,300 @@
+#include "mrlpch.h"
+#include "Font.h"
+#include "RenderProfiler.h"
+#include "VertexBufferLayout.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Marle {
+
+    static const uint32_t s_PageSize = 1024;
+    // Runs kept around after they stop being drawn; beyond this, stale ones are dropped
+    static const size_t s_MaxCachedRuns = 2048;
+
+    static uint64_t HashString(const std::string& text)
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ull;
+        for (unsigned char c : text) {
+            hash ^= c;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    // Decodes one UTF-8 sequence, advancing i; malformed bytes come out as U+FFFD
+    static uint32_t DecodeUTF8(const std::string& text, size_t& i)
+    {
+        unsigned char lead = (unsigned char)text[i++];
+        if (lead < 0x80) {
+            return lead;
+        }
+
+        int extra = (lead >= 0xF0) ? 3 : (lead >= 0xE0) ? 2 : (lead >= 0xC0) ? 1 : -1;
+        if (extra < 0 || i + extra > text.size()) {
+            return 0xFFFD;
+        }
+
+        uint32_t codepoint = lead & (0x3F >> extra);
+        for (int n = 0; n < extra; n++) {
+            unsigned char next = (unsigned char)text[i];
+            if ((next & 0xC0) != 0x80) {
+                return 0xFFFD;
+            }
+            codepoint = (codepoint << 6) | (next & 0x3F);
+            i++;
+        }
+        return codepoint;
+    }
+
+    Font::Font(const std::string& path, float sdfPixelSize)
+        : m_PixelSize(sdfPixelSize), m_Padding(std::max(2.0f, std::ceil(sdfPixelSize / 8.0f))),
+          m_Scale(0.0f), m_LineHeight(1.2f)
+    {
+        if (!m_File.LoadFromFile(path)) {
+            return;
+        }
+
+        float unitsPerEm = m_File.GetUnitsPerEm();
+        m_Scale = m_PixelSize / unitsPerEm;
+        m_LineHeight = (m_File.GetAscender() - m_File.GetDescender() + m_File.GetLineGap()) / unitsPerEm;
+
+        // Fixed-size cells make eviction a slot swap; glyphs larger than a cell are clipped
+        float extent = std::max(m_PixelSize, (m_File.GetAscender() - m_File.GetDescender()) * m_Scale);
+        m_CellWidth = m_CellHeight = (uint32_t)std::ceil(extent + 2.0f * m_Padding);
+        m_CellsPerRow = s_PageSize / m_CellWidth;
+        m_CellsPerPage = m_CellsPerRow * (s_PageSize / m_CellHeight);
+
+        printf("Loaded font: %s (%.0fpx SDF, %u glyphs per atlas page)\n", path.c_str(), m_PixelSize, m_CellsPerPage);
+    }
+
+    Font::~Font()
+    {
+        if (!m_Pages.empty()) {
+            glDeleteTextures((GLsizei)m_Pages.size(), m_Pages.data());
+        }
+    }
+
+    size_t Font::GetAtlasMemorySize() const
+    {
+        return m_Pages.size() * s_PageSize * s_PageSize;
+    }
+
+    float Font::MeasureWidth(const std::string& text, float size)
+    {
+        return GetRun(text, m_LastFrame).Width * size;
+    }
+
+    const Font::GlyphInfo& Font::GetGlyphInfo(uint32_t codepoint)
+    {
+        auto it = m_GlyphInfo.find(codepoint);
+        if (it != m_GlyphInfo.end()) {
+            return it->second;
+        }
+
+        GlyphInfo info;
+        info.Glyph = m_File.GetGlyphIndex(codepoint);
+        TrueTypeFont::GlyphMetrics metrics = m_File.GetGlyphMetrics(info.Glyph);
+        info.Advance = metrics.Advance / m_File.GetUnitsPerEm();
+
+        if (!metrics.Empty) {
+            int32_t left = (int32_t)std::floor(metrics.XMin * m_Scale);
+            int32_t bottom = (int32_t)std::floor(metrics.YMin * m_Scale);
+            int32_t right = (int32_t)std::ceil(metrics.XMax * m_Scale);
+            int32_t top = (int32_t)std::ceil(metrics.YMax * m_Scale);
+            int32_t padding = (int32_t)m_Padding;
+
+            info.BitmapX = left - padding;
+            info.BitmapY = bottom - padding;
+            info.BitmapWidth = std::min<uint32_t>(right - left + 2 * padding, m_CellWidth);
+            info.BitmapHeight = std::min<uint32_t>(top - bottom + 2 * padding, m_CellHeight);
+        }
+
+        return m_GlyphInfo.emplace(codepoint, info).first->second;
+    }
+
+    Font::TextRun& Font::GetRun(const std::string& text, uint64_t frame)
+    {
+        m_LastFrame = frame;
+        uint64_t hash = HashString(text);
+
+        auto it = m_Runs.find(hash);
+        if (it != m_Runs.end() && it->second.Text == text) {
+            m_Stats.RunCacheHits++;
+            it->second.LastUsedFrame = frame;
+            return it->second;
+        }
+        m_Stats.RunCacheMisses++;
+
+        if (m_Runs.size() >= s_MaxCachedRuns) {
+            for (auto run = m_Runs.begin(); run != m_Runs.end();) {
+                run = (run->second.LastUsedFrame < frame) ? m_Runs.erase(run) : std::next(run);
+            }
+        }
+
+        // A hash collision simply replaces the older run
+        TextRun& run = m_Runs[hash];
+        run.Text = text;
+        run.Glyphs.clear();
+        run.Slots.clear();
+        run.SlotEpoch = ~0ull;
+        run.LastUsedFrame = frame;
+        run.Width = 0.0f;
+
+        float penX = 0.0f, penY = 0.0f;
+        for (size_t i = 0; i < text.size();) {
+            uint32_t codepoint = DecodeUTF8(text, i);
+            if (codepoint == '\n') {
+                run.Width = std::max(run.Width, penX);
+                penX = 0.0f;
+                penY -= m_LineHeight;
+                continue;
+            }
+
+            const GlyphInfo& info = GetGlyphInfo(codepoint);
+            if (info.BitmapWidth > 0) {
+                float x0 = penX + (float)info.BitmapX / m_PixelSize;
+                float y0 = penY + (float)info.BitmapY / m_PixelSize;
+                run.Glyphs.push_back({ codepoint, x0, y0,
+                                       x0 + (float)info.BitmapWidth / m_PixelSize,
+                                       y0 + (float)info.BitmapHeight / m_PixelSize });
+            }
+            penX += info.Advance;
+        }
+        run.Width = std::max(run.Width, penX);
+
+        m_Stats.CachedRuns = (uint32_t)m_Runs.size();
+        return run;
+    }
+
+    void Font::ResolveRun(TextRun& run, uint64_t frame)
+    {
+        // Nothing was evicted since the last resolve: the slots are still ours, just mark them used
+        if (run.SlotEpoch == m_Epoch) {
+            for (uint32_t slot : run.Slots) {
+                if (slot != InvalidSlot) {
+                    m_Slots[slot].LastUsedFrame = frame;
+                }
+            }
+            return;
+        }
+
+        run.Slots.resize(run.Glyphs.size());
+        for (size_t i = 0; i < run.Glyphs.size(); i++) {
+            run.Slots[i] = AcquireSlot(run.Glyphs[i].Codepoint, frame);
+        }
+        run.SlotEpoch = m_Epoch;
+    }
+
+    uint32_t Font::AcquireSlot(uint32_t codepoint, uint64_t frame)
+    {
+        // Slots are keyed by glyph so codepoints sharing one (e.g. missing ones) share the cell
+        const GlyphInfo& info = GetGlyphInfo(codepoint);
+        auto it = m_SlotByGlyph.find(info.Glyph);
+        if (it != m_SlotByGlyph.end()) {
+            m_Slots[it->second].LastUsedFrame = frame;
+            return it->second;
+        }
+
+        if (info.BitmapWidth == 0 || !IsLoaded()) {
+            return InvalidSlot;
+        }
+
+        // Free cell first, then a new page, then the least recently drawn glyph
+        uint32_t slot = InvalidSlot;
+        for (uint32_t pass = 0; pass < 2 && slot == InvalidSlot; pass++) {
+            for (uint32_t i = 0; i < m_Slots.size(); i++) {
+                if (!m_Slots[i].InUse) {
+                    slot = i;
+                    break;
+                }
+            }
+            if (slot == InvalidSlot && (m_Pages.size() >= m_MaxPages || !AddPage())) {
+                break;
+            }
+        }
+
+        if (slot == InvalidSlot) {
+            uint64_t oldest = frame;
+            for (uint32_t i = 0; i < m_Slots.size(); i++) {
+                if (m_Slots[i].LastUsedFrame < oldest) {
+                    oldest = m_Slots[i].LastUsedFrame;
+                    slot = i;
+                }
+            }
+            if (slot == InvalidSlot) {
+                return InvalidSlot; // Every cell is on screen this frame
+            }
+            m_SlotByGlyph.erase(m_Slots[slot].Glyph);
+            m_Stats.GlyphsEvicted++;
+            m_Epoch++;
+        }
+
+        // Rasterize into the slot's cell
+        uint32_t page = slot / m_CellsPerPage;
+        uint32_t cell = slot % m_CellsPerPage;
+        uint32_t cellX = (cell % m_CellsPerRow) * m_CellWidth;
+        uint32_t cellY = (cell / m_CellsPerRow) * m_CellHeight;
+
+        m_Scratch.assign((size_t)info.BitmapWidth * info.BitmapHeight, 0);
+        m_File.RasterizeSDF(info.Glyph, m_Scale, (float)-info.BitmapX, (float)-info.BitmapY, m_Padding,
+                            info.BitmapWidth, info.BitmapHeight, m_Scratch.data(), info.BitmapWidth);
+
+        glBindTexture(GL_TEXTURE_2D, m_Pages[page]);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, cellX, cellY, info.BitmapWidth, info.BitmapHeight,
+                        GL_RED, GL_UNSIGNED_BYTE, m_Scratch.data());
+        RenderProfiler::CountTextureUpload(m_Scratch.size());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        GlyphSlot& entry = m_Slots[slot];
+        entry.Glyph = info.Glyph;
+        entry.Page = page;
+        // Packed once here rather than per vertex when text is batched
+        float u0 = (float)cellX / s_PageSize, v0 = (float)cellY / s_PageSize;
+        float u1 = (float)(cellX + info.BitmapWidth) / s_PageSize;
+        float v1 = (float)(cellY + info.BitmapHeight) / s_PageSize;
+        entry.TexCoords[0] = PackUNorm16x2({ u0, v0 });
+        entry.TexCoords[1] = PackUNorm16x2({ u1, v0 });
+        entry.TexCoords[2] = PackUNorm16x2({ u1, v1 });
+        entry.TexCoords[3] = PackUNorm16x2({ u0, v1 });
+        entry.LastUsedFrame = frame;
+        entry.InUse = true;
+
+        m_SlotByGlyph[info.Glyph] = slot;
+        m_Stats.GlyphsRasterized++;
+        m_Stats.CachedGlyphs = (uint32_t)m_SlotByGlyph.size();
+        return slot;
+    }
+
+    bool Font::AddPage()
+    {
+        if (m_CellsPerPage == 0) {
+            return false;
+        }
+
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+        // Cleared so bilinear taps past a glyph's edge read "far outside"
+        std::vector<uint8_t> clear((size_t)s_PageSize * s_PageSize, 0);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, s_PageSize, s_PageSize, 0, GL_RED, GL_UNSIGNED_BYTE, clear.data());
+        RenderProfiler::CountTextureUpload(clear.size());
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        m_Pages.push_back(texture);
+        m_Slots.resize(m_Pages.size() * m_CellsPerPage);
+        m_Stats.Pages = (uint32_t)m_Pages.size();
+        return true;
+    }
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "../Core.h"
+#include "TrueTypeFont.h"
+#include <glad/gl.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Marle {
+
+    // Signed-distance-field font. Glyphs are rasterized into atlas pages the first time they are
+    // drawn and evicted least-recently-used when the pages fill up; laid-out strings are cached
+    // by hash so a label that does not change is never laid out again.
+    class Font {
+    public:
+        // sdfPixelSize is the size glyphs are rasterized at; the distance field keeps them sharp
+        // well above and below it
+        Font(const std::string& path, float sdfPixelSize = 32.0f);
+        ~Font();
+
+        Font(const Font&) = delete;
+        Font& operator=(const Font&) = delete;
+
+        bool IsLoaded() const { return m_File.IsLoaded(); }
+        // Bytes of the font file kept in memory, and of the atlas pages on the GPU
+        size_t GetFileSize() const { return m_File.GetDataSize(); }
+        size_t GetAtlasMemorySize() const;
+
+        // Line advance for text drawn at the given pixel size
+        float GetLineHeight(float size) const { return m_LineHeight * size; }
+        float MeasureWidth(const std::string& text, float size);
+
+        // Upper bound on atlas pages; once reached, glyphs not drawn this frame are evicted
+        void SetMaxPages(uint32_t pages) { m_MaxPages = pages; }
+
+        struct Stats {
+            uint32_t Pages = 0;
+            uint32_t CachedGlyphs = 0;
+            uint32_t CachedRuns = 0;
+            uint64_t GlyphsRasterized = 0;
+            uint64_t GlyphsEvicted = 0;
+            uint64_t RunCacheHits = 0;
+            uint64_t RunCacheMisses = 0;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        friend class Renderer2D;
+
+        // Quad relative to the pen origin, in ems
+        struct GlyphQuad {
+            uint32_t Codepoint;
+            float X0, Y0, X1, Y1;
+        };
+
+        struct TextRun {
+            std::string Text;
+            std::vector<GlyphQuad> Glyphs;
+            std::vector<uint32_t> Slots;    // Atlas slot per glyph, valid while SlotEpoch == m_Epoch
+            uint64_t SlotEpoch = ~0ull;
+            uint64_t LastUsedFrame = 0;
+            float Width = 0.0f;             // Widest line, in ems
+        };
+
+        struct GlyphInfo {
+            uint32_t Glyph = 0;
+            float Advance = 0.0f;          // In ems
+            int32_t BitmapX = 0, BitmapY = 0; // SDF bitmap placement relative to the pen, in pixels
+            uint32_t BitmapWidth = 0, BitmapHeight = 0;
+        };
+
+        struct GlyphSlot {
+            uint32_t Glyph = 0;
+            uint32_t Page = 0;
+            uint32_t TexCoords[4] = {};     // UNorm16x2 corners: (U0,V0) (U1,V0) (U1,V1) (U0,V1)
+            uint64_t LastUsedFrame = 0;
+            bool InUse = false;
+        };
+
+        static const uint32_t InvalidSlot = ~0u;
+
+        const GlyphInfo& GetGlyphInfo(uint32_t codepoint);
+        TextRun& GetRun(const std::string& text, uint64_t frame);
+        // Maps every glyph of the run to an atlas slot, rasterizing missing ones
+        void ResolveRun(TextRun& run, uint64_t frame);
+        uint32_t AcquireSlot(uint32_t codepoint, uint64_t frame);
+        bool AddPage();
+
+        TrueTypeFont m_File;
+        float m_PixelSize;
+        float m_Padding;           // SDF spread in pixels around each glyph
+        float m_Scale;             // Pixels per font unit at m_PixelSize
+        float m_LineHeight;        // In ems
+        uint32_t m_CellWidth = 0, m_CellHeight = 0;
+        uint32_t m_CellsPerRow = 0, m_CellsPerPage = 0;
+
+        std::vector<GLuint> m_Pages;
+        uint32_t m_MaxPages = 4;
+        std::unordered_map<uint32_t, GlyphInfo> m_GlyphInfo;
+        std::vector<GlyphSlot> m_Slots;
+        std::unordered_map<uint32_t, uint32_t> m_SlotByGlyph;
+        uint64_t m_Epoch = 0;      // Bumped whenever a slot changes owner
+
+        std::unordered_map<uint64_t, TextRun> m_Runs;
+        uint64_t m_LastFrame = 0;
+        std::vector<uint8_t> m_Scratch;
+        Stats m_Stats;
+    };
+
+}
@@ -0,0 +1,1099 @@
+#include "mrlpch.h"
+#include "ImageDecoder.h"
+#include "../Core/FileSystem.h"
+#include "../Core/JobSystem.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/SIMD.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+
+// Decode buffers are charged to Assets
+#define STBI_MALLOC(size)           Marle::MemoryTracker::Allocate(size, Marle::MemoryTag::Assets)
+#define STBI_REALLOC(ptr, size)     Marle::MemoryTracker::Reallocate(ptr, size, Marle::MemoryTag::Assets)
+#define STBI_FREE(ptr)              Marle::MemoryTracker::Free(ptr)
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+namespace Marle {
+
+    static thread_local const char* s_Error = "";
+
+    // Largest texture side the engine accepts; the output buffer is sized from the header before decoding
+    static const uint32_t s_MaxDimension = 16384;
+
+    static bool Fail(const char* reason)
+    {
+        s_Error = reason;
+        return false;
+    }
+
+    static bool CheckDimensions(uint32_t width, uint32_t height)
+    {
+        if (width > s_MaxDimension || height > s_MaxDimension) {
+            return Fail("image dimensions too large");
+        }
+        return width > 0 && height > 0;
+    }
+
+    static uint32_t ReadBE32(const uint8_t* p)
+    {
+        return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+    }
+
+    static uint32_t ReadLE16(const uint8_t* p)
+    {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8);
+    }
+
+    static int32_t ReadLE32(const uint8_t* p)
+    {
+        int32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // ---- Row conversion to RGBA8 ----
+
+    typedef void (*RowConverter)(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t* palette);
+
+    static void ConvertRGBA(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t*)
+    {
+        memcpy(dst, src, (size_t)width * 4);
+    }
+
+    static void ConvertBGRA(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t*)
+    {
+        const SIMD::Int4 greenAlpha = SIMD::SetInt1((int32_t)0xFF00FF00);
+        const SIMD::Int4 low = SIMD::SetInt1(0xFF);
+        uint32_t x = 0;
+        for (; x + 4 <= width; x += 4) {
+            SIMD::Int4 bgra = SIMD::LoadInt((const int32_t*)(src + x * 4));
+            SIMD::Int4 rgba = SIMD::OrInt(SIMD::AndInt(bgra, greenAlpha),
+                              SIMD::OrInt(SIMD::AndInt(SIMD::ShiftRightInt(bgra, 16), low),
+                                          SIMD::ShiftLeftInt(SIMD::AndInt(bgra, low), 16)));
+            SIMD::StoreInt((int32_t*)(dst + x * 4), rgba);
+        }
+        for (; x < width; x++) {
+            dst[x * 4 + 0] = src[x * 4 + 2];
+            dst[x * 4 + 1] = src[x * 4 + 1];
+            dst[x * 4 + 2] = src[x * 4 + 0];
+            dst[x * 4 + 3] = src[x * 4 + 3];
+        }
+    }
+
+    // Three-byte pixels are gathered with four overlapping word loads; the loop stops one pixel
+    // early so the last load never reads past the row
+    template<bool SwapRB>
+    static void ConvertRGB(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t*)
+    {
+        const SIMD::Int4 opaque = SIMD::SetInt1((int32_t)0xFF000000);
+        const SIMD::Int4 green = SIMD::SetInt1(0xFF00);
+        const SIMD::Int4 low = SIMD::SetInt1(0xFF);
+        uint32_t x = 0;
+        for (; x + 5 <= width; x += 4) {
+            const uint8_t* p = src + x * 3;
+            SIMD::Int4 rgb = SIMD::SetInt(ReadLE32(p), ReadLE32(p + 3), ReadLE32(p + 6), ReadLE32(p + 9));
+            SIMD::Int4 rgba;
+            if (SwapRB) {
+                rgba = SIMD::OrInt(SIMD::AndInt(rgb, green),
+                       SIMD::OrInt(SIMD::AndInt(SIMD::ShiftRightInt(rgb, 16), low),
+                                   SIMD::ShiftLeftInt(SIMD::AndInt(rgb, low), 16)));
+            } else {
+                rgba = SIMD::AndInt(rgb, SIMD::SetInt1(0xFFFFFF));
+            }
+            SIMD::StoreInt((int32_t*)(dst + x * 4), SIMD::OrInt(rgba, opaque));
+        }
+        for (; x < width; x++) {
+            dst[x * 4 + 0] = src[x * 3 + (SwapRB ? 2 : 0)];
+            dst[x * 4 + 1] = src[x * 3 + 1];
+            dst[x * 4 + 2] = src[x * 3 + (SwapRB ? 0 : 2)];
+            dst[x * 4 + 3] = 255;
+        }
+    }
+
+    static void ConvertGray(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t*)
+    {
+        const SIMD::Int4 opaque = SIMD::SetInt1((int32_t)0xFF000000);
+        uint32_t x = 0;
+        for (; x + 4 <= width; x += 4) {
+            SIMD::Int4 gray = SIMD::LoadBytesInt(src + x);
+            SIMD::Int4 rgba = SIMD::OrInt(SIMD::OrInt(gray, SIMD::ShiftLeftInt(gray, 8)),
+                              SIMD::OrInt(SIMD::ShiftLeftInt(gray, 16), opaque));
+            SIMD::StoreInt((int32_t*)(dst + x * 4), rgba);
+        }
+        for (; x < width; x++) {
+            dst[x * 4 + 0] = dst[x * 4 + 1] = dst[x * 4 + 2] = src[x];
+            dst[x * 4 + 3] = 255;
+        }
+    }
+
+    static void ConvertGrayAlpha(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t*)
+    {
+        for (uint32_t x = 0; x < width; x++) {
+            dst[x * 4 + 0] = dst[x * 4 + 1] = dst[x * 4 + 2] = src[x * 2];
+            dst[x * 4 + 3] = src[x * 2 + 1];
+        }
+    }
+
+    static void ConvertPalette(const uint8_t* src, uint8_t* dst, uint32_t width, const uint32_t* palette)
+    {
+        for (uint32_t x = 0; x < width; x++) {
+            memcpy(dst + x * 4, &palette[src[x]], 4);
+        }
+    }
+
+    // ---- TGA ----
+
+    struct TGALayout {
+        uint32_t ImageType;
+        uint32_t BytesPerPixel;
+        bool TopDown;
+        size_t DataOffset;
+        size_t MinSize;         // Smallest file that can hold the pixel data
+    };
+
+    static bool ParseTGAHeader(const uint8_t* data, size_t size, ImageInfo& info, TGALayout& layout)
+    {
+        if (size < 18) {
+            return false;
+        }
+        uint32_t colorMapType = data[1];
+        uint32_t imageType = data[2];
+        uint32_t mapLength = ReadLE16(data + 5);
+        uint32_t mapEntryBits = data[7];
+        uint32_t width = ReadLE16(data + 12);
+        uint32_t height = ReadLE16(data + 14);
+        uint32_t depth = data[16];
+        uint32_t descriptor = data[17];
+
+        bool colorMapped = imageType == 1 || imageType == 9;
+        bool known = colorMapped || imageType == 2 || imageType == 3 || imageType == 10 || imageType == 11;
+        if (colorMapType > 1 || !known || !CheckDimensions(width, height) ||
+            (depth != 8 && depth != 15 && depth != 16 && depth != 24 && depth != 32)) {
+            return false;
+        }
+
+        info.Type = ImageFileType::TGA;
+        info.Width = width;
+        info.Height = height;
+        info.Channels = (imageType == 3 || imageType == 11) ? 1 : (depth == 32 ? 4 : 3);
+
+        layout.ImageType = imageType;
+        layout.BytesPerPixel = depth / 8;
+        layout.TopDown = (descriptor & 0x20) != 0;
+        layout.DataOffset = 18 + data[0] + (colorMapType ? (size_t)mapLength * ((mapEntryBits + 7) / 8) : 0);
+        // RLE packets hold at least one pixel each, so only uncompressed files have a known minimum
+        bool rle = imageType >= 9;
+        layout.MinSize = layout.DataOffset + (rle ? 0 : (size_t)width * height * ((depth + 7) / 8));
+
+        // Only these reach the engine path: colour-mapped, 15/16-bit and right-to-left files go to stb_image
+        bool gray = imageType == 3 || imageType == 11;
+        bool color = imageType == 2 || imageType == 10;
+        bool supported = (gray && depth == 8) || (color && (depth == 24 || depth == 32));
+        if (!supported || (descriptor & 0x10)) {
+            layout.ImageType = 0;
+        }
+        return true;
+    }
+
+    static RowConverter GetTGAConverter(uint32_t bytesPerPixel)
+    {
+        switch (bytesPerPixel) {
+            case 1:  return ConvertGray;
+            case 3:  return ConvertRGB<true>;
+            default: return ConvertBGRA;
+        }
+    }
+
+    static bool DecodeTGA(const uint8_t* data, size_t size, const ImageInfo& info, const TGALayout& layout, uint8_t* pixels)
+    {
+        const uint32_t width = info.Width, height = info.Height;
+        const uint32_t bpp = layout.BytesPerPixel;
+        const size_t rowBytes = (size_t)width * bpp;
+        const RowConverter convert = GetTGAConverter(bpp);
+        // File rows go bottom-up unless the descriptor says otherwise, which is already our order
+        auto destRow = [&](uint32_t fileRow) {
+            return pixels + (size_t)(layout.TopDown ? height - 1 - fileRow : fileRow) * width * 4;
+        };
+
+        if (layout.ImageType == 2 || layout.ImageType == 3) {
+            if (layout.DataOffset + rowBytes * height > size) {
+                return Fail("truncated TGA");
+            }
+            const uint8_t* src = data + layout.DataOffset;
+            uint32_t rowsPerChunk = (uint32_t)std::max<size_t>(1, 65536 / rowBytes);
+            JobSystem::ParallelFor(height, rowsPerChunk, [&](uint32_t begin, uint32_t end) {
+                for (uint32_t row = begin; row < end; row++) {
+                    convert(src + row * rowBytes, destRow(row), width, nullptr);
+                }
+            });
+            return true;
+        }
+
+        // RLE: runs may cross rows, so this is one serial pass over the packets
+        const uint8_t* src = data + layout.DataOffset;
+        const uint8_t* end = data + size;
+        uint32_t x = 0, row = 0;
+        uint8_t* dst = destRow(0);
+        while (row < height) {
+            if (src >= end) {
+                return Fail("truncated TGA");
+            }
+            uint32_t header = *src++;
+            uint32_t count = (header & 0x7F) + 1;
+            if (header & 0x80) {
+                if ((size_t)(end - src) < bpp) {
+                    return Fail("truncated TGA");
+                }
+                uint8_t pixel[4];
+                convert(src, pixel, 1, nullptr);
+                src += bpp;
+                while (count > 0 && row < height) {
+                    uint32_t run = std::min(count, width - x);
+                    for (uint32_t i = 0; i < run; i++) {
+                        memcpy(dst + (x + i) * 4, pixel, 4);
+                    }
+                    count -= run;
+                    x += run;
+                    if (x == width && ++row < height) {
+                        x = 0;
+                        dst = destRow(row);
+                    }
+                }
+            } else {
+                if ((size_t)(end - src) < (size_t)count * bpp) {
+                    return Fail("truncated TGA");
+                }
+                while (count > 0 && row < height) {
+                    uint32_t run = std::min(count, width - x);
+                    convert(src, dst + x * 4, run, nullptr);
+                    src += (size_t)run * bpp;
+                    count -= run;
+                    x += run;
+                    if (x == width && ++row < height) {
+                        x = 0;
+                        dst = destRow(row);
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // ---- Inflate (RFC 1950/1951) ----
+
+    static const uint32_t s_FastBits = 10;
+    static const uint32_t s_FastMask = (1u << s_FastBits) - 1;
+    // Match copies move 8 bytes at a time and may write this far past the match
+    static const size_t s_CopySlack = 8;
+
+    // Canonical Huffman decoding table. Codes up to s_FastBits long resolve with one lookup on the
+    // next input bits; longer ones are found by comparing the bit-reversed input against the
+    // highest code of each length.
+    struct HuffmanTable {
+        uint16_t Fast[1 << s_FastBits];   // (length << 9) | symbol, 0 when the code is longer
+        uint16_t FirstCode[16];
+        uint16_t FirstSymbol[16];
+        uint32_t MaxCode[17];             // One past the last code of each length, left-aligned to 16 bits
+        uint8_t Size[288];
+        uint16_t Value[288];
+    };
+
+    static uint32_t ReverseBits(uint32_t value, uint32_t bits)
+    {
+        uint32_t result = 0;
+        for (uint32_t i = 0; i < bits; i++) {
+            result = (result << 1) | ((value >> i) & 1);
+        }
+        return result;
+    }
+
+    static bool BuildHuffman(HuffmanTable& table, const uint8_t* lengths, uint32_t count)
+    {
+        uint32_t sizes[17] = {};
+        for (uint32_t i = 0; i < count; i++) {
+            sizes[lengths[i]]++;
+        }
+        sizes[0] = 0;
+        for (uint32_t i = 1; i < 16; i++) {
+            if (sizes[i] > (1u << i)) {
+                return false;
+            }
+        }
+
+        uint32_t nextCode[16];
+        uint32_t code = 0, symbol = 0;
+        for (uint32_t i = 1; i < 16; i++) {
+            nextCode[i] = code;
+            table.FirstCode[i] = (uint16_t)code;
+            table.FirstSymbol[i] = (uint16_t)symbol;
+            code += sizes[i];
+            if (sizes[i] && code - 1 >= (1u << i)) {
+                return false;   // Over-subscribed
+            }
+            table.MaxCode[i] = code << (16 - i);
+            code <<= 1;
+            symbol += sizes[i];
+        }
+        table.MaxCode[16] = 0x10000;
+
+        memset(table.Fast, 0, sizeof(table.Fast));
+        memset(table.Size, 0, sizeof(table.Size));
+        for (uint32_t i = 0; i < count; i++) {
+            uint32_t length = lengths[i];
+            if (!length) {
+                continue;
+            }
+            uint32_t slot = nextCode[length] - table.FirstCode[length] + table.FirstSymbol[length];
+            table.Size[slot] = (uint8_t)length;
+            table.Value[slot] = (uint16_t)i;
+            if (length <= s_FastBits) {
+                uint16_t entry = (uint16_t)((length << 9) | i);
+                for (uint32_t j = ReverseBits(nextCode[length], length); j < (1u << s_FastBits); j += 1u << length) {
+                    table.Fast[j] = entry;
+                }
+            }
+            nextCode[length]++;
+        }
+        return true;
+    }
+
+    struct FixedHuffman {
+        HuffmanTable Literals, Distances;
+
+        FixedHuffman()
+        {
+            uint8_t lengths[288];
+            memset(lengths, 8, 144);
+            memset(lengths + 144, 9, 112);
+            memset(lengths + 256, 7, 24);
+            memset(lengths + 280, 8, 8);
+            BuildHuffman(Literals, lengths, 288);
+            memset(lengths, 5, 30);
+            BuildHuffman(Distances, lengths, 30);
+        }
+    };
+
+    static const uint16_t s_LengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                               35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint8_t s_LengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t s_DistanceBase[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+                                                 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+                                                 8193, 12289, 16385, 24577 };
+    static const uint8_t s_DistanceExtra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+                                                 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+    // How much of an Inflater's output is final. A consumer on another thread sleeps in WaitFor
+    // until its bytes are there; the inflater publishes every 64 KB, so waking it is cheap.
+    struct InflateProgress {
+        std::atomic<size_t> Bytes{ 0 };
+        std::atomic<bool> Failed{ false };
+        std::mutex Mutex;
+        std::condition_variable Condition;
+
+        void Publish(size_t bytes)
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Bytes.store(bytes, std::memory_order_release);
+            }
+            Condition.notify_all();
+        }
+
+        void Fail()
+        {
+            {
+                std::lock_guard<std::mutex> lock(Mutex);
+                Failed.store(true, std::memory_order_release);
+            }
+            Condition.notify_all();
+        }
+
+        // False when inflating failed before `bytes` were final
+        bool WaitFor(size_t bytes)
+        {
+            if (Bytes.load(std::memory_order_acquire) >= bytes) {
+                return true;
+            }
+            std::unique_lock<std::mutex> lock(Mutex);
+            Condition.wait(lock, [&]() { return Bytes.load(std::memory_order_acquire) >= bytes || Failed.load(std::memory_order_acquire); });
+            return Bytes.load(std::memory_order_acquire) >= bytes;
+        }
+    };
+
+    // Decompresses into a buffer of known size, publishing how many bytes are final through
+    // `progress` so another thread can consume the output as it appears. Input is read through a
+    // 64-bit bit buffer refilled a word at a time; past the end of the input it reads zeros and
+    // counts them, and consuming any of those fails the stream.
+    class Inflater {
+    public:
+        Inflater(const uint8_t* in, size_t inSize, uint8_t* out, size_t outSize, InflateProgress* progress)
+            : m_In(in), m_InEnd(in + inSize), m_OutStart(out), m_Out(out), m_OutEnd(out + outSize), m_Progress(progress)
+        {
+        }
+
+        bool Run()
+        {
+            Refill();
+            uint32_t cmf = Take(8), flags = Take(8);
+            if ((cmf & 0x0F) != 8 || ((cmf << 8) | flags) % 31 != 0 || (flags & 0x20)) {
+                return Fail("bad zlib header");
+            }
+
+            bool last = false;
+            while (!last) {
+                Refill();
+                last = Take(1) != 0;
+                uint32_t type = Take(2);
+                bool ok = false;
+                if (type == 0) {
+                    ok = StoredBlock();
+                } else if (type == 1) {
+                    static const FixedHuffman s_Fixed;
+                    ok = HuffmanBlock(s_Fixed.Literals, s_Fixed.Distances);
+                } else if (type == 2) {
+                    ok = DynamicBlock();
+                } else {
+                    return Fail("bad deflate block type");
+                }
+                if (!ok) {
+                    return false;
+                }
+                if (m_Padding * 8 > m_Count) {
+                    return Fail("truncated deflate stream");
+                }
+            }
+            if (m_Out != m_OutEnd) {
+                return Fail("not enough image data");
+            }
+            Publish();
+            return true;
+        }
+
+    private:
+        void Refill()
+        {
+            if (m_InEnd - m_In >= 8) {
+                uint64_t word;
+                memcpy(&word, m_In, sizeof(word));
+                m_Bits |= word << m_Count;
+                m_In += (63 - m_Count) >> 3;
+                m_Count |= 56;
+                return;
+            }
+            while (m_Count <= 56) {
+                if (m_In < m_InEnd) {
+                    m_Bits |= (uint64_t)*m_In++ << m_Count;
+                } else {
+                    m_Padding++;
+                }
+                m_Count += 8;
+            }
+        }
+
+        uint32_t Take(uint32_t bits)
+        {
+            uint32_t value = (uint32_t)(m_Bits & ((1ull << bits) - 1));
+            m_Bits >>= bits;
+            m_Count -= bits;
+            return value;
+        }
+
+        int Decode(const HuffmanTable& table)
+        {
+            uint32_t entry = table.Fast[m_Bits & s_FastMask];
+            if (entry) {
+                uint32_t length = entry >> 9;
+                m_Bits >>= length;
+                m_Count -= length;
+                return (int)(entry & 511);
+            }
+
+            uint32_t code = ReverseBits((uint32_t)(m_Bits & 0xFFFF), 16);
+            uint32_t length = s_FastBits + 1;
+            while (length < 16 && code >= table.MaxCode[length]) {
+                length++;
+            }
+            if (length >= 16) {
+                return -1;
+            }
+            uint32_t slot = (code >> (16 - length)) - table.FirstCode[length] + table.FirstSymbol[length];
+            if (slot >= 288 || table.Size[slot] != length) {
+                return -1;
+            }
+            m_Bits >>= length;
+            m_Count -= length;
+            return table.Value[slot];
+        }
+
+        void Publish()
+        {
+            if (m_Progress) {
+                m_Progress->Publish((size_t)(m_Out - m_OutStart));
+            }
+            m_Published = m_Out;
+        }
+
+        bool StoredBlock()
+        {
+            Take(m_Count & 7);
+            uint32_t length = Take(16);
+            uint32_t inverse = Take(16);
+            if ((length ^ 0xFFFF) != inverse) {
+                return Fail("corrupt stored block");
+            }
+            // Hand the whole bytes still buffered back to the input
+            size_t buffered = m_Count >> 3;
+            if (buffered < m_Padding) {
+                return Fail("truncated deflate stream");
+            }
+            m_In -= buffered - m_Padding;
+            m_Padding = 0;
+            m_Bits = 0;
+            m_Count = 0;
+
+            if ((size_t)(m_InEnd - m_In) < length) {
+                return Fail("truncated stored block");
+            }
+            if ((size_t)(m_OutEnd - m_Out) < length) {
+                return Fail("too much image data");
+            }
+            memcpy(m_Out, m_In, length);
+            m_In += length;
+            m_Out += length;
+            Publish();
+            return true;
+        }
+
+        bool DynamicBlock()
+        {
+            static const uint8_t s_Order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+            Refill();
+            uint32_t literalCount = Take(5) + 257;
+            uint32_t distanceCount = Take(5) + 1;
+            uint32_t codeLengthCount = Take(4) + 4;
+
+            uint8_t codeLengths[19] = {};
+            for (uint32_t i = 0; i < codeLengthCount; i++) {
+                Refill();
+                codeLengths[s_Order[i]] = (uint8_t)Take(3);
+            }
+            HuffmanTable codeLengthTable;
+            if (!BuildHuffman(codeLengthTable, codeLengths, 19)) {
+                return Fail("corrupt code lengths");
+            }
+
+            uint8_t lengths[288 + 32];
+            const uint32_t total = literalCount + distanceCount;
+            uint32_t n = 0;
+            while (n < total) {
+                Refill();
+                int symbol = Decode(codeLengthTable);
+                if (symbol < 0) {
+                    return Fail("corrupt code lengths");
+                }
+                if (symbol < 16) {
+                    lengths[n++] = (uint8_t)symbol;
+                    continue;
+                }
+                uint32_t repeat;
+                uint8_t value = 0;
+                if (symbol == 16) {
+                    if (n == 0) {
+                        return Fail("corrupt code lengths");
+                    }
+                    value = lengths[n - 1];
+                    repeat = 3 + Take(2);
+                } else if (symbol == 17) {
+                    repeat = 3 + Take(3);
+                } else {
+                    repeat = 11 + Take(7);
+                }
+                if (n + repeat > total) {
+                    return Fail("corrupt code lengths");
+                }
+                memset(lengths + n, value, repeat);
+                n += repeat;
+            }
+            if (lengths[256] == 0) {
+                return Fail("no end-of-block code");
+            }
+
+            HuffmanTable literals, distances;
+            if (!BuildHuffman(literals, lengths, literalCount) || !BuildHuffman(distances, lengths + literalCount, distanceCount)) {
+                return Fail("corrupt huffman codes");
+            }
+            return HuffmanBlock(literals, distances);
+        }
+
+        bool HuffmanBlock(const HuffmanTable& literals, const HuffmanTable& distances)
+        {
+            for (;;) {
+                // 56+ bits cover the longest symbol pair: 15 + 5 length bits, 15 + 13 distance bits
+                Refill();
+                int symbol = Decode(literals);
+                if (symbol < 256) {
+                    if (symbol < 0) {
+                        return Fail("corrupt deflate stream");
+                    }
+                    if (m_Out >= m_OutEnd) {
+                        return Fail("too much image data");
+                    }
+                    *m_Out++ = (uint8_t)symbol;
+                    continue;
+                }
+                if (symbol == 256) {
+                    Publish();
+                    return true;
+                }
+
+                symbol -= 257;
+                if (symbol >= 29) {
+                    return Fail("corrupt deflate stream");
+                }
+                uint32_t length = s_LengthBase[symbol] + Take(s_LengthExtra[symbol]);
+                int distanceSymbol = Decode(distances);
+                if (distanceSymbol < 0 || distanceSymbol >= 30) {
+                    return Fail("corrupt deflate stream");
+                }
+                size_t distance = s_DistanceBase[distanceSymbol] + Take(s_DistanceExtra[distanceSymbol]);
+                if (distance > (size_t)(m_Out - m_OutStart)) {
+                    return Fail("bad match distance");
+                }
+                if (length > (size_t)(m_OutEnd - m_Out)) {
+                    return Fail("too much image data");
+                }
+
+                const uint8_t* from = m_Out - distance;
+                uint8_t* to = m_Out;
+                m_Out += length;
+                if (distance >= 8 && m_OutEnd - m_Out >= (ptrdiff_t)s_CopySlack) {
+                    // Each 8-byte step reads only bytes already written, even when the match overlaps itself
+                    do {
+                        memcpy(to, from, 8);
+                        to += 8;
+                        from += 8;
+                    } while (to < m_Out);
+                } else if (distance == 1) {
+                    memset(to, *from, length);
+                } else {
+                    while (to < m_Out) {
+                        *to++ = *from++;
+                    }
+                }
+
+                if (m_Out - m_Published >= 65536) {
+                    Publish();
+                }
+            }
+        }
+
+        const uint8_t* m_In;
+        const uint8_t* m_InEnd;
+        uint8_t* m_OutStart;
+        uint8_t* m_Out;
+        uint8_t* m_OutEnd;
+        uint8_t* m_Published = nullptr;
+        InflateProgress* m_Progress;
+        uint64_t m_Bits = 0;
+        uint32_t m_Count = 0;
+        size_t m_Padding = 0;     // Zero bytes fed past the end of the input
+    };
+
+    // ---- PNG ----
+
+    static const uint8_t s_PNGSignature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    // Below this much filtered data the unfilter job costs more than it overlaps
+    static const size_t s_PipelineMinBytes = 256 * 1024;
+
+    struct PNGLayout {
+        uint32_t ColorType = 0;
+        uint32_t BytesPerPixel = 0;
+        size_t RowBytes = 0;
+        uint32_t Palette[256] = {};
+        TaggedVector<uint8_t, MemoryTag::Assets> Compressed;    // IDAT chunks, concatenated
+    };
+
+    static bool ParsePNGHeader(const uint8_t* data, size_t size, ImageInfo& info)
+    {
+        if (size < 33 || memcmp(data, s_PNGSignature, 8) != 0 || memcmp(data + 12, "IHDR", 4) != 0) {
+            return false;
+        }
+        static const int s_Channels[7] = { 1, 0, 3, 3, 2, 0, 4 };
+        uint32_t colorType = data[25];
+        uint32_t width = ReadBE32(data + 16);
+        uint32_t height = ReadBE32(data + 20);
+        if (!CheckDimensions(width, height)) {
+            return false;
+        }
+        info.Type = ImageFileType::PNG;
+        info.Width = width;
+        info.Height = height;
+        info.Channels = colorType < 7 ? s_Channels[colorType] : 0;
+
+        // Transparency adds an alpha channel; it must come before the image data
+        for (size_t offset = 33; offset + 12 <= size && memcmp(data + offset + 4, "IDAT", 4) != 0;) {
+            if (memcmp(data + offset + 4, "tRNS", 4) == 0 && (colorType == 0 || colorType == 2 || colorType == 3)) {
+                info.Channels++;
+                break;
+            }
+            offset += 12 + (size_t)ReadBE32(data + offset);
+        }
+        return info.Width > 0 && info.Height > 0 && info.Channels > 0;
+    }
+
+    // Collects what the engine path needs; false for anything it leaves to stb_image
+    static bool ReadPNGChunks(const uint8_t* data, size_t size, const ImageInfo& info, PNGLayout& png)
+    {
+        const uint8_t* header = data + 16;
+        uint32_t depth = header[8];
+        png.ColorType = header[9];
+        if (depth != 8 || header[10] != 0 || header[11] != 0 || header[12] != 0) {
+            return Fail("PNG bit depth or interlacing handled by stb_image");
+        }
+        static const uint32_t s_BytesPerPixel[7] = { 1, 0, 3, 1, 2, 0, 4 };
+        png.BytesPerPixel = s_BytesPerPixel[png.ColorType];
+        png.RowBytes = (size_t)info.Width * png.BytesPerPixel;
+
+        // Sized first: encoders commonly split the data into many small IDAT chunks
+        size_t compressedSize = 0;
+        for (size_t offset = 8; offset + 12 <= size;) {
+            uint32_t length = ReadBE32(data + offset);
+            if (memcmp(data + offset + 4, "IDAT", 4) == 0) {
+                compressedSize += length;
+            }
+            offset += 12 + (size_t)length;
+        }
+        png.Compressed.reserve(std::min(compressedSize, size));
+
+        bool hasPalette = false;
+        size_t offset = 8;
+        while (offset + 12 <= size) {
+            uint32_t length = ReadBE32(data + offset);
+            const uint8_t* type = data + offset + 4;
+            const uint8_t* body = data + offset + 8;
+            if (length > size - offset - 12) {
+                return Fail("truncated PNG chunk");
+            }
+
+            if (memcmp(type, "IDAT", 4) == 0) {
+                png.Compressed.insert(png.Compressed.end(), body, body + length);
+            } else if (memcmp(type, "PLTE", 4) == 0) {
+                if (length % 3 != 0 || length > 768) {
+                    return Fail("bad PNG palette");
+                }
+                for (uint32_t i = 0; i < length / 3; i++) {
+                    png.Palette[i] = (uint32_t)body[i * 3] | ((uint32_t)body[i * 3 + 1] << 8) |
+                                     ((uint32_t)body[i * 3 + 2] << 16) | 0xFF000000u;
+                }
+                hasPalette = true;
+            } else if (memcmp(type, "tRNS", 4) == 0) {
+                if (png.ColorType != 3) {
+                    return Fail("PNG colour-key transparency handled by stb_image");
+                }
+                for (uint32_t i = 0; i < length && i < 256; i++) {
+                    png.Palette[i] = (png.Palette[i] & 0x00FFFFFFu) | ((uint32_t)body[i] << 24);
+                }
+            } else if (memcmp(type, "IEND", 4) == 0) {
+                break;
+            }
+            offset += 12 + (size_t)length;
+        }
+
+        if (png.ColorType == 3 && !hasPalette) {
+            return Fail("PNG palette missing");
+        }
+        if (png.Compressed.empty()) {
+            return Fail("PNG has no image data");
+        }
+        return true;
+    }
+
+    // Same choice as the spec's predictor, arranged so it compiles to conditional moves
+    static int Paeth(int a, int b, int c)
+    {
+        int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+        if (pb < pa) {
+            pa = pb;
+            a = b;
+        }
+        return pc < pa ? c : a;
+    }
+
+    // Paeth for three and four-byte pixels, one pixel per step with its channels in the four lanes.
+    // Stops while a four-byte load still fits in the row; returns where the scalar loop continues.
+    // The seed loads read four bytes of the first pixel, so the row must hold at least one more
+    // pixel's worth of bytes: callers check rowBytes >= Bpp + 4.
+    template<uint32_t Bpp>
+    static size_t UnfilterPaethPixels(const uint8_t* src, const uint8_t* prior, uint8_t* row, size_t rowBytes)
+    {
+        const SIMD::Int4 low = SIMD::SetInt1(0xFF);
+        SIMD::Int4 a = SIMD::LoadBytesInt(row);
+        SIMD::Int4 c = SIMD::LoadBytesInt(prior);
+        size_t i = Bpp;
+        for (; i + 4 <= rowBytes; i += Bpp) {
+            SIMD::Int4 b = SIMD::LoadBytesInt(prior + i);
+            SIMD::Int4 p = SIMD::SubInt(b, c);
+            SIMD::Int4 q = SIMD::SubInt(a, c);
+            SIMD::Int4 pa = SIMD::AbsInt(p), pb = SIMD::AbsInt(q), pc = SIMD::AbsInt(SIMD::AddInt(p, q));
+            SIMD::Int4 useB = SIMD::CmpLTInt(pb, pa);
+            pa = SIMD::SelectInt(useB, pb, pa);
+            SIMD::Int4 predictor = SIMD::SelectInt(useB, b, a);
+            predictor = SIMD::SelectInt(SIMD::CmpLTInt(pc, pa), c, predictor);
+
+            a = SIMD::AndInt(SIMD::AddInt(SIMD::LoadBytesInt(src + i), predictor), low);
+            SIMD::StoreBytesInt(row + i, a);
+            c = b;
+        }
+        return i;
+    }
+
+    // Bytes per pixel as a template parameter so each filter's loop unrolls into Bpp independent
+    // byte chains
+    template<uint32_t Bpp>
+    static bool UnfilterRow(uint32_t filter, const uint8_t* src, const uint8_t* prior, uint8_t* row, size_t rowBytes)
+    {
+        switch (filter) {
+            case 0:
+                memcpy(row, src, rowBytes);
+                return true;
+            case 1:
+                memcpy(row, src, Bpp);
+                for (size_t i = Bpp; i < rowBytes; i++) {
+                    row[i] = (uint8_t)(src[i] + row[i - Bpp]);
+                }
+                return true;
+            case 2:
+                for (size_t i = 0; i < rowBytes; i++) {
+                    row[i] = (uint8_t)(src[i] + prior[i]);
+                }
+                return true;
+            case 3:
+                for (size_t i = 0; i < Bpp; i++) {
+                    row[i] = (uint8_t)(src[i] + (prior[i] >> 1));
+                }
+                for (size_t i = Bpp; i < rowBytes; i++) {
+                    row[i] = (uint8_t)(src[i] + ((row[i - Bpp] + prior[i]) >> 1));
+                }
+                return true;
+            case 4: {
+                for (size_t i = 0; i < Bpp; i++) {
+                    row[i] = (uint8_t)(src[i] + prior[i]);
+                }
+                size_t i = Bpp;
+                if (Bpp >= 3 && rowBytes >= Bpp + 4) {
+                    i = UnfilterPaethPixels<Bpp>(src, prior, row, rowBytes);
+                }
+                for (; i < rowBytes; i++) {
+                    row[i] = (uint8_t)(src[i] + Paeth(row[i - Bpp], prior[i], prior[i - Bpp]));
+                }
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    typedef bool (*RowUnfilter)(uint32_t filter, const uint8_t* src, const uint8_t* prior, uint8_t* row, size_t rowBytes);
+
+    // Unfilters each row as soon as the inflater has finished it and converts it into its
+    // bottom-up destination row. Rows are unfiltered into a separate pair of buffers: the
+    // filtered bytes must stay intact because later matches copy from them.
+    static bool UnfilterRows(const PNGLayout& png, const ImageInfo& info, const uint8_t* filtered, InflateProgress& rows, uint8_t* pixels)
+    {
+        static const RowConverter s_Converters[7] = { ConvertGray, nullptr, ConvertRGB<false>, ConvertPalette,
+                                                      ConvertGrayAlpha, nullptr, ConvertRGBA };
+        static const RowUnfilter s_Unfilters[5] = { nullptr, UnfilterRow<1>, UnfilterRow<2>, UnfilterRow<3>, UnfilterRow<4> };
+        const RowConverter convert = s_Converters[png.ColorType];
+        const RowUnfilter unfilter = s_Unfilters[png.BytesPerPixel];
+        const size_t stride = png.RowBytes + 1;
+
+        TaggedVector<uint8_t, MemoryTag::Assets> buffers(png.RowBytes * 2, 0);
+        uint8_t* prior = buffers.data();
+        uint8_t* current = prior + png.RowBytes;
+
+        size_t available = 0;
+        for (uint32_t y = 0; y < info.Height; y++) {
+            const size_t rowEnd = (size_t)(y + 1) * stride;
+            if (available < rowEnd) {
+                if (!rows.WaitFor(rowEnd)) {
+                    return false;
+                }
+                available = rows.Bytes.load(std::memory_order_acquire);
+            }
+
+            const uint8_t* src = filtered + (size_t)y * stride;
+            if (!unfilter(src[0], src + 1, prior, current, png.RowBytes)) {
+                return Fail("bad PNG filter type");
+            }
+            convert(current, pixels + (size_t)(info.Height - 1 - y) * info.Width * 4, info.Width, png.Palette);
+            std::swap(prior, current);
+        }
+        return true;
+    }
+
+    static bool DecodePNG(const uint8_t* data, size_t size, const ImageInfo& info, uint8_t* pixels)
+    {
+        PNGLayout png;
+        if (!ReadPNGChunks(data, size, info, png)) {
+            return false;
+        }
+
+        const size_t filteredSize = (png.RowBytes + 1) * info.Height;
+        TaggedVector<uint8_t, MemoryTag::Assets> filtered(filteredSize + s_CopySlack);
+        InflateProgress rows;
+
+        // With a worker and a spare core, unfiltering trails the inflater a few rows behind instead
+        // of waiting for the whole image; on one core the two would only take turns. It is a
+        // background job, so no frame wait picks it up and sits through this inflate; if no worker
+        // has started it by the time the inflate is done, Wait() runs it here.
+        bool pipelined = JobSystem::IsInitialized() && JobSystem::GetWorkerCount() > 0 &&
+                         std::thread::hardware_concurrency() > 1 && filteredSize >= s_PipelineMinBytes;
+        bool unfiltered = false;
+        const char* unfilterError = "";
+        JobHandle job;
+        if (pipelined) {
+            job = JobSystem::SubmitBackground([&]() {
+                unfiltered = UnfilterRows(png, info, filtered.data(), rows, pixels);
+                unfilterError = s_Error;
+            });
+        }
+
+        Inflater inflater(png.Compressed.data(), png.Compressed.size(), filtered.data(), filteredSize, &rows);
+        bool inflated = inflater.Run();
+        if (!inflated) {
+            rows.Fail();
+        }
+
+        if (pipelined) {
+            job.Wait();
+            if (inflated && !unfiltered) {
+                s_Error = unfilterError;
+            }
+        } else if (inflated) {
+            unfiltered = UnfilterRows(png, info, filtered.data(), rows, pixels);
+        }
+        return inflated && unfiltered;
+    }
+
+    // ---- Public interface ----
+
+    bool ReadImageInfo(const uint8_t* data, size_t size, ImageInfo& info)
+    {
+        info = ImageInfo();
+        if (ParsePNGHeader(data, size, info)) {
+            return true;
+        }
+        // TGA has no signature; the header checks rule out the other formats' magic numbers
+        TGALayout layout;
+        if (ParseTGAHeader(data, size, info, layout)) {
+            if (layout.MinSize > size) {
+                info = ImageInfo();
+                return Fail("truncated TGA");
+            }
+            return true;
+        }
+
+        int width = 0, height = 0, channels = 0;
+        if (size > (size_t)INT32_MAX || !stbi_info_from_memory(data, (int)size, &width, &height, &channels)) {
+            info = ImageInfo();
+            return Fail("unknown image format");
+        }
+        if (width <= 0 || height <= 0 || !CheckDimensions((uint32_t)width, (uint32_t)height)) {
+            return false;
+        }
+        info.Type = ImageFileType::Other;
+        info.Width = (uint32_t)width;
+        info.Height = (uint32_t)height;
+        info.Channels = channels;
+        return true;
+    }
+
+    static bool DecodeWithStb(const uint8_t* data, size_t size, const ImageInfo& info, uint8_t* pixels)
+    {
+        int width = 0, height = 0, channels = 0;
+        stbi_set_flip_vertically_on_load_thread(1);
+        unsigned char* decoded = stbi_load_from_memory(data, (int)size, &width, &height, &channels, 4);
+        if (!decoded) {
+            return Fail(stbi_failure_reason());
+        }
+        if ((uint32_t)width != info.Width || (uint32_t)height != info.Height) {
+            stbi_image_free(decoded);
+            return Fail("image size does not match its header");
+        }
+        memcpy(pixels, decoded, (size_t)width * height * 4);
+        stbi_image_free(decoded);
+        return true;
+    }
+
+    bool DecodeImage(const uint8_t* data, size_t size, const ImageInfo& info, uint8_t* pixels)
+    {
+        s_Error = "";
+        if (info.Type == ImageFileType::TGA) {
+            ImageInfo parsed;
+            TGALayout layout;
+            if (ParseTGAHeader(data, size, parsed, layout) && layout.ImageType != 0 &&
+                DecodeTGA(data, size, parsed, layout, pixels)) {
+                return true;
+            }
+        } else if (info.Type == ImageFileType::PNG) {
+            if (DecodePNG(data, size, info, pixels)) {
+                return true;
+            }
+        } else if (info.Type == ImageFileType::Unknown) {
+            return Fail("unknown image format");
+        }
+
+        // Other formats, and anything the engine path turned down; stb_image reports its own reason
+        return size <= (size_t)INT32_MAX && DecodeWithStb(data, size, info, pixels);
+    }
+
+    bool LoadImageFile(const std::string& path, ImageInfo& info, std::vector<uint8_t>& pixels)
+    {
+        VirtualFile file;
+        if (!FileSystem::Open(path, file)) {
+            return Fail("cannot open file");
+        }
+        FileBuffer data;
+        if (file.GetSize() == 0 || !file.ReadAll(data)) {
+            return Fail("cannot read file");
+        }
+        return LoadImageMemory(data.GetData(), data.GetSize(), info, pixels);
+    }
+
+    bool LoadImageMemory(const uint8_t* data, size_t size, ImageInfo& info, std::vector<uint8_t>& pixels)
+    {
+        if (!ReadImageInfo(data, size, info)) {
+            return false;
+        }
+        if ((size_t)info.Width > SIZE_MAX / 4 / info.Height) {
+            return Fail("image dimensions too large");
+        }
+        pixels.resize((size_t)info.Width * info.Height * 4);
+        return DecodeImage(data, size, info, pixels.data());
+    }
+
+    const char* GetImageDecodeError()
+    {
+        return s_Error;
+    }
+
+    const char* GetImageFileTypeName(ImageFileType type)
+    {
+        switch (type) {
+            case ImageFileType::TGA:   return "TGA";
+            case ImageFileType::PNG:   return "PNG";
+            case ImageFileType::Other: return "stb_image";
+            default:                   return "unknown";
+        }
+    }
+
+}
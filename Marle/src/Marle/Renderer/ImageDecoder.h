@@ -0,0 +1,49 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    enum class ImageFileType : uint8_t {
+        Unknown = 0,
+        TGA,
+        PNG,
+        Other       // Any other format stb_image reads (JPEG, BMP, GIF, ...)
+    };
+
+    struct ImageInfo {
+        ImageFileType Type = ImageFileType::Unknown;
+        uint32_t Width = 0, Height = 0;
+        int Channels = 0;       // In the file; decoding always produces four
+    };
+
+    // Reads the header only. Returns false when the data is not an image stb_image could read either,
+    // when a side is over 16384 pixels, or when an uncompressed TGA is too short for its pixels.
+    bool ReadImageInfo(const uint8_t* data, size_t size, ImageInfo& info);
+
+    // Decodes to RGBA8 with rows bottom-up (the engine/OpenGL convention), writing straight into
+    // `pixels`, which must hold Width * Height * 4 bytes: a mip level vector or a mapped upload buffer.
+    //
+    // Uncompressed and RLE TGA (8-bit gray, 24 and 32-bit colour) and 8-bit non-interlaced PNG are
+    // decoded by the engine: TGA rows are swizzled with SIMD and flipped for free by writing them
+    // in destination order, in parallel on the JobSystem. PNG inflates on the calling thread
+    // while a job unfilters and converts finished rows behind it. Everything else, and any file the
+    // engine path rejects, goes through stb_image.
+    bool DecodeImage(const uint8_t* data, size_t size, const ImageInfo& info, uint8_t* pixels);
+
+    // Reads (through the FileSystem) and decodes a file; pixels is resized to fit. Safe to call
+    // from any thread.
+    bool LoadImageFile(const std::string& path, ImageInfo& info, std::vector<uint8_t>& pixels);
+    // Same, for a whole file already in memory
+    bool LoadImageMemory(const uint8_t* data, size_t size, ImageInfo& info, std::vector<uint8_t>& pixels);
+
+    // Why the last DecodeImage/LoadImageFile on this thread failed
+    const char* GetImageDecodeError();
+
+    const char* GetImageFileTypeName(ImageFileType type);
+
+}
@@ -0,0 +1,145 @@
+#include "mrlpch.h"
+#include "MipGenerator.h"
+#include "../Core/JobSystem.h"
+#include "../Core/SIMD.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Marle {
+
+    // Levels smaller than this many pixels are filtered on the calling thread
+    static const uint32_t s_ParallelPixelThreshold = 128 * 128;
+    static const uint32_t s_LinearTableSize = 4096;
+
+    struct GammaTables {
+        float ToLinear[256];
+        uint8_t ToSRGB[s_LinearTableSize];
+
+        GammaTables()
+        {
+            for (uint32_t i = 0; i < 256; i++) {
+                float c = i / 255.0f;
+                ToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (uint32_t i = 0; i < s_LinearTableSize; i++) {
+                float l = (float)i / (float)(s_LinearTableSize - 1);
+                float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                ToSRGB[i] = (uint8_t)std::min(std::max(c * 255.0f + 0.5f, 0.0f), 255.0f);
+            }
+        }
+    };
+
+    static const GammaTables& GetGammaTables()
+    {
+        static GammaTables s_Tables;
+        return s_Tables;
+    }
+
+    uint32_t GetMipCount(uint32_t width, uint32_t height)
+    {
+        uint32_t count = 1;
+        for (uint32_t size = std::max(width, height); size > 1; size >>= 1) {
+            count++;
+        }
+        return count;
+    }
+
+    static void ForEachRow(uint32_t rows, uint32_t pixels, const std::function<void(uint32_t, uint32_t)>& fn)
+    {
+        if (pixels >= s_ParallelPixelThreshold) {
+            JobSystem::ParallelFor(rows, 8, fn);
+        } else {
+            fn(0, rows);
+        }
+    }
+
+    // Premultiplied linear floats back to straight-alpha sRGB bytes
+    static void EncodeLevel(const float* linear, uint32_t width, uint32_t height, uint8_t* out)
+    {
+        const GammaTables& tables = GetGammaTables();
+        ForEachRow(height, width * height, [&](uint32_t firstRow, uint32_t lastRow) {
+            const SIMD::Float4 scale = SIMD::Set(s_LinearTableSize - 1.0f, s_LinearTableSize - 1.0f, s_LinearTableSize - 1.0f, 255.0f);
+            const SIMD::Float4 half = SIMD::Set1(0.5f);
+            const SIMD::Float4 zero = SIMD::Zero();
+            const SIMD::Float4 one = SIMD::Set1(1.0f);
+            int32_t indices[4];
+
+            for (uint32_t y = firstRow; y < lastRow; y++) {
+                const float* src = linear + (size_t)y * width * 4;
+                uint8_t* dst = out + (size_t)y * width * 4;
+                for (uint32_t x = 0; x < width; x++, src += 4, dst += 4) {
+                    float alpha = src[3];
+                    float inverse = alpha > 0.0f ? 1.0f / alpha : 0.0f;
+                    SIMD::Float4 straight = SIMD::Mul(SIMD::Load(src), SIMD::Set(inverse, inverse, inverse, 1.0f));
+                    straight = SIMD::Min(SIMD::Max(straight, zero), one);
+                    SIMD::StoreInt(indices, SIMD::ToInt(SIMD::MulAdd(straight, scale, half)));
+
+                    dst[0] = tables.ToSRGB[indices[0]];
+                    dst[1] = tables.ToSRGB[indices[1]];
+                    dst[2] = tables.ToSRGB[indices[2]];
+                    dst[3] = (uint8_t)indices[3];
+                }
+            }
+        });
+    }
+
+    void GenerateMipChain(const uint8_t* rgba, uint32_t width, uint32_t height, std::vector<std::vector<uint8_t>>& levels)
+    {
+        const uint32_t count = GetMipCount(width, height);
+        levels.resize(count);
+        if (levels[0].data() != rgba) {
+            levels[0].assign(rgba, rgba + (size_t)width * height * 4);
+        }
+        if (count == 1) {
+            return;
+        }
+
+        // Level 0 to premultiplied linear
+        const GammaTables& tables = GetGammaTables();
+        std::vector<float> current((size_t)width * height * 4), next;
+        ForEachRow(height, width * height, [&](uint32_t firstRow, uint32_t lastRow) {
+            for (size_t i = (size_t)firstRow * width; i < (size_t)lastRow * width; i++) {
+                const uint8_t* p = rgba + i * 4;
+                float alpha = p[3] / 255.0f;
+                float* out = &current[i * 4];
+                out[0] = tables.ToLinear[p[0]] * alpha;
+                out[1] = tables.ToLinear[p[1]] * alpha;
+                out[2] = tables.ToLinear[p[2]] * alpha;
+                out[3] = alpha;
+            }
+        });
+
+        uint32_t srcWidth = width, srcHeight = height;
+        for (uint32_t level = 1; level < count; level++) {
+            const uint32_t dstWidth = std::max(srcWidth >> 1, 1u);
+            const uint32_t dstHeight = std::max(srcHeight >> 1, 1u);
+            next.resize((size_t)dstWidth * dstHeight * 4);
+
+            // One pixel (RGBA) per Float4; odd edges repeat the last row/column
+            ForEachRow(dstHeight, dstWidth * dstHeight, [&](uint32_t firstRow, uint32_t lastRow) {
+                const SIMD::Float4 quarter = SIMD::Set1(0.25f);
+                for (uint32_t y = firstRow; y < lastRow; y++) {
+                    const float* row0 = &current[(size_t)std::min(y * 2, srcHeight - 1) * srcWidth * 4];
+                    const float* row1 = &current[(size_t)std::min(y * 2 + 1, srcHeight - 1) * srcWidth * 4];
+                    float* dst = &next[(size_t)y * dstWidth * 4];
+                    for (uint32_t x = 0; x < dstWidth; x++, dst += 4) {
+                        uint32_t x0 = std::min(x * 2, srcWidth - 1) * 4;
+                        uint32_t x1 = std::min(x * 2 + 1, srcWidth - 1) * 4;
+                        SIMD::Float4 sum = SIMD::Add(SIMD::Add(SIMD::Load(row0 + x0), SIMD::Load(row0 + x1)),
+                                                     SIMD::Add(SIMD::Load(row1 + x0), SIMD::Load(row1 + x1)));
+                        SIMD::Store(dst, SIMD::Mul(sum, quarter));
+                    }
+                }
+            });
+
+            levels[level].resize(next.size());
+            EncodeLevel(next.data(), dstWidth, dstHeight, levels[level].data());
+
+            current.swap(next);
+            srcWidth = dstWidth;
+            srcHeight = dstHeight;
+        }
+    }
+
+}
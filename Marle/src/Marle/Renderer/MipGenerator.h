@@ -0,0 +1,19 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    // Number of levels in a full chain down to 1x1
+    uint32_t GetMipCount(uint32_t width, uint32_t height);
+
+    // Fills levels with a full mip chain for an RGBA8 image, levels[0] being a copy of the input
+    // (or the input itself, when it was decoded straight into levels[0]).
+    // Colors are treated as sRGB: every level is a 2x2 box filter of the previous one computed in
+    // premultiplied linear light (four channels per SIMD lane group), so dark fringes and
+    // transparent texels do not bleed into the smaller levels. Rows of large levels run on the JobSystem.
+    void GenerateMipChain(const uint8_t* rgba, uint32_t width, uint32_t height, std::vector<std::vector<uint8_t>>& levels);
+
+}
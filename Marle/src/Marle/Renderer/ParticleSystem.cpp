@@ -0,0 +1,210 @@
+#include "mrlpch.h"
+#include "ParticleSystem.h"
+#include "Renderer2D.h"
+#include "VertexBufferLayout.h"
+#include "../Core/JobSystem.h"
+#include "../Core/SIMD.h"
+#include "../Core/SystemScheduler.h"
+
+#include <algorithm>
+
+namespace Marle {
+
+    // Emitters below this many live particles are not worth the job system round trip
+    static const uint32_t s_ParallelThreshold = 32768;
+    // Work unit per job, in blocks of four particles
+    static const uint32_t s_BlocksPerJob = 2048;
+
+    ParticleEmitter::ParticleEmitter(const ParticleEmitterProps& props)
+        : m_Props(props)
+    {
+        m_Capacity = (std::max<uint32_t>(props.MaxParticles, 1) + 3) & ~3u;
+        m_Props.MaxParticles = m_Capacity;
+
+        m_PositionX.resize(m_Capacity);
+        m_PositionY.resize(m_Capacity);
+        m_VelocityX.resize(m_Capacity);
+        m_VelocityY.resize(m_Capacity);
+        m_Life.resize(m_Capacity);
+        m_InvLifetime.resize(m_Capacity);
+        m_Color.resize(m_Capacity);
+    }
+
+    ParticleEmitter::~ParticleEmitter()
+    {
+        if (m_InstanceVAO) {
+            glDeleteVertexArrays(1, &m_InstanceVAO);
+            glDeleteBuffers(1, &m_InstanceVBO);
+        }
+    }
+
+    void ParticleEmitter::Burst(uint32_t count)
+    {
+        m_PendingBurst += count;
+        uint32_t steps = std::max<uint32_t>(m_Props.BurstSpreadSteps, 1);
+        m_BurstPerStep = (m_PendingBurst + steps - 1) / steps;
+    }
+
+    void ParticleEmitter::Update(float dt)
+    {
+        uint32_t blockCount = (m_AliveCount + 3) / 4;
+        if (m_AliveCount >= s_ParallelThreshold && JobSystem::IsInitialized()) {
+            JobSystem::ParallelFor(blockCount, s_BlocksPerJob, [this, dt](uint32_t begin, uint32_t end) {
+                Integrate(begin, end, dt);
+            });
+        } else {
+            Integrate(0, blockCount, dt);
+        }
+
+        Compact();
+
+        m_EmissionAccumulator += m_Props.EmissionRate * dt;
+        uint32_t spawn = (uint32_t)m_EmissionAccumulator;
+        m_EmissionAccumulator -= (float)spawn;
+
+        if (m_PendingBurst > 0) {
+            uint32_t released = std::min(m_PendingBurst, m_BurstPerStep);
+            m_PendingBurst -= released;
+            spawn += released;
+        }
+
+        Emit(spawn);
+    }
+
+    void ParticleEmitter::Integrate(uint32_t firstBlock, uint32_t lastBlock, float dt)
+    {
+        // Pools are padded to a multiple of four, so the last block may run over dead slots harmlessly
+        const SIMD::Float4 step = SIMD::Set1(dt);
+        const SIMD::Float4 accelX = SIMD::Set1(m_Props.Acceleration.x * dt);
+        const SIMD::Float4 accelY = SIMD::Set1(m_Props.Acceleration.y * dt);
+
+        float* px = m_PositionX.data();
+        float* py = m_PositionY.data();
+        float* vx = m_VelocityX.data();
+        float* vy = m_VelocityY.data();
+        float* life = m_Life.data();
+
+        for (uint32_t block = firstBlock; block < lastBlock; block++) {
+            uint32_t i = block * 4;
+
+            SIMD::Float4 velX = SIMD::Add(SIMD::Load(vx + i), accelX);
+            SIMD::Float4 velY = SIMD::Add(SIMD::Load(vy + i), accelY);
+            SIMD::Store(vx + i, velX);
+            SIMD::Store(vy + i, velY);
+
+            SIMD::Store(px + i, SIMD::MulAdd(velX, step, SIMD::Load(px + i)));
+            SIMD::Store(py + i, SIMD::MulAdd(velY, step, SIMD::Load(py + i)));
+            SIMD::Store(life + i, SIMD::Sub(SIMD::Load(life + i), step));
+        }
+    }
+
+    void ParticleEmitter::MoveParticle(uint32_t from, uint32_t to)
+    {
+        m_PositionX[to] = m_PositionX[from];
+        m_PositionY[to] = m_PositionY[from];
+        m_VelocityX[to] = m_VelocityX[from];
+        m_VelocityY[to] = m_VelocityY[from];
+        m_Life[to] = m_Life[from];
+        m_InvLifetime[to] = m_InvLifetime[from];
+        m_Color[to] = m_Color[from];
+    }
+
+    void ParticleEmitter::Compact()
+    {
+        // Swap-remove: a dead particle is overwritten by the last live one, keeping [0, alive) dense.
+        // Whole blocks without deaths are skipped with a single compare.
+        const SIMD::Float4 zero = SIMD::Zero();
+        uint32_t alive = m_AliveCount;
+        uint32_t i = 0;
+
+        while (i < alive) {
+            if (i + 4 <= alive && SIMD::MoveMask(SIMD::CmpLE(SIMD::Load(&m_Life[i]), zero)) == 0) {
+                i += 4;
+                continue;
+            }
+            if (m_Life[i] <= 0.0f) {
+                alive--;
+                MoveParticle(alive, i);
+            } else {
+                i++;
+            }
+        }
+
+        m_AliveCount = alive;
+    }
+
+    float ParticleEmitter::RandomFloat()
+    {
+        // xorshift32, plenty for visual variation
+        m_RandomState ^= m_RandomState << 13;
+        m_RandomState ^= m_RandomState >> 17;
+        m_RandomState ^= m_RandomState << 5;
+        return (float)(m_RandomState >> 8) * (1.0f / 16777216.0f);
+    }
+
+    void ParticleEmitter::Emit(uint32_t count)
+    {
+        count = std::min(count, m_Capacity - m_AliveCount);
+
+        for (uint32_t n = 0; n < count; n++) {
+            uint32_t i = m_AliveCount++;
+
+            m_PositionX[i] = m_Props.Position.x;
+            m_PositionY[i] = m_Props.Position.y;
+            m_VelocityX[i] = glm::mix(m_Props.VelocityMin.x, m_Props.VelocityMax.x, RandomFloat());
+            m_VelocityY[i] = glm::mix(m_Props.VelocityMin.y, m_Props.VelocityMax.y, RandomFloat());
+
+            float lifetime = std::max(glm::mix(m_Props.LifetimeMin, m_Props.LifetimeMax, RandomFloat()), 0.001f);
+            m_Life[i] = lifetime;
+            m_InvLifetime[i] = 1.0f / lifetime;
+
+            m_Color[i] = PackUNorm8x4(glm::mix(m_Props.ColorMin, m_Props.ColorMax, RandomFloat()));
+        }
+    }
+
+    ParticleEmitter* ParticleSystem::CreateEmitter(const ParticleEmitterProps& props)
+    {
+        SystemScheduler::ValidateAccess<ParticleSystem>(true);
+        m_Emitters.push_back(std::make_unique<ParticleEmitter>(props));
+        return m_Emitters.back().get();
+    }
+
+    void ParticleSystem::DestroyEmitter(ParticleEmitter* emitter)
+    {
+        SystemScheduler::ValidateAccess<ParticleSystem>(true);
+        m_Emitters.erase(std::remove_if(m_Emitters.begin(), m_Emitters.end(),
+                                        [emitter](const std::unique_ptr<ParticleEmitter>& e) { return e.get() == emitter; }),
+                         m_Emitters.end());
+    }
+
+    void ParticleSystem::Update(float dt)
+    {
+        SystemScheduler::ValidateAccess<ParticleSystem>(true);
+        for (auto& emitter : m_Emitters) {
+            emitter->Update(dt);
+        }
+    }
+
+    void ParticleSystem::Render()
+    {
+        SystemScheduler::ValidateAccess<ParticleSystem>(false);
+        for (ParticleBlendMode mode : { ParticleBlendMode::Alpha, ParticleBlendMode::Additive }) {
+            for (auto& emitter : m_Emitters) {
+                if (emitter->GetProps().BlendMode == mode && emitter->GetAliveCount() > 0) {
+                    Renderer2D::DrawParticles(*emitter);
+                }
+            }
+        }
+    }
+
+    uint32_t ParticleSystem::GetAliveCount() const
+    {
+        SystemScheduler::ValidateAccess<ParticleSystem>(false);
+        uint32_t total = 0;
+        for (const auto& emitter : m_Emitters) {
+            total += emitter->GetAliveCount();
+        }
+        return total;
+    }
+
+}
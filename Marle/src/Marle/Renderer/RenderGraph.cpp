@@ -0,0 +1,471 @@
+#include "mrlpch.h"
+#include "RenderGraph.h"
+#include "RenderProfiler.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace Marle {
+
+    // Pool entries not used for this many frames give their memory back
+    static const uint64_t s_PoolRetainFrames = 120;
+
+    struct GraphResource {
+        const char* Name = nullptr;
+        RenderGraph::TargetDesc Desc;
+        bool Imported = false;              // The backbuffer; never pooled or read
+        FramebufferSpec Spec;               // Desc resolved against the backbuffer size
+        uint32_t Physical = RenderGraph::InvalidResource;
+        uint32_t FirstUse = 0;
+        uint32_t LastUse = 0;
+        bool Used = false;
+    };
+
+    struct GraphPass {
+        const char* Name = nullptr;
+        RenderGraph::ExecuteFunc Execute;
+        std::vector<RenderGraphResource> Reads;
+        RenderGraphResource Target = RenderGraph::InvalidResource;
+        bool Clear = false;
+        bool SideEffect = false;
+        bool Alive = false;
+    };
+
+    struct PoolEntry {
+        std::unique_ptr<OpenGLFramebuffer> Framebuffer;
+        uint64_t LastFrame = 0;
+        uint32_t BusyUntil = 0;             // Last pass position (this frame) that uses it
+    };
+
+    struct RenderGraph::RenderGraphData {
+        std::vector<GraphPass> Passes;
+        std::vector<GraphResource> Resources;
+        std::vector<uint32_t> Order;        // Live passes in execution order
+        std::vector<PoolEntry> Pool;
+        uint64_t Frame = 0;
+        bool InFrame = false;
+        GLint BackbufferFBO = 0;
+        uint32_t Width = 0;
+        uint32_t Height = 0;
+        Stats FrameStats;
+    };
+
+    std::unique_ptr<RenderGraph::RenderGraphData> RenderGraph::s_Data = nullptr;
+
+    void RenderGraph::Init()
+    {
+        s_Data = std::make_unique<RenderGraphData>();
+        printf("RenderGraph initialized\n");
+    }
+
+    void RenderGraph::Shutdown()
+    {
+        s_Data.reset();
+    }
+
+    bool RenderGraph::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    void RenderGraph::BeginFrame(uint32_t width, uint32_t height)
+    {
+        if (!s_Data) {
+            return;
+        }
+        RenderGraphData& data = *s_Data;
+
+        data.Frame++;
+        data.Passes.clear();
+        data.Resources.clear();
+        data.Order.clear();
+        data.Width = std::max(width, 1u);
+        data.Height = std::max(height, 1u);
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &data.BackbufferFBO);
+
+        GraphResource backbuffer;
+        backbuffer.Name = "Backbuffer";
+        backbuffer.Imported = true;
+        backbuffer.Spec.Width = data.Width;
+        backbuffer.Spec.Height = data.Height;
+        data.Resources.push_back(backbuffer);
+        data.InFrame = true;
+    }
+
+    RenderGraphResource RenderGraph::GetBackbuffer()
+    {
+        return 0;
+    }
+
+    void RenderGraph::AddPass(const char* name, const SetupFunc& setup, const ExecuteFunc& execute)
+    {
+        if (!s_Data || !s_Data->InFrame) {
+            printf("Error: RenderGraph::AddPass('%s') outside a frame\n", name);
+            return;
+        }
+
+        GraphPass pass;
+        pass.Name = name;
+        pass.Execute = execute;
+        s_Data->Passes.push_back(std::move(pass));
+
+        PassBuilder builder((uint32_t)s_Data->Passes.size() - 1);
+        setup(builder);
+    }
+
+    RenderGraphResource RenderGraph::PassBuilder::Create(const char* name, const TargetDesc& desc)
+    {
+        GraphResource resource;
+        resource.Name = name;
+        resource.Desc = desc;
+        s_Data->Resources.push_back(resource);
+        return (RenderGraphResource)s_Data->Resources.size() - 1;
+    }
+
+    void RenderGraph::PassBuilder::Read(RenderGraphResource resource)
+    {
+        GraphPass& pass = s_Data->Passes[m_Pass];
+        if (resource >= s_Data->Resources.size()) {
+            printf("Error: Render pass '%s' reads an unknown resource\n", pass.Name);
+            return;
+        }
+        if (s_Data->Resources[resource].Imported) {
+            printf("Error: Render pass '%s' cannot read the backbuffer\n", pass.Name);
+            return;
+        }
+        if (resource == pass.Target) {
+            printf("Error: Render pass '%s' reads the target it writes (%s)\n", pass.Name, s_Data->Resources[resource].Name);
+            return;
+        }
+        pass.Reads.push_back(resource);
+    }
+
+    RenderGraphResource RenderGraph::PassBuilder::Write(RenderGraphResource resource, bool clear)
+    {
+        GraphPass& pass = s_Data->Passes[m_Pass];
+        if (resource >= s_Data->Resources.size()) {
+            printf("Error: Render pass '%s' writes an unknown resource\n", pass.Name);
+            return InvalidResource;
+        }
+        if (pass.Target != InvalidResource) {
+            printf("Error: Render pass '%s' already writes %s\n", pass.Name, s_Data->Resources[pass.Target].Name);
+            return resource;
+        }
+        if (std::find(pass.Reads.begin(), pass.Reads.end(), resource) != pass.Reads.end()) {
+            printf("Error: Render pass '%s' writes a target it reads (%s)\n", pass.Name, s_Data->Resources[resource].Name);
+            return resource;
+        }
+        pass.Target = resource;
+        pass.Clear = clear;
+        return resource;
+    }
+
+    void RenderGraph::PassBuilder::SetSideEffect()
+    {
+        s_Data->Passes[m_Pass].SideEffect = true;
+    }
+
+    GLuint RenderGraph::PassContext::GetTexture(RenderGraphResource resource) const
+    {
+        if (!s_Data || resource >= s_Data->Resources.size()) {
+            return 0;
+        }
+        const GraphResource& target = s_Data->Resources[resource];
+        if (target.Imported || target.Physical == InvalidResource) {
+            return 0;
+        }
+        return s_Data->Pool[target.Physical].Framebuffer->GetColorAttachment();
+    }
+
+    glm::uvec2 RenderGraph::PassContext::GetSize(RenderGraphResource resource) const
+    {
+        if (!s_Data || resource >= s_Data->Resources.size()) {
+            return glm::uvec2(0);
+        }
+        const FramebufferSpec& spec = s_Data->Resources[resource].Spec;
+        return glm::uvec2(spec.Width, spec.Height);
+    }
+
+    bool RenderGraph::Compile()
+    {
+        RenderGraphData& data = *s_Data;
+        const uint32_t passCount = (uint32_t)data.Passes.size();
+        const uint32_t resourceCount = (uint32_t)data.Resources.size();
+
+        std::vector<std::vector<uint32_t>> writers(resourceCount);
+        std::vector<std::vector<uint32_t>> readers(resourceCount);
+        for (uint32_t p = 0; p < passCount; p++) {
+            const GraphPass& pass = data.Passes[p];
+            if (pass.Target != InvalidResource) {
+                writers[pass.Target].push_back(p);
+            }
+            for (RenderGraphResource r : pass.Reads) {
+                readers[r].push_back(p);
+            }
+        }
+
+        // Culling: walk back from the backbuffer writers and side-effect passes; a target is
+        // needed once a live pass reads it, and then every pass that writes it is live too
+        std::vector<uint32_t> stack;
+        std::vector<bool> needed(resourceCount, false);
+        for (uint32_t p = 0; p < passCount; p++) {
+            GraphPass& pass = data.Passes[p];
+            pass.Alive = pass.SideEffect || (pass.Target != InvalidResource && data.Resources[pass.Target].Imported);
+            if (pass.Alive) {
+                stack.push_back(p);
+            }
+        }
+        while (!stack.empty()) {
+            const GraphPass& pass = data.Passes[stack.back()];
+            stack.pop_back();
+            for (RenderGraphResource r : pass.Reads) {
+                if (needed[r]) {
+                    continue;
+                }
+                needed[r] = true;
+                if (writers[r].empty()) {
+                    printf("Warning: Render pass '%s' reads %s, which no pass writes\n", pass.Name, data.Resources[r].Name);
+                }
+                for (uint32_t w : writers[r]) {
+                    if (!data.Passes[w].Alive) {
+                        data.Passes[w].Alive = true;
+                        stack.push_back(w);
+                    }
+                }
+            }
+        }
+
+        // Ordering: writers of a target run in the order they were added, and all of them before
+        // any reader. Ties go to the pass added first, so independent passes keep their order.
+        std::vector<std::vector<uint32_t>> edges(passCount);
+        std::vector<uint32_t> incoming(passCount, 0);
+        for (uint32_t r = 0; r < resourceCount; r++) {
+            uint32_t previous = InvalidResource;
+            for (uint32_t w : writers[r]) {
+                if (!data.Passes[w].Alive) {
+                    continue;
+                }
+                if (previous != InvalidResource) {
+                    edges[previous].push_back(w);
+                    incoming[w]++;
+                }
+                previous = w;
+                for (uint32_t reader : readers[r]) {
+                    if (data.Passes[reader].Alive) {
+                        edges[w].push_back(reader);
+                        incoming[reader]++;
+                    }
+                }
+            }
+        }
+
+        uint32_t alive = 0;
+        std::vector<bool> scheduled(passCount, false);
+        for (uint32_t p = 0; p < passCount; p++) {
+            alive += data.Passes[p].Alive ? 1 : 0;
+        }
+        while (data.Order.size() < alive) {
+            uint32_t next = InvalidResource;
+            for (uint32_t p = 0; p < passCount; p++) {
+                if (data.Passes[p].Alive && !scheduled[p] && incoming[p] == 0) {
+                    next = p;
+                    break;
+                }
+            }
+            if (next == InvalidResource) {
+                printf("Error: RenderGraph has a dependency cycle; %u passes skipped\n", alive - (uint32_t)data.Order.size());
+                break;
+            }
+            scheduled[next] = true;
+            data.Order.push_back(next);
+            for (uint32_t e : edges[next]) {
+                incoming[e]--;
+            }
+        }
+
+        // Lifetimes of transient targets in execution positions
+        for (uint32_t position = 0; position < data.Order.size(); position++) {
+            const GraphPass& pass = data.Passes[data.Order[position]];
+            auto touch = [&](RenderGraphResource r) {
+                GraphResource& resource = data.Resources[r];
+                if (!resource.Used) {
+                    resource.Used = true;
+                    resource.FirstUse = position;
+                }
+                resource.LastUse = position;
+            };
+            if (pass.Target != InvalidResource) {
+                touch(pass.Target);
+            }
+            for (RenderGraphResource r : pass.Reads) {
+                touch(r);
+            }
+        }
+
+        // Aliasing: targets in order of first use take a pooled framebuffer of the same spec that
+        // is idle this frame or whose previous user is already done
+        std::vector<uint32_t> transients;
+        for (uint32_t r = 0; r < resourceCount; r++) {
+            GraphResource& resource = data.Resources[r];
+            if (resource.Imported || !resource.Used) {
+                continue;
+            }
+            resource.Spec.Width = resource.Desc.Width ? resource.Desc.Width
+                                                      : std::max((uint32_t)(data.Width * resource.Desc.Scale), 1u);
+            resource.Spec.Height = resource.Desc.Height ? resource.Desc.Height
+                                                        : std::max((uint32_t)(data.Height * resource.Desc.Scale), 1u);
+            resource.Spec.Format = resource.Desc.Format;
+            resource.Spec.Depth = resource.Desc.Depth;
+            transients.push_back(r);
+        }
+        std::stable_sort(transients.begin(), transients.end(), [&](uint32_t a, uint32_t b) {
+            return data.Resources[a].FirstUse < data.Resources[b].FirstUse;
+        });
+
+        Stats& stats = data.FrameStats;
+        size_t peak = stats.PeakTransientBytes;
+        stats = Stats();
+        stats.PeakTransientBytes = peak;
+        stats.Passes = (uint32_t)data.Order.size();
+        stats.CulledPasses = passCount - alive;
+        stats.TransientTargets = (uint32_t)transients.size();
+
+        // Release framebuffers nothing has wanted for a while, before any index is handed out
+        for (size_t i = data.Pool.size(); i-- > 0;) {
+            if (data.Pool[i].LastFrame + s_PoolRetainFrames < data.Frame) {
+                data.Pool.erase(data.Pool.begin() + i);
+            }
+        }
+
+        for (uint32_t r : transients) {
+            GraphResource& resource = data.Resources[r];
+            uint32_t chosen = InvalidResource;
+            for (uint32_t i = 0; i < data.Pool.size(); i++) {
+                PoolEntry& entry = data.Pool[i];
+                bool free = entry.LastFrame != data.Frame || entry.BusyUntil < resource.FirstUse;
+                if (free && entry.Framebuffer->GetSpec() == resource.Spec) {
+                    chosen = i;
+                    break;
+                }
+            }
+            if (chosen == InvalidResource) {
+                PoolEntry entry;
+                entry.Framebuffer = std::make_unique<OpenGLFramebuffer>(resource.Spec);
+                if (!entry.Framebuffer->IsValid()) {
+                    continue;
+                }
+                data.Pool.push_back(std::move(entry));
+                chosen = (uint32_t)data.Pool.size() - 1;
+            }
+
+            PoolEntry& entry = data.Pool[chosen];
+            if (entry.LastFrame != data.Frame) {
+                stats.PhysicalTargets++;
+                stats.TransientBytes += entry.Framebuffer->GetMemorySize();
+            }
+            entry.LastFrame = data.Frame;
+            entry.BusyUntil = resource.LastUse;
+            resource.Physical = chosen;
+            stats.UnaliasedBytes += OpenGLFramebuffer::GetMemorySize(resource.Spec);
+        }
+        stats.PeakTransientBytes = std::max(stats.PeakTransientBytes, stats.TransientBytes);
+
+        for (const PoolEntry& entry : data.Pool) {
+            stats.PoolBytes += entry.Framebuffer->GetMemorySize();
+        }
+
+        return data.Order.size() == alive;
+    }
+
+    void RenderGraph::Execute()
+    {
+        if (!s_Data || !s_Data->InFrame) {
+            return;
+        }
+        RenderGraphData& data = *s_Data;
+        data.InFrame = false;
+
+        Compile();
+        if (data.Order.empty()) {
+            return;
+        }
+
+        GLfloat backbufferClear[4];
+        glGetFloatv(GL_COLOR_CLEAR_VALUE, backbufferClear);
+
+        PassContext context;
+        for (uint32_t p : data.Order) {
+            GraphPass& pass = data.Passes[p];
+            RenderProfiler::ScopedPass scope(pass.Name);
+
+            if (pass.Target != InvalidResource) {
+                const GraphResource& target = data.Resources[pass.Target];
+                if (target.Imported) {
+                    glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)data.BackbufferFBO);
+                    glViewport(0, 0, data.Width, data.Height);
+                    if (pass.Clear) {
+                        glClearColor(backbufferClear[0], backbufferClear[1], backbufferClear[2], backbufferClear[3]);
+                        glClear(GL_COLOR_BUFFER_BIT);
+                    }
+                } else if (target.Physical != InvalidResource) {
+                    data.Pool[target.Physical].Framebuffer->Bind();
+                    if (pass.Clear) {
+                        const glm::vec4& color = target.Desc.ClearColor;
+                        glClearColor(color.x, color.y, color.z, color.w);
+                        glClear(GL_COLOR_BUFFER_BIT | (target.Spec.Depth ? GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT : 0));
+                    }
+                } else {
+                    continue; // Its framebuffer could not be created
+                }
+                RenderProfiler::CountStateChange();
+            }
+
+            if (pass.Execute) {
+                pass.Execute(context);
+            }
+        }
+
+        glBindFramebuffer(GL_FRAMEBUFFER, (GLuint)data.BackbufferFBO);
+        glViewport(0, 0, data.Width, data.Height);
+        glClearColor(backbufferClear[0], backbufferClear[1], backbufferClear[2], backbufferClear[3]);
+    }
+
+    const RenderGraph::Stats& RenderGraph::GetStats()
+    {
+        static const Stats s_Empty;
+        return s_Data ? s_Data->FrameStats : s_Empty;
+    }
+
+    void RenderGraph::PrintStats()
+    {
+        if (!s_Data) {
+            return;
+        }
+        const RenderGraphData& data = *s_Data;
+        const Stats& stats = data.FrameStats;
+        const double mb = 1.0 / (1024.0 * 1024.0);
+
+        printf("RenderGraph frame %llu: %u passes (%u culled)\n", (unsigned long long)data.Frame, stats.Passes, stats.CulledPasses);
+        for (uint32_t p : data.Order) {
+            const GraphPass& pass = data.Passes[p];
+            const char* target = pass.Target != InvalidResource ? data.Resources[pass.Target].Name : "-";
+            printf("  %-20s -> %s\n", pass.Name, target);
+        }
+        for (const GraphPass& pass : data.Passes) {
+            if (!pass.Alive) {
+                printf("  %-20s (culled)\n", pass.Name);
+            }
+        }
+        for (const GraphResource& resource : data.Resources) {
+            if (resource.Imported || !resource.Used) {
+                continue;
+            }
+            printf("  target %-16s %4ux%-4u %s  passes %u-%u\n", resource.Name, resource.Spec.Width, resource.Spec.Height,
+                   resource.Spec.Format == FramebufferFormat::RGBA16F ? "RGBA16F" : "RGBA8  ", resource.FirstUse, resource.LastUse);
+        }
+        printf("  transient: %u targets on %u framebuffers, %.2f MB (%.2f MB unaliased, peak %.2f MB, pool %.2f MB)\n",
+               stats.TransientTargets, stats.PhysicalTargets, stats.TransientBytes * mb, stats.UnaliasedBytes * mb,
+               stats.PeakTransientBytes * mb, stats.PoolBytes * mb);
+    }
+
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Platform/OpenGL/OpenGLFramebuffer.h"
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+namespace Marle {
+
+    typedef uint32_t RenderGraphResource;
+
+    // Frame-level graph of render passes.
+    //
+    // Each frame passes are added with a setup callback that declares the render targets the pass
+    // creates, reads and writes, and an execute callback that issues the draws. Execute() then
+    // culls passes whose outputs nothing consumes (only the backbuffer and side-effect passes
+    // are kept for their own sake), orders the rest so every target is fully written before it
+    // is read, and backs transient targets with framebuffers from a pool: targets of the same
+    // size and format whose lifetimes do not overlap share one framebuffer. Pool entries unused
+    // for a while are released. Render thread only.
+    class RenderGraph {
+    public:
+        static const RenderGraphResource InvalidResource = ~0u;
+
+        struct TargetDesc {
+            uint32_t Width = 0;         // 0 = backbuffer size times Scale
+            uint32_t Height = 0;
+            float Scale = 1.0f;
+            FramebufferFormat Format = FramebufferFormat::RGBA8;
+            bool Depth = false;
+            glm::vec4 ClearColor = glm::vec4(0.0f);
+        };
+
+        class PassBuilder {
+        public:
+            // Transient target; contents are undefined until this frame writes them
+            RenderGraphResource Create(const char* name, const TargetDesc& desc);
+            void Read(RenderGraphResource resource);
+            // A pass renders to at most one target; clear applies the target's clear colour first
+            RenderGraphResource Write(RenderGraphResource resource, bool clear = false);
+            // Keeps the pass even when nothing reads what it writes (readbacks, captures)
+            void SetSideEffect();
+
+        private:
+            friend class RenderGraph;
+            PassBuilder(uint32_t pass) : m_Pass(pass) {}
+            uint32_t m_Pass;
+        };
+
+        class PassContext {
+        public:
+            // Colour texture of a target the pass reads
+            GLuint GetTexture(RenderGraphResource resource) const;
+            glm::uvec2 GetSize(RenderGraphResource resource) const;
+
+        private:
+            friend class RenderGraph;
+            PassContext() {}
+        };
+
+        typedef std::function<void(PassBuilder&)> SetupFunc;
+        typedef std::function<void(PassContext&)> ExecuteFunc;
+
+        static void Init();
+        static void Shutdown();
+        static bool IsInitialized();
+
+        // Called by Application::Run before OnRender; the currently bound draw framebuffer
+        // becomes this frame's backbuffer
+        static void BeginFrame(uint32_t width, uint32_t height);
+        static RenderGraphResource GetBackbuffer();
+
+        // Names must outlive the frame (string literals)
+        static void AddPass(const char* name, const SetupFunc& setup, const ExecuteFunc& execute);
+
+        // Compiles and runs the passes added this frame, then leaves the backbuffer bound.
+        // Called by Application::Run after OnRender.
+        static void Execute();
+
+        struct Stats {
+            uint32_t Passes = 0;
+            uint32_t CulledPasses = 0;
+            uint32_t TransientTargets = 0;      // Declared by live passes
+            uint32_t PhysicalTargets = 0;       // Framebuffers backing them this frame
+            size_t TransientBytes = 0;          // Memory of those framebuffers
+            size_t UnaliasedBytes = 0;          // What one framebuffer per target would have cost
+            size_t PeakTransientBytes = 0;      // Highest TransientBytes since Init
+            size_t PoolBytes = 0;               // Everything the pool holds, idle entries included
+        };
+        static const Stats& GetStats();
+        // Last executed frame: pass order, culled passes and which framebuffer backed each target
+        static void PrintStats();
+
+    private:
+        static bool Compile();
+
+        struct RenderGraphData;
+        static std::unique_ptr<RenderGraphData> s_Data;
+    };
+
+}
@@ -0,0 +1,394 @@
+#include "mrlpch.h"
+#include "RenderProfiler.h"
+#include "../Core/Metrics.h"
+
+#include <glad/gl.h>
+#include <chrono>
+#include <cstdio>
+
+namespace Marle {
+
+    struct QueryPass {
+        const char* Name;
+        uint32_t Depth;
+        uint32_t BeginQuery;
+        uint32_t EndQuery;
+    };
+
+    // Everything recorded for one frame until its queries come back
+    struct FrameSlot {
+        std::vector<GLuint> Queries;    // Pool; grows to the most queries a frame has used
+        uint32_t QueriesUsed = 0;
+        uint32_t FrameBeginQuery = 0;
+        uint32_t FrameEndQuery = 0;
+        std::vector<QueryPass> Passes;
+        RenderProfiler::FrameRecord Record;
+        bool Pending = false;
+    };
+
+    enum class LogFormat : uint8_t {
+        CSV = 0,
+        JSON
+    };
+
+    struct RenderProfiler::RenderProfilerData {
+        FrameSlot Slots[FramesInFlight];
+        uint64_t Frame = 0;
+        bool InFrame = false;
+        bool GpuTimers = false;
+        std::chrono::steady_clock::time_point FrameStart;
+        std::vector<uint32_t> OpenPasses;  // Indices into the current slot's Passes
+        FrameStats Counters;
+        FrameRecord LastFrame;
+        uint64_t DroppedFrames = 0;
+
+        FILE* LogFile = nullptr;
+        LogFormat Format = LogFormat::CSV;
+        bool FirstLogEntry = true;
+
+        // Exported through Metrics; InvalidMetric when it is not initialized
+        MetricId CpuMsMetric = Metrics::InvalidMetric;
+        MetricId GpuMsMetric = Metrics::InvalidMetric;
+        MetricId DrawCallsMetric = Metrics::InvalidMetric;
+        MetricId TrianglesMetric = Metrics::InvalidMetric;
+        MetricId StateChangesMetric = Metrics::InvalidMetric;
+        MetricId UploadBytesMetric = Metrics::InvalidMetric;
+        MetricId DroppedFramesMetric = Metrics::InvalidMetric;
+    };
+
+    std::unique_ptr<RenderProfiler::RenderProfilerData> RenderProfiler::s_Data = nullptr;
+
+    static uint32_t TakeTimestamp(FrameSlot& slot)
+    {
+        if (slot.QueriesUsed == slot.Queries.size()) {
+            GLuint query = 0;
+            glGenQueries(1, &query);
+            slot.Queries.push_back(query);
+        }
+        uint32_t index = slot.QueriesUsed++;
+        glQueryCounter(slot.Queries[index], GL_TIMESTAMP);
+        return index;
+    }
+
+    static double ElapsedMs(const std::vector<GLuint64>& times, uint32_t begin, uint32_t end)
+    {
+        return times[end] > times[begin] ? (double)(times[end] - times[begin]) / 1e6 : 0.0;
+    }
+
+    void RenderProfiler::Init()
+    {
+        s_Data = std::make_unique<RenderProfilerData>();
+        s_Data->GpuTimers = (GLAD_GL_VERSION_3_3 || GLAD_GL_ARB_timer_query) && glad_glQueryCounter != nullptr;
+
+        static const double frameMsBounds[] = { 1.0, 2.0, 4.0, 8.0, 12.0, 16.7, 20.0, 25.0, 33.3, 50.0, 100.0 };
+        const uint32_t boundCount = sizeof(frameMsBounds) / sizeof(frameMsBounds[0]);
+        s_Data->CpuMsMetric = Metrics::RegisterHistogram("marle_render_cpu_ms", "CPU time from frame start to the end of command submission",
+                                                         frameMsBounds, boundCount);
+        s_Data->GpuMsMetric = Metrics::RegisterHistogram("marle_render_gpu_ms", "GPU time of the top-level passes", frameMsBounds, boundCount);
+        s_Data->DrawCallsMetric = Metrics::RegisterCounter("marle_render_draw_calls_total", "Draw calls submitted");
+        s_Data->TrianglesMetric = Metrics::RegisterCounter("marle_render_triangles_total", "Triangles drawn");
+        s_Data->StateChangesMetric = Metrics::RegisterCounter("marle_render_state_changes_total", "Program, texture, vertex array and blend changes");
+        s_Data->UploadBytesMetric = Metrics::RegisterCounter("marle_render_upload_bytes_total", "Texture and buffer bytes uploaded");
+        s_Data->DroppedFramesMetric = Metrics::RegisterCounter("marle_render_dropped_timings_total", "Frames whose GPU timings were dropped");
+        printf("RenderProfiler initialized (%s)\n", s_Data->GpuTimers ? "GPU timer queries" : "no timer queries, CPU only");
+    }
+
+    void RenderProfiler::Shutdown()
+    {
+        if (!s_Data) {
+            return;
+        }
+        StopLog();
+        for (FrameSlot& slot : s_Data->Slots) {
+            if (!slot.Queries.empty()) {
+                glDeleteQueries((GLsizei)slot.Queries.size(), slot.Queries.data());
+            }
+        }
+        s_Data.reset();
+    }
+
+    bool RenderProfiler::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    void RenderProfiler::BeginFrame()
+    {
+        if (!s_Data) {
+            return;
+        }
+        RenderProfilerData& data = *s_Data;
+
+        ResolveFrames(false);
+
+        FrameSlot& slot = data.Slots[data.Frame % FramesInFlight];
+        if (slot.Pending) {
+            // The GPU is more than FramesInFlight frames behind; drop rather than wait
+            slot.Pending = false;
+            data.DroppedFrames++;
+            Metrics::Increment(data.DroppedFramesMetric);
+        }
+
+        slot.QueriesUsed = 0;
+        slot.Passes.clear();
+        slot.Record = FrameRecord();
+        slot.Record.Frame = data.Frame;
+        data.OpenPasses.clear();
+        data.Counters = FrameStats();
+        data.FrameStart = std::chrono::steady_clock::now();
+        data.InFrame = true;
+
+        if (data.GpuTimers) {
+            slot.FrameBeginQuery = TakeTimestamp(slot);
+        }
+    }
+
+    void RenderProfiler::EndFrame()
+    {
+        if (!s_Data || !s_Data->InFrame) {
+            return;
+        }
+        RenderProfilerData& data = *s_Data;
+        FrameSlot& slot = data.Slots[data.Frame % FramesInFlight];
+
+        while (!data.OpenPasses.empty()) {
+            printf("Warning: RenderProfiler pass '%s' was not ended\n", slot.Passes[data.OpenPasses.back()].Name);
+            EndPass();
+        }
+
+        slot.Record.CpuMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - data.FrameStart).count();
+        slot.Record.Stats = data.Counters;
+        data.InFrame = false;
+        data.Frame++;
+
+        Metrics::Observe(data.CpuMsMetric, slot.Record.CpuMs);
+        Metrics::Increment(data.DrawCallsMetric, data.Counters.DrawCalls);
+        Metrics::Increment(data.TrianglesMetric, data.Counters.Triangles);
+        Metrics::Increment(data.StateChangesMetric, data.Counters.StateChanges);
+        Metrics::Increment(data.UploadBytesMetric, data.Counters.TextureUploadBytes + data.Counters.BufferUploadBytes);
+
+        if (data.GpuTimers) {
+            slot.FrameEndQuery = TakeTimestamp(slot);
+            slot.Pending = true;
+        } else {
+            data.LastFrame = slot.Record;
+            WriteLogEntry(data.LastFrame);
+        }
+    }
+
+    void RenderProfiler::BeginPass(const char* name)
+    {
+        if (!s_Data || !s_Data->InFrame) {
+            return;
+        }
+        RenderProfilerData& data = *s_Data;
+        FrameSlot& slot = data.Slots[data.Frame % FramesInFlight];
+
+        QueryPass pass;
+        pass.Name = name;
+        pass.Depth = (uint32_t)data.OpenPasses.size();
+        pass.BeginQuery = data.GpuTimers ? TakeTimestamp(slot) : 0;
+        pass.EndQuery = pass.BeginQuery;
+        data.OpenPasses.push_back((uint32_t)slot.Passes.size());
+        slot.Passes.push_back(pass);
+    }
+
+    void RenderProfiler::EndPass()
+    {
+        if (!s_Data || !s_Data->InFrame || s_Data->OpenPasses.empty()) {
+            return;
+        }
+        RenderProfilerData& data = *s_Data;
+        FrameSlot& slot = data.Slots[data.Frame % FramesInFlight];
+
+        QueryPass& pass = slot.Passes[data.OpenPasses.back()];
+        data.OpenPasses.pop_back();
+        if (data.GpuTimers) {
+            pass.EndQuery = TakeTimestamp(slot);
+        }
+    }
+
+    void RenderProfiler::ResolveFrames(bool wait)
+    {
+        RenderProfilerData& data = *s_Data;
+        std::vector<GLuint64> times;
+
+        // Oldest first, so records are published (and logged) in frame order
+        for (uint64_t age = FramesInFlight; age > 0; age--) {
+            if (data.Frame < age) {
+                continue;
+            }
+            FrameSlot& slot = data.Slots[(data.Frame - age) % FramesInFlight];
+            if (!slot.Pending) {
+                continue;
+            }
+
+            // Timestamps complete in order, so the frame's last query answers for all of them
+            if (!wait) {
+                GLint available = 0;
+                glGetQueryObjectiv(slot.Queries[slot.FrameEndQuery], GL_QUERY_RESULT_AVAILABLE, &available);
+                if (!available) {
+                    break;
+                }
+            }
+
+            times.resize(slot.QueriesUsed);
+            for (uint32_t i = 0; i < slot.QueriesUsed; i++) {
+                glGetQueryObjectui64v(slot.Queries[i], GL_QUERY_RESULT, &times[i]);
+            }
+
+            FrameRecord& record = slot.Record;
+            record.GpuMs = ElapsedMs(times, slot.FrameBeginQuery, slot.FrameEndQuery);
+            record.GpuPassMs = 0.0;
+            record.Passes.clear();
+            for (const QueryPass& pass : slot.Passes) {
+                PassTiming timing;
+                timing.Name = pass.Name;
+                timing.Depth = pass.Depth;
+                timing.GpuMs = ElapsedMs(times, pass.BeginQuery, pass.EndQuery);
+                if (pass.Depth == 0) {
+                    record.GpuPassMs += timing.GpuMs;
+                }
+                record.Passes.push_back(timing);
+            }
+            // The frame span also counts GPU idle time waiting for commands, so the pass sum decides
+            record.GpuBound = record.GpuPassMs > record.CpuMs;
+
+            slot.Pending = false;
+            data.LastFrame = record;
+            WriteLogEntry(record);
+            Metrics::Observe(data.GpuMsMetric, record.GpuPassMs);
+        }
+    }
+
+    void RenderProfiler::CountDraw(uint64_t triangles)
+    {
+        if (s_Data) {
+            s_Data->Counters.DrawCalls++;
+            s_Data->Counters.Triangles += triangles;
+        }
+    }
+
+    void RenderProfiler::CountStateChange()
+    {
+        if (s_Data) {
+            s_Data->Counters.StateChanges++;
+        }
+    }
+
+    void RenderProfiler::CountTextureUpload(size_t bytes)
+    {
+        if (s_Data) {
+            s_Data->Counters.TextureUploads++;
+            s_Data->Counters.TextureUploadBytes += bytes;
+        }
+    }
+
+    void RenderProfiler::CountBufferUpload(size_t bytes)
+    {
+        if (s_Data) {
+            s_Data->Counters.BufferUploadBytes += bytes;
+        }
+    }
+
+    const RenderProfiler::FrameRecord& RenderProfiler::GetLastFrame()
+    {
+        static const FrameRecord s_Empty;
+        return s_Data ? s_Data->LastFrame : s_Empty;
+    }
+
+    bool RenderProfiler::HasGpuTimers()
+    {
+        return s_Data && s_Data->GpuTimers;
+    }
+
+    uint64_t RenderProfiler::GetDroppedFrames()
+    {
+        return s_Data ? s_Data->DroppedFrames : 0;
+    }
+
+    bool RenderProfiler::StartLog(const std::string& path)
+    {
+        if (!s_Data) {
+            return false;
+        }
+        StopLog();
+
+        RenderProfilerData& data = *s_Data;
+        data.LogFile = fopen(path.c_str(), "w");
+        if (!data.LogFile) {
+            printf("Error: could not open frame log %s\n", path.c_str());
+            return false;
+        }
+        data.Format = path.size() > 5 && path.compare(path.size() - 5, 5, ".json") == 0 ? LogFormat::JSON : LogFormat::CSV;
+        data.FirstLogEntry = true;
+
+        if (data.Format == LogFormat::JSON) {
+            fprintf(data.LogFile, "[\n");
+        } else {
+            fprintf(data.LogFile, "frame,cpu_ms,gpu_ms,gpu_pass_ms,bound,draw_calls,triangles,state_changes,"
+                                  "texture_uploads,texture_upload_bytes,buffer_upload_bytes,passes\n");
+        }
+        printf("Frame log started: %s\n", path.c_str());
+        return true;
+    }
+
+    void RenderProfiler::StopLog()
+    {
+        if (!s_Data || !s_Data->LogFile) {
+            return;
+        }
+        RenderProfilerData& data = *s_Data;
+
+        // Frames still in flight are read back with a wait; a stall here is fine
+        ResolveFrames(true);
+
+        if (data.Format == LogFormat::JSON) {
+            fprintf(data.LogFile, "\n]\n");
+        }
+        fclose(data.LogFile);
+        data.LogFile = nullptr;
+        printf("Frame log stopped\n");
+    }
+
+    bool RenderProfiler::IsLogging()
+    {
+        return s_Data && s_Data->LogFile;
+    }
+
+    void RenderProfiler::WriteLogEntry(const FrameRecord& record)
+    {
+        RenderProfilerData& data = *s_Data;
+        if (!data.LogFile) {
+            return;
+        }
+        FILE* file = data.LogFile;
+        const FrameStats& stats = record.Stats;
+        const char* bound = record.GpuMs < 0.0 ? "unknown" : (record.GpuBound ? "gpu" : "cpu");
+
+        if (data.Format == LogFormat::CSV) {
+            fprintf(file, "%llu,%.3f,%.3f,%.3f,%s,%u,%llu,%u,%u,%zu,%zu,", (unsigned long long)record.Frame, record.CpuMs,
+                    record.GpuMs, record.GpuPassMs, bound, stats.DrawCalls, (unsigned long long)stats.Triangles,
+                    stats.StateChanges, stats.TextureUploads, stats.TextureUploadBytes, stats.BufferUploadBytes);
+            for (size_t i = 0; i < record.Passes.size(); i++) {
+                fprintf(file, "%s%s=%.3f", i ? ";" : "", record.Passes[i].Name, record.Passes[i].GpuMs);
+            }
+            fprintf(file, "\n");
+            return;
+        }
+
+        fprintf(file, "%s  {\"frame\": %llu, \"cpu_ms\": %.3f, \"gpu_ms\": %.3f, \"gpu_pass_ms\": %.3f, \"bound\": \"%s\", "
+                      "\"draw_calls\": %u, \"triangles\": %llu, \"state_changes\": %u, \"texture_uploads\": %u, "
+                      "\"texture_upload_bytes\": %zu, \"buffer_upload_bytes\": %zu, \"passes\": [",
+                data.FirstLogEntry ? "" : ",\n", (unsigned long long)record.Frame, record.CpuMs, record.GpuMs,
+                record.GpuPassMs, bound, stats.DrawCalls, (unsigned long long)stats.Triangles, stats.StateChanges,
+                stats.TextureUploads, stats.TextureUploadBytes, stats.BufferUploadBytes);
+        for (size_t i = 0; i < record.Passes.size(); i++) {
+            fprintf(file, "%s{\"name\": \"%s\", \"depth\": %u, \"gpu_ms\": %.3f}", i ? ", " : "",
+                    record.Passes[i].Name, record.Passes[i].Depth, record.Passes[i].GpuMs);
+        }
+        fprintf(file, "]}");
+        data.FirstLogEntry = false;
+    }
+
+}
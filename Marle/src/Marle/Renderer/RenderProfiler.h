@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // GPU pass timings and render statistics per frame.
+    //
+    // Passes are bracketed with GL_TIMESTAMP queries taken from a ring spanning FramesInFlight
+    // frames. A frame's results are read back only once the driver reports them available,
+    // normally FramesInFlight - 1 frames later, so profiling never makes the CPU wait on the
+    // GPU; a frame whose queries are still pending when its ring slot comes around again is
+    // dropped. Counters (draw calls, state changes, uploads) are gathered on the CPU and
+    // published together with the GPU times of the same frame. Render thread only.
+    class RenderProfiler {
+    public:
+        static const uint32_t FramesInFlight = 4;
+
+        static void Init();
+        static void Shutdown();
+        static bool IsInitialized();
+
+        // Called by Application::Run around each frame (before the swap)
+        static void BeginFrame();
+        static void EndFrame();
+
+        // Passes nest; each one gets its own GPU time
+        static void BeginPass(const char* name);
+        static void EndPass();
+
+        class ScopedPass {
+        public:
+            ScopedPass(const char* name) { BeginPass(name); }
+            ~ScopedPass() { EndPass(); }
+        };
+
+        // Statistics hooks used by the renderer; no-ops when the profiler is not initialized
+        static void CountDraw(uint64_t triangles);
+        static void CountStateChange();
+        static void CountTextureUpload(size_t bytes);
+        static void CountBufferUpload(size_t bytes);
+
+        struct FrameStats {
+            uint32_t DrawCalls = 0;
+            uint64_t Triangles = 0;
+            uint32_t StateChanges = 0;      // Program, texture, vertex array and blend changes
+            uint32_t TextureUploads = 0;
+            size_t TextureUploadBytes = 0;
+            size_t BufferUploadBytes = 0;
+        };
+
+        struct PassTiming {
+            const char* Name = nullptr;
+            uint32_t Depth = 0;
+            double GpuMs = 0.0;
+        };
+
+        struct FrameRecord {
+            uint64_t Frame = 0;
+            double CpuMs = 0.0;             // Frame start to the end of command submission
+            double GpuMs = -1.0;            // First to last GPU timestamp of the frame; -1 without timer queries
+            double GpuPassMs = 0.0;         // Sum of top-level passes: GPU time spent on our work
+            bool GpuBound = false;
+            FrameStats Stats;
+            std::vector<PassTiming> Passes;
+        };
+
+        // Most recent frame whose GPU results have been read back
+        static const FrameRecord& GetLastFrame();
+        static bool HasGpuTimers();
+        static uint64_t GetDroppedFrames();
+
+        // One line per resolved frame; ".json" paths get a JSON array, anything else CSV
+        static bool StartLog(const std::string& path);
+        static void StopLog();
+        static bool IsLogging();
+
+    private:
+        static void ResolveFrames(bool wait);
+        static void WriteLogEntry(const FrameRecord& record);
+
+        struct RenderProfilerData;
+        static std::unique_ptr<RenderProfilerData> s_Data;
+    };
+
+}
@@ -1,80 +1,103 @@
 #include "mrlpch.h"
 #include "Renderer2D.h"
+#include "ParticleSystem.h"
+#include "Tilemap.h"
+#include "Font.h"
+#include "RenderProfiler.h"
+#include "TextureStreamer.h"
+#include "../Animation/AnimationSystem.h"
 #include "../Application.h"
+#include "../Platform/OpenGL/OpenGLRendererBackend.h"
+#include "../Platform/OpenGL/OpenGLVertexLayout.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace Marle {
 
     std::unique_ptr<Renderer2D::RendererData> Renderer2D::s_Data = nullptr;
 
-    void Renderer2D::Init()
+    void Renderer2D::Init(std::unique_ptr<RendererBackend> backend)
     {
         printf("Initializing Renderer2D...\n");
         
         s_Data = std::make_unique<RendererData>();
+        TextureStreamer::Init();
 
-        // Create and load shader
-        s_Data->TextureShader = std::make_unique<OpenGLShader>(
-            "Assets/Shaders/Texture.vert", 
-            "Assets/Shaders/Texture.frag"
-        );
-
-        // Define quad vertices (unit quad: -0.5 to 0.5)
-        float vertices[] = {
-            // Positions        // TexCoords
-            -0.5f, -0.5f, 0.0f,  0.0f, 0.0f, // Bottom-left
-             0.5f, -0.5f, 0.0f,  1.0f, 0.0f, // Bottom-right
-             0.5f,  0.5f, 0.0f,  1.0f, 1.0f, // Top-right
-            -0.5f,  0.5f, 0.0f,  0.0f, 1.0f  // Top-left
-        };
-
-        unsigned int indices[] = {
-            0, 1, 2, // First triangle
-            2, 3, 0  // Second triangle
-        };
-
-        // Generate and bind VAO
-        glGenVertexArrays(1, &s_Data->QuadVAO);
-        glBindVertexArray(s_Data->QuadVAO);
-
-        // Generate and bind VBO
-        glGenBuffers(1, &s_Data->QuadVBO);
-        glBindBuffer(GL_ARRAY_BUFFER, s_Data->QuadVBO);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
-
-        // Generate and bind EBO
-        glGenBuffers(1, &s_Data->QuadEBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_Data->QuadEBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
-
-        // Position attribute (location = 0)
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
-        glEnableVertexAttribArray(0);
-
-        // TexCoord attribute (location = 1)
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
-        glEnableVertexAttribArray(1);
-
-        // Unbind VAO
+        if (!backend) {
+            backend = std::make_unique<OpenGLRendererBackend>();
+        }
+        s_Data->Backend = std::move(backend);
+        if (s_Data->Backend->GetType() != RendererBackendType::OpenGL) {
+            printf("Renderer2D initialized (%s backend; particles, tilemaps, text and skinned meshes need OpenGL)\n",
+                   s_Data->Backend->GetName());
+            return;
+        }
+        s_Data->GL = static_cast<OpenGLRendererBackend*>(s_Data->Backend.get());
+
+        // Shaders are shared through the resource cache (path stem loads .vert + .frag)
+        s_Data->ParticleShader = ResourceManager::Load<OpenGLShader>("Assets/Shaders/Particle");
+        s_Data->TilemapShader = ResourceManager::Load<OpenGLShader>("Assets/Shaders/Tilemap");
+        s_Data->TextShader = ResourceManager::Load<OpenGLShader>("Assets/Shaders/Text");
+
+        // Index list for a full tilemap chunk, shared by every chunk VAO
+        const uint32_t tileQuads = Tilemap::ChunkSize * Tilemap::ChunkSize;
+        std::vector<uint16_t> tileIndices(tileQuads * 6);
+        for (uint32_t quad = 0; quad < tileQuads; quad++) {
+            uint16_t base = (uint16_t)(quad * 4);
+            uint16_t* out = &tileIndices[quad * 6];
+            out[0] = base + 0; out[1] = base + 1; out[2] = base + 2;
+            out[3] = base + 2; out[4] = base + 3; out[5] = base + 0;
+        }
+        glGenBuffers(1, &s_Data->TileEBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_Data->TileEBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, tileIndices.size() * sizeof(uint16_t), tileIndices.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+        // Streamed text quads; the index buffer grows with the largest batch seen
+        glGenVertexArrays(1, &s_Data->TextVAO);
+        glBindVertexArray(s_Data->TextVAO);
+        glGenBuffers(1, &s_Data->TextVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, s_Data->TextVBO);
+        glGenBuffers(1, &s_Data->TextEBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_Data->TextEBO);
+        ApplyVertexLayout(VertexBufferLayout()
+            .Add(0, VertexFormat::Float2)
+            .Add(1, VertexFormat::UNorm16x2)
+            .Add(2, VertexFormat::UNorm8x4));
         glBindVertexArray(0);
 
+        s_Data->GpuBytes = tileIndices.size() * sizeof(uint16_t);
+        MemoryTracker::TrackGpu(MemoryTag::Renderer, (int64_t)s_Data->GpuBytes);
+
         printf("Renderer2D initialized successfully\n");
     }
 
     void Renderer2D::Shutdown()
     {
         if (s_Data) {
-            glDeleteVertexArrays(1, &s_Data->QuadVAO);
-            glDeleteBuffers(1, &s_Data->QuadVBO);
-            glDeleteBuffers(1, &s_Data->QuadEBO);
+            if (s_Data->GL) {
+                glDeleteBuffers(1, &s_Data->TileEBO);
+                glDeleteVertexArrays(1, &s_Data->TextVAO);
+                glDeleteBuffers(1, &s_Data->TextVBO);
+                glDeleteBuffers(1, &s_Data->TextEBO);
+                MemoryTracker::TrackGpu(MemoryTag::Renderer, -(int64_t)s_Data->GpuBytes);
+            }
             s_Data.reset();
         }
+        TextureStreamer::Shutdown();
         printf("Renderer2D shutdown complete\n");
     }
 
     void Renderer2D::BeginScene()
     {
-        if (!s_Data || !s_Data->TextureShader) {
+        BeginScene(glm::vec2(0.0f, 0.0f));
+    }
+
+    void Renderer2D::BeginScene(const glm::vec2& cameraPosition, float zoom)
+    {
+        if (!s_Data || (s_Data->GL && !s_Data->GL->IsValid())) {
             printf("Error: Renderer2D not initialized!\n");
             return;
         }
@@ -84,48 +107,463 @@ namespace Marle {
         float windowWidth = 1024.0f;
         float windowHeight = 768.0f;
 
-        s_Data->TextureShader->Bind();
+        s_Data->FrameIndex++;
+        RenderProfiler::BeginPass("Scene");
         
         // Create orthographic projection matrix (0,0 at bottom-left)
         glm::mat4 proj = glm::ortho(0.0f, windowWidth, 0.0f, windowHeight, -1.0f, 1.0f);
         
-        // View matrix (identity for now, no camera movement)
-        glm::mat4 view = glm::mat4(1.0f);
-        glm::mat4 viewProjectionMatrix = proj * view;
+        // View matrix: pan to the camera, then zoom about the bottom-left corner
+        glm::mat4 view = glm::scale(glm::mat4(1.0f), glm::vec3(zoom, zoom, 1.0f)) *
+                         glm::translate(glm::mat4(1.0f), glm::vec3(-cameraPosition, 0.0f));
+        s_Data->ViewProjection = proj * view;
+        s_Data->ViewMin = cameraPosition;
+        s_Data->ViewMax = cameraPosition + glm::vec2(windowWidth, windowHeight) / zoom;
+        s_Data->Zoom = zoom;
         
-        s_Data->TextureShader->SetUniformMat4f("u_ViewProjection", viewProjectionMatrix);
+        RenderSceneInfo scene;
+        scene.ViewProjection = s_Data->ViewProjection;
+        scene.Zoom = zoom;
+        scene.FrameIndex = s_Data->FrameIndex;
+        s_Data->Backend->BeginScene(scene);
     }
 
     void Renderer2D::EndScene()
     {
-        if (s_Data && s_Data->TextureShader) {
-            s_Data->TextureShader->Unbind();
+        FlushText();
+
+        if (s_Data && (!s_Data->GL || s_Data->GL->IsValid())) {
+            s_Data->Backend->EndScene();
+            RenderProfiler::EndPass();
+            TextureStreamer::Update(s_Data->FrameIndex);
+        }
+    }
+
+    void Renderer2D::Clear(const glm::vec4& color)
+    {
+        if (s_Data) {
+            s_Data->Backend->Clear(color);
+        }
+    }
+
+    void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture)
+    {
+        if (!s_Data || (s_Data->GL && !s_Data->GL->IsValid()) || !texture) {
+            printf("Error: Cannot draw quad - missing components\n");
+            return;
         }
+
+        s_Data->Backend->DrawQuad(position, size, texture);
     }
 
-    void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, OpenGLTexture2D* texture)
+    void Renderer2D::DrawTransformedQuad(const Affine2D& transform, const glm::vec2& size, Texture2D* texture)
     {
-        if (!s_Data || !s_Data->TextureShader || !texture) {
+        if (!s_Data || (s_Data->GL && !s_Data->GL->IsValid()) || !texture) {
             printf("Error: Cannot draw quad - missing components\n");
             return;
         }
 
-        // Bind texture
+        // Axis-aligned transforms (flips included) fit every backend
+        if (transform.B == 0.0f && transform.C == 0.0f) {
+            s_Data->Backend->DrawQuad(glm::vec2(transform.TX, transform.TY),
+                                      glm::vec2(size.x * transform.A, size.y * transform.D), texture);
+            return;
+        }
+        if (!RequireOpenGL(UnsupportedRotatedQuads, "rotated quads")) {
+            return;
+        }
+
+        glm::mat4 model(1.0f);
+        model[0] = glm::vec4(transform.A * size.x, transform.B * size.x, 0.0f, 0.0f);
+        model[1] = glm::vec4(transform.C * size.y, transform.D * size.y, 0.0f, 0.0f);
+        model[3] = glm::vec4(transform.TX, transform.TY, 0.0f, 1.0f);
+        s_Data->GL->DrawQuad(model, texture);
+    }
+
+    void Renderer2D::Blit(GLuint texture, const glm::vec2& min, const glm::vec2& max)
+    {
+        if (!s_Data || !s_Data->GL || !s_Data->GL->IsValid() || !texture) {
+            return;
+        }
+        s_Data->GL->Blit(texture, min, max);
+    }
+
+    void Renderer2D::DrawParticles(ParticleEmitter& emitter)
+    {
+        if (!RequireOpenGL(UnsupportedParticles, "particles")) {
+            return;
+        }
+        if (!s_Data->ParticleShader) {
+            printf("Error: Cannot draw particles - renderer not initialized\n");
+            return;
+        }
+        if (emitter.m_AliveCount == 0) {
+            return;
+        }
+
+        RenderProfiler::ScopedPass pass("Particles");
+        const GLsizeiptr streamBytes = (GLsizeiptr)emitter.m_Capacity * sizeof(float);
+
+        // One instance buffer per emitter holding each SoA pool back to back, so attribute
+        // offsets depend only on capacity and are configured once.
+        if (!emitter.m_InstanceVAO) {
+            glGenVertexArrays(1, &emitter.m_InstanceVAO);
+            glBindVertexArray(emitter.m_InstanceVAO);
+
+            // Corners come from the shared unit quad; its texture coordinates are left out, as
+            // location 1 onwards are the per-particle streams
+            glBindBuffer(GL_ARRAY_BUFFER, s_Data->GL->GetQuadVertexBuffer());
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, s_Data->GL->GetQuadIndexBuffer());
+            VertexBufferLayout corners;
+            corners.AddAt(0, VertexFormat::Half2, 0).SetStride(OpenGLRendererBackend::GetQuadLayout().GetStride());
+            ApplyVertexLayout(corners);
+
+            glGenBuffers(1, &emitter.m_InstanceVBO);
+            glBindBuffer(GL_ARRAY_BUFFER, emitter.m_InstanceVBO);
+            glBufferData(GL_ARRAY_BUFFER, streamBytes * 5, nullptr, GL_STREAM_DRAW);
+
+            // Position X/Y, life and inverse lifetime (locations 1-4), then colour (5), one
+            // tightly packed stream each
+            VertexBufferLayout streams;
+            for (uint32_t stream = 0; stream < 4; stream++) {
+                streams.AddAt(stream + 1, VertexFormat::Float, (uint32_t)(streamBytes * stream), 1);
+            }
+            streams.AddAt(5, VertexFormat::UNorm8x4, (uint32_t)(streamBytes * 4), 1);
+            ApplyVertexLayout(streams.SetStride(sizeof(float)));
+        } else {
+            glBindVertexArray(emitter.m_InstanceVAO);
+            glBindBuffer(GL_ARRAY_BUFFER, emitter.m_InstanceVBO);
+        }
+
+        // Orphan last frame's storage so the driver never waits on the GPU still reading it
+        const GLsizeiptr liveBytes = (GLsizeiptr)emitter.m_AliveCount * sizeof(float);
+        glBufferData(GL_ARRAY_BUFFER, streamBytes * 5, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, streamBytes * 0, liveBytes, emitter.m_PositionX.data());
+        glBufferSubData(GL_ARRAY_BUFFER, streamBytes * 1, liveBytes, emitter.m_PositionY.data());
+        glBufferSubData(GL_ARRAY_BUFFER, streamBytes * 2, liveBytes, emitter.m_Life.data());
+        glBufferSubData(GL_ARRAY_BUFFER, streamBytes * 3, liveBytes, emitter.m_InvLifetime.data());
+        glBufferSubData(GL_ARRAY_BUFFER, streamBytes * 4, liveBytes, emitter.m_Color.data());
+        RenderProfiler::CountBufferUpload((size_t)liveBytes * 5);
+
+        const ParticleEmitterProps& props = emitter.GetProps();
+        glEnable(GL_BLEND);
+        if (props.BlendMode == ParticleBlendMode::Additive) {
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+        } else {
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        }
+
+        s_Data->ParticleShader->Bind();
+        s_Data->ParticleShader->SetUniformMat4f(Uniforms::ViewProjection, s_Data->ViewProjection);
+        s_Data->ParticleShader->SetUniform2f(Uniforms::Size, glm::vec2(props.SizeBegin, props.SizeEnd));
+        s_Data->ParticleShader->SetUniform1f(Uniforms::FadeOut, props.FadeOut ? 1.0f : 0.0f);
+
+        glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr, (GLsizei)emitter.m_AliveCount);
+        RenderProfiler::CountStateChange(); // Vertex array
+        RenderProfiler::CountStateChange(); // Blend
+        RenderProfiler::CountDraw((uint64_t)emitter.m_AliveCount * 2);
+
+        // Leave the state DrawQuad expects
+        glDisable(GL_BLEND);
+        glBindVertexArray(0);
+        s_Data->GL->GetTextureShader()->Bind();
+    }
+
+    void Renderer2D::DrawSkinnedMeshes(AnimationSystem& system, OpenGLTexture2D* texture)
+    {
+        if (!RequireOpenGL(UnsupportedSkinnedMeshes, "skinned meshes")) {
+            return;
+        }
+        if (!s_Data->GL->IsValid() || !texture) {
+            printf("Error: Cannot draw skinned meshes - missing components\n");
+            return;
+        }
+
+        RenderProfiler::ScopedPass pass("Skinned");
+        if (!system.m_VAO) {
+            glGenVertexArrays(1, &system.m_VAO);
+            glBindVertexArray(system.m_VAO);
+            glGenBuffers(1, &system.m_VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, system.m_VBO);
+            glGenBuffers(1, &system.m_EBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, system.m_EBO);
+            // The texture shader's vec3 position gets z = 0 from the two-component attribute
+            ApplyVertexLayout(VertexBufferLayout()
+                .AddAt(0, VertexFormat::Float2, offsetof(SkinnedVertex, Position))
+                .AddAt(1, VertexFormat::UNorm16x2, offsetof(SkinnedVertex, TexCoord))
+                .SetStride(sizeof(SkinnedVertex)));
+        } else {
+            glBindVertexArray(system.m_VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, system.m_VBO);
+        }
+
+        // Vertices change every frame (orphaned); indices only when instances come or go
+        const size_t vertexBytes = system.m_Vertices.size() * sizeof(SkinnedVertex);
+        const size_t indexBytes = system.m_Indices.size() * sizeof(uint32_t);
+        glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexBytes, nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, (GLsizeiptr)vertexBytes, system.m_Vertices.data());
+        RenderProfiler::CountBufferUpload(vertexBytes);
+        if (!system.m_IndicesUploaded) {
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indexBytes, system.m_Indices.data(), GL_STATIC_DRAW);
+            RenderProfiler::CountBufferUpload(indexBytes);
+            system.m_IndicesUploaded = true;
+        }
+        MemoryTracker::TrackGpu(MemoryTag::Animation, (int64_t)(vertexBytes + indexBytes) - (int64_t)system.m_GpuBytes);
+        system.m_GpuBytes = vertexBytes + indexBytes;
+
+        texture->RequestScreenSize((float)texture->GetWidth(), (float)texture->GetHeight(), s_Data->FrameIndex);
         texture->Bind(0);
-        
-        // Set texture uniform
-        s_Data->TextureShader->SetUniform1i("u_Texture", 0);
+        OpenGLShader* textureShader = s_Data->GL->GetTextureShader();
+        textureShader->Bind();
+        textureShader->SetUniform1i(Uniforms::Texture, 0);
+        textureShader->SetUniformMat4f(Uniforms::Transform, glm::mat4(1.0f)); // Skinned positions are already in world space
 
-        // Create transform matrix
-        glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f)) *
-                              glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f));
-        
-        s_Data->TextureShader->SetUniformMat4f("u_Transform", transform);
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDrawElements(GL_TRIANGLES, (GLsizei)system.m_Indices.size(), GL_UNSIGNED_INT, nullptr);
+        RenderProfiler::CountStateChange(); // Vertex array
+        RenderProfiler::CountStateChange(); // Blend
+        RenderProfiler::CountDraw(system.m_Indices.size() / 3);
+
+        // Leave the state DrawQuad expects
+        glDisable(GL_BLEND);
+        glBindVertexArray(0);
+    }
+
+    void Renderer2D::DrawTilemap(Tilemap& tilemap)
+    {
+        if (!RequireOpenGL(UnsupportedTilemaps, "tilemaps")) {
+            return;
+        }
+        if (!s_Data->TilemapShader) {
+            printf("Error: Cannot draw tilemap - renderer not initialized\n");
+            return;
+        }
+
+        Tilemap::Stats& stats = tilemap.m_Stats;
+        stats.VisibleChunks = 0;
+        stats.DrawCalls = 0;
+        stats.RebuiltChunks = 0;
+        tilemap.m_Frame++;
+
+        // Chunk range overlapping the view; everything outside it is never looked at
+        const float chunkExtent = (float)Tilemap::ChunkSize * tilemap.m_TileSize;
+        int32_t firstX = std::max((int32_t)std::floor(s_Data->ViewMin.x / chunkExtent), 0);
+        int32_t firstY = std::max((int32_t)std::floor(s_Data->ViewMin.y / chunkExtent), 0);
+        int32_t lastX = std::min((int32_t)std::floor(s_Data->ViewMax.x / chunkExtent), (int32_t)tilemap.m_ChunksX - 1);
+        int32_t lastY = std::min((int32_t)std::floor(s_Data->ViewMax.y / chunkExtent), (int32_t)tilemap.m_ChunksY - 1);
+
+        if (firstX <= lastX && firstY <= lastY) {
+            RenderProfiler::ScopedPass pass("Tilemap");
+            glEnable(GL_BLEND);
+            RenderProfiler::CountStateChange();
+            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+            s_Data->TilemapShader->Bind();
+            s_Data->TilemapShader->SetUniformMat4f(Uniforms::ViewProjection, s_Data->ViewProjection);
+            s_Data->TilemapShader->SetUniform1f(Uniforms::Time, tilemap.m_Time);
+            s_Data->TilemapShader->SetUniform2f(Uniforms::TileUVSize,
+                glm::vec2(1.0f / (float)tilemap.m_AtlasColumns, 1.0f / (float)tilemap.m_AtlasRows));
+            s_Data->TilemapShader->SetUniform1i(Uniforms::Texture, 0);
+            if (tilemap.m_Atlas) {
+                // The whole atlas spans columns x rows tiles on screen
+                float tilePixels = tilemap.m_TileSize * s_Data->Zoom;
+                tilemap.m_Atlas->RequestScreenSize(tilePixels * tilemap.m_AtlasColumns, tilePixels * tilemap.m_AtlasRows, s_Data->FrameIndex);
+                tilemap.m_Atlas->Bind(0);
+            }
+
+            for (Tilemap::Layer& layer : tilemap.m_Layers) {
+                for (int32_t cy = firstY; cy <= lastY; cy++) {
+                    for (int32_t cx = firstX; cx <= lastX; cx++) {
+                        Tilemap::Chunk& chunk = layer.Chunks[cy * tilemap.m_ChunksX + cx];
+                        stats.VisibleChunks++;
+
+                        if (chunk.Dirty) {
+                            tilemap.BuildChunk(layer, (uint32_t)cx, (uint32_t)cy, s_Data->TileEBO);
+                        }
+                        if (chunk.QuadCount == 0) {
+                            continue;
+                        }
+
+                        chunk.LastDrawnFrame = tilemap.m_Frame;
+                        glBindVertexArray(chunk.VAO);
+                        glDrawElements(GL_TRIANGLES, (GLsizei)(chunk.QuadCount * 6), GL_UNSIGNED_SHORT, nullptr);
+                        stats.DrawCalls++;
+                        RenderProfiler::CountStateChange();
+                        RenderProfiler::CountDraw((uint64_t)chunk.QuadCount * 2);
+                    }
+                }
+            }
+
+            // Leave the state DrawQuad expects
+            glDisable(GL_BLEND);
+            glBindVertexArray(0);
+            s_Data->GL->GetTextureShader()->Bind();
+        }
+
+        tilemap.EvictChunks(tilemap.m_Frame);
+    }
+
+    void Renderer2D::DrawText(Font& font, const std::string& text, const glm::vec2& position,
+                              float size, const glm::vec4& color)
+    {
+        if (!RequireOpenGL(UnsupportedText, "text")) {
+            return;
+        }
+        if (!s_Data->TextShader) {
+            printf("Error: Cannot draw text - renderer not initialized\n");
+            return;
+        }
+        if (!font.IsLoaded() || text.empty()) {
+            return;
+        }
+
+        // Layout is cached per string, so only the scale/translate below runs for unchanged text
+        Font::TextRun& run = font.GetRun(text, s_Data->FrameIndex);
+        font.ResolveRun(run, s_Data->FrameIndex);
+
+        uint32_t packedColor = PackUNorm8x4(color);
+
+        TextBatch* batch = nullptr;
+        for (size_t i = 0; i < run.Glyphs.size(); i++) {
+            uint32_t slot = run.Slots[i];
+            if (slot == Font::InvalidSlot) {
+                continue;
+            }
+            const Font::GlyphSlot& entry = font.m_Slots[slot];
+            GLuint texture = font.m_Pages[entry.Page];
+
+            if (!batch || batch->Texture != texture) {
+                batch = nullptr;
+                for (TextBatch& candidate : s_Data->TextBatches) {
+                    if (candidate.Texture == texture) {
+                        batch = &candidate;
+                        break;
+                    }
+                }
+                if (!batch) {
+                    s_Data->TextBatches.push_back({ texture, {} });
+                    batch = &s_Data->TextBatches.back();
+                }
+            }
 
-        // Draw quad
-        glBindVertexArray(s_Data->QuadVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, nullptr);
+            const Font::GlyphQuad& quad = run.Glyphs[i];
+            float x0 = position.x + quad.X0 * size, x1 = position.x + quad.X1 * size;
+            float y0 = position.y + quad.Y0 * size, y1 = position.y + quad.Y1 * size;
+            batch->Vertices.push_back({ { x0, y0 }, entry.TexCoords[0], packedColor });
+            batch->Vertices.push_back({ { x1, y0 }, entry.TexCoords[1], packedColor });
+            batch->Vertices.push_back({ { x1, y1 }, entry.TexCoords[2], packedColor });
+            batch->Vertices.push_back({ { x0, y1 }, entry.TexCoords[3], packedColor });
+        }
+    }
+
+    void Renderer2D::FlushText()
+    {
+        if (!s_Data || s_Data->TextBatches.empty()) {
+            return;
+        }
+        bool anyText = false;
+        for (const TextBatch& batch : s_Data->TextBatches) {
+            anyText |= !batch.Vertices.empty();
+        }
+        if (!anyText) {
+            s_Data->TextBatches.clear();
+            return;
+        }
+        RenderProfiler::ScopedPass pass("Text");
+
+        glBindVertexArray(s_Data->TextVAO);
+        glBindBuffer(GL_ARRAY_BUFFER, s_Data->TextVBO);
+
+        // Grow the shared index list to cover the largest batch
+        uint32_t maxQuads = 0;
+        for (const TextBatch& batch : s_Data->TextBatches) {
+            maxQuads = std::max(maxQuads, (uint32_t)(batch.Vertices.size() / 4));
+        }
+        if (maxQuads > s_Data->TextQuadCapacity) {
+            uint32_t capacity = std::max(maxQuads, s_Data->TextQuadCapacity * 2);
+            std::vector<uint32_t> indices((size_t)capacity * 6);
+            for (uint32_t quad = 0; quad < capacity; quad++) {
+                uint32_t base = quad * 4;
+                uint32_t* out = &indices[(size_t)quad * 6];
+                out[0] = base + 0; out[1] = base + 1; out[2] = base + 2;
+                out[3] = base + 2; out[4] = base + 3; out[5] = base + 0;
+            }
+            glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+            size_t grownBytes = (size_t)(capacity - s_Data->TextQuadCapacity) * 6 * sizeof(uint32_t);
+            MemoryTracker::TrackGpu(MemoryTag::Renderer, (int64_t)grownBytes);
+            RenderProfiler::CountBufferUpload(indices.size() * sizeof(uint32_t));
+            s_Data->GpuBytes += grownBytes;
+            s_Data->TextQuadCapacity = capacity;
+        }
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        s_Data->TextShader->Bind();
+        s_Data->TextShader->SetUniformMat4f(Uniforms::ViewProjection, s_Data->ViewProjection);
+        s_Data->TextShader->SetUniform1i(Uniforms::Atlas, 0);
+        glActiveTexture(GL_TEXTURE0);
+
+        // One draw per atlas page. Batches keep their storage between frames; ones that went
+        // unused (e.g. the font was destroyed) are dropped.
+        auto& batches = s_Data->TextBatches;
+        for (size_t i = 0; i < batches.size();) {
+            TextBatch& batch = batches[i];
+            if (batch.Vertices.empty()) {
+                batch = std::move(batches.back());
+                batches.pop_back();
+                continue;
+            }
+            glBindTexture(GL_TEXTURE_2D, batch.Texture);
+            glBufferData(GL_ARRAY_BUFFER, batch.Vertices.size() * sizeof(TextVertex), batch.Vertices.data(), GL_STREAM_DRAW);
+            glDrawElements(GL_TRIANGLES, (GLsizei)(batch.Vertices.size() / 4 * 6), GL_UNSIGNED_INT, nullptr);
+            RenderProfiler::CountStateChange(); // Atlas page
+            RenderProfiler::CountBufferUpload(batch.Vertices.size() * sizeof(TextVertex));
+            RenderProfiler::CountDraw(batch.Vertices.size() / 4 * 2);
+            batch.Vertices.clear();
+            i++;
+        }
+
+        glDisable(GL_BLEND);
         glBindVertexArray(0);
+        s_Data->GL->GetTextureShader()->Bind();
+    }
+
+    RendererBackend* Renderer2D::GetBackend()
+    {
+        return s_Data ? s_Data->Backend.get() : nullptr;
+    }
+
+    bool Renderer2D::RequireOpenGL(uint32_t feature, const char* name)
+    {
+        if (!s_Data) {
+            printf("Error: Cannot draw %s - renderer not initialized\n", name);
+            return false;
+        }
+        if (s_Data->GL) {
+            return true;
+        }
+        if (!(s_Data->WarnedUnsupported & feature)) {
+            printf("Warning: %s backend cannot draw %s; skipped\n", s_Data->Backend->GetName(), name);
+            s_Data->WarnedUnsupported |= feature;
+        }
+        return false;
+    }
+
+    const glm::mat4& Renderer2D::GetViewProjection()
+    {
+        static const glm::mat4 identity(1.0f);
+        return s_Data ? s_Data->ViewProjection : identity;
+    }
+
+    void Renderer2D::GetViewBounds(glm::vec2& min, glm::vec2& max)
+    {
+        if (s_Data) {
+            min = s_Data->ViewMin;
+            max = s_Data->ViewMax;
+        } else {
+            min = max = glm::vec2(0.0f);
+        }
     }
 
-} 
\ No newline at end of file
+}
\ No newline at end of file
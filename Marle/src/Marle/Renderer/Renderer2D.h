@@ -2,32 +2,111 @@
 
 #include "../Platform/OpenGL/OpenGLShader.h"
 #include "../Platform/OpenGL/OpenGLTexture.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/ResourceManager.h"
+#include "RendererBackend.h"
 #include <glm/glm.hpp>
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Marle {
+
+    class ParticleEmitter;
+    class AnimationSystem;
+    class Tilemap;
+    class Font;
+    class OpenGLRendererBackend;
+    struct Affine2D;
     
     class Renderer2D {
     public:
-        static void Init();
+        // Draws through the given backend; OpenGL when none is given
+        static void Init(std::unique_ptr<RendererBackend> backend = nullptr);
         static void Shutdown();
+        static RendererBackend* GetBackend();
+
+        // Straight RGBA; clears the whole target
+        static void Clear(const glm::vec4& color);
 
         static void BeginScene();
+        // Camera position is the world point at the bottom-left of the screen
+        static void BeginScene(const glm::vec2& cameraPosition, float zoom = 1.0f);
         static void EndScene();
 
-        static void DrawQuad(const glm::vec2& position, const glm::vec2& size, OpenGLTexture2D* texture);
+        // The texture must belong to the active backend (OpenGLTexture2D or SoftwareTexture)
+        static void DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture);
+        // Quad of the given size centred on the transform's origin, e.g. a TransformHierarchy
+        // world transform. Rotated or sheared quads need OpenGL.
+        static void DrawTransformedQuad(const Affine2D& transform, const glm::vec2& size, Texture2D* texture);
+
+        // Streams the emitter's SoA pools and draws every live particle with one instanced call
+        static void DrawParticles(ParticleEmitter& emitter);
+
+        // Streams every skinned instance of the system and draws them with one call, alpha-blended.
+        // AnimationSystem::Render skins and calls this.
+        static void DrawSkinnedMeshes(AnimationSystem& system, OpenGLTexture2D* texture);
+
+        // Draws the chunks of every layer that overlap the current view, rebuilding dirty ones first
+        static void DrawTilemap(Tilemap& tilemap);
+
+        // Queues a string with its baseline starting at position; size is the em size in pixels.
+        // Text is batched per atlas page and drawn on top of the scene in EndScene.
+        static void DrawText(Font& font, const std::string& text, const glm::vec2& position,
+                             float size, const glm::vec4& color = glm::vec4(1.0f));
+
+        // Copies a texture (e.g. a render graph target) over part of the current viewport, given in
+        // 0-1 viewport coordinates. Opaque; needs no BeginScene.
+        static void Blit(GLuint texture, const glm::vec2& min = glm::vec2(0.0f), const glm::vec2& max = glm::vec2(1.0f));
+
+        static const glm::mat4& GetViewProjection();
+        // World-space rectangle visible in the current scene
+        static void GetViewBounds(glm::vec2& min, glm::vec2& max);
 
     private:
-        struct QuadVertex {
-            glm::vec3 Position;
-            glm::vec2 TexCoord;
+        struct TextVertex {
+            glm::vec2 Position;
+            uint32_t TexCoord;  // VertexFormat::UNorm16x2
+            uint32_t Color;     // VertexFormat::UNorm8x4
+        };
+
+        struct TextBatch {
+            GLuint Texture = 0;
+            TaggedVector<TextVertex, MemoryTag::Renderer> Vertices;
         };
 
+        static void FlushText();
+
+        enum UnsupportedFeature : uint32_t {
+            UnsupportedParticles = 1 << 0,
+            UnsupportedSkinnedMeshes = 1 << 1,
+            UnsupportedTilemaps = 1 << 2,
+            UnsupportedText = 1 << 3,
+            UnsupportedRotatedQuads = 1 << 4,
+        };
+        // True on the OpenGL backend; otherwise warns once per feature
+        static bool RequireOpenGL(uint32_t feature, const char* name);
+
         struct RendererData {
-            GLuint QuadVAO = 0;
-            GLuint QuadVBO = 0;
-            GLuint QuadEBO = 0;
-            std::unique_ptr<OpenGLShader> TextureShader;
+            std::unique_ptr<RendererBackend> Backend;
+            OpenGLRendererBackend* GL = nullptr; // Backend, when it is OpenGL; GL-only paths need it
+            uint32_t WarnedUnsupported = 0;
+            ResourceHandle<OpenGLShader> ParticleShader;
+            ResourceHandle<OpenGLShader> TilemapShader;
+            GLuint TileEBO = 0; // Shared quad index list for tilemap chunks
+            glm::mat4 ViewProjection = glm::mat4(1.0f);
+            glm::vec2 ViewMin = { 0.0f, 0.0f };
+            glm::vec2 ViewMax = { 0.0f, 0.0f };
+            float Zoom = 1.0f;
+            uint64_t FrameIndex = 0;
+
+            ResourceHandle<OpenGLShader> TextShader;
+            GLuint TextVAO = 0;
+            GLuint TextVBO = 0;
+            GLuint TextEBO = 0;
+            uint32_t TextQuadCapacity = 0;
+            size_t GpuBytes = 0; // Estimate of the buffers above, reported to MemoryTracker
+            std::vector<TextBatch> TextBatches; // One per atlas page touched this scene
         };
 
         static std::unique_ptr<RendererData> s_Data;
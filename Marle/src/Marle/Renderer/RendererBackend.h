@@ -0,0 +1,50 @@
+#pragma once
+
+#include "../Core.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+
+namespace Marle {
+
+    enum class RendererBackendType : uint8_t {
+        OpenGL = 0,
+        Software
+    };
+
+    // A texture some backend can sample. Each backend draws only its own textures:
+    // OpenGLTexture2D for OpenGL, SoftwareTexture for the software rasterizer.
+    class Texture2D {
+    public:
+        virtual ~Texture2D() = default;
+
+        virtual RendererBackendType GetBackendType() const = 0;
+        virtual int GetWidth() const = 0;
+        virtual int GetHeight() const = 0;
+    };
+
+    struct RenderSceneInfo {
+        glm::mat4 ViewProjection = glm::mat4(1.0f);
+        float Zoom = 1.0f;
+        uint64_t FrameIndex = 0;
+    };
+
+    // What Renderer2D's sprite path needs from a graphics API. Renderer2D::Init takes one;
+    // without one it creates an OpenGLRendererBackend. Particles, tilemaps, text and skinned
+    // meshes are still drawn with OpenGL directly and are skipped on other backends.
+    class RendererBackend {
+    public:
+        virtual ~RendererBackend() = default;
+
+        virtual RendererBackendType GetType() const = 0;
+        virtual const char* GetName() const = 0;
+
+        // Fills the whole target; color is straight (not premultiplied) RGBA
+        virtual void Clear(const glm::vec4& color) = 0;
+        virtual void BeginScene(const RenderSceneInfo& scene) = 0;
+        // Axis-aligned quad centred on position, in world units, alpha-blended
+        virtual void DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture) = 0;
+        // Every quad of the scene is on the target once this returns
+        virtual void EndScene() = 0;
+    };
+
+}
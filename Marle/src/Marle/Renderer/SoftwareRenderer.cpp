@@ -0,0 +1,412 @@
+#include "mrlpch.h"
+#include "SoftwareRenderer.h"
+#include "TextureCompression.h"
+#include "../Core/JobSystem.h"
+#include "../Core/SIMD.h"
+#include "../Platform/OpenGL/OpenGLTexture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+namespace Marle {
+
+    static uint32_t PackPremultiplied(float r, float g, float b, float a)
+    {
+        auto channel = [](float value) { return (uint32_t)(std::min(std::max(value, 0.0f), 1.0f) * 255.0f + 0.5f); };
+        return channel(r * a) | (channel(g * a) << 8) | (channel(b * a) << 16) | (channel(a) << 24);
+    }
+
+    SoftwareTexture::SoftwareTexture(uint32_t width, uint32_t height, const uint8_t* rgba, bool bottomUp)
+        : m_Width(width), m_Height(height), m_Texels((size_t)width * height)
+    {
+        for (uint32_t y = 0; y < height; y++) {
+            const uint8_t* in = rgba + (size_t)(bottomUp ? y : height - 1 - y) * width * 4;
+            uint32_t* out = &m_Texels[(size_t)y * width];
+            for (uint32_t x = 0; x < width; x++, in += 4) {
+                uint32_t a = in[3];
+                // Premultiplied so filtering never bleeds the colour of transparent texels
+                uint32_t r = (in[0] * a + 127) / 255;
+                uint32_t g = (in[1] * a + 127) / 255;
+                uint32_t b = (in[2] * a + 127) / 255;
+                out[x] = r | (g << 8) | (b << 16) | (a << 24);
+                m_Opaque = m_Opaque && a == 255;
+            }
+        }
+    }
+
+    std::unique_ptr<SoftwareTexture> SoftwareTexture::Load(const std::string& path)
+    {
+        OpenGLTexture2D::SourceLevels source;
+        if (!OpenGLTexture2D::ReadLevels(path, 0, source) || source.Levels.empty()) {
+            printf("Failed to load texture: %s\n", path.c_str());
+            return nullptr;
+        }
+
+        const std::vector<uint8_t>& level = source.Levels[0];
+        if (source.Format == TextureFormat::RGBA8) {
+            return std::make_unique<SoftwareTexture>(source.Width, source.Height, level.data(), source.BottomUp);
+        }
+        std::vector<uint8_t> rgba;
+        DecompressImage(level.data(), source.Width, source.Height, source.Format, rgba);
+        return std::make_unique<SoftwareTexture>(source.Width, source.Height, rgba.data(), source.BottomUp);
+    }
+
+    SoftwareRasterizer::SoftwareRasterizer(uint32_t width, uint32_t height)
+    {
+        Resize(width, height);
+    }
+
+    void SoftwareRasterizer::Resize(uint32_t width, uint32_t height)
+    {
+        m_Quads.clear();
+        m_Width = width;
+        m_Height = height;
+        m_TilesX = (width + TileSize - 1) / TileSize;
+        m_TilesY = (height + TileSize - 1) / TileSize;
+        m_Pixels.assign((size_t)width * height, 0);
+        m_Bins.clear();
+    }
+
+    void SoftwareRasterizer::Clear(uint32_t color)
+    {
+        // Quads already submitted go under the clear, i.e. nowhere
+        m_Quads.clear();
+        m_ClearPending = true;
+        m_ClearColor = color;
+    }
+
+    void SoftwareRasterizer::Submit(const Quad& quad)
+    {
+        PreparedQuad prepared;
+        Quad& q = prepared.Source;
+        q = quad;
+        if (q.X1 < q.X0) {
+            std::swap(q.X0, q.X1);
+            std::swap(q.U0, q.U1);
+        }
+        if (q.Y1 < q.Y0) {
+            std::swap(q.Y0, q.Y1);
+            std::swap(q.V0, q.V1);
+        }
+
+        // Pixel centres inside [X0, X1): the top-left rule for rectangles, so quads sharing an
+        // edge never both cover a pixel
+        prepared.MinX = std::max((int32_t)std::ceil(q.X0 - 0.5f), 0);
+        prepared.MinY = std::max((int32_t)std::ceil(q.Y0 - 0.5f), 0);
+        prepared.MaxX = std::min((int32_t)std::ceil(q.X1 - 0.5f) - 1, (int32_t)m_Width - 1);
+        prepared.MaxY = std::min((int32_t)std::ceil(q.Y1 - 0.5f) - 1, (int32_t)m_Height - 1);
+        if (prepared.MinX > prepared.MaxX || prepared.MinY > prepared.MaxY) {
+            return;
+        }
+
+        float width = q.Texture ? (float)q.Texture->GetWidth() : 0.0f;
+        float height = q.Texture ? (float)q.Texture->GetHeight() : 0.0f;
+        float du = (q.U1 - q.U0) / (q.X1 - q.X0);
+        float dv = (q.V1 - q.V0) / (q.Y1 - q.Y0);
+        prepared.TexelStepX = du * width;
+        prepared.TexelStepY = dv * height;
+        prepared.TexelX = (q.U0 + ((float)prepared.MinX + 0.5f - q.X0) * du) * width - 0.5f;
+        prepared.TexelY = (q.V0 + ((float)prepared.MinY + 0.5f - q.Y0) * dv) * height - 0.5f;
+
+        float alpha = (float)(q.Color >> 24) / 255.0f;
+        prepared.Tint[0] = (float)(q.Color & 0xFF) / 255.0f * alpha;
+        prepared.Tint[1] = (float)((q.Color >> 8) & 0xFF) / 255.0f * alpha;
+        prepared.Tint[2] = (float)((q.Color >> 16) & 0xFF) / 255.0f * alpha;
+        prepared.Tint[3] = alpha;
+        prepared.Blend = (q.Color >> 24) != 0xFF || (q.Texture && !q.Texture->IsOpaque());
+
+        m_Quads.push_back(prepared);
+    }
+
+    void SoftwareRasterizer::Flush()
+    {
+        m_Stats = Stats();
+        if (m_Quads.empty() && !m_ClearPending) {
+            return;
+        }
+
+        using Clock = std::chrono::steady_clock;
+        auto start = Clock::now();
+
+        uint32_t available = JobSystem::GetWorkerCount() + 1;
+        uint32_t slots = m_ThreadCount ? std::min(m_ThreadCount, available) : available;
+        const uint32_t tileCount = m_TilesX * m_TilesY;
+        if (m_Bins.size() < slots) {
+            m_Bins.resize(slots);
+        }
+        for (uint32_t slot = 0; slot < slots; slot++) {
+            m_Bins[slot].resize(tileCount);
+            for (std::vector<uint32_t>& bin : m_Bins[slot]) {
+                bin.clear();
+            }
+        }
+        m_TilePixels.assign(tileCount, 0);
+
+        // Each slot bins a contiguous range of quads, so reading the slots in order gives every
+        // tile its quads in submission order
+        JobSystem::ParallelFor(slots, 1, [this, slots](uint32_t begin, uint32_t end) {
+            for (uint32_t slot = begin; slot < end; slot++) {
+                BinQuads(slot, slots);
+            }
+        });
+        auto binned = Clock::now();
+
+        // Tiles are handed out one at a time; their costs differ too much for fixed ranges
+        std::atomic<uint32_t> nextTile{ 0 };
+        JobSystem::ParallelFor(slots, 1, [this, slots, tileCount, &nextTile](uint32_t, uint32_t) {
+            for (uint32_t tile = nextTile.fetch_add(1, std::memory_order_relaxed); tile < tileCount;
+                 tile = nextTile.fetch_add(1, std::memory_order_relaxed)) {
+                RasterizeTile(tile, slots);
+            }
+        });
+        auto rasterized = Clock::now();
+
+        m_Stats.Quads = (uint32_t)m_Quads.size();
+        m_Stats.Threads = slots;
+        for (uint32_t slot = 0; slot < slots; slot++) {
+            for (const std::vector<uint32_t>& bin : m_Bins[slot]) {
+                m_Stats.BinnedQuads += bin.size();
+            }
+        }
+        for (uint64_t pixels : m_TilePixels) {
+            m_Stats.Pixels += pixels;
+        }
+        m_Stats.BinMs = std::chrono::duration<float, std::milli>(binned - start).count();
+        m_Stats.RasterMs = std::chrono::duration<float, std::milli>(rasterized - binned).count();
+
+        m_Quads.clear();
+        m_ClearPending = false;
+    }
+
+    void SoftwareRasterizer::BinQuads(uint32_t slot, uint32_t slotCount)
+    {
+        const size_t count = m_Quads.size();
+        const uint32_t begin = (uint32_t)(count * slot / slotCount);
+        const uint32_t end = (uint32_t)(count * (slot + 1) / slotCount);
+        std::vector<std::vector<uint32_t>>& bins = m_Bins[slot];
+
+        for (uint32_t index = begin; index < end; index++) {
+            const PreparedQuad& quad = m_Quads[index];
+            uint32_t firstX = (uint32_t)quad.MinX / TileSize, lastX = (uint32_t)quad.MaxX / TileSize;
+            uint32_t firstY = (uint32_t)quad.MinY / TileSize, lastY = (uint32_t)quad.MaxY / TileSize;
+            for (uint32_t ty = firstY; ty <= lastY; ty++) {
+                for (uint32_t tx = firstX; tx <= lastX; tx++) {
+                    bins[ty * m_TilesX + tx].push_back(index);
+                }
+            }
+        }
+    }
+
+    void SoftwareRasterizer::RasterizeTile(uint32_t tile, uint32_t slotCount)
+    {
+        const int32_t tileMinX = (int32_t)((tile % m_TilesX) * TileSize);
+        const int32_t tileMinY = (int32_t)((tile / m_TilesX) * TileSize);
+        const int32_t tileMaxX = std::min(tileMinX + (int32_t)TileSize, (int32_t)m_Width) - 1;
+        const int32_t tileMaxY = std::min(tileMinY + (int32_t)TileSize, (int32_t)m_Height) - 1;
+
+        if (m_ClearPending) {
+            for (int32_t y = tileMinY; y <= tileMaxY; y++) {
+                uint32_t* row = &m_Pixels[(size_t)y * m_Width];
+                std::fill(row + tileMinX, row + tileMaxX + 1, m_ClearColor);
+            }
+        }
+
+        uint64_t pixels = 0;
+        for (uint32_t slot = 0; slot < slotCount; slot++) {
+            for (uint32_t index : m_Bins[slot][tile]) {
+                const PreparedQuad& quad = m_Quads[index];
+                int32_t x0 = std::max(quad.MinX, tileMinX), x1 = std::min(quad.MaxX, tileMaxX);
+                int32_t y0 = std::max(quad.MinY, tileMinY), y1 = std::min(quad.MaxY, tileMaxY);
+                for (int32_t y = y0; y <= y1; y++) {
+                    DrawSpan(quad, y, x0, x1);
+                }
+                pixels += (uint64_t)(x1 - x0 + 1) * (uint64_t)(y1 - y0 + 1);
+            }
+        }
+        m_TilePixels[tile] = pixels;
+    }
+
+    // Pixels [x0, x1] of row y, four at a time. Channels are unpacked to floats, filtered,
+    // tinted, blended and packed again; the texel fetches are the only scalar part.
+    void SoftwareRasterizer::DrawSpan(const PreparedQuad& quad, int32_t y, int32_t x0, int32_t x1)
+    {
+        using namespace SIMD;
+
+        uint32_t* dst = &m_Pixels[(size_t)y * m_Width + x0];
+        const int32_t count = x1 - x0 + 1;
+        const Int4 byteMask = SetInt1(0xFF);
+        const Float4 half = Set1(0.5f);
+        const Float4 tint[4] = { Set1(quad.Tint[0]), Set1(quad.Tint[1]), Set1(quad.Tint[2]), Set1(quad.Tint[3]) };
+
+        auto channel = [byteMask](Int4 pixels, int c) { return ToFloat(AndInt(ShiftRightInt(pixels, c * 8), byteMask)); };
+        auto blendAndStore = [&](Float4 src[4], uint32_t* out, int32_t lanes) {
+            alignas(16) int32_t packed[4];
+            Int4 result;
+            if (quad.Blend) {
+                alignas(16) int32_t target[4] = { 0, 0, 0, 0 };
+                memcpy(target, out, (size_t)lanes * sizeof(uint32_t));
+                Int4 below = LoadInt(target);
+                Float4 inverse = Sub(Set1(1.0f), Mul(src[3], Set1(1.0f / 255.0f)));
+                result = SetInt1(0);
+                for (int c = 0; c < 4; c++) {
+                    Float4 value = MulAdd(channel(below, c), inverse, src[c]);
+                    result = OrInt(result, ShiftLeftInt(ToInt(Add(value, half)), c * 8));
+                }
+            } else {
+                result = SetInt1(0);
+                for (int c = 0; c < 4; c++) {
+                    result = OrInt(result, ShiftLeftInt(ToInt(Add(src[c], half)), c * 8));
+                }
+            }
+            if (lanes == 4) {
+                StoreInt((int32_t*)out, result);
+            } else {
+                StoreInt(packed, result);
+                memcpy(out, packed, (size_t)lanes * sizeof(uint32_t));
+            }
+        };
+
+        const SoftwareTexture* texture = quad.Source.Texture;
+        if (!texture) {
+            Float4 src[4];
+            for (int c = 0; c < 4; c++) {
+                src[c] = Mul(tint[c], Set1(255.0f));
+            }
+            for (int32_t i = 0; i < count; i += 4) {
+                blendAndStore(src, dst + i, std::min(count - i, 4));
+            }
+            return;
+        }
+
+        // The row pair and vertical weight are shared by the whole span
+        const int32_t width = texture->GetWidth(), height = texture->GetHeight();
+        float texelY = quad.TexelY + (float)(y - quad.MinY) * quad.TexelStepY;
+        texelY = std::min(std::max(texelY, 0.0f), (float)(height - 1));
+        const int32_t row0 = (int32_t)texelY;
+        const int32_t row1 = std::min(row0 + 1, height - 1);
+        const Float4 fy = Set1(texelY - (float)row0);
+        const uint32_t* texels0 = texture->GetTexels() + (size_t)row0 * width;
+        const uint32_t* texels1 = texture->GetTexels() + (size_t)row1 * width;
+
+        const float startX = quad.TexelX + (float)(x0 - quad.MinX) * quad.TexelStepX;
+        const Float4 laneOffsets = Mul(Set(0.0f, 1.0f, 2.0f, 3.0f), Set1(quad.TexelStepX));
+        const Float4 maxX = Set1((float)(width - 1));
+
+        for (int32_t i = 0; i < count; i += 4) {
+            Float4 texelX = Add(Set1(startX + (float)i * quad.TexelStepX), laneOffsets);
+            texelX = Min(Max(texelX, Zero()), maxX);
+            Int4 column = ToInt(texelX);
+            Float4 fx = Sub(texelX, ToFloat(column));
+
+            alignas(16) int32_t columns[4];
+            alignas(16) int32_t t00[4], t10[4], t01[4], t11[4];
+            StoreInt(columns, column);
+            for (int lane = 0; lane < 4; lane++) {
+                int32_t left = columns[lane];
+                int32_t right = left + (left < width - 1 ? 1 : 0);
+                t00[lane] = (int32_t)texels0[left];
+                t10[lane] = (int32_t)texels0[right];
+                t01[lane] = (int32_t)texels1[left];
+                t11[lane] = (int32_t)texels1[right];
+            }
+            Int4 p00 = LoadInt(t00), p10 = LoadInt(t10), p01 = LoadInt(t01), p11 = LoadInt(t11);
+
+            Float4 src[4];
+            for (int c = 0; c < 4; c++) {
+                Float4 c00 = channel(p00, c), c10 = channel(p10, c);
+                Float4 c01 = channel(p01, c), c11 = channel(p11, c);
+                Float4 bottom = MulAdd(Sub(c10, c00), fx, c00);
+                Float4 top = MulAdd(Sub(c11, c01), fx, c01);
+                src[c] = Mul(MulAdd(Sub(top, bottom), fy, bottom), tint[c]);
+            }
+            blendAndStore(src, dst + i, std::min(count - i, 4));
+        }
+    }
+
+    bool SoftwareRasterizer::WriteTGA(const std::string& path) const
+    {
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            printf("Error: cannot write %s\n", path.c_str());
+            return false;
+        }
+
+        // Type 2 (uncompressed true colour), 32 bpp, 8 alpha bits, origin at the bottom-left
+        uint8_t header[18] = {};
+        header[2] = 2;
+        header[12] = (uint8_t)(m_Width & 0xFF);
+        header[13] = (uint8_t)(m_Width >> 8);
+        header[14] = (uint8_t)(m_Height & 0xFF);
+        header[15] = (uint8_t)(m_Height >> 8);
+        header[16] = 32;
+        header[17] = 8;
+        bool ok = fwrite(header, sizeof(header), 1, file) == 1;
+
+        std::vector<uint8_t> row((size_t)m_Width * 4);
+        for (uint32_t y = 0; y < m_Height && ok; y++) {
+            const uint32_t* pixels = &m_Pixels[(size_t)y * m_Width];
+            for (uint32_t x = 0; x < m_Width; x++) {
+                uint32_t pixel = pixels[x];
+                row[x * 4 + 0] = (uint8_t)(pixel >> 16);    // BGRA
+                row[x * 4 + 1] = (uint8_t)(pixel >> 8);
+                row[x * 4 + 2] = (uint8_t)pixel;
+                row[x * 4 + 3] = (uint8_t)(pixel >> 24);
+            }
+            ok = fwrite(row.data(), row.size(), 1, file) == 1;
+        }
+        fclose(file);
+        if (!ok) {
+            printf("Error: failed writing %s\n", path.c_str());
+        }
+        return ok;
+    }
+
+    SoftwareRendererBackend::SoftwareRendererBackend(uint32_t width, uint32_t height)
+        : m_Rasterizer(width, height)
+    {
+    }
+
+    void SoftwareRendererBackend::Clear(const glm::vec4& color)
+    {
+        m_Rasterizer.Clear(PackPremultiplied(color.x, color.y, color.z, color.w));
+    }
+
+    void SoftwareRendererBackend::BeginScene(const RenderSceneInfo& scene)
+    {
+        m_ViewProjection = scene.ViewProjection;
+    }
+
+    void SoftwareRendererBackend::DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture)
+    {
+        if (texture->GetBackendType() != RendererBackendType::Software) {
+            printf("Error: Software backend cannot draw an OpenGL texture\n");
+            return;
+        }
+
+        // Corners to clip space, then to pixels; Renderer2D's projections never rotate
+        glm::vec2 halfSize = size * 0.5f;
+        glm::vec4 min = m_ViewProjection * glm::vec4(position.x - halfSize.x, position.y - halfSize.y, 0.0f, 1.0f);
+        glm::vec4 max = m_ViewProjection * glm::vec4(position.x + halfSize.x, position.y + halfSize.y, 0.0f, 1.0f);
+        const float width = (float)m_Rasterizer.GetWidth(), height = (float)m_Rasterizer.GetHeight();
+
+        SoftwareRasterizer::Quad quad;
+        quad.X0 = (min.x / min.w * 0.5f + 0.5f) * width;
+        quad.Y0 = (min.y / min.w * 0.5f + 0.5f) * height;
+        quad.X1 = (max.x / max.w * 0.5f + 0.5f) * width;
+        quad.Y1 = (max.y / max.w * 0.5f + 0.5f) * height;
+        quad.U0 = 0.0f; quad.V0 = 0.0f;
+        quad.U1 = 1.0f; quad.V1 = 1.0f;
+        quad.Texture = static_cast<SoftwareTexture*>(texture);
+        m_Rasterizer.Submit(quad);
+    }
+
+    void SoftwareRendererBackend::EndScene()
+    {
+        m_Rasterizer.Flush();
+    }
+
+}
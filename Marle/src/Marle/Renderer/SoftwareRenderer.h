@@ -0,0 +1,146 @@
+#pragma once
+
+#include "../Core.h"
+#include "RendererBackend.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // RGBA8 texture in main memory for the software rasterizer. Texels are stored premultiplied
+    // and bottom row first, like an uploaded GL texture, so v = 0 is the bottom edge.
+    class SoftwareTexture : public Texture2D {
+    public:
+        // rgba is straight alpha, top row first unless bottomUp
+        SoftwareTexture(uint32_t width, uint32_t height, const uint8_t* rgba, bool bottomUp = true);
+
+        // Any format OpenGLTexture2D reads (ImageDecoder formats, .dds); nullptr when loading failed.
+        // No GL calls, safe on job threads.
+        static std::unique_ptr<SoftwareTexture> Load(const std::string& path);
+
+        RendererBackendType GetBackendType() const override { return RendererBackendType::Software; }
+        int GetWidth() const override { return (int)m_Width; }
+        int GetHeight() const override { return (int)m_Height; }
+
+        const uint32_t* GetTexels() const { return m_Texels.data(); }
+        // Every texel has alpha 255, so draws can skip reading the target
+        bool IsOpaque() const { return m_Opaque; }
+        size_t GetMemorySize() const { return m_Texels.size() * sizeof(uint32_t); }
+
+    private:
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        std::vector<uint32_t> m_Texels;
+        bool m_Opaque = true;
+    };
+
+    // Draws textured, axis-aligned quads into a framebuffer in main memory, on every JobSystem
+    // thread. The framebuffer is split into 64x64 tiles. Flush() first bins the submitted quads
+    // to the tiles they touch, then rasterizes whole tiles in parallel, so no two threads ever
+    // write the same pixel and each tile stays in cache while its quads are drawn. Within a tile,
+    // quads are drawn in submission order: the result is identical for any thread count.
+    //
+    // Texels are sampled bilinearly with clamp-to-edge, four pixels at a time in SIMD, and blended
+    // premultiplied "over" the target. Pixels are RGBA8 (R in the low byte), bottom row first.
+    class SoftwareRasterizer {
+    public:
+        static constexpr uint32_t TileSize = 64;
+
+        // Pixel coordinates, (0, 0) at the bottom-left corner; a pixel is covered when its centre
+        // is inside [X0, X1) x [Y0, Y1)
+        struct Quad {
+            float X0, Y0, X1, Y1;
+            float U0, V0, U1, V1;
+            const SoftwareTexture* Texture = nullptr;   // nullptr = solid Color
+            uint32_t Color = 0xFFFFFFFF;                // Straight RGBA8, multiplies the texels
+        };
+
+        SoftwareRasterizer(uint32_t width, uint32_t height);
+
+        void Resize(uint32_t width, uint32_t height);
+        uint32_t GetWidth() const { return m_Width; }
+        uint32_t GetHeight() const { return m_Height; }
+
+        // Threads that bin and rasterize, the calling one included. 0 = every JobSystem thread;
+        // larger values are capped to it.
+        void SetThreadCount(uint32_t threads) { m_ThreadCount = threads; }
+
+        // Applied to each tile just before its quads, so it costs no separate pass
+        void Clear(uint32_t color);
+        void Submit(const Quad& quad);
+        // Draws everything submitted since the last flush
+        void Flush();
+
+        const uint32_t* GetPixels() const { return m_Pixels.data(); }
+        uint32_t GetPixel(uint32_t x, uint32_t y) const { return m_Pixels[(size_t)y * m_Width + x]; }
+
+        // Uncompressed 32-bit TGA, for inspecting and diffing frames
+        bool WriteTGA(const std::string& path) const;
+
+        struct Stats {
+            uint32_t Quads = 0;
+            uint32_t Threads = 0;
+            uint64_t BinnedQuads = 0;   // Quad-tile pairs
+            uint64_t Pixels = 0;        // Pixels shaded, overdraw included
+            float BinMs = 0.0f;
+            float RasterMs = 0.0f;
+        };
+        // Of the last Flush()
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        // Quad plus what every tile needs to rasterize it
+        struct PreparedQuad {
+            Quad Source;
+            int32_t MinX, MinY, MaxX, MaxY;     // Covered pixels, inclusive, clipped to the target
+            float TexelX, TexelStepX;           // Texel-space x at MinX's centre, and per pixel
+            float TexelY, TexelStepY;
+            float Tint[4];                      // Premultiplied, 0-1
+            bool Blend;
+        };
+
+        void BinQuads(uint32_t slot, uint32_t slotCount);
+        void RasterizeTile(uint32_t tile, uint32_t slotCount);
+        void DrawSpan(const PreparedQuad& quad, int32_t y, int32_t x0, int32_t x1);
+
+        uint32_t m_Width = 0;
+        uint32_t m_Height = 0;
+        uint32_t m_TilesX = 0;
+        uint32_t m_TilesY = 0;
+        uint32_t m_ThreadCount = 0;
+        std::vector<uint32_t> m_Pixels;
+
+        bool m_ClearPending = false;
+        uint32_t m_ClearColor = 0;
+        std::vector<PreparedQuad> m_Quads;
+        // Per binning thread, per tile: indices into m_Quads, ascending
+        std::vector<std::vector<std::vector<uint32_t>>> m_Bins;
+        std::vector<uint64_t> m_TilePixels;
+        Stats m_Stats;
+    };
+
+    // Renderer2D on the CPU, for machines without a usable GPU and for deterministic headless
+    // rendering in tests. Renders into a SoftwareRasterizer; draws only SoftwareTextures.
+    class SoftwareRendererBackend : public RendererBackend {
+    public:
+        SoftwareRendererBackend(uint32_t width = 1024, uint32_t height = 768);
+
+        RendererBackendType GetType() const override { return RendererBackendType::Software; }
+        const char* GetName() const override { return "Software"; }
+
+        void Clear(const glm::vec4& color) override;
+        void BeginScene(const RenderSceneInfo& scene) override;
+        void DrawQuad(const glm::vec2& position, const glm::vec2& size, Texture2D* texture) override;
+        void EndScene() override;
+
+        SoftwareRasterizer& GetRasterizer() { return m_Rasterizer; }
+        const SoftwareRasterizer& GetRasterizer() const { return m_Rasterizer; }
+
+    private:
+        SoftwareRasterizer m_Rasterizer;
+        glm::mat4 m_ViewProjection = glm::mat4(1.0f);
+    };
+
+}
@@ -0,0 +1,801 @@
+#include "mrlpch.h"
+#include "TextureCompression.h"
+#include "../Core/JobSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Marle {
+
+    const char* GetTextureFormatName(TextureFormat format)
+    {
+        switch (format) {
+            case TextureFormat::RGBA8: return "RGBA8";
+            case TextureFormat::BC1:   return "BC1";
+            case TextureFormat::BC3:   return "BC3";
+            case TextureFormat::BC7:   return "BC7";
+        }
+        return "Unknown";
+    }
+
+    size_t GetBlockBytes(TextureFormat format)
+    {
+        switch (format) {
+            case TextureFormat::BC1: return 8;
+            case TextureFormat::BC3: return 16;
+            case TextureFormat::BC7: return 16;
+            default:                 return 0;
+        }
+    }
+
+    size_t GetTextureDataSize(TextureFormat format, uint32_t width, uint32_t height)
+    {
+        if (format == TextureFormat::RGBA8) {
+            return (size_t)width * height * 4;
+        }
+        return (size_t)((width + 3) / 4) * ((height + 3) / 4) * GetBlockBytes(format);
+    }
+
+    // Shared helpers
+
+    static inline float Clamp255(float v) { return std::min(std::max(v, 0.0f), 255.0f); }
+
+    // Principal axis of count points with the given number of channels (power iteration on the covariance)
+    static void PrincipalAxis(const float (*points)[4], int count, int channels, const float mean[4], float axis[4])
+    {
+        float cov[4][4] = {};
+        for (int i = 0; i < count; i++) {
+            float d[4];
+            for (int c = 0; c < channels; c++) d[c] = points[i][c] - mean[c];
+            for (int a = 0; a < channels; a++)
+                for (int b = 0; b < channels; b++)
+                    cov[a][b] += d[a] * d[b];
+        }
+
+        for (int c = 0; c < 4; c++) axis[c] = c < channels ? 1.0f : 0.0f;
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float next[4] = {};
+            for (int a = 0; a < channels; a++)
+                for (int b = 0; b < channels; b++)
+                    next[a] += cov[a][b] * axis[b];
+
+            float length = 0.0f;
+            for (int c = 0; c < channels; c++) length += next[c] * next[c];
+            if (length < 1e-12f) {
+                break; // Flat block, any axis will do
+            }
+            length = 1.0f / std::sqrt(length);
+            for (int c = 0; c < channels; c++) axis[c] = next[c] * length;
+        }
+    }
+
+    // Least-squares endpoints for fixed per-pixel interpolation weights (0 = first endpoint, 1 = second)
+    static bool SolveEndpoints(const float (*points)[4], const float* weights, int count, int channels, float e0[4], float e1[4])
+    {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        float x[4] = {}, y[4] = {};
+        for (int i = 0; i < count; i++) {
+            float beta = weights[i], alpha = 1.0f - beta;
+            a += alpha * alpha;
+            b += alpha * beta;
+            c += beta * beta;
+            for (int ch = 0; ch < channels; ch++) {
+                x[ch] += alpha * points[i][ch];
+                y[ch] += beta * points[i][ch];
+            }
+        }
+
+        float det = a * c - b * b;
+        if (std::fabs(det) < 1e-6f) {
+            return false;
+        }
+        float inv = 1.0f / det;
+        for (int ch = 0; ch < channels; ch++) {
+            e0[ch] = Clamp255((c * x[ch] - b * y[ch]) * inv);
+            e1[ch] = Clamp255((a * y[ch] - b * x[ch]) * inv);
+        }
+        return true;
+    }
+
+    // BC1 / BC3 color block
+
+    static uint16_t Pack565(const float c[4])
+    {
+        uint32_t r = (uint32_t)(Clamp255(c[0]) * 31.0f / 255.0f + 0.5f);
+        uint32_t g = (uint32_t)(Clamp255(c[1]) * 63.0f / 255.0f + 0.5f);
+        uint32_t b = (uint32_t)(Clamp255(c[2]) * 31.0f / 255.0f + 0.5f);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    static void Unpack565(uint16_t v, int out[3])
+    {
+        int r = (v >> 11) & 31, g = (v >> 5) & 63, b = v & 31;
+        out[0] = (r << 3) | (r >> 2);
+        out[1] = (g << 2) | (g >> 4);
+        out[2] = (b << 3) | (b >> 2);
+    }
+
+    static void BuildColorPalette(uint16_t c0, uint16_t c1, bool fourColor, int palette[4][3])
+    {
+        Unpack565(c0, palette[0]);
+        Unpack565(c1, palette[1]);
+        for (int ch = 0; ch < 3; ch++) {
+            if (fourColor) {
+                palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+                palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+            } else {
+                palette[2][ch] = (palette[0][ch] + palette[1][ch]) / 2;
+                palette[3][ch] = 0;
+            }
+        }
+    }
+
+    // Picks indices for fixed endpoints; returns the squared error over opaque pixels
+    static float ChooseColorIndices(const uint8_t* rgba, uint16_t c0, uint16_t c1, bool fourColor, bool transparent, uint8_t indices[16])
+    {
+        int palette[4][3];
+        BuildColorPalette(c0, c1, fourColor, palette);
+
+        float error = 0.0f;
+        int usable = fourColor ? 4 : 3;
+        for (int i = 0; i < 16; i++) {
+            const uint8_t* p = rgba + i * 4;
+            if (transparent && p[3] < 128) {
+                indices[i] = 3;
+                continue;
+            }
+            int best = 0, bestError = 1 << 30;
+            for (int e = 0; e < usable; e++) {
+                int dr = p[0] - palette[e][0], dg = p[1] - palette[e][1], db = p[2] - palette[e][2];
+                int d = dr * dr + dg * dg + db * db;
+                if (d < bestError) {
+                    bestError = d;
+                    best = e;
+                }
+            }
+            indices[i] = (uint8_t)best;
+            error += (float)bestError;
+        }
+        return error;
+    }
+
+    static void EncodeColorBlock(const uint8_t* rgba, uint8_t* output, bool allowTransparent)
+    {
+        float points[16][4];
+        int count = 0;
+        bool transparent = false;
+        for (int i = 0; i < 16; i++) {
+            const uint8_t* p = rgba + i * 4;
+            if (allowTransparent && p[3] < 128) {
+                transparent = true;
+                continue;
+            }
+            points[count][0] = p[0];
+            points[count][1] = p[1];
+            points[count][2] = p[2];
+            points[count][3] = 0.0f;
+            count++;
+        }
+
+        if (count == 0) {
+            // Fully transparent: three-color mode, every index "transparent black"
+            memset(output, 0, 4);
+            memset(output + 4, 0xFF, 4);
+            return;
+        }
+
+        float mean[4] = {};
+        for (int i = 0; i < count; i++)
+            for (int ch = 0; ch < 3; ch++)
+                mean[ch] += points[i][ch] / (float)count;
+
+        float axis[4];
+        PrincipalAxis(points, count, 3, mean, axis);
+
+        float minT = 1e9f, maxT = -1e9f;
+        for (int i = 0; i < count; i++) {
+            float t = (points[i][0] - mean[0]) * axis[0] + (points[i][1] - mean[1]) * axis[1] + (points[i][2] - mean[2]) * axis[2];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        // Pull the extremes in slightly; interpolated colors then cover the cluster better
+        float inset = (maxT - minT) / 16.0f;
+        minT += inset;
+        maxT -= inset;
+
+        float e0[4], e1[4];
+        for (int ch = 0; ch < 3; ch++) {
+            e0[ch] = mean[ch] + axis[ch] * maxT;
+            e1[ch] = mean[ch] + axis[ch] * minT;
+        }
+
+        const bool fourColor = !transparent;
+        uint16_t c0 = Pack565(e0), c1 = Pack565(e1);
+        uint8_t indices[16];
+        float error = ChooseColorIndices(rgba, c0, c1, fourColor, transparent, indices);
+
+        // One refinement: least-squares endpoints for the chosen indices
+        static const float s_FourColorWeights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+        static const float s_ThreeColorWeights[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+        const float* weightTable = fourColor ? s_FourColorWeights : s_ThreeColorWeights;
+        float weights[16];
+        for (int i = 0, n = 0; i < 16; i++) {
+            if (!transparent || rgba[i * 4 + 3] >= 128) {
+                weights[n++] = weightTable[indices[i]];
+            }
+        }
+        float r0[4], r1[4];
+        if (SolveEndpoints(points, weights, count, 3, r0, r1)) {
+            uint16_t rc0 = Pack565(r0), rc1 = Pack565(r1);
+            uint8_t refined[16];
+            float refinedError = ChooseColorIndices(rgba, rc0, rc1, fourColor, transparent, refined);
+            if (refinedError < error) {
+                c0 = rc0;
+                c1 = rc1;
+                error = refinedError;
+                memcpy(indices, refined, 16);
+            }
+        }
+
+        // Endpoint order selects the mode: c0 > c1 is four-color, c0 <= c1 three-color
+        if ((fourColor && c0 < c1) || (!fourColor && c0 > c1)) {
+            std::swap(c0, c1);
+            for (int i = 0; i < 16; i++) {
+                if (indices[i] < 2) indices[i] ^= 1;
+                else if (fourColor) indices[i] ^= 1; // 2 <-> 3
+            }
+        }
+        if (fourColor && c0 == c1) {
+            memset(indices, 0, 16);
+        }
+
+        output[0] = (uint8_t)(c0 & 0xFF);
+        output[1] = (uint8_t)(c0 >> 8);
+        output[2] = (uint8_t)(c1 & 0xFF);
+        output[3] = (uint8_t)(c1 >> 8);
+        for (int row = 0; row < 4; row++) {
+            output[4 + row] = (uint8_t)(indices[row * 4] | (indices[row * 4 + 1] << 2) |
+                                        (indices[row * 4 + 2] << 4) | (indices[row * 4 + 3] << 6));
+        }
+    }
+
+    static void DecodeColorBlock(const uint8_t* input, uint8_t* rgba, bool alwaysFourColor)
+    {
+        uint16_t c0 = (uint16_t)(input[0] | (input[1] << 8));
+        uint16_t c1 = (uint16_t)(input[2] | (input[3] << 8));
+        bool fourColor = alwaysFourColor || c0 > c1;
+
+        int palette[4][3];
+        BuildColorPalette(c0, c1, fourColor, palette);
+
+        for (int i = 0; i < 16; i++) {
+            int index = (input[4 + i / 4] >> ((i % 4) * 2)) & 3;
+            uint8_t* p = rgba + i * 4;
+            p[0] = (uint8_t)palette[index][0];
+            p[1] = (uint8_t)palette[index][1];
+            p[2] = (uint8_t)palette[index][2];
+            p[3] = (!fourColor && index == 3) ? 0 : 255;
+        }
+    }
+
+    // BC3 alpha block (BC4)
+
+    static void BuildAlphaPalette(int a0, int a1, int palette[8])
+    {
+        palette[0] = a0;
+        palette[1] = a1;
+        if (a0 > a1) {
+            for (int i = 2; i < 8; i++) palette[i] = ((8 - i) * a0 + (i - 1) * a1) / 7;
+        } else {
+            for (int i = 2; i < 6; i++) palette[i] = ((6 - i) * a0 + (i - 1) * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+    }
+
+    static void EncodeAlphaBlock(const uint8_t* rgba, uint8_t* output)
+    {
+        int a0 = 0, a1 = 255;
+        for (int i = 0; i < 16; i++) {
+            a0 = std::max(a0, (int)rgba[i * 4 + 3]);
+            a1 = std::min(a1, (int)rgba[i * 4 + 3]);
+        }
+
+        output[0] = (uint8_t)a0;
+        output[1] = (uint8_t)a1;
+        uint64_t bits = 0;
+        if (a0 != a1) {
+            int palette[8];
+            BuildAlphaPalette(a0, a1, palette);
+            for (int i = 0; i < 16; i++) {
+                int alpha = rgba[i * 4 + 3];
+                int best = 0, bestError = 1 << 30;
+                for (int e = 0; e < 8; e++) {
+                    int d = std::abs(alpha - palette[e]);
+                    if (d < bestError) {
+                        bestError = d;
+                        best = e;
+                    }
+                }
+                bits |= (uint64_t)best << (i * 3);
+            }
+        }
+        for (int i = 0; i < 6; i++) {
+            output[2 + i] = (uint8_t)(bits >> (i * 8));
+        }
+    }
+
+    static void DecodeAlphaBlock(const uint8_t* input, uint8_t* rgba)
+    {
+        int palette[8];
+        BuildAlphaPalette(input[0], input[1], palette);
+
+        uint64_t bits = 0;
+        for (int i = 0; i < 6; i++) {
+            bits |= (uint64_t)input[2 + i] << (i * 8);
+        }
+        for (int i = 0; i < 16; i++) {
+            rgba[i * 4 + 3] = (uint8_t)palette[(bits >> (i * 3)) & 7];
+        }
+    }
+
+    void EncodeBC1Block(const uint8_t rgba[64], uint8_t output[8])
+    {
+        EncodeColorBlock(rgba, output, true);
+    }
+
+    void EncodeBC3Block(const uint8_t rgba[64], uint8_t output[16])
+    {
+        EncodeAlphaBlock(rgba, output);
+        EncodeColorBlock(rgba, output + 8, false);
+    }
+
+    void DecodeBC1Block(const uint8_t input[8], uint8_t rgba[64])
+    {
+        DecodeColorBlock(input, rgba, false);
+    }
+
+    void DecodeBC3Block(const uint8_t input[16], uint8_t rgba[64])
+    {
+        DecodeColorBlock(input + 8, rgba, true);
+        DecodeAlphaBlock(input, rgba);
+    }
+
+    // BC7 encoding uses mode 6 only: one subset, RGBA endpoints 7 bits + unique p-bit each,
+    // 4-bit indices
+
+    static const int s_BC7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    struct BC7Endpoints {
+        int Quantized[2][4]; // 7-bit values
+        int PBit[2];
+        int Value[2][4];     // Reconstructed 8-bit values
+    };
+
+    static void QuantizeBC7Endpoint(const float e[4], int slot, BC7Endpoints& out)
+    {
+        float bestError = 1e30f;
+        for (int p = 0; p < 2; p++) {
+            float error = 0.0f;
+            int q[4], v[4];
+            for (int ch = 0; ch < 4; ch++) {
+                q[ch] = std::min(std::max((int)std::lround((e[ch] - p) / 2.0f), 0), 127);
+                v[ch] = (q[ch] << 1) | p;
+                error += (v[ch] - e[ch]) * (v[ch] - e[ch]);
+            }
+            if (error < bestError) {
+                bestError = error;
+                out.PBit[slot] = p;
+                for (int ch = 0; ch < 4; ch++) {
+                    out.Quantized[slot][ch] = q[ch];
+                    out.Value[slot][ch] = v[ch];
+                }
+            }
+        }
+    }
+
+    static float ChooseBC7Indices(const uint8_t* rgba, const BC7Endpoints& endpoints, uint8_t indices[16])
+    {
+        int palette[16][4];
+        for (int i = 0; i < 16; i++)
+            for (int ch = 0; ch < 4; ch++)
+                palette[i][ch] = ((64 - s_BC7Weights4[i]) * endpoints.Value[0][ch] + s_BC7Weights4[i] * endpoints.Value[1][ch] + 32) >> 6;
+
+        float error = 0.0f;
+        for (int i = 0; i < 16; i++) {
+            const uint8_t* p = rgba + i * 4;
+            int best = 0, bestError = 1 << 30;
+            for (int e = 0; e < 16; e++) {
+                int d = 0;
+                for (int ch = 0; ch < 4; ch++) {
+                    int diff = p[ch] - palette[e][ch];
+                    d += diff * diff;
+                }
+                if (d < bestError) {
+                    bestError = d;
+                    best = e;
+                }
+            }
+            indices[i] = (uint8_t)best;
+            error += (float)bestError;
+        }
+        return error;
+    }
+
+    struct BitWriter {
+        uint8_t* Data;
+        uint32_t Position = 0;
+
+        void Write(uint32_t value, uint32_t bits)
+        {
+            for (uint32_t i = 0; i < bits; i++, Position++) {
+                if ((value >> i) & 1) {
+                    Data[Position >> 3] |= (uint8_t)(1 << (Position & 7));
+                }
+            }
+        }
+    };
+
+    struct BitReader {
+        const uint8_t* Data;
+        uint32_t Position = 0;
+
+        uint32_t Read(uint32_t bits)
+        {
+            uint32_t value = 0;
+            for (uint32_t i = 0; i < bits; i++, Position++) {
+                value |= (uint32_t)((Data[Position >> 3] >> (Position & 7)) & 1) << i;
+            }
+            return value;
+        }
+    };
+
+    void EncodeBC7Block(const uint8_t rgba[64], uint8_t output[16])
+    {
+        float points[16][4];
+        float mean[4] = {};
+        for (int i = 0; i < 16; i++) {
+            for (int ch = 0; ch < 4; ch++) {
+                points[i][ch] = rgba[i * 4 + ch];
+                mean[ch] += points[i][ch] / 16.0f;
+            }
+        }
+
+        float axis[4];
+        PrincipalAxis(points, 16, 4, mean, axis);
+
+        float minT = 1e9f, maxT = -1e9f;
+        for (int i = 0; i < 16; i++) {
+            float t = 0.0f;
+            for (int ch = 0; ch < 4; ch++) t += (points[i][ch] - mean[ch]) * axis[ch];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        float e0[4], e1[4];
+        for (int ch = 0; ch < 4; ch++) {
+            e0[ch] = Clamp255(mean[ch] + axis[ch] * minT);
+            e1[ch] = Clamp255(mean[ch] + axis[ch] * maxT);
+        }
+
+        BC7Endpoints endpoints;
+        QuantizeBC7Endpoint(e0, 0, endpoints);
+        QuantizeBC7Endpoint(e1, 1, endpoints);
+        uint8_t indices[16];
+        float error = ChooseBC7Indices(rgba, endpoints, indices);
+
+        // Two least-squares refinements; sixteen levels make this converge quickly
+        for (int iteration = 0; iteration < 2; iteration++) {
+            float weights[16];
+            for (int i = 0; i < 16; i++) weights[i] = s_BC7Weights4[indices[i]] / 64.0f;
+
+            float r0[4], r1[4];
+            if (!SolveEndpoints(points, weights, 16, 4, r0, r1)) {
+                break;
+            }
+            BC7Endpoints refined;
+            QuantizeBC7Endpoint(r0, 0, refined);
+            QuantizeBC7Endpoint(r1, 1, refined);
+            uint8_t refinedIndices[16];
+            float refinedError = ChooseBC7Indices(rgba, refined, refinedIndices);
+            if (refinedError >= error) {
+                break;
+            }
+            endpoints = refined;
+            error = refinedError;
+            memcpy(indices, refinedIndices, 16);
+        }
+
+        // The anchor index is stored without its top bit, so it must be < 8
+        if (indices[0] & 8) {
+            for (int ch = 0; ch < 4; ch++) std::swap(endpoints.Quantized[0][ch], endpoints.Quantized[1][ch]);
+            std::swap(endpoints.PBit[0], endpoints.PBit[1]);
+            for (int i = 0; i < 16; i++) indices[i] = (uint8_t)(15 - indices[i]);
+        }
+
+        memset(output, 0, 16);
+        BitWriter writer{ output };
+        writer.Write(1 << 6, 7); // Mode 6
+        for (int ch = 0; ch < 4; ch++) {
+            writer.Write(endpoints.Quantized[0][ch], 7);
+            writer.Write(endpoints.Quantized[1][ch], 7);
+        }
+        writer.Write(endpoints.PBit[0], 1);
+        writer.Write(endpoints.PBit[1], 1);
+        writer.Write(indices[0], 3);
+        for (int i = 1; i < 16; i++) {
+            writer.Write(indices[i], 4);
+        }
+    }
+
+    // BC7 decoding covers all eight modes, since .dds files from other encoders use all of them
+
+    struct BC7Mode {
+        int Subsets;
+        int PartitionBits;
+        int RotationBits;
+        int IndexSelectionBits;
+        int ColorBits;
+        int AlphaBits;              // 0 = opaque
+        int EndpointPBits;          // One p-bit per endpoint
+        int SharedPBits;            // One p-bit per subset
+        int IndexBits;
+        int SecondaryIndexBits;     // Modes 4 and 5 index colour and alpha separately
+    };
+
+    static const BC7Mode s_BC7Modes[8] = {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+    };
+
+    static const int s_BC7Weights2[4] = { 0, 21, 43, 64 };
+    static const int s_BC7Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+
+    // Two subsets: bit i set when pixel i is in subset 1
+    static const uint16_t s_BC7Partitions2[64] = {
+        0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80,
+        0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+        0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE,
+        0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+        0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A,
+        0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+        0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C,
+        0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22
+    };
+
+    static const uint8_t s_BC7Partitions3[64][16] = {
+        { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 2, 1 },
+        { 0, 0, 0, 0, 2, 0, 0, 1, 2, 2, 1, 1, 2, 2, 1, 1 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 1, 0, 1, 1, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 2, 2 },
+        { 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1 }, { 0, 0, 1, 1, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2 }, { 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2 },
+        { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2 },
+        { 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2, 0, 1, 1, 2 }, { 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2, 0, 1, 2, 2 },
+        { 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0, 2, 2, 2, 0 },
+        { 0, 0, 0, 1, 0, 0, 1, 1, 0, 1, 1, 2, 1, 1, 2, 2 }, { 0, 1, 1, 1, 0, 0, 1, 1, 2, 0, 0, 1, 2, 2, 0, 0 },
+        { 0, 0, 0, 0, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2 }, { 0, 0, 2, 2, 0, 0, 2, 2, 0, 0, 2, 2, 1, 1, 1, 1 },
+        { 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2, 0, 2, 2, 2 }, { 0, 0, 0, 1, 0, 0, 0, 1, 2, 2, 2, 1, 2, 2, 2, 1 },
+        { 0, 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2 }, { 0, 0, 0, 0, 1, 1, 0, 0, 2, 2, 1, 0, 2, 2, 1, 0 },
+        { 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1, 0, 0, 0, 0 }, { 0, 0, 1, 2, 0, 0, 1, 2, 1, 1, 2, 2, 2, 2, 2, 2 },
+        { 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1, 0, 1, 1, 0 }, { 0, 0, 0, 0, 0, 1, 1, 0, 1, 2, 2, 1, 1, 2, 2, 1 },
+        { 0, 0, 2, 2, 1, 1, 0, 2, 1, 1, 0, 2, 0, 0, 2, 2 }, { 0, 1, 1, 0, 0, 1, 1, 0, 2, 0, 0, 2, 2, 2, 2, 2 },
+        { 0, 0, 1, 1, 0, 1, 2, 2, 0, 1, 2, 2, 0, 0, 1, 1 }, { 0, 0, 0, 0, 2, 0, 0, 0, 2, 2, 1, 1, 2, 2, 2, 1 },
+        { 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 2, 2, 2 }, { 0, 2, 2, 2, 0, 0, 2, 2, 0, 0, 1, 2, 0, 0, 1, 1 },
+        { 0, 0, 1, 1, 0, 0, 1, 2, 0, 0, 2, 2, 0, 2, 2, 2 }, { 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0, 0, 1, 2, 0 },
+        { 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0 }, { 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0, 1, 2, 0 },
+        { 0, 1, 2, 0, 2, 0, 1, 2, 1, 2, 0, 1, 0, 1, 2, 0 }, { 0, 0, 1, 1, 2, 2, 0, 0, 1, 1, 2, 2, 0, 0, 1, 1 },
+        { 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 0, 0, 0, 0, 1, 1 }, { 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2 },
+        { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1 }, { 0, 0, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2, 1, 1, 2, 2 },
+        { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 2, 2, 0, 0, 1, 1 }, { 0, 2, 2, 0, 1, 2, 2, 1, 0, 2, 2, 0, 1, 2, 2, 1 },
+        { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 0, 1, 0, 1 }, { 0, 0, 0, 0, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1, 2, 1 },
+        { 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 0, 1, 2, 2, 2, 2 }, { 0, 2, 2, 2, 0, 1, 1, 1, 0, 2, 2, 2, 0, 1, 1, 1 },
+        { 0, 0, 0, 2, 1, 1, 1, 2, 0, 0, 0, 2, 1, 1, 1, 2 }, { 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2, 2, 1, 1, 2 },
+        { 0, 2, 2, 2, 0, 1, 1, 1, 0, 1, 1, 1, 0, 2, 2, 2 }, { 0, 0, 0, 2, 1, 1, 1, 2, 1, 1, 1, 2, 0, 0, 0, 2 },
+        { 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2, 2, 1, 1, 2 },
+        { 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 0, 2, 2, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 2, 2 },
+        { 0, 0, 2, 2, 1, 1, 2, 2, 1, 1, 2, 2, 0, 0, 2, 2 }, { 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 1, 1, 2 },
+        { 0, 0, 0, 2, 0, 0, 0, 1, 0, 0, 0, 2, 0, 0, 0, 1 }, { 0, 2, 2, 2, 1, 2, 2, 2, 0, 2, 2, 2, 1, 2, 2, 2 },
+        { 0, 1, 0, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2 }, { 0, 1, 1, 1, 2, 0, 1, 1, 2, 2, 0, 1, 2, 2, 2, 0 }
+    };
+
+    // Pixels whose index is stored without its top bit, besides pixel 0
+    static const uint8_t s_BC7Anchors2[64] = {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+    };
+
+    static const uint8_t s_BC7Anchors3[2][64] = {
+        {  3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+           3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+           8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+           3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3 },
+        { 15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+          15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+          15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+          15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8 }
+    };
+
+    static int BC7Weight(int bits, int index)
+    {
+        return bits == 2 ? s_BC7Weights2[index] : bits == 3 ? s_BC7Weights3[index] : s_BC7Weights4[index];
+    }
+
+    void DecodeBC7Block(const uint8_t input[16], uint8_t rgba[64])
+    {
+        BitReader reader{ input };
+        int modeIndex = 0;
+        while (modeIndex < 8 && reader.Read(1) == 0) {
+            modeIndex++;
+        }
+        if (modeIndex == 8) {
+            memset(rgba, 0, 64); // Reserved mode: transparent black, as GPUs decode it
+            return;
+        }
+
+        const BC7Mode& mode = s_BC7Modes[modeIndex];
+        const int partition = (int)reader.Read(mode.PartitionBits);
+        const int rotation = (int)reader.Read(mode.RotationBits);
+        const int indexSelection = (int)reader.Read(mode.IndexSelectionBits);
+        const int endpointCount = mode.Subsets * 2;
+
+        // Channel by channel, each subset's two endpoints in turn
+        int endpoints[6][4];
+        for (int ch = 0; ch < 4; ch++) {
+            int bits = ch < 3 ? mode.ColorBits : mode.AlphaBits;
+            for (int e = 0; e < endpointCount; e++) {
+                endpoints[e][ch] = bits ? (int)reader.Read(bits) : 255;
+            }
+        }
+
+        int pBits[6] = {};
+        for (int e = 0; e < endpointCount && mode.EndpointPBits; e++) {
+            pBits[e] = (int)reader.Read(1);
+        }
+        for (int subset = 0; subset < mode.Subsets && mode.SharedPBits; subset++) {
+            pBits[subset * 2] = pBits[subset * 2 + 1] = (int)reader.Read(1);
+        }
+
+        // To 8 bits: the p-bit goes below the stored bits, then the top bits are repeated below that
+        const bool hasPBits = mode.EndpointPBits || mode.SharedPBits;
+        for (int e = 0; e < endpointCount; e++) {
+            for (int ch = 0; ch < 4; ch++) {
+                int bits = ch < 3 ? mode.ColorBits : mode.AlphaBits;
+                if (bits == 0) {
+                    continue;
+                }
+                int value = endpoints[e][ch];
+                if (hasPBits) {
+                    value = (value << 1) | pBits[e];
+                    bits++;
+                }
+                endpoints[e][ch] = (value << (8 - bits)) | (value >> (2 * bits - 8));
+            }
+        }
+
+        uint8_t subsets[16] = {};
+        bool anchor[16] = { true };
+        if (mode.Subsets == 2) {
+            for (int i = 0; i < 16; i++) {
+                subsets[i] = (uint8_t)((s_BC7Partitions2[partition] >> i) & 1);
+            }
+            anchor[s_BC7Anchors2[partition]] = true;
+        } else if (mode.Subsets == 3) {
+            memcpy(subsets, s_BC7Partitions3[partition], 16);
+            anchor[s_BC7Anchors3[0][partition]] = true;
+            anchor[s_BC7Anchors3[1][partition]] = true;
+        }
+
+        int indices[16], secondary[16] = {};
+        for (int i = 0; i < 16; i++) {
+            indices[i] = (int)reader.Read(mode.IndexBits - (anchor[i] ? 1 : 0));
+        }
+        for (int i = 0; i < 16 && mode.SecondaryIndexBits; i++) {
+            secondary[i] = (int)reader.Read(mode.SecondaryIndexBits - (i == 0 ? 1 : 0));
+        }
+
+        for (int i = 0; i < 16; i++) {
+            const int* e0 = endpoints[subsets[i] * 2];
+            const int* e1 = endpoints[subsets[i] * 2 + 1];
+            int colorWeight = BC7Weight(mode.IndexBits, indices[i]);
+            int alphaWeight = colorWeight;
+            if (mode.SecondaryIndexBits) {
+                int secondaryWeight = BC7Weight(mode.SecondaryIndexBits, secondary[i]);
+                if (indexSelection) {
+                    alphaWeight = colorWeight;
+                    colorWeight = secondaryWeight;
+                } else {
+                    alphaWeight = secondaryWeight;
+                }
+            }
+
+            uint8_t* pixel = rgba + i * 4;
+            for (int ch = 0; ch < 4; ch++) {
+                int w = ch < 3 ? colorWeight : alphaWeight;
+                pixel[ch] = (uint8_t)(((64 - w) * e0[ch] + w * e1[ch] + 32) >> 6);
+            }
+            if (rotation > 0) {
+                std::swap(pixel[3], pixel[rotation - 1]);
+            }
+        }
+    }
+
+    // Whole images
+
+    void CompressImage(const uint8_t* rgba, uint32_t width, uint32_t height, TextureFormat format, std::vector<uint8_t>& output)
+    {
+        if (format == TextureFormat::RGBA8) {
+            output.assign(rgba, rgba + (size_t)width * height * 4);
+            return;
+        }
+
+        const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const size_t blockBytes = GetBlockBytes(format);
+        output.resize((size_t)blocksX * blocksY * blockBytes);
+
+        JobSystem::ParallelFor(blocksY, 1, [&](uint32_t firstRow, uint32_t lastRow) {
+            uint8_t block[64];
+            for (uint32_t by = firstRow; by < lastRow; by++) {
+                for (uint32_t bx = 0; bx < blocksX; bx++) {
+                    for (uint32_t y = 0; y < 4; y++) {
+                        uint32_t sy = std::min(by * 4 + y, height - 1);
+                        for (uint32_t x = 0; x < 4; x++) {
+                            uint32_t sx = std::min(bx * 4 + x, width - 1);
+                            memcpy(block + (y * 4 + x) * 4, rgba + ((size_t)sy * width + sx) * 4, 4);
+                        }
+                    }
+
+                    uint8_t* out = output.data() + ((size_t)by * blocksX + bx) * blockBytes;
+                    switch (format) {
+                        case TextureFormat::BC1: EncodeBC1Block(block, out); break;
+                        case TextureFormat::BC3: EncodeBC3Block(block, out); break;
+                        case TextureFormat::BC7: EncodeBC7Block(block, out); break;
+                        default: break;
+                    }
+                }
+            }
+        });
+    }
+
+    void DecompressImage(const uint8_t* blocks, uint32_t width, uint32_t height, TextureFormat format, std::vector<uint8_t>& rgba)
+    {
+        rgba.resize((size_t)width * height * 4);
+        if (format == TextureFormat::RGBA8) {
+            memcpy(rgba.data(), blocks, rgba.size());
+            return;
+        }
+
+        const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+        const size_t blockBytes = GetBlockBytes(format);
+
+        JobSystem::ParallelFor(blocksY, 4, [&](uint32_t firstRow, uint32_t lastRow) {
+            uint8_t block[64];
+            for (uint32_t by = firstRow; by < lastRow; by++) {
+                for (uint32_t bx = 0; bx < blocksX; bx++) {
+                    const uint8_t* in = blocks + ((size_t)by * blocksX + bx) * blockBytes;
+                    switch (format) {
+                        case TextureFormat::BC1: DecodeBC1Block(in, block); break;
+                        case TextureFormat::BC3: DecodeBC3Block(in, block); break;
+                        case TextureFormat::BC7: DecodeBC7Block(in, block); break;
+                        default: break;
+                    }
+
+                    for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++) {
+                        uint32_t columns = std::min<uint32_t>(4, width - bx * 4);
+                        memcpy(rgba.data() + ((size_t)(by * 4 + y) * width + bx * 4) * 4, block + y * 16, columns * 4);
+                    }
+                }
+            }
+        });
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    enum class TextureFormat {
+        RGBA8 = 0,
+        BC1,    // 4 bpp, RGB + 1-bit alpha
+        BC3,    // 8 bpp, RGB + interpolated alpha
+        BC7     // 8 bpp, RGBA; the encoder only emits mode 6
+    };
+
+    const char* GetTextureFormatName(TextureFormat format);
+    size_t GetBlockBytes(TextureFormat format); // 0 for RGBA8
+    size_t GetTextureDataSize(TextureFormat format, uint32_t width, uint32_t height);
+
+    // CPU block codecs. Blocks are 4x4 RGBA8 pixels, row by row.
+    void EncodeBC1Block(const uint8_t rgba[64], uint8_t output[8]);
+    void EncodeBC3Block(const uint8_t rgba[64], uint8_t output[16]);
+    void EncodeBC7Block(const uint8_t rgba[64], uint8_t output[16]);
+
+    void DecodeBC1Block(const uint8_t input[8], uint8_t rgba[64]);
+    void DecodeBC3Block(const uint8_t input[16], uint8_t rgba[64]);
+    // Every mode; the reserved mode decodes to transparent black
+    void DecodeBC7Block(const uint8_t input[16], uint8_t rgba[64]);
+
+    // Whole-image helpers. Rows of blocks are spread over the JobSystem workers; edges of images
+    // that are not a multiple of four are padded by repeating the last row/column.
+    void CompressImage(const uint8_t* rgba, uint32_t width, uint32_t height, TextureFormat format, std::vector<uint8_t>& output);
+    void DecompressImage(const uint8_t* blocks, uint32_t width, uint32_t height, TextureFormat format, std::vector<uint8_t>& rgba);
+
+}
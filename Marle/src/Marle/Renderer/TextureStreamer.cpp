@@ -0,0 +1,267 @@
+#include "mrlpch.h"
+#include "TextureStreamer.h"
+#include "../Core/JobSystem.h"
+#include "../Platform/OpenGL/OpenGLTexture.h"
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+namespace Marle {
+
+    // A texture must want less detail for this many frames before its levels are dropped
+    static const uint64_t s_HysteresisFrames = 120;
+    static const uint32_t s_MaxLoadsInFlight = 4;
+    static const size_t s_UploadBytesPerFrame = 8 * 1024 * 1024;
+
+    struct LoadRequest {
+        uint32_t FirstLevel = 0;
+        uint32_t LastLevel = 0;  // Exclusive; the resident mip when the load was issued
+        size_t Bytes = 0;        // GPU size of the levels being loaded
+        std::vector<std::vector<uint8_t>> Levels;
+        bool Succeeded = false;
+        std::atomic<bool> Done{ false };
+    };
+
+    struct StreamEntry {
+        OpenGLTexture2D* Texture = nullptr;
+        uint32_t DesiredMip = 0;
+        uint64_t LastSharpFrame = 0; // Last frame DesiredMip or sharper was asked for
+        std::shared_ptr<LoadRequest> Pending;
+        JobHandle PendingJob;
+        bool Failed = false;         // A load failed; the texture keeps what it has instead of retrying every frame
+    };
+
+    struct TextureStreamer::TextureStreamerData {
+        size_t Budget = 0;
+        uint64_t LastFrame = 0;
+        std::vector<StreamEntry> Entries;
+        Stats FrameStats;
+    };
+
+    std::unique_ptr<TextureStreamer::TextureStreamerData> TextureStreamer::s_Data = nullptr;
+
+    void TextureStreamer::Init(size_t budgetBytes)
+    {
+        s_Data = std::make_unique<TextureStreamerData>();
+        s_Data->Budget = budgetBytes;
+        printf("TextureStreamer initialized (%.0f MB budget)\n", budgetBytes / (1024.0 * 1024.0));
+    }
+
+    void TextureStreamer::Shutdown()
+    {
+        // Loads still in flight own their request; they finish into it and it is freed with them
+        s_Data.reset();
+    }
+
+    bool TextureStreamer::IsInitialized()
+    {
+        return s_Data != nullptr;
+    }
+
+    void TextureStreamer::SetBudget(size_t bytes)
+    {
+        if (s_Data) {
+            s_Data->Budget = bytes;
+        }
+    }
+
+    size_t TextureStreamer::GetBudget()
+    {
+        return s_Data ? s_Data->Budget : 0;
+    }
+
+    TextureStreamer::Stats TextureStreamer::GetStats()
+    {
+        return s_Data ? s_Data->FrameStats : Stats();
+    }
+
+    void TextureStreamer::Register(OpenGLTexture2D* texture)
+    {
+        if (!s_Data) {
+            return;
+        }
+        StreamEntry entry;
+        entry.Texture = texture;
+        entry.DesiredMip = texture->m_ResidentMip;
+        entry.LastSharpFrame = s_Data->LastFrame;
+        s_Data->Entries.push_back(std::move(entry));
+    }
+
+    void TextureStreamer::Unregister(OpenGLTexture2D* texture)
+    {
+        if (!s_Data) {
+            return;
+        }
+        std::vector<StreamEntry>& entries = s_Data->Entries;
+        entries.erase(std::remove_if(entries.begin(), entries.end(),
+                                     [texture](const StreamEntry& e) { return e.Texture == texture; }),
+                      entries.end());
+    }
+
+    void TextureStreamer::Update(uint64_t frame)
+    {
+        if (!s_Data) {
+            return;
+        }
+        TextureStreamerData& data = *s_Data;
+        data.LastFrame = frame;
+        Stats& stats = data.FrameStats;
+
+        // 1. Upload finished loads, a bounded amount per frame
+        size_t uploaded = 0;
+        for (StreamEntry& entry : data.Entries) {
+            if (!entry.Pending || !entry.Pending->Done.load(std::memory_order_acquire) || uploaded >= s_UploadBytesPerFrame) {
+                continue;
+            }
+
+            LoadRequest& request = *entry.Pending;
+            OpenGLTexture2D* texture = entry.Texture;
+            if (request.Succeeded && texture->m_ResidentMip == request.LastLevel) {
+                glBindTexture(GL_TEXTURE_2D, texture->m_RendererID);
+                for (uint32_t level = request.LastLevel; level-- > request.FirstLevel;) {
+                    texture->UploadLevel(level, request.Levels[level]);
+                }
+                texture->SetResidentMip(request.FirstLevel);
+                glBindTexture(GL_TEXTURE_2D, 0);
+
+                stats.LevelsStreamedIn += request.LastLevel - request.FirstLevel;
+                stats.BytesUploaded += request.Bytes;
+                uploaded += request.Bytes;
+            } else if (!request.Succeeded) {
+                printf("Warning: failed to stream mips %u-%u of %s, keeping mip %u\n", request.FirstLevel,
+                       request.LastLevel - 1, texture->m_FilePath.c_str(), texture->m_ResidentMip);
+                entry.Failed = true;
+            }
+            entry.Pending.reset();
+        }
+
+        // 2. Wanted level per texture, with hysteresis before asking for less; drop what is no longer wanted
+        size_t resident = 0, pendingBytes = 0;
+        uint32_t inFlight = 0;
+        for (StreamEntry& entry : data.Entries) {
+            OpenGLTexture2D* texture = entry.Texture;
+            uint32_t requested = texture->m_RequestFrame == frame ? texture->m_RequestedMip : texture->m_TailMip;
+            if (requested <= entry.DesiredMip || frame - entry.LastSharpFrame > s_HysteresisFrames) {
+                entry.DesiredMip = requested;
+                entry.LastSharpFrame = frame;
+            }
+
+            if (entry.Pending) {
+                pendingBytes += entry.Pending->Bytes;
+                inFlight++;
+            } else if (texture->m_ResidentMip < entry.DesiredMip) {
+                stats.LevelsEvicted += entry.DesiredMip - texture->m_ResidentMip;
+                texture->EvictTo(entry.DesiredMip);
+            }
+            resident += texture->m_MemorySize;
+        }
+
+        // 3. Start loads for missing detail: biggest shortfall first, then most recently drawn
+        std::vector<StreamEntry*> candidates;
+        for (StreamEntry& entry : data.Entries) {
+            if (!entry.Pending && !entry.Failed && entry.DesiredMip < entry.Texture->m_ResidentMip) {
+                candidates.push_back(&entry);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const StreamEntry* a, const StreamEntry* b) {
+            uint32_t gapA = a->Texture->m_ResidentMip - a->DesiredMip;
+            uint32_t gapB = b->Texture->m_ResidentMip - b->DesiredMip;
+            if (gapA != gapB) {
+                return gapA > gapB;
+            }
+            return a->Texture->m_RequestFrame > b->Texture->m_RequestFrame;
+        });
+
+        for (StreamEntry* candidate : candidates) {
+            if (inFlight >= s_MaxLoadsInFlight) {
+                break;
+            }
+            OpenGLTexture2D* texture = candidate->Texture;
+
+            uint32_t target = candidate->DesiredMip;
+            size_t need = 0;
+            for (uint32_t level = target; level < texture->m_ResidentMip; level++) {
+                need += texture->GetLevelSize(level);
+            }
+
+            // Make room by taking the top level of the least recently drawn texture, or load fewer levels
+            while (target < texture->m_ResidentMip && resident + pendingBytes + need > data.Budget) {
+                StreamEntry* victim = nullptr;
+                for (StreamEntry& entry : data.Entries) {
+                    OpenGLTexture2D* other = entry.Texture;
+                    if (&entry == candidate || entry.Pending || other->m_RequestFrame >= frame || other->m_ResidentMip >= other->m_TailMip) {
+                        continue;
+                    }
+                    if (!victim || other->m_RequestFrame < victim->Texture->m_RequestFrame) {
+                        victim = &entry;
+                    }
+                }
+
+                if (victim) {
+                    OpenGLTexture2D* other = victim->Texture;
+                    size_t before = other->m_MemorySize;
+                    other->EvictTo(other->m_ResidentMip + 1);
+                    resident -= before - other->m_MemorySize;
+                    victim->DesiredMip = std::max(victim->DesiredMip, other->m_ResidentMip);
+                    victim->LastSharpFrame = frame;
+                    stats.LevelsEvicted++;
+                } else {
+                    need -= texture->GetLevelSize(target);
+                    target++;
+                }
+            }
+            if (target >= texture->m_ResidentMip) {
+                continue;
+            }
+
+            auto request = std::make_shared<LoadRequest>();
+            request->FirstLevel = target;
+            request->LastLevel = texture->m_ResidentMip;
+            request->Bytes = need;
+            candidate->Pending = request;
+            pendingBytes += need;
+            inFlight++;
+
+            std::string path = texture->m_FilePath;
+            candidate->PendingJob = JobSystem::SubmitBackground([request, path]() {
+                OpenGLTexture2D::SourceLevels source;
+                request->Succeeded = OpenGLTexture2D::ReadLevels(path, request->FirstLevel, source) &&
+                                     source.Levels.size() >= request->LastLevel;
+                if (request->Succeeded) {
+                    request->Levels = std::move(source.Levels);
+                }
+                request->Done.store(true, std::memory_order_release);
+            });
+        }
+
+        stats.Textures = (uint32_t)data.Entries.size();
+        stats.PendingLoads = inFlight;
+        stats.ResidentBytes = resident;
+        stats.BudgetBytes = data.Budget;
+    }
+
+    void TextureStreamer::Flush()
+    {
+        if (!s_Data) {
+            return;
+        }
+
+        // A finished load can make room for (or reveal) another one, so repeat until nothing is in flight
+        for (uint32_t pass = 0; pass < 64; pass++) {
+            Update(s_Data->LastFrame);
+
+            bool pending = false;
+            for (StreamEntry& entry : s_Data->Entries) {
+                if (entry.Pending) {
+                    pending = true;
+                    entry.PendingJob.Wait();
+                }
+            }
+            if (!pending) {
+                break;
+            }
+        }
+    }
+
+}
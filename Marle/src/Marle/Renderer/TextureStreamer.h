@@ -0,0 +1,59 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace Marle {
+
+    class OpenGLTexture2D;
+
+    // Decides which mip levels of each texture live on the GPU under one global budget.
+    //
+    // Textures register on load with only their tail resident. Each frame Update() turns the
+    // on-screen sizes reported through the renderer into a wanted level per texture, loads the
+    // missing levels on the JobSystem (the file is re-read, so nothing large stays in system
+    // memory) and uploads them a few megabytes per frame. When a load would go over budget,
+    // levels are taken from the textures drawn least recently; levels a texture has not needed
+    // for a couple of seconds are dropped on their own. A texture whose levels fail to load keeps
+    // the ones it has and is not retried.
+    class TextureStreamer {
+    public:
+        // Levels at or below this size (largest side, in texels) always stay resident
+        static const uint32_t TailSize = 64;
+
+        static void Init(size_t budgetBytes = 256ull * 1024 * 1024);
+        static void Shutdown();
+        static bool IsInitialized();
+
+        static void SetBudget(size_t bytes);
+        static size_t GetBudget();
+
+        // Called by Renderer2D::EndScene with the renderer's frame index
+        static void Update(uint64_t frame);
+        // Waits for every outstanding load and uploads it (loading screens, benchmarks)
+        static void Flush();
+
+        struct Stats {
+            uint32_t Textures = 0;
+            uint32_t PendingLoads = 0;
+            size_t ResidentBytes = 0;
+            size_t BudgetBytes = 0;
+            uint64_t LevelsStreamedIn = 0;
+            uint64_t LevelsEvicted = 0;
+            uint64_t BytesUploaded = 0;
+        };
+        static Stats GetStats();
+
+    private:
+        friend class OpenGLTexture2D;
+
+        static void Register(OpenGLTexture2D* texture);
+        static void Unregister(OpenGLTexture2D* texture);
+
+        struct TextureStreamerData;
+        static std::unique_ptr<TextureStreamerData> s_Data;
+    };
+
+}
@@ -0,0 +1,212 @@
+#include "mrlpch.h"
+#include "Tilemap.h"
+#include "RenderProfiler.h"
+#include "Renderer2D.h"
+#include "../Platform/OpenGL/OpenGLTexture.h"
+#include "../Platform/OpenGL/OpenGLVertexLayout.h"
+
+#include <algorithm>
+
+namespace Marle {
+
+    Tilemap::Tilemap(uint32_t width, uint32_t height, float tileSize,
+                     OpenGLTexture2D* atlas, uint32_t atlasColumns, uint32_t atlasRows)
+        : m_Width(width), m_Height(height),
+          m_ChunksX((width + ChunkSize - 1) / ChunkSize), m_ChunksY((height + ChunkSize - 1) / ChunkSize),
+          m_TileSize(tileSize),
+          m_Atlas(atlas), m_AtlasColumns(std::max<uint32_t>(atlasColumns, 1)), m_AtlasRows(std::max<uint32_t>(atlasRows, 1))
+    {
+        m_ScratchVertices.reserve(ChunkSize * ChunkSize * 4);
+    }
+
+    Tilemap::~Tilemap()
+    {
+        for (Layer& layer : m_Layers) {
+            for (Chunk& chunk : layer.Chunks) {
+                ReleaseChunk(chunk);
+            }
+        }
+    }
+
+    uint32_t Tilemap::AddLayer()
+    {
+        Layer layer;
+        layer.Tiles.assign((size_t)m_Width * m_Height, EmptyTile);
+        layer.Chunks.resize((size_t)m_ChunksX * m_ChunksY);
+        m_Layers.push_back(std::move(layer));
+        return (uint32_t)m_Layers.size() - 1;
+    }
+
+    void Tilemap::SetTile(uint32_t layer, uint32_t x, uint32_t y, uint16_t tile)
+    {
+        if (layer >= m_Layers.size() || x >= m_Width || y >= m_Height) {
+            printf("Warning: Tilemap::SetTile out of range (layer %u, %u, %u)\n", layer, x, y);
+            return;
+        }
+
+        uint16_t& slot = m_Layers[layer].Tiles[(size_t)y * m_Width + x];
+        if (slot != tile) {
+            slot = tile;
+            m_Layers[layer].Chunks[(y / ChunkSize) * m_ChunksX + (x / ChunkSize)].Dirty = true;
+        }
+    }
+
+    uint16_t Tilemap::GetTile(uint32_t layer, uint32_t x, uint32_t y) const
+    {
+        if (layer >= m_Layers.size() || x >= m_Width || y >= m_Height) {
+            return EmptyTile;
+        }
+        return m_Layers[layer].Tiles[(size_t)y * m_Width + x];
+    }
+
+    void Tilemap::Fill(uint32_t layer, uint16_t tile)
+    {
+        if (layer >= m_Layers.size()) {
+            return;
+        }
+        std::fill(m_Layers[layer].Tiles.begin(), m_Layers[layer].Tiles.end(), tile);
+        for (Chunk& chunk : m_Layers[layer].Chunks) {
+            chunk.Dirty = true;
+        }
+    }
+
+    void Tilemap::SetTileAnimation(uint16_t tile, uint16_t frameCount, float framesPerSecond)
+    {
+        if (tile >= m_Animations.size()) {
+            m_Animations.resize((size_t)tile + 1);
+        }
+        m_Animations[tile].FrameCount = std::max<uint16_t>(frameCount, 1);
+        m_Animations[tile].FramesPerSecond = framesPerSecond;
+
+        // Flags only; chunks are rebuilt lazily when they next become visible
+        for (Layer& layer : m_Layers) {
+            for (Chunk& chunk : layer.Chunks) {
+                chunk.Dirty = true;
+            }
+        }
+    }
+
+    void Tilemap::Render()
+    {
+        Renderer2D::DrawTilemap(*this);
+    }
+
+    void Tilemap::BuildChunk(Layer& layer, uint32_t chunkX, uint32_t chunkY, GLuint indexBuffer)
+    {
+        Chunk& chunk = layer.Chunks[chunkY * m_ChunksX + chunkX];
+        chunk.Dirty = false;
+
+        const uint32_t x0 = chunkX * ChunkSize, x1 = std::min(x0 + ChunkSize, m_Width);
+        const uint32_t y0 = chunkY * ChunkSize, y1 = std::min(y0 + ChunkSize, m_Height);
+
+        // Half-texel inset keeps linear filtering from bleeding in neighbouring atlas tiles
+        const float tileU = 1.0f / (float)m_AtlasColumns;
+        const float tileV = 1.0f / (float)m_AtlasRows;
+        const float insetU = (m_Atlas && m_Atlas->GetWidth() > 0) ? 0.5f / (float)m_Atlas->GetWidth() : 0.0f;
+        const float insetV = (m_Atlas && m_Atlas->GetHeight() > 0) ? 0.5f / (float)m_Atlas->GetHeight() : 0.0f;
+
+        m_ScratchVertices.clear();
+        for (uint32_t y = y0; y < y1; y++) {
+            const uint16_t* row = &layer.Tiles[(size_t)y * m_Width];
+            for (uint32_t x = x0; x < x1; x++) {
+                uint16_t tile = row[x];
+                if (tile == EmptyTile) {
+                    continue;
+                }
+
+                // Images are flipped on load, so atlas row 0 (top of the image) sits at v = 1
+                float u0 = (float)(tile % m_AtlasColumns) * tileU + insetU;
+                float u1 = u0 + tileU - 2.0f * insetU;
+                float v1 = 1.0f - (float)(tile / m_AtlasColumns) * tileV - insetV;
+                float v0 = v1 - tileV + 2.0f * insetV;
+
+                glm::vec2 animation(1.0f, 0.0f);
+                if (tile < m_Animations.size()) {
+                    animation = { (float)m_Animations[tile].FrameCount, m_Animations[tile].FramesPerSecond };
+                }
+                uint32_t packedAnimation = PackHalf2(animation);
+
+                float px0 = (float)x * m_TileSize, px1 = px0 + m_TileSize;
+                float py0 = (float)y * m_TileSize, py1 = py0 + m_TileSize;
+                m_ScratchVertices.push_back({ { px0, py0 }, PackUNorm16x2({ u0, v0 }), packedAnimation });
+                m_ScratchVertices.push_back({ { px1, py0 }, PackUNorm16x2({ u1, v0 }), packedAnimation });
+                m_ScratchVertices.push_back({ { px1, py1 }, PackUNorm16x2({ u1, v1 }), packedAnimation });
+                m_ScratchVertices.push_back({ { px0, py1 }, PackUNorm16x2({ u0, v1 }), packedAnimation });
+            }
+        }
+
+        chunk.QuadCount = (uint32_t)(m_ScratchVertices.size() / 4);
+        if (chunk.QuadCount == 0) {
+            ReleaseChunk(chunk);
+            return;
+        }
+
+        if (!chunk.VAO) {
+            glGenVertexArrays(1, &chunk.VAO);
+            glBindVertexArray(chunk.VAO);
+
+            glGenBuffers(1, &chunk.VBO);
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+
+            ApplyVertexLayout(VertexBufferLayout()
+                .AddAt(0, VertexFormat::Float2, offsetof(TileVertex, Position))
+                .AddAt(1, VertexFormat::UNorm16x2, offsetof(TileVertex, TexCoord))
+                .AddAt(2, VertexFormat::Half2, offsetof(TileVertex, Animation))
+                .SetStride(sizeof(TileVertex)));
+
+            m_ResidentChunks++;
+        } else {
+            glBindVertexArray(chunk.VAO);
+            glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+        }
+
+        glBufferData(GL_ARRAY_BUFFER, m_ScratchVertices.size() * sizeof(TileVertex), m_ScratchVertices.data(), GL_STATIC_DRAW);
+        RenderProfiler::CountBufferUpload(m_ScratchVertices.size() * sizeof(TileVertex));
+        m_Stats.RebuiltChunks++;
+    }
+
+    void Tilemap::ReleaseChunk(Chunk& chunk)
+    {
+        if (chunk.VAO) {
+            glDeleteVertexArrays(1, &chunk.VAO);
+            glDeleteBuffers(1, &chunk.VBO);
+            chunk.VAO = 0;
+            chunk.VBO = 0;
+            m_ResidentChunks--;
+        }
+    }
+
+    void Tilemap::EvictChunks(uint64_t frame)
+    {
+        m_Stats.ResidentChunks = m_ResidentChunks;
+        if (m_ResidentChunks <= m_ResidentBudget) {
+            return;
+        }
+
+        // Rare path (camera travelled far): collect resident chunks not drawn this frame, oldest first,
+        // and free down to 90% of the budget so we don't evict again next frame.
+        struct Candidate { uint64_t LastDrawn; Chunk* Target; };
+        std::vector<Candidate> candidates;
+        for (Layer& layer : m_Layers) {
+            for (Chunk& chunk : layer.Chunks) {
+                if (chunk.VAO && chunk.LastDrawnFrame != frame) {
+                    candidates.push_back({ chunk.LastDrawnFrame, &chunk });
+                }
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.LastDrawn < b.LastDrawn; });
+
+        uint32_t target = m_ResidentBudget - m_ResidentBudget / 10;
+        for (const Candidate& candidate : candidates) {
+            if (m_ResidentChunks <= target) {
+                break;
+            }
+            ReleaseChunk(*candidate.Target);
+            candidate.Target->Dirty = true;
+        }
+        m_Stats.ResidentChunks = m_ResidentChunks;
+    }
+
+}
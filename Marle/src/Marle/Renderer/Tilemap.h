@@ -0,0 +1,110 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include <glad/gl.h>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace Marle {
+
+    class OpenGLTexture2D;
+
+    // Large tile grids split into fixed-size chunks. Each chunk's geometry is built once into a
+    // static VBO and only rebuilt when one of its tiles changes, and only chunks overlapping the
+    // camera are touched at all, so per-frame cost depends on the view, not on the map size.
+    class Tilemap {
+    public:
+        static constexpr uint32_t ChunkSize = 32;      // Tiles per chunk side
+        static constexpr uint16_t EmptyTile = 0xFFFF;
+
+        Tilemap(uint32_t width, uint32_t height, float tileSize,
+                OpenGLTexture2D* atlas, uint32_t atlasColumns, uint32_t atlasRows);
+        ~Tilemap();
+
+        Tilemap(const Tilemap&) = delete;
+        Tilemap& operator=(const Tilemap&) = delete;
+
+        // Layers are drawn in creation order, later layers on top
+        uint32_t AddLayer();
+        uint32_t GetLayerCount() const { return (uint32_t)m_Layers.size(); }
+
+        void SetTile(uint32_t layer, uint32_t x, uint32_t y, uint16_t tile);
+        uint16_t GetTile(uint32_t layer, uint32_t x, uint32_t y) const;
+        void Fill(uint32_t layer, uint16_t tile);
+
+        // Tiles [tile, tile + frameCount) must sit next to each other on one atlas row;
+        // the shader steps the UV along that row, so animating costs no rebuilds.
+        void SetTileAnimation(uint16_t tile, uint16_t frameCount, float framesPerSecond);
+
+        // Advances animated tiles
+        void Update(float dt) { m_Time += dt; }
+
+        // Call between Renderer2D::BeginScene/EndScene
+        void Render();
+
+        // Chunk VBOs kept alive while off screen; least recently drawn ones are released past this
+        void SetResidentChunkBudget(uint32_t chunks) { m_ResidentBudget = chunks; }
+
+        uint32_t GetWidth() const { return m_Width; }
+        uint32_t GetHeight() const { return m_Height; }
+        float GetTileSize() const { return m_TileSize; }
+
+        struct Stats {
+            uint32_t VisibleChunks = 0;
+            uint32_t DrawCalls = 0;
+            uint32_t RebuiltChunks = 0;
+            uint32_t ResidentChunks = 0;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        friend class Renderer2D;
+
+        struct TileVertex {
+            glm::vec2 Position;
+            uint32_t TexCoord;  // VertexFormat::UNorm16x2
+            uint32_t Animation; // VertexFormat::Half2: x = frame count, y = frames per second
+        };
+
+        struct Chunk {
+            GLuint VAO = 0;
+            GLuint VBO = 0;
+            uint32_t QuadCount = 0;
+            uint64_t LastDrawnFrame = 0;
+            bool Dirty = true;
+        };
+
+        struct Layer {
+            std::vector<uint16_t> Tiles;
+            std::vector<Chunk> Chunks;
+        };
+
+        struct TileAnimation {
+            uint16_t FrameCount = 1;
+            float FramesPerSecond = 0.0f;
+        };
+
+        void BuildChunk(Layer& layer, uint32_t chunkX, uint32_t chunkY, GLuint indexBuffer);
+        void ReleaseChunk(Chunk& chunk);
+        void EvictChunks(uint64_t frame);
+
+        uint32_t m_Width, m_Height;
+        uint32_t m_ChunksX, m_ChunksY;
+        float m_TileSize;
+
+        OpenGLTexture2D* m_Atlas;
+        uint32_t m_AtlasColumns, m_AtlasRows;
+        std::vector<TileAnimation> m_Animations; // Indexed by tile id, grown on demand
+
+        std::vector<Layer> m_Layers;
+        TaggedVector<TileVertex, MemoryTag::Renderer> m_ScratchVertices;
+
+        float m_Time = 0.0f;
+        uint64_t m_Frame = 0;
+        uint32_t m_ResidentChunks = 0;
+        uint32_t m_ResidentBudget = 4096;
+        Stats m_Stats;
+    };
+
+}
@@ -0,0 +1,564 @@
+#include "mrlpch.h"
+#include "TrueTypeFont.h"
+#include "../Core/FileSystem.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Marle {
+
+    // TrueType data is big-endian
+    static inline uint16_t ReadU16(const uint8_t* p) { return (uint16_t)((p[0] << 8) | p[1]); }
+    static inline int16_t ReadI16(const uint8_t* p) { return (int16_t)ReadU16(p); }
+    static inline uint32_t ReadU32(const uint8_t* p) { return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3]; }
+
+    static const uint32_t s_MaxCompositeDepth = 8;
+    // Components expanded per glyph in total. The depth cap alone still allows a fan-out of
+    // thousands of components at every level, so a crafted font could cost exponential work.
+    static const uint32_t s_MaxCompositeComponents = 256;
+
+    bool TrueTypeFont::LoadFromFile(const std::string& path)
+    {
+        VirtualFile file;
+        if (!FileSystem::Open(path, file)) {
+            printf("Error: Could not open font file %s\n", path.c_str());
+            return false;
+        }
+
+        std::vector<uint8_t> data((size_t)file.GetSize());
+        if (!file.Read(0, data.data(), data.size()) || !LoadFromMemory(std::move(data))) {
+            printf("Error: %s is not a supported TrueType font\n", path.c_str());
+            return false;
+        }
+        return true;
+    }
+
+    bool TrueTypeFont::LoadFromMemory(std::vector<uint8_t> data)
+    {
+        m_Data = std::move(data);
+        m_Glyf = 0;
+        if (m_Data.size() < 12) {
+            return false;
+        }
+
+        // Font collections: use the first face
+        m_FontStart = 0;
+        if (memcmp(m_Data.data(), "ttcf", 4) == 0) {
+            if (m_Data.size() < 16) {
+                return false;
+            }
+            m_FontStart = ReadU32(&m_Data[12]);
+            if ((uint64_t)m_FontStart + 12 > m_Data.size()) {
+                return false;
+            }
+        }
+
+        // Every read below and in the lookups stays inside the table lengths checked here
+        uint32_t headLength, hheaLength, maxpLength, cmapLength, locaLength, hmtxLength;
+        uint32_t head = FindTable("head", headLength);
+        uint32_t hhea = FindTable("hhea", hheaLength);
+        uint32_t maxp = FindTable("maxp", maxpLength);
+        uint32_t cmap = FindTable("cmap", cmapLength);
+        m_Loca = FindTable("loca", locaLength);
+        m_Hmtx = FindTable("hmtx", hmtxLength);
+        uint32_t glyf = FindTable("glyf", m_GlyfLength);
+        if (!head || !hhea || !maxp || !cmap || !m_Loca || !m_Hmtx || !glyf) {
+            return false;
+        }
+        if (headLength < 54 || hheaLength < 36 || maxpLength < 6 || cmapLength < 4) {
+            return false;
+        }
+
+        const uint8_t* d = m_Data.data();
+        m_UnitsPerEm = std::max<uint16_t>(ReadU16(d + head + 18), 1);
+        m_IndexToLocFormat = ReadI16(d + head + 50);
+        m_Ascender = ReadI16(d + hhea + 4);
+        m_Descender = ReadI16(d + hhea + 6);
+        m_LineGap = ReadI16(d + hhea + 8);
+        m_HMetricCount = std::min<uint32_t>(ReadU16(d + hhea + 34), hmtxLength / 4);
+        m_GlyphCount = ReadU16(d + maxp + 4);
+
+        uint64_t locaEntryBytes = m_IndexToLocFormat == 0 ? 2 : 4;
+        if ((m_GlyphCount + 1ull) * locaEntryBytes > locaLength) {
+            return false;
+        }
+
+        // Prefer a full Unicode (format 12) subtable, fall back to the BMP (format 4) one
+        uint32_t cmapEnd = cmap + cmapLength;
+        uint32_t format4 = 0, format12 = 0, format4End = 0, format12End = 0;
+        uint16_t subtableCount = ReadU16(d + cmap + 2);
+        for (uint16_t i = 0; i < subtableCount && 4u + (i + 1u) * 8u <= cmapLength; i++) {
+            const uint8_t* record = d + cmap + 4 + i * 8;
+            uint16_t platform = ReadU16(record);
+            uint16_t encoding = ReadU16(record + 2);
+            uint64_t offset = (uint64_t)cmap + ReadU32(record + 4);
+            if (offset + 16 > cmapEnd) {
+                continue;
+            }
+            bool unicode = platform == 0 || (platform == 3 && (encoding == 1 || encoding == 10));
+            uint16_t format = ReadU16(d + offset);
+            if (unicode && format == 12 && !format12) {
+                uint64_t groupCount = ReadU32(d + offset + 12);
+                if (offset + 16 + groupCount * 12 <= cmapEnd) {
+                    format12 = (uint32_t)offset;
+                    format12End = (uint32_t)(offset + 16 + groupCount * 12);
+                }
+            }
+            if (unicode && format == 4 && !format4) {
+                uint64_t segCount = ReadU16(d + offset + 6) / 2;
+                if (offset + 16 + segCount * 8 <= cmapEnd) {
+                    format4 = (uint32_t)offset;
+                    format4End = cmapEnd; // idRangeOffset may point past the segment arrays
+                }
+            }
+        }
+
+        m_Cmap = format12 ? format12 : format4;
+        m_CmapEnd = format12 ? format12End : format4End;
+        m_CmapFormat = format12 ? 12 : 4;
+        if (!m_Cmap) {
+            return false;
+        }
+
+        m_Glyf = glyf;
+        return true;
+    }
+
+    uint32_t TrueTypeFont::FindTable(const char* tag, uint32_t& length) const
+    {
+        length = 0;
+        const uint8_t* d = m_Data.data();
+        uint16_t tableCount = ReadU16(d + m_FontStart + 4);
+        for (uint16_t i = 0; i < tableCount; i++) {
+            uint64_t record = m_FontStart + 12ull + i * 16ull;
+            if (record + 16 > m_Data.size()) {
+                break;
+            }
+            if (memcmp(d + record, tag, 4) == 0) {
+                uint32_t offset = ReadU32(d + record + 8);
+                length = ReadU32(d + record + 12);
+                if ((uint64_t)offset + length > m_Data.size()) {
+                    length = 0;
+                    return 0;
+                }
+                return offset;
+            }
+        }
+        return 0;
+    }
+
+    uint32_t TrueTypeFont::GetGlyphIndex(uint32_t codepoint) const
+    {
+        if (!IsLoaded()) {
+            return 0;
+        }
+        const uint8_t* d = m_Data.data();
+
+        if (m_CmapFormat == 12) {
+            uint32_t groupCount = ReadU32(d + m_Cmap + 12);
+            uint32_t low = 0, high = groupCount;
+            while (low < high) {
+                uint32_t mid = (low + high) / 2;
+                const uint8_t* group = d + m_Cmap + 16 + mid * 12;
+                uint32_t start = ReadU32(group), end = ReadU32(group + 4);
+                if (codepoint < start) {
+                    high = mid;
+                } else if (codepoint > end) {
+                    low = mid + 1;
+                } else {
+                    return ReadU32(group + 8) + (codepoint - start);
+                }
+            }
+            return 0;
+        }
+
+        if (codepoint > 0xFFFF) {
+            return 0;
+        }
+
+        // Format 4: segments sorted by end code
+        uint32_t segCount = ReadU16(d + m_Cmap + 6) / 2;
+        uint32_t endCodes = m_Cmap + 14;
+        uint32_t startCodes = endCodes + segCount * 2 + 2;
+        uint32_t idDeltas = startCodes + segCount * 2;
+        uint32_t idRangeOffsets = idDeltas + segCount * 2;
+
+        uint32_t low = 0, high = segCount;
+        while (low < high) {
+            uint32_t mid = (low + high) / 2;
+            if (ReadU16(d + endCodes + mid * 2) < codepoint) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        if (low >= segCount) {
+            return 0;
+        }
+
+        uint16_t start = ReadU16(d + startCodes + low * 2);
+        if (codepoint < start) {
+            return 0;
+        }
+        uint16_t delta = ReadU16(d + idDeltas + low * 2);
+        uint16_t rangeOffset = ReadU16(d + idRangeOffsets + low * 2);
+        if (rangeOffset == 0) {
+            return (codepoint + delta) & 0xFFFF;
+        }
+
+        uint64_t glyphAddress = (uint64_t)idRangeOffsets + low * 2 + rangeOffset + (codepoint - start) * 2;
+        if (glyphAddress + 2 > m_CmapEnd) {
+            return 0;
+        }
+        uint16_t glyph = ReadU16(d + glyphAddress);
+        return glyph ? (glyph + delta) & 0xFFFF : 0;
+    }
+
+    uint32_t TrueTypeFont::GetGlyphOffset(uint32_t glyph, uint32_t& length) const
+    {
+        length = 0;
+        if (glyph >= m_GlyphCount) {
+            return 0;
+        }
+
+        const uint8_t* d = m_Data.data();
+        uint32_t start, end;
+        if (m_IndexToLocFormat == 0) {
+            start = ReadU16(d + m_Loca + glyph * 2) * 2u;
+            end = ReadU16(d + m_Loca + glyph * 2 + 2) * 2u;
+        } else {
+            start = ReadU32(d + m_Loca + glyph * 4);
+            end = ReadU32(d + m_Loca + glyph * 4 + 4);
+        }
+
+        if (end <= start || end > m_GlyfLength) {
+            return 0;
+        }
+        length = end - start;
+        return m_Glyf + start;
+    }
+
+    TrueTypeFont::GlyphMetrics TrueTypeFont::GetGlyphMetrics(uint32_t glyph) const
+    {
+        GlyphMetrics metrics;
+        if (!IsLoaded() || m_HMetricCount == 0) {
+            return metrics;
+        }
+
+        const uint8_t* d = m_Data.data();
+        uint32_t metricIndex = std::min(glyph, m_HMetricCount - 1);
+        metrics.Advance = (float)ReadU16(d + m_Hmtx + metricIndex * 4);
+
+        uint32_t length;
+        uint32_t offset = GetGlyphOffset(glyph, length);
+        if (offset && length >= 10) {
+            metrics.XMin = ReadI16(d + offset + 2);
+            metrics.YMin = ReadI16(d + offset + 4);
+            metrics.XMax = ReadI16(d + offset + 6);
+            metrics.YMax = ReadI16(d + offset + 8);
+            metrics.Empty = metrics.XMax <= metrics.XMin || metrics.YMax <= metrics.YMin;
+        }
+        return metrics;
+    }
+
+    void TrueTypeFont::AppendOutline(uint32_t glyph, const float transform[6], std::vector<Point>& points,
+                                     std::vector<uint32_t>& contourEnds, int depth, uint32_t& componentBudget) const
+    {
+        uint32_t length;
+        uint32_t offset = GetGlyphOffset(glyph, length);
+        if (!offset || length < 10) {
+            return;
+        }
+
+        const uint8_t* d = m_Data.data();
+        const uint8_t* end = d + offset + length;
+        int16_t contourCount = ReadI16(d + offset);
+
+        if (contourCount >= 0) {
+            const uint8_t* p = d + offset + 10;
+            if (p + contourCount * 2 + 2 > end) {
+                return;
+            }
+            // Contour end points must increase, or FlattenOutline would walk past the points
+            std::vector<uint16_t> ends(contourCount);
+            for (int16_t i = 0; i < contourCount; i++) {
+                ends[i] = ReadU16(p + i * 2);
+                if (i > 0 && ends[i] <= ends[i - 1]) {
+                    return;
+                }
+            }
+            uint32_t pointCount = contourCount ? ends.back() + 1u : 0u;
+            p += contourCount * 2;
+            p += 2 + ReadU16(p); // Skip instructions
+
+            // Flags, with run-length repeats
+            std::vector<uint8_t> flags(pointCount);
+            for (uint32_t i = 0; i < pointCount && p < end;) {
+                uint8_t flag = *p++;
+                uint32_t repeat = 1;
+                if ((flag & 8) && p < end) {
+                    repeat += *p++;
+                }
+                while (repeat-- && i < pointCount) {
+                    flags[i++] = flag;
+                }
+            }
+
+            // Coordinates are deltas: short (1 byte + sign flag), long (2 bytes) or repeated
+            std::vector<int32_t> xs(pointCount), ys(pointCount);
+            int32_t value = 0;
+            for (uint32_t i = 0; i < pointCount; i++) {
+                uint8_t flag = flags[i];
+                if (flag & 2) {
+                    if (p + 1 > end) {
+                        return;
+                    }
+                    value += (flag & 16) ? *p : -(int32_t)*p;
+                    p += 1;
+                } else if (!(flag & 16)) {
+                    if (p + 2 > end) {
+                        return;
+                    }
+                    value += ReadI16(p);
+                    p += 2;
+                }
+                xs[i] = value;
+            }
+            value = 0;
+            for (uint32_t i = 0; i < pointCount; i++) {
+                uint8_t flag = flags[i];
+                if (flag & 4) {
+                    if (p + 1 > end) {
+                        return;
+                    }
+                    value += (flag & 32) ? *p : -(int32_t)*p;
+                    p += 1;
+                } else if (!(flag & 32)) {
+                    if (p + 2 > end) {
+                        return;
+                    }
+                    value += ReadI16(p);
+                    p += 2;
+                }
+                ys[i] = value;
+            }
+
+            uint32_t base = (uint32_t)points.size();
+            for (uint32_t i = 0; i < pointCount; i++) {
+                float x = (float)xs[i], y = (float)ys[i];
+                points.push_back({ transform[0] * x + transform[2] * y + transform[4],
+                                   transform[1] * x + transform[3] * y + transform[5],
+                                   (flags[i] & 1) != 0 });
+            }
+            for (uint16_t contourEnd : ends) {
+                contourEnds.push_back(base + contourEnd + 1);
+            }
+            return;
+        }
+
+        if (depth >= (int)s_MaxCompositeDepth) {
+            return;
+        }
+
+        // Composite glyph: a list of transformed component glyphs
+        const uint8_t* p = d + offset + 10;
+        uint16_t flags;
+        do {
+            if (p + 4 > end) {
+                return;
+            }
+            if (componentBudget == 0) {
+                return;
+            }
+            componentBudget--;
+            flags = ReadU16(p);
+            uint16_t component = ReadU16(p + 2);
+            p += 4;
+
+            // Offsets, then the optional scale or 2x2 matrix
+            size_t argumentBytes = (flags & 1) ? 4 : 2;
+            argumentBytes += (flags & 8) ? 2 : (flags & 0x40) ? 4 : (flags & 0x80) ? 8 : 0;
+            if (p + argumentBytes > end) {
+                return;
+            }
+
+            float dx, dy;
+            if (flags & 1) {
+                dx = ReadI16(p);
+                dy = ReadI16(p + 2);
+                p += 4;
+            } else {
+                dx = (int8_t)p[0];
+                dy = (int8_t)p[1];
+                p += 2;
+            }
+            if (!(flags & 2)) {
+                dx = dy = 0.0f; // Point-matching placement is not supported
+            }
+
+            float a = 1.0f, b = 0.0f, c = 0.0f, dd = 1.0f;
+            if (flags & 8) {
+                a = dd = ReadI16(p) / 16384.0f;
+                p += 2;
+            } else if (flags & 0x40) {
+                a = ReadI16(p) / 16384.0f;
+                dd = ReadI16(p + 2) / 16384.0f;
+                p += 4;
+            } else if (flags & 0x80) {
+                a = ReadI16(p) / 16384.0f;
+                b = ReadI16(p + 2) / 16384.0f;
+                c = ReadI16(p + 4) / 16384.0f;
+                dd = ReadI16(p + 6) / 16384.0f;
+                p += 8;
+            }
+
+            // Component transform first, then ours
+            float combined[6] = {
+                transform[0] * a + transform[2] * b,
+                transform[1] * a + transform[3] * b,
+                transform[0] * c + transform[2] * dd,
+                transform[1] * c + transform[3] * dd,
+                transform[0] * dx + transform[2] * dy + transform[4],
+                transform[1] * dx + transform[3] * dy + transform[5]
+            };
+            AppendOutline(component, combined, points, contourEnds, depth + 1, componentBudget);
+        } while (flags & 0x20);
+    }
+
+    void TrueTypeFont::FlattenOutline(uint32_t glyph, float scale, float offsetX, float offsetY, std::vector<Edge>& edges) const
+    {
+        std::vector<Point> points;
+        std::vector<uint32_t> contourEnds;
+        const float transform[6] = { scale, 0.0f, 0.0f, scale, offsetX, offsetY };
+        uint32_t componentBudget = s_MaxCompositeComponents;
+        AppendOutline(glyph, transform, points, contourEnds, 0, componentBudget);
+
+        auto addQuadratic = [&edges](float x0, float y0, float cx, float cy, float x1, float y1) {
+            // Enough steps to keep the chord error well under a pixel
+            float deviation = std::fabs(x0 - 2.0f * cx + x1) + std::fabs(y0 - 2.0f * cy + y1);
+            int steps = std::min(std::max((int)std::ceil(std::sqrt(deviation * 2.0f)), 1), 16);
+            float px = x0, py = y0;
+            for (int i = 1; i <= steps; i++) {
+                float t = (float)i / (float)steps, u = 1.0f - t;
+                float x = u * u * x0 + 2.0f * u * t * cx + t * t * x1;
+                float y = u * u * y0 + 2.0f * u * t * cy + t * t * y1;
+                edges.push_back({ px, py, x, y });
+                px = x;
+                py = y;
+            }
+        };
+
+        uint32_t first = 0;
+        for (uint32_t contourEnd : contourEnds) {
+            uint32_t count = contourEnd - first;
+            if (count < 2) {
+                first = contourEnd;
+                continue;
+            }
+            const Point* contour = &points[first];
+
+            // Start on an on-curve point, or the implied midpoint between two off-curve ones
+            uint32_t startIndex = 0;
+            while (startIndex < count && !contour[startIndex].OnCurve) {
+                startIndex++;
+            }
+            float startX, startY;
+            if (startIndex == count) {
+                startIndex = 0;
+                startX = (contour[0].X + contour[count - 1].X) * 0.5f;
+                startY = (contour[0].Y + contour[count - 1].Y) * 0.5f;
+            } else {
+                startX = contour[startIndex].X;
+                startY = contour[startIndex].Y;
+                startIndex++;
+            }
+
+            float penX = startX, penY = startY;
+            bool hasControl = false;
+            float controlX = 0.0f, controlY = 0.0f;
+            for (uint32_t n = 0; n < count; n++) {
+                const Point& point = contour[(startIndex + n) % count];
+                if (point.OnCurve) {
+                    if (hasControl) {
+                        addQuadratic(penX, penY, controlX, controlY, point.X, point.Y);
+                    } else {
+                        edges.push_back({ penX, penY, point.X, point.Y });
+                    }
+                    penX = point.X;
+                    penY = point.Y;
+                    hasControl = false;
+                } else {
+                    if (hasControl) {
+                        float midX = (controlX + point.X) * 0.5f, midY = (controlY + point.Y) * 0.5f;
+                        addQuadratic(penX, penY, controlX, controlY, midX, midY);
+                        penX = midX;
+                        penY = midY;
+                    }
+                    controlX = point.X;
+                    controlY = point.Y;
+                    hasControl = true;
+                }
+            }
+
+            // Close the contour
+            if (hasControl) {
+                addQuadratic(penX, penY, controlX, controlY, startX, startY);
+            } else if (penX != startX || penY != startY) {
+                edges.push_back({ penX, penY, startX, startY });
+            }
+            first = contourEnd;
+        }
+    }
+
+    void TrueTypeFont::RasterizeSDF(uint32_t glyph, float scale, float offsetX, float offsetY, float spread,
+                                    uint32_t width, uint32_t height, uint8_t* output, uint32_t stride) const
+    {
+        std::vector<Edge> edges;
+        FlattenOutline(glyph, scale, offsetX, offsetY, edges);
+
+        struct Crossing { float X; int Direction; };
+        std::vector<Crossing> crossings;
+        const float maxDistanceSq = spread * spread;
+
+        for (uint32_t row = 0; row < height; row++) {
+            float py = (float)row + 0.5f;
+            uint8_t* out = output + row * stride;
+
+            // Non-zero winding per row: crossings to the right of a texel decide inside/outside
+            crossings.clear();
+            for (const Edge& e : edges) {
+                if ((e.Y0 <= py) != (e.Y1 <= py)) {
+                    float t = (py - e.Y0) / (e.Y1 - e.Y0);
+                    crossings.push_back({ e.X0 + t * (e.X1 - e.X0), e.Y1 > e.Y0 ? 1 : -1 });
+                }
+            }
+
+            for (uint32_t column = 0; column < width; column++) {
+                float px = (float)column + 0.5f;
+
+                int winding = 0;
+                for (const Crossing& crossing : crossings) {
+                    if (crossing.X > px) {
+                        winding += crossing.Direction;
+                    }
+                }
+
+                float bestSq = maxDistanceSq;
+                for (const Edge& e : edges) {
+                    float ex = e.X1 - e.X0, ey = e.Y1 - e.Y0;
+                    float wx = px - e.X0, wy = py - e.Y0;
+                    float lengthSq = ex * ex + ey * ey;
+                    float t = lengthSq > 0.0f ? std::min(std::max((wx * ex + wy * ey) / lengthSq, 0.0f), 1.0f) : 0.0f;
+                    float dx = wx - t * ex, dy = wy - t * ey;
+                    bestSq = std::min(bestSq, dx * dx + dy * dy);
+                }
+
+                float distance = std::sqrt(bestSq) / spread;     // 0..1
+                float value = winding != 0 ? 0.5f + 0.5f * distance : 0.5f - 0.5f * distance;
+                out[column] = (uint8_t)std::min(std::max(value * 255.0f + 0.5f, 0.0f), 255.0f);
+            }
+        }
+    }
+
+}
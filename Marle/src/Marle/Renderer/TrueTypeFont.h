@@ -0,0 +1,63 @@
+#pragma once
+
+#include "../Core.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Marle {
+
+    // Minimal TrueType reader: just enough of cmap (formats 4 and 12), hmtx, loca and glyf
+    // (simple and composite glyphs) to lay out text and rasterize glyph outlines.
+    // Hinting, kerning and OpenType/CFF outlines are not supported.
+    class TrueTypeFont {
+    public:
+        struct GlyphMetrics {
+            float Advance = 0.0f;                 // In font units
+            int16_t XMin = 0, YMin = 0, XMax = 0, YMax = 0;
+            bool Empty = true;                    // No outline (e.g. space)
+        };
+
+        bool LoadFromFile(const std::string& path);
+        bool LoadFromMemory(std::vector<uint8_t> data);
+        bool IsLoaded() const { return m_Glyf != 0; }
+        size_t GetDataSize() const { return m_Data.size(); }
+
+        uint32_t GetGlyphIndex(uint32_t codepoint) const;
+        GlyphMetrics GetGlyphMetrics(uint32_t glyph) const;
+
+        float GetUnitsPerEm() const { return (float)m_UnitsPerEm; }
+        float GetAscender() const { return (float)m_Ascender; }
+        float GetDescender() const { return (float)m_Descender; }
+        float GetLineGap() const { return (float)m_LineGap; }
+
+        // Writes a width x height signed distance field of the glyph, rows bottom-up. The glyph
+        // outline is scaled by scale (pixels per font unit) and moved by (offsetX, offsetY) pixels.
+        // Texels on the outline are 128; spread is the distance in pixels mapped to 0 / 255.
+        void RasterizeSDF(uint32_t glyph, float scale, float offsetX, float offsetY, float spread,
+                          uint32_t width, uint32_t height, uint8_t* output, uint32_t stride) const;
+
+    private:
+        struct Edge { float X0, Y0, X1, Y1; };
+        struct Point { float X, Y; bool OnCurve; };
+
+        // Offset of the table, 0 if it is missing or does not fit in the file
+        uint32_t FindTable(const char* tag, uint32_t& length) const;
+        uint32_t GetGlyphOffset(uint32_t glyph, uint32_t& length) const;
+        // Composite components are expanded up to a nesting depth and a total count per glyph
+        void AppendOutline(uint32_t glyph, const float transform[6], std::vector<Point>& points,
+                           std::vector<uint32_t>& contourEnds, int depth, uint32_t& componentBudget) const;
+        void FlattenOutline(uint32_t glyph, float scale, float offsetX, float offsetY, std::vector<Edge>& edges) const;
+
+        std::vector<uint8_t> m_Data;
+        uint32_t m_FontStart = 0;
+        uint32_t m_Cmap = 0, m_CmapFormat = 0, m_CmapEnd = 0;  // The chosen subtable
+        uint32_t m_Loca = 0, m_Glyf = 0, m_Hmtx = 0;
+        uint32_t m_GlyfLength = 0;
+        uint32_t m_GlyphCount = 0, m_HMetricCount = 0;
+        int16_t m_IndexToLocFormat = 0;
+        uint16_t m_UnitsPerEm = 1000;
+        int16_t m_Ascender = 0, m_Descender = 0, m_LineGap = 0;
+    };
+
+}
@@ -0,0 +1,128 @@
+#include "mrlpch.h"
+#include "VertexBufferLayout.h"
+#include "../Core/StringId.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Marle {
+
+    static const VertexFormatInfo s_FormatInfo[(size_t)VertexFormat::Count] = {
+        { 4, 1, false, false },     // Float
+        { 8, 2, false, false },     // Float2
+        { 12, 3, false, false },    // Float3
+        { 16, 4, false, false },    // Float4
+        { 4, 2, false, false },     // Half2
+        { 8, 4, false, false },     // Half4
+        { 4, 2, true, false },      // UNorm16x2
+        { 4, 2, true, false },      // SNorm16x2
+        { 4, 4, true, false },      // UNorm8x4
+        { 4, 4, false, false },     // UByte4
+        { 4, 1, false, true },      // Int
+        { 4, 1, false, true },      // UInt
+        { 4, 4, false, true },      // UInt8x4
+    };
+
+    const VertexFormatInfo& GetVertexFormatInfo(VertexFormat format)
+    {
+        return s_FormatInfo[(size_t)format];
+    }
+
+    VertexBufferLayout& VertexBufferLayout::Add(uint32_t location, VertexFormat format, uint32_t divisor)
+    {
+        uint32_t offset = 0;
+        for (const VertexAttribute& attribute : m_Attributes) {
+            offset = std::max(offset, attribute.Offset + GetVertexFormatInfo(attribute.Format).Size);
+        }
+        return AddAt(location, format, (offset + 3) & ~3u, divisor);
+    }
+
+    VertexBufferLayout& VertexBufferLayout::AddAt(uint32_t location, VertexFormat format, uint32_t offset, uint32_t divisor)
+    {
+        m_Attributes.push_back({ location, format, offset, divisor });
+        if (!m_ExplicitStride) {
+            m_Stride = std::max(m_Stride, (offset + GetVertexFormatInfo(format).Size + 3) & ~3u);
+        }
+        UpdateHash();
+        return *this;
+    }
+
+    VertexBufferLayout& VertexBufferLayout::SetStride(uint32_t stride)
+    {
+        m_Stride = stride;
+        m_ExplicitStride = true;
+        UpdateHash();
+        return *this;
+    }
+
+    void VertexBufferLayout::UpdateHash()
+    {
+        std::vector<uint32_t> words;
+        words.reserve(m_Attributes.size() * 4 + 1);
+        words.push_back(m_Stride);
+        for (const VertexAttribute& attribute : m_Attributes) {
+            words.push_back(attribute.Location);
+            words.push_back((uint32_t)attribute.Format);
+            words.push_back(attribute.Offset);
+            words.push_back(attribute.Divisor);
+        }
+        m_Hash = HashString((const char*)words.data(), words.size() * sizeof(uint32_t));
+    }
+
+    uint16_t PackHalf(float value)
+    {
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        const uint32_t sign = (bits >> 16) & 0x8000;
+        const uint32_t magnitude = bits & 0x7FFFFFFF;
+
+        if (magnitude >= 0x7F800000) {
+            return (uint16_t)(sign | 0x7C00 | (magnitude > 0x7F800000 ? 0x0200 : 0));   // Inf, NaN
+        }
+        if (magnitude >= 0x477FF000) {
+            return (uint16_t)(sign | 0x7BFF);       // Would round past 65504: clamp
+        }
+        if (magnitude < 0x38800000) {
+            // Below the smallest normal half (2^-14): subnormal, in units of 2^-24
+            float scaled = std::fabs(value) * 16777216.0f;
+            return (uint16_t)(sign | (uint32_t)std::nearbyint(scaled));
+        }
+
+        // Rebias the exponent and round the dropped 13 mantissa bits to nearest even; a carry
+        // correctly bumps the exponent
+        uint32_t half = ((magnitude >> 23) - 127 + 15) << 10 | ((magnitude >> 13) & 0x3FF);
+        uint32_t rest = magnitude & 0x1FFF;
+        if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) {
+            half++;
+        }
+        return (uint16_t)(sign | half);
+    }
+
+    float UnpackHalf(uint16_t value)
+    {
+        const uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+        const uint32_t exponent = (value >> 10) & 0x1F;
+        const uint32_t mantissa = value & 0x3FF;
+
+        uint32_t bits;
+        if (exponent == 0) {
+            float magnitude = (float)mantissa / 16777216.0f;
+            memcpy(&bits, &magnitude, sizeof(bits));
+            bits |= sign;
+        } else if (exponent == 31) {
+            bits = sign | 0x7F800000 | (mantissa << 13);
+        } else {
+            bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+        }
+        float result;
+        memcpy(&result, &bits, sizeof(result));
+        return result;
+    }
+
+    uint32_t PackHalf2(const glm::vec2& value)
+    {
+        return (uint32_t)PackHalf(value.x) | ((uint32_t)PackHalf(value.y) << 16);
+    }
+
+}
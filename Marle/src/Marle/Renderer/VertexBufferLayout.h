@@ -0,0 +1,97 @@
+#pragma once
+
+#include "../Core.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    // How one vertex attribute is stored. Normalized formats reach the shader as floats in 0..1
+    // (UNorm) or -1..1 (SNorm); the integer formats reach it as int/uint/uvec4 and need integer
+    // inputs in the shader.
+    enum class VertexFormat : uint8_t {
+        Float = 0,
+        Float2,
+        Float3,
+        Float4,
+        Half2,          // 16-bit floats: 11 bits of precision, exact integers up to 2048
+        Half4,
+        UNorm16x2,      // Texture coordinates within 0..1
+        SNorm16x2,
+        UNorm8x4,       // RGBA8 colour
+        UByte4,         // Small counts read as floats 0..255, unnormalized
+        Int,
+        UInt,
+        UInt8x4,        // Integer indices, e.g. bones or atlas pages
+        Count
+    };
+
+    struct VertexFormatInfo {
+        uint32_t Size;          // Bytes
+        uint32_t Components;
+        bool Normalized;
+        bool Integer;           // Read as int/uint in the shader, not converted to float
+    };
+
+    const VertexFormatInfo& GetVertexFormatInfo(VertexFormat format);
+
+    struct VertexAttribute {
+        uint32_t Location;
+        VertexFormat Format;
+        uint32_t Offset;
+        uint32_t Divisor;       // 0 = per vertex, n = advances every n instances
+    };
+
+    // Attributes read from one vertex buffer. Add() appends each attribute after the previous
+    // one, 4-byte aligned, and grows the stride to match; AddAt() places one at an explicit
+    // offset (a struct member, or a stream within a buffer). SetStride() overrides the computed
+    // stride, e.g. for structure-of-arrays buffers where each stream is tightly packed.
+    //
+    // The hash covers every attribute and the stride; two layouts with the same hash configure a
+    // vertex array identically.
+    class VertexBufferLayout {
+    public:
+        VertexBufferLayout() = default;
+
+        VertexBufferLayout& Add(uint32_t location, VertexFormat format, uint32_t divisor = 0);
+        VertexBufferLayout& AddAt(uint32_t location, VertexFormat format, uint32_t offset, uint32_t divisor = 0);
+        VertexBufferLayout& SetStride(uint32_t stride);
+
+        const std::vector<VertexAttribute>& GetAttributes() const { return m_Attributes; }
+        uint32_t GetStride() const { return m_Stride; }
+        uint64_t GetHash() const { return m_Hash; }
+
+    private:
+        void UpdateHash();
+
+        std::vector<VertexAttribute> m_Attributes;
+        uint32_t m_Stride = 0;
+        bool m_ExplicitStride = false;
+        uint64_t m_Hash = 0;
+    };
+
+    // Packing helpers for building vertices in the formats above. Values outside the format's
+    // range are clamped (saturated for the normalized ones).
+    uint16_t PackHalf(float value);
+    float UnpackHalf(uint16_t value);
+    uint32_t PackHalf2(const glm::vec2& value);
+
+    // Inline: these run per vertex when batches are built
+    inline uint32_t PackUNorm16x2(const glm::vec2& value)
+    {
+        uint32_t x = (uint32_t)(glm::clamp(value.x, 0.0f, 1.0f) * 65535.0f + 0.5f);
+        uint32_t y = (uint32_t)(glm::clamp(value.y, 0.0f, 1.0f) * 65535.0f + 0.5f);
+        return x | (y << 16);
+    }
+
+    inline uint32_t PackUNorm8x4(const glm::vec4& value)
+    {
+        uint32_t r = (uint32_t)(glm::clamp(value.x, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t g = (uint32_t)(glm::clamp(value.y, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t b = (uint32_t)(glm::clamp(value.z, 0.0f, 1.0f) * 255.0f + 0.5f);
+        uint32_t a = (uint32_t)(glm::clamp(value.w, 0.0f, 1.0f) * 255.0f + 0.5f);
+        return r | (g << 8) | (b << 16) | (a << 24);
+    }
+
+}
@@ -0,0 +1,506 @@
+#include "mrlpch.h"
+#include "TransformHierarchy.h"
+#include "../Core/JobSystem.h"
+#include "../Core/SIMD.h"
+#include "../Core/SystemScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+namespace Marle {
+
+    // Dirty trees claimed per atomic increment; most trees are small
+    static const uint32_t s_TreesPerClaim = 16;
+
+    template<typename T, typename Allocator>
+    static void Permute(std::vector<T, Allocator>& values, const std::vector<uint32_t>& order)
+    {
+        std::vector<T, Allocator> sorted(order.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            sorted[i] = values[order[i]];
+        }
+        values.swap(sorted);
+    }
+
+    TransformNode TransformHierarchy::Create(TransformNode parent, const glm::vec2& position, float rotation, const glm::vec2& scale)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (parent != InvalidNode && !IsValid(parent)) {
+            printf("Error: TransformHierarchy::Create with invalid parent %u\n", parent);
+            return InvalidNode;
+        }
+
+        TransformNode node;
+        if (!m_FreeNodes.empty()) {
+            node = m_FreeNodes.back();
+            m_FreeNodes.pop_back();
+        } else {
+            node = (TransformNode)m_Nodes.size();
+            m_Nodes.emplace_back();
+        }
+        m_Nodes[node] = Node();
+        m_Nodes[node].Alive = true;
+        m_LiveCount++;
+
+        Link(node, parent);
+        AppendIndex(node);
+        uint32_t index = m_Nodes[node].Index;
+
+        // A new root is a one-node tree at the end, which keeps the layout sorted
+        if (parent == InvalidNode && !m_LayoutDirty) {
+            m_TreeOf[index] = (uint32_t)m_Trees.size();
+            m_Trees.push_back({ index, index + 1, index + 1 });
+        } else {
+            m_LayoutDirty = true;
+        }
+        SetLocal(node, position, rotation, scale);
+        return node;
+    }
+
+    void TransformHierarchy::Destroy(TransformNode node)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (!IsValid(node)) {
+            return;
+        }
+
+        Unlink(node);
+        std::vector<TransformNode> stack = { node };
+        while (!stack.empty()) {
+            TransformNode current = stack.back();
+            stack.pop_back();
+            for (TransformNode child = m_Nodes[current].FirstChild; child != InvalidNode; child = m_Nodes[child].NextSibling) {
+                stack.push_back(child);
+            }
+            m_Handles[m_Nodes[current].Index] = InvalidNode;
+            m_Nodes[current] = Node();
+            m_FreeNodes.push_back(current);
+            m_LiveCount--;
+        }
+        m_LayoutDirty = true;
+    }
+
+    bool TransformHierarchy::SetParent(TransformNode node, TransformNode parent)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (!IsValid(node) || (parent != InvalidNode && !IsValid(parent))) {
+            printf("Error: TransformHierarchy::SetParent with invalid node\n");
+            return false;
+        }
+        for (TransformNode ancestor = parent; ancestor != InvalidNode; ancestor = m_Nodes[ancestor].Parent) {
+            if (ancestor == node) {
+                printf("Error: TransformHierarchy::SetParent would make node %u its own ancestor\n", node);
+                return false;
+            }
+        }
+        if (m_Nodes[node].Parent == parent) {
+            return true;
+        }
+
+        Unlink(node);
+        Link(node, parent);
+        uint32_t index = m_Nodes[node].Index;
+        m_Parents[index] = parent == InvalidNode ? -1 : (int32_t)m_Nodes[parent].Index;
+        m_Dirty[index] = 1;
+        m_LayoutDirty = true;
+        return true;
+    }
+
+    TransformNode TransformHierarchy::GetParent(TransformNode node) const
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(false);
+        return IsValid(node) ? m_Nodes[node].Parent : InvalidNode;
+    }
+
+    void TransformHierarchy::SetLocal(TransformNode node, const glm::vec2& position, float rotation, const glm::vec2& scale)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (!IsValid(node)) {
+            return;
+        }
+        uint32_t index = m_Nodes[node].Index;
+        m_PositionX[index] = position.x;
+        m_PositionY[index] = position.y;
+        m_Rotation[index] = rotation;
+        m_Cos[index] = std::cos(rotation);
+        m_Sin[index] = std::sin(rotation);
+        m_ScaleX[index] = scale.x;
+        m_ScaleY[index] = scale.y;
+        MarkDirty(index);
+    }
+
+    void TransformHierarchy::SetPosition(TransformNode node, const glm::vec2& position)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (!IsValid(node)) {
+            return;
+        }
+        uint32_t index = m_Nodes[node].Index;
+        m_PositionX[index] = position.x;
+        m_PositionY[index] = position.y;
+        MarkDirty(index);
+    }
+
+    void TransformHierarchy::SetRotation(TransformNode node, float rotation)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (!IsValid(node)) {
+            return;
+        }
+        uint32_t index = m_Nodes[node].Index;
+        m_Rotation[index] = rotation;
+        m_Cos[index] = std::cos(rotation);
+        m_Sin[index] = std::sin(rotation);
+        MarkDirty(index);
+    }
+
+    void TransformHierarchy::SetScale(TransformNode node, const glm::vec2& scale)
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        if (!IsValid(node)) {
+            return;
+        }
+        uint32_t index = m_Nodes[node].Index;
+        m_ScaleX[index] = scale.x;
+        m_ScaleY[index] = scale.y;
+        MarkDirty(index);
+    }
+
+    glm::vec2 TransformHierarchy::GetPosition(TransformNode node) const
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(false);
+        if (!IsValid(node)) {
+            return glm::vec2(0.0f);
+        }
+        uint32_t index = m_Nodes[node].Index;
+        return glm::vec2(m_PositionX[index], m_PositionY[index]);
+    }
+
+    float TransformHierarchy::GetRotation(TransformNode node) const
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(false);
+        return IsValid(node) ? m_Rotation[m_Nodes[node].Index] : 0.0f;
+    }
+
+    glm::vec2 TransformHierarchy::GetScale(TransformNode node) const
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(false);
+        if (!IsValid(node)) {
+            return glm::vec2(1.0f);
+        }
+        uint32_t index = m_Nodes[node].Index;
+        return glm::vec2(m_ScaleX[index], m_ScaleY[index]);
+    }
+
+    Affine2D TransformHierarchy::GetWorld(TransformNode node) const
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(false);
+        Affine2D world;
+        if (IsValid(node)) {
+            uint32_t index = m_Nodes[node].Index;
+            world.A = m_WorldA[index];
+            world.B = m_WorldB[index];
+            world.C = m_WorldC[index];
+            world.D = m_WorldD[index];
+            world.TX = m_WorldTX[index];
+            world.TY = m_WorldTY[index];
+        }
+        return world;
+    }
+
+    glm::vec2 TransformHierarchy::GetWorldPosition(TransformNode node) const
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(false);
+        if (!IsValid(node)) {
+            return glm::vec2(0.0f);
+        }
+        uint32_t index = m_Nodes[node].Index;
+        return glm::vec2(m_WorldTX[index], m_WorldTY[index]);
+    }
+
+    void TransformHierarchy::Update()
+    {
+        SystemScheduler::ValidateAccess<TransformHierarchy>(true);
+        auto start = std::chrono::steady_clock::now();
+        if (m_LayoutDirty) {
+            Relayout();
+            m_LayoutDirty = false;
+        }
+
+        // Trees own disjoint index ranges, so they update independently; threads claim them a
+        // few at a time since their sizes vary
+        const uint32_t dirtyCount = (uint32_t)m_DirtyTrees.size();
+        const uint32_t claims = (dirtyCount + s_TreesPerClaim - 1) / s_TreesPerClaim;
+        const uint32_t slots = std::min(JobSystem::GetWorkerCount() + 1, claims);
+        std::atomic<uint32_t> nextClaim{ 0 };
+        std::atomic<uint32_t> recomputed{ 0 };
+        JobSystem::ParallelFor(slots, 1, [&](uint32_t, uint32_t) {
+            uint32_t count = 0;
+            for (;;) {
+                uint32_t claim = nextClaim.fetch_add(1, std::memory_order_relaxed);
+                if (claim >= claims) {
+                    break;
+                }
+                uint32_t end = std::min((claim + 1) * s_TreesPerClaim, dirtyCount);
+                for (uint32_t i = claim * s_TreesPerClaim; i < end; i++) {
+                    count += UpdateTree(m_Trees[m_DirtyTrees[i]]);
+                }
+            }
+            recomputed.fetch_add(count, std::memory_order_relaxed);
+        });
+
+        m_Stats.Nodes = m_LiveCount;
+        m_Stats.Roots = (uint32_t)m_Trees.size();
+        m_Stats.DirtyRoots = dirtyCount;
+        m_Stats.Recomputed = recomputed.load();
+        m_DirtyTrees.clear();
+        m_Stats.UpdateMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    uint32_t TransformHierarchy::UpdateTree(Tree& tree)
+    {
+        const int32_t* parents = m_Parents.data();
+        uint8_t* dirty = m_Dirty.data();
+        const float* positionX = m_PositionX.data();
+        const float* positionY = m_PositionY.data();
+        const float* cosines = m_Cos.data();
+        const float* sines = m_Sin.data();
+        const float* scaleX = m_ScaleX.data();
+        const float* scaleY = m_ScaleY.data();
+        float* worldA = m_WorldA.data();
+        float* worldB = m_WorldB.data();
+        float* worldC = m_WorldC.data();
+        float* worldD = m_WorldD.data();
+        float* worldTX = m_WorldTX.data();
+        float* worldTY = m_WorldTY.data();
+
+        // Nodes before DirtyBegin are clean and, being earlier, cannot descend from a dirty node
+        uint32_t recomputed = 0;
+        uint32_t index = tree.DirtyBegin;
+        while (index < tree.End) {
+            // Breadth-first order keeps parent indices non-decreasing, so when the fourth node's
+            // parent comes before this group, all four parents are final and the group can be
+            // composed in SIMD. Siblings of leaf-heavy trees mostly take this path.
+            if (index + 4 <= tree.End && parents[index + 3] < (int32_t)index) {
+                float parentA[4], parentB[4], parentC[4], parentD[4], parentTX[4], parentTY[4];
+                uint32_t dirtyLanes = 0;
+                for (uint32_t lane = 0; lane < 4; lane++) {
+                    int32_t parent = parents[index + lane];
+                    uint8_t isDirty = dirty[index + lane] | (parent >= 0 ? dirty[parent] : 0);
+                    dirty[index + lane] = isDirty;
+                    dirtyLanes += isDirty;
+                    parentA[lane] = parent >= 0 ? worldA[parent] : 1.0f;
+                    parentB[lane] = parent >= 0 ? worldB[parent] : 0.0f;
+                    parentC[lane] = parent >= 0 ? worldC[parent] : 0.0f;
+                    parentD[lane] = parent >= 0 ? worldD[parent] : 1.0f;
+                    parentTX[lane] = parent >= 0 ? worldTX[parent] : 0.0f;
+                    parentTY[lane] = parent >= 0 ? worldTY[parent] : 0.0f;
+                }
+                if (dirtyLanes == 0) {
+                    index += 4;
+                    continue;
+                }
+
+                // Clean lanes recompute to the values they already hold
+                SIMD::Float4 c = SIMD::Load(cosines + index);
+                SIMD::Float4 s = SIMD::Load(sines + index);
+                SIMD::Float4 sx = SIMD::Load(scaleX + index);
+                SIMD::Float4 sy = SIMD::Load(scaleY + index);
+                SIMD::Float4 localA = SIMD::Mul(c, sx);
+                SIMD::Float4 localB = SIMD::Mul(s, sx);
+                SIMD::Float4 localC = SIMD::Sub(SIMD::Zero(), SIMD::Mul(s, sy));
+                SIMD::Float4 localD = SIMD::Mul(c, sy);
+                SIMD::Float4 tx = SIMD::Load(positionX + index);
+                SIMD::Float4 ty = SIMD::Load(positionY + index);
+
+                SIMD::Float4 pA = SIMD::Load(parentA), pB = SIMD::Load(parentB);
+                SIMD::Float4 pC = SIMD::Load(parentC), pD = SIMD::Load(parentD);
+                SIMD::Store(worldA + index, SIMD::MulAdd(pC, localB, SIMD::Mul(pA, localA)));
+                SIMD::Store(worldB + index, SIMD::MulAdd(pD, localB, SIMD::Mul(pB, localA)));
+                SIMD::Store(worldC + index, SIMD::MulAdd(pC, localD, SIMD::Mul(pA, localC)));
+                SIMD::Store(worldD + index, SIMD::MulAdd(pD, localD, SIMD::Mul(pB, localC)));
+                SIMD::Store(worldTX + index, SIMD::Add(SIMD::MulAdd(pC, ty, SIMD::Mul(pA, tx)), SIMD::Load(parentTX)));
+                SIMD::Store(worldTY + index, SIMD::Add(SIMD::MulAdd(pD, ty, SIMD::Mul(pB, tx)), SIMD::Load(parentTY)));
+                recomputed += dirtyLanes;
+                index += 4;
+                continue;
+            }
+
+            int32_t parent = parents[index];
+            if (dirty[index] || (parent >= 0 && dirty[parent])) {
+                dirty[index] = 1;
+                Affine2D parentWorld;
+                if (parent >= 0) {
+                    parentWorld.A = worldA[parent];
+                    parentWorld.B = worldB[parent];
+                    parentWorld.C = worldC[parent];
+                    parentWorld.D = worldD[parent];
+                    parentWorld.TX = worldTX[parent];
+                    parentWorld.TY = worldTY[parent];
+                }
+                Affine2D local;
+                local.A = cosines[index] * scaleX[index];
+                local.B = sines[index] * scaleX[index];
+                local.C = -sines[index] * scaleY[index];
+                local.D = cosines[index] * scaleY[index];
+                local.TX = positionX[index];
+                local.TY = positionY[index];
+                Affine2D world = parentWorld * local;
+                worldA[index] = world.A;
+                worldB[index] = world.B;
+                worldC[index] = world.C;
+                worldD[index] = world.D;
+                worldTX[index] = world.TX;
+                worldTY[index] = world.TY;
+                recomputed++;
+            }
+            index++;
+        }
+
+        // Children read their parents' flags during the pass, so clear them only once it is done
+        memset(dirty + tree.DirtyBegin, 0, tree.End - tree.DirtyBegin);
+        tree.DirtyBegin = tree.End;
+        return recomputed;
+    }
+
+    void TransformHierarchy::Link(TransformNode node, TransformNode parent)
+    {
+        Node& entry = m_Nodes[node];
+        entry.Parent = parent;
+        entry.PrevSibling = InvalidNode;
+        entry.NextSibling = InvalidNode;
+        if (parent != InvalidNode) {
+            TransformNode first = m_Nodes[parent].FirstChild;
+            entry.NextSibling = first;
+            if (first != InvalidNode) {
+                m_Nodes[first].PrevSibling = node;
+            }
+            m_Nodes[parent].FirstChild = node;
+        }
+    }
+
+    void TransformHierarchy::Unlink(TransformNode node)
+    {
+        Node& entry = m_Nodes[node];
+        if (entry.PrevSibling != InvalidNode) {
+            m_Nodes[entry.PrevSibling].NextSibling = entry.NextSibling;
+        } else if (entry.Parent != InvalidNode) {
+            m_Nodes[entry.Parent].FirstChild = entry.NextSibling;
+        }
+        if (entry.NextSibling != InvalidNode) {
+            m_Nodes[entry.NextSibling].PrevSibling = entry.PrevSibling;
+        }
+        entry.Parent = InvalidNode;
+        entry.PrevSibling = InvalidNode;
+        entry.NextSibling = InvalidNode;
+    }
+
+    void TransformHierarchy::MarkDirty(uint32_t index)
+    {
+        m_Dirty[index] = 1;
+        if (m_LayoutDirty) {
+            return;     // Relayout() rebuilds the dirty tree list from the flags
+        }
+        uint32_t treeIndex = m_TreeOf[index];
+        Tree& tree = m_Trees[treeIndex];
+        if (tree.DirtyBegin == tree.End) {
+            m_DirtyTrees.push_back(treeIndex);
+        }
+        tree.DirtyBegin = std::min(tree.DirtyBegin, index);
+    }
+
+    void TransformHierarchy::AppendIndex(TransformNode node)
+    {
+        const Node& entry = m_Nodes[node];
+        m_Nodes[node].Index = (uint32_t)m_Handles.size();
+        m_Handles.push_back(node);
+        m_Parents.push_back(entry.Parent == InvalidNode ? -1 : (int32_t)m_Nodes[entry.Parent].Index);
+        m_TreeOf.push_back(0);
+        m_Dirty.push_back(1);
+        m_PositionX.push_back(0.0f);
+        m_PositionY.push_back(0.0f);
+        m_Rotation.push_back(0.0f);
+        m_Cos.push_back(1.0f);
+        m_Sin.push_back(0.0f);
+        m_ScaleX.push_back(1.0f);
+        m_ScaleY.push_back(1.0f);
+        m_WorldA.push_back(1.0f);
+        m_WorldB.push_back(0.0f);
+        m_WorldC.push_back(0.0f);
+        m_WorldD.push_back(1.0f);
+        m_WorldTX.push_back(0.0f);
+        m_WorldTY.push_back(0.0f);
+    }
+
+    void TransformHierarchy::Relayout()
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        // New order: roots in their current order, each followed by its tree breadth-first.
+        // Destroyed slots are dropped.
+        std::vector<uint32_t> order;
+        order.reserve(m_LiveCount);
+        m_Trees.clear();
+        for (uint32_t index = 0; index < (uint32_t)m_Handles.size(); index++) {
+            TransformNode root = m_Handles[index];
+            if (root == InvalidNode || m_Nodes[root].Parent != InvalidNode) {
+                continue;
+            }
+            uint32_t begin = (uint32_t)order.size();
+            order.push_back(index);
+            for (uint32_t i = begin; i < (uint32_t)order.size(); i++) {
+                for (TransformNode child = m_Nodes[m_Handles[order[i]]].FirstChild; child != InvalidNode; child = m_Nodes[child].NextSibling) {
+                    order.push_back(m_Nodes[child].Index);
+                }
+            }
+            uint32_t end = (uint32_t)order.size();
+            m_Trees.push_back({ begin, end, end });
+        }
+
+        Permute(m_Handles, order);
+        Permute(m_Dirty, order);
+        Permute(m_PositionX, order);
+        Permute(m_PositionY, order);
+        Permute(m_Rotation, order);
+        Permute(m_Cos, order);
+        Permute(m_Sin, order);
+        Permute(m_ScaleX, order);
+        Permute(m_ScaleY, order);
+        Permute(m_WorldA, order);
+        Permute(m_WorldB, order);
+        Permute(m_WorldC, order);
+        Permute(m_WorldD, order);
+        Permute(m_WorldTX, order);
+        Permute(m_WorldTY, order);
+
+        const uint32_t count = (uint32_t)order.size();
+        for (uint32_t index = 0; index < count; index++) {
+            m_Nodes[m_Handles[index]].Index = index;
+        }
+        m_Parents.resize(count);
+        m_TreeOf.resize(count);
+        for (uint32_t index = 0; index < count; index++) {
+            TransformNode parent = m_Nodes[m_Handles[index]].Parent;
+            m_Parents[index] = parent == InvalidNode ? -1 : (int32_t)m_Nodes[parent].Index;
+        }
+
+        m_DirtyTrees.clear();
+        for (uint32_t treeIndex = 0; treeIndex < (uint32_t)m_Trees.size(); treeIndex++) {
+            Tree& tree = m_Trees[treeIndex];
+            for (uint32_t index = tree.Begin; index < tree.End; index++) {
+                m_TreeOf[index] = treeIndex;
+                if (m_Dirty[index] && tree.DirtyBegin == tree.End) {
+                    tree.DirtyBegin = index;
+                    m_DirtyTrees.push_back(treeIndex);
+                }
+            }
+        }
+
+        m_Stats.Layouts++;
+        m_Stats.LayoutMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/MemoryTracker.h"
+#include "../Animation/Pose.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Marle {
+
+    typedef uint32_t TransformNode;
+
+    // Parent-relative 2D transforms for attached objects (weapons on characters, turrets on
+    // vehicles, UI panels in windows) and their world transforms.
+    //
+    // Nodes live in flat structure-of-arrays storage. Every root's tree is one contiguous range,
+    // ordered breadth-first, so parents always come before their children. Setting a local
+    // transform only flags that node; the flag reaches its descendants lazily, during Update().
+    // Update() walks each changed tree once, from its first dirty node, and recomputes the world
+    // transforms of dirty nodes and their subtrees only. Runs of nodes whose parents all lie
+    // earlier are composed four at a time in SIMD, and separate trees update in parallel on the
+    // JobSystem.
+    //
+    // Creating a root keeps the layout; creating a child, reparenting or destroying re-sorts the
+    // arrays at the next Update(), in one O(n) pass.
+    class TransformHierarchy {
+    public:
+        static constexpr TransformNode InvalidNode = ~0u;
+
+        TransformHierarchy() = default;
+        TransformHierarchy(const TransformHierarchy&) = delete;
+        TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+        // The local transform is relative to the parent, or to the world for roots
+        TransformNode Create(TransformNode parent = InvalidNode, const glm::vec2& position = glm::vec2(0.0f),
+                             float rotation = 0.0f, const glm::vec2& scale = glm::vec2(1.0f));
+        // Destroys the node and all of its descendants
+        void Destroy(TransformNode node);
+        // Keeps the local transform, so the node moves with its new parent. InvalidNode makes it
+        // a root. Fails when parent is the node itself or one of its descendants.
+        bool SetParent(TransformNode node, TransformNode parent);
+        TransformNode GetParent(TransformNode node) const;
+        bool IsValid(TransformNode node) const { return node < m_Nodes.size() && m_Nodes[node].Alive; }
+
+        void SetLocal(TransformNode node, const glm::vec2& position, float rotation, const glm::vec2& scale);
+        void SetPosition(TransformNode node, const glm::vec2& position);
+        void SetRotation(TransformNode node, float rotation);   // Radians, counter-clockwise
+        void SetScale(TransformNode node, const glm::vec2& scale);
+        glm::vec2 GetPosition(TransformNode node) const;
+        float GetRotation(TransformNode node) const;
+        glm::vec2 GetScale(TransformNode node) const;
+
+        // Recomputes the world transforms of every node changed since the last call, and of
+        // their descendants
+        void Update();
+
+        // As of the last Update()
+        Affine2D GetWorld(TransformNode node) const;
+        glm::vec2 GetWorldPosition(TransformNode node) const;
+
+        uint32_t GetNodeCount() const { return m_LiveCount; }
+
+        struct Stats {
+            uint32_t Nodes = 0;
+            uint32_t Roots = 0;
+            uint32_t DirtyRoots = 0;        // Trees with a change, updated last Update
+            uint32_t Recomputed = 0;        // World transforms that changed last Update
+            uint32_t Layouts = 0;           // Re-sorts so far
+            double LayoutMs = 0.0;
+            double UpdateMs = 0.0;
+        };
+        const Stats& GetStats() const { return m_Stats; }
+
+    private:
+        // Stable per-handle record; the hierarchy links are kept here so re-sorting can rebuild
+        // the flat order without searching
+        struct Node {
+            bool Alive = false;
+            uint32_t Index = 0;                 // Into the flat arrays
+            TransformNode Parent = InvalidNode;
+            TransformNode FirstChild = InvalidNode;
+            TransformNode NextSibling = InvalidNode;
+            TransformNode PrevSibling = InvalidNode;
+        };
+
+        // One root and its descendants: flat indices [Begin, End)
+        struct Tree {
+            uint32_t Begin = 0;
+            uint32_t End = 0;
+            uint32_t DirtyBegin = 0;            // First dirty index, End when clean
+        };
+
+        void Link(TransformNode node, TransformNode parent);
+        void Unlink(TransformNode node);
+        void MarkDirty(uint32_t index);
+        void Relayout();
+        uint32_t UpdateTree(Tree& tree);
+        void AppendIndex(TransformNode node);
+
+        std::vector<Node> m_Nodes;
+        std::vector<TransformNode> m_FreeNodes;
+        uint32_t m_LiveCount = 0;
+
+        // Flat arrays, parent before child; InvalidNode in m_Handles marks a destroyed slot
+        // until the next re-sort
+        TaggedVector<TransformNode, MemoryTag::Game> m_Handles;
+        TaggedVector<int32_t, MemoryTag::Game> m_Parents;       // Flat index, -1 for roots
+        TaggedVector<uint32_t, MemoryTag::Game> m_TreeOf;
+        TaggedVector<uint8_t, MemoryTag::Game> m_Dirty;
+        TaggedVector<float, MemoryTag::Game> m_PositionX, m_PositionY;
+        TaggedVector<float, MemoryTag::Game> m_Rotation, m_Cos, m_Sin;
+        TaggedVector<float, MemoryTag::Game> m_ScaleX, m_ScaleY;
+        // World transforms, one array per Affine2D member
+        TaggedVector<float, MemoryTag::Game> m_WorldA, m_WorldB, m_WorldC, m_WorldD, m_WorldTX, m_WorldTY;
+
+        std::vector<Tree> m_Trees;
+        std::vector<uint32_t> m_DirtyTrees;
+        bool m_LayoutDirty = false;
+        Stats m_Stats;
+    };
+
+}
@@ -0,0 +1,749 @@
+#include "mrlpch.h"
+#include "WorldStreamer.h"
+#include "../Core/FileSystem.h"
+#include "../Core/Metrics.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/stat.h>
+#endif
+
+namespace Marle {
+
+    // On-disk layout. A chunk file is the header, EntityCount WorldEntity records, then AssetCount
+    // NUL-terminated paths (StringBytes in total). The manifest is its header and ChunkCount entries.
+    struct WorldChunkFileHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        int32_t X, Y;
+        uint32_t EntityCount;
+        uint32_t AssetCount;
+        uint32_t StringBytes;
+        uint32_t Reserved;
+    };
+
+    struct WorldManifestHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        float ChunkSize;
+        uint32_t ChunkCount;
+    };
+
+    static const uint32_t s_ChunkMagic = 0x434C524D;       // "MRLC" in memory order
+    static const uint32_t s_ManifestMagic = 0x574C524D;    // "MRLW"
+    static const uint32_t s_WorldFormatVersion = 1;
+    static const char* s_ManifestName = "world.manifest";
+
+    static_assert(sizeof(WorldEntity) == 40, "WorldEntity is stored on disk as-is");
+    static_assert(sizeof(WorldManifestEntry) == 32, "WorldManifestEntry is stored on disk as-is");
+
+    // Upper bounds of the load latency buckets, shared with the marle_world_chunk_load_ms histogram
+    static const double s_LatencyBoundsMs[] = { 5.0, 10.0, 20.0, 50.0, 100.0, 200.0, 500.0, 1000.0, 2000.0, 5000.0 };
+
+    static MetricId s_LoadMsMetric = Metrics::InvalidMetric;
+    static MetricId s_HitchesMetric = Metrics::InvalidMetric;
+    static MetricId s_ChunksLoadedMetric = Metrics::InvalidMetric;
+    static MetricId s_ResidentBytesMetric = Metrics::InvalidMetric;
+    static MetricId s_ActiveChunksMetric = Metrics::InvalidMetric;
+
+    static uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static double ToMs(uint64_t ns)
+    {
+        return (double)ns / 1000000.0;
+    }
+
+    static std::string GetChunkPath(const std::string& directory, const glm::ivec2& coord)
+    {
+        char name[48];
+        snprintf(name, sizeof(name), "/%d_%d.chunk", coord.x, coord.y);
+        return directory + name;
+    }
+
+    // Distance from a point to the square chunk `coord` covers; 0 inside it
+    static float DistanceToChunk(const glm::vec2& point, const glm::ivec2& coord, float chunkSize)
+    {
+        float minX = coord.x * chunkSize, minY = coord.y * chunkSize;
+        float dx = std::max(std::max(minX - point.x, point.x - (minX + chunkSize)), 0.0f);
+        float dy = std::max(std::max(minY - point.y, point.y - (minY + chunkSize)), 0.0f);
+        return std::sqrt(dx * dx + dy * dy);
+    }
+
+    // Runs on the JobSystem
+    static bool ReadChunkFile(const std::string& path, const glm::ivec2& coord, WorldChunkData& data)
+    {
+        VirtualFile file;
+        if (!FileSystem::Open(path, file)) {
+            printf("Error: Could not open world chunk %s\n", path.c_str());
+            return false;
+        }
+
+        WorldChunkFileHeader header;
+        bool ok = file.Read(0, &header, sizeof(header));
+        if (ok && (header.Magic != s_ChunkMagic || header.Version != s_WorldFormatVersion)) {
+            printf("Error: %s is not a compatible world chunk (format %u)\n", path.c_str(), header.Version);
+            return false;
+        }
+        if (ok && (header.X != coord.x || header.Y != coord.y)) {
+            printf("Error: World chunk %s holds chunk (%d, %d)\n", path.c_str(), header.X, header.Y);
+            return false;
+        }
+
+        std::string strings;
+        uint64_t entityBytes = ok ? (uint64_t)header.EntityCount * sizeof(WorldEntity) : 0;
+        ok = ok && entityBytes + header.StringBytes <= file.GetSize() - sizeof(header);
+        if (ok) {
+            data.Coord = coord;
+            data.Entities.resize(header.EntityCount);
+            strings.resize(header.StringBytes);
+            ok = file.Read(sizeof(header), data.Entities.data(), (size_t)entityBytes) &&
+                 file.Read(sizeof(header) + entityBytes, &strings[0], header.StringBytes);
+        }
+        if (!ok) {
+            printf("Error: World chunk %s is truncated\n", path.c_str());
+            return false;
+        }
+
+        size_t offset = 0;
+        data.Assets.reserve(header.AssetCount);
+        for (uint32_t i = 0; i < header.AssetCount; i++) {
+            size_t end = strings.find('\0', offset);
+            if (end == std::string::npos) {
+                printf("Error: World chunk %s has a malformed asset list\n", path.c_str());
+                return false;
+            }
+            data.Assets.emplace_back(strings, offset, end - offset);
+            offset = end + 1;
+        }
+        for (const WorldEntity& entity : data.Entities) {
+            if (entity.Asset != WorldEntity::NoAsset && entity.Asset >= header.AssetCount) {
+                printf("Error: World chunk %s has an entity using asset %u of %u\n", path.c_str(), entity.Asset, header.AssetCount);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    size_t WorldChunkData::GetMemoryBytes() const
+    {
+        size_t bytes = sizeof(WorldChunk) + Entities.size() * sizeof(WorldEntity);
+        for (const std::string& asset : Assets) {
+            bytes += sizeof(std::string) + asset.size() + 1 + sizeof(ResourceHandle<OpenGLTexture2D>);
+        }
+        return bytes;
+    }
+
+    WorldWriter::WorldWriter(const std::string& directory, float chunkSize)
+        : m_Directory(directory), m_ChunkSize(chunkSize)
+    {
+#if defined(__unix__) || defined(__APPLE__)
+        mkdir(directory.c_str(), 0755);
+#endif
+    }
+
+    bool WorldWriter::AddChunk(const WorldChunkData& chunk)
+    {
+        std::string path = GetChunkPath(m_Directory, chunk.Coord);
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            printf("Error: Could not open %s for writing\n", path.c_str());
+            return false;
+        }
+
+        std::string strings;
+        for (const std::string& asset : chunk.Assets) {
+            strings.append(asset.c_str(), asset.size() + 1);
+        }
+
+        WorldChunkFileHeader header = {};
+        header.Magic = s_ChunkMagic;
+        header.Version = s_WorldFormatVersion;
+        header.X = chunk.Coord.x;
+        header.Y = chunk.Coord.y;
+        header.EntityCount = (uint32_t)chunk.Entities.size();
+        header.AssetCount = (uint32_t)chunk.Assets.size();
+        header.StringBytes = (uint32_t)strings.size();
+
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(chunk.Entities.data(), sizeof(WorldEntity), chunk.Entities.size(), file) == chunk.Entities.size() &&
+                  fwrite(strings.data(), 1, strings.size(), file) == strings.size();
+        ok = fclose(file) == 0 && ok;
+        if (!ok) {
+            printf("Error: Failed to write world chunk %s\n", path.c_str());
+            return false;
+        }
+
+        WorldManifestEntry entry;
+        entry.Coord = chunk.Coord;
+        entry.EntityCount = header.EntityCount;
+        entry.AssetCount = header.AssetCount;
+        entry.FileBytes = sizeof(header) + chunk.Entities.size() * sizeof(WorldEntity) + strings.size();
+        entry.MemoryBytes = chunk.GetMemoryBytes();
+        m_Entries.push_back(entry);
+        return true;
+    }
+
+    bool WorldWriter::Finish()
+    {
+        std::string path = m_Directory + "/" + s_ManifestName;
+        FILE* file = fopen(path.c_str(), "wb");
+        if (!file) {
+            printf("Error: Could not open %s for writing\n", path.c_str());
+            return false;
+        }
+
+        WorldManifestHeader header = { s_ManifestMagic, s_WorldFormatVersion, m_ChunkSize, (uint32_t)m_Entries.size() };
+        bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                  fwrite(m_Entries.data(), sizeof(WorldManifestEntry), m_Entries.size(), file) == m_Entries.size();
+        ok = fclose(file) == 0 && ok;
+        if (!ok) {
+            printf("Error: Failed to write world manifest %s\n", path.c_str());
+        }
+        return ok;
+    }
+
+    struct WorldStreamer::LoadRequest {
+        std::string Path;
+        glm::ivec2 Coord = glm::ivec2(0);
+        WorldChunkData Data;
+        bool Succeeded = false;
+    };
+
+    WorldStreamer::~WorldStreamer()
+    {
+        Close();
+    }
+
+    bool WorldStreamer::Open(const std::string& directory, const WorldStreamerSettings& settings)
+    {
+        Close();
+
+        std::string path = directory + "/" + s_ManifestName;
+        VirtualFile file;
+        if (!FileSystem::Open(path, file)) {
+            printf("Error: Could not open world manifest %s\n", path.c_str());
+            return false;
+        }
+
+        WorldManifestHeader header;
+        bool ok = file.Read(0, &header, sizeof(header));
+        if (ok && (header.Magic != s_ManifestMagic || header.Version != s_WorldFormatVersion || !(header.ChunkSize > 0.0f))) {
+            printf("Error: %s is not a compatible world manifest (format %u)\n", path.c_str(), header.Version);
+            return false;
+        }
+        ok = ok && (uint64_t)header.ChunkCount * sizeof(WorldManifestEntry) <= file.GetSize() - sizeof(header);
+        if (ok) {
+            m_Manifest.resize(header.ChunkCount);
+            ok = file.Read(sizeof(header), m_Manifest.data(), m_Manifest.size() * sizeof(WorldManifestEntry));
+        }
+        if (!ok) {
+            printf("Error: World manifest %s is truncated\n", path.c_str());
+            m_Manifest.clear();
+            return false;
+        }
+
+        m_ManifestIndex.reserve(m_Manifest.size());
+        for (uint32_t i = 0; i < (uint32_t)m_Manifest.size(); i++) {
+            m_ManifestIndex[ChunkKey(m_Manifest[i].Coord)] = i;
+        }
+        m_Directory = directory;
+        m_ChunkSize = header.ChunkSize;
+        m_Settings = settings;
+        m_Stats = Stats();
+        m_Stats.KnownChunks = (uint32_t)m_ManifestIndex.size();
+
+        s_LoadMsMetric = Metrics::RegisterHistogram("marle_world_chunk_load_ms", "World chunk request to activation",
+                                                    s_LatencyBoundsMs, (uint32_t)(sizeof(s_LatencyBoundsMs) / sizeof(double)));
+        s_HitchesMetric = Metrics::RegisterCounter("marle_world_hitches_total", "Required world chunks not active in time");
+        s_ChunksLoadedMetric = Metrics::RegisterCounter("marle_world_chunks_loaded_total", "World chunks activated");
+        s_ResidentBytesMetric = Metrics::RegisterGauge("marle_world_resident_bytes", "World chunk data resident or loading");
+        s_ActiveChunksMetric = Metrics::RegisterGauge("marle_world_active_chunks", "World chunks active");
+        return true;
+    }
+
+    void WorldStreamer::Close()
+    {
+        for (std::unique_ptr<LiveChunk>& live : m_Live) {
+            if (live->State == ChunkState::Loading) {
+                live->Job.Wait();
+            } else if (live->ActivatedEntities > 0 && m_Deactivate) {
+                m_Deactivate(live->Chunk);
+            }
+        }
+        for (std::pair<JobHandle, size_t>& abandoned : m_Abandoned) {
+            abandoned.first.Wait();
+        }
+
+        m_Live.clear();
+        m_LiveIndex.clear();
+        m_Abandoned.clear();
+        m_ActiveChunks.clear();
+        m_MissingSince.clear();
+        m_Manifest.clear();
+        m_ManifestIndex.clear();
+        m_ResidentBytes = 0;
+        m_HasFocus = false;
+        m_Velocity = glm::vec2(0.0f);
+        m_ChunkSize = 0.0f;
+        RefreshStats();
+    }
+
+    void WorldStreamer::SetCallbacks(ActivateFunc activate, DeactivateFunc deactivate)
+    {
+        m_Activate = std::move(activate);
+        m_Deactivate = std::move(deactivate);
+    }
+
+    glm::ivec2 WorldStreamer::WorldToChunk(const glm::vec2& position) const
+    {
+        return glm::ivec2((int)std::floor(position.x / m_ChunkSize), (int)std::floor(position.y / m_ChunkSize));
+    }
+
+    bool WorldStreamer::IsActive(const glm::ivec2& coord) const
+    {
+        auto it = m_LiveIndex.find(ChunkKey(coord));
+        return it != m_LiveIndex.end() && m_Live[it->second]->State == ChunkState::Active;
+    }
+
+    void WorldStreamer::Update(const glm::vec2& focus, float dt)
+    {
+        if (!IsOpen()) {
+            return;
+        }
+        uint64_t start = NowNs();
+        m_Frame++;
+
+        UpdateVelocity(focus, dt);
+        FinishLoads();
+        SelectChunks(start, false);
+        ActivateChunks(start, false);
+        TrackHitches(NowNs());
+        RefreshStats();
+
+        m_Stats.UpdateMs = ToMs(NowNs() - start);
+        m_Stats.MaxUpdateMs = std::max(m_Stats.MaxUpdateMs, m_Stats.UpdateMs);
+        Metrics::SetGauge(s_ResidentBytesMetric, (double)m_ResidentBytes);
+        Metrics::SetGauge(s_ActiveChunksMetric, (double)m_ActiveChunks.size());
+    }
+
+    void WorldStreamer::RefreshStats()
+    {
+        m_ActiveChunks.clear();
+        uint32_t loading = 0, pending = 0;
+        for (const std::unique_ptr<LiveChunk>& live : m_Live) {
+            if (live->State == ChunkState::Active) {
+                m_ActiveChunks.push_back(&live->Chunk);
+            } else if (live->State == ChunkState::Loading) {
+                loading++;
+            } else if (live->State == ChunkState::Ready) {
+                pending++;
+            }
+        }
+        m_Stats.ActiveChunks = (uint32_t)m_ActiveChunks.size();
+        m_Stats.LoadingChunks = loading;
+        m_Stats.PendingActivation = pending;
+        m_Stats.ResidentBytes = m_ResidentBytes;
+        m_Stats.PeakResidentBytes = std::max(m_Stats.PeakResidentBytes, m_ResidentBytes);
+        m_Stats.BudgetBytes = m_Settings.MemoryBudgetBytes;
+        m_Stats.Velocity = m_Velocity;
+    }
+
+    void WorldStreamer::Preload(const glm::vec2& focus)
+    {
+        if (!IsOpen()) {
+            return;
+        }
+        m_Focus = focus;
+        m_Velocity = glm::vec2(0.0f);
+        m_HasFocus = true;
+
+        for (;;) {
+            uint64_t now = NowNs();
+            FinishLoads();
+            SelectChunks(now, true);
+            ActivateChunks(now, true);
+
+            bool pending = false;
+            for (const std::unique_ptr<LiveChunk>& live : m_Live) {
+                pending |= live->State == ChunkState::Loading || live->State == ChunkState::Ready;
+            }
+            if (!pending) {
+                break;
+            }
+            // Help the workers instead of idling
+            if (!JobSystem::RunPendingJob()) {
+                std::this_thread::yield();
+            }
+        }
+        // What was missing before the preload is not the player's problem
+        m_MissingSince.clear();
+        RefreshStats();
+    }
+
+    void WorldStreamer::UpdateVelocity(const glm::vec2& focus, float dt)
+    {
+        if (!m_HasFocus) {
+            m_Focus = focus;
+            m_HasFocus = true;
+            return;
+        }
+
+        glm::vec2 moved = focus - m_Focus;
+        m_Focus = focus;
+        if (glm::length(moved) > m_Settings.UnloadRadius) {
+            // A teleport, not movement: predicting along it would load the wrong way
+            m_Velocity = glm::vec2(0.0f);
+        } else if (dt > 0.0f) {
+            float blend = 1.0f - std::exp(-dt / 0.2f);
+            m_Velocity += (moved / dt - m_Velocity) * blend;
+        }
+    }
+
+    void WorldStreamer::FinishLoads()
+    {
+        for (std::unique_ptr<LiveChunk>& livePtr : m_Live) {
+            LiveChunk& live = *livePtr;
+            if (live.State != ChunkState::Loading || !live.Job.IsDone()) {
+                continue;
+            }
+
+            std::shared_ptr<LoadRequest> load = std::move(live.Load);
+            live.Job = JobHandle();
+            if (!load->Succeeded) {
+                live.State = ChunkState::Failed;
+                m_ResidentBytes -= live.Bytes;
+                live.Bytes = 0;
+                m_Stats.LoadFailures++;
+                continue;
+            }
+
+            live.Chunk.Data = std::move(load->Data);
+            size_t bytes = live.Chunk.Data.GetMemoryBytes();
+            m_ResidentBytes = m_ResidentBytes - live.Bytes + bytes;
+            live.Bytes = bytes;
+
+            // Textures decode while the chunk waits for its activation turn
+            live.Chunk.Textures.clear();
+            live.Chunk.Textures.reserve(live.Chunk.Data.Assets.size());
+            for (const std::string& asset : live.Chunk.Data.Assets) {
+                live.Chunk.Textures.push_back(ResourceManager::IsInitialized() ? ResourceManager::LoadAsync<OpenGLTexture2D>(asset)
+                                                                               : ResourceHandle<OpenGLTexture2D>());
+            }
+            live.State = ChunkState::Ready;
+        }
+
+        // Unloaded while loading: their memory is only free once the read is over
+        for (size_t i = 0; i < m_Abandoned.size();) {
+            if (m_Abandoned[i].first.IsDone()) {
+                m_ResidentBytes -= m_Abandoned[i].second;
+                m_Abandoned[i] = std::move(m_Abandoned.back());
+                m_Abandoned.pop_back();
+            } else {
+                i++;
+            }
+        }
+    }
+
+    float WorldStreamer::MeasureChunk(const glm::ivec2& coord, float& offPath) const
+    {
+        float step = m_PathSamples.size() > 1 ? glm::length(m_PathSamples[1] - m_PathSamples[0]) : 0.0f;
+        float best = 3.4e38f;
+        offPath = 3.4e38f;
+        for (size_t i = 0; i < m_PathSamples.size(); i++) {
+            float distance = DistanceToChunk(m_PathSamples[i], coord, m_ChunkSize);
+            offPath = std::min(offPath, distance);
+            best = std::min(best, step * (float)i + distance);
+        }
+        return best;
+    }
+
+    void WorldStreamer::SelectChunks(uint64_t now, bool unthrottled)
+    {
+        // Where the camera will be over the look-ahead window, sampled every half chunk
+        glm::vec2 ahead = m_Velocity * m_Settings.LookAheadSeconds;
+        uint32_t samples = 1 + std::min((uint32_t)std::ceil(glm::length(ahead) / (m_ChunkSize * 0.5f)), 64u);
+        m_PathSamples.resize(samples);
+        for (uint32_t i = 0; i < samples; i++) {
+            m_PathSamples[i] = m_Focus + ahead * (samples > 1 ? (float)i / (float)(samples - 1) : 0.0f);
+        }
+
+        for (std::unique_ptr<LiveChunk>& live : m_Live) {
+            float offPath;
+            live->PathDistance = MeasureChunk(m_Manifest[live->Entry].Coord, offPath);
+            live->Wanted = offPath <= m_Settings.LoadRadius;
+        }
+
+        // Every chunk within LoadRadius of the path that is not live yet
+        glm::vec2 low = m_Focus, high = m_Focus;
+        for (const glm::vec2& sample : m_PathSamples) {
+            low = glm::min(low, sample);
+            high = glm::max(high, sample);
+        }
+        glm::ivec2 first = WorldToChunk(low - glm::vec2(m_Settings.LoadRadius));
+        glm::ivec2 last = WorldToChunk(high + glm::vec2(m_Settings.LoadRadius));
+        m_Candidates.clear();
+        for (int y = first.y; y <= last.y; y++) {
+            for (int x = first.x; x <= last.x; x++) {
+                uint64_t key = ChunkKey(glm::ivec2(x, y));
+                auto entry = m_ManifestIndex.find(key);
+                if (entry == m_ManifestIndex.end() || m_LiveIndex.count(key)) {
+                    continue;
+                }
+                float offPath;
+                float pathDistance = MeasureChunk(glm::ivec2(x, y), offPath);
+                if (offPath <= m_Settings.LoadRadius) {
+                    m_Candidates.push_back({ pathDistance, entry->second });
+                }
+            }
+        }
+
+        // Swap-removal only moves chunks that were already looked at
+        for (size_t i = m_Live.size(); i-- > 0;) {
+            if (!m_Live[i]->Wanted) {
+                float offPath;
+                MeasureChunk(m_Manifest[m_Live[i]->Entry].Coord, offPath);
+                if (offPath > m_Settings.UnloadRadius) {
+                    Unload((uint32_t)i);
+                }
+            }
+        }
+
+        std::sort(m_Candidates.begin(), m_Candidates.end());
+        uint32_t inFlight = 0;
+        for (const std::unique_ptr<LiveChunk>& live : m_Live) {
+            inFlight += live->State == ChunkState::Loading ? 1 : 0;
+        }
+        for (const std::pair<float, uint32_t>& candidate : m_Candidates) {
+            if (!unthrottled && inFlight >= m_Settings.MaxLoadsInFlight) {
+                break;
+            }
+            if (!MakeRoom((size_t)m_Manifest[candidate.second].MemoryBytes, candidate.first)) {
+                m_Stats.BudgetDeferrals++;
+                break;
+            }
+            StartLoad(candidate.second, now);
+            inFlight++;
+        }
+    }
+
+    bool WorldStreamer::MakeRoom(size_t bytes, float pathDistance)
+    {
+        if (bytes > m_Settings.MemoryBudgetBytes) {
+            return false;
+        }
+        while (m_ResidentBytes + bytes > m_Settings.MemoryBudgetBytes) {
+            // Chunks nobody wants first, then the ones the camera reaches last. Loads in flight
+            // stay: dropping them frees nothing until their read finishes.
+            int32_t victim = -1;
+            for (uint32_t i = 0; i < (uint32_t)m_Live.size(); i++) {
+                const LiveChunk& live = *m_Live[i];
+                if (live.State == ChunkState::Loading) {
+                    continue;
+                }
+                if (victim < 0) {
+                    victim = (int32_t)i;
+                    continue;
+                }
+                const LiveChunk& best = *m_Live[victim];
+                if ((!live.Wanted && best.Wanted) || (live.Wanted == best.Wanted && live.PathDistance > best.PathDistance)) {
+                    victim = (int32_t)i;
+                }
+            }
+            if (victim < 0 || (m_Live[victim]->Wanted && m_Live[victim]->PathDistance <= pathDistance)) {
+                return false;
+            }
+            Unload((uint32_t)victim);
+        }
+        return true;
+    }
+
+    void WorldStreamer::StartLoad(uint32_t entry, uint64_t now)
+    {
+        const WorldManifestEntry& manifest = m_Manifest[entry];
+        std::unique_ptr<LiveChunk> live = std::make_unique<LiveChunk>();
+        live->Entry = entry;
+        live->State = ChunkState::Loading;
+        live->Bytes = (size_t)manifest.MemoryBytes;
+        live->RequestedNs = now;
+        live->Wanted = true;
+
+        std::shared_ptr<LoadRequest> load = std::make_shared<LoadRequest>();
+        load->Path = GetChunkPath(m_Directory, manifest.Coord);
+        load->Coord = manifest.Coord;
+        live->Load = load;
+        live->Job = JobSystem::SubmitBackground([load]() {
+            load->Succeeded = ReadChunkFile(load->Path, load->Coord, load->Data);
+        });
+
+        m_ResidentBytes += live->Bytes;
+        m_LiveIndex[ChunkKey(manifest.Coord)] = (uint32_t)m_Live.size();
+        m_Live.push_back(std::move(live));
+    }
+
+    void WorldStreamer::ActivateChunks(uint64_t now, bool unthrottled)
+    {
+        // Nearest along the path first
+        std::vector<LiveChunk*> ready;
+        for (std::unique_ptr<LiveChunk>& live : m_Live) {
+            if (live->State == ChunkState::Ready) {
+                ready.push_back(live.get());
+            }
+        }
+        std::sort(ready.begin(), ready.end(), [](const LiveChunk* a, const LiveChunk* b) { return a->PathDistance < b->PathDistance; });
+
+        uint64_t budgetNs = (uint64_t)(m_Settings.ActivationBudgetMs * 1000000.0);
+        uint32_t batch = std::max(m_Settings.ActivationBatch, 1u);
+        bool activated = false;
+        for (LiveChunk* live : ready) {
+            uint32_t entityCount = (uint32_t)live->Chunk.Data.Entities.size();
+            // A chunk already in view finishes now: a long frame is better than a hole
+            bool required = DistanceToChunk(m_Focus, m_Manifest[live->Entry].Coord, m_ChunkSize) <= m_Settings.RequiredRadius;
+            while (live->ActivatedEntities < entityCount) {
+                // Every frame activates at least one batch, however long the frame already was
+                if (!unthrottled && !required && activated && NowNs() - now >= budgetNs) {
+                    return;
+                }
+                uint32_t count = std::min(batch, entityCount - live->ActivatedEntities);
+                if (m_Activate) {
+                    m_Activate(live->Chunk, live->ActivatedEntities, count);
+                }
+                live->ActivatedEntities += count;
+                activated = true;
+            }
+
+            live->State = ChunkState::Active;
+            m_Stats.ChunksLoaded++;
+            m_Stats.ForcedActivations += required && !unthrottled ? 1 : 0;
+            Metrics::Increment(s_ChunksLoadedMetric);
+            RecordLoadLatency(ToMs(NowNs() - live->RequestedNs));
+        }
+    }
+
+    void WorldStreamer::TrackHitches(uint64_t now)
+    {
+        // Chunks the player should be seeing that are not there
+        glm::ivec2 first = WorldToChunk(m_Focus - glm::vec2(m_Settings.RequiredRadius));
+        glm::ivec2 last = WorldToChunk(m_Focus + glm::vec2(m_Settings.RequiredRadius));
+        bool missing = false;
+        for (int y = first.y; y <= last.y; y++) {
+            for (int x = first.x; x <= last.x; x++) {
+                glm::ivec2 coord(x, y);
+                uint64_t key = ChunkKey(coord);
+                if (!m_ManifestIndex.count(key) || DistanceToChunk(m_Focus, coord, m_ChunkSize) > m_Settings.RequiredRadius) {
+                    continue;
+                }
+                auto live = m_LiveIndex.find(key);
+                if (live != m_LiveIndex.end() && (m_Live[live->second]->State == ChunkState::Active ||
+                                                  m_Live[live->second]->State == ChunkState::Failed)) {
+                    continue;
+                }
+                missing = true;
+                if (m_MissingSince.emplace(key, now).second) {
+                    m_Stats.Hitches++;
+                    Metrics::Increment(s_HitchesMetric);
+                }
+            }
+        }
+        m_Stats.HitchFrames += missing ? 1 : 0;
+
+        // Hitches that ended: the chunk arrived, or the camera moved on without it
+        for (auto it = m_MissingSince.begin(); it != m_MissingSince.end();) {
+            glm::ivec2 coord((int32_t)(uint32_t)(it->first >> 32), (int32_t)(uint32_t)it->first);
+            auto live = m_LiveIndex.find(it->first);
+            bool arrived = live != m_LiveIndex.end() && m_Live[live->second]->State != ChunkState::Loading &&
+                           m_Live[live->second]->State != ChunkState::Ready;
+            if (!arrived && DistanceToChunk(m_Focus, coord, m_ChunkSize) <= m_Settings.RequiredRadius) {
+                ++it;
+                continue;
+            }
+
+            HitchRecord record = { coord, ToMs(now - it->second), glm::length(m_Velocity), m_Frame };
+            m_Stats.MaxHitchMs = std::max(m_Stats.MaxHitchMs, record.WaitMs);
+            const uint32_t keep = 32;
+            if (m_Hitches.size() < keep) {
+                m_Hitches.push_back(record);
+            } else {
+                m_Hitches[m_NextHitch] = record;
+            }
+            m_NextHitch = (m_NextHitch + 1) % keep;
+            it = m_MissingSince.erase(it);
+        }
+    }
+
+    void WorldStreamer::Unload(uint32_t index)
+    {
+        LiveChunk& live = *m_Live[index];
+        if (live.State == ChunkState::Loading) {
+            m_Abandoned.push_back({ live.Job, live.Bytes });
+        } else {
+            if (live.ActivatedEntities > 0 && m_Deactivate) {
+                m_Deactivate(live.Chunk);
+            }
+            m_ResidentBytes -= live.Bytes;
+        }
+        m_Stats.ChunksUnloaded++;
+
+        m_LiveIndex.erase(ChunkKey(m_Manifest[live.Entry].Coord));
+        if (index + 1 != m_Live.size()) {
+            m_Live[index] = std::move(m_Live.back());
+            m_LiveIndex[ChunkKey(m_Manifest[m_Live[index]->Entry].Coord)] = index;
+        }
+        m_Live.pop_back();
+    }
+
+    void WorldStreamer::RecordLoadLatency(double ms)
+    {
+        uint32_t bucket = 0;
+        while (bucket < LatencyBuckets && ms > s_LatencyBoundsMs[bucket]) {
+            bucket++;
+        }
+        m_LatencyHistogram[bucket]++;
+        m_TotalLoadMs += ms;
+        m_Stats.AverageLoadMs = m_TotalLoadMs / (double)m_Stats.ChunksLoaded;
+        m_Stats.MaxLoadMs = std::max(m_Stats.MaxLoadMs, ms);
+        Metrics::Observe(s_LoadMsMetric, ms);
+    }
+
+    void WorldStreamer::PrintReport() const
+    {
+        const Stats& stats = m_Stats;
+        printf("WorldStreamer: %u of %u chunks active, %u loading, %u waiting to activate, %.1f / %.1f MB (peak %.1f)\n",
+               stats.ActiveChunks, stats.KnownChunks, stats.LoadingChunks, stats.PendingActivation, stats.ResidentBytes / (1024.0 * 1024.0),
+               stats.BudgetBytes / (1024.0 * 1024.0), stats.PeakResidentBytes / (1024.0 * 1024.0));
+        printf("  %llu loaded, %llu unloaded, %llu failed, %llu budget deferrals, update %.3f ms (max %.3f), speed %.0f units/s\n",
+               (unsigned long long)stats.ChunksLoaded, (unsigned long long)stats.ChunksUnloaded, (unsigned long long)stats.LoadFailures,
+               (unsigned long long)stats.BudgetDeferrals, stats.UpdateMs, stats.MaxUpdateMs, glm::length(stats.Velocity));
+
+        printf("  load latency: avg %.1f ms, max %.1f ms\n", stats.AverageLoadMs, stats.MaxLoadMs);
+        for (uint32_t bucket = 0; bucket <= LatencyBuckets; bucket++) {
+            if (m_LatencyHistogram[bucket] == 0) {
+                continue;
+            }
+            if (bucket < LatencyBuckets) {
+                printf("    <= %6.0f ms  %llu\n", s_LatencyBoundsMs[bucket], (unsigned long long)m_LatencyHistogram[bucket]);
+            } else {
+                printf("     > %6.0f ms  %llu\n", s_LatencyBoundsMs[LatencyBuckets - 1], (unsigned long long)m_LatencyHistogram[bucket]);
+            }
+        }
+
+        printf("  hitches: %llu (%llu frames), longest %.1f ms; %llu chunks activated past the budget\n", (unsigned long long)stats.Hitches,
+               (unsigned long long)stats.HitchFrames, stats.MaxHitchMs, (unsigned long long)stats.ForcedActivations);
+        for (size_t i = 0; i < m_Hitches.size(); i++) {
+            // Oldest first
+            const HitchRecord& hitch = m_Hitches[(m_NextHitch + i) % m_Hitches.size()];
+            printf("    frame %llu  chunk (%d, %d)  missing %.1f ms at %.0f units/s\n", (unsigned long long)hitch.Frame, hitch.Coord.x,
+                   hitch.Coord.y, hitch.WaitMs, hitch.Speed);
+        }
+    }
+
+}
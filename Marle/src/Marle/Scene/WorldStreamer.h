@@ -0,0 +1,245 @@
+#pragma once
+
+#include "../Core.h"
+#include "../Core/JobSystem.h"
+#include "../Core/MemoryTracker.h"
+#include "../Core/ResourceManager.h"
+#include "../Core/StringId.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Marle {
+
+    class OpenGLTexture2D;
+
+    // One placed object of a chunk, stored on disk as-is. What Type and Variant mean is up to the game.
+    struct WorldEntity {
+        static const uint32_t NoAsset = ~0u;
+
+        StringId Type;
+        glm::vec2 Position = glm::vec2(0.0f);  // World units
+        glm::vec2 Scale = glm::vec2(1.0f);
+        float Rotation = 0.0f;
+        uint32_t Asset = NoAsset;               // Index into the chunk's asset list
+        uint32_t Variant = 0;
+        uint32_t Flags = 0;
+    };
+
+    // What a chunk file holds: the entities placed in it and the assets they use
+    struct WorldChunkData {
+        glm::ivec2 Coord = glm::ivec2(0);
+        TaggedVector<WorldEntity, MemoryTag::World> Entities;
+        std::vector<std::string> Assets;        // Texture paths
+
+        size_t GetMemoryBytes() const;
+    };
+
+    // One chunk as listed in a world manifest on disk
+    struct WorldManifestEntry {
+        glm::ivec2 Coord = glm::ivec2(0);
+        uint32_t EntityCount = 0;
+        uint32_t AssetCount = 0;
+        uint64_t FileBytes = 0;
+        uint64_t MemoryBytes = 0;               // WorldChunkData::GetMemoryBytes once loaded
+    };
+
+    // A chunk as handed to the game. Textures parallels Data.Assets; they load asynchronously
+    // through ResourceManager, so a handle may still resolve to nullptr when entities activate.
+    struct WorldChunk {
+        WorldChunkData Data;
+        std::vector<ResourceHandle<OpenGLTexture2D>> Textures;
+    };
+
+    // Writes a streamed world: one file per chunk plus the manifest listing them, with the sizes
+    // the streamer plans its memory budget from. For tools and generated worlds.
+    class WorldWriter {
+    public:
+        // Creates the directory if needed
+        WorldWriter(const std::string& directory, float chunkSize);
+
+        // Writes the chunk's file and records it for the manifest
+        bool AddChunk(const WorldChunkData& chunk);
+        // Writes the manifest; chunks added before it are what WorldStreamer::Open will see
+        bool Finish();
+
+    private:
+        std::string m_Directory;
+        float m_ChunkSize;
+        std::vector<WorldManifestEntry> m_Entries;
+    };
+
+    struct WorldStreamerSettings {
+        float LoadRadius = 1024.0f;         // World units
+        float UnloadRadius = 1536.0f;       // Beyond LoadRadius, so chunks at the edge do not flicker
+        float RequiredRadius = 512.0f;      // Roughly what is on screen
+        float LookAheadSeconds = 1.5f;
+        size_t MemoryBudgetBytes = 64ull * 1024 * 1024;
+        uint32_t MaxLoadsInFlight = 4;
+        double ActivationBudgetMs = 1.0;
+        uint32_t ActivationBatch = 64;      // Entities per activate callback
+    };
+
+    // Keeps the part of a large world around the camera loaded, so levels need not fit in memory.
+    //
+    // The world is a grid of square chunks, each a file with an entity and an asset manifest; a
+    // world manifest lists the chunks that exist and how much memory each needs. Update() looks
+    // at the camera's focus and its smoothed velocity, and wants every chunk within LoadRadius of
+    // the path the camera will cover in the next LookAheadSeconds, nearest along that path first.
+    // Files are read and deserialized on the JobSystem, a few at a time. A loaded chunk requests
+    // its textures, then activates: the game's callback gets its entities in batches, for at most
+    // ActivationBudgetMs per frame, except that a chunk already within RequiredRadius finishes in
+    // the frame it gets its turn. Chunks further than UnloadRadius from the camera and its path
+    // are deactivated and dropped.
+    //
+    // Chunk data stays under MemoryBudgetBytes: a load that does not fit evicts the chunks
+    // furthest along the path, and waits if only nearer ones are left. The manifest itself costs
+    // a few dozen bytes per chunk. Textures count against the ResourceManager budgets instead.
+    //
+    // A chunk within RequiredRadius of the camera that is not active yet is a hitch: the player
+    // can see the hole, because it was requested too late or its read is slow. Hitches and the
+    // request-to-active latency of every chunk are in GetStats() and PrintReport(), and in the
+    // metrics (marle_world_*).
+    //
+    // Main thread only.
+    class WorldStreamer {
+    public:
+        typedef std::function<void(const WorldChunk& chunk, uint32_t firstEntity, uint32_t count)> ActivateFunc;
+        // Called for chunks that activated at least one entity, before their data is freed
+        typedef std::function<void(const WorldChunk& chunk)> DeactivateFunc;
+
+        WorldStreamer() = default;
+        ~WorldStreamer();
+
+        WorldStreamer(const WorldStreamer&) = delete;
+        WorldStreamer& operator=(const WorldStreamer&) = delete;
+
+        // directory is a FileSystem path, so a world may also be read from a mounted archive
+        bool Open(const std::string& directory, const WorldStreamerSettings& settings = WorldStreamerSettings());
+        // Deactivates every chunk and waits for loads in flight
+        void Close();
+        bool IsOpen() const { return m_ChunkSize > 0.0f; }
+
+        void SetCallbacks(ActivateFunc activate, DeactivateFunc deactivate);
+        void SetSettings(const WorldStreamerSettings& settings) { m_Settings = settings; }
+        const WorldStreamerSettings& GetSettings() const { return m_Settings; }
+
+        // Once per rendered frame with the world point at the center of the view
+        void Update(const glm::vec2& focus, float dt);
+        // Loads and activates everything within LoadRadius of `focus` before returning, ignoring
+        // the throttles: for spawning and teleports behind a loading screen
+        void Preload(const glm::vec2& focus);
+
+        glm::ivec2 WorldToChunk(const glm::vec2& position) const;
+        float GetChunkSize() const { return m_ChunkSize; }
+        bool IsActive(const glm::ivec2& coord) const;
+        // Fully activated chunks, valid until the next Update
+        const std::vector<const WorldChunk*>& GetActiveChunks() const { return m_ActiveChunks; }
+
+        struct Stats {
+            uint32_t KnownChunks = 0;           // In the manifest
+            uint32_t ActiveChunks = 0;
+            uint32_t LoadingChunks = 0;
+            uint32_t PendingActivation = 0;     // Loaded, entities not all activated yet
+            size_t ResidentBytes = 0;           // Chunk data, including loads in flight
+            size_t PeakResidentBytes = 0;
+            size_t BudgetBytes = 0;
+            uint64_t ChunksLoaded = 0;
+            uint64_t ChunksUnloaded = 0;
+            uint64_t LoadFailures = 0;
+            uint64_t BudgetDeferrals = 0;       // Loads that waited because nearer chunks filled the budget
+            double AverageLoadMs = 0.0;         // Request to active
+            double MaxLoadMs = 0.0;
+            uint64_t Hitches = 0;               // Required chunks that were not active in time
+            uint64_t HitchFrames = 0;           // Frames with at least one of them
+            double MaxHitchMs = 0.0;            // Longest a required chunk stayed missing
+            uint64_t ForcedActivations = 0;     // Chunks already in view at their turn, activated past the budget
+            double UpdateMs = 0.0;              // Last Update, activation callbacks included
+            double MaxUpdateMs = 0.0;
+            glm::vec2 Velocity = glm::vec2(0.0f);
+        };
+        const Stats& GetStats() const { return m_Stats; }
+        // Latency distribution and the most recent hitches
+        void PrintReport() const;
+
+    private:
+        enum class ChunkState : uint8_t {
+            Loading,        // File read in flight
+            Ready,          // Loaded, waiting for its activation turn
+            Active,         // Every entity handed to the game
+            Failed          // Unreadable; kept so it is not retried until the camera leaves
+        };
+
+        struct LoadRequest;
+
+        struct LiveChunk {
+            uint32_t Entry = 0;                 // Into m_Manifest
+            ChunkState State = ChunkState::Loading;
+            std::shared_ptr<LoadRequest> Load;
+            JobHandle Job;
+            WorldChunk Chunk;
+            uint32_t ActivatedEntities = 0;
+            size_t Bytes = 0;                   // Manifest estimate until loaded
+            float PathDistance = 0.0f;          // This frame; how soon the camera gets there
+            bool Wanted = false;
+            uint64_t RequestedNs = 0;
+        };
+
+        struct HitchRecord {
+            glm::ivec2 Coord;
+            double WaitMs;
+            float Speed;
+            uint64_t Frame;
+        };
+
+        static uint64_t ChunkKey(const glm::ivec2& coord) { return ((uint64_t)(uint32_t)coord.x << 32) | (uint32_t)coord.y; }
+
+        void UpdateVelocity(const glm::vec2& focus, float dt);
+        void FinishLoads();
+        // Distance the camera travels (along its predicted path, then straight off it) to reach
+        // the chunk, and the chunk's distance from the path itself
+        float MeasureChunk(const glm::ivec2& coord, float& offPath) const;
+        void SelectChunks(uint64_t now, bool unthrottled);
+        bool MakeRoom(size_t bytes, float pathDistance);
+        void StartLoad(uint32_t entry, uint64_t now);
+        void ActivateChunks(uint64_t now, bool unthrottled);
+        void TrackHitches(uint64_t now);
+        void Unload(uint32_t live);
+        void RecordLoadLatency(double ms);
+        void RefreshStats();
+
+        std::string m_Directory;
+        float m_ChunkSize = 0.0f;
+        WorldStreamerSettings m_Settings;
+        ActivateFunc m_Activate;
+        DeactivateFunc m_Deactivate;
+
+        std::vector<WorldManifestEntry> m_Manifest;
+        std::unordered_map<uint64_t, uint32_t> m_ManifestIndex;        // Chunk key to manifest entry
+        std::vector<std::unique_ptr<LiveChunk>> m_Live;
+        std::unordered_map<uint64_t, uint32_t> m_LiveIndex;            // Chunk key to m_Live slot, rebuilt on removal
+        std::vector<std::pair<JobHandle, size_t>> m_Abandoned;         // Loads unloaded mid-flight, with their bytes, until the job ends
+        std::vector<const WorldChunk*> m_ActiveChunks;
+        std::unordered_map<uint64_t, uint64_t> m_MissingSince;         // Required chunks not active yet, since when
+
+        glm::vec2 m_Focus = glm::vec2(0.0f);
+        glm::vec2 m_Velocity = glm::vec2(0.0f);
+        bool m_HasFocus = false;
+        std::vector<glm::vec2> m_PathSamples;
+        std::vector<std::pair<float, uint32_t>> m_Candidates;          // Path distance, manifest entry
+        uint64_t m_Frame = 0;
+        size_t m_ResidentBytes = 0;
+
+        static const uint32_t LatencyBuckets = 10;
+        uint64_t m_LatencyHistogram[LatencyBuckets + 1] = {};
+        double m_TotalLoadMs = 0.0;
+        std::vector<HitchRecord> m_Hitches;                             // Ring of the latest
+        uint32_t m_NextHitch = 0;
+        Stats m_Stats;
+    };
+
+}
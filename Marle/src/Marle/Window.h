@@ -8,11 +8,13 @@ namespace Marle {
         const char* Title;
         unsigned int Width;
         unsigned int Height;
+        bool Headless;      // No window or GL context; only fixed updates run (dedicated servers)
 
         WindowProps(const char* title = "Marle Engine",
                     unsigned int width = 1280,
-                    unsigned int height = 720)
-            : Title(title), Width(width), Height(height) {}
+                    unsigned int height = 720,
+                    bool headless = false)
+            : Title(title), Width(width), Height(height), Headless(headless) {}
     };
 
 } 
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "Bench.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+
+namespace MarleBench {
+
+    double NowSeconds()
+    {
+        using Clock = std::chrono::steady_clock;
+        return std::chrono::duration<double>(Clock::now().time_since_epoch()).count();
+    }
+
+    bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& outBytes)
+    {
+        FILE* file = std::fopen(path.c_str(), "rb");
+        if (!file) {
+            return false;
+        }
+        std::fseek(file, 0, SEEK_END);
+        long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        outBytes.resize(size > 0 ? (size_t)size : 0);
+        size_t read = outBytes.empty() ? 0 : std::fread(outBytes.data(), 1, outBytes.size(), file);
+        std::fclose(file);
+        return read == outBytes.size();
+    }
+
+    BenchState::BenchState(const BenchConfig& config)
+        : m_Config(config)
+    {
+        m_Samples.reserve(config.MeasuredIterations);
+    }
+
+    bool BenchState::Run()
+    {
+        double now = NowSeconds();
+
+        if (!m_Started) {
+            m_Started = true;
+            m_IterationStart = now;
+            return !m_Skipped;
+        }
+
+        if (m_Skipped) {
+            return false;
+        }
+
+        double elapsed = now - m_IterationStart - m_PausedTotal;
+        m_PausedTotal = 0.0;
+
+        if (m_Completed >= m_Config.WarmupIterations) {
+            m_Samples.push_back(elapsed * 1e9);
+            m_MeasuredSeconds += elapsed;
+        }
+        m_Completed++;
+
+        // Hard cap so a MinIterationSeconds floor on a nanosecond benchmark can't run away
+        const uint32_t maxSamples = std::max<uint32_t>(m_Config.MeasuredIterations, 1) * 100;
+        bool needMore = m_Samples.size() < m_Config.MeasuredIterations ||
+                        (m_MeasuredSeconds < m_Config.MinIterationSeconds && m_Samples.size() < maxSamples);
+        if (!needMore) {
+            return false;
+        }
+
+        m_IterationStart = NowSeconds();
+        return true;
+    }
+
+    void BenchState::PauseTiming()
+    {
+        m_PausedAt = NowSeconds();
+    }
+
+    void BenchState::ResumeTiming()
+    {
+        m_PausedTotal += NowSeconds() - m_PausedAt;
+    }
+
+    void BenchState::SetCounter(const std::string& name, double value)
+    {
+        for (auto& counter : m_Counters) {
+            if (counter.first == name) {
+                counter.second = value;
+                return;
+            }
+        }
+        m_Counters.emplace_back(name, value);
+    }
+
+    void BenchState::Skip(const std::string& reason)
+    {
+        m_Skipped = true;
+        m_SkipReason = reason;
+    }
+
+    std::vector<Benchmark>& GetRegistry()
+    {
+        // Function-local so registration from static initializers in other translation units is order-safe
+        static std::vector<Benchmark> s_Registry;
+        return s_Registry;
+    }
+
+    bool RegisterBenchmark(const std::string& name, const std::string& category, uint32_t flags, BenchFn fn)
+    {
+        GetRegistry().push_back({ name, category, flags, std::move(fn) });
+        return true;
+    }
+
+    BenchResult RunBenchmark(const Benchmark& bench, const BenchConfig& config)
+    {
+        BenchState state(config);
+        bench.Fn(state);
+
+        BenchResult result;
+        result.Name = bench.Name;
+        result.Category = bench.Category;
+        result.Warmup = config.WarmupIterations;
+        result.ItemsPerIteration = state.GetItemsPerIteration();
+        result.BytesPerIteration = state.GetBytesPerIteration();
+        result.Counters = state.GetCounters();
+
+        std::vector<double> samples = state.GetSamples();
+        if (state.IsSkipped() || samples.empty()) {
+            result.Skipped = true;
+            result.SkipReason = state.IsSkipped() ? state.GetSkipReason() : "no samples recorded";
+            return result;
+        }
+
+        std::sort(samples.begin(), samples.end());
+        size_t count = samples.size();
+
+        double sum = 0.0;
+        for (double s : samples) {
+            sum += s;
+        }
+        double mean = sum / (double)count;
+
+        double variance = 0.0;
+        for (double s : samples) {
+            variance += (s - mean) * (s - mean);
+        }
+        variance /= (double)count;
+
+        result.Iterations = (uint32_t)count;
+        result.MeanNs = mean;
+        result.MedianNs = (count % 2) ? samples[count / 2] : 0.5 * (samples[count / 2 - 1] + samples[count / 2]);
+        result.MinNs = samples.front();
+        result.MaxNs = samples.back();
+        result.StdDevNs = std::sqrt(variance);
+        result.P95Ns = samples[std::min(count - 1, (size_t)std::ceil(0.95 * (double)count) - 1)];
+        return result;
+    }
+
+}
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace MarleBench {
+
+    enum BenchFlags
+    {
+        BenchFlagNone       = 0,
+        BenchFlagRequiresGL = 1 << 0 // Skipped when no headless OpenGL context could be created
+    };
+
+    struct BenchConfig {
+        uint32_t WarmupIterations = 5;
+        uint32_t MeasuredIterations = 50;
+        double MinIterationSeconds = 0.0; // Optional floor: keep sampling until this much time was measured
+    };
+
+    // Handed to every benchmark body. The body does its own setup, then loops on Run():
+    //
+    //     while (state.Run()) { ...work for one iteration... }
+    //
+    // Each pass through the loop is one timed sample. The first WarmupIterations samples are discarded.
+    class BenchState {
+    public:
+        BenchState(const BenchConfig& config);
+
+        bool Run();
+
+        // Work excluded from the current sample (e.g. per-iteration cleanup)
+        void PauseTiming();
+        void ResumeTiming();
+
+        // Lets the report express results per item (sprite, event, matrix...) instead of per iteration
+        void SetItemsPerIteration(uint64_t items) { m_ItemsPerIteration = items; }
+        void SetBytesPerIteration(uint64_t bytes) { m_BytesPerIteration = bytes; }
+
+        // Free-form counters written next to the timings (e.g. "draw_calls")
+        void SetCounter(const std::string& name, double value);
+
+        // Marks the benchmark as skipped (missing asset, missing GL feature...)
+        void Skip(const std::string& reason);
+
+        bool IsSkipped() const { return m_Skipped; }
+        const std::string& GetSkipReason() const { return m_SkipReason; }
+        const std::vector<double>& GetSamples() const { return m_Samples; }
+        uint64_t GetItemsPerIteration() const { return m_ItemsPerIteration; }
+        uint64_t GetBytesPerIteration() const { return m_BytesPerIteration; }
+        const std::vector<std::pair<std::string, double>>& GetCounters() const { return m_Counters; }
+        const BenchConfig& GetConfig() const { return m_Config; }
+
+    private:
+        BenchConfig m_Config;
+        std::vector<double> m_Samples; // Nanoseconds per measured iteration
+        std::vector<std::pair<std::string, double>> m_Counters;
+        uint64_t m_ItemsPerIteration = 1;
+        uint64_t m_BytesPerIteration = 0;
+        uint32_t m_Completed = 0;
+        double m_MeasuredSeconds = 0.0;
+        double m_IterationStart = 0.0;
+        double m_PausedAt = 0.0;
+        double m_PausedTotal = 0.0;
+        bool m_Started = false;
+        bool m_Skipped = false;
+        std::string m_SkipReason;
+    };
+
+    using BenchFn = std::function<void(BenchState&)>;
+
+    struct Benchmark {
+        std::string Name;
+        std::string Category; // "micro" or "scenario"
+        uint32_t Flags = BenchFlagNone;
+        BenchFn Fn;
+    };
+
+    struct BenchResult {
+        std::string Name;
+        std::string Category;
+        bool Skipped = false;
+        std::string SkipReason;
+        uint32_t Warmup = 0;
+        uint32_t Iterations = 0;
+        uint64_t ItemsPerIteration = 1;
+        uint64_t BytesPerIteration = 0;
+        double MeanNs = 0.0, MedianNs = 0.0, MinNs = 0.0, MaxNs = 0.0, StdDevNs = 0.0, P95Ns = 0.0;
+        std::vector<std::pair<std::string, double>> Counters;
+
+        double NsPerItem() const { return ItemsPerIteration ? MedianNs / (double)ItemsPerIteration : MedianNs; }
+    };
+
+    std::vector<Benchmark>& GetRegistry();
+    bool RegisterBenchmark(const std::string& name, const std::string& category, uint32_t flags, BenchFn fn);
+
+    BenchResult RunBenchmark(const Benchmark& bench, const BenchConfig& config);
+
+    double NowSeconds();
+
+    // Reads a whole file (relative to the working directory, normally the repository root)
+    bool ReadFileBytes(const std::string& path, std::vector<uint8_t>& outBytes);
+
+    // Keeps the optimizer from discarding results that are otherwise unused
+    template<typename T>
+    inline void DoNotOptimize(const T& value)
+    {
+    #if defined(__clang__) || defined(__GNUC__)
+        asm volatile("" : : "r,m"(value) : "memory");
+    #else
+        volatile const T* sink = &value;
+        (void)sink;
+    #endif
+    }
+
+    inline void ClobberMemory()
+    {
+    #if defined(__clang__) || defined(__GNUC__)
+        asm volatile("" : : : "memory");
+    #endif
+    }
+
+}
+
+#define MRL_BENCH_CONCAT_INNER(a, b) a##b
+#define MRL_BENCH_CONCAT(a, b) MRL_BENCH_CONCAT_INNER(a, b)
+
+// Defines and registers a benchmark body: MRL_BENCHMARK(EventDispatch, "micro", BenchFlagNone) { ... }
+#define MRL_BENCHMARK(name, category, flags) \
+    static void MRL_BENCH_CONCAT(Bench_, name)(MarleBench::BenchState& state); \
+    static const bool MRL_BENCH_CONCAT(s_Registered_, name) = \
+        MarleBench::RegisterBenchmark(#name, category, flags, &MRL_BENCH_CONCAT(Bench_, name)); \
+    static void MRL_BENCH_CONCAT(Bench_, name)(MarleBench::BenchState& state)
@@ -0,0 +1,121 @@
+#include "BenchGL.h"
+
+#include <cstdio>
+#include <glad/gl.h>
+
+#if defined(__APPLE__)
+#define GL_SILENCE_DEPRECATION
+#include <dlfcn.h>
+#include <OpenGL/OpenGL.h>
+#endif
+
+namespace MarleBench {
+
+#if defined(__APPLE__)
+
+    static CGLContextObj s_Context = nullptr;
+    static GLuint s_Framebuffer = 0;
+    static GLuint s_ColorBuffer = 0;
+
+    static GLADapiproc LoadGLProc(const char* name)
+    {
+        return (GLADapiproc)dlsym(RTLD_DEFAULT, name);
+    }
+
+    bool CreateHeadlessGLContext(uint32_t width, uint32_t height)
+    {
+        CGLPixelFormatAttribute attributes[] = {
+            kCGLPFAOpenGLProfile, (CGLPixelFormatAttribute)kCGLOGLPVersion_3_2_Core,
+            kCGLPFAColorSize, (CGLPixelFormatAttribute)24,
+            kCGLPFAAlphaSize, (CGLPixelFormatAttribute)8,
+            kCGLPFAAccelerated,
+            (CGLPixelFormatAttribute)0
+        };
+
+        CGLPixelFormatObj pixelFormat = nullptr;
+        GLint formatCount = 0;
+        if (CGLChoosePixelFormat(attributes, &pixelFormat, &formatCount) != kCGLNoError || !pixelFormat) {
+            printf("MarleBench: failed to choose a CGL pixel format\n");
+            return false;
+        }
+
+        CGLError error = CGLCreateContext(pixelFormat, nullptr, &s_Context);
+        CGLDestroyPixelFormat(pixelFormat);
+        if (error != kCGLNoError || !s_Context) {
+            printf("MarleBench: failed to create a CGL context\n");
+            return false;
+        }
+        CGLSetCurrentContext(s_Context);
+
+        if (gladLoadGL(LoadGLProc) == 0) {
+            printf("MarleBench: failed to initialize GLAD\n");
+            DestroyHeadlessGLContext();
+            return false;
+        }
+
+        // A context without a drawable has no usable default framebuffer
+        glGenRenderbuffers(1, &s_ColorBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, s_ColorBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, (GLsizei)width, (GLsizei)height);
+
+        glGenFramebuffers(1, &s_Framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, s_Framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, s_ColorBuffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            printf("MarleBench: off-screen framebuffer is incomplete\n");
+            DestroyHeadlessGLContext();
+            return false;
+        }
+
+        glViewport(0, 0, (GLsizei)width, (GLsizei)height);
+        glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+
+        printf("MarleBench: headless GL context ready (%s, %s)\n",
+               (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+        return true;
+    }
+
+    void DestroyHeadlessGLContext()
+    {
+        if (!s_Context) {
+            return;
+        }
+        if (s_Framebuffer) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &s_Framebuffer);
+            glDeleteRenderbuffers(1, &s_ColorBuffer);
+            s_Framebuffer = 0;
+            s_ColorBuffer = 0;
+        }
+        CGLSetCurrentContext(nullptr);
+        CGLDestroyContext(s_Context);
+        s_Context = nullptr;
+    }
+
+    bool HasGLContext()
+    {
+        return s_Context != nullptr;
+    }
+
+    void FinishGL()
+    {
+        if (s_Context) {
+            glFinish();
+        }
+    }
+
+#else
+
+    bool CreateHeadlessGLContext(uint32_t /*width*/, uint32_t /*height*/)
+    {
+        printf("MarleBench: headless GL contexts are not implemented for this platform\n");
+        return false;
+    }
+
+    void DestroyHeadlessGLContext() {}
+    bool HasGLContext() { return false; }
+    void FinishGL() {}
+
+#endif
+
+}
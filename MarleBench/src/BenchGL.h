@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+
+namespace MarleBench {
+
+    // Headless OpenGL 3.2 core context with an off-screen framebuffer bound as the draw target,
+    // so renderer benchmarks run without opening a window.
+    bool CreateHeadlessGLContext(uint32_t width, uint32_t height);
+    void DestroyHeadlessGLContext();
+    bool HasGLContext();
+
+    // Blocks until the GPU has drained all submitted work, so frame scenarios time real GPU cost
+    void FinishGL();
+
+}
@@ -0,0 +1,164 @@
+#include "Bench.h"
+#include "BenchGL.h"
+#include "BenchReport.h"
+
+#include "Marle/Core/FileSystem.h"
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Core/MemoryTracker.h"
+#include "Marle/Core/ResourceManager.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace MarleBench;
+
+static void PrintUsage()
+{
+    printf("Usage: MarleBench [options]\n");
+    printf("       MarleBench --compare <baseline.json> <current.json> [--threshold <percent>]\n");
+    printf("\n");
+    printf("Run from the repository root so Assets/ resolves.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --list                  List registered benchmarks and exit\n");
+    printf("  --filter <text>         Only run benchmarks whose name contains <text>\n");
+    printf("  --category <name>       Only run 'micro' or 'scenario' benchmarks\n");
+    printf("  --warmup <n>            Discarded iterations before measuring (default 5)\n");
+    printf("  --iterations <n>        Measured iterations (default 50)\n");
+    printf("  --min-time <seconds>    Keep sampling until at least this much time was measured\n");
+    printf("  --out <file>            JSON report path (default bench_results.json)\n");
+    printf("  --baseline <file>       Compare this run against a stored report\n");
+    printf("  --threshold <percent>   Median slowdown that counts as a regression (default 5)\n");
+    printf("  --no-gl                 Skip benchmarks that need an OpenGL context\n");
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config;
+    std::string filter;
+    std::string category;
+    std::string outPath = "bench_results.json";
+    std::string baselinePath;
+    std::string compareBase, compareCurrent;
+    double threshold = 5.0;
+    bool useGL = true;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--list") == 0) {
+            listOnly = true;
+        } else if (std::strcmp(arg, "--no-gl") == 0) {
+            useGL = false;
+        } else if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else if (std::strcmp(arg, "--category") == 0 && hasValue) {
+            category = argv[++i];
+        } else if (std::strcmp(arg, "--warmup") == 0 && hasValue) {
+            config.WarmupIterations = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--iterations") == 0 && hasValue) {
+            config.MeasuredIterations = (uint32_t)std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(arg, "--min-time") == 0 && hasValue) {
+            config.MinIterationSeconds = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--out") == 0 && hasValue) {
+            outPath = argv[++i];
+        } else if (std::strcmp(arg, "--baseline") == 0 && hasValue) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(arg, "--threshold") == 0 && hasValue) {
+            threshold = std::atof(argv[++i]);
+        } else if (std::strcmp(arg, "--compare") == 0 && i + 2 < argc) {
+            compareBase = argv[++i];
+            compareCurrent = argv[++i];
+        } else {
+            PrintUsage();
+            return std::strcmp(arg, "--help") == 0 ? 0 : 2;
+        }
+    }
+
+    // Offline diff of two stored reports
+    if (!compareBase.empty()) {
+        BenchReport baseline, current;
+        if (!LoadReportJson(compareBase, baseline) || !LoadReportJson(compareCurrent, current)) {
+            return 2;
+        }
+        return CompareReports(baseline, current, threshold) > 0 ? 1 : 0;
+    }
+
+    if (listOnly) {
+        for (const Benchmark& bench : GetRegistry()) {
+            printf("%-10s %s%s\n", bench.Category.c_str(), bench.Name.c_str(),
+                   (bench.Flags & BenchFlagRequiresGL) ? "  [gl]" : "");
+        }
+        return 0;
+    }
+
+    if (useGL) {
+        useGL = CreateHeadlessGLContext(1024, 768);
+    }
+    Marle::MemoryTracker::Init();
+    Marle::JobSystem::Init();
+    Marle::FileSystem::Init();
+    Marle::ResourceManager::Init();
+
+    BenchReport report;
+    report.Timestamp = CurrentTimestamp();
+    report.Config = config;
+    report.Machine = QueryMachineInfo();
+
+    printf("MarleBench: %s, %u logical cores, ~%.0f MHz (%s)\n", report.Machine.CPU.c_str(),
+           report.Machine.LogicalCores, report.Machine.EstimatedMHz, report.Machine.FrequencyNote.c_str());
+
+    for (const Benchmark& bench : GetRegistry()) {
+        if (!filter.empty() && bench.Name.find(filter) == std::string::npos) {
+            continue;
+        }
+        if (!category.empty() && bench.Category != category) {
+            continue;
+        }
+
+        BenchResult result;
+        if ((bench.Flags & BenchFlagRequiresGL) && !useGL) {
+            result.Name = bench.Name;
+            result.Category = bench.Category;
+            result.Skipped = true;
+            result.SkipReason = "no OpenGL context";
+        } else {
+            result = RunBenchmark(bench, config);
+        }
+
+        if (result.Skipped) {
+            printf("[skip] %-40s %s\n", result.Name.c_str(), result.SkipReason.c_str());
+        } else {
+            printf("[done] %-40s median %12.1f ns  (%10.3f ns/item, p95 %12.1f ns)\n",
+                   result.Name.c_str(), result.MedianNs, result.NsPerItem(), result.P95Ns);
+        }
+        report.Results.push_back(result);
+    }
+
+    Marle::ResourceManager::Shutdown();
+    Marle::FileSystem::Shutdown();
+    Marle::JobSystem::Shutdown();
+    Marle::MemoryTracker::Shutdown();
+    if (useGL) {
+        DestroyHeadlessGLContext();
+    }
+
+    if (!WriteReportJson(report, outPath)) {
+        return 2;
+    }
+    printf("Wrote %zu results to %s\n", report.Results.size(), outPath.c_str());
+
+    if (!baselinePath.empty()) {
+        BenchReport baseline;
+        if (!LoadReportJson(baselinePath, baseline)) {
+            return 2;
+        }
+        return CompareReports(baseline, report, threshold) > 0 ? 1 : 0;
+    }
+    return 0;
+}
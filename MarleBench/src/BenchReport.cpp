@@ -0,0 +1,481 @@
+#include "BenchReport.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#endif
+
+namespace MarleBench {
+
+    // ---------------------------------------------------------------------
+    // Machine information
+    // ---------------------------------------------------------------------
+
+    static std::string ReadFirstLine(const char* path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        if (file.is_open()) {
+            std::getline(file, line);
+        }
+        return line;
+    }
+
+    static double EstimateCpuMHz()
+    {
+        // A loop-carried add retires at roughly one iteration per cycle on every core we target,
+        // so this tracks the effective clock (including turbo / thermal throttling) well enough
+        // to tell whether two runs were taken at comparable frequencies.
+        const uint64_t iterations = 200000000ull;
+        uint64_t x = 0;
+        double start = NowSeconds();
+        for (uint64_t i = 0; i < iterations; i++) {
+            x += i;
+        #if defined(__clang__) || defined(__GNUC__)
+            asm volatile("" : "+r"(x));
+        #endif
+        }
+        double elapsed = NowSeconds() - start;
+        DoNotOptimize(x);
+        return elapsed > 0.0 ? (double)iterations / elapsed / 1e6 : 0.0;
+    }
+
+    MachineInfo QueryMachineInfo()
+    {
+        MachineInfo info;
+        info.LogicalCores = std::thread::hardware_concurrency();
+
+    #if defined(__APPLE__)
+        info.OS = "macOS";
+
+        char brand[256] = {};
+        size_t size = sizeof(brand);
+        if (sysctlbyname("machdep.cpu.brand_string", brand, &size, nullptr, 0) == 0) {
+            info.CPU = brand;
+        }
+
+        uint64_t frequency = 0;
+        size = sizeof(frequency);
+        if (sysctlbyname("hw.cpufrequency", &frequency, &size, nullptr, 0) == 0 && frequency > 0) {
+            info.NominalMHz = (double)frequency / 1e6;
+            info.FrequencyNote = "nominal clock from hw.cpufrequency; Turbo Boost and thermal state are not controlled";
+        } else {
+            info.FrequencyNote = "hw.cpufrequency unavailable (Apple Silicon?); rely on estimated_mhz, keep the machine on AC power";
+        }
+    #elif defined(__linux__)
+        info.OS = "Linux";
+
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (info.CPU.empty() && line.rfind("model name", 0) == 0) {
+                info.CPU = line.substr(line.find(':') + 2);
+            }
+        }
+
+        std::string curFreq = ReadFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_cur_freq");
+        if (!curFreq.empty()) {
+            info.NominalMHz = std::atof(curFreq.c_str()) / 1000.0;
+        }
+
+        std::string governor = ReadFirstLine("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor");
+        std::string noTurbo = ReadFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+        std::stringstream note;
+        note << "governor=" << (governor.empty() ? "unknown" : governor);
+        if (!noTurbo.empty()) {
+            note << ", turbo=" << (noTurbo == "1" ? "off" : "on");
+        }
+        if (governor != "performance") {
+            note << "; frequency scaling is active, results may drift between runs";
+        }
+        info.FrequencyNote = note.str();
+    #else
+        info.OS = "unknown";
+        info.FrequencyNote = "no frequency information for this platform";
+    #endif
+
+        info.EstimatedMHz = EstimateCpuMHz();
+        return info;
+    }
+
+    std::string CurrentTimestamp()
+    {
+        std::time_t now = std::time(nullptr);
+        std::tm utc = *std::gmtime(&now);
+        char buffer[32];
+        std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%SZ", &utc);
+        return buffer;
+    }
+
+    // ---------------------------------------------------------------------
+    // JSON output
+    // ---------------------------------------------------------------------
+
+    static std::string EscapeJson(const std::string& text)
+    {
+        std::string out;
+        out.reserve(text.size());
+        for (char c : text) {
+            switch (c) {
+                case '"':  out += "\\\""; break;
+                case '\\': out += "\\\\"; break;
+                case '\n': out += "\\n"; break;
+                case '\t': out += "\\t"; break;
+                default:
+                    if ((unsigned char)c >= 0x20) {
+                        out += c;
+                    }
+                    break;
+            }
+        }
+        return out;
+    }
+
+    bool WriteReportJson(const BenchReport& report, const std::string& path)
+    {
+        FILE* file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            printf("Failed to open benchmark report for writing: %s\n", path.c_str());
+            return false;
+        }
+
+        const MachineInfo& m = report.Machine;
+        std::fprintf(file, "{\n");
+        std::fprintf(file, "  \"format\": 1,\n");
+        std::fprintf(file, "  \"timestamp\": \"%s\",\n", EscapeJson(report.Timestamp).c_str());
+        std::fprintf(file, "  \"machine\": {\n");
+        std::fprintf(file, "    \"os\": \"%s\",\n", EscapeJson(m.OS).c_str());
+        std::fprintf(file, "    \"cpu\": \"%s\",\n", EscapeJson(m.CPU).c_str());
+        std::fprintf(file, "    \"logical_cores\": %u,\n", m.LogicalCores);
+        std::fprintf(file, "    \"nominal_mhz\": %.1f,\n", m.NominalMHz);
+        std::fprintf(file, "    \"estimated_mhz\": %.1f,\n", m.EstimatedMHz);
+        std::fprintf(file, "    \"frequency_note\": \"%s\"\n", EscapeJson(m.FrequencyNote).c_str());
+        std::fprintf(file, "  },\n");
+        std::fprintf(file, "  \"config\": { \"warmup\": %u, \"iterations\": %u, \"min_seconds\": %.3f },\n",
+                     report.Config.WarmupIterations, report.Config.MeasuredIterations, report.Config.MinIterationSeconds);
+        std::fprintf(file, "  \"benchmarks\": [\n");
+
+        for (size_t i = 0; i < report.Results.size(); i++) {
+            const BenchResult& r = report.Results[i];
+            std::fprintf(file, "    {\n");
+            std::fprintf(file, "      \"name\": \"%s\",\n", EscapeJson(r.Name).c_str());
+            std::fprintf(file, "      \"category\": \"%s\",\n", EscapeJson(r.Category).c_str());
+            if (r.Skipped) {
+                std::fprintf(file, "      \"skipped\": true,\n");
+                std::fprintf(file, "      \"skip_reason\": \"%s\"\n", EscapeJson(r.SkipReason).c_str());
+            } else {
+                std::fprintf(file, "      \"warmup\": %u,\n", r.Warmup);
+                std::fprintf(file, "      \"iterations\": %u,\n", r.Iterations);
+                std::fprintf(file, "      \"items_per_iteration\": %llu,\n", (unsigned long long)r.ItemsPerIteration);
+                std::fprintf(file, "      \"bytes_per_iteration\": %llu,\n", (unsigned long long)r.BytesPerIteration);
+                std::fprintf(file, "      \"mean_ns\": %.1f,\n", r.MeanNs);
+                std::fprintf(file, "      \"median_ns\": %.1f,\n", r.MedianNs);
+                std::fprintf(file, "      \"min_ns\": %.1f,\n", r.MinNs);
+                std::fprintf(file, "      \"max_ns\": %.1f,\n", r.MaxNs);
+                std::fprintf(file, "      \"p95_ns\": %.1f,\n", r.P95Ns);
+                std::fprintf(file, "      \"stddev_ns\": %.1f,\n", r.StdDevNs);
+                std::fprintf(file, "      \"ns_per_item\": %.3f", r.NsPerItem());
+                if (r.BytesPerIteration > 0 && r.MedianNs > 0.0) {
+                    std::fprintf(file, ",\n      \"mb_per_s\": %.2f", (double)r.BytesPerIteration / r.MedianNs * 1e3);
+                }
+                if (!r.Counters.empty()) {
+                    std::fprintf(file, ",\n      \"counters\": {");
+                    for (size_t c = 0; c < r.Counters.size(); c++) {
+                        std::fprintf(file, "%s \"%s\": %.3f", c ? "," : "", EscapeJson(r.Counters[c].first).c_str(), r.Counters[c].second);
+                    }
+                    std::fprintf(file, " }");
+                }
+                std::fprintf(file, "\n");
+            }
+            std::fprintf(file, "    }%s\n", i + 1 < report.Results.size() ? "," : "");
+        }
+
+        std::fprintf(file, "  ]\n");
+        std::fprintf(file, "}\n");
+        std::fclose(file);
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // JSON input (just enough to read back what WriteReportJson produces)
+    // ---------------------------------------------------------------------
+
+    struct JsonValue {
+        enum class Type { Null, Bool, Number, String, Array, Object };
+
+        Type ValueType = Type::Null;
+        bool Bool = false;
+        double Number = 0.0;
+        std::string String;
+        std::vector<JsonValue> Elements;     // Array elements or object values
+        std::vector<std::string> Keys;       // Object keys, parallel to Elements
+
+        const JsonValue* Find(const std::string& key) const
+        {
+            for (size_t i = 0; i < Keys.size(); i++) {
+                if (Keys[i] == key) {
+                    return &Elements[i];
+                }
+            }
+            return nullptr;
+        }
+
+        double NumberOr(const std::string& key, double fallback) const
+        {
+            const JsonValue* v = Find(key);
+            return (v && v->ValueType == Type::Number) ? v->Number : fallback;
+        }
+
+        std::string StringOr(const std::string& key, const std::string& fallback) const
+        {
+            const JsonValue* v = Find(key);
+            return (v && v->ValueType == Type::String) ? v->String : fallback;
+        }
+    };
+
+    class JsonParser {
+    public:
+        JsonParser(const std::string& text) : m_Text(text) {}
+
+        bool Parse(JsonValue& out)
+        {
+            return ParseValue(out) && (SkipWhitespace(), m_Pos == m_Text.size());
+        }
+
+    private:
+        void SkipWhitespace()
+        {
+            while (m_Pos < m_Text.size() && std::isspace((unsigned char)m_Text[m_Pos])) {
+                m_Pos++;
+            }
+        }
+
+        bool Consume(char c)
+        {
+            SkipWhitespace();
+            if (m_Pos < m_Text.size() && m_Text[m_Pos] == c) {
+                m_Pos++;
+                return true;
+            }
+            return false;
+        }
+
+        bool ParseString(std::string& out)
+        {
+            if (!Consume('"')) {
+                return false;
+            }
+            while (m_Pos < m_Text.size() && m_Text[m_Pos] != '"') {
+                char c = m_Text[m_Pos++];
+                if (c == '\\' && m_Pos < m_Text.size()) {
+                    char e = m_Text[m_Pos++];
+                    c = (e == 'n') ? '\n' : (e == 't') ? '\t' : e;
+                }
+                out += c;
+            }
+            return m_Pos++ < m_Text.size();
+        }
+
+        bool ParseValue(JsonValue& out)
+        {
+            SkipWhitespace();
+            if (m_Pos >= m_Text.size()) {
+                return false;
+            }
+
+            char c = m_Text[m_Pos];
+            if (c == '{') {
+                m_Pos++;
+                out.ValueType = JsonValue::Type::Object;
+                if (Consume('}')) {
+                    return true;
+                }
+                do {
+                    std::string key;
+                    JsonValue value;
+                    if (!ParseString(key) || !Consume(':') || !ParseValue(value)) {
+                        return false;
+                    }
+                    out.Keys.push_back(key);
+                    out.Elements.push_back(std::move(value));
+                } while (Consume(','));
+                return Consume('}');
+            }
+            if (c == '[') {
+                m_Pos++;
+                out.ValueType = JsonValue::Type::Array;
+                if (Consume(']')) {
+                    return true;
+                }
+                do {
+                    JsonValue value;
+                    if (!ParseValue(value)) {
+                        return false;
+                    }
+                    out.Elements.push_back(std::move(value));
+                } while (Consume(','));
+                return Consume(']');
+            }
+            if (c == '"') {
+                out.ValueType = JsonValue::Type::String;
+                return ParseString(out.String);
+            }
+            if (m_Text.compare(m_Pos, 4, "true") == 0 || m_Text.compare(m_Pos, 5, "false") == 0) {
+                out.ValueType = JsonValue::Type::Bool;
+                out.Bool = (c == 't');
+                m_Pos += out.Bool ? 4 : 5;
+                return true;
+            }
+            if (m_Text.compare(m_Pos, 4, "null") == 0) {
+                m_Pos += 4;
+                return true;
+            }
+
+            const char* begin = m_Text.c_str() + m_Pos;
+            char* end = nullptr;
+            out.ValueType = JsonValue::Type::Number;
+            out.Number = std::strtod(begin, &end);
+            if (end == begin) {
+                return false;
+            }
+            m_Pos += (size_t)(end - begin);
+            return true;
+        }
+
+        const std::string& m_Text;
+        size_t m_Pos = 0;
+    };
+
+    bool LoadReportJson(const std::string& path, BenchReport& outReport)
+    {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            printf("Failed to open benchmark report: %s\n", path.c_str());
+            return false;
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        std::string text = buffer.str();
+
+        JsonValue root;
+        if (!JsonParser(text).Parse(root) || root.ValueType != JsonValue::Type::Object) {
+            printf("Malformed benchmark report: %s\n", path.c_str());
+            return false;
+        }
+
+        outReport.Timestamp = root.StringOr("timestamp", "");
+        if (const JsonValue* machine = root.Find("machine")) {
+            outReport.Machine.OS = machine->StringOr("os", "");
+            outReport.Machine.CPU = machine->StringOr("cpu", "");
+            outReport.Machine.LogicalCores = (uint32_t)machine->NumberOr("logical_cores", 0.0);
+            outReport.Machine.NominalMHz = machine->NumberOr("nominal_mhz", 0.0);
+            outReport.Machine.EstimatedMHz = machine->NumberOr("estimated_mhz", 0.0);
+            outReport.Machine.FrequencyNote = machine->StringOr("frequency_note", "");
+        }
+        if (const JsonValue* config = root.Find("config")) {
+            outReport.Config.WarmupIterations = (uint32_t)config->NumberOr("warmup", 0.0);
+            outReport.Config.MeasuredIterations = (uint32_t)config->NumberOr("iterations", 0.0);
+            outReport.Config.MinIterationSeconds = config->NumberOr("min_seconds", 0.0);
+        }
+
+        const JsonValue* benchmarks = root.Find("benchmarks");
+        if (!benchmarks || benchmarks->ValueType != JsonValue::Type::Array) {
+            printf("Benchmark report has no \"benchmarks\" array: %s\n", path.c_str());
+            return false;
+        }
+
+        for (const JsonValue& entry : benchmarks->Elements) {
+            BenchResult r;
+            r.Name = entry.StringOr("name", "");
+            r.Category = entry.StringOr("category", "");
+            const JsonValue* skipped = entry.Find("skipped");
+            r.Skipped = skipped && skipped->Bool;
+            r.SkipReason = entry.StringOr("skip_reason", "");
+            r.Warmup = (uint32_t)entry.NumberOr("warmup", 0.0);
+            r.Iterations = (uint32_t)entry.NumberOr("iterations", 0.0);
+            r.ItemsPerIteration = (uint64_t)entry.NumberOr("items_per_iteration", 1.0);
+            r.BytesPerIteration = (uint64_t)entry.NumberOr("bytes_per_iteration", 0.0);
+            r.MeanNs = entry.NumberOr("mean_ns", 0.0);
+            r.MedianNs = entry.NumberOr("median_ns", 0.0);
+            r.MinNs = entry.NumberOr("min_ns", 0.0);
+            r.MaxNs = entry.NumberOr("max_ns", 0.0);
+            r.P95Ns = entry.NumberOr("p95_ns", 0.0);
+            r.StdDevNs = entry.NumberOr("stddev_ns", 0.0);
+            outReport.Results.push_back(r);
+        }
+        return true;
+    }
+
+    // ---------------------------------------------------------------------
+    // Regression diff
+    // ---------------------------------------------------------------------
+
+    int CompareReports(const BenchReport& baseline, const BenchReport& current, double thresholdPercent)
+    {
+        printf("Comparing against baseline from %s (threshold %.1f%%)\n", baseline.Timestamp.c_str(), thresholdPercent);
+
+        double baseMHz = baseline.Machine.EstimatedMHz;
+        double curMHz = current.Machine.EstimatedMHz;
+        if (baseMHz > 0.0 && curMHz > 0.0 && std::fabs(curMHz - baseMHz) / baseMHz > 0.05) {
+            printf("WARNING: estimated CPU clock differs from baseline (%.0f MHz vs %.0f MHz); deltas include frequency drift\n",
+                   curMHz, baseMHz);
+        }
+        if (baseline.Machine.CPU != current.Machine.CPU) {
+            printf("WARNING: baseline was recorded on a different CPU (%s)\n", baseline.Machine.CPU.c_str());
+        }
+
+        printf("%-40s %14s %14s %9s\n", "benchmark", "baseline ns", "current ns", "delta");
+
+        int regressions = 0;
+        for (const BenchResult& cur : current.Results) {
+            const BenchResult* base = nullptr;
+            for (const BenchResult& candidate : baseline.Results) {
+                if (candidate.Name == cur.Name) {
+                    base = &candidate;
+                    break;
+                }
+            }
+
+            if (!base) {
+                printf("%-40s %14s %14.1f %9s\n", cur.Name.c_str(), "-", cur.MedianNs, "new");
+                continue;
+            }
+            if (cur.Skipped || base->Skipped || base->MedianNs <= 0.0) {
+                printf("%-40s %14s %14s %9s\n", cur.Name.c_str(), "-", "-", "skipped");
+                continue;
+            }
+
+            double delta = (cur.MedianNs - base->MedianNs) / base->MedianNs * 100.0;
+            const char* verdict = "";
+            if (delta > thresholdPercent) {
+                verdict = "  REGRESSION";
+                regressions++;
+            } else if (delta < -thresholdPercent) {
+                verdict = "  improved";
+            }
+            printf("%-40s %14.1f %14.1f %+8.1f%%%s\n", cur.Name.c_str(), base->MedianNs, cur.MedianNs, delta, verdict);
+        }
+
+        for (const BenchResult& base : baseline.Results) {
+            bool found = false;
+            for (const BenchResult& cur : current.Results) {
+                found = found || cur.Name == base.Name;
+            }
+            if (!found) {
+                printf("%-40s %14.1f %14s %9s\n", base.Name.c_str(), base.MedianNs, "-", "missing");
+            }
+        }
+
+        printf("%d regression(s) beyond %.1f%%\n", regressions, thresholdPercent);
+        return regressions;
+    }
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Bench.h"
+
+#include <string>
+#include <vector>
+
+namespace MarleBench {
+
+    struct MachineInfo {
+        std::string OS;
+        std::string CPU;
+        uint32_t LogicalCores = 0;
+        double NominalMHz = 0.0;   // What the OS reports, 0 if unknown
+        double EstimatedMHz = 0.0; // Measured with a dependent add chain right before the run
+        std::string FrequencyNote; // Governor / turbo / throttling caveats
+    };
+
+    struct BenchReport {
+        std::string Timestamp;
+        MachineInfo Machine;
+        BenchConfig Config;
+        std::vector<BenchResult> Results;
+    };
+
+    MachineInfo QueryMachineInfo();
+    std::string CurrentTimestamp();
+
+    bool WriteReportJson(const BenchReport& report, const std::string& path);
+    bool LoadReportJson(const std::string& path, BenchReport& outReport);
+
+    // Prints a per-benchmark comparison of median times and returns the number of regressions,
+    // i.e. benchmarks whose median got slower than the baseline by more than thresholdPercent.
+    int CompareReports(const BenchReport& baseline, const BenchReport& current, double thresholdPercent);
+
+}
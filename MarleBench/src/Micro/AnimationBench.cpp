@@ -0,0 +1,197 @@
+#include "../Bench.h"
+
+#include "Marle/Animation/AnimationSystem.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace MarleBench;
+
+static const uint32_t s_Characters = 1000;
+static const uint32_t s_BoneCount = 32;
+
+// A humanoid-sized hierarchy: a spine of eight bones with four six-bone limbs hanging off it
+static std::shared_ptr<Marle::Skeleton> MakeSkeleton()
+{
+    auto skeleton = std::make_shared<Marle::Skeleton>();
+    skeleton->AddBone("Root", Marle::Skeleton::NoParent, Marle::BoneTransform());
+    for (uint32_t bone = 1; bone < s_BoneCount; bone++) {
+        Marle::BoneTransform transform;
+        transform.Position = { 12.0f, 0.0f };
+        transform.Rotation = 0.1f * (float)(bone % 7);
+        int32_t parent = bone < 8 ? (int32_t)bone - 1 : ((bone - 8) % 6 == 0 ? (int32_t)((bone - 8) / 6 + 2) : (int32_t)bone - 1);
+        skeleton->AddBone("Bone" + std::to_string(bone), parent, transform);
+    }
+    return skeleton;
+}
+
+// Two-second loop touching rotation on every bone and translation on the root
+static std::shared_ptr<Marle::AnimationClip> MakeClip(const Marle::Skeleton& skeleton, float phase)
+{
+    auto clip = std::make_shared<Marle::AnimationClip>(skeleton, 2.0f, true);
+    for (uint32_t key = 0; key <= 8; key++) {
+        float t = key * 0.25f;
+        clip->AddKey(0, Marle::AnimationTrack::PositionX, t, 4.0f * sinf(t * 3.14159265f));
+        for (uint32_t bone = 1; bone < skeleton.GetBoneCount(); bone++) {
+            clip->AddKey(bone, Marle::AnimationTrack::Rotation, t, 0.3f * sinf(t * 3.14159265f + bone * 0.4f + phase));
+        }
+    }
+    clip->Bake();
+    return clip;
+}
+
+// Quad strip along each bone, two influences per vertex
+static std::shared_ptr<Marle::SkinnedMesh> MakeMesh(const Marle::Skeleton& skeleton)
+{
+    auto mesh = std::make_shared<Marle::SkinnedMesh>(skeleton.GetBoneCount());
+    for (uint32_t bone = 0; bone < skeleton.GetBoneCount(); bone++) {
+        glm::vec2 base = { bone * 12.0f, 0.0f };
+        uint32_t parent = skeleton.GetParent(bone) < 0 ? bone : (uint32_t)skeleton.GetParent(bone);
+        uint32_t first = mesh->AddVertex(base + glm::vec2(0.0f, -4.0f), { 0.0f, 0.0f }, { { bone, 0.6f }, { parent, 0.4f } });
+        mesh->AddVertex(base + glm::vec2(0.0f, 4.0f), { 0.0f, 1.0f }, { { bone, 0.6f }, { parent, 0.4f } });
+        mesh->AddVertex(base + glm::vec2(12.0f, -4.0f), { 1.0f, 0.0f }, { { bone, 1.0f } });
+        mesh->AddVertex(base + glm::vec2(12.0f, 4.0f), { 1.0f, 1.0f }, { { bone, 1.0f } });
+        mesh->AddTriangle(first, first + 2, first + 3);
+        mesh->AddTriangle(first, first + 3, first + 1);
+    }
+    return mesh;
+}
+
+MRL_BENCHMARK(Animation_Sample_1000, "micro", BenchFlagNone)
+{
+    auto skeleton = MakeSkeleton();
+    auto clip = MakeClip(*skeleton, 0.0f);
+    std::vector<Marle::Pose> poses(s_Characters, skeleton->GetBindPose());
+
+    state.SetItemsPerIteration((uint64_t)s_Characters * s_BoneCount);
+    float time = 0.0f;
+    while (state.Run()) {
+        time += 1.0f / 60.0f;
+        for (uint32_t i = 0; i < s_Characters; i++) {
+            clip->Sample(time + i * 0.013f, poses[i]);
+        }
+        DoNotOptimize(poses[0].GetData()[0]);
+    }
+    state.SetCounter("frames", clip->GetFrameCount());
+    state.SetCounter("clip_bytes", (double)clip->GetMemorySize());
+}
+
+MRL_BENCHMARK(Animation_Blend_1000, "micro", BenchFlagNone)
+{
+    auto skeleton = MakeSkeleton();
+    auto walk = MakeClip(*skeleton, 0.0f);
+    auto run = MakeClip(*skeleton, 1.5f);
+    Marle::Pose a = skeleton->GetBindPose();
+    Marle::Pose b = skeleton->GetBindPose();
+    walk->Sample(0.3f, a);
+    run->Sample(0.9f, b);
+    std::vector<Marle::Pose> poses(s_Characters, skeleton->GetBindPose());
+
+    state.SetItemsPerIteration((uint64_t)s_Characters * s_BoneCount);
+    while (state.Run()) {
+        for (uint32_t i = 0; i < s_Characters; i++) {
+            Marle::BlendPoses(a, b, (float)i / (float)s_Characters, poses[i]);
+        }
+        DoNotOptimize(poses[0].GetData()[0]);
+    }
+}
+
+MRL_BENCHMARK(Animation_Hierarchy_1000, "micro", BenchFlagNone)
+{
+    auto skeleton = MakeSkeleton();
+    auto clip = MakeClip(*skeleton, 0.0f);
+    Marle::Pose pose = skeleton->GetBindPose();
+    clip->Sample(0.7f, pose);
+    std::vector<Marle::Affine2D> world((size_t)s_Characters * s_BoneCount);
+    std::vector<Marle::Affine2D> palette((size_t)s_Characters * s_BoneCount);
+
+    state.SetItemsPerIteration((uint64_t)s_Characters * s_BoneCount);
+    while (state.Run()) {
+        for (uint32_t i = 0; i < s_Characters; i++) {
+            Marle::Affine2D root = Marle::Affine2D::FromTRS({ (float)i, 0.0f }, 0.0f, glm::vec2(1.0f));
+            Marle::Affine2D* characterWorld = world.data() + (size_t)i * s_BoneCount;
+            Marle::ComputeWorldTransforms(skeleton->GetParents(), pose, root, characterWorld);
+            Marle::ComputeSkinningPalette(characterWorld, skeleton->GetInverseBind(), s_BoneCount,
+                                          palette.data() + (size_t)i * s_BoneCount);
+        }
+        DoNotOptimize(palette[0].TX);
+    }
+}
+
+MRL_BENCHMARK(Animation_Skin_1000, "micro", BenchFlagNone)
+{
+    auto skeleton = MakeSkeleton();
+    auto clip = MakeClip(*skeleton, 0.0f);
+    auto mesh = MakeMesh(*skeleton);
+    Marle::Pose pose = skeleton->GetBindPose();
+    clip->Sample(0.7f, pose);
+    std::vector<Marle::Affine2D> world(s_BoneCount);
+    std::vector<Marle::Affine2D> palette(s_BoneCount);
+    Marle::ComputeWorldTransforms(skeleton->GetParents(), pose, Marle::Affine2D(), world.data());
+    Marle::ComputeSkinningPalette(world.data(), skeleton->GetInverseBind(), s_BoneCount, palette.data());
+    std::vector<Marle::SkinnedVertex> vertices((size_t)s_Characters * mesh->GetVertexCount());
+
+    state.SetItemsPerIteration((uint64_t)s_Characters * mesh->GetVertexCount());
+    while (state.Run()) {
+        for (uint32_t i = 0; i < s_Characters; i++) {
+            mesh->Skin(palette.data(), vertices.data() + (size_t)i * mesh->GetVertexCount());
+        }
+        DoNotOptimize(vertices[0].Position.x);
+    }
+    state.SetCounter("vertices_per_character", mesh->GetVertexCount());
+}
+
+// The whole fixed-step path as the game runs it: sample, crossfade, hierarchy and palette
+// across the JobSystem, then CPU skinning of every mesh into the shared vertex array
+static void RunSystemUpdate(BenchState& state, uint32_t characters)
+{
+    auto skeleton = MakeSkeleton();
+    auto walk = MakeClip(*skeleton, 0.0f);
+    auto run = MakeClip(*skeleton, 1.5f);
+    auto mesh = MakeMesh(*skeleton);
+
+    Marle::AnimationSystem system;
+    std::vector<Marle::AnimationInstance> instances;
+    for (uint32_t i = 0; i < characters; i++) {
+        Marle::AnimationInstance instance = system.CreateInstance(skeleton, mesh);
+        system.SetTransform(instance, { (float)(i % 64) * 20.0f, (float)(i / 64) * 20.0f });
+        system.Play(instance, walk, 0.0f, 0.9f + 0.01f * (float)(i % 20));
+        instances.push_back(instance);
+    }
+
+    state.SetItemsPerIteration(characters);
+    uint32_t frame = 0;
+    double updateMs = 0.0;
+    double skinMs = 0.0;
+    while (state.Run()) {
+        // A tenth of the characters switch clips every frame so crossfades are always in flight
+        for (uint32_t i = frame % 10; i < characters; i += 10) {
+            system.Play(instances[i], (frame / 10) % 2 ? walk : run, 0.25f);
+        }
+        system.Update(1.0f / 60.0f);
+        system.Skin();
+        updateMs += system.GetStats().UpdateMs;
+        skinMs += system.GetStats().SkinMs;
+        frame++;
+        DoNotOptimize(system.GetBoneWorld(instances[0], s_BoneCount - 1).TX);
+    }
+
+    const Marle::AnimationSystem::Stats& stats = system.GetStats();
+    state.SetCounter("bones", stats.Bones);
+    state.SetCounter("vertices", stats.Vertices);
+    state.SetCounter("crossfades", stats.Crossfades);
+    state.SetCounter("update_ms", frame ? updateMs / frame : 0.0);
+    state.SetCounter("skin_ms", frame ? skinMs / frame : 0.0);
+}
+
+MRL_BENCHMARK(AnimationSystem_Update_1000, "micro", BenchFlagNone)
+{
+    RunSystemUpdate(state, 1000);
+}
+
+MRL_BENCHMARK(AnimationSystem_Update_4000, "micro", BenchFlagNone)
+{
+    RunSystemUpdate(state, 4000);
+}
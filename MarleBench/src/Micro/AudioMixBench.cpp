@@ -0,0 +1,100 @@
+#include "../Bench.h"
+
+#include "Marle/Audio/AudioClip.h"
+#include "Marle/Audio/AudioMixer.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace MarleBench;
+
+static const uint32_t s_PeriodsPerIteration = 16;
+
+// One second of noise-free tone; the content does not matter to the mixer, only the rate
+static std::shared_ptr<Marle::AudioClip> MakeToneClip(uint32_t sampleRate, uint32_t channels)
+{
+    std::vector<float> samples((size_t)sampleRate * channels);
+    for (uint32_t frame = 0; frame < sampleRate; frame++) {
+        float value = 0.1f * sinf((float)frame * 0.05f);
+        for (uint32_t channel = 0; channel < channels; channel++) {
+            samples[(size_t)frame * channels + channel] = value;
+        }
+    }
+    return Marle::AudioClip::Create(sampleRate, channels, samples.data(), sampleRate);
+}
+
+// 48 kHz stereo device, 256-frame periods; every voice loops so the count stays constant.
+// A clip at the device rate with pitch 1 takes the copy path, anything else the resampler.
+static void RunMix(BenchState& state, uint32_t voices, uint32_t clipRate, float pitch)
+{
+    Marle::AudioFormat format;
+    Marle::AudioMixer mixer(format, voices);
+    std::shared_ptr<Marle::AudioClip> clip = MakeToneClip(clipRate, 2);
+
+    for (uint32_t i = 0; i < voices; i++) {
+        Marle::AudioCommand command;
+        command.Type = Marle::AudioCommandType::Play;
+        command.Voice = (1u << 16) | i;
+        command.Clip = clip.get();
+        command.Params.Volume = 1.0f / (float)voices;
+        command.Params.Pan = (float)(i % 9) / 4.0f - 1.0f;
+        command.Params.Pitch = pitch;
+        command.Params.Loop = true;
+        mixer.Execute(command);
+    }
+
+    std::vector<float> output((size_t)format.PeriodFrames * format.Channels);
+    mixer.Mix(output.data(), format.PeriodFrames); // Past the fade-in ramps
+
+    state.SetItemsPerIteration((uint64_t)format.PeriodFrames * s_PeriodsPerIteration * voices);
+    double measuredSeconds = 0.0;
+    uint64_t periods = 0;
+    while (state.Run()) {
+        double start = NowSeconds();
+        for (uint32_t i = 0; i < s_PeriodsPerIteration; i++) {
+            mixer.Mix(output.data(), format.PeriodFrames);
+        }
+        measuredSeconds += NowSeconds() - start;
+        periods += s_PeriodsPerIteration;
+        DoNotOptimize(output[0]);
+    }
+
+    // How many times faster than playback the mix runs; below ~4 leaves little room on a busy audio thread
+    double periodSeconds = (double)format.PeriodFrames / (double)format.SampleRate;
+    double mixSeconds = periods ? measuredSeconds / (double)periods : 0.0;
+    state.SetCounter("active_voices", mixer.GetActiveVoices());
+    state.SetCounter("mix_us_per_period", mixSeconds * 1e6);
+    state.SetCounter("realtime_factor", mixSeconds > 0.0 ? periodSeconds / mixSeconds : 0.0);
+}
+
+MRL_BENCHMARK(AudioMix_64Voices_Native, "micro", BenchFlagNone)
+{
+    RunMix(state, 64, 48000, 1.0f);
+}
+
+MRL_BENCHMARK(AudioMix_256Voices_Native, "micro", BenchFlagNone)
+{
+    RunMix(state, 256, 48000, 1.0f);
+}
+
+MRL_BENCHMARK(AudioMix_512Voices_Native, "micro", BenchFlagNone)
+{
+    RunMix(state, 512, 48000, 1.0f);
+}
+
+// 44.1 kHz assets with pitch variation, the common case for sound effects
+MRL_BENCHMARK(AudioMix_64Voices_Resampled, "micro", BenchFlagNone)
+{
+    RunMix(state, 64, 44100, 1.07f);
+}
+
+MRL_BENCHMARK(AudioMix_256Voices_Resampled, "micro", BenchFlagNone)
+{
+    RunMix(state, 256, 44100, 1.07f);
+}
+
+MRL_BENCHMARK(AudioMix_512Voices_Resampled, "micro", BenchFlagNone)
+{
+    RunMix(state, 512, 44100, 1.07f);
+}
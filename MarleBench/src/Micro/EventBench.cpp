@@ -0,0 +1,56 @@
+#include "../Bench.h"
+
+#include "Marle/Events/ApplicationEvent.h"
+#include "Marle/Events/KeyEvent.h"
+#include "Marle/Events/MouseEvent.h"
+
+using namespace MarleBench;
+
+static const int s_EventsPerIteration = 10000;
+
+// Mirrors the Sandbox OnEvent: one dispatcher per event, three typed handlers, only one matches
+MRL_BENCHMARK(EventDispatch_Key, "micro", BenchFlagNone)
+{
+    state.SetItemsPerIteration(s_EventsPerIteration);
+
+    int handled = 0;
+    while (state.Run()) {
+        for (int i = 0; i < s_EventsPerIteration; i++) {
+            Marle::KeyPressedEvent event(i & 0xFF, 0);
+            Marle::EventDispatcher dispatcher(event);
+            dispatcher.Dispatch<Marle::KeyPressedEvent>([&handled](Marle::KeyPressedEvent& e) {
+                handled += e.GetKeyCode();
+                return false;
+            });
+            dispatcher.Dispatch<Marle::KeyReleasedEvent>([&handled](Marle::KeyReleasedEvent& e) {
+                handled -= e.GetKeyCode();
+                return false;
+            });
+            dispatcher.Dispatch<Marle::KeyTypedEvent>([&handled](Marle::KeyTypedEvent& e) {
+                handled ^= e.GetKeyCode();
+                return false;
+            });
+        }
+        DoNotOptimize(handled);
+    }
+}
+
+// Category filtering is what layers do before dispatching, so it gets its own number
+MRL_BENCHMARK(EventCategoryFilter_Mixed, "micro", BenchFlagNone)
+{
+    state.SetItemsPerIteration(s_EventsPerIteration);
+
+    Marle::KeyPressedEvent key(32, 0);
+    Marle::MouseMovedEvent mouse(10.0f, 20.0f);
+    Marle::WindowResizeEvent resize(1024, 768);
+    Marle::Event* events[] = { &key, &mouse, &resize };
+
+    int inputEvents = 0;
+    while (state.Run()) {
+        for (int i = 0; i < s_EventsPerIteration; i++) {
+            Marle::Event* event = events[i % 3];
+            inputEvents += event->IsInCategory(Marle::EventCategoryInput) ? 1 : 0;
+        }
+        DoNotOptimize(inputEvents);
+    }
+}
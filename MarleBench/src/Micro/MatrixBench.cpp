@@ -0,0 +1,44 @@
+#include "../Bench.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+using namespace MarleBench;
+
+static const int s_MatricesPerIteration = 10000;
+
+// The per-quad transform Renderer2D::DrawQuad builds on every call
+MRL_BENCHMARK(MatrixBuild_QuadTransform, "micro", BenchFlagNone)
+{
+    state.SetItemsPerIteration(s_MatricesPerIteration);
+
+    glm::mat4 accumulator(0.0f);
+    while (state.Run()) {
+        for (int i = 0; i < s_MatricesPerIteration; i++) {
+            glm::vec2 position((float)(i % 1024), (float)(i / 1024));
+            glm::vec2 size(64.0f, 64.0f);
+            glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(position, 0.0f)) *
+                                  glm::scale(glm::mat4(1.0f), glm::vec3(size, 1.0f));
+            accumulator[3] = accumulator[3] + transform[3];
+        }
+        DoNotOptimize(accumulator);
+    }
+}
+
+// The view-projection Renderer2D::BeginScene builds once per scene
+MRL_BENCHMARK(MatrixBuild_ViewProjection, "micro", BenchFlagNone)
+{
+    state.SetItemsPerIteration(s_MatricesPerIteration);
+
+    glm::mat4 accumulator(0.0f);
+    while (state.Run()) {
+        for (int i = 0; i < s_MatricesPerIteration; i++) {
+            float width = 1024.0f + (float)(i & 7);
+            glm::mat4 proj = glm::ortho(0.0f, width, 0.0f, 768.0f, -1.0f, 1.0f);
+            glm::mat4 view = glm::mat4(1.0f);
+            glm::mat4 viewProjection = proj * view;
+            accumulator[0] = accumulator[0] + viewProjection[0];
+        }
+        DoNotOptimize(accumulator);
+    }
+}
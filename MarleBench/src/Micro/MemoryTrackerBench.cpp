@@ -0,0 +1,60 @@
+#include "../Bench.h"
+
+#include "Marle/Core/MemoryTracker.h"
+
+#include <cstdlib>
+
+using namespace MarleBench;
+
+static const int s_AllocationsPerIteration = 10000;
+
+// Small short-lived blocks, the pattern that makes tracking overhead visible
+template<typename AllocateFn, typename FreeFn>
+static void RunAllocations(BenchState& state, AllocateFn allocate, FreeFn release)
+{
+    static void* blocks[64];
+    state.SetItemsPerIteration(s_AllocationsPerIteration);
+
+    while (state.Run()) {
+        for (int i = 0; i < s_AllocationsPerIteration; i++) {
+            void*& slot = blocks[i & 63];
+            release(slot);
+            slot = allocate(16 + (i & 255));
+        }
+        DoNotOptimize(blocks[0]);
+    }
+    for (void*& slot : blocks) {
+        release(slot);
+        slot = nullptr;
+    }
+}
+
+static void RunTracked(BenchState& state, Marle::MemoryTrackingMode mode)
+{
+    Marle::MemoryTrackingMode previous = Marle::MemoryTracker::GetMode();
+    Marle::MemoryTracker::SetMode(mode);
+    RunAllocations(state,
+        [](size_t size) { return Marle::MemoryTracker::Allocate(size, Marle::MemoryTag::Game); },
+        [](void* ptr) { Marle::MemoryTracker::Free(ptr); });
+    Marle::MemoryTracker::SetMode(previous);
+}
+
+MRL_BENCHMARK(Allocate_Malloc, "micro", BenchFlagNone)
+{
+    RunAllocations(state, [](size_t size) { return std::malloc(size); }, [](void* ptr) { std::free(ptr); });
+}
+
+MRL_BENCHMARK(Allocate_Tracked_Off, "micro", BenchFlagNone)
+{
+    RunTracked(state, Marle::MemoryTrackingMode::Off);
+}
+
+MRL_BENCHMARK(Allocate_Tracked_Sampled, "micro", BenchFlagNone)
+{
+    RunTracked(state, Marle::MemoryTrackingMode::Sampled);
+}
+
+MRL_BENCHMARK(Allocate_Tracked_Full, "micro", BenchFlagNone)
+{
+    RunTracked(state, Marle::MemoryTrackingMode::Full);
+}
@@ -0,0 +1,25 @@
+#include "../Bench.h"
+
+#include "Marle/Renderer/MipGenerator.h"
+
+#include <vector>
+
+using namespace MarleBench;
+
+// Gamma-correct chain for a 2048x2048 RGBA8 image, as done on load for non-.dds textures
+MRL_BENCHMARK(MipChain_2048, "micro", BenchFlagNone)
+{
+    const uint32_t size = 2048;
+    std::vector<uint8_t> pixels((size_t)size * size * 4);
+    for (size_t i = 0; i < pixels.size(); i++) {
+        pixels[i] = (uint8_t)((i * 2654435761u) >> 24);
+    }
+    state.SetItemsPerIteration((uint64_t)size * size);
+    state.SetBytesPerIteration(pixels.size());
+
+    std::vector<std::vector<uint8_t>> levels;
+    while (state.Run()) {
+        Marle::GenerateMipChain(pixels.data(), size, size, levels);
+        DoNotOptimize(levels.back().data());
+    }
+}
@@ -0,0 +1,88 @@
+#include "../Bench.h"
+
+#include "Marle/Network/Replication.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace MarleBench;
+
+// Position, heading, health and a flag: 66 bits per entity at full precision
+static Marle::ReplicationSchema MakeSchema()
+{
+    Marle::ReplicationSchema schema;
+    schema.AddFloat("X", -2048.0f, 2048.0f, 0.01f);
+    schema.AddFloat("Y", -2048.0f, 2048.0f, 0.01f);
+    schema.AddFloat("Heading", -3.1416f, 3.1416f, 0.005f);
+    schema.AddInt("Health", 0, 100);
+    schema.AddBool("Alive");
+    return schema;
+}
+
+// Tick `tick` of a world where every tenth entity walks and everything else stands still
+static void MakeSnapshot(const Marle::ReplicationSchema& schema, uint32_t count, uint32_t tick, Marle::ReplicationSnapshot& snapshot)
+{
+    snapshot.Clear();
+    snapshot.Tick = tick;
+    for (uint32_t i = 0; i < count; i++) {
+        float t = (i % 10 == 0) ? tick / 60.0f : 0.0f;
+        float values[5] = { -1500.0f + (i % 100) * 30.0f + 40.0f * sinf(t + i), -1500.0f + (i / 100) * 30.0f + 40.0f * cosf(t + i),
+                            sinf(i * 0.7f), (float)(i % 101), 1.0f };
+        snapshot.Ids.push_back(i * 2 + 1);
+        for (uint32_t f = 0; f < 5; f++) {
+            snapshot.Values.push_back(schema.Quantize(f, values[f]));
+        }
+    }
+}
+
+MRL_BENCHMARK(Replication_EncodeFull_1000, "micro", BenchFlagNone)
+{
+    Marle::ReplicationSchema schema = MakeSchema();
+    Marle::ReplicationSnapshot snapshot;
+    MakeSnapshot(schema, 1000, 10, snapshot);
+    std::vector<uint8_t> packet;
+
+    state.SetItemsPerIteration(1000);
+    while (state.Run()) {
+        schema.Encode(nullptr, snapshot, packet);
+        DoNotOptimize(packet.data());
+    }
+    state.SetCounter("bytes", (double)packet.size());
+    state.SetCounter("bits_per_entity", packet.size() * 8.0 / 1000.0);
+}
+
+// Against the snapshot three ticks back, the usual distance of an acked baseline at 60 Hz
+MRL_BENCHMARK(Replication_EncodeDelta_1000, "micro", BenchFlagNone)
+{
+    Marle::ReplicationSchema schema = MakeSchema();
+    Marle::ReplicationSnapshot baseline, snapshot;
+    MakeSnapshot(schema, 1000, 10, baseline);
+    MakeSnapshot(schema, 1000, 13, snapshot);
+    std::vector<uint8_t> packet;
+
+    state.SetItemsPerIteration(1000);
+    while (state.Run()) {
+        schema.Encode(&baseline, snapshot, packet);
+        DoNotOptimize(packet.data());
+    }
+    state.SetCounter("bytes", (double)packet.size());
+    state.SetCounter("bits_per_entity", packet.size() * 8.0 / 1000.0);
+}
+
+MRL_BENCHMARK(Replication_DecodeDelta_1000, "micro", BenchFlagNone)
+{
+    Marle::ReplicationSchema schema = MakeSchema();
+    Marle::ReplicationSnapshot baseline, snapshot, decoded;
+    MakeSnapshot(schema, 1000, 10, baseline);
+    MakeSnapshot(schema, 1000, 13, snapshot);
+    std::vector<uint8_t> packet;
+    schema.Encode(&baseline, snapshot, packet);
+
+    state.SetItemsPerIteration(1000);
+    bool ok = true;
+    while (state.Run()) {
+        ok &= schema.Decode(packet.data(), packet.size(), &baseline, decoded);
+        DoNotOptimize(decoded.Values.data());
+    }
+    state.SetCounter("matches", ok && decoded.Values == snapshot.Values ? 1.0 : 0.0);
+}
@@ -0,0 +1,77 @@
+#include "../Bench.h"
+
+#include "Marle/Core/StringId.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace MarleBench;
+
+static const int s_LookupsPerIteration = 1000;
+static const int s_NameCount = 64;
+
+static std::vector<std::string> MakeNames()
+{
+    std::vector<std::string> names;
+    for (int i = 0; i < s_NameCount; i++) {
+        names.push_back("Assets/Textures/Sprite_" + std::to_string(i) + ".png");
+    }
+    return names;
+}
+
+// Hashing a path at runtime: what every StringId built from a std::string pays
+MRL_BENCHMARK(StringId_HashRuntime, "micro", BenchFlagNone)
+{
+    std::vector<std::string> names = MakeNames();
+    state.SetItemsPerIteration(s_LookupsPerIteration);
+
+    while (state.Run()) {
+        uint64_t sum = 0;
+        for (int i = 0; i < s_LookupsPerIteration; i++) {
+            const std::string& name = names[i % s_NameCount];
+            sum += Marle::HashString(name.data(), name.size());
+        }
+        DoNotOptimize(sum);
+    }
+}
+
+// The old way to find a resource or uniform: hash and compare the whole string per lookup
+MRL_BENCHMARK(StringId_LookupByString, "micro", BenchFlagNone)
+{
+    std::vector<std::string> names = MakeNames();
+    std::unordered_map<std::string, int> table;
+    for (int i = 0; i < s_NameCount; i++) {
+        table[names[i]] = i;
+    }
+    state.SetItemsPerIteration(s_LookupsPerIteration);
+
+    while (state.Run()) {
+        int sum = 0;
+        for (int i = 0; i < s_LookupsPerIteration; i++) {
+            sum += table.find(names[i % s_NameCount])->second;
+        }
+        DoNotOptimize(sum);
+    }
+}
+
+// Ids hashed ahead of time, as constexpr StringIds are: the lookup is an integer probe
+MRL_BENCHMARK(StringId_LookupById, "micro", BenchFlagNone)
+{
+    std::vector<std::string> names = MakeNames();
+    std::vector<Marle::StringId> ids;
+    std::unordered_map<Marle::StringId, int> table;
+    for (int i = 0; i < s_NameCount; i++) {
+        ids.push_back(Marle::StringId(names[i]));
+        table[ids.back()] = i;
+    }
+    state.SetItemsPerIteration(s_LookupsPerIteration);
+
+    while (state.Run()) {
+        int sum = 0;
+        for (int i = 0; i < s_LookupsPerIteration; i++) {
+            sum += table.find(ids[i % s_NameCount])->second;
+        }
+        DoNotOptimize(sum);
+    }
+}
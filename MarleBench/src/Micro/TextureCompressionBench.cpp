@@ -0,0 +1,106 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Platform/OpenGL/OpenGLTexture.h"
+#include "Marle/Renderer/TextureCompression.h"
+
+#include "stb_image.h"
+
+#include <memory>
+#include <vector>
+
+using namespace MarleBench;
+
+static bool LoadSourcePixels(BenchState& state, std::vector<uint8_t>& pixels, int& width, int& height)
+{
+    std::vector<uint8_t> file;
+    if (!ReadFileBytes("Assets/Textures/test_sprite.tga", file)) {
+        state.Skip("Assets/Textures/test_sprite.tga not found (run from the repository root)");
+        return false;
+    }
+
+    int channels = 0;
+    unsigned char* data = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &channels, 4);
+    if (!data) {
+        state.Skip("stb_image cannot parse test_sprite.tga");
+        return false;
+    }
+    pixels.assign(data, data + (size_t)width * height * 4);
+    stbi_image_free(data);
+    return true;
+}
+
+// Offline encoder throughput (MarleTexConv), rows of blocks spread over the JobSystem
+static void RunEncode(BenchState& state, Marle::TextureFormat format)
+{
+    std::vector<uint8_t> pixels, blocks;
+    int width = 0, height = 0;
+    if (!LoadSourcePixels(state, pixels, width, height)) {
+        return;
+    }
+    state.SetItemsPerIteration((uint64_t)width * (uint64_t)height);
+
+    while (state.Run()) {
+        Marle::CompressImage(pixels.data(), width, height, format, blocks);
+        DoNotOptimize(blocks.data());
+    }
+}
+
+MRL_BENCHMARK(TextureEncode_BC1, "micro", BenchFlagNone)
+{
+    RunEncode(state, Marle::TextureFormat::BC1);
+}
+
+MRL_BENCHMARK(TextureEncode_BC7, "micro", BenchFlagNone)
+{
+    RunEncode(state, Marle::TextureFormat::BC7);
+}
+
+// Software fallback used when the driver lacks the compression extension
+MRL_BENCHMARK(TextureDecode_BC1_Fallback, "micro", BenchFlagNone)
+{
+    std::vector<uint8_t> pixels, blocks, decoded;
+    int width = 0, height = 0;
+    if (!LoadSourcePixels(state, pixels, width, height)) {
+        return;
+    }
+    Marle::CompressImage(pixels.data(), width, height, Marle::TextureFormat::BC1, blocks);
+    state.SetItemsPerIteration((uint64_t)width * (uint64_t)height);
+
+    while (state.Run()) {
+        Marle::DecompressImage(blocks.data(), width, height, Marle::TextureFormat::BC1, decoded);
+        DoNotOptimize(decoded.data());
+    }
+}
+
+// Full OpenGLTexture2D construction: TGA decode + RGBA8 upload versus BC1 .dds straight to the GPU
+static void RunTextureLoad(BenchState& state, const char* path)
+{
+    std::vector<uint8_t> file;
+    if (!ReadFileBytes(path, file)) {
+        state.Skip(std::string(path) + " not found (run from the repository root)");
+        return;
+    }
+    state.SetBytesPerIteration(file.size());
+
+    std::unique_ptr<Marle::OpenGLTexture2D> texture;
+    while (state.Run()) {
+        texture = std::make_unique<Marle::OpenGLTexture2D>(path);
+        FinishGL();
+
+        state.PauseTiming();
+        state.SetCounter("gpu_kb", texture->GetMemorySize() / 1024.0);
+        texture.reset();
+        state.ResumeTiming();
+    }
+}
+
+MRL_BENCHMARK(TextureLoad_TGA, "micro", BenchFlagRequiresGL)
+{
+    RunTextureLoad(state, "Assets/Textures/test_sprite.tga");
+}
+
+MRL_BENCHMARK(TextureLoad_DDS_BC1, "micro", BenchFlagRequiresGL)
+{
+    RunTextureLoad(state, "Assets/Textures/test_sprite.dds");
+}
@@ -0,0 +1,180 @@
+#include "../Bench.h"
+
+#include "Marle/Renderer/ImageDecoder.h"
+#include "stb_image.h"
+
+#include <string>
+#include <vector>
+
+using namespace MarleBench;
+
+// Decode only (no GL upload) with the same settings OpenGLTexture2D uses: flipped, forced to RGBA
+MRL_BENCHMARK(TextureDecode_TGA_RGBA, "micro", BenchFlagNone)
+{
+    std::vector<uint8_t> file;
+    if (!ReadFileBytes("Assets/Textures/test_sprite.tga", file)) {
+        state.Skip("Assets/Textures/test_sprite.tga not found (run from the repository root)");
+        return;
+    }
+
+    stbi_set_flip_vertically_on_load(1);
+
+    int width = 0, height = 0, channels = 0;
+    if (!stbi_info_from_memory(file.data(), (int)file.size(), &width, &height, &channels)) {
+        state.Skip("stb_image cannot parse test_sprite.tga");
+        return;
+    }
+    state.SetItemsPerIteration((uint64_t)width * (uint64_t)height);
+    state.SetBytesPerIteration(file.size());
+
+    while (state.Run()) {
+        unsigned char* pixels = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &channels, 4);
+        DoNotOptimize(pixels);
+        stbi_image_free(pixels);
+    }
+}
+
+// Engine ImageDecoder against stb_image on an asset corpus, both producing bottom-up RGBA8.
+// Throughput (mb_per_s) counts decoded RGBA bytes so every pair is directly comparable; the
+// engine decodes into a preallocated buffer the way texture loads decode into the mip level.
+enum class ImageCorpus : uint32_t {
+    SpriteGrayTGA = 0,      // test_sprite.tga as is: 8-bit grayscale
+    TilesetPNG,             // test_tileset.png as is: RGBA, adaptive filters, zlib level 9
+    AtlasBGRATGA,           // The tileset tiled to 1024x1024, uncompressed 32-bit, top-down rows
+    AtlasRLETGA,            // The same atlas RLE-compressed
+    Count
+};
+
+static const char* s_CorpusNames[(uint32_t)ImageCorpus::Count] = { "SpriteGray_TGA", "Tileset_PNG", "Atlas1024_BGRA_TGA", "Atlas1024_RLE_TGA" };
+
+static void WriteTGAHeader(std::vector<uint8_t>& file, uint32_t imageType, uint32_t width, uint32_t height)
+{
+    uint8_t header[18] = {};
+    header[2] = (uint8_t)imageType;
+    header[12] = (uint8_t)width;
+    header[13] = (uint8_t)(width >> 8);
+    header[14] = (uint8_t)height;
+    header[15] = (uint8_t)(height >> 8);
+    header[16] = 32;
+    header[17] = 0x20 | 8;  // Top-down rows, 8 alpha bits
+    file.assign(header, header + sizeof(header));
+}
+
+static bool BuildCorpusFile(ImageCorpus entry, std::vector<uint8_t>& file, std::string& error)
+{
+    if (entry == ImageCorpus::SpriteGrayTGA) {
+        error = "Assets/Textures/test_sprite.tga not found (run from the repository root)";
+        return ReadFileBytes("Assets/Textures/test_sprite.tga", file);
+    }
+
+    std::vector<uint8_t> png;
+    if (!ReadFileBytes("Assets/Textures/test_tileset.png", png)) {
+        error = "Assets/Textures/test_tileset.png not found (run from the repository root)";
+        return false;
+    }
+    if (entry == ImageCorpus::TilesetPNG) {
+        file = std::move(png);
+        return true;
+    }
+
+    Marle::ImageInfo info;
+    std::vector<uint8_t> tile;
+    if (!Marle::ReadImageInfo(png.data(), png.size(), info)) {
+        error = "cannot parse test_tileset.png";
+        return false;
+    }
+    tile.resize((size_t)info.Width * info.Height * 4);
+    Marle::DecodeImage(png.data(), png.size(), info, tile.data());
+
+    // Tiled up to 1024x1024 as BGRA, top row first
+    const uint32_t size = 1024;
+    std::vector<uint8_t> bgra((size_t)size * size * 4);
+    for (uint32_t y = 0; y < size; y++) {
+        const uint8_t* src = &tile[(size_t)(info.Height - 1 - y % info.Height) * info.Width * 4];
+        for (uint32_t x = 0; x < size; x++) {
+            const uint8_t* p = src + (x % info.Width) * 4;
+            uint8_t* q = &bgra[((size_t)y * size + x) * 4];
+            q[0] = p[2]; q[1] = p[1]; q[2] = p[0]; q[3] = p[3];
+        }
+    }
+
+    if (entry == ImageCorpus::AtlasBGRATGA) {
+        WriteTGAHeader(file, 2, size, size);
+        file.insert(file.end(), bgra.begin(), bgra.end());
+        return true;
+    }
+
+    // Runs of identical pixels become run packets, everything else raw packets of up to 128
+    WriteTGAHeader(file, 10, size, size);
+    const uint32_t* pixels = (const uint32_t*)bgra.data();
+    const size_t count = (size_t)size * size;
+    size_t i = 0;
+    while (i < count) {
+        size_t run = 1;
+        while (i + run < count && run < 128 && pixels[i + run] == pixels[i]) {
+            run++;
+        }
+        if (run > 1) {
+            file.push_back((uint8_t)(0x80 | (run - 1)));
+            file.insert(file.end(), (const uint8_t*)&pixels[i], (const uint8_t*)&pixels[i] + 4);
+            i += run;
+            continue;
+        }
+        size_t raw = 1;
+        while (i + raw < count && raw < 128 && (i + raw + 1 >= count || pixels[i + raw] != pixels[i + raw + 1])) {
+            raw++;
+        }
+        file.push_back((uint8_t)(raw - 1));
+        file.insert(file.end(), (const uint8_t*)&pixels[i], (const uint8_t*)&pixels[i + raw]);
+        i += raw;
+    }
+    return true;
+}
+
+static void RunImageDecode(BenchState& state, ImageCorpus entry, bool engine)
+{
+    std::vector<uint8_t> file;
+    std::string error;
+    if (!BuildCorpusFile(entry, file, error)) {
+        state.Skip(error);
+        return;
+    }
+
+    Marle::ImageInfo info;
+    if (!Marle::ReadImageInfo(file.data(), file.size(), info)) {
+        state.Skip(std::string(s_CorpusNames[(uint32_t)entry]) + ": " + Marle::GetImageDecodeError());
+        return;
+    }
+    const size_t decodedBytes = (size_t)info.Width * info.Height * 4;
+    std::vector<uint8_t> pixels(decodedBytes);
+
+    stbi_set_flip_vertically_on_load(1);
+    state.SetItemsPerIteration((uint64_t)info.Width * info.Height);
+    state.SetBytesPerIteration(decodedBytes);
+    while (state.Run()) {
+        if (engine) {
+            Marle::DecodeImage(file.data(), file.size(), info, pixels.data());
+            DoNotOptimize(pixels.data());
+        } else {
+            int width = 0, height = 0, channels = 0;
+            unsigned char* decoded = stbi_load_from_memory(file.data(), (int)file.size(), &width, &height, &channels, 4);
+            DoNotOptimize(decoded);
+            stbi_image_free(decoded);
+        }
+    }
+    state.SetCounter("file_kb", (double)file.size() / 1024.0);
+    state.SetCounter("channels", info.Channels);
+}
+
+static bool RegisterImageDecode()
+{
+    for (uint32_t entry = 0; entry < (uint32_t)ImageCorpus::Count; entry++) {
+        for (bool engine : { true, false }) {
+            RegisterBenchmark(std::string("ImageDecode_") + s_CorpusNames[entry] + (engine ? "_Engine" : "_Stb"), "micro", BenchFlagNone,
+                              [entry, engine](BenchState& state) { RunImageDecode(state, (ImageCorpus)entry, engine); });
+        }
+    }
+    return true;
+}
+
+static const bool s_ImageDecodeRegistered = RegisterImageDecode();
@@ -0,0 +1,100 @@
+#include "../Bench.h"
+
+#include "Marle/Scene/TransformHierarchy.h"
+
+#include <random>
+#include <vector>
+
+using namespace MarleBench;
+
+static const uint32_t s_Roots = 1000;
+static const uint32_t s_ChildrenPerRoot = 9;
+static const uint32_t s_LeavesPerChild = 10;
+static const uint32_t s_NodeCount = s_Roots * (1 + s_ChildrenPerRoot * (1 + s_LeavesPerChild));   // 100k
+
+// 1000 objects of 100 nodes each: a root, nine attachments and ten parts per attachment
+static std::vector<Marle::TransformNode> BuildScene(Marle::TransformHierarchy& hierarchy)
+{
+    std::vector<Marle::TransformNode> nodes;
+    nodes.reserve(s_NodeCount);
+    for (uint32_t root = 0; root < s_Roots; root++) {
+        Marle::TransformNode rootNode = hierarchy.Create(Marle::TransformHierarchy::InvalidNode,
+                                                         { (float)(root % 40) * 25.0f, (float)(root / 40) * 30.0f });
+        nodes.push_back(rootNode);
+        for (uint32_t child = 0; child < s_ChildrenPerRoot; child++) {
+            Marle::TransformNode childNode = hierarchy.Create(rootNode, { 8.0f, 0.0f }, 0.7f * (float)child);
+            nodes.push_back(childNode);
+            for (uint32_t leaf = 0; leaf < s_LeavesPerChild; leaf++) {
+                nodes.push_back(hierarchy.Create(childNode, { 2.0f, (float)leaf }, 0.1f * (float)leaf, { 0.9f, 0.9f }));
+            }
+        }
+    }
+    hierarchy.Update();
+    return nodes;
+}
+
+// Moves `percent` of the nodes, chosen at random each frame, then updates the world transforms
+static void RunTransformUpdate(BenchState& state, uint32_t percent)
+{
+    Marle::TransformHierarchy hierarchy;
+    std::vector<Marle::TransformNode> nodes = BuildScene(hierarchy);
+    const uint32_t changes = s_NodeCount * percent / 100;
+
+    std::mt19937 random(1234);
+    std::vector<uint32_t> picks(changes);
+    uint64_t recomputed = 0;
+    uint64_t frames = 0;
+    float time = 0.0f;
+    state.SetItemsPerIteration(changes);
+    while (state.Run()) {
+        state.PauseTiming();
+        for (uint32_t& pick : picks) {
+            pick = random() % s_NodeCount;
+        }
+        state.ResumeTiming();
+
+        time += 1.0f / 60.0f;
+        for (uint32_t pick : picks) {
+            hierarchy.SetRotation(nodes[pick], time);
+        }
+        hierarchy.Update();
+        recomputed += hierarchy.GetStats().Recomputed;
+        frames++;
+        DoNotOptimize(hierarchy.GetWorldPosition(nodes.back()));
+    }
+
+    state.SetCounter("nodes", hierarchy.GetNodeCount());
+    state.SetCounter("changed", changes);
+    if (frames > 0) {
+        state.SetCounter("recomputed", (double)recomputed / (double)frames);
+    }
+    state.SetCounter("dirty_roots", hierarchy.GetStats().DirtyRoots);
+}
+
+MRL_BENCHMARK(Transform_Update_100k_1pct, "micro", BenchFlagNone)
+{
+    RunTransformUpdate(state, 1);
+}
+
+// Every node changes: the cost of recomputing everything, as a reference for the 1% case
+MRL_BENCHMARK(Transform_Update_100k_100pct, "micro", BenchFlagNone)
+{
+    RunTransformUpdate(state, 100);
+}
+
+// Reparenting forces a re-sort of the flat arrays at the next Update
+MRL_BENCHMARK(Transform_Relayout_100k, "micro", BenchFlagNone)
+{
+    Marle::TransformHierarchy hierarchy;
+    std::vector<Marle::TransformNode> nodes = BuildScene(hierarchy);
+
+    uint32_t frame = 0;
+    state.SetItemsPerIteration(s_NodeCount);
+    while (state.Run()) {
+        // Moves the first object's first attachment back and forth between the first two objects
+        hierarchy.SetParent(nodes[1], nodes[(frame % 2 == 0) ? s_NodeCount / s_Roots : 0]);
+        hierarchy.Update();
+        frame++;
+        DoNotOptimize(hierarchy.GetStats().LayoutMs);
+    }
+}
@@ -0,0 +1,31 @@
+#include "../Bench.h"
+
+#include "Marle/Platform/OpenGL/OpenGLShader.h"
+
+#include <glm/glm.hpp>
+#include <memory>
+
+using namespace MarleBench;
+
+static const int s_UniformsPerIteration = 1000;
+
+// Same call pattern as Renderer2D::DrawQuad: a sampler and a transform set by name per draw.
+// The literals become compile-time StringIds, so each set is one probe of the reflected table.
+MRL_BENCHMARK(UniformSet_ByName, "micro", BenchFlagRequiresGL)
+{
+    auto shader = std::make_unique<Marle::OpenGLShader>("Assets/Shaders/Texture.vert", "Assets/Shaders/Texture.frag");
+    shader->Bind();
+
+    state.SetItemsPerIteration(s_UniformsPerIteration * 2);
+
+    glm::mat4 transform(1.0f);
+    while (state.Run()) {
+        for (int i = 0; i < s_UniformsPerIteration; i++) {
+            transform[3][0] = (float)i;
+            shader->SetUniform1i("u_Texture", 0);
+            shader->SetUniformMat4f("u_Transform", transform);
+        }
+    }
+
+    shader->Unbind();
+}
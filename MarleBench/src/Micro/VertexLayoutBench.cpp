@@ -0,0 +1,96 @@
+#include "../Bench.h"
+
+#include "Marle/Renderer/VertexBufferLayout.h"
+
+#include <vector>
+
+using namespace MarleBench;
+
+static const uint32_t s_QuadCount = 25000;     // 100k vertices
+static const uint32_t s_CellCount = 64 * 64;   // Atlas cells the quads sample from
+
+// Vertex building cost and bytes per frame for the text batch vertex, before and after packing
+// texture coordinates to UNorm16x2. As in the font atlas, each cell's corners are computed once
+// and copied into the vertices.
+struct FloatVertex {
+    glm::vec2 Position;
+    glm::vec2 TexCoord;
+    uint32_t Color;
+};
+
+struct PackedVertex {
+    glm::vec2 Position;
+    uint32_t TexCoord;
+    uint32_t Color;
+};
+
+template<typename Vertex, typename TexCoord>
+static void RunVertexBuild(BenchState& state, const std::vector<TexCoord>& corners)
+{
+    std::vector<Vertex> vertices;
+    vertices.reserve((size_t)s_QuadCount * 4);
+    const uint32_t color = Marle::PackUNorm8x4(glm::vec4(1.0f, 0.8f, 0.6f, 1.0f));
+
+    state.SetItemsPerIteration((uint64_t)s_QuadCount * 4);
+    while (state.Run()) {
+        vertices.clear();
+        for (uint32_t quad = 0; quad < s_QuadCount; quad++) {
+            float x0 = (float)(quad % 128) * 8.0f, y0 = (float)(quad / 128) * 4.0f;
+            const TexCoord* cell = &corners[(quad % s_CellCount) * 4];
+            vertices.push_back({ { x0, y0 }, cell[0], color });
+            vertices.push_back({ { x0 + 8.0f, y0 }, cell[1], color });
+            vertices.push_back({ { x0 + 8.0f, y0 + 4.0f }, cell[2], color });
+            vertices.push_back({ { x0, y0 + 4.0f }, cell[3], color });
+        }
+        DoNotOptimize(vertices.data());
+    }
+    state.SetCounter("bytes_per_vertex", sizeof(Vertex));
+    state.SetCounter("upload_kb", (double)(vertices.size() * sizeof(Vertex)) / 1024.0);
+}
+
+static std::vector<glm::vec2> BuildCellCorners()
+{
+    std::vector<glm::vec2> corners;
+    corners.reserve(s_CellCount * 4);
+    const float size = 1.0f / 64.0f;
+    for (uint32_t cell = 0; cell < s_CellCount; cell++) {
+        float u0 = (float)(cell % 64) * size, v0 = (float)(cell / 64) * size;
+        corners.push_back(glm::vec2(u0, v0));
+        corners.push_back(glm::vec2(u0 + size, v0));
+        corners.push_back(glm::vec2(u0 + size, v0 + size));
+        corners.push_back(glm::vec2(u0, v0 + size));
+    }
+    return corners;
+}
+
+MRL_BENCHMARK(VertexBuild_Float_100k, "micro", BenchFlagNone)
+{
+    RunVertexBuild<FloatVertex>(state, BuildCellCorners());
+}
+
+MRL_BENCHMARK(VertexBuild_Packed_100k, "micro", BenchFlagNone)
+{
+    std::vector<uint32_t> packed;
+    for (const glm::vec2& corner : BuildCellCorners()) {
+        packed.push_back(Marle::PackUNorm16x2(corner));
+    }
+    RunVertexBuild<PackedVertex>(state, packed);
+}
+
+// Half-float conversion, as tilemap chunks pack their animation data
+MRL_BENCHMARK(VertexPack_Half2_100k, "micro", BenchFlagNone)
+{
+    std::vector<glm::vec2> values(100000);
+    for (size_t i = 0; i < values.size(); i++) {
+        values[i] = glm::vec2((float)(i % 17), 0.25f * (float)(i % 40));
+    }
+    std::vector<uint32_t> packed(values.size());
+
+    state.SetItemsPerIteration(values.size());
+    while (state.Run()) {
+        for (size_t i = 0; i < values.size(); i++) {
+            packed[i] = Marle::PackHalf2(values[i]);
+        }
+        DoNotOptimize(packed.data());
+    }
+}
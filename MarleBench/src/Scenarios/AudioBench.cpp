@@ -0,0 +1,65 @@
+#include "../Bench.h"
+
+#include "Marle/Audio/AudioClip.h"
+#include "Marle/Audio/AudioEngine.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace MarleBench;
+
+// Full engine on a paced (real-time) null device with a background of looping voices. Each
+// iteration is one Play, issued at a random point of the period: the time until the audio
+// thread has picked it up, i.e. what a game event waits before it is audible, minus device
+// buffering. Expect about half a period on average and one period at worst.
+MRL_BENCHMARK(AudioEngine_PlayLatency, "scenario", BenchFlagNone)
+{
+    Marle::AudioConfig config;
+    if (!Marle::AudioEngine::Init(std::make_unique<Marle::NullAudioDevice>(true), config)) {
+        state.Skip("audio engine failed to start");
+        return;
+    }
+
+    {
+        std::vector<float> samples(config.Format.SampleRate / 50, 0.05f);
+        std::shared_ptr<Marle::AudioClip> blip = Marle::AudioClip::Create(config.Format.SampleRate, 1, samples.data(), (uint32_t)samples.size());
+
+        Marle::AudioPlayParams background;
+        background.Loop = true;
+        background.Volume = 0.01f;
+        std::vector<Marle::AudioVoice> loops;
+        for (int i = 0; i < 128; i++) {
+            loops.push_back(Marle::AudioEngine::Play(blip, background));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(300)); // Let the mix statistics publish once
+        const int periodUs = (int)(config.Format.PeriodFrames * 1000000ull / config.Format.SampleRate);
+
+        while (state.Run()) {
+            state.PauseTiming();
+            std::this_thread::sleep_for(std::chrono::microseconds(rand() % periodUs));
+            state.ResumeTiming();
+
+            uint64_t started = Marle::AudioEngine::GetStats().VoicesStarted;
+            Marle::AudioEngine::Play(blip);
+            while (Marle::AudioEngine::GetStats().VoicesStarted == started) {
+                std::this_thread::yield();
+            }
+            Marle::AudioEngine::Update();
+        }
+
+        Marle::AudioEngine::Stats stats = Marle::AudioEngine::GetStats();
+        state.SetCounter("voices", stats.ActiveVoices);
+        state.SetCounter("period_ms", stats.PeriodMs);
+        state.SetCounter("output_latency_ms", stats.OutputLatencyMs);
+        state.SetCounter("mix_ms_avg", stats.MixMsAverage);
+        state.SetCounter("mix_ms_max", stats.MixMsMax);
+        state.SetCounter("device_underruns", (double)stats.DeviceUnderruns);
+
+        for (Marle::AudioVoice voice : loops) {
+            Marle::AudioEngine::Stop(voice);
+        }
+    }
+    Marle::AudioEngine::Shutdown();
+}
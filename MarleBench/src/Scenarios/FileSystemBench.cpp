@@ -0,0 +1,263 @@
+#include "../Bench.h"
+
+#include "Marle/Core/FileSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <fcntl.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace MarleBench;
+
+using Clock = std::chrono::steady_clock;
+
+static const char* s_AssetPath = "/tmp/marlebench_fs";
+static const char* s_ArchivePath = "/tmp/marlebench_fs.mpak";
+static const uint32_t s_AssetCount = 512;
+
+// 16-64 KB, the size of a typical sprite sheet or shader, so every file fits a pooled buffer
+static size_t AssetSize(uint32_t index)
+{
+    return 16 * 1024 + (index * 7919u) % (48 * 1024);
+}
+
+static std::string AssetName(uint32_t index)
+{
+    return "asset_" + std::to_string(index) + ".bin";
+}
+
+static uint64_t s_AssetBytes = 0;
+
+static bool EnsureAssets()
+{
+    static bool written = false;
+    if (written) {
+        return true;
+    }
+
+#if defined(__unix__) || defined(__APPLE__)
+    mkdir(s_AssetPath, 0755);
+#endif
+    Marle::ArchiveWriter archive(s_ArchivePath);
+    std::vector<uint8_t> bytes;
+    s_AssetBytes = 0;
+    for (uint32_t i = 0; i < s_AssetCount; i++) {
+        bytes.resize(AssetSize(i));
+        for (size_t b = 0; b < bytes.size(); b++) {
+            bytes[b] = (uint8_t)(b * 31 + i);
+        }
+
+        std::string name = AssetName(i);
+        FILE* file = fopen((std::string(s_AssetPath) + "/" + name).c_str(), "wb");
+        if (!file) {
+            return false;
+        }
+        bool ok = fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+        fclose(file);
+        if (!ok || !archive.AddFile(name, bytes.data(), bytes.size())) {
+            return false;
+        }
+        s_AssetBytes += bytes.size();
+    }
+    written = archive.Finish();
+    return written;
+}
+
+// Drops the files from the page cache, where the file system honours the hint (not tmpfs)
+static void EvictAssets()
+{
+#if defined(__linux__)
+    for (uint32_t i = 0; i < s_AssetCount; i++) {
+        int file = open((std::string(s_AssetPath) + "/" + AssetName(i)).c_str(), O_RDONLY);
+        if (file >= 0) {
+            posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+            close(file);
+        }
+    }
+    int archive = open(s_ArchivePath, O_RDONLY);
+    if (archive >= 0) {
+        posix_fadvise(archive, 0, 0, POSIX_FADV_DONTNEED);
+        close(archive);
+    }
+#endif
+}
+
+static bool PrepareAssets(BenchState& state)
+{
+    if (!EnsureAssets()) {
+        state.Skip("could not write the test assets to /tmp");
+        return false;
+    }
+    state.SetItemsPerIteration(s_AssetCount);
+    state.SetBytesPerIteration(s_AssetBytes);
+    return true;
+}
+
+// Latency is from the start of the batch to each file being in memory, as an asset load that
+// asks for everything at once would see it.
+static void SetLatencyCounters(BenchState& state, double totalMs, double maxMs, uint64_t reads)
+{
+    state.SetCounter("avg_latency_ms", reads ? totalMs / reads : 0.0);
+    state.SetCounter("max_latency_ms", maxMs);
+}
+
+// The path the engine used before the FileSystem: one blocking std::ifstream per file, as
+// OpenGLShader::ReadFile did.
+static void RunIfstream(BenchState& state, bool cold)
+{
+    if (!PrepareAssets(state)) {
+        return;
+    }
+
+    double totalMs = 0.0, maxMs = 0.0;
+    uint64_t reads = 0;
+    std::string contents;
+    while (state.Run()) {
+        if (cold) {
+            state.PauseTiming();
+            EvictAssets();
+            state.ResumeTiming();
+        }
+
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < s_AssetCount; i++) {
+            std::ifstream stream(std::string(s_AssetPath) + "/" + AssetName(i), std::ios::in | std::ios::binary);
+            std::stringstream buffer;
+            buffer << stream.rdbuf();
+            contents = buffer.str();
+            DoNotOptimize(contents);
+
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            totalMs += ms;
+            maxMs = std::max(maxMs, ms);
+            reads++;
+        }
+    }
+    SetLatencyCounters(state, totalMs, maxMs, reads);
+}
+
+static void RunBlockingRead(BenchState& state)
+{
+    if (!PrepareAssets(state)) {
+        return;
+    }
+
+    double totalMs = 0.0, maxMs = 0.0;
+    uint64_t reads = 0;
+    Marle::FileBuffer data;
+    while (state.Run()) {
+        Clock::time_point start = Clock::now();
+        for (uint32_t i = 0; i < s_AssetCount; i++) {
+            Marle::FileSystem::ReadFile(std::string(s_AssetPath) + "/" + AssetName(i), data);
+            DoNotOptimize(data);
+
+            double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            totalMs += ms;
+            maxMs = std::max(maxMs, ms);
+            reads++;
+        }
+    }
+    SetLatencyCounters(state, totalMs, maxMs, reads);
+}
+
+// Every file is requested up front and the batch is pumped to completion, as a level load would
+static void RunAsync(BenchState& state, bool useIoUring, bool fromArchive, bool cold)
+{
+    if (!PrepareAssets(state)) {
+        return;
+    }
+
+    Marle::FileSystemSettings settings;
+    settings.UseIoUring = useIoUring;
+    Marle::FileSystem::Shutdown();
+    Marle::FileSystem::Init(settings);
+    Marle::FileSystem::Stats stats = Marle::FileSystem::GetStats();
+    if (useIoUring && std::string(stats.Backend) != "io_uring") {
+        state.Skip("io_uring is unavailable");
+    } else if (!fromArchive || Marle::FileSystem::MountArchive("Assets", s_ArchivePath)) {
+        std::string prefix = fromArchive ? std::string("Assets/") : std::string(s_AssetPath) + "/";
+        std::vector<std::string> paths;
+        for (uint32_t i = 0; i < s_AssetCount; i++) {
+            paths.push_back(prefix + AssetName(i));
+        }
+
+        uint64_t failures = 0;
+        while (state.Run()) {
+            if (cold) {
+                state.PauseTiming();
+                EvictAssets();
+                state.ResumeTiming();
+            }
+
+            for (const std::string& path : paths) {
+                Marle::FileSystem::ReadAsync(path, [&failures](Marle::FileReadResult& result) {
+                    failures += result.Success ? 0 : 1;
+                    DoNotOptimize(result.Data);
+                });
+            }
+            Marle::FileSystem::Flush();
+        }
+
+        stats = Marle::FileSystem::GetStats();
+        if (failures > 0) {
+            state.Skip("async reads failed");
+        }
+        state.SetCounter("avg_latency_ms", stats.AverageLatencyMs);
+        state.SetCounter("max_latency_ms", stats.MaxLatencyMs);
+        state.SetCounter("reads_per_submission", stats.Submissions ? (double)stats.Reads / stats.Submissions : 0.0);
+        state.SetCounter("peak_in_flight", stats.PeakInFlight);
+    } else {
+        state.Skip("could not mount the test archive");
+    }
+
+    Marle::FileSystem::Shutdown();
+    Marle::FileSystem::Init();
+}
+
+MRL_BENCHMARK(FileSystem_Ifstream_512Files, "filesystem", BenchFlagNone)
+{
+    RunIfstream(state, false);
+}
+
+MRL_BENCHMARK(FileSystem_Blocking_512Files, "filesystem", BenchFlagNone)
+{
+    RunBlockingRead(state);
+}
+
+MRL_BENCHMARK(FileSystem_AsyncIoUring_512Files, "filesystem", BenchFlagNone)
+{
+    RunAsync(state, true, false, false);
+}
+
+MRL_BENCHMARK(FileSystem_AsyncThreadPool_512Files, "filesystem", BenchFlagNone)
+{
+    RunAsync(state, false, false, false);
+}
+
+MRL_BENCHMARK(FileSystem_AsyncIoUring_Archive_512Files, "filesystem", BenchFlagNone)
+{
+    RunAsync(state, true, true, false);
+}
+
+MRL_BENCHMARK(FileSystem_Ifstream_Cold_512Files, "filesystem", BenchFlagNone)
+{
+    RunIfstream(state, true);
+}
+
+MRL_BENCHMARK(FileSystem_AsyncIoUring_Cold_512Files, "filesystem", BenchFlagNone)
+{
+    RunAsync(state, true, false, true);
+}
+
+MRL_BENCHMARK(FileSystem_AsyncThreadPool_Cold_512Files, "filesystem", BenchFlagNone)
+{
+    RunAsync(state, false, false, true);
+}
@@ -0,0 +1,176 @@
+#include "../Bench.h"
+
+#include "Marle/Navigation/FlowField.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace MarleBench;
+
+// Open ground with scattered wall segments and patches of slow terrain (fixed seed)
+static std::unique_ptr<Marle::NavGrid> MakeMap(uint32_t size)
+{
+    auto grid = std::make_unique<Marle::NavGrid>(size, size, 1.0f);
+    std::mt19937 rng(77);
+    uint32_t walls = size * size / 400;
+    for (uint32_t i = 0; i < walls; i++) {
+        uint32_t x = rng() % size;
+        uint32_t y = rng() % size;
+        uint32_t length = 8 + rng() % 24;
+        if (rng() % 2) {
+            grid->FillRect(x, y, length, 1, Marle::NavGrid::Blocked);
+        } else {
+            grid->FillRect(x, y, 1, length, Marle::NavGrid::Blocked);
+        }
+    }
+    for (uint32_t i = 0; i < walls / 8; i++) {
+        grid->FillRect(rng() % size, rng() % size, 12, 12, 4);
+    }
+    grid->FillRect(0, 0, 4, 4, 1);
+    grid->FillRect(size - 4, size - 4, 4, 4, 1);
+    return grid;
+}
+
+static void RequestEverySector(const Marle::NavGrid& grid, const Marle::FlowField& field)
+{
+    for (uint32_t y = 0; y < grid.GetHeight(); y += Marle::NavGrid::SectorSize) {
+        for (uint32_t x = 0; x < grid.GetWidth(); x += Marle::NavGrid::SectorSize) {
+            field.Request(grid.CellToWorld({ (int32_t)x, (int32_t)y }));
+        }
+    }
+}
+
+// Cost of a brand-new goal when the whole map is needed: portal search plus every sector
+MRL_BENCHMARK(FlowField_FullField_512, "scenario", BenchFlagNone)
+{
+    std::unique_ptr<Marle::NavGrid> grid = MakeMap(512);
+    grid->Rebuild();
+
+    state.SetItemsPerIteration(grid->GetSectorCount());
+    double searchMs = 0.0;
+    double buildMs = 0.0;
+    uint64_t fields = 0;
+    while (state.Run()) {
+        state.PauseTiming();
+        Marle::FlowFieldCache cache(*grid);
+        state.ResumeTiming();
+
+        std::shared_ptr<const Marle::FlowField> field = cache.GetField(glm::ivec2(1, 1));
+        RequestEverySector(*grid, *field);
+        cache.Update();
+        searchMs += cache.GetStats().SearchMs;
+        buildMs += cache.GetStats().BuildMs;
+        fields++;
+        DoNotOptimize(field->GetCost(glm::ivec2(500, 500)));
+    }
+    state.SetCounter("sectors", grid->GetSectorCount());
+    state.SetCounter("portals", grid->GetPortalCount());
+    state.SetCounter("search_ms", fields ? searchMs / fields : 0.0);
+    state.SetCounter("build_ms", fields ? buildMs / fields : 0.0);
+}
+
+// The hierarchical case: a 4096 x 4096 map where agents in one corner head for the other.
+// Only the corridor of sectors on the abstract path is built.
+MRL_BENCHMARK(FlowField_Corridor_4096, "scenario", BenchFlagNone)
+{
+    std::unique_ptr<Marle::NavGrid> grid = MakeMap(4096);
+    grid->Rebuild();
+
+    uint32_t built = 0;
+    double searchMs = 0.0;
+    double buildMs = 0.0;
+    uint64_t fields = 0;
+    while (state.Run()) {
+        state.PauseTiming();
+        Marle::FlowFieldCache cache(*grid);
+        state.ResumeTiming();
+
+        std::shared_ptr<const Marle::FlowField> field = cache.GetField(glm::ivec2(4093, 4093));
+        field->Request({ 2.0f, 2.0f });
+        cache.Update();
+        built = field->GetBuiltSectorCount();
+        searchMs += cache.GetStats().SearchMs;
+        buildMs += cache.GetStats().BuildMs;
+        fields++;
+        DoNotOptimize(field->GetDirection({ 2.0f, 2.0f }).x);
+    }
+    state.SetCounter("sectors", grid->GetSectorCount());
+    state.SetCounter("built_sectors", built);
+    state.SetCounter("search_ms", fields ? searchMs / fields : 0.0);
+    state.SetCounter("build_ms", fields ? buildMs / fields : 0.0);
+}
+
+// A door opening or closing somewhere each step, with four live goals fully built:
+// only sectors whose cells or portal distances changed are rebuilt
+MRL_BENCHMARK(FlowField_IncrementalEdit_512, "scenario", BenchFlagNone)
+{
+    std::unique_ptr<Marle::NavGrid> grid = MakeMap(512);
+    Marle::FlowFieldCache cache(*grid);
+    std::vector<std::shared_ptr<const Marle::FlowField>> fields = {
+        cache.GetField(glm::ivec2(1, 1)), cache.GetField(glm::ivec2(510, 510)),
+        cache.GetField(glm::ivec2(1, 510)), cache.GetField(glm::ivec2(510, 1))
+    };
+    for (const auto& field : fields) {
+        if (field) {
+            RequestEverySector(*grid, *field);
+        }
+    }
+    cache.Update();
+    uint32_t fullSectors = cache.GetStats().BuiltSectors;
+
+    std::mt19937 rng(5);
+    uint64_t rebuilt = 0;
+    uint64_t edits = 0;
+    while (state.Run()) {
+        uint32_t x = 8 + rng() % 496;
+        uint32_t y = 8 + rng() % 496;
+        uint8_t cost = (edits % 2) ? 1 : Marle::NavGrid::Blocked;
+        grid->FillRect(x, y, 1, 6, cost);
+        cache.Update();
+        rebuilt += cache.GetStats().RebuiltSectors;
+        edits++;
+    }
+    state.SetCounter("built_sectors", fullSectors);
+    state.SetCounter("rebuilt_per_edit", edits ? (double)rebuilt / edits : 0.0);
+}
+
+// Per-agent cost of the lookup and a step with wall sliding, over a fully built field
+MRL_BENCHMARK(FlowField_AgentStep_10000, "scenario", BenchFlagNone)
+{
+    const uint32_t agentCount = 10000;
+    std::unique_ptr<Marle::NavGrid> grid = MakeMap(512);
+    Marle::FlowFieldCache cache(*grid);
+    std::shared_ptr<const Marle::FlowField> field = cache.GetField(glm::ivec2(256, 256));
+    if (!field) {
+        field = cache.GetField(glm::ivec2(1, 1));
+    }
+    RequestEverySector(*grid, *field);
+    cache.Update();
+
+    std::mt19937 rng(9);
+    std::vector<glm::vec2> agents;
+    while (agents.size() < agentCount) {
+        glm::ivec2 cell((int32_t)(rng() % 512), (int32_t)(rng() % 512));
+        if (grid->IsWalkable(cell)) {
+            agents.push_back(grid->CellToWorld(cell));
+        }
+    }
+
+    const float step = 0.25f;
+    state.SetItemsPerIteration(agentCount);
+    while (state.Run()) {
+        for (glm::vec2& agent : agents) {
+            glm::vec2 direction = field->GetDirection(agent);
+            glm::vec2 next(agent.x + direction.x * step, agent.y);
+            if (grid->IsWalkable(grid->WorldToCell(next))) {
+                agent = next;
+            }
+            next = glm::vec2(agent.x, agent.y + direction.y * step);
+            if (grid->IsWalkable(grid->WorldToCell(next))) {
+                agent = next;
+            }
+        }
+        DoNotOptimize(agents[0].x);
+    }
+}
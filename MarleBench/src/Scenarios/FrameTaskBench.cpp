@@ -0,0 +1,119 @@
+#include "../Bench.h"
+
+#include "Marle/Core/FrameTaskScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace MarleBench;
+
+using Clock = std::chrono::steady_clock;
+
+static const double s_TargetFrameMs = 1000.0 / 60.0;
+static const double s_GameWorkMs = 9.0;             // Update and render before the tasks get their turn
+static const uint32_t s_RebuildChunks = 2048;
+static const uint32_t s_ChunkItems = 2048;          // A few microseconds each: a cache or nav rebuild in pieces
+
+static void RebuildChunk(std::vector<float>& values, uint32_t chunk)
+{
+    float* begin = values.data() + (size_t)chunk * s_ChunkItems;
+    for (uint32_t i = 0; i < s_ChunkItems; i++) {
+        begin[i] = begin[i] * 0.999f + sinf(begin[i] + (float)chunk);
+    }
+}
+
+static double ElapsedMs(Clock::time_point since)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - since).count();
+}
+
+// A 60 Hz frame loop paced like a vsynced swap: fixed game work, then the task slice, then a
+// wait for the next interval (or none once the frame has already overrun it). One iteration
+// is one complete rebuild; the counters say what it did to the frames it landed on.
+static void RunRebuild(BenchState& state, bool amortized)
+{
+    bool ownScheduler = !Marle::FrameTaskScheduler::IsInitialized();
+    if (ownScheduler) {
+        Marle::FrameTaskScheduler::Init(s_TargetFrameMs);
+    }
+
+    std::vector<float> values((size_t)s_RebuildChunks * s_ChunkItems, 1.0f);
+    const auto frameLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double, std::milli>(s_TargetFrameMs));
+
+    double workMs = 0.0, maxFrameMs = 0.0;
+    uint64_t frames = 0, overrunFrames = 0, rebuilds = 0;
+
+    state.SetItemsPerIteration(s_RebuildChunks);
+    while (state.Run()) {
+        uint32_t cursor = 0;
+        if (amortized) {
+            Marle::FrameTaskScheduler::Submit("BenchRebuild", [&values, &cursor](Marle::FrameTaskContext& context) {
+                RebuildChunk(values, cursor++);
+                context.SetProgress((float)cursor / (float)s_RebuildChunks);
+                return cursor == s_RebuildChunks;
+            });
+        }
+
+        auto nextFrame = Clock::now();
+        while (cursor < s_RebuildChunks) {
+            auto frameStart = Clock::now();
+            Marle::FrameTaskScheduler::BeginFrame();
+            while (ElapsedMs(frameStart) < s_GameWorkMs) {
+                // Stand-in for the frame's own update and render work
+            }
+
+            if (amortized) {
+                Marle::FrameTaskScheduler::Execute();
+            } else {
+                auto start = Clock::now();
+                for (; cursor < s_RebuildChunks; cursor++) {
+                    RebuildChunk(values, cursor);
+                }
+                workMs += ElapsedMs(start);
+            }
+
+            double frameMs = ElapsedMs(frameStart);
+            maxFrameMs = std::max(maxFrameMs, frameMs);
+            overrunFrames += frameMs > s_TargetFrameMs ? 1 : 0;
+            frames++;
+
+            nextFrame += frameLength;
+            if (Clock::now() < nextFrame) {
+                std::this_thread::sleep_until(nextFrame);
+            } else {
+                nextFrame = Clock::now();
+            }
+        }
+        rebuilds++;
+        DoNotOptimize(values[0]);
+    }
+
+    const Marle::FrameTaskScheduler::Stats& stats = Marle::FrameTaskScheduler::GetStats();
+    state.SetCounter("frames_per_rebuild", rebuilds ? (double)frames / (double)rebuilds : 0.0);
+    state.SetCounter("max_frame_ms", maxFrameMs);
+    state.SetCounter("overrun_frames_per_rebuild", rebuilds ? (double)overrunFrames / (double)rebuilds : 0.0);
+    if (amortized) {
+        state.SetCounter("ceiling_ms", stats.CeilingMs);
+    } else {
+        state.SetCounter("rebuild_ms", rebuilds ? workMs / (double)rebuilds : 0.0);
+    }
+
+    if (ownScheduler) {
+        Marle::FrameTaskScheduler::Shutdown();
+    }
+}
+
+// The whole rebuild on the frame that asked for it
+MRL_BENCHMARK(FrameTasks_Rebuild_OneShot, "scenario", BenchFlagNone)
+{
+    RunRebuild(state, false);
+}
+
+// The same rebuild as a step task: one chunk per step inside the leftover frame time
+MRL_BENCHMARK(FrameTasks_Rebuild_Amortized, "scenario", BenchFlagNone)
+{
+    RunRebuild(state, true);
+}
@@ -0,0 +1,129 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Core/ResourceManager.h"
+#include "Marle/Platform/OpenGL/OpenGLShader.h"
+#include "Marle/Platform/OpenGL/OpenGLTexture.h"
+
+#include <memory>
+#include <vector>
+
+using namespace MarleBench;
+
+// There is no level format yet, so a "level" is the asset set a Sandbox-style game loads in its
+// constructor: the sprite shader plus a sprite library. Every entry is loaded independently,
+// exactly as separate game objects would do today.
+struct LevelManifest {
+    const char* VertexShader;
+    const char* FragmentShader;
+    std::vector<const char*> Textures;
+};
+
+static LevelManifest MakeTestLevel(int textureCount)
+{
+    LevelManifest level{ "Assets/Shaders/Texture.vert", "Assets/Shaders/Texture.frag", {} };
+    for (int i = 0; i < textureCount; i++) {
+        level.Textures.push_back("Assets/Textures/test_sprite.tga");
+    }
+    return level;
+}
+
+static void RunLevelLoad(BenchState& state, int textureCount)
+{
+    LevelManifest level = MakeTestLevel(textureCount);
+
+    std::vector<uint8_t> probe;
+    if (!ReadFileBytes(level.Textures.front(), probe)) {
+        state.Skip("Assets/Textures/test_sprite.tga not found (run from the repository root)");
+        return;
+    }
+
+    state.SetItemsPerIteration(level.Textures.size() + 1);
+    state.SetBytesPerIteration(probe.size() * level.Textures.size());
+
+    std::unique_ptr<Marle::OpenGLShader> shader;
+    std::vector<std::unique_ptr<Marle::OpenGLTexture2D>> textures;
+    textures.reserve(level.Textures.size());
+
+    while (state.Run()) {
+        shader = std::make_unique<Marle::OpenGLShader>(level.VertexShader, level.FragmentShader);
+        for (const char* path : level.Textures) {
+            textures.push_back(std::make_unique<Marle::OpenGLTexture2D>(path));
+        }
+        FinishGL();
+
+        // Unloading is not part of the load cost
+        state.PauseTiming();
+        textures.clear();
+        shader.reset();
+        FinishGL();
+        state.ResumeTiming();
+    }
+}
+
+MRL_BENCHMARK(LevelLoad_16Textures, "scenario", BenchFlagRequiresGL)
+{
+    RunLevelLoad(state, 16);
+}
+
+MRL_BENCHMARK(LevelLoad_128Textures, "scenario", BenchFlagRequiresGL)
+{
+    RunLevelLoad(state, 128);
+}
+
+// The same level through ResourceManager. Duplicate paths collapse into one load; with warm=true
+// the previous level's resources stay cached between iterations, which is what a transition
+// back into an already visited level costs.
+static void RunManagedLevelLoad(BenchState& state, int textureCount, bool warm)
+{
+    LevelManifest level = MakeTestLevel(textureCount);
+
+    std::vector<uint8_t> probe;
+    if (!ReadFileBytes(level.Textures.front(), probe)) {
+        state.Skip("Assets/Textures/test_sprite.tga not found (run from the repository root)");
+        return;
+    }
+
+    state.SetItemsPerIteration(level.Textures.size() + 1);
+    Marle::ResourceManager::ClearCache();
+    Marle::ResourceManager::TypeStats before = Marle::ResourceManager::GetStats(Marle::ResourceType::Texture);
+
+    Marle::ResourceHandle<Marle::OpenGLShader> shader;
+    std::vector<Marle::ResourceHandle<Marle::OpenGLTexture2D>> textures;
+    textures.reserve(level.Textures.size());
+
+    while (state.Run()) {
+        shader = Marle::ResourceManager::Load<Marle::OpenGLShader>("Assets/Shaders/Texture");
+        for (const char* path : level.Textures) {
+            textures.push_back(Marle::ResourceManager::LoadAsync<Marle::OpenGLTexture2D>(path));
+        }
+        while (textures.back().IsLoading()) {
+            Marle::ResourceManager::Update();
+        }
+        FinishGL();
+
+        state.PauseTiming();
+        textures.clear();
+        shader.Reset();
+        if (!warm) {
+            Marle::ResourceManager::ClearCache();
+        }
+        FinishGL();
+        state.ResumeTiming();
+    }
+
+    Marle::ResourceManager::TypeStats after = Marle::ResourceManager::GetStats(Marle::ResourceType::Texture);
+    uint64_t requests = after.Requests - before.Requests;
+    state.SetCounter("texture_hit_rate", requests ? (double)(after.Hits - before.Hits) / (double)requests : 0.0);
+    Marle::ResourceManager::ClearCache();
+}
+
+MRL_BENCHMARK(LevelLoad_128Textures_Managed, "scenario", BenchFlagRequiresGL)
+{
+    RunManagedLevelLoad(state, 128, false);
+}
+
+MRL_BENCHMARK(LevelTransition_128Textures_Warm, "scenario", BenchFlagRequiresGL)
+{
+    RunManagedLevelLoad(state, 128, true);
+}
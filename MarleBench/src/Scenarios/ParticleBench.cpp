@@ -0,0 +1,87 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Renderer/ParticleSystem.h"
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Renderer/Renderer2D.h"
+
+using namespace MarleBench;
+
+static const float s_FixedStep = 1.0f / 60.0f;
+
+// Steady-state fountain: emission rate * average lifetime ~= liveTarget
+static Marle::ParticleEmitterProps MakeStressEmitter(uint32_t liveTarget)
+{
+    Marle::ParticleEmitterProps props;
+    props.Position = { 512.0f, 200.0f };
+    props.VelocityMin = { -150.0f, 100.0f };
+    props.VelocityMax = { 150.0f, 400.0f };
+    props.Acceleration = { 0.0f, -300.0f };
+    props.ColorMin = { 0.2f, 0.5f, 1.0f, 1.0f };
+    props.ColorMax = { 0.6f, 0.9f, 1.0f, 1.0f };
+    props.SizeBegin = 4.0f;
+    props.SizeEnd = 1.0f;
+    props.LifetimeMin = 1.0f;
+    props.LifetimeMax = 2.0f;
+    props.EmissionRate = (float)liveTarget / 1.5f;
+    props.MaxParticles = liveTarget + liveTarget / 4;
+    props.BlendMode = Marle::ParticleBlendMode::Additive;
+    return props;
+}
+
+static void RunParticleStress(BenchState& state, uint32_t liveTarget, bool render)
+{
+    if (render) {
+        Marle::Renderer2D::Init();
+    }
+
+    {
+        Marle::ParticleSystem system;
+        system.CreateEmitter(MakeStressEmitter(liveTarget));
+
+        // Three seconds of simulation to reach steady state
+        for (int i = 0; i < 180; i++) {
+            system.Update(s_FixedStep);
+        }
+        state.SetItemsPerIteration(system.GetAliveCount());
+
+        double measuredSeconds = 0.0;
+        uint64_t particlesUpdated = 0;
+        while (state.Run()) {
+            double start = NowSeconds();
+            system.Update(s_FixedStep);
+            if (render) {
+                glClear(GL_COLOR_BUFFER_BIT);
+                Marle::Renderer2D::BeginScene();
+                system.Render();
+                Marle::Renderer2D::EndScene();
+                FinishGL();
+            }
+            measuredSeconds += NowSeconds() - start;
+            particlesUpdated += system.GetAliveCount();
+        }
+
+        state.SetCounter("live_particles", system.GetAliveCount());
+        state.SetCounter("particles_per_ms", measuredSeconds > 0.0 ? (double)particlesUpdated / (measuredSeconds * 1e3) : 0.0);
+        state.SetCounter("worker_threads", Marle::JobSystem::GetWorkerCount());
+    }
+
+    if (render) {
+        Marle::Renderer2D::Shutdown();
+    }
+}
+
+MRL_BENCHMARK(ParticleStress_Update_100k, "scenario", BenchFlagNone)
+{
+    RunParticleStress(state, 100000, false);
+}
+
+MRL_BENCHMARK(ParticleStress_Update_500k, "scenario", BenchFlagNone)
+{
+    RunParticleStress(state, 500000, false);
+}
+
+MRL_BENCHMARK(ParticleStress_Frame_100k, "scenario", BenchFlagRequiresGL)
+{
+    RunParticleStress(state, 100000, true);
+}
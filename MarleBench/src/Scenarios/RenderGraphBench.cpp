@@ -0,0 +1,118 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Renderer/RenderGraph.h"
+#include "Marle/Renderer/Renderer2D.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace MarleBench;
+
+static void ReportGraph(BenchState& state)
+{
+    const Marle::RenderGraph::Stats& stats = Marle::RenderGraph::GetStats();
+    const double mb = 1.0 / (1024.0 * 1024.0);
+    state.SetCounter("passes", stats.Passes);
+    state.SetCounter("culled_passes", stats.CulledPasses);
+    state.SetCounter("transient_targets", stats.TransientTargets);
+    state.SetCounter("framebuffers", stats.PhysicalTargets);
+    state.SetCounter("transient_mb", stats.TransientBytes * mb);
+    state.SetCounter("unaliased_mb", stats.UnaliasedBytes * mb);
+    state.SetCounter("peak_transient_mb", stats.PeakTransientBytes * mb);
+}
+
+// Post-processing frame at 1024x768: an HDR scene, a bloom chain that halves down `levels`
+// times and blurs back up, and a tonemap into the backbuffer. Every blur step has its own
+// target, so the counters show how far aliasing gets below one framebuffer per target.
+// A debug view nobody reads is added each frame to exercise culling.
+static void RunBloomFrame(BenchState& state, int levels)
+{
+    Marle::Renderer2D::Init();
+    Marle::RenderGraph::Init();
+    auto texture = std::make_unique<Marle::OpenGLTexture2D>("Assets/Textures/test_sprite.tga");
+    if (texture->GetRendererID() == 0) {
+        state.Skip("Assets/Textures/test_sprite.tga not found (run from the repository root)");
+        Marle::RenderGraph::Shutdown();
+        Marle::Renderer2D::Shutdown();
+        return;
+    }
+
+    using Graph = Marle::RenderGraph;
+    Graph::TargetDesc hdr;
+    hdr.Format = Marle::FramebufferFormat::RGBA16F;
+
+    Graph::TargetDesc ldr;
+    std::vector<Marle::RenderGraphResource> chain(levels * 2);
+    Marle::RenderGraphResource scene = Graph::InvalidResource;
+
+    while (state.Run()) {
+        Graph::BeginFrame(1024, 768);
+
+        Graph::AddPass("Scene",
+            [&](Graph::PassBuilder& builder) { scene = builder.Write(builder.Create("SceneColor", hdr), true); },
+            [&](Graph::PassContext&) {
+                Marle::Renderer2D::BeginScene();
+                for (int i = 0; i < 256; i++) {
+                    Marle::Renderer2D::DrawQuad({ (float)(i % 16) * 64.0f + 32.0f, (float)(i / 16) * 48.0f + 24.0f },
+                                                { 48.0f, 48.0f }, texture.get());
+                }
+                Marle::Renderer2D::EndScene();
+            });
+
+        Graph::AddPass("DebugView",
+            [&](Graph::PassBuilder& builder) {
+                builder.Read(scene);
+                builder.Write(builder.Create("DebugColor", ldr));
+            },
+            [&](Graph::PassContext& context) { Marle::Renderer2D::Blit(context.GetTexture(scene)); });
+
+        // Down: level i is 1/2^(i+1) of the screen; up: back through the same sizes
+        for (int i = 0; i < levels * 2; i++) {
+            int size = i < levels ? i : levels * 2 - 2 - i;
+            Graph::TargetDesc desc = hdr;
+            desc.Scale = 1.0f / (float)(2 << std::max(size, 0));
+            Marle::RenderGraphResource source = i == 0 ? scene : chain[i - 1];
+            Graph::AddPass(i < levels ? "BloomDown" : "BloomUp",
+                [&chain, i, source, desc](Graph::PassBuilder& builder) {
+                    builder.Read(source);
+                    chain[i] = builder.Write(builder.Create("Bloom", desc));
+                },
+                [source](Graph::PassContext& context) { Marle::Renderer2D::Blit(context.GetTexture(source)); });
+        }
+
+        Graph::AddPass("Tonemap",
+            [&](Graph::PassBuilder& builder) {
+                builder.Read(scene);
+                builder.Read(chain.back());
+                builder.Write(Graph::GetBackbuffer());
+            },
+            [&](Graph::PassContext& context) {
+                Marle::Renderer2D::Blit(context.GetTexture(scene));
+                Marle::Renderer2D::Blit(context.GetTexture(chain.back()), { 0.75f, 0.75f }, { 1.0f, 1.0f });
+            });
+
+        Graph::Execute();
+        FinishGL();
+    }
+
+    state.SetItemsPerIteration(1);
+    ReportGraph(state);
+
+    texture.reset();
+    Marle::RenderGraph::Shutdown();
+    Marle::Renderer2D::Shutdown();
+}
+
+static bool RegisterBloomFrames()
+{
+    for (int levels : { 3, 6 }) {
+        RegisterBenchmark("RenderGraph_Bloom_" + std::to_string(levels) + "Levels", "scenario", BenchFlagRequiresGL,
+                          [levels](BenchState& state) { RunBloomFrame(state, levels); });
+    }
+    return true;
+}
+
+static const bool s_BloomFramesRegistered = RegisterBloomFrames();
@@ -0,0 +1,89 @@
+#include "../Bench.h"
+
+#include "Marle/Network/Replication.h"
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace MarleBench;
+
+// A server and 8 clients over real UDP on 127.0.0.1, with 5% loss, 50 ms latency and 10 ms
+// jitter applied on both sides. 1000 entities, a tenth of them moving. One iteration is ten
+// simulated seconds at 60 ticks; the network clock is simulated, so it runs as fast as it can.
+MRL_BENCHMARK(Replication_Loopback_8Clients, "scenario", BenchFlagNone)
+{
+    const uint32_t clientCount = 8;
+    const uint32_t entityCount = 1000;
+    const double dt = 1.0 / 60.0;
+
+    Marle::ReplicationSchema schema;
+    schema.AddFloat("X", 0.0f, 4096.0f, 0.05f);
+    schema.AddFloat("Y", 0.0f, 4096.0f, 0.05f);
+    schema.AddInt("Kind", 0, 15);
+    schema.AddBool("Active");
+
+    Marle::NetConditions conditions;
+    conditions.LossPercent = 5.0f;
+    conditions.LatencyMs = 50.0f;
+    conditions.JitterMs = 10.0f;
+
+    double bytesPerClient = 0.0, encodeNs = 0.0, snapshotBytes = 0.0, rtt = 0.0;
+    uint64_t fullSnapshots = 0, starved = 0, decodeErrors = 0, runs = 0;
+    state.SetItemsPerIteration(600);
+    while (state.Run()) {
+        state.PauseTiming();
+        Marle::ReplicationServerConfig config;
+        Marle::ReplicationServer server(schema, config);
+        if (!server.Start(0)) {
+            state.Skip("could not open a UDP socket");
+            return;
+        }
+        server.SetConditions(conditions);
+        std::vector<std::unique_ptr<Marle::ReplicationClient>> clients;
+        for (uint32_t i = 0; i < clientCount; i++) {
+            clients.push_back(std::make_unique<Marle::ReplicationClient>(schema));
+            clients.back()->SetConditions(conditions);
+            clients.back()->Connect(Marle::NetAddress(127, 0, 0, 1, server.GetPort()));
+        }
+        state.ResumeTiming();
+
+        for (uint32_t tick = 0; tick < 600; tick++) {
+            server.Update(dt);
+            server.BeginSnapshot();
+            for (uint32_t i = 0; i < entityCount; i++) {
+                float t = (i % 10 == 0) ? tick * (float)dt : 0.0f;
+                float values[4] = { 2048.0f + 1500.0f * sinf(t * 0.3f + i), 2048.0f + 1500.0f * cosf(t * 0.2f + i),
+                                    (float)(i % 16), 1.0f };
+                server.WriteEntity(i, values);
+            }
+            server.EndSnapshot();
+            for (auto& client : clients) {
+                client->Update(dt);
+                DoNotOptimize(client->Interpolate(0.5).data());
+            }
+        }
+
+        const Marle::ReplicationServer::Stats& stats = server.GetStats();
+        bytesPerClient += stats.BytesPerClientPerSecond;
+        encodeNs += stats.EncodeNsPerEntity;
+        snapshotBytes += stats.AverageSnapshotBytes;
+        rtt += stats.RttMs;
+        fullSnapshots += stats.FullSnapshots;
+        for (auto& client : clients) {
+            starved += client->GetStats().StarvedFrames;
+            decodeErrors += client->GetStats().DecodeErrors;
+        }
+        runs++;
+    }
+    if (runs == 0) {
+        return;
+    }
+    state.SetCounter("bytes_per_client_per_s", bytesPerClient / runs);
+    state.SetCounter("encode_ns_per_entity", encodeNs / runs);
+    state.SetCounter("snapshot_bytes", snapshotBytes / runs);
+    state.SetCounter("rtt_ms", rtt / runs);
+    state.SetCounter("full_snapshots", (double)fullSnapshots / runs);
+    state.SetCounter("starved_frames", (double)starved / runs);
+    state.SetCounter("decode_errors", (double)decodeErrors / runs);
+}
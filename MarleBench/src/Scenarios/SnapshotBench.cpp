@@ -0,0 +1,147 @@
+#include "../Bench.h"
+
+#include "Marle/Core/Snapshot.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace MarleBench;
+
+// Scene-object sized record with a pointer to its parent, so loads exercise the fix-up pass
+struct BenchSceneObject {
+    float PositionX, PositionY;
+    float VelocityX, VelocityY;
+    float Rotation, Scale;
+    uint32_t Sprite;
+    uint32_t Flags;
+    Marle::SnapshotPtr<BenchSceneObject> Parent;
+};
+
+static const uint32_t s_ObjectCount = 100000;
+static const char* s_SnapshotPath = "/tmp/marlebench_scene.snap";
+
+static std::vector<BenchSceneObject> MakeScene(uint32_t count)
+{
+    std::vector<BenchSceneObject> objects(count);
+    for (uint32_t i = 0; i < count; i++) {
+        BenchSceneObject& o = objects[i];
+        o.PositionX = (float)(i % 1000) * 4.0f;
+        o.PositionY = (float)(i / 1000) * 4.0f;
+        o.VelocityX = o.VelocityY = 0.0f;
+        o.Rotation = 0.0f;
+        o.Scale = 1.0f;
+        o.Sprite = i % 64;
+        o.Flags = 0;
+        o.Parent = i ? Marle::SnapshotPtr<BenchSceneObject>::FromIndex(i / 8) : Marle::SnapshotPtr<BenchSceneObject>();
+    }
+    return objects;
+}
+
+static void Capture(Marle::SnapshotSaver& saver, const std::vector<BenchSceneObject>& objects, Marle::SnapshotCapture*& capture)
+{
+    capture = saver.BeginCapture();
+    uint32_t section = capture->AddSection("objects", 1, objects.data(), objects.size() * sizeof(BenchSceneObject));
+    capture->AddPointers(section, offsetof(BenchSceneObject, Parent), sizeof(BenchSceneObject), objects.size(), section);
+}
+
+// Game-thread cost of an autosave: copying the state into the double-buffered capture
+MRL_BENCHMARK(Snapshot_Capture_100k, "scenario", BenchFlagNone)
+{
+    std::vector<BenchSceneObject> objects = MakeScene(s_ObjectCount);
+    Marle::SnapshotSaver saver;
+    state.SetBytesPerIteration(objects.size() * sizeof(BenchSceneObject));
+
+    while (state.Run()) {
+        Marle::SnapshotCapture* capture = nullptr;
+        Capture(saver, objects, capture);
+
+        state.PauseTiming();
+        saver.SaveNow(capture, s_SnapshotPath);
+        state.ResumeTiming();
+    }
+    remove(s_SnapshotPath);
+}
+
+static void RunSnapshotSave(BenchState& state, bool incremental)
+{
+    std::vector<BenchSceneObject> objects = MakeScene(s_ObjectCount);
+    std::unique_ptr<Marle::SnapshotSaver> saver = std::make_unique<Marle::SnapshotSaver>();
+    state.SetBytesPerIteration(objects.size() * sizeof(BenchSceneObject));
+
+    uint64_t bytesWritten = 0, blocksWritten = 0, blocksTotal = 0, saves = 0;
+    uint32_t frame = 0;
+    while (state.Run()) {
+        state.PauseTiming();
+        if (incremental) {
+            // 1% of the objects moved, clustered the way a region of the scene would be
+            uint32_t first = (frame * 7919u) % (s_ObjectCount - s_ObjectCount / 100);
+            for (uint32_t i = first; i < first + s_ObjectCount / 100; i++) {
+                objects[i].PositionX += 1.0f;
+            }
+        } else {
+            // A fresh saver has no block hashes, so everything is written
+            saver = std::make_unique<Marle::SnapshotSaver>();
+        }
+        Marle::SnapshotCapture* capture = nullptr;
+        Capture(*saver, objects, capture);
+        state.ResumeTiming();
+
+        saver->SaveAsync(capture, s_SnapshotPath);
+        saver->WaitForSaves();
+
+        Marle::SnapshotSaver::SaveStats stats = saver->GetLastSaveStats();
+        bytesWritten += stats.BytesWritten;
+        blocksWritten += stats.BlocksWritten;
+        blocksTotal += stats.BlocksTotal;
+        saves++;
+        frame++;
+    }
+
+    if (saves > 0) {
+        state.SetCounter("bytes_written_per_save", (double)bytesWritten / saves);
+        state.SetCounter("blocks_rewritten_fraction", blocksTotal ? (double)blocksWritten / blocksTotal : 0.0);
+    }
+    remove(s_SnapshotPath);
+}
+
+MRL_BENCHMARK(Snapshot_SaveFull_100k, "scenario", BenchFlagNone)
+{
+    RunSnapshotSave(state, false);
+}
+
+MRL_BENCHMARK(Snapshot_SaveIncremental_100k, "scenario", BenchFlagNone)
+{
+    RunSnapshotSave(state, true);
+}
+
+// Map + pointer fix-up + touching every object through its parent pointer
+MRL_BENCHMARK(Snapshot_Load_100k, "scenario", BenchFlagNone)
+{
+    {
+        std::vector<BenchSceneObject> objects = MakeScene(s_ObjectCount);
+        Marle::SnapshotSaver saver;
+        Marle::SnapshotCapture* capture = nullptr;
+        Capture(saver, objects, capture);
+        if (!saver.SaveNow(capture, s_SnapshotPath)) {
+            state.Skip("could not write the test snapshot");
+            return;
+        }
+        state.SetBytesPerIteration(objects.size() * sizeof(BenchSceneObject));
+    }
+
+    while (state.Run()) {
+        Marle::Snapshot snapshot;
+        snapshot.Load(s_SnapshotPath);
+
+        size_t count = 0;
+        const BenchSceneObject* objects = snapshot.GetArray<BenchSceneObject>("objects", count);
+        float sum = 0.0f;
+        for (size_t i = 1; i < count; i++) {
+            sum += objects[i].Parent.Get()->PositionX;
+        }
+        DoNotOptimize(sum);
+    }
+    remove(s_SnapshotPath);
+}
@@ -0,0 +1,107 @@
+#include "../Bench.h"
+
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Renderer/SoftwareRenderer.h"
+
+#include <cmath>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace MarleBench;
+
+static const uint32_t TargetWidth = 1024;
+static const uint32_t TargetHeight = 768;
+
+// 32x32 sprite with a soft alpha edge, so blending and the opaque-texel fast path both run
+static std::unique_ptr<Marle::SoftwareTexture> MakeSprite()
+{
+    const uint32_t size = 32;
+    std::vector<uint8_t> rgba(size * size * 4);
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            float dx = ((float)x + 0.5f) / (float)size - 0.5f;
+            float dy = ((float)y + 0.5f) / (float)size - 0.5f;
+            float d = 1.0f - 2.0f * std::sqrt(dx * dx + dy * dy);
+            uint8_t* texel = &rgba[(y * size + x) * 4];
+            texel[0] = (uint8_t)(x * 8);
+            texel[1] = (uint8_t)(y * 8);
+            texel[2] = 160;
+            texel[3] = (uint8_t)(d <= 0.0f ? 0 : d >= 0.25f ? 255 : d * 4.0f * 255.0f);
+        }
+    }
+    return std::make_unique<Marle::SoftwareTexture>(size, size, rgba.data());
+}
+
+// One software frame: clear, N 32x32 sprites on a grid covering the target, then a full-screen
+// translucent quad over everything, binned and rasterized on the given number of threads
+static void RunSoftwareRaster(BenchState& state, int spriteCount, uint32_t threads)
+{
+    if (threads > Marle::JobSystem::GetWorkerCount() + 1) {
+        state.Skip("fewer JobSystem threads than requested");
+        return;
+    }
+
+    std::unique_ptr<Marle::SoftwareTexture> sprite = MakeSprite();
+    Marle::SoftwareRasterizer rasterizer(TargetWidth, TargetHeight);
+    rasterizer.SetThreadCount(threads);
+
+    const int columns = 64;
+    const float cellX = (float)TargetWidth / (float)columns;
+    const float cellY = (float)TargetHeight / (float)((spriteCount + columns - 1) / columns);
+
+    std::vector<Marle::SoftwareRasterizer::Quad> quads((size_t)spriteCount + 1);
+    for (int i = 0; i < spriteCount; i++) {
+        float x = ((float)(i % columns) + 0.5f) * cellX;
+        float y = ((float)(i / columns) + 0.5f) * cellY;
+        Marle::SoftwareRasterizer::Quad& quad = quads[i];
+        quad.X0 = x - 16.0f; quad.Y0 = y - 16.0f; quad.X1 = x + 16.0f; quad.Y1 = y + 16.0f;
+        quad.U0 = 0.0f; quad.V0 = 0.0f; quad.U1 = 1.0f; quad.V1 = 1.0f;
+        quad.Texture = sprite.get();
+    }
+    Marle::SoftwareRasterizer::Quad& overlay = quads.back();
+    overlay.X0 = 0.0f; overlay.Y0 = 0.0f; overlay.X1 = (float)TargetWidth; overlay.Y1 = (float)TargetHeight;
+    overlay.U0 = 0.0f; overlay.V0 = 0.0f; overlay.U1 = 1.0f; overlay.V1 = 1.0f;
+    overlay.Color = 0x40FFC080;
+
+    uint64_t pixels = 0;
+    double binMs = 0.0;
+    double rasterMs = 0.0;
+    uint64_t frames = 0;
+    while (state.Run()) {
+        rasterizer.Clear(0xFF202020);
+        for (const Marle::SoftwareRasterizer::Quad& quad : quads) {
+            rasterizer.Submit(quad);
+        }
+        rasterizer.Flush();
+
+        const Marle::SoftwareRasterizer::Stats& stats = rasterizer.GetStats();
+        pixels = stats.Pixels;
+        binMs += stats.BinMs;
+        rasterMs += stats.RasterMs;
+        frames++;
+        DoNotOptimize(rasterizer.GetPixel(TargetWidth / 2, TargetHeight / 2));
+    }
+
+    state.SetItemsPerIteration(pixels);
+    state.SetCounter("sprites", spriteCount);
+    state.SetCounter("threads", rasterizer.GetStats().Threads);
+    state.SetCounter("pixels_per_frame", (double)pixels);
+    if (frames > 0) {
+        state.SetCounter("bin_ms", binMs / (double)frames);
+        state.SetCounter("raster_ms", rasterMs / (double)frames);
+        double seconds = (binMs + rasterMs) / 1000.0;
+        state.SetCounter("mpixels_per_s", seconds > 0.0 ? (double)pixels * (double)frames / seconds / 1e6 : 0.0);
+    }
+}
+
+static bool RegisterSoftwareRaster()
+{
+    for (uint32_t threads : { 1u, 2u, 4u, 8u }) {
+        RegisterBenchmark("SoftwareRaster_Sprites_" + std::to_string(threads) + "T", "scenario", BenchFlagNone,
+                          [threads](BenchState& state) { RunSoftwareRaster(state, 10000, threads); });
+    }
+    return true;
+}
+
+static const bool s_SoftwareRasterRegistered = RegisterSoftwareRaster();
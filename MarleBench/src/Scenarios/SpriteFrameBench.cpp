@@ -0,0 +1,69 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Renderer/RenderProfiler.h"
+#include "Marle/Renderer/Renderer2D.h"
+
+#include <memory>
+#include <string>
+
+using namespace MarleBench;
+
+// One full frame: clear, N sprites through Renderer2D, GPU drained. Sprites are laid out on a
+// grid that covers the 1024x768 target so fill cost stays representative as N grows.
+static void RunSpriteFrame(BenchState& state, int spriteCount)
+{
+    Marle::Renderer2D::Init();
+    auto texture = std::make_unique<Marle::OpenGLTexture2D>("Assets/Textures/test_sprite.tga");
+    if (texture->GetRendererID() == 0) {
+        state.Skip("Assets/Textures/test_sprite.tga not found (run from the repository root)");
+        Marle::Renderer2D::Shutdown();
+        return;
+    }
+
+    state.SetItemsPerIteration((uint64_t)spriteCount);
+    state.SetCounter("sprites", spriteCount);
+
+    const int columns = 64;
+    const float cellX = 1024.0f / (float)columns;
+    const float cellY = 768.0f / (float)((spriteCount + columns - 1) / columns);
+
+    Marle::RenderProfiler::Init();
+    while (state.Run()) {
+        Marle::RenderProfiler::BeginFrame();
+        glClear(GL_COLOR_BUFFER_BIT);
+        Marle::Renderer2D::BeginScene();
+        for (int i = 0; i < spriteCount; i++) {
+            glm::vec2 position(((float)(i % columns) + 0.5f) * cellX, ((float)(i / columns) + 0.5f) * cellY);
+            Marle::Renderer2D::DrawQuad(position, { 32.0f, 32.0f }, texture.get());
+        }
+        Marle::Renderer2D::EndScene();
+        Marle::RenderProfiler::EndFrame();
+        FinishGL();
+    }
+
+    // FinishGL drained every frame, so the last one has been read back by now
+    Marle::RenderProfiler::BeginFrame();
+    const Marle::RenderProfiler::FrameRecord& frame = Marle::RenderProfiler::GetLastFrame();
+    state.SetCounter("draw_calls", frame.Stats.DrawCalls);
+    state.SetCounter("state_changes", frame.Stats.StateChanges);
+    if (Marle::RenderProfiler::HasGpuTimers()) {
+        state.SetCounter("gpu_ms", frame.GpuPassMs);
+    }
+    Marle::RenderProfiler::EndFrame();
+    Marle::RenderProfiler::Shutdown();
+
+    texture.reset();
+    Marle::Renderer2D::Shutdown();
+}
+
+static bool RegisterSpriteFrames()
+{
+    for (int count : { 100, 1000, 10000 }) {
+        RegisterBenchmark("SpriteFrame_" + std::to_string(count), "scenario", BenchFlagRequiresGL,
+                          [count](BenchState& state) { RunSpriteFrame(state, count); });
+    }
+    return true;
+}
+
+static const bool s_SpriteFramesRegistered = RegisterSpriteFrames();
@@ -0,0 +1,114 @@
+#include "../Bench.h"
+
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Core/SystemScheduler.h"
+
+#include <cmath>
+#include <random>
+#include <typeindex>
+#include <utility>
+#include <vector>
+
+using namespace MarleBench;
+
+static const uint32_t s_SystemCount = 32;
+static const uint32_t s_ResourceCount = 8;
+static const uint32_t s_ItemsPerSystem = 16384;  // Tens of microseconds of work each
+
+template<uint32_t N> struct BenchResource {};
+
+template<size_t... I>
+static std::vector<std::type_index> MakeResourceTypes(std::index_sequence<I...>)
+{
+    return { std::type_index(typeid(BenchResource<(uint32_t)I>))... };
+}
+
+// Stand-in for a subsystem update: a pass over its own array
+static void SimulateSystem(std::vector<float>& values, float dt)
+{
+    for (float& value : values) {
+        value = value * 0.999f + sinf(value) * dt;
+    }
+}
+
+// Every system writes one of eight resources and reads two others (fixed seed), so the graph
+// has real dependencies; with `independent` each system writes only its own resource.
+static void RunScheduler(BenchState& state, bool independent, bool scheduled)
+{
+    std::vector<std::type_index> resources = MakeResourceTypes(std::make_index_sequence<s_ResourceCount>());
+    std::vector<std::vector<float>> data(s_SystemCount, std::vector<float>(s_ItemsPerSystem, 1.0f));
+
+    bool ownScheduler = !Marle::SystemScheduler::IsInitialized();
+    if (ownScheduler) {
+        Marle::SystemScheduler::Init();
+    }
+
+    std::mt19937 rng(1234);
+    std::vector<Marle::SystemId> systems;
+    for (uint32_t i = 0; i < s_SystemCount; i++) {
+        std::vector<std::type_index> writes;
+        std::vector<std::type_index> reads;
+        if (!independent) {
+            writes.push_back(resources[rng() % s_ResourceCount]);
+            reads.push_back(resources[rng() % s_ResourceCount]);
+            reads.push_back(resources[rng() % s_ResourceCount]);
+        }
+        std::vector<float>* values = &data[i];
+        systems.push_back(Marle::SystemScheduler::AddSystem("BenchSystem",
+            [writes, reads](Marle::SystemScheduler::SystemBuilder& builder) {
+                for (const std::type_index& type : writes) {
+                    builder.Write(type);
+                }
+                for (const std::type_index& type : reads) {
+                    builder.Read(type);
+                }
+            },
+            [values](double dt) { SimulateSystem(*values, (float)dt); }));
+    }
+
+    state.SetItemsPerIteration(s_SystemCount);
+    while (state.Run()) {
+        if (scheduled) {
+            Marle::SystemScheduler::Execute(1.0 / 60.0);
+        } else {
+            for (std::vector<float>& values : data) {
+                SimulateSystem(values, 1.0f / 60.0f);
+            }
+        }
+        DoNotOptimize(data[0][0]);
+    }
+
+    const Marle::SystemScheduler::Stats& stats = Marle::SystemScheduler::GetStats();
+    if (scheduled) {
+        state.SetCounter("dependencies", stats.Dependencies);
+        state.SetCounter("depth", stats.Depth);
+        state.SetCounter("step_ms", stats.StepMs);
+        state.SetCounter("serial_ms", stats.SerialMs);
+        state.SetCounter("critical_path_ms", stats.CriticalPathMs);
+        state.SetCounter("parallelism", stats.StepMs > 0.0 ? stats.SerialMs / stats.StepMs : 0.0);
+    }
+    state.SetCounter("worker_threads", Marle::JobSystem::GetWorkerCount());
+
+    for (Marle::SystemId system : systems) {
+        Marle::SystemScheduler::RemoveSystem(system);
+    }
+    if (ownScheduler) {
+        Marle::SystemScheduler::Shutdown();
+    }
+}
+
+// The same 32 updates called back to back on one thread, as OnUpdate would
+MRL_BENCHMARK(SystemScheduler_32Systems_Serial, "scenario", BenchFlagNone)
+{
+    RunScheduler(state, false, false);
+}
+
+MRL_BENCHMARK(SystemScheduler_32Systems_Dependent, "scenario", BenchFlagNone)
+{
+    RunScheduler(state, false, true);
+}
+
+MRL_BENCHMARK(SystemScheduler_32Systems_Independent, "scenario", BenchFlagNone)
+{
+    RunScheduler(state, true, true);
+}
@@ -0,0 +1,88 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Renderer/Font.h"
+#include "Marle/Renderer/Renderer2D.h"
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace MarleBench;
+
+static const char* s_FontPath = "Assets/Fonts/Lato-Regular.ttf";
+
+static const uint32_t s_LabelCount = 64;
+
+// A debug-overlay sized workload: 64 labels of ~40 glyphs. Static text is laid out once and
+// then only re-emitted; changing text embeds per-frame numbers so every label misses the cache.
+static void RunTextOverlay(BenchState& state, bool changing)
+{
+    if (access(s_FontPath, R_OK) != 0) {
+        state.Skip(std::string(s_FontPath) + " not found (run from the repository root)");
+        return;
+    }
+
+    Marle::Renderer2D::Init();
+
+    {
+        Marle::Font font(s_FontPath);
+        if (!font.IsLoaded()) {
+            state.Skip("font failed to load");
+            Marle::Renderer2D::Shutdown();
+            return;
+        }
+
+        std::vector<std::string> labels(s_LabelCount);
+        char buffer[128];
+        for (uint32_t i = 0; i < s_LabelCount; i++) {
+            snprintf(buffer, sizeof(buffer), "Entity %03u  pos (%7.2f, %7.2f)  hp %3u", i, i * 13.5f, i * 7.25f, 100 - i);
+            labels[i] = buffer;
+        }
+
+        uint64_t frame = 0, glyphs = 0;
+        double measuredSeconds = 0.0;
+        while (state.Run()) {
+            if (changing) {
+                for (uint32_t i = 0; i < s_LabelCount; i++) {
+                    snprintf(buffer, sizeof(buffer), "Entity %03u  pos (%7.2f, %7.2f)  hp %3u",
+                             i, i * 13.5f + frame * 0.37f, i * 7.25f - frame * 0.11f, (uint32_t)((i + frame) % 100));
+                    labels[i] = buffer;
+                }
+            }
+
+            double start = NowSeconds();
+            glClear(GL_COLOR_BUFFER_BIT);
+            Marle::Renderer2D::BeginScene();
+            for (uint32_t i = 0; i < s_LabelCount; i++) {
+                Marle::Renderer2D::DrawText(font, labels[i], { 8.0f, 760.0f - 11.5f * i }, 11.0f);
+                glyphs += labels[i].size();
+            }
+            Marle::Renderer2D::EndScene();
+            FinishGL();
+            measuredSeconds += NowSeconds() - start;
+            frame++;
+        }
+
+        const Marle::Font::Stats& stats = font.GetStats();
+        uint64_t lookups = stats.RunCacheHits + stats.RunCacheMisses;
+        state.SetCounter("glyphs_per_ms", measuredSeconds > 0.0 ? (double)glyphs / (measuredSeconds * 1e3) : 0.0);
+        state.SetCounter("run_cache_hit_rate", lookups ? (double)stats.RunCacheHits / lookups : 0.0);
+        state.SetCounter("glyphs_rasterized", (double)stats.GlyphsRasterized);
+        state.SetCounter("atlas_pages", stats.Pages);
+    }
+
+    Marle::Renderer2D::Shutdown();
+}
+
+MRL_BENCHMARK(Text_Overlay_Static, "scenario", BenchFlagRequiresGL)
+{
+    RunTextOverlay(state, false);
+}
+
+MRL_BENCHMARK(Text_Overlay_Changing, "scenario", BenchFlagRequiresGL)
+{
+    RunTextOverlay(state, true);
+}
@@ -0,0 +1,87 @@
+#include "../Bench.h"
+#include "../BenchGL.h"
+
+#include "Marle/Renderer/Tilemap.h"
+#include "Marle/Renderer/Renderer2D.h"
+
+#include <algorithm>
+
+using namespace MarleBench;
+
+// Pans across a two-layer map (ground everywhere, sparse decoration on top). Frame cost should
+// match between map sizes, since only chunks under the 1024x768 view are ever touched.
+static void RunTilemapPan(BenchState& state, uint32_t mapSize, uint32_t editsPerFrame)
+{
+    Marle::Renderer2D::Init();
+
+    {
+        const float tileSize = 16.0f;
+        Marle::Tilemap map(mapSize, mapSize, tileSize, nullptr, 16, 16);
+        uint32_t ground = map.AddLayer();
+        uint32_t detail = map.AddLayer();
+        map.Fill(ground, 0);
+        map.SetTileAnimation(32, 4, 8.0f);
+        for (uint32_t y = 0; y < mapSize; y += 3) {
+            for (uint32_t x = (y * 7) % 5; x < mapSize; x += 5) {
+                map.SetTile(detail, x, y, (uint16_t)(32 + (x + y) % 48));
+            }
+        }
+
+        const float worldSize = (float)mapSize * tileSize;
+        glm::vec2 camera(0.0f, 0.0f);
+        uint32_t random = 0x12345678u;
+        uint64_t visibleChunks = 0, rebuiltChunks = 0, drawCalls = 0, frames = 0;
+
+        while (state.Run()) {
+            // Diagonal pan that wraps around inside the map
+            camera += glm::vec2(7.0f, 3.0f);
+            if (camera.x + 1024.0f > worldSize) camera.x = 0.0f;
+            if (camera.y + 768.0f > worldSize) camera.y = 0.0f;
+
+            for (uint32_t i = 0; i < editsPerFrame; i++) {
+                random ^= random << 13; random ^= random >> 17; random ^= random << 5;
+                uint32_t x = (uint32_t)(camera.x / tileSize) + random % 64;
+                uint32_t y = (uint32_t)(camera.y / tileSize) + (random >> 8) % 48;
+                map.SetTile(detail, std::min(x, mapSize - 1), std::min(y, mapSize - 1), (uint16_t)(random % 32));
+            }
+
+            map.Update(1.0f / 60.0f);
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            Marle::Renderer2D::BeginScene(camera);
+            map.Render();
+            Marle::Renderer2D::EndScene();
+            FinishGL();
+
+            const Marle::Tilemap::Stats& stats = map.GetStats();
+            visibleChunks += stats.VisibleChunks;
+            rebuiltChunks += stats.RebuiltChunks;
+            drawCalls += stats.DrawCalls;
+            frames++;
+        }
+
+        if (frames > 0) {
+            state.SetCounter("visible_chunks", (double)visibleChunks / frames);
+            state.SetCounter("rebuilt_chunks_per_frame", (double)rebuiltChunks / frames);
+            state.SetCounter("draw_calls", (double)drawCalls / frames);
+        }
+        state.SetCounter("resident_chunks", map.GetStats().ResidentChunks);
+    }
+
+    Marle::Renderer2D::Shutdown();
+}
+
+MRL_BENCHMARK(Tilemap_Pan_256, "scenario", BenchFlagRequiresGL)
+{
+    RunTilemapPan(state, 256, 0);
+}
+
+MRL_BENCHMARK(Tilemap_Pan_4096, "scenario", BenchFlagRequiresGL)
+{
+    RunTilemapPan(state, 4096, 0);
+}
+
+MRL_BENCHMARK(Tilemap_PanEdit_4096, "scenario", BenchFlagRequiresGL)
+{
+    RunTilemapPan(state, 4096, 16);
+}
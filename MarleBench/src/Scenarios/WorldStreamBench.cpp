@@ -0,0 +1,144 @@
+#include "../Bench.h"
+
+#include "Marle/Scene/WorldStreamer.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace MarleBench;
+
+using Clock = std::chrono::steady_clock;
+
+static const char* s_WorldPath = "/tmp/marlebench_world";
+static const int s_WorldChunks = 32;                // Per side
+static const float s_ChunkSize = 512.0f;
+static const uint32_t s_EntitiesPerChunk = 4096;
+static const uint32_t s_FlightFrames = 120;         // Two seconds at 60 Hz
+static const float s_CameraSpeed = 6000.0f;         // World units per second
+
+static bool EnsureWorld()
+{
+    static bool written = false;
+    if (written) {
+        return true;
+    }
+
+    Marle::WorldWriter writer(s_WorldPath, s_ChunkSize);
+    for (int y = 0; y < s_WorldChunks; y++) {
+        for (int x = 0; x < s_WorldChunks; x++) {
+            Marle::WorldChunkData chunk;
+            chunk.Coord = { x, y };
+            chunk.Entities.resize(s_EntitiesPerChunk);
+            for (uint32_t i = 0; i < s_EntitiesPerChunk; i++) {
+                chunk.Entities[i].Type = "Prop";
+                chunk.Entities[i].Position = { (x + (i % 64) / 64.0f) * s_ChunkSize, (y + (i / 64) / 64.0f) * s_ChunkSize };
+                chunk.Entities[i].Variant = i;
+            }
+            if (!writer.AddChunk(chunk)) {
+                return false;
+            }
+        }
+    }
+    written = writer.Finish();
+    return written;
+}
+
+// A 60 Hz flight in a straight line across the world, paced like a vsynced swap. Activating an
+// entity costs about what spawning a simple prop would, so a chunk takes a couple of frames of
+// activation budget, and a chunk is in view a frame or two after it comes within LoadRadius.
+// Without look-ahead most chunks reach the view before their turn and are forced through in one
+// frame; with it they are read and activated well before.
+static void RunFlythrough(BenchState& state, float lookAheadSeconds)
+{
+    if (!EnsureWorld()) {
+        state.Skip("could not write the world to /tmp");
+        return;
+    }
+
+    Marle::WorldStreamerSettings settings;
+    settings.LoadRadius = 768.0f;
+    settings.UnloadRadius = 1280.0f;
+    settings.RequiredRadius = 640.0f;
+    settings.LookAheadSeconds = lookAheadSeconds;
+    settings.MemoryBudgetBytes = 16ull * 1024 * 1024;
+
+    std::vector<glm::vec2> spawned;
+    spawned.reserve(1 << 16);
+    const auto frameLength = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / 60.0));
+    uint64_t hitches = 0, hitchFrames = 0, forced = 0, runs = 0;
+    double maxHitchMs = 0.0, maxUpdateMs = 0.0, loadMs = 0.0;
+    size_t peakBytes = 0;
+
+    state.SetItemsPerIteration(s_FlightFrames);
+    while (state.Run()) {
+        Marle::WorldStreamer world;
+        if (!world.Open(s_WorldPath, settings)) {
+            state.Skip("could not open the world");
+            return;
+        }
+        world.SetCallbacks(
+            [&spawned](const Marle::WorldChunk& chunk, uint32_t first, uint32_t count) {
+                for (uint32_t i = first; i < first + count; i++) {
+                    const Marle::WorldEntity& entity = chunk.Data.Entities[i];
+                    glm::vec2 position = entity.Position;
+                    for (int step = 0; step < 2; step++) {
+                        position = position * 0.999f + glm::vec2(std::sin(position.y), std::cos(position.x));
+                    }
+                    spawned.push_back(position);
+                }
+            },
+            [&spawned](const Marle::WorldChunk&) {
+                if (spawned.size() > (1 << 16)) {
+                    spawned.clear();
+                }
+            });
+
+        glm::vec2 camera(s_ChunkSize * 2.0f, s_ChunkSize * 2.0f);
+        world.Preload(camera);
+        auto nextFrame = Clock::now();
+        for (uint32_t frame = 0; frame < s_FlightFrames; frame++) {
+            camera += glm::vec2(0.8f, 0.6f) * (s_CameraSpeed / 60.0f);
+            world.Update(camera, 1.0f / 60.0f);
+
+            nextFrame += frameLength;
+            if (Clock::now() < nextFrame) {
+                std::this_thread::sleep_until(nextFrame);
+            } else {
+                nextFrame = Clock::now();
+            }
+        }
+
+        const Marle::WorldStreamer::Stats& stats = world.GetStats();
+        hitches += stats.Hitches;
+        hitchFrames += stats.HitchFrames;
+        forced += stats.ForcedActivations;
+        maxHitchMs = std::max(maxHitchMs, stats.MaxHitchMs);
+        maxUpdateMs = std::max(maxUpdateMs, stats.MaxUpdateMs);
+        peakBytes = std::max(peakBytes, stats.PeakResidentBytes);
+        loadMs += stats.AverageLoadMs;
+        runs++;
+    }
+
+    state.SetCounter("hitches_per_flight", runs ? (double)hitches / (double)runs : 0.0);
+    state.SetCounter("hitch_frames_per_flight", runs ? (double)hitchFrames / (double)runs : 0.0);
+    state.SetCounter("max_hitch_ms", maxHitchMs);
+    state.SetCounter("forced_activations_per_flight", runs ? (double)forced / (double)runs : 0.0);
+    state.SetCounter("avg_load_ms", runs ? loadMs / (double)runs : 0.0);
+    state.SetCounter("max_update_ms", maxUpdateMs);
+    state.SetCounter("peak_resident_mb", peakBytes / (1024.0 * 1024.0));
+    DoNotOptimize(spawned.size());
+}
+
+// Loads only what is already within LoadRadius of the camera
+MRL_BENCHMARK(WorldStream_Flythrough_Reactive, "scenario", BenchFlagNone)
+{
+    RunFlythrough(state, 0.0f);
+}
+
+// Also loads along the path the camera covers in the next second and a half
+MRL_BENCHMARK(WorldStream_Flythrough_Predictive, "scenario", BenchFlagNone)
+{
+    RunFlythrough(state, 1.5f);
+}
@@ -0,0 +1,228 @@
+#include "Marle/Core/Metrics.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+    #include <sys/socket.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
+using namespace Marle;
+
+static void PrintUsage()
+{
+    printf("Usage: MarleStat [options] <pid | /shm-name>\n");
+    printf("       MarleStat -s <socket-path>\n");
+    printf("\n");
+    printf("Prints the metrics a running Marle game publishes. The game only publishes\n");
+    printf("while a reader is attached, so the first snapshot can take a frame to appear.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  -w, --watch <ms>        Refresh every <ms> milliseconds until interrupted\n");
+    printf("  -t, --text              Text exposition format instead of the summary table\n");
+    printf("  -s, --socket <path>     Read the text format from the game's socket endpoint\n");
+}
+
+// Upper edge interpolation within the bucket the quantile falls in; the overflow bucket reports its lower bound
+static double EstimateQuantile(const MetricSample& sample, double quantile)
+{
+    if (sample.Count == 0) {
+        return 0.0;
+    }
+    double rank = quantile * (double)sample.Count;
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket <= sample.BucketCount; bucket++) {
+        uint64_t hits = sample.Buckets[bucket];
+        if (hits > 0 && (double)(seen + hits) >= rank) {
+            if (bucket == sample.BucketCount) {
+                return sample.Bounds[sample.BucketCount - 1];
+            }
+            double lower = bucket > 0 ? sample.Bounds[bucket - 1] : 0.0;
+            double fraction = (rank - (double)seen) / (double)hits;
+            return lower + (sample.Bounds[bucket] - lower) * fraction;
+        }
+        seen += hits;
+    }
+    return sample.Bounds[sample.BucketCount - 1];
+}
+
+static void PrintSummary(const std::vector<MetricSample>& samples, const std::unordered_map<std::string, double>& previous,
+                         double elapsedSeconds)
+{
+    printf("%-40s %16s %12s\n", "metric", "value", "rate/s");
+    for (const MetricSample& sample : samples) {
+        switch (sample.Type) {
+            case MetricType::Counter: {
+                auto it = previous.find(sample.Name);
+                if (it != previous.end() && elapsedSeconds > 0.0) {
+                    printf("%-40s %16llu %12.1f\n", sample.Name, (unsigned long long)sample.Count, (sample.Value - it->second) / elapsedSeconds);
+                } else {
+                    printf("%-40s %16llu %12s\n", sample.Name, (unsigned long long)sample.Count, "-");
+                }
+                break;
+            }
+            case MetricType::Gauge:
+                printf("%-40s %16.6g\n", sample.Name, sample.Value);
+                break;
+            case MetricType::Histogram: {
+                double mean = sample.Count ? sample.Value / (double)sample.Count : 0.0;
+                printf("%-40s %16llu   mean %.3f  p50 %.3f  p90 %.3f  p99 %.3f\n", sample.Name, (unsigned long long)sample.Count, mean,
+                       EstimateQuantile(sample, 0.5), EstimateQuantile(sample, 0.9), EstimateQuantile(sample, 0.99));
+                break;
+            }
+        }
+    }
+}
+
+static bool ReadSocket(const std::string& path, std::string& text)
+{
+#if defined(__unix__) || defined(__APPLE__)
+    sockaddr_un address = {};
+    if (path.size() >= sizeof(address.sun_path)) {
+        printf("Error: socket path '%s' is too long\n", path.c_str());
+        return false;
+    }
+    int handle = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (handle < 0) {
+        printf("Error: failed to create socket\n");
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    if (connect(handle, (const sockaddr*)&address, sizeof(address)) < 0) {
+        printf("Error: nothing is serving metrics on %s\n", path.c_str());
+        close(handle);
+        return false;
+    }
+
+    // The game answers at the end of its next frame and closes the connection
+    text.clear();
+    char buffer[16384];
+    ssize_t received;
+    while ((received = recv(handle, buffer, sizeof(buffer), 0)) > 0) {
+        text.append(buffer, (size_t)received);
+    }
+    close(handle);
+    return true;
+#else
+    printf("Error: sockets are not implemented for this platform (%s)\n", path.c_str());
+    return false;
+#endif
+}
+
+// Announces the reader and waits (up to a second) for a snapshot published after that
+static bool ReadFresh(MetricsReader& reader, std::vector<MetricSample>& samples, uint64_t& frame, double& uptime)
+{
+    uint64_t staleFrame = 0;
+    double staleUptime = 0.0;
+    bool hadSnapshot = reader.Read(samples, staleFrame, staleUptime) && staleUptime > 0.0;
+    reader.Announce();
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        if (reader.Read(samples, frame, uptime) && uptime > 0.0 && (!hadSnapshot || uptime != staleUptime)) {
+            return true;
+        }
+    }
+    printf("Warning: no new snapshot within a second (the game may be paused or stalled)\n");
+    return reader.Read(samples, frame, uptime) && uptime > 0.0;
+}
+
+int main(int argc, char** argv)
+{
+    std::string target, socketPath;
+    int watchMs = 0;
+    bool text = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((std::strcmp(arg, "-w") == 0 || std::strcmp(arg, "--watch") == 0) && hasValue) {
+            watchMs = std::atoi(argv[++i]);
+        } else if ((std::strcmp(arg, "-s") == 0 || std::strcmp(arg, "--socket") == 0) && hasValue) {
+            socketPath = argv[++i];
+        } else if (std::strcmp(arg, "-t") == 0 || std::strcmp(arg, "--text") == 0) {
+            text = true;
+        } else if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0) {
+            PrintUsage();
+            return 0;
+        } else if (arg[0] == '-') {
+            printf("Error: unknown option '%s'\n\n", arg);
+            PrintUsage();
+            return 1;
+        } else {
+            target = arg;
+        }
+    }
+
+    if (!socketPath.empty()) {
+        do {
+            std::string exposition;
+            if (!ReadSocket(socketPath, exposition)) {
+                return 1;
+            }
+            if (watchMs > 0) {
+                printf("\033[H\033[2J");
+            }
+            fputs(exposition.c_str(), stdout);
+            fflush(stdout);
+            std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+        } while (watchMs > 0);
+        return 0;
+    }
+
+    if (target.empty()) {
+        PrintUsage();
+        return 1;
+    }
+    std::string shmName = target[0] == '/' ? target : MetricsReader::GetDefaultName((uint32_t)std::strtoul(target.c_str(), nullptr, 10));
+
+    MetricsReader reader;
+    if (!reader.Open(shmName)) {
+        return 1;
+    }
+
+    std::vector<MetricSample> samples;
+    std::unordered_map<std::string, double> previous;
+    double previousUptime = 0.0;
+    do {
+        uint64_t frame = 0;
+        double uptime = 0.0;
+        if (!ReadFresh(reader, samples, frame, uptime)) {
+            printf("Error: %s has not published a snapshot\n", shmName.c_str());
+            return 1;
+        }
+
+        if (watchMs > 0) {
+            printf("\033[H\033[2J");
+        }
+        printf("%s  frame %llu  uptime %.1f s  %zu metrics\n\n", shmName.c_str(), (unsigned long long)frame, uptime, samples.size());
+        if (text) {
+            std::string exposition;
+            FormatMetricsText(samples.data(), (uint32_t)samples.size(), exposition);
+            fputs(exposition.c_str(), stdout);
+        } else {
+            PrintSummary(samples, previous, uptime - previousUptime);
+        }
+        fflush(stdout);
+
+        previous.clear();
+        for (const MetricSample& sample : samples) {
+            previous[sample.Name] = sample.Value;
+        }
+        previousUptime = uptime;
+        std::this_thread::sleep_for(std::chrono::milliseconds(watchMs));
+    } while (watchMs > 0);
+
+    return 0;
+}
@@ -0,0 +1,33 @@
+#include "../Test.h"
+
+#include "Marle/Animation/SkinnedMesh.h"
+
+#include <cmath>
+
+using namespace MarleTests;
+
+static bool IsNear(const glm::vec2& a, const glm::vec2& b)
+{
+    return std::fabs(a.x - b.x) < 1e-4f && std::fabs(a.y - b.y) < 1e-4f;
+}
+
+// A bone index past the skeleton would make Skin() read past the palette; it is dropped instead
+MRL_TEST(SkinnedMesh_DropsInfluencesOnMissingBones, TestFlagNone)
+{
+    Marle::SkinnedMesh mesh(2);
+    mesh.AddVertex({ 0.0f, 0.0f }, { 0.0f, 0.0f }, { { 1, 1.0f } });
+    mesh.AddVertex({ 0.0f, 0.0f }, { 0.0f, 0.0f }, { { 7, 1.0f } });
+    mesh.AddVertex({ 0.0f, 0.0f }, { 0.0f, 0.0f }, { { 1, 0.5f }, { 2, 0.5f } });
+
+    Marle::Affine2D palette[2];
+    palette[0].TX = 10.0f;
+    palette[1].TY = 20.0f;
+    Marle::SkinnedVertex out[3];
+    mesh.Skin(palette, out);
+
+    MRL_CHECK(IsNear(out[0].Position, { 0.0f, 20.0f }));
+    // Nothing valid left: follows the root
+    MRL_CHECK(IsNear(out[1].Position, { 10.0f, 0.0f }));
+    // The valid influence keeps the whole weight
+    MRL_CHECK(IsNear(out[2].Position, { 0.0f, 20.0f }));
+}
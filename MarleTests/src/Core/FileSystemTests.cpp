@@ -0,0 +1,49 @@
+#include "../Test.h"
+
+#include "Marle/Core/FileSystem.h"
+
+#include <string>
+#include <unistd.h>
+
+using namespace MarleTests;
+
+// "../<repo>/..." names a real file through the parent directory, so the tests need no fixtures
+static std::string GetRepositoryName()
+{
+    char buffer[4096];
+    if (!getcwd(buffer, sizeof(buffer))) {
+        return "";
+    }
+    std::string cwd = buffer;
+    return cwd.substr(cwd.rfind('/') + 1);
+}
+
+MRL_TEST(FileSystem_DotDotOutsideMountsOpensNatively, TestFlagNone)
+{
+    std::string repository = GetRepositoryName();
+    if (!MRL_CHECK(!repository.empty()) || !MRL_CHECK(Marle::FileSystem::MountDirectory("Assets", "Assets"))) {
+        return;
+    }
+
+    Marle::VirtualFile file;
+    MRL_CHECK(Marle::FileSystem::Open("Assets/Fonts/OFL.txt", file));
+    MRL_CHECK(Marle::FileSystem::Open("Assets/Fonts/../Fonts/OFL.txt", file));
+    MRL_CHECK(Marle::FileSystem::Open("../" + repository + "/Assets/Fonts/OFL.txt", file));
+
+    Marle::FileSystem::Unmount("Assets");
+}
+
+MRL_TEST(FileSystem_DotDotCannotClimbOutOfAMount, TestFlagNone)
+{
+    std::string repository = GetRepositoryName();
+    if (!MRL_CHECK(!repository.empty()) || !MRL_CHECK(Marle::FileSystem::MountDirectory("Assets", "Assets"))) {
+        return;
+    }
+
+    // The file exists natively at this path, but the path starts inside the "Assets" mount
+    Marle::VirtualFile file;
+    MRL_CHECK(!Marle::FileSystem::Open("Assets/../../" + repository + "/Assets/Fonts/OFL.txt", file));
+    MRL_CHECK(!Marle::FileSystem::Open("Assets\\Fonts\\..\\..\\..\\" + repository + "\\Assets\\Fonts\\OFL.txt", file));
+
+    Marle::FileSystem::Unmount("Assets");
+}
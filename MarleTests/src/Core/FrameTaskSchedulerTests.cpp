@@ -0,0 +1,158 @@
+#include "../Test.h"
+
+#include "Marle/Core/FrameTaskScheduler.h"
+
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+using namespace MarleTests;
+using Marle::FrameTaskContext;
+using Marle::FrameTaskPriority;
+using Marle::FrameTaskScheduler;
+
+static bool NearlyEqual(double a, double b)
+{
+    return std::fabs(a - b) < 1e-9;
+}
+
+// One frame as Application::Run drives it
+static void RunFrame()
+{
+    FrameTaskScheduler::BeginFrame();
+    FrameTaskScheduler::Execute();
+}
+
+MRL_TEST(FrameTaskScheduler_OverrunHalvesCeilingThenGrowsBack, TestFlagNone)
+{
+    // A long target keeps ordinary frames far from an overrun on a busy machine
+    FrameTaskScheduler::Init(40.0);
+    FrameTaskScheduler::SetBudgetLimits(0.25, 3.0, 1.0);
+    MRL_CHECK(NearlyEqual(FrameTaskScheduler::GetStats().CeilingMs, 2.0));
+
+    bool overrun = true;
+    Marle::FrameTaskId task = FrameTaskScheduler::Submit("Overrun", [&overrun](FrameTaskContext&) {
+        if (overrun) {
+            overrun = false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(60));
+        }
+        return false;
+    });
+
+    RunFrame();
+    FrameTaskScheduler::BeginFrame();
+    MRL_CHECK(NearlyEqual(FrameTaskScheduler::GetStats().CeilingMs, 1.0));
+    MRL_CHECK(FrameTaskScheduler::GetStats().OverrunFrames == 1);
+
+    // Each frame that ran tasks within the target earns back a quarter millisecond, up to the maximum
+    const double expected[] = { 1.25, 1.5, 1.75, 2.0, 2.25, 2.5, 2.75, 3.0, 3.0 };
+    for (double ceiling : expected) {
+        FrameTaskScheduler::Execute();
+        FrameTaskScheduler::BeginFrame();
+        MRL_CHECK(NearlyEqual(FrameTaskScheduler::GetStats().CeilingMs, ceiling));
+        MRL_CHECK(FrameTaskScheduler::GetStats().BudgetMs <= FrameTaskScheduler::GetStats().CeilingMs);
+    }
+
+    // Frames without tasks leave the ceiling alone
+    FrameTaskScheduler::Cancel(task);
+    FrameTaskScheduler::SetBudgetLimits(0.25, 4.0, 1.0);
+    RunFrame();
+    RunFrame();
+    MRL_CHECK(NearlyEqual(FrameTaskScheduler::GetStats().CeilingMs, 3.0));
+    MRL_CHECK(FrameTaskScheduler::GetStats().OverrunFrames == 1);
+
+    FrameTaskScheduler::Shutdown();
+}
+
+MRL_TEST(FrameTaskScheduler_PriorityThenDeadlineOrder, TestFlagNone)
+{
+    FrameTaskScheduler::Init(40.0);
+    FrameTaskScheduler::SetBudgetLimits(1.0, 20.0, 1.0);
+
+    std::vector<int> order;
+    auto record = [&order](int tag) {
+        return [&order, tag](FrameTaskContext&) {
+            order.push_back(tag);
+            return true;
+        };
+    };
+    // Submitted in the reverse of the order they must run in
+    FrameTaskScheduler::Submit("Low", record(5), FrameTaskPriority::Low, 1.0);
+    FrameTaskScheduler::Submit("NoDeadline", record(4), FrameTaskPriority::Normal);
+    FrameTaskScheduler::Submit("LateDeadline", record(3), FrameTaskPriority::Normal, 20.0);
+    FrameTaskScheduler::Submit("SoonDeadline", record(2), FrameTaskPriority::Normal, 10.0);
+    FrameTaskScheduler::Submit("High", record(1), FrameTaskPriority::High);
+
+    RunFrame();
+    const std::vector<int> expected = { 1, 2, 3, 4, 5 };
+    MRL_CHECK(order == expected);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 0);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Completed == 5);
+
+    FrameTaskScheduler::Shutdown();
+}
+
+MRL_TEST(FrameTaskScheduler_CancelBeforeFirstExecute, TestFlagNone)
+{
+    FrameTaskScheduler::Init(40.0);
+
+    bool ran = false;
+    Marle::FrameTaskId task = FrameTaskScheduler::Submit("Cancelled", [&ran](FrameTaskContext&) {
+        ran = true;
+        return true;
+    });
+    Marle::FrameTaskId other = FrameTaskScheduler::Submit("Other", [](FrameTaskContext&) { return true; });
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 2);
+
+    // Still in Incoming: nothing has merged it into the task list yet
+    FrameTaskScheduler::Cancel(task);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 1);
+    MRL_CHECK(!FrameTaskScheduler::IsPending(task));
+    FrameTaskScheduler::Cancel(task);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 1);
+
+    RunFrame();
+    MRL_CHECK(!ran);
+    MRL_CHECK(!FrameTaskScheduler::IsPending(other));
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 0);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Completed == 1);
+
+    // Once merged and dropped, cancelling again changes nothing
+    FrameTaskScheduler::Cancel(task);
+    FrameTaskScheduler::Cancel(other);
+    RunFrame();
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 0);
+
+    FrameTaskScheduler::Shutdown();
+}
+
+MRL_TEST(FrameTaskScheduler_FlushRunsEverythingToCompletion, TestFlagNone)
+{
+    FrameTaskScheduler::Init(40.0);
+
+    // Many steps each, more than any slice would grant; one submits a follow-up from its last step
+    int stepsA = 0, stepsB = 0, stepsFollowUp = 0;
+    Marle::FrameTaskId a = FrameTaskScheduler::Submit("A", [&stepsA](FrameTaskContext& context) {
+        context.SetProgress(++stepsA / 1000.0f);
+        return stepsA == 1000;
+    }, FrameTaskPriority::Low);
+    Marle::FrameTaskId b = FrameTaskScheduler::Submit("B", [&](FrameTaskContext&) {
+        if (++stepsB < 500) {
+            return false;
+        }
+        FrameTaskScheduler::Submit("FollowUp", [&stepsFollowUp](FrameTaskContext&) { return ++stepsFollowUp == 10; });
+        return true;
+    });
+
+    FrameTaskScheduler::Flush();
+    MRL_CHECK(stepsA == 1000);
+    MRL_CHECK(stepsB == 500);
+    MRL_CHECK(stepsFollowUp == 10);
+    MRL_CHECK(!FrameTaskScheduler::IsPending(a) && !FrameTaskScheduler::IsPending(b));
+    MRL_CHECK(FrameTaskScheduler::GetProgress(a) == 1.0f);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Pending == 0);
+    MRL_CHECK(FrameTaskScheduler::GetStats().Completed == 3);
+
+    FrameTaskScheduler::Shutdown();
+}
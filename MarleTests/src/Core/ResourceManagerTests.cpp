@@ -0,0 +1,197 @@
+#include "../Test.h"
+
+#include "Marle/Core/FileSystem.h"
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Core/ResourceManager.h"
+#include "Marle/Renderer/SoftwareRenderer.h"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace MarleTests;
+using Marle::ResourceHandle;
+using Marle::ResourceManager;
+using Marle::ResourceType;
+using Marle::SoftwareTexture;
+
+// The manager keys resources by path string, so "Textures/../Textures/" spellings of one file
+// are distinct resources: as many as a test needs, with no fixtures
+static std::string SpritePath(int variant)
+{
+    std::string path = "Assets/Textures/";
+    for (int i = 0; i < variant; i++) {
+        path += "../Textures/";
+    }
+    return path + "test_sprite.tga";
+}
+
+static ResourceManager::TypeStats Stats()
+{
+    return ResourceManager::GetStats(ResourceType::SoftwareTexture);
+}
+
+// Pumps frames until the handle's async load has finished
+static void WaitForLoad(const ResourceHandle<SoftwareTexture>& handle)
+{
+    while (handle.IsLoading()) {
+        Marle::FileSystem::Update();
+        ResourceManager::Update();
+    }
+}
+
+MRL_TEST(ResourceManager_ConcurrentLoadsShareOneSlot, TestFlagNone)
+{
+    ResourceManager::TypeStats before = Stats();
+    ResourceHandle<SoftwareTexture> first = ResourceManager::LoadAsync<SoftwareTexture>(SpritePath(0));
+    ResourceHandle<SoftwareTexture> second = ResourceManager::LoadAsync<SoftwareTexture>(SpritePath(0));
+    MRL_CHECK(Stats().Requests == before.Requests + 2);
+    MRL_CHECK(Stats().Hits == before.Hits + 1);
+    MRL_CHECK(Stats().Loading == 1);
+    MRL_CHECK(first.IsLoading() && second.IsLoading());
+
+    WaitForLoad(first);
+    MRL_CHECK(!second.IsLoading());
+    MRL_CHECK(first.Get() != nullptr && first.Get() == second.Get());
+    MRL_CHECK(Stats().Resident == 1 && Stats().Referenced == 1);
+
+    // A blocking load of the same path is a hit on the same object
+    ResourceHandle<SoftwareTexture> third = ResourceManager::Load<SoftwareTexture>(SpritePath(0));
+    MRL_CHECK(third.Get() == first.Get());
+    MRL_CHECK(Stats().Hits == before.Hits + 2);
+
+    first.Reset();
+    second.Reset();
+    third.Reset();
+    MRL_CHECK(Stats().Resident == 1 && Stats().Referenced == 0);
+    ResourceManager::ClearCache();
+    MRL_CHECK(Stats().Resident == 0);
+}
+
+MRL_TEST(ResourceManager_EvictsLeastRecentlyReleasedFirst, TestFlagNone)
+{
+    std::vector<ResourceHandle<SoftwareTexture>> handles;
+    for (int i = 0; i < 4; i++) {
+        handles.push_back(ResourceManager::Load<SoftwareTexture>(SpritePath(i)));
+        if (!MRL_CHECK(handles.back().Get() != nullptr)) {
+            return;
+        }
+    }
+    const size_t size = handles[0]->GetMemorySize();
+    ResourceManager::TypeStats before = Stats();
+    MRL_CHECK(before.CpuBytes == 4 * size);
+
+    auto cached = [](int variant) {
+        return (bool)ResourceManager::Find<SoftwareTexture>(Marle::StringId(SpritePath(variant)));
+    };
+
+    // Released 2, 0, 3, 1; a budget of two keeps the last two released
+    const int releaseOrder[] = { 2, 0, 3, 1 };
+    for (int variant : releaseOrder) {
+        handles[variant].Reset();
+    }
+    ResourceManager::SetBudgets(2 * size, 512ull * 1024 * 1024);
+    ResourceManager::Update();
+    MRL_CHECK(Stats().Evictions == before.Evictions + 2);
+    MRL_CHECK(!cached(2) && !cached(0));
+    // Find takes and drops a reference, which makes variant 3 the most recently released
+    MRL_CHECK(cached(1));
+    MRL_CHECK(cached(3));
+
+    ResourceManager::SetBudgets(size, 512ull * 1024 * 1024);
+    ResourceManager::Update();
+    MRL_CHECK(Stats().Evictions == before.Evictions + 3);
+    MRL_CHECK(!cached(1) && cached(3));
+
+    // Referenced resources are never evicted, whatever the budget
+    ResourceHandle<SoftwareTexture> held = ResourceManager::Load<SoftwareTexture>(SpritePath(3));
+    ResourceManager::SetBudgets(0, 0);
+    ResourceManager::Update();
+    MRL_CHECK(held.Get() != nullptr);
+    MRL_CHECK(Stats().Resident == 1);
+
+    held.Reset();
+    ResourceManager::Update();
+    MRL_CHECK(Stats().Resident == 0);
+    ResourceManager::SetBudgets(256ull * 1024 * 1024, 512ull * 1024 * 1024);
+}
+
+// A handle that outlives Shutdown must not resolve to, or release, whatever takes its slot.
+// Each session's first load gets slot 0, so the second session reuses the stale handle's slot.
+MRL_TEST(ResourceManager_StaleHandleRejectedAfterSlotReuse, TestFlagNone)
+{
+    ResourceManager::Shutdown();
+    ResourceManager::Init();
+    ResourceHandle<SoftwareTexture> stale = ResourceManager::Load<SoftwareTexture>(SpritePath(0));
+    MRL_CHECK(stale.Get() != nullptr);
+    ResourceManager::Shutdown();
+    ResourceManager::Init();
+
+    ResourceHandle<SoftwareTexture> fresh = ResourceManager::Load<SoftwareTexture>(SpritePath(1));
+    MRL_CHECK(fresh.Get() != nullptr);
+    MRL_CHECK(stale.Get() == nullptr);
+
+    ResourceHandle<SoftwareTexture> copy = stale;
+    copy.Reset();
+    stale.Reset();
+    MRL_CHECK(Stats().Referenced == 1);
+    MRL_CHECK(fresh.Get() != nullptr);
+
+    fresh.Reset();
+    ResourceManager::ClearCache();
+}
+
+// A blocking load that waits on an async one runs FileSystem callbacks, which may start more
+// loads and grow the slot array under it
+MRL_TEST(ResourceManager_BlockingLoadSurvivesNestedLoads, TestFlagNone)
+{
+    std::vector<ResourceHandle<SoftwareTexture>> nested;
+    Marle::FileSystem::ReadAsync("Assets/Fonts/OFL.txt", [&nested](Marle::FileReadResult&) {
+        for (int i = 1; i <= 64; i++) {
+            nested.push_back(ResourceManager::LoadAsync<SoftwareTexture>(SpritePath(i)));
+        }
+    });
+    // Update reaps before it submits, so the callback runs from the next one: the first
+    // FileSystem::Update inside the blocking load's wait
+    Marle::FileSystem::Update();
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    // Every worker held, so the decode stays queued and the blocking load runs it after that update
+    std::atomic<uint32_t> held{ 0 };
+    std::atomic<bool> release{ false };
+    std::vector<Marle::JobHandle> holders;
+    for (uint32_t i = 0; i < Marle::JobSystem::GetWorkerCount(); i++) {
+        holders.push_back(Marle::JobSystem::SubmitBackground([&held, &release]() {
+            held++;
+            while (!release) {
+                std::this_thread::yield();
+            }
+        }));
+    }
+    while (held < holders.size()) {
+        std::this_thread::yield();
+    }
+
+    ResourceHandle<SoftwareTexture> async = ResourceManager::LoadAsync<SoftwareTexture>(SpritePath(0));
+    ResourceHandle<SoftwareTexture> blocking = ResourceManager::Load<SoftwareTexture>(SpritePath(0));
+    MRL_CHECK(nested.size() == 64);
+    MRL_CHECK(blocking.Get() != nullptr && blocking.Get() == async.Get());
+    release = true;
+    for (const Marle::JobHandle& holder : holders) {
+        holder.Wait();
+    }
+
+    Marle::FileSystem::Flush();
+    for (const ResourceHandle<SoftwareTexture>& handle : nested) {
+        WaitForLoad(handle);
+        MRL_CHECK(handle.Get() != nullptr);
+    }
+
+    nested.clear();
+    async.Reset();
+    blocking.Reset();
+    ResourceManager::ClearCache();
+    MRL_CHECK(Stats().Resident == 0);
+}
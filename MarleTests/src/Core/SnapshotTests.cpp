@@ -0,0 +1,128 @@
+#include "../Test.h"
+
+#include "Marle/Core/Snapshot.h"
+
+#include <atomic>
+#include <cstdio>
+#include <thread>
+
+using namespace MarleTests;
+using Marle::Snapshot;
+using Marle::SnapshotCapture;
+using Marle::SnapshotSaver;
+
+static const char* s_SnapshotPath = "test_interleaved.snap";
+static const size_t s_PayloadWords = 256 * 1024; // 1 MB, many blocks per save
+
+// Every word of the payload carries the save's sequence number, so a save torn by another
+// write to the same slot shows up as a mix of two sequences
+static void FillCapture(SnapshotCapture& capture, uint32_t sequence)
+{
+    capture.AddSection("Sequence", 1, &sequence, sizeof(sequence));
+    uint32_t* payload = static_cast<uint32_t*>(capture.AllocateSection("Payload", 1, s_PayloadWords * sizeof(uint32_t)));
+    for (size_t i = 0; i < s_PayloadWords; i++) {
+        payload[i] = sequence;
+    }
+}
+
+// Returns the sequence the newest generation holds, or 0 when it is missing or torn
+static uint32_t LoadSequence(TestContext& context, Snapshot& snapshot)
+{
+    if (!MRL_CHECK(snapshot.Load(s_SnapshotPath))) {
+        return 0;
+    }
+    size_t count = 0;
+    const uint32_t* sequence = snapshot.GetArray<uint32_t>("Sequence", count);
+    if (!MRL_CHECK(sequence && count == 1)) {
+        return 0;
+    }
+    const uint32_t* payload = snapshot.GetArray<uint32_t>("Payload", count);
+    if (!MRL_CHECK(payload && count == s_PayloadWords)) {
+        return 0;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (payload[i] != *sequence) {
+            context.Fail("payload word %zu is from save %u, the header from save %u", i, payload[i], *sequence);
+            return 0;
+        }
+    }
+    return *sequence;
+}
+
+// Each round a SaveAsync from one thread races a SaveNow from another, to one file. The writes
+// must not overlap: two writes to the same slot would share a generation and mix their payloads.
+// Then the two in order on one thread, where the synchronous save is queued behind the async one.
+MRL_TEST(Snapshot_InterleavedAsyncAndSyncSavesKeepNewestGeneration, TestFlagNone)
+{
+    std::remove(s_SnapshotPath);
+    {
+        SnapshotSaver saver;
+        Snapshot snapshot;
+        std::atomic<uint32_t> round{ 0 };
+        std::atomic<uint32_t> go{ 0 };
+        std::atomic<bool> ready{ false };
+        std::atomic<bool> stop{ false };
+        std::thread asyncThread([&]() {
+            for (uint32_t done = 0;; done++) {
+                while (round == done && !stop) {
+                    std::this_thread::yield();
+                }
+                if (stop) {
+                    return;
+                }
+                SnapshotCapture* capture = saver.BeginCapture();
+                FillCapture(*capture, 2 * round);
+                ready = true;
+                while (go != round) {
+                    std::this_thread::yield();
+                }
+                saver.SaveAsync(capture, s_SnapshotPath);
+            }
+        });
+
+        const uint32_t rounds = 40;
+        for (uint32_t i = 1; i <= rounds; i++) {
+            // Both captures filled first, so the two saves start together and either may claim the file first
+            SnapshotCapture* capture = saver.BeginCapture();
+            FillCapture(*capture, 2 * i + 1);
+            ready = false;
+            round = i;
+            while (!ready) {
+                std::this_thread::yield();
+            }
+            go = i;
+            MRL_CHECK(saver.SaveNow(capture, s_SnapshotPath));
+            saver.WaitForSaves();
+
+            uint32_t sequence = LoadSequence(context, snapshot);
+            if (sequence != 2 * i && sequence != 2 * i + 1) {
+                context.Fail("round %u: newest save is %u", i, sequence);
+                break;
+            }
+            if (snapshot.GetGeneration() != 2 * i) {
+                context.Fail("round %u: generation %llu after %u saves", i, (unsigned long long)snapshot.GetGeneration(), 2 * i);
+                break;
+            }
+            snapshot.Unload();
+        }
+        stop = true;
+        asyncThread.join();
+        snapshot.Unload();
+
+        SnapshotCapture* first = saver.BeginCapture();
+        SnapshotCapture* second = saver.BeginCapture();
+        if (MRL_CHECK(first && second)) {
+            FillCapture(*first, 1000);
+            saver.SaveAsync(first, s_SnapshotPath);
+            FillCapture(*second, 1001);
+            MRL_CHECK(saver.SaveNow(second, s_SnapshotPath));
+            MRL_CHECK(!saver.IsSaving());
+            // Only the changed blocks: the layout from the first save still fits
+            MRL_CHECK(!saver.GetLastSaveStats().FullRewrite);
+
+            MRL_CHECK(LoadSequence(context, snapshot) == 1001);
+            MRL_CHECK(snapshot.GetGeneration() == 2 * rounds + 2);
+        }
+    }
+    std::remove(s_SnapshotPath);
+}
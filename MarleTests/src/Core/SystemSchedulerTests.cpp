@@ -0,0 +1,162 @@
+#include "../Test.h"
+
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Core/SystemScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace MarleTests;
+
+namespace {
+
+    struct ResourceA {};
+    struct ResourceB {};
+    struct ResourceC {};
+
+    // Systems currently inside a resource; a writer must be alone, readers only exclude writers
+    struct InFlight {
+        std::atomic<int> Readers{ 0 };
+        std::atomic<int> Writers{ 0 };
+        std::atomic<int> Violations{ 0 };
+    };
+
+    InFlight s_A, s_B, s_C;
+    std::atomic<uint32_t> s_Clock{ 0 };
+
+    struct Span {
+        uint32_t Start = 0, End = 0;
+    };
+
+    // Long enough that systems the graph leaves unordered really do run side by side
+    void Work()
+    {
+        auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(50);
+        while (std::chrono::steady_clock::now() < until) {
+        }
+    }
+
+    void Access(InFlight& resource, bool write)
+    {
+        if (write) {
+            if (resource.Writers.fetch_add(1) != 0 || resource.Readers.load() != 0) {
+                resource.Violations++;
+            }
+            Work();
+            resource.Writers.fetch_sub(1);
+        } else {
+            resource.Readers.fetch_add(1);
+            if (resource.Writers.load() != 0) {
+                resource.Violations++;
+            }
+            Work();
+            resource.Readers.fetch_sub(1);
+        }
+    }
+
+}
+
+// Readers of the same resource may overlap, a writer never overlaps anything touching its
+// resource, and After/Before constraints hold even against registration order
+MRL_TEST(SystemScheduler_ConflictsNeverOverlap, TestFlagNone)
+{
+    using Marle::SystemScheduler;
+    typedef SystemScheduler::SystemBuilder Builder;
+
+    SystemScheduler::Init();
+    Span spans[8];
+    std::thread::id mainThread = std::this_thread::get_id();
+    std::atomic<bool> mainOnly{ true };
+
+    auto system = [&spans](uint32_t index, std::function<void()> body) {
+        return [&spans, index, body](double) {
+            spans[index].Start = s_Clock++;
+            body();
+            spans[index].End = s_Clock++;
+        };
+    };
+
+    SystemScheduler::AddSystem("WriteA", [](Builder& b) { b.Write<ResourceA>(); },
+                               system(0, []() { Access(s_A, true); }));
+    SystemScheduler::AddSystem("ReadA1", [](Builder& b) { b.Read<ResourceA>(); },
+                               system(1, []() { Access(s_A, false); }));
+    SystemScheduler::AddSystem("ReadA2", [](Builder& b) { b.Read<ResourceA>(); },
+                               system(2, []() { Access(s_A, false); }));
+    SystemScheduler::AddSystem("WriteB", [](Builder& b) { b.Write<ResourceB>(); },
+                               system(3, []() { Access(s_B, true); }));
+    SystemScheduler::AddSystem("ReadAB", [](Builder& b) { b.Read<ResourceA>(); b.Read<ResourceB>(); b.SetMainThread(); },
+                               system(4, [&]() {
+                                   if (std::this_thread::get_id() != mainThread) {
+                                       mainOnly = false;
+                                   }
+                                   Access(s_A, false);
+                                   Access(s_B, false);
+                               }));
+    // Registered ahead of the system it must follow
+    SystemScheduler::AddSystem("Late", [](Builder& b) { b.Read<ResourceC>(); b.After("Early"); },
+                               system(5, []() { Access(s_C, false); }));
+    SystemScheduler::AddSystem("Early", [](Builder& b) { b.Read<ResourceC>(); },
+                               system(6, []() { Access(s_C, false); }));
+    SystemScheduler::AddSystem("Prologue", [](Builder& b) { b.Read<ResourceC>(); b.Before("Early"); },
+                               system(7, []() { Access(s_C, false); }));
+
+    for (int step = 0; step < 200; step++) {
+        SystemScheduler::Execute(1.0 / 60.0);
+
+        // Conflicting pairs keep registration order; declared constraints keep theirs
+        const uint32_t before[] = { 0, 0, 0, 3, 6, 7 };
+        const uint32_t after[] = { 1, 2, 4, 4, 5, 6 };
+        for (uint32_t i = 0; i < 6; i++) {
+            if (spans[before[i]].End > spans[after[i]].Start) {
+                context.Fail("step %d: system %u started before system %u finished", step, after[i], before[i]);
+            }
+        }
+    }
+
+    MRL_CHECK(s_A.Violations == 0);
+    MRL_CHECK(s_B.Violations == 0);
+    MRL_CHECK(s_C.Violations == 0);
+    MRL_CHECK(mainOnly);
+
+    // Only conflicts and constraints become edges: the readers of A stay unordered
+    const SystemScheduler::Stats& stats = SystemScheduler::GetStats();
+    MRL_CHECK(stats.Systems == 8);
+    MRL_CHECK(stats.Dependencies == 6);
+    MRL_CHECK(stats.Ambiguities == 4);
+    MRL_CHECK(stats.Depth == 3);
+
+    SystemScheduler::Shutdown();
+}
+
+// An After() naming a disabled system adds no edge; the conflict still orders the other two
+MRL_TEST(SystemScheduler_ConstraintOnDisabledSystemIsSkipped, TestFlagNone)
+{
+    using Marle::SystemScheduler;
+    typedef SystemScheduler::SystemBuilder Builder;
+
+    SystemScheduler::Init();
+    std::atomic<uint32_t> order[3];
+    for (auto& value : order) {
+        value = 0;
+    }
+
+    SystemScheduler::AddSystem("First", [](Builder& b) { b.Write<ResourceA>(); },
+                               [&order](double) { order[0] = s_Clock++; Work(); });
+    Marle::SystemId middle = SystemScheduler::AddSystem("Middle", [](Builder& b) { b.Write<ResourceA>(); },
+                                                        [&order](double) { order[1] = s_Clock++; Work(); });
+    SystemScheduler::AddSystem("Last", [](Builder& b) { b.Write<ResourceA>(); b.After("Middle"); },
+                               [&order](double) { order[2] = s_Clock++; });
+
+    SystemScheduler::SetEnabled(middle, false);
+    for (int step = 0; step < 50; step++) {
+        uint32_t stepStart = s_Clock;
+        SystemScheduler::Execute(1.0 / 60.0);
+        MRL_CHECK(order[0] >= stepStart && order[2] > order[0]);
+        MRL_CHECK(order[1] == 0);
+    }
+    MRL_CHECK(SystemScheduler::GetStats().Systems == 2);
+    MRL_CHECK(SystemScheduler::GetStats().Dependencies == 1);
+
+    SystemScheduler::Shutdown();
+}
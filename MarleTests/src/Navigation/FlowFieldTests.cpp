@@ -0,0 +1,162 @@
+#include "../Test.h"
+
+#include "Marle/Navigation/FlowField.h"
+#include "Marle/Navigation/NavGrid.h"
+
+#include <cmath>
+#include <deque>
+#include <vector>
+
+using namespace MarleTests;
+using Marle::FlowField;
+using Marle::FlowFieldCache;
+using Marle::NavGrid;
+
+namespace {
+
+    const uint32_t s_Size = 64;         // 4 x 4 sectors
+    const int32_t s_WallX = 40;
+
+    // A wall down the whole grid, through all four sector rows, open at one cell
+    void BuildWall(NavGrid& grid, int32_t gapY)
+    {
+        grid.FillRect(s_WallX, 0, 1, s_Size, NavGrid::Blocked);
+        grid.SetCost(s_WallX, gapY, 1);
+    }
+
+    // Fewest 8-connected steps between two cells, without cutting wall corners
+    int32_t ShortestSteps(const NavGrid& grid, const glm::ivec2& from, const glm::ivec2& to)
+    {
+        std::vector<int32_t> steps(s_Size * s_Size, -1);
+        std::deque<glm::ivec2> queue;
+        steps[from.y * s_Size + from.x] = 0;
+        queue.push_back(from);
+        while (!queue.empty()) {
+            glm::ivec2 cell = queue.front();
+            queue.pop_front();
+            if (cell == to) {
+                return steps[cell.y * s_Size + cell.x];
+            }
+            for (int32_t dy = -1; dy <= 1; dy++) {
+                for (int32_t dx = -1; dx <= 1; dx++) {
+                    glm::ivec2 next = cell + glm::ivec2(dx, dy);
+                    if (!grid.IsWalkable(next) || steps[next.y * s_Size + next.x] >= 0) {
+                        continue;
+                    }
+                    if (dx != 0 && dy != 0 && (!grid.IsWalkable(cell + glm::ivec2(dx, 0)) || !grid.IsWalkable(cell + glm::ivec2(0, dy)))) {
+                        continue;
+                    }
+                    steps[next.y * s_Size + next.x] = steps[cell.y * s_Size + cell.x] + 1;
+                    queue.push_back(next);
+                }
+            }
+        }
+        return -1;
+    }
+
+    // Follows the field one cell per step, running an Update whenever the walk enters a sector
+    // that is not built yet, as the game loop would. Returns the step count, or -1 if the walk
+    // stopped short of the goal, entered a wall, cut a corner or never passed `through`.
+    int32_t Walk(TestContext& context, FlowFieldCache& cache, const FlowField& field, glm::ivec2 cell, const glm::ivec2& through)
+    {
+        const NavGrid& grid = cache.GetGrid();
+        bool passed = false;
+        uint32_t updates = 0;
+        for (int32_t step = 0; step < 4 * (int32_t)s_Size;) {
+            if (cell == field.GetGoal()) {
+                if (!passed) {
+                    context.Fail("walk reached the goal without passing (%d, %d)", through.x, through.y);
+                    return -1;
+                }
+                return step;
+            }
+            glm::vec2 direction = field.GetDirection(grid.CellToWorld(cell));
+            if (field.GetCost(cell) == NavGrid::Unreachable) {
+                // The lookup queued the sector
+                if (++updates > grid.GetSectorCount()) {
+                    context.Fail("sector of (%d, %d) never got built", cell.x, cell.y);
+                    return -1;
+                }
+                cache.Update();
+                continue;
+            }
+            glm::ivec2 move((int32_t)std::lround(direction.x), (int32_t)std::lround(direction.y));
+            if (move == glm::ivec2(0)) {
+                context.Fail("no direction at (%d, %d)", cell.x, cell.y);
+                return -1;
+            }
+            glm::ivec2 next = cell + move;
+            if (!grid.IsWalkable(next) ||
+                (move.x != 0 && move.y != 0 && (!grid.IsWalkable(cell + glm::ivec2(move.x, 0)) || !grid.IsWalkable(cell + glm::ivec2(0, move.y))))) {
+                context.Fail("step from (%d, %d) to (%d, %d) enters or clips a wall", cell.x, cell.y, next.x, next.y);
+                return -1;
+            }
+            cell = next;
+            passed |= cell == through;
+            step++;
+        }
+        context.Fail("walk did not reach the goal");
+        return -1;
+    }
+
+}
+
+// The only way from the far side of the wall is its one gap, two sector rows from both ends
+MRL_TEST(FlowField_FollowsDirectionsThroughTheGap, TestFlagNone)
+{
+    NavGrid grid(s_Size, s_Size);
+    BuildWall(grid, 50);
+    FlowFieldCache cache(grid);
+
+    const glm::ivec2 goal(60, 5);
+    const glm::ivec2 start(3, 4);
+    std::shared_ptr<const FlowField> field = cache.GetField(goal);
+    if (!MRL_CHECK(field != nullptr)) {
+        return;
+    }
+
+    // A lookup before anything is built only queues the sector; the next Update builds the
+    // whole corridor from it to the goal
+    MRL_CHECK(field->GetDirection(grid.CellToWorld(start)) == glm::vec2(0.0f));
+    cache.Update();
+    uint32_t corridor = field->GetBuiltSectorCount();
+    MRL_CHECK(corridor > 1 && corridor < grid.GetSectorCount());
+
+    int32_t steps = Walk(context, cache, *field, start, glm::ivec2(s_WallX, 50));
+    int32_t shortest = ShortestSteps(grid, start, goal);
+    MRL_CHECK(steps >= shortest && steps <= shortest + shortest / 10);
+    MRL_CHECK(field->GetBuiltSectorCount() < grid.GetSectorCount());
+
+    // Corner cells lie on no path between portal anchors, so editing one changes no portal
+    // distance: only a built sector holding the cell is rebuilt
+    uint64_t graphVersion = grid.GetGraphVersion();
+    uint32_t unbuilt = NavGrid::Unreachable;
+    for (uint32_t sector = 0; sector < grid.GetSectorCount() && unbuilt == NavGrid::Unreachable; sector++) {
+        if (field->GetCost(grid.GetSectorOrigin(sector) + glm::ivec2(1)) == NavGrid::Unreachable) {
+            unbuilt = sector;
+        }
+    }
+    if (MRL_CHECK(unbuilt != NavGrid::Unreachable)) {
+        glm::ivec2 cell = grid.GetSectorOrigin(unbuilt) + glm::ivec2(1);
+        grid.SetCost(cell.x, cell.y, 5);
+        cache.Update();
+        MRL_CHECK(grid.GetGraphVersion() == graphVersion + 1);
+        MRL_CHECK(cache.GetStats().RebuiltSectors == 0);
+    }
+
+    glm::ivec2 startCorner = grid.GetSectorOrigin(grid.GetSectorIndex(start)) + glm::ivec2(1);
+    grid.SetCost(startCorner.x, startCorner.y, 5);
+    cache.Update();
+    MRL_CHECK(grid.GetGraphVersion() == graphVersion + 2);
+    MRL_CHECK(cache.GetStats().RebuiltSectors == 1);
+    MRL_CHECK(Walk(context, cache, *field, start, glm::ivec2(s_WallX, 50)) == steps);
+
+    // Moving the gap reroutes the corridor; the walk must find the new one
+    grid.SetCost(s_WallX, 50, NavGrid::Blocked);
+    grid.SetCost(s_WallX, 12, 1);
+    cache.Update();
+    MRL_CHECK(cache.GetStats().RebuiltSectors > 0);
+    steps = Walk(context, cache, *field, start, glm::ivec2(s_WallX, 12));
+    shortest = ShortestSteps(grid, start, goal);
+    MRL_CHECK(steps >= shortest && steps <= shortest + shortest / 10);
+}
@@ -0,0 +1,319 @@
+#include "../Test.h"
+
+#include "Marle/Network/NetConnection.h"
+#include "Marle/Network/Replication.h"
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace MarleTests;
+using Marle::NetAddress;
+using Marle::NetConnection;
+using Marle::NetPacketType;
+using Marle::NetSocket;
+using Marle::ReplicationClient;
+using Marle::ReplicationSchema;
+using Marle::ReplicationServer;
+using Marle::ReplicationSnapshot;
+
+namespace {
+
+    const double s_Dt = 1.0 / 60.0;
+
+    void BuildSchema(ReplicationSchema& schema)
+    {
+        schema.AddFloat("X", 0.0f, 1024.0f, 0.05f);
+        schema.AddFloat("Y", 0.0f, 1024.0f, 0.05f);
+        schema.AddInt("Kind", 0, 15);
+        schema.AddBool("Active");
+    }
+
+    // Entities come and go every second; a third of them move
+    bool IsPresent(uint32_t id, uint32_t tick)
+    {
+        return (id + tick / 60) % 7 != 0;
+    }
+
+    void EntityValues(uint32_t id, uint32_t tick, float* values)
+    {
+        float t = id % 3 == 0 ? tick * (float)s_Dt : 0.0f;
+        values[0] = 512.0f + 400.0f * std::sin(t + id);
+        values[1] = 512.0f + 400.0f * std::cos(t * 0.5f + id);
+        values[2] = (float)(id % 16);
+        values[3] = (id + tick / 60) % 2 ? 1.0f : 0.0f;
+    }
+
+    void WriteWorld(ReplicationServer& server, uint32_t tick)
+    {
+        float values[4];
+        server.BeginSnapshot();
+        for (uint32_t id = 0; id < 40; id++) {
+            if (IsPresent(id, tick)) {
+                EntityValues(id, tick, values);
+                server.WriteEntity(id, values);
+            }
+        }
+        server.EndSnapshot();
+    }
+
+    void MakeSnapshot(const ReplicationSchema& schema, uint32_t tick, ReplicationSnapshot& snapshot)
+    {
+        float values[4];
+        snapshot.Clear();
+        snapshot.Tick = tick;
+        for (uint32_t id = 0; id < 40; id++) {
+            if (IsPresent(id, tick * 60)) {
+                EntityValues(id, tick * 60, values);
+                snapshot.Ids.push_back(id);
+                for (uint32_t f = 0; f < schema.GetFieldCount(); f++) {
+                    snapshot.Values.push_back(schema.Quantize(f, values[f]));
+                }
+            }
+        }
+    }
+
+    NetAddress Loopback(uint16_t port)
+    {
+        return NetAddress(127, 0, 0, 1, port);
+    }
+
+}
+
+// Loss, duplicates and jitter wide enough to reorder packets, on both sides. Once the world
+// stops changing, the client must show exactly the server's quantized state.
+MRL_TEST(Replication_ClientConvergesOverLossyLink, TestFlagNone)
+{
+    ReplicationSchema schema;
+    BuildSchema(schema);
+    ReplicationServer server(schema);
+    if (!server.Start(0)) {
+        context.Skip("could not open a UDP socket");
+        return;
+    }
+    Marle::NetConditions conditions;
+    conditions.LossPercent = 20.0f;
+    conditions.LatencyMs = 40.0f;
+    conditions.JitterMs = 60.0f;
+    conditions.DuplicatePercent = 15.0f;
+    server.SetConditions(conditions);
+
+    ReplicationClient client(schema);
+    client.SetConditions(conditions);
+    if (!MRL_CHECK(client.Connect(Loopback(server.GetPort())))) {
+        return;
+    }
+
+    // Ten seconds of motion and churn, then three of a still world
+    const uint32_t finalTick = 600;
+    for (uint32_t step = 0; step < 780; step++) {
+        server.Update(s_Dt);
+        WriteWorld(server, std::min(server.GetTick(), finalTick));
+        client.Update(s_Dt);
+        client.Interpolate(0.5);
+    }
+
+    MRL_CHECK(client.GetState() == ReplicationClient::State::Connected);
+    MRL_CHECK(server.GetStats().DeltaSnapshots > server.GetStats().FullSnapshots);
+    MRL_CHECK(client.GetStats().Snapshots > 0);
+
+    const std::vector<Marle::ReplicatedEntity>& entities = client.Interpolate(0.0);
+    std::vector<uint32_t> expectedIds;
+    for (uint32_t id = 0; id < 40; id++) {
+        if (IsPresent(id, finalTick)) {
+            expectedIds.push_back(id);
+        }
+    }
+    if (!MRL_CHECK(entities.size() == expectedIds.size())) {
+        return;
+    }
+    float values[4];
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (entities[i].Id != expectedIds[i]) {
+            context.Fail("entity %zu is %u, expected %u", i, entities[i].Id, expectedIds[i]);
+            return;
+        }
+        EntityValues(entities[i].Id, finalTick, values);
+        for (uint32_t f = 0; f < schema.GetFieldCount(); f++) {
+            float expected = schema.Dequantize(f, schema.Quantize(f, values[f]));
+            if (entities[i].Values[f] != expected) {
+                context.Fail("entity %u field %u is %f, expected %f", entities[i].Id, f, entities[i].Values[f], expected);
+            }
+        }
+    }
+}
+
+// A delta naming a snapshot the client never received is dropped, and the client asks for a
+// full snapshot until it gets one
+MRL_TEST(Replication_ClientRejectsDeltaAgainstMissingBaseline, TestFlagNone)
+{
+    ReplicationSchema schema;
+    BuildSchema(schema);
+    NetSocket socket;
+    if (!socket.Open(0)) {
+        context.Skip("could not open a UDP socket");
+        return;
+    }
+    ReplicationClient client(schema);
+    if (!MRL_CHECK(client.Connect(Loopback(socket.GetPort())))) {
+        return;
+    }
+
+    // A hand-driven server: answers the connect, then sends what the test says
+    std::unique_ptr<NetConnection> connection;
+    double now = 0.0;
+    uint8_t packet[NetSocket::MaxPacketSize];
+    std::vector<uint8_t> message;
+    int keepAlives = 0;
+    bool resyncRequested = false;
+    auto step = [&]() {
+        client.Update(s_Dt);
+        now += s_Dt;
+        NetAddress from;
+        size_t size;
+        keepAlives = 0;
+        resyncRequested = false;
+        while ((size = socket.Receive(from, packet, sizeof(packet))) > 0) {
+            NetPacketType type;
+            if (!NetConnection::ReadPacketType(packet, size, type)) {
+                continue;
+            }
+            if (!connection) {
+                connection = std::make_unique<NetConnection>(socket, from);
+            }
+            connection->ProcessPacket(packet, size, now, message);
+            if (type == NetPacketType::ConnectRequest) {
+                connection->SendControl(NetPacketType::ConnectAccept, now);
+            } else if (type == NetPacketType::KeepAlive) {
+                keepAlives++;
+                resyncRequested |= size > NetConnection::HeaderSize;
+            }
+        }
+    };
+    auto send = [&](const ReplicationSnapshot* baseline, const ReplicationSnapshot& snapshot) {
+        std::vector<uint8_t> encoded;
+        schema.Encode(baseline, snapshot, encoded);
+        connection->SendMessage(encoded.data(), encoded.size(), now);
+    };
+
+    for (int i = 0; i < 4 && client.GetState() != ReplicationClient::State::Connected; i++) {
+        step();
+    }
+    if (!MRL_CHECK(client.GetState() == ReplicationClient::State::Connected) || !MRL_CHECK(connection != nullptr)) {
+        return;
+    }
+
+    ReplicationSnapshot unsent, first, second, third;
+    MakeSnapshot(schema, 5, unsent);
+    MakeSnapshot(schema, 6, first);
+    MakeSnapshot(schema, 7, second);
+    MakeSnapshot(schema, 8, third);
+
+    // The keep-alive sent in the same update already asks for a resync
+    send(&unsent, first);
+    step();
+    MRL_CHECK(client.GetStats().DecodeErrors == 1);
+    MRL_CHECK(client.GetStats().Snapshots == 0);
+    MRL_CHECK(client.GetNewestTick() == 0);
+    MRL_CHECK(keepAlives == 1 && resyncRequested);
+    // Still nothing to delta against: every keep-alive repeats the request
+    step();
+    MRL_CHECK(keepAlives == 1 && resyncRequested);
+
+    send(nullptr, second);
+    step();
+    MRL_CHECK(client.GetStats().Snapshots == 1);
+    MRL_CHECK(client.GetNewestTick() == 7);
+    MRL_CHECK(keepAlives == 1 && !resyncRequested);
+
+    // A delta against the snapshot it now has decodes, one against the one it never had still does not
+    send(&second, third);
+    step();
+    MRL_CHECK(client.GetStats().Snapshots == 2);
+    MRL_CHECK(client.GetNewestTick() == 8);
+    MRL_CHECK(client.GetStats().DecodeErrors == 1);
+    ReplicationSnapshot decoded;
+    std::vector<uint8_t> encoded;
+    schema.Encode(&unsent, third, encoded);
+    // The right contents under another tick are still the wrong baseline
+    ReplicationSnapshot renamed = unsent;
+    renamed.Tick = second.Tick;
+    MRL_CHECK(!schema.Decode(encoded.data(), encoded.size(), &renamed, decoded));
+    MRL_CHECK(!schema.Decode(encoded.data(), encoded.size(), nullptr, decoded));
+    MRL_CHECK(schema.Decode(encoded.data(), encoded.size(), &unsent, decoded));
+    MRL_CHECK(decoded.Ids == third.Ids && decoded.Values == third.Values);
+}
+
+// The server deltas only against snapshots the client acked: full snapshots while nothing is
+// acked, and afterwards baselines taken only from the ticks the client's acks covered
+MRL_TEST(Replication_ServerDeltasOnlyAgainstAckedSnapshots, TestFlagNone)
+{
+    ReplicationSchema schema;
+    BuildSchema(schema);
+    ReplicationServer server(schema);
+    NetSocket socket;
+    if (!server.Start(0) || !socket.Open(0)) {
+        context.Skip("could not open a UDP socket");
+        return;
+    }
+    Marle::NetConditions conditions;
+    conditions.LossPercent = 25.0f;
+    conditions.JitterMs = 50.0f;
+    conditions.DuplicatePercent = 20.0f;
+    server.SetConditions(conditions);
+
+    // A hand-driven client that sends its acks only when the test says so. The connect request
+    // goes out before its own losses are switched on.
+    NetConnection connection(socket, Loopback(server.GetPort()));
+    double now = 0.0;
+    uint32_t hash = schema.GetHash();
+    uint8_t hashBytes[4] = { (uint8_t)hash, (uint8_t)(hash >> 8), (uint8_t)(hash >> 16), (uint8_t)(hash >> 24) };
+    connection.SendControl(NetPacketType::ConnectRequest, now, hashBytes, sizeof(hashBytes));
+    socket.SetConditions(conditions, 7);
+
+    std::set<uint32_t> received, acked;
+    uint32_t fullSnapshots = 0, deltaSnapshots = 0;
+    uint8_t packet[NetSocket::MaxPacketSize];
+    std::vector<uint8_t> message;
+    for (uint32_t step = 0; step < 400; step++) {
+        server.Update(s_Dt);
+        WriteWorld(server, server.GetTick());
+        now += s_Dt;
+        socket.Update(now);
+
+        NetAddress from;
+        size_t size;
+        while ((size = socket.Receive(from, packet, sizeof(packet))) > 0) {
+            if (!connection.ProcessPacket(packet, size, now, message)) {
+                continue;
+            }
+            uint32_t tick, baselineTick;
+            bool hasBaseline;
+            if (!MRL_CHECK(ReplicationSchema::ReadHeader(message.data(), message.size(), tick, hasBaseline, baselineTick))) {
+                continue;
+            }
+            received.insert(tick);
+            if (!hasBaseline) {
+                fullSnapshots++;
+            } else {
+                deltaSnapshots++;
+                if (!acked.count(baselineTick)) {
+                    context.Fail("step %u: snapshot %u deltas against unacked snapshot %u", step, tick, baselineTick);
+                }
+            }
+        }
+
+        // Silent for the first half second, then acks every other step
+        if (step >= 30 && step % 2 == 0) {
+            connection.SendControl(NetPacketType::KeepAlive, now);
+            acked.insert(received.begin(), received.end());
+        }
+    }
+
+    MRL_CHECK(server.GetClientCount() == 1);
+    MRL_CHECK(fullSnapshots >= 20);
+    MRL_CHECK(deltaSnapshots > fullSnapshots);
+    MRL_CHECK(connection.GetStats().DuplicatePackets > 0);
+}
@@ -0,0 +1,466 @@
+#include "../Test.h"
+
+#include "Marle/Renderer/ImageDecoder.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace MarleTests;
+
+// Header of an uncompressed 32-bit TGA, followed by however many pixel bytes the test wants
+static std::vector<uint8_t> BuildTGA(uint16_t width, uint16_t height, size_t pixelBytes)
+{
+    std::vector<uint8_t> data(18 + pixelBytes, 0);
+    data[2] = 2;                // Uncompressed true colour
+    data[12] = (uint8_t)width;
+    data[13] = (uint8_t)(width >> 8);
+    data[14] = (uint8_t)height;
+    data[15] = (uint8_t)(height >> 8);
+    data[16] = 32;
+    return data;
+}
+
+// Signature and IHDR only: enough for the header to parse, nothing to decode
+static std::vector<uint8_t> BuildPNGHeader(uint32_t width, uint32_t height)
+{
+    static const uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    std::vector<uint8_t> data(signature, signature + 8);
+    const uint8_t ihdr[25] = {
+        0, 0, 0, 13, 'I', 'H', 'D', 'R',
+        (uint8_t)(width >> 24), (uint8_t)(width >> 16), (uint8_t)(width >> 8), (uint8_t)width,
+        (uint8_t)(height >> 24), (uint8_t)(height >> 16), (uint8_t)(height >> 8), (uint8_t)height,
+        8, 6, 0, 0, 0,          // 8-bit RGBA, not interlaced
+        0, 0, 0, 0              // CRC, unchecked
+    };
+    data.insert(data.end(), ihdr, ihdr + sizeof(ihdr));
+    return data;
+}
+
+MRL_TEST(ImageDecoder_LoadsSmallTGA, TestFlagNone)
+{
+    std::vector<uint8_t> file = BuildTGA(2, 2, 2 * 2 * 4);
+    memset(file.data() + 18, 0x40, 2 * 2 * 4);
+
+    Marle::ImageInfo info;
+    std::vector<uint8_t> pixels;
+    MRL_CHECK(Marle::LoadImageMemory(file.data(), file.size(), info, pixels));
+    MRL_CHECK(info.Width == 2 && info.Height == 2);
+    MRL_CHECK(pixels.size() == 2 * 2 * 4);
+}
+
+// The header alone claims about 17 GB of pixels; it must be turned down before anything is allocated
+MRL_TEST(ImageDecoder_RejectsOversizedTGA, TestFlagNone)
+{
+    std::vector<uint8_t> file = BuildTGA(65535, 65535, 0);
+
+    Marle::ImageInfo info;
+    std::vector<uint8_t> pixels;
+    MRL_CHECK(!Marle::LoadImageMemory(file.data(), file.size(), info, pixels));
+    MRL_CHECK(pixels.empty());
+}
+
+MRL_TEST(ImageDecoder_RejectsTruncatedTGA, TestFlagNone)
+{
+    std::vector<uint8_t> file = BuildTGA(1024, 1024, 16);
+
+    Marle::ImageInfo info;
+    std::vector<uint8_t> pixels;
+    MRL_CHECK(!Marle::LoadImageMemory(file.data(), file.size(), info, pixels));
+    MRL_CHECK(pixels.empty());
+}
+
+MRL_TEST(ImageDecoder_RejectsOversizedPNG, TestFlagNone)
+{
+    std::vector<uint8_t> file = BuildPNGHeader(0x10000, 0x10000);
+
+    Marle::ImageInfo info;
+    std::vector<uint8_t> pixels;
+    MRL_CHECK(!Marle::ReadImageInfo(file.data(), file.size(), info));
+    MRL_CHECK(!Marle::LoadImageMemory(file.data(), file.size(), info, pixels));
+    MRL_CHECK(pixels.empty());
+}
+
+// ---- PNG decoding ----
+//
+// The images below are encoded here rather than shipped as files, so every filter type, pixel
+// size and row width can be paired with the pixels it must decode to.
+
+enum class Deflate { Stored, Fixed };
+
+struct PNGSource {
+    uint32_t ColorType = 6;                 // 0 gray, 2 RGB, 3 palette, 4 gray-alpha, 6 RGBA
+    uint32_t Width = 1, Height = 1;
+    std::vector<uint8_t> Raw;               // Unfiltered rows, top-down
+    std::vector<uint8_t> Filters;           // One filter type per row
+    std::vector<uint8_t> Palette;           // RGB triples
+    std::vector<uint8_t> Alpha;             // tRNS entries
+    Deflate Compression = Deflate::Fixed;
+    size_t IDATSize = 0;                    // Splits the zlib stream into chunks of this size; 0 for one chunk
+};
+
+static uint32_t BytesPerPixel(uint32_t colorType)
+{
+    static const uint32_t s_Bytes[7] = { 1, 0, 3, 1, 2, 0, 4 };
+    return s_Bytes[colorType];
+}
+
+static int PaethPredictor(int a, int b, int c)
+{
+    int p = a + b - c;
+    int pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+    if (pa <= pb && pa <= pc) {
+        return a;
+    }
+    return pb <= pc ? b : c;
+}
+
+static std::vector<uint8_t> FilterRows(const PNGSource& source)
+{
+    const size_t bpp = BytesPerPixel(source.ColorType);
+    const size_t rowBytes = source.Width * bpp;
+    const std::vector<uint8_t> zero(rowBytes, 0);
+    std::vector<uint8_t> out;
+    for (uint32_t y = 0; y < source.Height; y++) {
+        const uint8_t* row = source.Raw.data() + y * rowBytes;
+        const uint8_t* prior = y > 0 ? row - rowBytes : zero.data();
+        uint8_t filter = source.Filters[y];
+        out.push_back(filter);
+        for (size_t i = 0; i < rowBytes; i++) {
+            int a = i >= bpp ? row[i - bpp] : 0;
+            int b = prior[i];
+            int c = i >= bpp ? prior[i - bpp] : 0;
+            int predictor = 0;
+            switch (filter) {
+                case 1: predictor = a; break;
+                case 2: predictor = b; break;
+                case 3: predictor = (a + b) / 2; break;
+                case 4: predictor = PaethPredictor(a, b, c); break;
+            }
+            out.push_back((uint8_t)(row[i] - predictor));
+        }
+    }
+    return out;
+}
+
+class BitWriter {
+public:
+    void Write(uint32_t value, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++) {
+            if (m_Bit == 0) {
+                Bytes.push_back(0);
+            }
+            Bytes.back() |= (uint8_t)(((value >> i) & 1) << m_Bit);
+            m_Bit = (m_Bit + 1) & 7;
+        }
+    }
+
+    // Huffman codes go most significant bit first
+    void WriteCode(uint32_t code, uint32_t length)
+    {
+        for (uint32_t i = length; i-- > 0;) {
+            Write((code >> i) & 1, 1);
+        }
+    }
+
+    void Align() { m_Bit = 0; }
+
+    std::vector<uint8_t> Bytes;
+
+private:
+    uint32_t m_Bit = 0;
+};
+
+static void WriteFixedSymbol(BitWriter& bits, uint32_t symbol)
+{
+    if (symbol < 144) {
+        bits.WriteCode(0x30 + symbol, 8);
+    } else if (symbol < 256) {
+        bits.WriteCode(0x190 + symbol - 144, 9);
+    } else if (symbol < 280) {
+        bits.WriteCode(symbol - 256, 7);
+    } else {
+        bits.WriteCode(0xC0 + symbol - 280, 8);
+    }
+}
+
+// One fixed-Huffman block with greedy matches over a short window, so the inflater sees both
+// literals and back-references, overlapping ones included
+static void DeflateFixed(BitWriter& bits, const std::vector<uint8_t>& data)
+{
+    static const uint16_t s_LengthBase[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+                                               35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint8_t s_LengthExtra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+                                               3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t s_DistanceBase[12] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49 };
+    static const uint8_t s_DistanceExtra[12] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4 };
+    const size_t window = 64;
+
+    bits.Write(1, 1);   // Final block
+    bits.Write(1, 2);   // Fixed Huffman
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t bestLength = 0, bestDistance = 0;
+        for (size_t distance = 1; distance <= std::min(pos, window); distance++) {
+            size_t length = 0;
+            while (length < 258 && pos + length < data.size() && data[pos + length] == data[pos + length - distance]) {
+                length++;
+            }
+            if (length > bestLength) {
+                bestLength = length;
+                bestDistance = distance;
+            }
+        }
+
+        if (bestLength < 3) {
+            WriteFixedSymbol(bits, data[pos++]);
+            continue;
+        }
+        uint32_t code = 28;
+        while (s_LengthBase[code] > bestLength) {
+            code--;
+        }
+        WriteFixedSymbol(bits, 257 + code);
+        bits.Write((uint32_t)bestLength - s_LengthBase[code], s_LengthExtra[code]);
+        uint32_t distanceCode = 11;
+        while (s_DistanceBase[distanceCode] > bestDistance) {
+            distanceCode--;
+        }
+        bits.WriteCode(distanceCode, 5);
+        bits.Write((uint32_t)bestDistance - s_DistanceBase[distanceCode], s_DistanceExtra[distanceCode]);
+        pos += bestLength;
+    }
+    WriteFixedSymbol(bits, 256);
+}
+
+// Stored blocks of at most 100 bytes, so longer streams span several of them
+static void DeflateStored(BitWriter& bits, const std::vector<uint8_t>& data)
+{
+    const size_t blockSize = 100;
+    size_t pos = 0;
+    do {
+        size_t length = std::min(blockSize, data.size() - pos);
+        bits.Write(pos + length == data.size() ? 1 : 0, 1);
+        bits.Write(0, 2);
+        bits.Align();
+        bits.Write((uint32_t)length, 16);
+        bits.Write((uint32_t)~length & 0xFFFF, 16);
+        for (size_t i = 0; i < length; i++) {
+            bits.Write(data[pos + i], 8);
+        }
+        pos += length;
+    } while (pos < data.size());
+}
+
+static std::vector<uint8_t> ZlibCompress(const std::vector<uint8_t>& data, Deflate compression)
+{
+    BitWriter bits;
+    bits.Write(0x78, 8);
+    bits.Write(0x01, 8);
+    if (compression == Deflate::Stored) {
+        DeflateStored(bits, data);
+    } else {
+        DeflateFixed(bits, data);
+    }
+    uint32_t s1 = 1, s2 = 0;
+    for (uint8_t byte : data) {
+        s1 = (s1 + byte) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+    uint32_t adler = (s2 << 16) | s1;
+    std::vector<uint8_t> out = bits.Bytes;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back((uint8_t)(adler >> shift));
+    }
+    return out;
+}
+
+static void AppendChunk(std::vector<uint8_t>& file, const char* type, const uint8_t* body, size_t length)
+{
+    const size_t start = file.size();
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        file.push_back((uint8_t)(length >> shift));
+    }
+    file.insert(file.end(), type, type + 4);
+    file.insert(file.end(), body, body + length);
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = start + 4; i < file.size(); i++) {
+        crc ^= file[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1)));
+        }
+    }
+    crc ^= 0xFFFFFFFFu;
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        file.push_back((uint8_t)(crc >> shift));
+    }
+}
+
+static std::vector<uint8_t> EncodePNG(const PNGSource& source)
+{
+    static const uint8_t signature[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+    std::vector<uint8_t> file(signature, signature + 8);
+
+    const uint8_t ihdr[13] = {
+        (uint8_t)(source.Width >> 24), (uint8_t)(source.Width >> 16), (uint8_t)(source.Width >> 8), (uint8_t)source.Width,
+        (uint8_t)(source.Height >> 24), (uint8_t)(source.Height >> 16), (uint8_t)(source.Height >> 8), (uint8_t)source.Height,
+        8, (uint8_t)source.ColorType, 0, 0, 0
+    };
+    AppendChunk(file, "IHDR", ihdr, sizeof(ihdr));
+    if (!source.Palette.empty()) {
+        AppendChunk(file, "PLTE", source.Palette.data(), source.Palette.size());
+    }
+    if (!source.Alpha.empty()) {
+        AppendChunk(file, "tRNS", source.Alpha.data(), source.Alpha.size());
+    }
+
+    std::vector<uint8_t> stream = ZlibCompress(FilterRows(source), source.Compression);
+    size_t chunkSize = source.IDATSize > 0 ? source.IDATSize : stream.size();
+    for (size_t offset = 0; offset < stream.size(); offset += chunkSize) {
+        AppendChunk(file, "IDAT", stream.data() + offset, std::min(chunkSize, stream.size() - offset));
+    }
+    AppendChunk(file, "IEND", nullptr, 0);
+    return file;
+}
+
+// Gradients with a little noise: neighbouring bytes are close, so every Paeth branch gets taken
+static PNGSource MakeSource(uint32_t colorType, uint32_t width, uint32_t height, uint8_t filter)
+{
+    PNGSource source;
+    source.ColorType = colorType;
+    source.Width = width;
+    source.Height = height;
+    source.Filters.assign(height, filter);
+    const uint32_t bpp = BytesPerPixel(colorType);
+    uint32_t seed = 0x9E3779B9u ^ (colorType * 131 + width * 17 + filter);
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width * bpp; x++) {
+            seed = seed * 1664525u + 1013904223u;
+            source.Raw.push_back((uint8_t)(x * 9 + y * 23 + ((seed >> 24) & 0x1F)));
+        }
+    }
+    return source;
+}
+
+// What the decoder must produce: RGBA8 with rows bottom-up
+static std::vector<uint8_t> ExpectedRGBA(const PNGSource& source)
+{
+    const uint32_t bpp = BytesPerPixel(source.ColorType);
+    std::vector<uint8_t> out((size_t)source.Width * source.Height * 4);
+    for (uint32_t y = 0; y < source.Height; y++) {
+        for (uint32_t x = 0; x < source.Width; x++) {
+            const uint8_t* in = source.Raw.data() + ((size_t)y * source.Width + x) * bpp;
+            uint8_t* px = out.data() + ((size_t)(source.Height - 1 - y) * source.Width + x) * 4;
+            switch (source.ColorType) {
+                case 0: px[0] = px[1] = px[2] = in[0]; px[3] = 255; break;
+                case 2: px[0] = in[0]; px[1] = in[1]; px[2] = in[2]; px[3] = 255; break;
+                case 3:
+                    px[0] = source.Palette[in[0] * 3];
+                    px[1] = source.Palette[in[0] * 3 + 1];
+                    px[2] = source.Palette[in[0] * 3 + 2];
+                    px[3] = in[0] < source.Alpha.size() ? source.Alpha[in[0]] : 255;
+                    break;
+                case 4: px[0] = px[1] = px[2] = in[0]; px[3] = in[1]; break;
+                case 6: memcpy(px, in, 4); break;
+            }
+        }
+    }
+    return out;
+}
+
+// Decodes through the engine path and compares every pixel. An empty decode error after success
+// means the engine decoded it; stb_image would only run after the engine path had failed.
+static bool DecodeMatches(TestContext& context, const PNGSource& source)
+{
+    std::vector<uint8_t> file = EncodePNG(source);
+    Marle::ImageInfo info;
+    std::vector<uint8_t> pixels;
+    bool loaded = Marle::LoadImageMemory(file.data(), file.size(), info, pixels);
+    if (!loaded || info.Type != Marle::ImageFileType::PNG || Marle::GetImageDecodeError()[0] != '\0') {
+        context.Fail("type %u %ux%u filter %u: engine decode failed (%s)", source.ColorType, source.Width,
+                     source.Height, source.Filters[0], Marle::GetImageDecodeError());
+        return false;
+    }
+    if (pixels != ExpectedRGBA(source)) {
+        context.Fail("type %u %ux%u filter %u: pixels differ", source.ColorType, source.Width, source.Height,
+                     source.Filters[0]);
+        return false;
+    }
+    return true;
+}
+
+// Filter types 0-4 for one to four bytes per pixel, at widths that leave every SIMD tail length
+MRL_TEST(ImageDecoder_PNGFiltersAndWidths, TestFlagNone)
+{
+    const uint32_t colorTypes[4] = { 0, 4, 2, 6 };
+    for (uint32_t colorType : colorTypes) {
+        for (uint32_t width = 1; width <= 5; width++) {
+            for (uint8_t filter = 0; filter <= 4; filter++) {
+                DecodeMatches(context, MakeSource(colorType, width, 4, filter));
+            }
+        }
+    }
+}
+
+// A one-pixel RGB row is shorter than the four-byte Paeth vector loads
+MRL_TEST(ImageDecoder_PNGPaethOnePixelWideRGB, TestFlagNone)
+{
+    MRL_CHECK(DecodeMatches(context, MakeSource(2, 1, 4, 4)));
+}
+
+MRL_TEST(ImageDecoder_PNGMixedFilters, TestFlagNone)
+{
+    PNGSource source = MakeSource(6, 7, 10, 0);
+    for (uint32_t y = 0; y < source.Height; y++) {
+        source.Filters[y] = (uint8_t)((y * 3) % 5);
+    }
+    MRL_CHECK(DecodeMatches(context, source));
+}
+
+MRL_TEST(ImageDecoder_PNGPaletteWithTransparency, TestFlagNone)
+{
+    PNGSource source = MakeSource(3, 5, 4, 1);
+    for (uint32_t i = 0; i < 256; i++) {
+        const uint8_t entry[3] = { (uint8_t)i, (uint8_t)(255 - i), (uint8_t)(i * 7) };
+        source.Palette.insert(source.Palette.end(), entry, entry + 3);
+    }
+    // Shorter than the palette: the remaining entries stay opaque
+    for (uint32_t i = 0; i < 100; i++) {
+        source.Alpha.push_back((uint8_t)(i * 2));
+    }
+    MRL_CHECK(DecodeMatches(context, source));
+}
+
+MRL_TEST(ImageDecoder_PNGMultipleIDAT, TestFlagNone)
+{
+    PNGSource source = MakeSource(2, 5, 6, 4);
+    source.IDATSize = 7;
+    MRL_CHECK(DecodeMatches(context, source));
+
+    source.Compression = Deflate::Stored;
+    source.IDATSize = 3;
+    MRL_CHECK(DecodeMatches(context, source));
+}
+
+MRL_TEST(ImageDecoder_PNGStoredBlocks, TestFlagNone)
+{
+    const uint32_t colorTypes[4] = { 0, 4, 2, 6 };
+    for (uint32_t colorType : colorTypes) {
+        PNGSource source = MakeSource(colorType, 5, 8, 4);
+        source.Compression = Deflate::Stored;
+        MRL_CHECK(DecodeMatches(context, source));
+    }
+}
+
+// Large enough that unfiltering runs as a job behind the inflater when workers are available
+MRL_TEST(ImageDecoder_PNGPipelinedRows, TestFlagNone)
+{
+    PNGSource source = MakeSource(6, 300, 240, 0);
+    for (uint32_t y = 0; y < source.Height; y++) {
+        source.Filters[y] = (uint8_t)(y % 5);
+    }
+    MRL_CHECK(DecodeMatches(context, source));
+}
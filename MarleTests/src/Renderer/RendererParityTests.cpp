@@ -0,0 +1,92 @@
+#include "../Test.h"
+#include "BenchGL.h"
+
+#include "Marle/Platform/OpenGL/OpenGLRendererBackend.h"
+#include "Marle/Platform/OpenGL/OpenGLTexture.h"
+#include "Marle/Renderer/SoftwareRenderer.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace MarleTests;
+
+static const uint32_t TargetWidth = 1024;
+static const uint32_t TargetHeight = 768;
+
+// Largest per-channel difference that still counts as the same pixel: the two backends round
+// the blend differently
+static const int s_Tolerance = 2;
+
+// The same translucent quad over the same clear colour through the OpenGL and software
+// backends, both read back and compared pixel by pixel
+MRL_TEST(RendererParity_TranslucentQuad, TestFlagRequiresGL)
+{
+    // 8x8 of one translucent orange, so filtering cannot differ between backends
+    const uint32_t textureSize = 8;
+    std::vector<uint8_t> rgba;
+    for (uint32_t i = 0; i < textureSize * textureSize; i++) {
+        const uint8_t pixel[4] = { 255, 128, 64, 128 };
+        rgba.insert(rgba.end(), pixel, pixel + 4);
+    }
+
+    Marle::OpenGLTexture2D::SourceLevels source;
+    source.Width = textureSize;
+    source.Height = textureSize;
+    source.Levels.push_back(rgba);
+    auto glTexture = std::make_unique<Marle::OpenGLTexture2D>("translucent", source);
+    Marle::SoftwareTexture softwareTexture(textureSize, textureSize, rgba.data());
+    if (!MRL_CHECK(glTexture->GetRendererID() != 0)) {
+        return;
+    }
+
+    auto glBackend = std::make_unique<Marle::OpenGLRendererBackend>();
+    Marle::SoftwareRendererBackend softwareBackend(TargetWidth, TargetHeight);
+
+    Marle::RenderSceneInfo scene;
+    scene.ViewProjection = glm::ortho(0.0f, (float)TargetWidth, 0.0f, (float)TargetHeight, -1.0f, 1.0f);
+    const glm::vec4 clearColor(0.125f, 0.25f, 0.5f, 1.0f);
+    // Edges on pixel boundaries, so both coverage rules pick the same pixels
+    const glm::vec2 position(512.0f, 384.0f);
+    const glm::vec2 size(256.0f, 256.0f);
+
+    glBackend->Clear(clearColor);
+    glBackend->BeginScene(scene);
+    glBackend->DrawQuad(position, size, glTexture.get());
+    glBackend->EndScene();
+
+    softwareBackend.Clear(clearColor);
+    softwareBackend.BeginScene(scene);
+    softwareBackend.DrawQuad(position, size, &softwareTexture);
+    softwareBackend.EndScene();
+    MarleBench::FinishGL();
+
+    // Both targets are RGBA8, bottom row first
+    std::vector<uint32_t> glPixels((size_t)TargetWidth * TargetHeight);
+    glReadPixels(0, 0, (GLsizei)TargetWidth, (GLsizei)TargetHeight, GL_RGBA, GL_UNSIGNED_BYTE, glPixels.data());
+    const uint32_t* softwarePixels = softwareBackend.GetRasterizer().GetPixels();
+
+    int maxDifference = 0;
+    uint64_t mismatches = 0;
+    for (size_t i = 0; i < glPixels.size(); i++) {
+        int pixelDifference = 0;
+        for (uint32_t shift = 0; shift < 32; shift += 8) {
+            int a = (int)((glPixels[i] >> shift) & 0xFF);
+            int b = (int)((softwarePixels[i] >> shift) & 0xFF);
+            pixelDifference = std::max(pixelDifference, std::abs(a - b));
+        }
+        maxDifference = std::max(maxDifference, pixelDifference);
+        mismatches += pixelDifference > s_Tolerance ? 1 : 0;
+    }
+
+    // Centre pixel, to tell a missing blend (pure texture colour) from a missing quad (clear colour)
+    size_t centre = (size_t)(TargetHeight / 2) * TargetWidth + TargetWidth / 2;
+    if (mismatches > 0) {
+        context.Fail("backends differ in %llu pixels (largest channel difference %d); centre is 0x%08x in OpenGL, "
+                     "0x%08x in software", (unsigned long long)mismatches, maxDifference, glPixels[centre],
+                     softwarePixels[centre]);
+    }
+}
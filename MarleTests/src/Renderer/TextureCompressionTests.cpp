@@ -0,0 +1,214 @@
+#include "../Test.h"
+
+#include "Marle/Renderer/TextureCompression.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+using namespace MarleTests;
+
+// BC7 block layouts as the format specification lists them, written out independently of the
+// decoder so a wrong table on either side shows up as a mismatch
+struct BC7Layout {
+    int Subsets;
+    int PartitionBits;
+    int RotationBits;
+    int IndexSelectionBits;
+    int ColorBits;
+    int AlphaBits;
+    int EndpointPBits;
+    int SharedPBits;
+    int IndexBits;
+    int SecondaryIndexBits;
+};
+
+static const BC7Layout s_Layouts[8] = {
+    { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+    { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+    { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+    { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+    { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+    { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+    { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+    { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+// Partition 0 of the two- and three-subset tables, and its anchor pixels
+static const uint8_t s_TwoSubsets[16] = { 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1, 0, 0, 1, 1 };
+static const uint8_t s_ThreeSubsets[16] = { 0, 0, 1, 1, 0, 0, 1, 1, 0, 2, 2, 1, 2, 2, 2, 2 };
+
+static bool IsAnchor(int subsets, int pixel)
+{
+    return pixel == 0 || (subsets == 2 && pixel == 15) || (subsets == 3 && (pixel == 3 || pixel == 15));
+}
+
+static int Weight(int bits, int index)
+{
+    static const int s_Weights2[4] = { 0, 21, 43, 64 };
+    static const int s_Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    static const int s_Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+    return bits == 2 ? s_Weights2[index] : bits == 3 ? s_Weights3[index] : s_Weights4[index];
+}
+
+struct BlockWriter {
+    uint8_t* Data;
+    uint32_t Position = 0;
+
+    void Write(uint32_t value, int bits)
+    {
+        for (int i = 0; i < bits; i++, Position++) {
+            Data[Position >> 3] |= (uint8_t)(((value >> i) & 1) << (Position & 7));
+        }
+    }
+};
+
+// Packs a block of `mode` from deterministic endpoints and indices (varied by `variant`) and
+// computes the pixels the specification says it decodes to
+static bool BuildBC7Block(int mode, int variant, uint8_t block[16], uint8_t expected[64])
+{
+    const BC7Layout& layout = s_Layouts[mode];
+    const int endpointCount = layout.Subsets * 2;
+    const int rotation = layout.RotationBits ? (variant + mode) % 4 : 0;
+    const int indexSelection = layout.IndexSelectionBits ? variant & 1 : 0;
+
+    int quantized[6][4] = {};
+    int pBits[6] = {};
+    for (int e = 0; e < endpointCount; e++) {
+        for (int ch = 0; ch < 4; ch++) {
+            int bits = ch < 3 ? layout.ColorBits : layout.AlphaBits;
+            quantized[e][ch] = bits ? (e * 53 + ch * 29 + variant * 17 + mode * 7) % (1 << bits) : 0;
+        }
+        pBits[e] = layout.SharedPBits ? ((e / 2) + variant) & 1 : (e + variant) & 1;
+    }
+
+    int indices[16], secondary[16] = {};
+    for (int i = 0; i < 16; i++) {
+        int bits = layout.IndexBits - (IsAnchor(layout.Subsets, i) ? 1 : 0);
+        indices[i] = (i * 5 + variant * 3) % (1 << bits);
+        if (layout.SecondaryIndexBits) {
+            secondary[i] = (i * 3 + variant) % (1 << (layout.SecondaryIndexBits - (i == 0 ? 1 : 0)));
+        }
+    }
+
+    memset(block, 0, 16);
+    BlockWriter writer{ block };
+    writer.Write(1u << mode, mode + 1);
+    writer.Write(0, layout.PartitionBits);
+    writer.Write((uint32_t)rotation, layout.RotationBits);
+    writer.Write((uint32_t)indexSelection, layout.IndexSelectionBits);
+    for (int ch = 0; ch < 4; ch++) {
+        int bits = ch < 3 ? layout.ColorBits : layout.AlphaBits;
+        for (int e = 0; e < endpointCount && bits; e++) {
+            writer.Write((uint32_t)quantized[e][ch], bits);
+        }
+    }
+    for (int e = 0; e < endpointCount && layout.EndpointPBits; e++) {
+        writer.Write((uint32_t)pBits[e], 1);
+    }
+    for (int e = 0; e < endpointCount && layout.SharedPBits; e += 2) {
+        writer.Write((uint32_t)pBits[e], 1);
+    }
+    for (int i = 0; i < 16; i++) {
+        writer.Write((uint32_t)indices[i], layout.IndexBits - (IsAnchor(layout.Subsets, i) ? 1 : 0));
+    }
+    for (int i = 0; i < 16 && layout.SecondaryIndexBits; i++) {
+        writer.Write((uint32_t)secondary[i], layout.SecondaryIndexBits - (i == 0 ? 1 : 0));
+    }
+    if (writer.Position != 128) {
+        return false;
+    }
+
+    int endpoints[6][4];
+    const bool hasPBits = layout.EndpointPBits || layout.SharedPBits;
+    for (int e = 0; e < endpointCount; e++) {
+        for (int ch = 0; ch < 4; ch++) {
+            int bits = ch < 3 ? layout.ColorBits : layout.AlphaBits;
+            if (bits == 0) {
+                endpoints[e][ch] = 255;
+                continue;
+            }
+            int value = quantized[e][ch];
+            if (hasPBits) {
+                value = (value << 1) | pBits[e];
+                bits++;
+            }
+            endpoints[e][ch] = (value << (8 - bits)) | (value >> (2 * bits - 8));
+        }
+    }
+
+    for (int i = 0; i < 16; i++) {
+        int subset = layout.Subsets == 2 ? s_TwoSubsets[i] : layout.Subsets == 3 ? s_ThreeSubsets[i] : 0;
+        int colorWeight = Weight(layout.IndexBits, indices[i]);
+        int alphaWeight = colorWeight;
+        if (layout.SecondaryIndexBits) {
+            int secondaryWeight = Weight(layout.SecondaryIndexBits, secondary[i]);
+            colorWeight = indexSelection ? secondaryWeight : colorWeight;
+            alphaWeight = indexSelection ? Weight(layout.IndexBits, indices[i]) : secondaryWeight;
+        }
+
+        uint8_t* pixel = expected + i * 4;
+        for (int ch = 0; ch < 4; ch++) {
+            int w = ch < 3 ? colorWeight : alphaWeight;
+            pixel[ch] = (uint8_t)(((64 - w) * endpoints[subset * 2][ch] + w * endpoints[subset * 2 + 1][ch] + 32) >> 6);
+        }
+        if (rotation > 0) {
+            std::swap(pixel[3], pixel[rotation - 1]);
+        }
+    }
+    return true;
+}
+
+MRL_TEST(BC7_DecodesEveryMode, TestFlagNone)
+{
+    for (int mode = 0; mode < 8; mode++) {
+        for (int variant = 0; variant < 4; variant++) {
+            uint8_t block[16], expected[64], decoded[64];
+            if (!MRL_CHECK(BuildBC7Block(mode, variant, block, expected))) {
+                continue;
+            }
+            Marle::DecodeBC7Block(block, decoded);
+            for (int i = 0; i < 64; i++) {
+                if (decoded[i] != expected[i]) {
+                    context.Fail("mode %d variant %d: pixel %d channel %d is %d, expected %d", mode, variant,
+                                 i / 4, i % 4, decoded[i], expected[i]);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+MRL_TEST(BC7_ReservedModeIsTransparentBlack, TestFlagNone)
+{
+    uint8_t block[16] = {}, decoded[64];
+    memset(decoded, 0xAB, sizeof(decoded));
+    Marle::DecodeBC7Block(block, decoded);
+    MRL_CHECK(std::all_of(decoded, decoded + 64, [](uint8_t value) { return value == 0; }));
+}
+
+// The encoder's mode 6 blocks decode close to their source when it lies on one colour line,
+// the case a single-subset mode can represent
+MRL_TEST(BC7_EncoderRoundTrip, TestFlagNone)
+{
+    const int from[4] = { 20, 90, 200, 255 }, to[4] = { 180, 130, 40, 120 };
+    uint8_t source[64];
+    for (int i = 0; i < 16; i++) {
+        for (int ch = 0; ch < 4; ch++) {
+            source[i * 4 + ch] = (uint8_t)(from[ch] + (to[ch] - from[ch]) * ((i * 7) % 16) / 15);
+        }
+    }
+
+    uint8_t block[16], decoded[64];
+    Marle::EncodeBC7Block(source, block);
+    Marle::DecodeBC7Block(block, decoded);
+    MRL_CHECK((block[0] & 0x7F) == 0x40);
+
+    int worst = 0;
+    for (int i = 0; i < 64; i++) {
+        worst = std::max(worst, std::abs(decoded[i] - source[i]));
+    }
+    if (worst > 8) {
+        context.Fail("largest channel error %d, expected at most 8", worst);
+    }
+}
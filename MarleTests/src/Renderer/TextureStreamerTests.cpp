@@ -0,0 +1,43 @@
+#include "../Test.h"
+
+#include "Marle/Platform/OpenGL/OpenGLTexture.h"
+#include "Marle/Renderer/TextureStreamer.h"
+
+#include <memory>
+#include <vector>
+
+using namespace MarleTests;
+
+// A streamed texture whose file is gone: the first stream-in fails, and the streamer must
+// not keep submitting the same load every frame after that
+MRL_TEST(TextureStreamer_FailedLoadIsNotRetried, TestFlagRequiresGL)
+{
+    Marle::TextureStreamer::Init();
+
+    // Full chain from 256x256 down, so the levels above the 64x64 tail are left to stream
+    Marle::OpenGLTexture2D::SourceLevels source;
+    source.Width = 256;
+    source.Height = 256;
+    for (uint32_t size = 256; size > 0; size /= 2) {
+        source.Levels.emplace_back((size_t)size * size * 4, (uint8_t)200);
+    }
+    auto texture = std::make_unique<Marle::OpenGLTexture2D>("Assets/Textures/DoesNotExist.png", source);
+    MRL_CHECK(texture->GetResidentMip() > 0);
+
+    uint32_t framesWithLoads = 0;
+    for (uint64_t frame = 1; frame <= 8; frame++) {
+        texture->RequestScreenSize(256.0f, 256.0f, frame);
+        Marle::TextureStreamer::Update(frame);
+        framesWithLoads += Marle::TextureStreamer::GetStats().PendingLoads > 0 ? 1 : 0;
+        Marle::TextureStreamer::Flush();
+    }
+
+    // One load for the first request, then none
+    if (framesWithLoads != 1) {
+        context.Fail("loads were in flight on %u of 8 frames, expected 1", framesWithLoads);
+    }
+    MRL_CHECK(Marle::TextureStreamer::GetStats().LevelsStreamedIn == 0);
+
+    texture.reset();
+    Marle::TextureStreamer::Shutdown();
+}
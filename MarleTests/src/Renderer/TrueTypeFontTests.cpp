@@ -0,0 +1,172 @@
+#include "../Test.h"
+
+#include "Marle/Renderer/TrueTypeFont.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <vector>
+
+using namespace MarleTests;
+
+static const uint32_t SDFSize = 32;
+
+static void PutU16(std::vector<uint8_t>& data, size_t offset, uint16_t value)
+{
+    data[offset] = (uint8_t)(value >> 8);
+    data[offset + 1] = (uint8_t)value;
+}
+
+static void PutU32(std::vector<uint8_t>& data, size_t offset, uint32_t value)
+{
+    PutU16(data, offset, (uint16_t)(value >> 16));
+    PutU16(data, offset + 2, (uint16_t)value);
+}
+
+// Smallest font the reader accepts: glyph 0 is a square, and every further glyph is a composite
+// that places the previous one `fanOut` times. Expanding glyph N naively costs fanOut^N components.
+static std::vector<uint8_t> BuildCompositeBombFont(uint16_t glyphCount, uint16_t fanOut)
+{
+    std::vector<uint8_t> glyf;
+    std::vector<uint32_t> loca;
+    auto append16 = [&glyf](uint16_t value) {
+        glyf.push_back((uint8_t)(value >> 8));
+        glyf.push_back((uint8_t)value);
+    };
+
+    // One contour, four on-curve points with long coordinates: (0,0) (1000,0) (1000,1000) (0,1000)
+    loca.push_back(0);
+    const int16_t header[5] = { 1, 0, 0, 1000, 1000 };
+    for (int16_t value : header) {
+        append16((uint16_t)value);
+    }
+    append16(3);       // Last point of the contour
+    append16(0);       // No instructions
+    for (int i = 0; i < 4; i++) {
+        glyf.push_back(1);
+    }
+    const int16_t xs[4] = { 0, 1000, 0, -1000 }, ys[4] = { 0, 0, 1000, 0 };
+    for (int16_t x : xs) {
+        append16((uint16_t)x);
+    }
+    for (int16_t y : ys) {
+        append16((uint16_t)y);
+    }
+
+    for (uint16_t glyph = 1; glyph < glyphCount; glyph++) {
+        loca.push_back((uint32_t)glyf.size());
+        const int16_t compositeHeader[5] = { -1, 0, 0, 1000, 1000 };
+        for (int16_t value : compositeHeader) {
+            append16((uint16_t)value);
+        }
+        for (uint16_t i = 0; i < fanOut; i++) {
+            // Byte offsets used as x/y, more components follow except after the last
+            append16((uint16_t)(2 | (i + 1 < fanOut ? 0x20 : 0)));
+            append16((uint16_t)(glyph - 1));
+            glyf.push_back(0);
+            glyf.push_back(0);
+        }
+    }
+    loca.push_back((uint32_t)glyf.size());
+
+    // Tag, then contents; offsets are filled in below
+    struct Table { const char* Tag; std::vector<uint8_t> Data; };
+    std::vector<Table> tables = {
+        { "cmap", std::vector<uint8_t>(4 + 8 + 24) },
+        { "glyf", glyf },
+        { "head", std::vector<uint8_t>(54) },
+        { "hhea", std::vector<uint8_t>(36) },
+        { "hmtx", std::vector<uint8_t>(4) },
+        { "loca", std::vector<uint8_t>(loca.size() * 4) },
+        { "maxp", std::vector<uint8_t>(6) },
+    };
+    for (Table& table : tables) {
+        std::vector<uint8_t>& t = table.Data;
+        if (strcmp(table.Tag, "cmap") == 0) {
+            // One Windows Unicode format 4 subtable with only the terminating segment
+            PutU16(t, 2, 1);
+            PutU16(t, 4, 3);
+            PutU16(t, 6, 1);
+            PutU32(t, 8, 12);
+            PutU16(t, 12, 4);
+            PutU16(t, 14, 24);
+            PutU16(t, 18, 2);
+            PutU16(t, 26, 0xFFFF);
+            PutU16(t, 30, 0xFFFF);
+            PutU16(t, 32, 1);
+        } else if (strcmp(table.Tag, "head") == 0) {
+            PutU16(t, 18, 1000);
+            PutU16(t, 50, 1);
+        } else if (strcmp(table.Tag, "hhea") == 0) {
+            PutU16(t, 34, 1);
+        } else if (strcmp(table.Tag, "hmtx") == 0) {
+            PutU16(t, 0, 1000);
+        } else if (strcmp(table.Tag, "loca") == 0) {
+            for (size_t i = 0; i < loca.size(); i++) {
+                PutU32(t, i * 4, loca[i]);
+            }
+        } else if (strcmp(table.Tag, "maxp") == 0) {
+            PutU16(t, 4, glyphCount);
+        }
+    }
+
+    std::vector<uint8_t> font(12 + tables.size() * 16);
+    PutU32(font, 0, 0x00010000);
+    PutU16(font, 4, (uint16_t)tables.size());
+    for (size_t i = 0; i < tables.size(); i++) {
+        size_t record = 12 + i * 16;
+        memcpy(&font[record], tables[i].Tag, 4);
+        PutU32(font, record + 8, (uint32_t)font.size());
+        PutU32(font, record + 12, (uint32_t)tables[i].Data.size());
+        font.insert(font.end(), tables[i].Data.begin(), tables[i].Data.end());
+        font.resize((font.size() + 3) & ~(size_t)3);
+    }
+    return font;
+}
+
+static uint32_t CountInsideTexels(const Marle::TrueTypeFont& font, uint32_t glyph, float scale)
+{
+    std::vector<uint8_t> sdf(SDFSize * SDFSize);
+    font.RasterizeSDF(glyph, scale, 4.0f, 4.0f, 4.0f, SDFSize, SDFSize, sdf.data(), SDFSize);
+    return (uint32_t)std::count_if(sdf.begin(), sdf.end(), [](uint8_t value) { return value > 128; });
+}
+
+MRL_TEST(TrueType_ShippedFontRasterizes, TestFlagNone)
+{
+    Marle::TrueTypeFont font;
+    if (!MRL_CHECK(font.LoadFromFile("Assets/Fonts/Lato-Regular.ttf"))) {
+        return;
+    }
+
+    // 'e' is a simple glyph; the accented form is usually a composite of 'e' and the accent
+    const float scale = 24.0f / font.GetUnitsPerEm();
+    for (uint32_t codepoint : { (uint32_t)'e', 0xE9u }) {
+        uint32_t glyph = font.GetGlyphIndex(codepoint);
+        if (!MRL_CHECK(glyph != 0)) {
+            continue;
+        }
+        if (CountInsideTexels(font, glyph, scale) == 0) {
+            context.Fail("glyph for U+%04X rasterized empty", codepoint);
+        }
+    }
+}
+
+// Nesting within the depth cap but fanning out 16 ways per level would expand 16^8 components
+MRL_TEST(TrueType_CompositeFanOutIsBounded, TestFlagNone)
+{
+    Marle::TrueTypeFont font;
+    if (!MRL_CHECK(font.LoadFromMemory(BuildCompositeBombFont(9, 16)))) {
+        return;
+    }
+
+    // The plain square must still come out, or the test would pass on a font that never draws
+    MRL_CHECK(CountInsideTexels(font, 0, 0.02f) > 0);
+
+    auto start = std::chrono::steady_clock::now();
+    uint32_t inside = CountInsideTexels(font, 8, 0.02f);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    MRL_CHECK(inside > 0);
+    if (seconds > 1.0) {
+        context.Fail("rasterizing the nested composite took %.2f s", seconds);
+    }
+}
@@ -0,0 +1,235 @@
+#include "../Test.h"
+
+#include "Marle/Scene/TransformHierarchy.h"
+
+#include <cmath>
+#include <vector>
+
+using namespace MarleTests;
+using Marle::TransformHierarchy;
+using Marle::TransformNode;
+
+namespace {
+
+    // What the hierarchy should hold, kept independently of its flat layout
+    struct MirrorNode {
+        bool Alive = false;
+        TransformNode Parent = TransformHierarchy::InvalidNode;
+        double X = 0.0, Y = 0.0, Rotation = 0.0, ScaleX = 1.0, ScaleY = 1.0;
+    };
+
+    struct Matrix {
+        double A = 1.0, B = 0.0, C = 0.0, D = 1.0, TX = 0.0, TY = 0.0;
+    };
+
+    class Random {
+    public:
+        uint32_t Next()
+        {
+            m_State = m_State * 1664525u + 1013904223u;
+            return m_State >> 8;
+        }
+        uint32_t Below(uint32_t count) { return Next() % count; }
+        double Range(double low, double high) { return low + (high - low) * (Next() & 0xFFFF) / 65535.0; }
+
+    private:
+        uint32_t m_State = 12345;
+    };
+
+    // parent * local, recursively up to the root
+    Matrix NaiveWorld(const std::vector<MirrorNode>& nodes, TransformNode node)
+    {
+        const MirrorNode& entry = nodes[node];
+        Matrix local;
+        double c = std::cos(entry.Rotation), s = std::sin(entry.Rotation);
+        local.A = c * entry.ScaleX;
+        local.B = s * entry.ScaleX;
+        local.C = -s * entry.ScaleY;
+        local.D = c * entry.ScaleY;
+        local.TX = entry.X;
+        local.TY = entry.Y;
+        if (entry.Parent == TransformHierarchy::InvalidNode) {
+            return local;
+        }
+
+        Matrix parent = NaiveWorld(nodes, entry.Parent);
+        Matrix world;
+        world.A = parent.A * local.A + parent.C * local.B;
+        world.B = parent.B * local.A + parent.D * local.B;
+        world.C = parent.A * local.C + parent.C * local.D;
+        world.D = parent.B * local.C + parent.D * local.D;
+        world.TX = parent.A * local.TX + parent.C * local.TY + parent.TX;
+        world.TY = parent.B * local.TX + parent.D * local.TY + parent.TY;
+        return world;
+    }
+
+    bool IsAncestor(const std::vector<MirrorNode>& nodes, TransformNode ancestor, TransformNode node)
+    {
+        for (TransformNode current = node; current != TransformHierarchy::InvalidNode; current = nodes[current].Parent) {
+            if (current == ancestor) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    class Harness {
+    public:
+        TransformNode Create(TransformNode parent)
+        {
+            MirrorNode entry;
+            entry.Alive = true;
+            entry.Parent = parent;
+            entry.X = Rng.Range(-4.0, 4.0);
+            entry.Y = Rng.Range(-4.0, 4.0);
+            entry.Rotation = Rng.Range(-3.0, 3.0);
+            entry.ScaleX = Rng.Range(0.9, 1.1);
+            entry.ScaleY = Rng.Range(0.9, 1.1);
+            TransformNode node = Hierarchy.Create(parent, glm::vec2((float)entry.X, (float)entry.Y), (float)entry.Rotation,
+                                                  glm::vec2((float)entry.ScaleX, (float)entry.ScaleY));
+            if (node >= Nodes.size()) {
+                Nodes.resize(node + 1);
+            }
+            Nodes[node] = entry;
+            return node;
+        }
+
+        void Destroy(TransformNode node)
+        {
+            Hierarchy.Destroy(node);
+            std::vector<TransformNode> doomed;
+            for (TransformNode other = 0; other < Nodes.size(); other++) {
+                if (Nodes[other].Alive && IsAncestor(Nodes, node, other)) {
+                    doomed.push_back(other);
+                }
+            }
+            for (TransformNode other : doomed) {
+                Nodes[other] = MirrorNode();
+            }
+        }
+
+        // A random live node, or InvalidNode when none is left
+        TransformNode Pick()
+        {
+            std::vector<TransformNode> alive;
+            for (TransformNode node = 0; node < Nodes.size(); node++) {
+                if (Nodes[node].Alive) {
+                    alive.push_back(node);
+                }
+            }
+            return alive.empty() ? TransformHierarchy::InvalidNode : alive[Rng.Below((uint32_t)alive.size())];
+        }
+
+        void Compare(TestContext& context, int round)
+        {
+            uint32_t alive = 0;
+            for (TransformNode node = 0; node < Nodes.size(); node++) {
+                if (!Nodes[node].Alive) {
+                    if (Hierarchy.IsValid(node)) {
+                        context.Fail("round %d: destroyed node %u is still valid", round, node);
+                    }
+                    continue;
+                }
+                alive++;
+                Matrix expected = NaiveWorld(Nodes, node);
+                Marle::Affine2D world = Hierarchy.GetWorld(node);
+                const double actual[6] = { world.A, world.B, world.C, world.D, world.TX, world.TY };
+                const double wanted[6] = { expected.A, expected.B, expected.C, expected.D, expected.TX, expected.TY };
+                for (int i = 0; i < 6; i++) {
+                    if (std::fabs(actual[i] - wanted[i]) > 1e-3 * (1.0 + std::fabs(wanted[i]))) {
+                        context.Fail("round %d: node %u world[%d] is %f, expected %f", round, node, i, actual[i], wanted[i]);
+                        return;
+                    }
+                }
+                if (Hierarchy.GetParent(node) != Nodes[node].Parent) {
+                    context.Fail("round %d: node %u has the wrong parent", round, node);
+                }
+            }
+            if (Hierarchy.GetNodeCount() != alive) {
+                context.Fail("round %d: %u nodes, expected %u", round, Hierarchy.GetNodeCount(), alive);
+            }
+        }
+
+        TransformHierarchy Hierarchy;
+        std::vector<MirrorNode> Nodes;
+        Random Rng;
+    };
+
+}
+
+// A deep chain, a wide two-level fan and a random tree, edited between updates so the
+// breadth-first layout is rebuilt many times and both the four-wide and scalar paths run
+MRL_TEST(TransformHierarchy_MatchesNaiveProductAcrossEdits, TestFlagNone)
+{
+    Harness harness;
+    TransformNode chain = harness.Create(TransformHierarchy::InvalidNode);
+    for (int depth = 0; depth < 40; depth++) {
+        chain = harness.Create(chain);
+    }
+    TransformNode fan = harness.Create(TransformHierarchy::InvalidNode);
+    for (int i = 0; i < 50; i++) {
+        TransformNode child = harness.Create(fan);
+        for (int j = 0; j < 3; j++) {
+            harness.Create(child);
+        }
+    }
+    harness.Create(TransformHierarchy::InvalidNode);
+    for (int i = 0; i < 200; i++) {
+        harness.Create(harness.Pick());
+    }
+
+    harness.Hierarchy.Update();
+    harness.Compare(context, 0);
+
+    Random& random = harness.Rng;
+    for (int round = 1; round <= 30; round++) {
+        for (int edit = 0; edit < 20; edit++) {
+            TransformNode node = harness.Pick();
+            if (node == TransformHierarchy::InvalidNode) {
+                break;
+            }
+            switch (random.Below(6)) {
+                case 0: {
+                    MirrorNode& entry = harness.Nodes[node];
+                    entry.X = random.Range(-4.0, 4.0);
+                    entry.Rotation = random.Range(-3.0, 3.0);
+                    harness.Hierarchy.SetPosition(node, glm::vec2((float)entry.X, (float)entry.Y));
+                    harness.Hierarchy.SetRotation(node, (float)entry.Rotation);
+                    break;
+                }
+                case 1: {
+                    MirrorNode& entry = harness.Nodes[node];
+                    entry.ScaleX = random.Range(0.9, 1.1);
+                    harness.Hierarchy.SetScale(node, glm::vec2((float)entry.ScaleX, (float)entry.ScaleY));
+                    break;
+                }
+                case 2: {
+                    // Half the time a root; otherwise any node, which must be refused when it is a descendant
+                    TransformNode parent = random.Below(2) ? harness.Pick() : TransformHierarchy::InvalidNode;
+                    bool cycle = parent != TransformHierarchy::InvalidNode && IsAncestor(harness.Nodes, node, parent);
+                    bool moved = harness.Hierarchy.SetParent(node, parent);
+                    if (moved == cycle) {
+                        context.Fail("round %d: SetParent(%u, %u) returned %d", round, node, parent, moved);
+                    }
+                    if (moved) {
+                        harness.Nodes[node].Parent = parent;
+                    }
+                    break;
+                }
+                case 3:
+                    if (random.Below(3) == 0) {
+                        harness.Destroy(node);
+                    }
+                    break;
+                default:
+                    // Reuses handles freed by Destroy
+                    harness.Create(random.Below(8) == 0 ? TransformHierarchy::InvalidNode : node);
+                    break;
+            }
+        }
+        harness.Hierarchy.Update();
+        harness.Compare(context, round);
+    }
+
+    MRL_CHECK(harness.Hierarchy.GetStats().Layouts > 1);
+}
@@ -0,0 +1,47 @@
+#include "Test.h"
+
+#include <cstdarg>
+#include <cstdio>
+
+namespace MarleTests {
+
+    bool TestContext::Check(bool condition, const char* expression, const char* file, int line)
+    {
+        if (!condition) {
+            printf("    %s:%d: check failed: %s\n", file, line, expression);
+            m_Failures++;
+        }
+        return condition;
+    }
+
+    void TestContext::Fail(const char* format, ...)
+    {
+        printf("    ");
+        va_list args;
+        va_start(args, format);
+        vprintf(format, args);
+        va_end(args);
+        printf("\n");
+        m_Failures++;
+    }
+
+    void TestContext::Skip(const std::string& reason)
+    {
+        m_Skipped = true;
+        m_SkipReason = reason;
+    }
+
+    std::vector<Test>& GetRegistry()
+    {
+        // Function-local so registration from static initializers in other translation units is order-safe
+        static std::vector<Test> s_Registry;
+        return s_Registry;
+    }
+
+    bool RegisterTest(const std::string& name, uint32_t flags, TestFn fn)
+    {
+        GetRegistry().push_back({ name, flags, std::move(fn) });
+        return true;
+    }
+
+}
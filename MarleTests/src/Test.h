@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace MarleTests {
+
+    enum TestFlags
+    {
+        TestFlagNone       = 0,
+        TestFlagRequiresGL = 1 << 0 // Skipped when no headless OpenGL context could be created
+    };
+
+    // Handed to every test body. A failed check is reported and the test carries on, so one run
+    // shows every broken case; the test fails if any check did.
+    class TestContext {
+    public:
+        bool Check(bool condition, const char* expression, const char* file, int line);
+        // printf-style message for failures a single expression cannot describe
+        void Fail(const char* format, ...);
+        // Marks the test as skipped (missing GL feature...); checks made before still count
+        void Skip(const std::string& reason);
+
+        uint32_t GetFailureCount() const { return m_Failures; }
+        bool IsSkipped() const { return m_Skipped; }
+        const std::string& GetSkipReason() const { return m_SkipReason; }
+
+    private:
+        uint32_t m_Failures = 0;
+        bool m_Skipped = false;
+        std::string m_SkipReason;
+    };
+
+    using TestFn = std::function<void(TestContext&)>;
+
+    struct Test {
+        std::string Name;
+        uint32_t Flags = TestFlagNone;
+        TestFn Fn;
+    };
+
+    std::vector<Test>& GetRegistry();
+    bool RegisterTest(const std::string& name, uint32_t flags, TestFn fn);
+
+}
+
+#define MRL_TEST_CONCAT_INNER(a, b) a##b
+#define MRL_TEST_CONCAT(a, b) MRL_TEST_CONCAT_INNER(a, b)
+
+// Defines and registers a test body: MRL_TEST(BC7_DecodesEveryMode, TestFlagNone) { ... }
+#define MRL_TEST(name, flags) \
+    static void MRL_TEST_CONCAT(Test_, name)(MarleTests::TestContext& context); \
+    static const bool MRL_TEST_CONCAT(s_Registered_, name) = \
+        MarleTests::RegisterTest(#name, flags, &MRL_TEST_CONCAT(Test_, name)); \
+    static void MRL_TEST_CONCAT(Test_, name)(MarleTests::TestContext& context)
+
+// Inside a test body; evaluates to the condition
+#define MRL_CHECK(condition) context.Check((condition), #condition, __FILE__, __LINE__)
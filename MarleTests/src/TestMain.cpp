@@ -0,0 +1,100 @@
+#include "Test.h"
+#include "BenchGL.h"
+
+#include "Marle/Core/FileSystem.h"
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Core/MemoryTracker.h"
+#include "Marle/Core/ResourceManager.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+using namespace MarleTests;
+
+static void PrintUsage()
+{
+    printf("Usage: MarleTests [options]\n");
+    printf("\n");
+    printf("Run from the repository root so Assets/ resolves. Exits with 1 when a test failed.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --list                  List registered tests and exit\n");
+    printf("  --filter <text>         Only run tests whose name contains <text>\n");
+    printf("  --no-gl                 Skip tests that need an OpenGL context\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string filter;
+    bool useGL = true;
+    bool listOnly = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--list") == 0) {
+            listOnly = true;
+        } else if (std::strcmp(arg, "--no-gl") == 0) {
+            useGL = false;
+        } else if (std::strcmp(arg, "--filter") == 0 && hasValue) {
+            filter = argv[++i];
+        } else {
+            PrintUsage();
+            return std::strcmp(arg, "--help") == 0 ? 0 : 2;
+        }
+    }
+
+    if (listOnly) {
+        for (const Test& test : GetRegistry()) {
+            printf("%s%s\n", test.Name.c_str(), (test.Flags & TestFlagRequiresGL) ? "  [gl]" : "");
+        }
+        return 0;
+    }
+
+    // The headless context is shared with MarleBench
+    if (useGL) {
+        useGL = MarleBench::CreateHeadlessGLContext(1024, 768);
+    }
+    Marle::MemoryTracker::Init();
+    Marle::JobSystem::Init();
+    Marle::FileSystem::Init();
+    Marle::ResourceManager::Init();
+
+    uint32_t passed = 0, failed = 0, skipped = 0;
+    for (const Test& test : GetRegistry()) {
+        if (!filter.empty() && test.Name.find(filter) == std::string::npos) {
+            continue;
+        }
+
+        TestContext context;
+        if ((test.Flags & TestFlagRequiresGL) && !useGL) {
+            context.Skip("no OpenGL context");
+        } else {
+            test.Fn(context);
+        }
+
+        if (context.GetFailureCount() > 0) {
+            printf("[FAIL] %s (%u failed checks)\n", test.Name.c_str(), context.GetFailureCount());
+            failed++;
+        } else if (context.IsSkipped()) {
+            printf("[skip] %-40s %s\n", test.Name.c_str(), context.GetSkipReason().c_str());
+            skipped++;
+        } else {
+            printf("[pass] %s\n", test.Name.c_str());
+            passed++;
+        }
+    }
+
+    Marle::ResourceManager::Shutdown();
+    Marle::FileSystem::Shutdown();
+    Marle::JobSystem::Shutdown();
+    Marle::MemoryTracker::Shutdown();
+    if (useGL) {
+        MarleBench::DestroyHeadlessGLContext();
+    }
+
+    printf("%u passed, %u failed, %u skipped\n", passed, failed, skipped);
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,166 @@
+#include "Marle/Core/JobSystem.h"
+#include "Marle/Renderer/DDSFile.h"
+#include "Marle/Renderer/ImageDecoder.h"
+#include "Marle/Renderer/MipGenerator.h"
+#include "Marle/Renderer/TextureCompression.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Marle;
+
+static void PrintUsage()
+{
+    printf("Usage: MarleTexConv [options] <input>...\n");
+    printf("\n");
+    printf("Compresses images to .dds for OpenGLTexture2D. Rows are written bottom-up,\n");
+    printf("the way the engine loads every other texture.\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  -f, --format <fmt>      bc1 (default), bc3 or bc7 (mode 6 only)\n");
+    printf("  -o, --output <file>     Output path (single input only; default <input>.dds)\n");
+    printf("  -j, --threads <n>       Worker threads (default hardware threads - 1)\n");
+    printf("  -m, --mips              Store a full mip chain (gamma-correct downsample)\n");
+    printf("  --verify                Decode the result and report RMSE / PSNR\n");
+}
+
+static bool ParseFormat(const char* name, TextureFormat& format)
+{
+    if (std::strcmp(name, "bc1") == 0) { format = TextureFormat::BC1; return true; }
+    if (std::strcmp(name, "bc3") == 0) { format = TextureFormat::BC3; return true; }
+    if (std::strcmp(name, "bc7") == 0) { format = TextureFormat::BC7; return true; }
+    return false;
+}
+
+static std::string DefaultOutputPath(const std::string& input)
+{
+    size_t dot = input.find_last_of('.');
+    size_t slash = input.find_last_of("/\\");
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) {
+        return input + ".dds";
+    }
+    return input.substr(0, dot) + ".dds";
+}
+
+static bool Convert(const std::string& input, const std::string& output, TextureFormat format, bool mips, bool verify)
+{
+    ImageInfo info;
+    std::vector<uint8_t> decodedSource;   // Bottom-up, the same orientation OpenGLTexture2D uploads
+    if (!LoadImageFile(input, info, decodedSource)) {
+        printf("Error: failed to load %s (%s)\n", input.c_str(), GetImageDecodeError());
+        return false;
+    }
+    const uint8_t* pixels = decodedSource.data();
+    int width = (int)info.Width, height = (int)info.Height;
+
+    DDSImage image;
+    image.Format = format;
+    image.Width = (uint32_t)width;
+    image.Height = (uint32_t)height;
+    image.BottomUp = true;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    std::vector<std::vector<uint8_t>> sourceLevels;
+    if (mips) {
+        GenerateMipChain(pixels, image.Width, image.Height, sourceLevels);
+    } else {
+        sourceLevels.emplace_back(pixels, pixels + (size_t)width * height * 4);
+    }
+
+    size_t totalBytes = 0;
+    image.Levels.resize(sourceLevels.size());
+    for (size_t level = 0; level < sourceLevels.size(); level++) {
+        uint32_t levelWidth = std::max(image.Width >> level, 1u);
+        uint32_t levelHeight = std::max(image.Height >> level, 1u);
+        CompressImage(sourceLevels[level].data(), levelWidth, levelHeight, format, image.Levels[level]);
+        totalBytes += image.Levels[level].size();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+
+    bool saved = SaveDDS(output, image);
+    if (saved) {
+        double megapixels = (double)width * height / 1e6;
+        printf("%s -> %s (%dx%d %s, %zu mips, %.1f KB, %.1f ms, %.1f MPix/s)\n", input.c_str(), output.c_str(), width, height,
+               GetTextureFormatName(format), image.Levels.size(), totalBytes / 1024.0, seconds * 1000.0, megapixels / seconds);
+    }
+
+    if (saved && verify) {
+        std::vector<uint8_t> decoded;
+        DecompressImage(image.Levels[0].data(), image.Width, image.Height, format, decoded);
+
+        double squaredError = 0.0;
+        size_t count = (size_t)width * height * 4;
+        for (size_t i = 0; i < count; i++) {
+            double d = (double)decoded[i] - (double)pixels[i];
+            squaredError += d * d;
+        }
+        double rmse = std::sqrt(squaredError / (double)count);
+        double psnr = rmse > 0.0 ? 20.0 * std::log10(255.0 / rmse) : 99.0;
+        printf("  RMSE %.2f, PSNR %.2f dB\n", rmse, psnr);
+    }
+
+    return saved;
+}
+
+int main(int argc, char** argv)
+{
+    TextureFormat format = TextureFormat::BC1;
+    std::string outputPath;
+    std::vector<std::string> inputs;
+    uint32_t threads = 0;
+    bool mips = false;
+    bool verify = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if ((std::strcmp(arg, "-f") == 0 || std::strcmp(arg, "--format") == 0) && hasValue) {
+            if (!ParseFormat(argv[++i], format)) {
+                printf("Error: unknown format '%s'\n", argv[i]);
+                return 1;
+            }
+        } else if ((std::strcmp(arg, "-o") == 0 || std::strcmp(arg, "--output") == 0) && hasValue) {
+            outputPath = argv[++i];
+        } else if ((std::strcmp(arg, "-j") == 0 || std::strcmp(arg, "--threads") == 0) && hasValue) {
+            threads = (uint32_t)std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "-m") == 0 || std::strcmp(arg, "--mips") == 0) {
+            mips = true;
+        } else if (std::strcmp(arg, "--verify") == 0) {
+            verify = true;
+        } else if (std::strcmp(arg, "-h") == 0 || std::strcmp(arg, "--help") == 0) {
+            PrintUsage();
+            return 0;
+        } else if (arg[0] == '-') {
+            printf("Error: unknown option '%s'\n\n", arg);
+            PrintUsage();
+            return 1;
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+
+    if (inputs.empty() || (!outputPath.empty() && inputs.size() > 1)) {
+        PrintUsage();
+        return 1;
+    }
+
+    JobSystem::Init(threads);
+
+    int failures = 0;
+    for (const std::string& input : inputs) {
+        std::string output = outputPath.empty() ? DefaultOutputPath(input) : outputPath;
+        if (!Convert(input, output, format, mips, verify)) {
+            failures++;
+        }
+    }
+
+    JobSystem::Shutdown();
+    return failures == 0 ? 0 : 1;
+}
@@ -1,5 +1,43 @@
 #include <Marle.h>
 
+#include <atomic>
+#include <csignal>
+#include <cmath>
+#include <unordered_map>
+
+// Everything needed to restore a Sandbox session, stored as the "sandbox" snapshot section
+struct SandboxState {
+    double TotalTimeElapsed;
+    int32_t UpdateCount;
+    float RectPositionX;
+    float RectPositionY;
+};
+static const uint32_t s_SandboxStateVersion = 1;
+static const char* s_QuickSavePath = "sandbox_quicksave.snap";
+static const char* s_AutoSavePath = "sandbox_autosave.snap";
+static const char* s_MemoryDumpPath = "sandbox_memory.txt";
+static const char* s_FrameLogPath = "sandbox_frames.csv";
+static const char* s_WorldPath = "sandbox_world";
+static const char* s_AssetArchivePath = "Assets.mpak";
+
+// Lanterns drifting over the scene, simulated by a headless SandboxServer (MARLE_SERVER=1) and
+// drawn by Sandbox clients started with MARLE_CONNECT=a.b.c.d:port
+static const uint16_t s_LanternPort = 27015;
+static const uint32_t s_LanternCount = 256;
+
+static const Marle::ReplicationSchema& GetLanternSchema()
+{
+    static const Marle::ReplicationSchema schema = []() {
+        Marle::ReplicationSchema lanterns;
+        lanterns.AddFloat("X", 0.0f, 1024.0f, 0.05f);
+        lanterns.AddFloat("Y", 0.0f, 768.0f, 0.05f);
+        lanterns.AddFloat("Size", 4.0f, 36.0f, 0.25f);
+        lanterns.AddBool("Lit");
+        return lanterns;
+    }();
+    return schema;
+}
+
 class Sandbox : public Marle::Application
 {
 private:
@@ -7,15 +45,233 @@ private:
     int m_UpdateCount = 0;
     float m_RectPositionX = 0.0f; // Example value to change in OnUpdate
     float m_RectPositionY = 100.0f; // Y position for the sprite
-    std::unique_ptr<Marle::OpenGLTexture2D> m_TestTexture;
+    Marle::ResourceHandle<Marle::OpenGLTexture2D> m_TestTexture;
+    Marle::ParticleSystem m_Particles;
+    Marle::ParticleEmitter* m_SparkEmitter = nullptr;
+    Marle::ResourceHandle<Marle::Font> m_Font;
+    Marle::SnapshotSaver m_Saver;
+    Marle::RenderGraphResource m_SceneTarget = Marle::RenderGraph::InvalidResource;
+    Marle::RenderGraphResource m_PreviewTarget = Marle::RenderGraph::InvalidResource;
+    bool m_ShowPreview = false;
+    std::shared_ptr<Marle::AudioClip> m_Chirp;
+    Marle::AnimationSystem m_Animation;
+    std::shared_ptr<Marle::AnimationClip> m_SwayClip;
+    std::shared_ptr<Marle::AnimationClip> m_CurlClip;
+    std::vector<Marle::AnimationInstance> m_Seaweed;
+    bool m_SeaweedCurled = false;
+    Marle::NavGrid m_NavGrid{ 128, 96, 8.0f };      // 8 px cells over the whole window
+    Marle::FlowFieldCache m_FlowFields{ m_NavGrid };
+    std::shared_ptr<const Marle::FlowField> m_CrowdField;
+    std::vector<glm::vec2> m_Crowd;
+    uint32_t m_CrowdGoal = 0;
+    uint32_t m_CrowdArrivals = 0;
+    bool m_GateOpen = true;
+    Marle::ReplicationClient m_Lanterns{ GetLanternSchema() };
+    double m_RenderAlpha = 0.0;
+    Marle::TransformHierarchy m_Transforms;
+    Marle::TransformNode m_SpriteNode = Marle::TransformHierarchy::InvalidNode;
+    Marle::TransformNode m_TurretNode = Marle::TransformHierarchy::InvalidNode;
+    Marle::TransformNode m_BarrelNode = Marle::TransformHierarchy::InvalidNode;
+
+    struct WorldProp {
+        glm::vec2 Position;
+        glm::vec2 Size;
+        Marle::ResourceHandle<Marle::OpenGLTexture2D> Texture;
+    };
+    Marle::WorldStreamer m_World;
+    bool m_WorldView = false;
+    double m_WorldTime = 0.0;
+    glm::vec2 m_WorldCamera = { 0.0f, 0.0f };                          // View center
+    std::unordered_map<uint64_t, std::vector<WorldProp>> m_WorldProps;  // Per active chunk
 
 public:
     Sandbox() : Marle::Application({"Glass - The Sunken Orangerie - Sprite Rendering Test", 1024, 768})
     {
         printf("Sandbox Application created.\n");
+
+        // A packed Assets.mpak, when there is one, serves Assets/ instead of the loose files
+        if (Marle::FileSystem::Exists(s_AssetArchivePath)) {
+            Marle::FileSystem::MountArchive("Assets", s_AssetArchivePath);
+        }
         
         // Load test texture
-        m_TestTexture = std::make_unique<Marle::OpenGLTexture2D>("Assets/Textures/test_sprite.tga");
+        m_TestTexture = Marle::ResourceManager::Load<Marle::OpenGLTexture2D>("Assets/Textures/test_sprite.dds");
+
+        // Sparks trailing the sprite; Space fires an extra burst
+        Marle::ParticleEmitterProps sparks;
+        sparks.VelocityMin = { -40.0f, 60.0f };
+        sparks.VelocityMax = { 40.0f, 160.0f };
+        sparks.Acceleration = { 0.0f, -200.0f };
+        sparks.ColorMin = { 1.0f, 0.5f, 0.1f, 1.0f };
+        sparks.ColorMax = { 1.0f, 0.9f, 0.4f, 1.0f };
+        sparks.SizeBegin = 6.0f;
+        sparks.SizeEnd = 1.0f;
+        sparks.LifetimeMin = 0.6f;
+        sparks.LifetimeMax = 1.2f;
+        sparks.EmissionRate = 120.0f;
+        sparks.MaxParticles = 4096;
+        sparks.BlendMode = Marle::ParticleBlendMode::Additive;
+        m_SparkEmitter = m_Particles.CreateEmitter(sparks);
+
+        // Runs before OnUpdate each fixed step; SandboxState stands for the members saved in snapshots
+        Marle::SystemScheduler::AddSystem("Particles",
+            [](Marle::SystemScheduler::SystemBuilder& builder) {
+                builder.Write<Marle::ParticleSystem>();
+                builder.Read<SandboxState>();
+            },
+            [this](double fixed_dt) {
+                m_SparkEmitter->SetPosition({ m_RectPositionX + 512.0f, m_RectPositionY + 384.0f });
+                m_Particles.Update((float)fixed_dt);
+            });
+
+        // HUD font (Lato, SIL Open Font License; see Assets/Fonts/OFL.txt)
+        m_Font = Marle::ResourceManager::Load<Marle::Font>("Assets/Fonts/Lato-Regular.ttf");
+
+        BuildSeaweed();
+        Marle::SystemScheduler::AddSystem("Animation",
+            [](Marle::SystemScheduler::SystemBuilder& builder) {
+                builder.Write<Marle::AnimationSystem>();
+            },
+            [this](double fixed_dt) {
+                m_Animation.Update((float)fixed_dt);
+            });
+
+        // A turret riding on the sprite, with a barrel on the turret; only the local transforms
+        // are ever set
+        m_SpriteNode = m_Transforms.Create();
+        m_TurretNode = m_Transforms.Create(m_SpriteNode, { 0.0f, 40.0f });
+        m_BarrelNode = m_Transforms.Create(m_TurretNode, { 20.0f, 0.0f });
+        Marle::SystemScheduler::AddSystem("Transforms",
+            [](Marle::SystemScheduler::SystemBuilder& builder) {
+                builder.Write<Marle::TransformHierarchy>();
+                builder.Read<SandboxState>();
+            },
+            [this](double) {
+                m_Transforms.SetPosition(m_SpriteNode, { m_RectPositionX + 512.0f, m_RectPositionY + 384.0f });
+                m_Transforms.SetRotation(m_TurretNode, (float)m_TotalTimeElapsed);
+                m_Transforms.Update();
+            });
+
+        BuildCrowd();
+        Marle::SystemScheduler::AddSystem("Navigation",
+            [](Marle::SystemScheduler::SystemBuilder& builder) {
+                builder.Write<Marle::FlowFieldCache>();
+            },
+            [this](double) {
+                m_FlowFields.Update();
+            });
+
+        if (const char* address = getenv("MARLE_CONNECT")) {
+            Marle::NetAddress server;
+            if (Marle::NetAddress::Parse(address, server)) {
+                m_Lanterns.Connect(server);
+            } else {
+                printf("Error: MARLE_CONNECT must look like 127.0.0.1:%u\n", s_LanternPort);
+            }
+        }
+        if (const char* socket = getenv("MARLE_METRICS_SOCKET")) {
+            Marle::Metrics::ListenOnSocket(socket); // Text metrics for `MarleStat -s <path>`
+        }
+
+        // Short rising chirp for the burst; generated so the sandbox needs no audio assets
+        const uint32_t chirpRate = 48000;
+        std::vector<float> chirp(chirpRate / 5);
+        float phase = 0.0f;
+        for (size_t i = 0; i < chirp.size(); i++) {
+            float t = (float)i / (float)chirp.size();
+            phase += 2.0f * 3.14159265f * (440.0f + 880.0f * t) / (float)chirpRate;
+            chirp[i] = 0.4f * sinf(phase) * (1.0f - t);
+        }
+        m_Chirp = Marle::AudioClip::Create(chirpRate, 1, chirp.data(), (uint32_t)chirp.size());
+    }
+
+    // A row of skinned seaweed along the bottom of the screen: a six-bone chain with a strip
+    // mesh, swaying by default and curling up on C (crossfaded)
+    void BuildSeaweed()
+    {
+        const uint32_t boneCount = 6;
+        const float boneLength = 24.0f;
+        const float halfWidth = 8.0f;
+
+        auto skeleton = std::make_shared<Marle::Skeleton>();
+        Marle::BoneTransform root;
+        root.Rotation = 1.5707963f; // Grow upwards
+        skeleton->AddBone("Root", Marle::Skeleton::NoParent, root);
+        for (uint32_t bone = 1; bone < boneCount; bone++) {
+            Marle::BoneTransform segment;
+            segment.Position = { boneLength, 0.0f };
+            skeleton->AddBone("Segment" + std::to_string(bone), (int32_t)bone - 1, segment);
+        }
+
+        // Two vertices per joint plus the tip, each shared between the bones either side
+        auto mesh = std::make_shared<Marle::SkinnedMesh>(boneCount);
+        for (uint32_t joint = 0; joint <= boneCount; joint++) {
+            float v = (float)joint / (float)boneCount;
+            uint32_t bone = std::min(joint, boneCount - 1);
+            uint32_t previous = joint > 0 ? joint - 1 : 0;
+            glm::vec2 center = { 0.0f, joint * boneLength };
+            float width = halfWidth * (1.0f - 0.7f * v);
+            mesh->AddVertex(center + glm::vec2(-width, 0.0f), { 0.0f, v }, { { bone, 0.5f }, { previous, 0.5f } });
+            mesh->AddVertex(center + glm::vec2(width, 0.0f), { 1.0f, v }, { { bone, 0.5f }, { previous, 0.5f } });
+            if (joint > 0) {
+                uint32_t base = (joint - 1) * 2;
+                mesh->AddTriangle(base, base + 1, base + 3);
+                mesh->AddTriangle(base, base + 3, base + 2);
+            }
+        }
+
+        m_SwayClip = std::make_shared<Marle::AnimationClip>(*skeleton, 2.0f, true);
+        m_CurlClip = std::make_shared<Marle::AnimationClip>(*skeleton, 1.0f, true);
+        for (uint32_t bone = 1; bone < boneCount; bone++) {
+            for (uint32_t key = 0; key <= 8; key++) {
+                float t = key * 0.25f;
+                m_SwayClip->AddKey(bone, Marle::AnimationTrack::Rotation, t, 0.18f * sinf(t * 3.14159265f + bone * 0.6f));
+            }
+            m_CurlClip->AddKey(bone, Marle::AnimationTrack::Rotation, 0.0f, 0.45f);
+            m_CurlClip->AddKey(bone, Marle::AnimationTrack::Rotation, 0.5f, 0.55f);
+            m_CurlClip->AddKey(bone, Marle::AnimationTrack::Rotation, 1.0f, 0.45f);
+        }
+        m_SwayClip->Bake();
+        m_CurlClip->Bake();
+
+        for (uint32_t i = 0; i < 48; i++) {
+            Marle::AnimationInstance seaweed = m_Animation.CreateInstance(skeleton, mesh);
+            m_Animation.SetTransform(seaweed, { 16.0f + i * 21.0f, 0.0f }, 0.0f, glm::vec2(0.8f + 0.05f * (i % 5)));
+            m_Animation.Play(seaweed, m_SwayClip, 0.0f, 0.8f + 0.1f * (i % 4));
+            m_Seaweed.push_back(seaweed);
+        }
+    }
+
+    // Walls with a gate (O) and a patch of slow ground; the crowd heads for one of four corners (G)
+    void BuildCrowd()
+    {
+        m_NavGrid.FillRect(30, 10, 2, 76, Marle::NavGrid::Blocked);
+        m_NavGrid.FillRect(64, 0, 2, 40, Marle::NavGrid::Blocked);
+        m_NavGrid.FillRect(64, 48, 2, 48, Marle::NavGrid::Blocked);
+        m_NavGrid.FillRect(96, 10, 2, 76, Marle::NavGrid::Blocked);
+        m_NavGrid.FillRect(40, 30, 16, 36, 6);
+
+        for (uint32_t i = 0; i < 2000; i++) {
+            m_Crowd.push_back(RandomCrowdPosition());
+        }
+        SetCrowdGoal(0);
+    }
+
+    glm::vec2 RandomCrowdPosition()
+    {
+        for (;;) {
+            glm::ivec2 cell(rand() % (int)m_NavGrid.GetWidth(), rand() % (int)m_NavGrid.GetHeight());
+            if (m_NavGrid.IsWalkable(cell)) {
+                return m_NavGrid.CellToWorld(cell);
+            }
+        }
+    }
+
+    void SetCrowdGoal(uint32_t index)
+    {
+        static const glm::ivec2 goals[] = { { 4, 4 }, { 123, 91 }, { 123, 4 }, { 4, 91 } };
+        m_CrowdGoal = index % 4;
+        m_CrowdField = m_FlowFields.GetField(goals[m_CrowdGoal]);
     }
 
     ~Sandbox()
@@ -54,6 +310,57 @@ public:
             case Marle::Key::Space:
                 printf("Space pressed! Resetting position.\n");
                 m_RectPositionX = 0.0f;
+                m_SparkEmitter->Burst(500);
+                if (m_Chirp) {
+                    Marle::AudioPlayParams chirp;
+                    chirp.Pitch = 0.8f + 0.4f * (float)rand() / (float)RAND_MAX;
+                    Marle::AudioEngine::Play(m_Chirp, chirp);
+                }
+                break;
+            case Marle::Key::C:
+                m_SeaweedCurled = !m_SeaweedCurled;
+                for (Marle::AnimationInstance seaweed : m_Seaweed) {
+                    m_Animation.Play(seaweed, m_SeaweedCurled ? m_CurlClip : m_SwayClip, 0.4f);
+                }
+                break;
+            case Marle::Key::G:
+                SetCrowdGoal(m_CrowdGoal + 1);
+                break;
+            case Marle::Key::O:
+                m_GateOpen = !m_GateOpen;
+                m_NavGrid.FillRect(64, 40, 2, 8, m_GateOpen ? 1 : Marle::NavGrid::Blocked);
+                break;
+            case Marle::Key::F5:
+                SaveState(s_QuickSavePath, false);
+                break;
+            case Marle::Key::F6:
+                ToggleWorldView();
+                break;
+            case Marle::Key::F7:
+                // Unreferenced textures, shaders and fonts go a few per frame instead of all at once
+                Marle::ResourceManager::ClearCacheOverFrames();
+                break;
+            case Marle::Key::F8:
+                Marle::SystemScheduler::PrintStats();
+                Marle::FrameTaskScheduler::PrintStats();
+                Marle::FileSystem::PrintStats();
+                break;
+            case Marle::Key::F9:
+                LoadState(s_QuickSavePath);
+                break;
+            case Marle::Key::F10:
+                m_ShowPreview = !m_ShowPreview;
+                Marle::RenderGraph::PrintStats();
+                break;
+            case Marle::Key::F11:
+                if (Marle::RenderProfiler::IsLogging()) {
+                    Marle::RenderProfiler::StopLog();
+                } else {
+                    Marle::RenderProfiler::StartLog(s_FrameLogPath);
+                }
+                break;
+            case Marle::Key::F12:
+                Marle::MemoryTracker::DumpToFile(s_MemoryDumpPath);
                 break;
             case Marle::Key::Escape:
                 printf("Escape pressed! (Note: This might close the application)\n");
@@ -63,6 +370,123 @@ public:
         return false; // Don't consume the event
     }
 
+    static uint64_t WorldPropKey(const glm::ivec2& chunk)
+    {
+        return ((uint64_t)(uint32_t)chunk.x << 32) | (uint32_t)chunk.y;
+    }
+
+    // Where the flythrough camera is after `time` seconds: a slow Lissajous over the whole world
+    glm::vec2 GetWorldCamera(double time) const
+    {
+        float extent = m_World.GetChunkSize() * 24.0f;
+        return { extent + extent * 0.85f * (float)sin(time * 0.11), extent + extent * 0.85f * (float)sin(time * 0.17) };
+    }
+
+    // 48x48 chunks of 512 units with 64 props each; only ever written once
+    static bool GenerateWorld()
+    {
+        const int chunks = 48;
+        const float chunkSize = 512.0f;
+        Marle::WorldWriter writer(s_WorldPath, chunkSize);
+        for (int y = 0; y < chunks; y++) {
+            for (int x = 0; x < chunks; x++) {
+                Marle::WorldChunkData chunk;
+                chunk.Coord = { x, y };
+                chunk.Assets.push_back("Assets/Textures/test_sprite.dds");
+                for (uint32_t i = 0; i < 64; i++) {
+                    Marle::WorldEntity prop;
+                    prop.Type = "Prop";
+                    prop.Position = { (x + (float)rand() / (float)RAND_MAX) * chunkSize, (y + (float)rand() / (float)RAND_MAX) * chunkSize };
+                    prop.Scale = glm::vec2(16.0f + 32.0f * (float)rand() / (float)RAND_MAX);
+                    prop.Asset = 0;
+                    chunk.Entities.push_back(prop);
+                }
+                if (!writer.AddChunk(chunk)) {
+                    return false;
+                }
+            }
+        }
+        return writer.Finish();
+    }
+
+    // F6 flies over a streamed world (generated into sandbox_world/ on first use); F6 again
+    // prints the streaming report and closes it
+    void ToggleWorldView()
+    {
+        if (m_WorldView) {
+            m_World.PrintReport();
+            m_World.Close();
+            m_WorldView = false;
+            return;
+        }
+
+        if (!Marle::FileSystem::Exists(std::string(s_WorldPath) + "/world.manifest") && !GenerateWorld()) {
+            return;
+        }
+        if (!m_World.Open(s_WorldPath)) {
+            return;
+        }
+        m_World.SetCallbacks(
+            [this](const Marle::WorldChunk& chunk, uint32_t first, uint32_t count) {
+                std::vector<WorldProp>& props = m_WorldProps[WorldPropKey(chunk.Data.Coord)];
+                for (uint32_t i = first; i < first + count; i++) {
+                    const Marle::WorldEntity& entity = chunk.Data.Entities[i];
+                    if (entity.Asset != Marle::WorldEntity::NoAsset) {
+                        props.push_back({ entity.Position, entity.Scale, chunk.Textures[entity.Asset] });
+                    }
+                }
+            },
+            [this](const Marle::WorldChunk& chunk) {
+                m_WorldProps.erase(WorldPropKey(chunk.Data.Coord));
+            });
+
+        m_WorldTime = 0.0;
+        m_WorldCamera = GetWorldCamera(m_WorldTime);
+        m_World.Preload(m_WorldCamera);
+        m_WorldView = true;
+    }
+
+    void SaveState(const char* path, bool async)
+    {
+        // Capturing is a copy of the state; the write happens on the saver's thread
+        Marle::SnapshotCapture* capture = m_Saver.BeginCapture();
+        if (!capture) {
+            printf("Save skipped: previous saves still in progress\n");
+            return;
+        }
+
+        SandboxState state{ m_TotalTimeElapsed, m_UpdateCount, m_RectPositionX, m_RectPositionY };
+        capture->AddSection("sandbox", s_SandboxStateVersion, &state, sizeof(state));
+
+        if (async) {
+            m_Saver.SaveAsync(capture, path);
+        } else if (m_Saver.SaveNow(capture, path)) {
+            printf("Saved %s\n", path);
+        }
+    }
+
+    void LoadState(const char* path)
+    {
+        Marle::Snapshot snapshot;
+        if (!snapshot.Load(path)) {
+            return;
+        }
+
+        size_t count = 0;
+        uint32_t version = 0;
+        const SandboxState* state = snapshot.GetArray<SandboxState>("sandbox", count, &version);
+        if (!state || count != 1 || version != s_SandboxStateVersion) {
+            printf("Error: %s has no compatible Sandbox state\n", path);
+            return;
+        }
+
+        m_TotalTimeElapsed = state->TotalTimeElapsed;
+        m_UpdateCount = state->UpdateCount;
+        m_RectPositionX = state->RectPositionX;
+        m_RectPositionY = state->RectPositionY;
+        printf("Loaded %s (save #%llu)\n", path, (unsigned long long)snapshot.GetGeneration());
+    }
+
     bool OnKeyReleased(Marle::KeyReleasedEvent& event)
     {
         printf("Key Released: %d\n", event.GetKeyCode());
@@ -82,6 +506,19 @@ protected:
 
         m_TotalTimeElapsed += fixed_dt;
         m_UpdateCount++;
+        UpdateCrowd((float)fixed_dt);
+        m_Lanterns.Update(fixed_dt);
+
+        if (m_WorldView) {
+            m_WorldTime += fixed_dt;
+            m_WorldCamera = GetWorldCamera(m_WorldTime);
+            m_World.Update(m_WorldCamera, (float)fixed_dt);
+        }
+
+        // Autosave every 30 seconds, off the update thread
+        if (m_UpdateCount % (60 * 30) == 0) {
+            SaveState(s_AutoSavePath, true);
+        }
 
         // Log roughly every second
         if (m_UpdateCount % 60 == 0) { // Assuming 60 UPS target
@@ -90,25 +527,244 @@ protected:
         }
     }
 
+    // One O(1) flow lookup per agent; moves slide along walls one axis at a time
+    void UpdateCrowd(float dt)
+    {
+        if (!m_CrowdField) {
+            return;
+        }
+        const float speed = 60.0f;
+        glm::ivec2 goal = m_CrowdField->GetGoal();
+        for (glm::vec2& agent : m_Crowd) {
+            glm::ivec2 cell = m_NavGrid.WorldToCell(agent);
+            if (std::abs(cell.x - goal.x) <= 1 && std::abs(cell.y - goal.y) <= 1) {
+                agent = RandomCrowdPosition();
+                m_CrowdArrivals++;
+                continue;
+            }
+            glm::vec2 direction = m_CrowdField->GetDirection(agent);
+            glm::vec2 next(agent.x + direction.x * speed * dt, agent.y);
+            if (m_NavGrid.IsWalkable(m_NavGrid.WorldToCell(next))) {
+                agent = next;
+            }
+            next = glm::vec2(agent.x, agent.y + direction.y * speed * dt);
+            if (m_NavGrid.IsWalkable(m_NavGrid.WorldToCell(next))) {
+                agent = next;
+            }
+        }
+    }
+
     void OnRender(double interpolation_alpha) override {
         // Call base if it does anything important
         Marle::Application::OnRender(interpolation_alpha);
-        
+        m_RenderAlpha = interpolation_alpha;
+
+        // The scene is drawn off-screen and composited onto the backbuffer. The preview pass is
+        // always added, but the graph culls it unless F10 has the composite read its output.
+        Marle::RenderGraph::TargetDesc sceneDesc;
+        sceneDesc.ClearColor = { 0.1f, 0.1f, 0.15f, 1.0f };
+        Marle::RenderGraph::AddPass("Scene",
+            [this, &sceneDesc](Marle::RenderGraph::PassBuilder& builder) {
+                m_SceneTarget = builder.Write(builder.Create("SceneColor", sceneDesc), true);
+            },
+            [this](Marle::RenderGraph::PassContext&) { DrawScene(); });
+
+        Marle::RenderGraph::TargetDesc previewDesc;
+        previewDesc.Scale = 0.25f;
+        Marle::RenderGraph::AddPass("Preview",
+            [this, &previewDesc](Marle::RenderGraph::PassBuilder& builder) {
+                builder.Read(m_SceneTarget);
+                m_PreviewTarget = builder.Write(builder.Create("PreviewColor", previewDesc));
+            },
+            [this](Marle::RenderGraph::PassContext& context) { Marle::Renderer2D::Blit(context.GetTexture(m_SceneTarget)); });
+
+        Marle::RenderGraph::AddPass("Composite",
+            [this](Marle::RenderGraph::PassBuilder& builder) {
+                builder.Read(m_SceneTarget);
+                if (m_ShowPreview) {
+                    builder.Read(m_PreviewTarget);
+                }
+                builder.Write(Marle::RenderGraph::GetBackbuffer());
+            },
+            [this](Marle::RenderGraph::PassContext& context) {
+                Marle::Renderer2D::Blit(context.GetTexture(m_SceneTarget));
+                if (m_ShowPreview) {
+                    Marle::Renderer2D::Blit(context.GetTexture(m_PreviewTarget), { 0.72f, 0.72f }, { 0.98f, 0.98f });
+                }
+            });
+    }
+
+    void DrawScene()
+    {
+        if (m_WorldView) {
+            DrawWorld();
+        }
+
         // Begin scene for 2D rendering
         Marle::Renderer2D::BeginScene();
         
         // Draw the test sprite
         if (m_TestTexture) {
             // Draw sprite at current position with 64x64 size
-            Marle::Renderer2D::DrawQuad({m_RectPositionX + 512.0f, m_RectPositionY + 384.0f}, {64.0f, 64.0f}, m_TestTexture.get());
+            Marle::Renderer2D::DrawQuad({m_RectPositionX + 512.0f, m_RectPositionY + 384.0f}, {64.0f, 64.0f}, m_TestTexture.Get());
+            Marle::Renderer2D::DrawTransformedQuad(m_Transforms.GetWorld(m_TurretNode), { 24.0f, 24.0f }, m_TestTexture.Get());
+            Marle::Renderer2D::DrawTransformedQuad(m_Transforms.GetWorld(m_BarrelNode), { 24.0f, 6.0f }, m_TestTexture.Get());
+        }
+
+        m_Particles.Render();
+        if (m_TestTexture) {
+            m_Animation.Render(m_TestTexture.Get());
+
+            // Between the two server snapshots around the render time; unlit lanterns shrink
+            for (const Marle::ReplicatedEntity& lantern : m_Lanterns.Interpolate(m_RenderAlpha)) {
+                float size = lantern.Values[2] * (lantern.Values[3] != 0.0f ? 1.0f : 0.5f);
+                Marle::Renderer2D::DrawQuad({ lantern.Values[0], lantern.Values[1] }, { size, size }, m_TestTexture.Get());
+            }
+        }
+
+        if (m_Font) {
+            Marle::TextureStreamer::Stats textures = Marle::TextureStreamer::GetStats();
+            char hud[128];
+            snprintf(hud, sizeof(hud), "Updates: %d   Particles: %u   Textures: %.1f / %.0f MB", m_UpdateCount,
+                     m_Particles.GetAliveCount(), textures.ResidentBytes / (1024.0 * 1024.0), textures.BudgetBytes / (1024.0 * 1024.0));
+            Marle::Renderer2D::DrawText(*m_Font.Get(), "Glass - The Sunken Orangerie", { 16.0f, 736.0f }, 24.0f);
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 710.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            // Results lag a few frames behind; the GPU is never waited on for them
+            const Marle::RenderProfiler::FrameRecord& frame = Marle::RenderProfiler::GetLastFrame();
+            snprintf(hud, sizeof(hud), "CPU %.2f ms   GPU %.2f ms (%s-bound)   Draws: %u   State changes: %u", frame.CpuMs,
+                     frame.GpuPassMs, frame.GpuBound ? "GPU" : "CPU", frame.Stats.DrawCalls, frame.Stats.StateChanges);
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 688.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            const Marle::RenderGraph::Stats& graph = Marle::RenderGraph::GetStats();
+            snprintf(hud, sizeof(hud), "Passes: %u (%u culled)   Transient: %.1f MB, peak %.1f MB", graph.Passes,
+                     graph.CulledPasses, graph.TransientBytes / (1024.0 * 1024.0), graph.PeakTransientBytes / (1024.0 * 1024.0));
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 666.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            Marle::AudioEngine::Stats audio = Marle::AudioEngine::GetStats();
+            snprintf(hud, sizeof(hud), "Voices: %u   Mix %.3f ms (max %.3f) of %.2f ms   Underruns: %llu", audio.ActiveVoices,
+                     audio.MixMsAverage, audio.MixMsMax, audio.PeriodMs, (unsigned long long)(audio.StreamUnderruns + audio.DeviceUnderruns));
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 644.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            const Marle::AnimationSystem::Stats& animation = m_Animation.GetStats();
+            snprintf(hud, sizeof(hud), "Skinned: %u (%u bones, %u vertices)   Update %.3f ms   Skin %.3f ms", animation.Instances,
+                     animation.Bones, animation.Vertices, animation.UpdateMs, animation.SkinMs);
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 622.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            const Marle::FlowFieldCache::Stats& flow = m_FlowFields.GetStats();
+            snprintf(hud, sizeof(hud), "Crowd: %zu (%u arrived)   Flow sectors %u (%u rebuilt)   Search %.3f ms   Build %.3f ms",
+                     m_Crowd.size(), m_CrowdArrivals, flow.BuiltSectors, flow.RebuiltSectors, flow.SearchMs, flow.BuildMs);
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 600.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            const Marle::FrameTaskScheduler::Stats& tasks = Marle::FrameTaskScheduler::GetStats();
+            snprintf(hud, sizeof(hud), "Tasks: %u pending   Budget %.2f ms (used %.2f, ceiling %.2f)   Deadlines missed: %llu",
+                     tasks.Pending, tasks.BudgetMs, tasks.UsedMs, tasks.CeilingMs, (unsigned long long)tasks.DeadlinesMissed);
+            Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 578.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+
+            if (m_WorldView) {
+                const Marle::WorldStreamer::Stats& world = m_World.GetStats();
+                snprintf(hud, sizeof(hud), "World: %u chunks (%u loading)   %.2f / %.0f MB   Load %.1f ms (max %.1f)   Hitches: %llu",
+                         world.ActiveChunks, world.LoadingChunks, world.ResidentBytes / (1024.0 * 1024.0),
+                         world.BudgetBytes / (1024.0 * 1024.0), world.AverageLoadMs, world.MaxLoadMs, (unsigned long long)world.Hitches);
+                Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 534.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+            }
+            if (m_Lanterns.GetState() != Marle::ReplicationClient::State::Disconnected) {
+                const Marle::ReplicationClient::Stats& net = m_Lanterns.GetStats();
+                snprintf(hud, sizeof(hud), "Lanterns: %u   %.1f KB/s   RTT %.0f ms   Buffered %.1f ticks   Starved %u", net.Entities,
+                         net.BytesPerSecond / 1024.0f, net.RttMs, net.BufferedTicks, net.StarvedFrames);
+                Marle::Renderer2D::DrawText(*m_Font.Get(), hud, { 16.0f, 556.0f }, 16.0f, { 0.8f, 0.9f, 1.0f, 1.0f });
+            }
         }
         
         // End scene
         Marle::Renderer2D::EndScene();
     }
+
+    // The streamed world behind everything else, in its own scene with the flythrough camera
+    void DrawWorld()
+    {
+        glm::vec2 half(512.0f, 384.0f);
+        Marle::Renderer2D::BeginScene(m_WorldCamera - half);
+        glm::ivec2 first = m_World.WorldToChunk(m_WorldCamera - half);
+        glm::ivec2 last = m_World.WorldToChunk(m_WorldCamera + half);
+        for (int y = first.y; y <= last.y; y++) {
+            for (int x = first.x; x <= last.x; x++) {
+                auto props = m_WorldProps.find(WorldPropKey({ x, y }));
+                if (props == m_WorldProps.end()) {
+                    continue;
+                }
+                for (const WorldProp& prop : props->second) {
+                    if (prop.Texture) {
+                        Marle::Renderer2D::DrawQuad(prop.Position, prop.Size, prop.Texture.Get());
+                    }
+                }
+            }
+        }
+        Marle::Renderer2D::EndScene();
+    }
+};
+
+static std::atomic<bool> s_ServerQuit{ false };
+
+// Dedicated server for the lanterns: no window, only fixed updates. Ctrl+C stops it.
+class SandboxServer : public Marle::Application
+{
+private:
+    Marle::ReplicationServer m_Server{ GetLanternSchema() };
+    std::vector<float> m_Phases;
+    uint32_t m_UpdateCount = 0;
+
+public:
+    SandboxServer() : Marle::Application({ "Glass - Lantern Server", 0, 0, true })
+    {
+        if (!m_Server.Start(s_LanternPort)) {
+            Close();
+        }
+        for (uint32_t i = 0; i < s_LanternCount; i++) {
+            m_Phases.push_back((float)rand() / (float)RAND_MAX * 6.2831853f);
+        }
+        signal(SIGINT, [](int) { s_ServerQuit = true; });
+        if (const char* socket = getenv("MARLE_METRICS_SOCKET")) {
+            Marle::Metrics::ListenOnSocket(socket);
+        }
+    }
+
+protected:
+    void OnUpdate(double fixed_dt) override {
+        if (s_ServerQuit) {
+            Close();
+        }
+        m_Server.Update(fixed_dt);
+
+        // Slow Lissajous drift; a quarter of the lanterns is moving fast enough to need every snapshot
+        float time = m_UpdateCount++ * (float)fixed_dt;
+        m_Server.BeginSnapshot();
+        for (uint32_t i = 0; i < s_LanternCount; i++) {
+            float phase = m_Phases[i];
+            float speed = (i % 4 == 0) ? 0.6f : 0.05f;
+            float values[4] = {
+                512.0f + 420.0f * sinf(time * speed + phase),
+                384.0f + 300.0f * sinf(time * speed * 1.3f + phase * 2.0f),
+                12.0f + 8.0f * sinf(phase * 5.0f),
+                fmodf(time * 0.2f + phase, 6.2831853f) < 5.0f ? 1.0f : 0.0f,
+            };
+            m_Server.WriteEntity(i, values);
+        }
+        m_Server.EndSnapshot();
+
+        if (m_UpdateCount % (60 * 5) == 0) {
+            const Marle::ReplicationServer::Stats& stats = m_Server.GetStats();
+            printf("Lantern server - Clients: %u   %.0f B/client/s   Encode %.1f ns/entity   Snapshot %.0f B   RTT %.0f ms   Loss %.1f%%\n",
+                   stats.Clients, stats.BytesPerClientPerSecond, stats.EncodeNsPerEntity, stats.AverageSnapshotBytes,
+                   stats.RttMs, stats.PacketLossPercent);
+        }
+    }
 };
 
 Marle::Application* Marle::CreateApplication()
 {
+    if (getenv("MARLE_SERVER")) {
+        return new SandboxServer();
+    }
     return new Sandbox();
 }
\ No newline at end of file
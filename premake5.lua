@@ -86,6 +86,7 @@ project "Marle"
         }
 
     filter "configurations:Debug"
+        defines "MRL_DEBUG"
         symbols "On"
     
     filter "configurations:Release"
@@ -159,10 +160,325 @@ project "Sandbox"
         }
 
     filter "configurations:Debug"
+        defines "MRL_DEBUG"
         symbols "On"
     
     filter "configurations:Release"
         optimize "On"
 
     filter "configurations:Dist"
-        optimize "On"
\ No newline at end of file
+        optimize "On"
+
+project "MarleBench"
+    location "MarleBench"
+    kind "ConsoleApp"
+    language "C++"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files 
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp",
+    }
+
+    includedirs
+    {
+        "Marle/vendor/spdlog/include",
+        "Marle/src",
+        "Marle/vendor/glad/include",
+        "Marle/vendor",
+        "Marle/vendor/glm"
+    }
+
+    links 
+    {
+        "Marle"
+    }
+
+    filter "system:windows"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_WINDOWS"
+        }
+
+    filter "system:macosx"
+        cppdialect "C++17"
+        staticruntime "On"
+        buildoptions { "-stdlib=libc++" }
+        linkoptions { "-stdlib=libc++" }
+
+        defines 
+        {
+            "MRL_PLATFORM_MACOS"
+        }
+
+        includedirs
+        {
+            "/Library/Developer/CommandLineTools/SDKs/MacOSX15.5.sdk/usr/include/c++/v1"
+        }
+
+        -- Headless CGL context for the renderer benchmarks
+        links
+        {
+            "OpenGL.framework"
+        }
+
+    filter "system:linux"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_LINUX"
+        }
+
+    filter "configurations:Debug"
+        defines "MRL_DEBUG"
+        symbols "On"
+    
+    filter "configurations:Release"
+        optimize "On"
+
+    filter "configurations:Dist"
+        optimize "On"
+
+-- Offline texture compressor (BC1/BC3/BC7 .dds)
+project "MarleTexConv"
+    location "MarleTexConv"
+    kind "ConsoleApp"
+    language "C++"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files 
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp",
+    }
+
+    includedirs
+    {
+        "Marle/vendor/spdlog/include",
+        "Marle/src",
+        "Marle/vendor/glad/include",
+        "Marle/vendor",
+        "Marle/vendor/glm"
+    }
+
+    links 
+    {
+        "Marle"
+    }
+
+    filter "system:windows"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_WINDOWS"
+        }
+
+    filter "system:macosx"
+        cppdialect "C++17"
+        staticruntime "On"
+        buildoptions { "-stdlib=libc++" }
+        linkoptions { "-stdlib=libc++" }
+
+        defines 
+        {
+            "MRL_PLATFORM_MACOS"
+        }
+
+        includedirs
+        {
+            "/Library/Developer/CommandLineTools/SDKs/MacOSX15.5.sdk/usr/include/c++/v1"
+        }
+
+    filter "system:linux"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_LINUX"
+        }
+
+    filter "configurations:Debug"
+        defines "MRL_DEBUG"
+        symbols "On"
+    
+    filter "configurations:Release"
+        optimize "On"
+
+    filter "configurations:Dist"
+        optimize "On"
+
+-- Metrics reader for running games (shared memory or socket)
+project "MarleStat"
+    location "MarleStat"
+    kind "ConsoleApp"
+    language "C++"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files 
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp",
+    }
+
+    includedirs
+    {
+        "Marle/vendor/spdlog/include",
+        "Marle/src",
+        "Marle/vendor/glad/include",
+        "Marle/vendor",
+        "Marle/vendor/glm"
+    }
+
+    links 
+    {
+        "Marle"
+    }
+
+    filter "system:windows"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_WINDOWS"
+        }
+
+    filter "system:macosx"
+        cppdialect "C++17"
+        staticruntime "On"
+        buildoptions { "-stdlib=libc++" }
+        linkoptions { "-stdlib=libc++" }
+
+        defines 
+        {
+            "MRL_PLATFORM_MACOS"
+        }
+
+        includedirs
+        {
+            "/Library/Developer/CommandLineTools/SDKs/MacOSX15.5.sdk/usr/include/c++/v1"
+        }
+
+    filter "system:linux"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_LINUX"
+        }
+
+    filter "configurations:Debug"
+        defines "MRL_DEBUG"
+        symbols "On"
+    
+    filter "configurations:Release"
+        optimize "On"
+
+    filter "configurations:Dist"
+        optimize "On"
+
+-- Unit and parity tests; exits non-zero when a check fails
+project "MarleTests"
+    location "MarleTests"
+    kind "ConsoleApp"
+    language "C++"
+
+    targetdir ("bin/" .. outputdir .. "/%{prj.name}")
+    objdir ("bin-int/" .. outputdir .. "/%{prj.name}")
+
+    files 
+    {
+        "%{prj.name}/src/**.h",
+        "%{prj.name}/src/**.cpp",
+        "MarleBench/src/BenchGL.h",
+        "MarleBench/src/BenchGL.cpp"
+    }
+
+    includedirs
+    {
+        "Marle/vendor/spdlog/include",
+        "Marle/src",
+        "Marle/vendor/glad/include",
+        "Marle/vendor",
+        "Marle/vendor/glm",
+        "MarleBench/src"
+    }
+
+    links 
+    {
+        "Marle"
+    }
+
+    filter "system:windows"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_WINDOWS"
+        }
+
+    filter "system:macosx"
+        cppdialect "C++17"
+        staticruntime "On"
+        buildoptions { "-stdlib=libc++" }
+        linkoptions { "-stdlib=libc++" }
+
+        defines 
+        {
+            "MRL_PLATFORM_MACOS"
+        }
+
+        includedirs
+        {
+            "/Library/Developer/CommandLineTools/SDKs/MacOSX15.5.sdk/usr/include/c++/v1"
+        }
+
+        -- Headless CGL context for the renderer parity tests
+        links
+        {
+            "OpenGL.framework"
+        }
+
+    filter "system:linux"
+        cppdialect "C++17"
+        staticruntime "On"
+        systemversion "latest"
+
+        defines 
+        {
+            "MRL_PLATFORM_LINUX"
+        }
+
+    filter "configurations:Debug"
+        defines "MRL_DEBUG"
+        symbols "On"
+    
+    filter "configurations:Release"
+        optimize "On"
+
+    filter "configurations:Dist"
+        optimize "On"